@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * Measures the next message container lookup in a pipeline of 6 handlers,
+ * the cached one of the context and the pipeline, against walking the
+ * contexts every time.
+ *
+ * The last handler takes a different message type, so the lookup from the
+ * first handler walks the whole pipeline.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cetty/channel/NullChannel.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+
+using namespace cetty::channel;
+
+typedef ChannelMessageContainer<int, MESSAGE_BLOCK> IntContainer;
+typedef ChannelMessageContainer<std::string, MESSAGE_BLOCK> StringContainer;
+
+template<typename In>
+class PassThroughHandler {
+public:
+    typedef ChannelMessageContainer<In, MESSAGE_BLOCK> InContainer;
+
+    typedef ChannelMessageHandlerContext<PassThroughHandler<In>*,
+            In,
+            In,
+            In,
+            In,
+            InContainer,
+            InContainer,
+            InContainer,
+            InContainer> Context;
+
+    void registerTo(Context& ctx) {}
+};
+
+typedef PassThroughHandler<int> IntHandler;
+typedef PassThroughHandler<std::string> StringHandler;
+
+static const int ITERATIONS = 10 * 1000 * 1000;
+static const int HANDLER_COUNT = 6;
+
+template<typename Lookup>
+static void run(const char* name, Lookup lookup) {
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+
+    int found = 0;
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        if (lookup()) {
+            ++found;
+        }
+    }
+
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+
+    printf("%-36s %8.2f ns/op (%d found)\n",
+           name,
+           elapsed.total_microseconds() * 1000.0 / ITERATIONS,
+           found);
+}
+
+struct WalkNearest {
+    ChannelHandlerContext* ctx;
+    IntContainer* operator()() const {
+        return ctx->nextInboundMessageContainer<IntContainer>(ctx->next());
+    }
+};
+
+struct CachedNearest {
+    ChannelHandlerContext* ctx;
+    IntContainer* operator()() const {
+        return ctx->nextInboundMessageContainer<IntContainer>();
+    }
+};
+
+struct WalkFarthest {
+    ChannelHandlerContext* ctx;
+    StringContainer* operator()() const {
+        return ctx->nextInboundMessageContainer<StringContainer>(ctx->next());
+    }
+};
+
+struct CachedFarthest {
+    ChannelHandlerContext* ctx;
+    StringContainer* operator()() const {
+        return ctx->nextInboundMessageContainer<StringContainer>();
+    }
+};
+
+struct WalkPipeline {
+    ChannelPipeline* pipeline;
+    IntContainer* operator()() const {
+        ChannelHandlerContext* head = pipeline->head();
+        return head->nextInboundMessageContainer<IntContainer>(head);
+    }
+};
+
+struct CachedPipeline {
+    ChannelPipeline* pipeline;
+    IntContainer* operator()() const {
+        return pipeline->inboundMessageContainer<IntContainer>();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    ChannelPipeline pipeline(NullChannel::instance());
+
+    IntHandler intHandler;
+    StringHandler stringHandler;
+
+    for (int i = 0; i < HANDLER_COUNT - 1; ++i) {
+        char name[16];
+        snprintf(name, sizeof(name), "handler%d", i);
+        pipeline.addLast(new IntHandler::Context(name, &intHandler));
+    }
+
+    pipeline.addLast(new StringHandler::Context("last", &stringHandler));
+
+    ChannelHandlerContext* first = pipeline.find("handler0");
+
+    WalkNearest walkNearest = { first };
+    CachedNearest cachedNearest = { first };
+    WalkFarthest walkFarthest = { first };
+    CachedFarthest cachedFarthest = { first };
+    WalkPipeline walkPipeline = { &pipeline };
+    CachedPipeline cachedPipeline = { &pipeline };
+
+    run("next container, walk", walkNearest);
+    run("next container, cached", cachedNearest);
+    run("last container, walk", walkFarthest);
+    run("last container, cached", cachedFarthest);
+    run("pipeline container, walk", walkPipeline);
+    run("pipeline container, cached", cachedPipeline);
+
+    // the static NullChannel logs after the logger is gone, skip the exit.
+    fflush(stdout);
+    _exit(0);
+}
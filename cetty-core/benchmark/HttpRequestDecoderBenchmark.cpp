@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * Measures the HTTP request decoding on one core, as the snoop server sees a
+ * typical browser request: the header block scan of each implementation,
+ * and the whole HttpPackageDecoder with and without the header block scan.
+ *
+ * The requests are pipelined in one buffer, so the decoder only pays for
+ * parsing and building the request, not for the I/O.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/handler/codec/ReplayingDecoderBuffer.h>
+#include <cetty/handler/codec/http/HttpHeaderScanner.h>
+#include <cetty/handler/codec/http/HttpPackageDecoder.h>
+#include <cetty/handler/codec/http/HttpRequestCreator.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::handler::codec;
+using namespace cetty::handler::codec::http;
+
+static const char* REQUEST =
+    "GET /snoop/index.html?user=frankee&session=5f2b8a1c HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.11 "
+    "(KHTML, like Gecko) Chrome/23.0.1271.97 Safari/537.11\r\n"
+    "Referer: http://localhost:8080/snoop/\r\n"
+    "Accept-Encoding: gzip,deflate,sdch\r\n"
+    "Accept-Language: en-US,en;q=0.8\r\n"
+    "Accept-Charset: ISO-8859-1,utf-8;q=0.7,*;q=0.3\r\n"
+    "Cookie: JSESSIONID=5f2b8a1c9e7d; theme=dark\r\n"
+    "\r\n";
+
+static const int PIPELINED = 64;
+static const int ROUNDS = 20000;
+
+class BenchmarkContext : public ChannelHandlerContext {
+public:
+    BenchmarkContext() : ChannelHandlerContext("benchmark") {}
+
+    virtual boost::any getInboundMessageContainer() { return boost::any(); }
+    virtual boost::any getOutboundMessageContainer() { return boost::any(); }
+};
+
+/**
+ * drives the decoder the way ReplayingDecoder does.
+ */
+class DecoderDriver {
+public:
+    DecoderDriver(bool headerBlockScan)
+        : state_(0),
+          checkedPoint_(0),
+          decoder_(HttpPackageDecoder::REQUEST) {
+        decoder_.setHeaderBlockScan(headerBlockScan);
+        decoder_.setCheckPointInvoker(boost::bind(&DecoderDriver::checkpoint,
+                                      this,
+                                      _1));
+        decoder_.setHttpPackageCreator(boost::bind(&HttpRequestCreator::create,
+                                       &creator_,
+                                       _1,
+                                       _2,
+                                       _3));
+        state_ = decoder_.initialState();
+    }
+
+    int decode(const ReplayingDecoderBufferPtr& buffer) {
+        buffer_ = buffer;
+        int decoded = 0;
+
+        while (buffer->readable()) {
+            checkedPoint_ = buffer->readerIndex();
+            HttpPackage package = decoder_.decode(ctx_, buffer, state_);
+
+            if (package) {
+                ++decoded;
+            }
+            else if (buffer->needMoreBytes()) {
+                buffer->readerIndex(checkedPoint_);
+                break;
+            }
+        }
+
+        return decoded;
+    }
+
+private:
+    void checkpoint(int state) {
+        checkedPoint_ = buffer_->readerIndex();
+        state_ = state;
+    }
+
+private:
+    int state_;
+    int checkedPoint_;
+
+    BenchmarkContext ctx_;
+    ReplayingDecoderBufferPtr buffer_;
+    HttpRequestCreator creator_;
+    HttpPackageDecoder decoder_;
+};
+
+static double elapsedSeconds(const boost::posix_time::ptime& start) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    return elapsed.total_microseconds() / 1000000.0;
+}
+
+static void scan(HttpHeaderScanner::Implementation implementation) {
+    if (!HttpHeaderScanner::isSupported(implementation)) {
+        printf("scan, %-24s not supported\n",
+               HttpHeaderScanner::implementationName(implementation));
+        return;
+    }
+
+    HttpHeaderScanner scanner(implementation);
+    HttpHeaderScanner::Block block;
+    std::string request(REQUEST);
+    int iterations = ROUNDS * PIPELINED;
+    int headers = 0;
+
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+
+    for (int i = 0; i < iterations; ++i) {
+        if (scanner.scan(request.data(), (int)request.size(), &block) > 0) {
+            headers += block.headerCount;
+        }
+    }
+
+    double seconds = elapsedSeconds(start);
+
+    printf("scan, %-24s %8.1f ns/request, %8.0f MB/s (%d headers)\n",
+           HttpHeaderScanner::implementationName(implementation),
+           seconds * 1000000000.0 / iterations,
+           request.size() * (double)iterations / seconds / (1024 * 1024),
+           headers / iterations);
+}
+
+static void decode(const char* name, bool headerBlockScan) {
+    std::string request(REQUEST);
+    ChannelBufferPtr buffer = Unpooled::buffer((int)request.size() * PIPELINED);
+
+    for (int i = 0; i < PIPELINED; ++i) {
+        buffer->writeBytes(request);
+    }
+
+    ReplayingDecoderBufferPtr replayable(new ReplayingDecoderBuffer(buffer));
+    DecoderDriver driver(headerBlockScan);
+    int decoded = 0;
+
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+
+    for (int i = 0; i < ROUNDS; ++i) {
+        buffer->readerIndex(0);
+        decoded += driver.decode(replayable);
+    }
+
+    double seconds = elapsedSeconds(start);
+
+    printf("decode, %-22s %8.0f requests/s/core (%d decoded)\n",
+           name,
+           decoded / seconds,
+           decoded);
+}
+
+int main(int argc, char* argv[]) {
+    printf("best header scanner: %s\n\n",
+           HttpHeaderScanner::implementationName(
+               HttpHeaderScanner::bestImplementation()));
+
+    scan(HttpHeaderScanner::SCALAR);
+    scan(HttpHeaderScanner::SSE42);
+    scan(HttpHeaderScanner::AVX2);
+
+    printf("\n");
+
+    decode("line by line", false);
+    decode("header block scan", true);
+
+    // the static NullChannel logs after the logger is gone, skip the exit.
+    fflush(stdout);
+    _exit(0);
+}
@@ -19,13 +19,33 @@
  */
 
 
+#include <string.h>
+
 #include <cetty/bootstrap/ServerBootstrap.h>
 #include <cetty/channel/ChannelPipelineInitializer.h>
 
+#include <cetty/Platform.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#if (CETTY_OS == CETTY_OS_LINUX)
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+#include <cetty/channel/uring/UringEventLoopPool.h>
+#endif
+
 #include "DiscardServerHandler.h"
 
 using namespace cetty::bootstrap;
 using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+using namespace cetty::channel::epoll;
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+using namespace cetty::channel::uring;
+#endif
 
 /**
  * Discards any incoming data.
@@ -38,14 +58,44 @@ using namespace cetty::channel;
 
 int main(int argc, char* argv[]) {
     int threadCount = 1;
+    bool useEpoll = false;
+    bool useUring = false;
 
-    if (argc == 2) {
+    if (argc >= 2) {
         threadCount = atoi(argv[1]);
     }
 
+    // "epoll" or "uring" to serve with the native event loops instead of asio.
+    if (argc >= 3) {
+        useEpoll = strcmp(argv[2], "epoll") == 0;
+        useUring = strcmp(argv[2], "uring") == 0;
+    }
+
     ChannelPipelineInitializer1<DiscardServerHandler> initializer("discard");
 
-    ServerBootstrap bootstrap(threadCount);
+    EventLoopPoolPtr pool;
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+
+    if (useEpoll) {
+        pool = new EpollEventLoopPool(threadCount);
+    }
+
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+
+    // falls back to asio if the kernel can not run the io_uring.
+    if (useUring) {
+        pool = UringEventLoopPool::create(threadCount);
+    }
+
+#endif
+
+    if (!pool) {
+        pool = new AsioServicePool(threadCount);
+    }
+
+    ServerBootstrap bootstrap(pool);
 
     bootstrap.setChildInitializer(boost::bind<bool>(initializer, _1))
         .setOption(ChannelOption::CO_SO_REUSEADDR, true)
@@ -1,5 +1,6 @@
 // echo.cpp : Defines the entry point for the console application.
 //
+#include <string.h>
 #include <boost/thread.hpp>
 #include <boost/date_time.hpp>
 #include <boost/smart_ptr.hpp>
@@ -11,9 +12,27 @@
 #include <cetty/channel/InetAddress.h>
 #include <cetty/channel/ChannelFuture.h>
 
+#include <cetty/Platform.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#if (CETTY_OS == CETTY_OS_LINUX)
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+#include <cetty/channel/uring/UringEventLoopPool.h>
+#endif
+
 #include "EchoClientHandler.h"
 
 using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+using namespace cetty::channel::epoll;
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+using namespace cetty::channel::uring;
+#endif
 
 using namespace cetty::bootstrap;
 using namespace cetty::buffer;
@@ -22,9 +41,9 @@ using namespace cetty::util;
 
 int main(int argc, char* argv[]) {
     // Print usage if no argument is specified.
-    if (argc < 3 || argc > 6) {
+    if (argc < 3 || argc > 7) {
         printf(
-            "Usage: EchoClient \n <host> <port> [<first message size> <client count> <io thread count>]");
+            "Usage: EchoClient \n <host> <port> [<first message size> <client count> <io thread count> <asio|epoll|uring>]");
         return -1;
     }
 
@@ -49,8 +68,38 @@ int main(int argc, char* argv[]) {
         ioThreadCount = atoi(argv[5]);
     }
 
+    bool useEpoll = false;
+    bool useUring = false;
+
+    if (argc >= 7) {
+        useEpoll = strcmp(argv[6], "epoll") == 0;
+        useUring = strcmp(argv[6], "uring") == 0;
+    }
+
     // Configure the client.
-    ClientBootstrap bootstrap(ioThreadCount);
+    EventLoopPoolPtr pool;
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+
+    if (useEpoll) {
+        pool = new EpollEventLoopPool(ioThreadCount);
+    }
+
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+
+    // falls back to asio if the kernel can not run the io_uring.
+    if (useUring) {
+        pool = UringEventLoopPool::create(ioThreadCount);
+    }
+
+#endif
+
+    if (!pool) {
+        pool = new AsioServicePool(ioThreadCount);
+    }
+
+    ClientBootstrap bootstrap(pool);
     ChannelPipelineInitializer1<EchoClientHandler> initializer;
 
     // Set up the pipeline factory.
@@ -93,7 +93,7 @@ public:
             buf.append("\r\n");
 
             buf.append("HOSTNAME: ");
-            buf.append(request->headers().host("unknown"));
+            request->headers().host("unknown").append_to(&buf);
             buf.append("\r\n");
             
             buf.append("REQUEST_URI: ");
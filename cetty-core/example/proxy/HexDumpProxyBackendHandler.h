@@ -24,13 +24,17 @@
 #include <cetty/buffer/ChannelBuffer.h>
 #include <cetty/channel/ChannelHandlerContext.h>
 #include <cetty/channel/ChannelInboundBufferHandlerAdapter.h>
+#include <cetty/handler/traffic/ReadThrottleHandler.h>
 
 using namespace cetty::buffer;
+using namespace cetty::handler::traffic;
 
 class HexDumpProxyBackendHandler : private boost::noncopyable {
 public:
-    HexDumpProxyBackendHandler(const ChannelPtr& inboundChannel) {
+    HexDumpProxyBackendHandler(const ChannelPtr& inboundChannel,
+                               const ReadThrottleHandler::HandlerPtr& inboundThrottle) {
         this.inboundChannel = inboundChannel;
+        this.inboundThrottle = inboundThrottle;
     }
 
     virtual void channelActive(ChannelHandlerContext& ctx) {
@@ -43,6 +47,9 @@ public:
         out.writeBytes(in);
         in.clear();
         inboundChannel.flush();
+
+        // pause reading from the remote host when the client is too slow.
+        inboundThrottle->throttle(ctx.channel());
     }
 
     virtual void channelInactive(ChannelHandlerContext& ctx) {
@@ -57,6 +64,7 @@ public:
 
 private:
     ChannelPtr inboundChannel;
+    ReadThrottleHandler::HandlerPtr inboundThrottle;
 };
 
 #endif //#if !defined(PROXY_HEXDUMPPROXYBACKENDHANDLER_H)
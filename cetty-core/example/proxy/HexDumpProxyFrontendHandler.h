@@ -23,8 +23,10 @@
 
 #include <cetty/channel/ChannelHandlerWrapper.h>
 #include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/handler/traffic/ReadThrottleHandler.h>
 
 using namespace cetty::channel;
+using namespace cetty::handler::traffic;
 
 class HexDumpProxyFrontendHandler : private boost::noncopyable {
 public:
@@ -43,12 +45,24 @@ private:
         //       Currently, we just keep the inbound traffic in the client channel's outbound buffer.
         const ChannelPtr& inboundChannel = ctx.channel();
 
+        // pause reading from the remote host when the client is too slow
+        // to take the bytes.
+        ReadThrottleHandler::HandlerPtr inboundThrottle(new ReadThrottleHandler);
+        inboundChannel->pipeline().addLast<ReadThrottleHandler::Handler>("throttle",
+                inboundThrottle);
+
         // Start the connection attempt.
         Bootstrap b = new Bootstrap();
         b.group(inboundChannel.eventLoop())
         .channel(NioSocketChannel.class)
         .remoteAddress(remoteHost, remotePort)
-        .handler(new HexDumpProxyBackendHandler(inboundChannel));
+        .handler(new HexDumpProxyBackendHandler(inboundChannel, inboundThrottle));
+
+        // pause reading from the client when the remote host is too slow
+        // to take the bytes.
+        outboundThrottle.reset(new ReadThrottleHandler);
+        b.pipeline().addLast<ReadThrottleHandler::Handler>("throttle",
+                outboundThrottle);
 
         ChannelFuture f = b.connect();
         outboundChannel = f.channel();
@@ -67,6 +81,7 @@ private:
 
         if (outboundChannel.isActive()) {
             outboundChannel.flush();
+            outboundThrottle->throttle(ctx.channel());
         }
     }
 
@@ -108,6 +123,7 @@ private:
     std::string remoteHost;
 
     ChannelPtr outboundChannel;
+    ReadThrottleHandler::HandlerPtr outboundThrottle;
 };
 
 #endif //#if !defined(PROXY_HEXDUMPPROXYFRONTENDHANDLER_H)
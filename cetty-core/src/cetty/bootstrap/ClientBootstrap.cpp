@@ -31,12 +31,31 @@
 #include <cetty/channel/asio/AsioServicePool.h>
 #include <cetty/channel/asio/AsioSocketChannel.h>
 
+#include <cetty/Platform.h>
+#if (CETTY_OS == CETTY_OS_LINUX)
+#include <cetty/channel/epoll/EpollEventLoop.h>
+#include <cetty/channel/epoll/EpollSocketChannel.h>
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+#include <cetty/channel/uring/UringEventLoop.h>
+#include <cetty/channel/uring/UringSocketChannel.h>
+#endif
+
 namespace cetty {
 namespace bootstrap {
 
 using namespace cetty::channel;
 using namespace cetty::channel::asio;
 
+#if (CETTY_OS == CETTY_OS_LINUX)
+using namespace cetty::channel::epoll;
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+using namespace cetty::channel::uring;
+#endif
+
 ClientBootstrap::ClientBootstrap() {
 }
 
@@ -130,6 +149,19 @@ ChannelPtr ClientBootstrap::newChannel() {
     if (boost::dynamic_pointer_cast<AsioService>(eventLoop)) {
         return ChannelPtr(new AsioSocketChannel(eventLoop));
     }
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+    else if (boost::dynamic_pointer_cast<EpollEventLoop>(eventLoop)) {
+        return ChannelPtr(new EpollSocketChannel(eventLoop));
+    }
+
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+    else if (boost::dynamic_pointer_cast<UringEventLoop>(eventLoop)) {
+        return ChannelPtr(new UringSocketChannel(eventLoop));
+    }
+
+#endif
     else {
         // other implement
         BOOST_ASSERT(false);
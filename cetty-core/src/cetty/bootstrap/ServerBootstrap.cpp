@@ -38,6 +38,17 @@
 #include <cetty/channel/asio/AsioServicePool.h>
 #include <cetty/channel/asio/AsioServerSocketChannel.h>
 
+#include <cetty/Platform.h>
+#if (CETTY_OS == CETTY_OS_LINUX)
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+#include <cetty/channel/epoll/EpollServerSocketChannel.h>
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+#include <cetty/channel/uring/UringEventLoopPool.h>
+#include <cetty/channel/uring/UringServerSocketChannel.h>
+#endif
+
 #include <cetty/bootstrap/ServerUtil.h>
 
 namespace cetty {
@@ -47,6 +58,14 @@ using namespace cetty::util;
 using namespace cetty::channel;
 using namespace cetty::channel::asio;
 
+#if (CETTY_OS == CETTY_OS_LINUX)
+using namespace cetty::channel::epoll;
+#endif
+
+#if defined(CETTY_HAVE_IO_URING)
+using namespace cetty::channel::uring;
+#endif
+
 class Acceptor : private boost::noncopyable {
 public:
     typedef boost::shared_ptr<Acceptor> Ptr;
@@ -91,18 +110,7 @@ public:
                 break;
             }
 
-            child->setInitializer(bootstrap_.childInitializer());
-            child->open();
-
-            const ChannelOptions& childOptions = bootstrap_.childOptions();
-            ChannelOptions::ConstIterator itr = childOptions.begin();
-
-            for (; itr != childOptions.end(); ++itr) {
-                if (!child->config().setOption(itr->first, itr->second)) {
-                    LOG_WARN << "set " << itr->first.name() << " failed.";
-                }
-            }
-
+            bootstrap_.initChildChannel(child);
             inboundQueue.pop_front();
         }
     }
@@ -237,15 +245,52 @@ bool ServerBootstrap::initServerChannel(ChannelPipeline& pipeline) {
     return true;
 }
 
+void ServerBootstrap::initChildChannel(const ChannelPtr& child) {
+    child->setInitializer(childInitializer_);
+    child->open();
+
+    ChannelOptions::ConstIterator itr = childOptions_.begin();
+
+    for (; itr != childOptions_.end(); ++itr) {
+        if (!child->config().setOption(itr->first, itr->second)) {
+            LOG_WARN << "set " << itr->first.name() << " failed.";
+        }
+    }
+}
+
 ChannelPtr ServerBootstrap::newChannel() {
     const EventLoopPoolPtr& parent = eventLoopPool();
 
     if (parent) {
         if (boost::dynamic_pointer_cast<AsioServicePool>(parent)) {
-            return ChannelPtr(
-                       new AsioServerSocketChannel(parent->nextLoop(),
-                                                   childLoopPool()));
+            AsioServerSocketChannel* channel =
+                new AsioServerSocketChannel(parent->nextLoop(),
+                                            childLoopPool());
+
+            // used only in the SO_REUSEPORT mode, which accepts
+            // in the child event loops directly.
+            channel->setChildInitializer(boost::bind(
+                                             &ServerBootstrap::initChildChannel,
+                                             this,
+                                             _1));
+
+            return ChannelPtr(channel);
         }
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+        else if (boost::dynamic_pointer_cast<EpollEventLoopPool>(parent)) {
+            return ChannelPtr(new EpollServerSocketChannel(parent->nextLoop(),
+                              childLoopPool()));
+        }
+
+#endif
+#if defined(CETTY_HAVE_IO_URING)
+        else if (boost::dynamic_pointer_cast<UringEventLoopPool>(parent)) {
+            return ChannelPtr(new UringServerSocketChannel(parent->nextLoop(),
+                              childLoopPool()));
+        }
+
+#endif
         else {
             BOOST_ASSERT(false && "has not implement yet.");
             return ChannelPtr();
@@ -464,9 +464,39 @@ int CompositeChannelBuffer::slice(int index, int length, GatheringBuffer* gather
     return length;
 }
 
+void CompositeChannelBuffer::consolidate() {
+    int localCapacity = capacity();
+
+    if (components.size() <= 1 || localCapacity == 0) {
+        return;
+    }
+
+    int localReaderIndex = ChannelBuffer::readerIndex();
+    int localWriterIndex = writerIndex();
+
+    ChannelBufferPtr consolidated = Unpooled::buffer(localCapacity);
+    getBytes(0, consolidated, 0, localCapacity);
+    consolidated->writerIndex(localCapacity);
+
+    setComponents(std::vector<ChannelBufferPtr>(1, consolidated));
+    setIndex(localReaderIndex, localWriterIndex);
+}
+
 const char* CompositeChannelBuffer::readableBytes(int* length) {
-    CETTY_NDC_SCOPE();
-    throw UnsupportedOperationException();
+    consolidate();
+
+    if (length) {
+        *length = ChannelBuffer::readableBytes();
+    }
+
+    if (components.empty()) {
+        return NULL;
+    }
+
+    int bytes;
+    const char* data = components[0]->readableBytes(&bytes);
+
+    return data ? data + ChannelBuffer::readerIndex() : NULL;
 }
 
 char* CompositeChannelBuffer::writableBytes(int* length) {
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/detail/atomic_count.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/HeapChannelBuffer.h>
+#include <cetty/util/Exception.h>
+#include <cetty/util/NestedDiagnosticContext.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace buffer {
+
+using namespace cetty::util;
+
+// every size class caches at most these bytes (and at least MIN_CACHED_BLOCKS).
+static const int MAX_CACHED_BYTES_PER_CLASS = 1024 * 1024;
+static const int MIN_CACHED_BLOCKS = 4;
+
+class SizeClasses {
+public:
+    SizeClasses() {
+        for (int size = 16; size <= 128; size += 16) {
+            sizes.push_back(size);
+        }
+
+        for (int base = 128; base < PooledChannelBufferFactory::MAX_POOLED_SIZE; base *= 2) {
+            int step = base / 4;
+
+            for (int i = 1; i <= 4; ++i) {
+                sizes.push_back(base + i * step);
+            }
+        }
+    }
+
+    // return -1 if too large to be pooled.
+    int index(int size) const {
+        std::vector<int>::const_iterator itr =
+            std::lower_bound(sizes.begin(), sizes.end(), size);
+
+        return itr == sizes.end() ? -1 : static_cast<int>(itr - sizes.begin());
+    }
+
+    int size(int index) const {
+        return sizes[index];
+    }
+
+    int count() const {
+        return static_cast<int>(sizes.size());
+    }
+
+private:
+    std::vector<int> sizes;
+};
+
+static const SizeClasses SIZE_CLASSES;
+
+class PooledChannelBufferArena;
+typedef boost::shared_ptr<PooledChannelBufferArena> PooledChannelBufferArenaPtr;
+
+class PooledChannelBufferArena : private boost::noncopyable {
+public:
+    PooledChannelBufferArena()
+        : orphaned_(false),
+          hits_(0),
+          misses_(0),
+          remoteCount_(0),
+          freeBlocks_(SIZE_CLASSES.count()),
+          cachedBlocks_(SIZE_CLASSES.count()) {
+        for (int i = 0; i < SIZE_CLASSES.count(); ++i) {
+            cachedBlocks_[i].reset(new boost::detail::atomic_count(0));
+        }
+    }
+
+    ~PooledChannelBufferArena() {
+        orphan();
+    }
+
+    // only called in the owner thread.
+    char* allocate(int size, int* sizeClass, int* blockSize) {
+        int index = SIZE_CLASSES.index(size);
+        *sizeClass = index;
+
+        if (index < 0) {
+            ++misses_;
+            *blockSize = size;
+            return new char[size];
+        }
+
+        if (remoteCount_ > 0) {
+            drainRemoteFrees();
+        }
+
+        *blockSize = SIZE_CLASSES.size(index);
+        std::vector<char*>& blocks = freeBlocks_[index];
+
+        if (!blocks.empty()) {
+            char* block = blocks.back();
+            blocks.pop_back();
+            --(*cachedBlocks_[index]);
+            ++hits_;
+            return block;
+        }
+
+        ++misses_;
+        return new char[*blockSize];
+    }
+
+    // only called in the owner thread.
+    void free(char* block, int sizeClass) {
+        if (sizeClass < 0) {
+            delete[] block;
+            return;
+        }
+
+        std::vector<char*>& blocks = freeBlocks_[sizeClass];
+        int maxBlocks = std::max(MIN_CACHED_BLOCKS,
+                                 MAX_CACHED_BYTES_PER_CLASS / SIZE_CLASSES.size(sizeClass));
+
+        if (static_cast<int>(blocks.size()) < maxBlocks) {
+            blocks.push_back(block);
+            ++(*cachedBlocks_[sizeClass]);
+        }
+        else {
+            delete[] block;
+        }
+    }
+
+    // called in the other threads, the block will be reused by the owner.
+    void remoteFree(char* block, int sizeClass) {
+        boost::mutex::scoped_lock lock(remoteMutex_);
+
+        if (orphaned_ || sizeClass < 0) {
+            delete[] block;
+            return;
+        }
+
+        remoteFrees_.push_back(std::make_pair(block, sizeClass));
+        ++remoteCount_;
+    }
+
+    // the owner thread has exited, drop all the cached blocks.
+    void orphan() {
+        boost::mutex::scoped_lock lock(remoteMutex_);
+        orphaned_ = true;
+
+        for (std::size_t i = 0; i < remoteFrees_.size(); ++i) {
+            delete[] remoteFrees_[i].first;
+        }
+
+        remoteFrees_.clear();
+
+        for (std::size_t i = 0; i < freeBlocks_.size(); ++i) {
+            std::vector<char*>& blocks = freeBlocks_[i];
+
+            for (std::size_t j = 0; j < blocks.size(); ++j) {
+                delete[] blocks[j];
+                --(*cachedBlocks_[i]);
+            }
+
+            blocks.clear();
+        }
+    }
+
+    void statistics(PooledChannelBufferFactory::Statistics* statistics) const {
+        statistics->hits += hits_;
+        statistics->misses += misses_;
+
+        for (int i = 0; i < SIZE_CLASSES.count(); ++i) {
+            statistics->residentBytes +=
+                static_cast<int64_t>(*cachedBlocks_[i]) * SIZE_CLASSES.size(i);
+        }
+
+        statistics->arenas += 1;
+    }
+
+private:
+    void drainRemoteFrees() {
+        std::vector<std::pair<char*, int> > frees;
+        {
+            boost::mutex::scoped_lock lock(remoteMutex_);
+            frees.swap(remoteFrees_);
+
+            for (std::size_t i = 0; i < frees.size(); ++i) {
+                --remoteCount_;
+            }
+        }
+
+        for (std::size_t i = 0; i < frees.size(); ++i) {
+            free(frees[i].first, frees[i].second);
+        }
+    }
+
+private:
+    bool orphaned_;
+
+    boost::detail::atomic_count hits_;
+    boost::detail::atomic_count misses_;
+    boost::detail::atomic_count remoteCount_;
+
+    boost::mutex remoteMutex_;
+    std::vector<std::pair<char*, int> > remoteFrees_;
+
+    std::vector<std::vector<char*> > freeBlocks_;
+    std::vector<boost::shared_ptr<boost::detail::atomic_count> > cachedBlocks_;
+};
+
+class PooledChannelBufferArenaHolder {
+public:
+    PooledChannelBufferArenaHolder() : arena(new PooledChannelBufferArena) {}
+
+    ~PooledChannelBufferArenaHolder() {
+        arena->orphan();
+    }
+
+    PooledChannelBufferArenaPtr arena;
+};
+
+static boost::thread_specific_ptr<PooledChannelBufferArenaHolder> threadArena;
+
+static boost::mutex arenasMutex;
+static std::vector<boost::weak_ptr<PooledChannelBufferArena> > arenas;
+
+static PooledChannelBufferArena* currentArena() {
+    PooledChannelBufferArenaHolder* holder = threadArena.get();
+    return holder ? holder->arena.get() : NULL;
+}
+
+static const PooledChannelBufferArenaPtr& ensureCurrentArena() {
+    PooledChannelBufferArenaHolder* holder = threadArena.get();
+
+    if (!holder) {
+        holder = new PooledChannelBufferArenaHolder;
+        threadArena.reset(holder);
+
+        boost::mutex::scoped_lock lock(arenasMutex);
+        arenas.push_back(holder->arena);
+    }
+
+    return holder->arena;
+}
+
+/**
+ * A heap buffer whose memory block is borrowed from a
+ * {@link PooledChannelBufferArena}, and given back when destructed.
+ */
+class PooledChannelBuffer : public HeapChannelBuffer {
+public:
+    PooledChannelBuffer(const PooledChannelBufferArenaPtr& arena,
+                        char* block,
+                        int blockSize,
+                        int sizeClass,
+                        int aheadBytes,
+                        int maxCapacity)
+        : HeapChannelBuffer(block,
+                            blockSize,
+                            aheadBytes,
+                            aheadBytes,
+                            maxCapacity,
+                            false),
+          sizeClass_(sizeClass),
+          arena_(arena) {
+    }
+
+    virtual ~PooledChannelBuffer() {
+        releaseBlock(buf, sizeClass_, arena_);
+        buf = NULL;
+    }
+
+    using HeapChannelBuffer::capacity;
+
+    virtual void capacity(int newCapacity) {
+        if (newCapacity < 0 || newCapacity > maxCapacity()) {
+            LOG_ERROR << "newCapacity: " << newCapacity << " is illegal";
+            return;
+        }
+
+        if (newCapacity == bufSize) {
+            return;
+        }
+
+        int sizeClass;
+        int blockSize;
+        const PooledChannelBufferArenaPtr& arena = ensureCurrentArena();
+        char* block = arena->allocate(newCapacity, &sizeClass, &blockSize);
+
+        int readerIndex = readerIdx;
+        int writerIndex = writerIdx;
+
+        if (newCapacity < bufSize) {
+            if (readerIndex < newCapacity) {
+                if (writerIndex > newCapacity) {
+                    writerIndex = newCapacity;
+                }
+
+                memcpy(block + readerIndex, buf + readerIndex, writerIndex - readerIndex);
+                setIndex(readerIndex, writerIndex);
+            }
+            else {
+                setIndex(newCapacity, newCapacity);
+            }
+        }
+        else {
+            memcpy(block + readerIndex, buf + readerIndex, writerIndex - readerIndex);
+        }
+
+        releaseBlock(buf, sizeClass_, arena_);
+
+        buf = block;
+        bufSize = std::min(blockSize, maxCapacity());
+        sizeClass_ = sizeClass;
+        arena_ = arena;
+    }
+
+private:
+    static void releaseBlock(char* block,
+                             int sizeClass,
+                             const PooledChannelBufferArenaPtr& arena) {
+        if (!block) {
+            return;
+        }
+
+        if (currentArena() == arena.get()) {
+            arena->free(block, sizeClass);
+        }
+        else {
+            arena->remoteFree(block, sizeClass);
+        }
+    }
+
+private:
+    int sizeClass_;
+    PooledChannelBufferArenaPtr arena_;
+};
+
+ChannelBufferPtr PooledChannelBufferFactory::buffer(int initialCapacity) {
+    return buffer(initialCapacity, 0);
+}
+
+ChannelBufferPtr PooledChannelBufferFactory::buffer(int initialCapacity,
+        int aheadBytes,
+        int maxCapacity) {
+    if (initialCapacity == 0) {
+        return Unpooled::EMPTY_BUFFER;
+    }
+
+    if (initialCapacity < 0
+            || aheadBytes < 0
+            || initialCapacity > maxCapacity - aheadBytes) {
+        CETTY_NDC_SCOPE();
+        throw InvalidArgumentException("length must greater than 0.");
+    }
+
+    int sizeClass;
+    int blockSize;
+    const PooledChannelBufferArenaPtr& arena = ensureCurrentArena();
+    char* block = arena->allocate(initialCapacity + aheadBytes,
+                                  &sizeClass,
+                                  &blockSize);
+
+    return ChannelBufferPtr(new PooledChannelBuffer(arena,
+                            block,
+                            std::min(blockSize, maxCapacity),
+                            sizeClass,
+                            aheadBytes,
+                            maxCapacity));
+}
+
+int PooledChannelBufferFactory::sizeClass(int size) {
+    int index = SIZE_CLASSES.index(size);
+    return index < 0 ? size : SIZE_CLASSES.size(index);
+}
+
+void PooledChannelBufferFactory::statistics(Statistics* statistics) {
+    if (!statistics) {
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(arenasMutex);
+    std::vector<boost::weak_ptr<PooledChannelBufferArena> >::iterator itr =
+        arenas.begin();
+
+    while (itr != arenas.end()) {
+        PooledChannelBufferArenaPtr arena = itr->lock();
+
+        if (arena) {
+            arena->statistics(statistics);
+            ++itr;
+        }
+        else {
+            itr = arenas.erase(itr);
+        }
+    }
+}
+
+void PooledChannelBufferFactory::threadStatistics(Statistics* statistics) {
+    PooledChannelBufferArena* arena = currentArena();
+
+    if (statistics && arena) {
+        arena->statistics(statistics);
+    }
+}
+
+void PooledChannelBufferFactory::prepareThreadArena() {
+    ensureCurrentArena();
+}
+
+}
+}
@@ -65,7 +65,8 @@ const char* SlicedChannelBuffer::readableBytes(int* len) {
             *len = writerIdx - readerIdx;
         }
 
-        return data + adjustment;
+        // the data starts at the reader index of the wrapped buffer.
+        return data - channelBuffer->readerIndex() + adjustment + readerIdx;
     }
 
     return NULL;
@@ -243,6 +243,10 @@ void Channel::doDisconnect(ChannelHandlerContext& ctx,
         future->setSuccess();
     }
 
+    if (state_ == CHANNEL_ACTIVED) {
+        eventLoop_->channelInactived();
+    }
+
     state_ = CHANNEL_INACTIVED;
 }
 
@@ -257,6 +261,7 @@ void Channel::doClose(ChannelHandlerContext& ctx, const ChannelFuturePtr& future
                 state_ = CHANNEL_INACTIVED;
 
                 if (wasActive) {
+                    eventLoop_->channelInactived();
                     LOG_INFO << "channel " << toString()
                              << " closed successfully.";
                     pipeline_->fireChannelInactive();
@@ -281,6 +286,10 @@ void Channel::doClose(ChannelHandlerContext& ctx, const ChannelFuturePtr& future
         future->setSuccess();
     }
 
+    if (state_ == CHANNEL_ACTIVED) {
+        eventLoop_->channelInactived();
+    }
+
     state_ = CHANNEL_INACTIVED;
 }
 
@@ -306,6 +315,10 @@ void Channel::closeIfClosed() {
 }
 
 void Channel::setActived() {
+    if (state_ != CHANNEL_ACTIVED && eventLoop_) {
+        eventLoop_->channelActived();
+    }
+
     state_ = CHANNEL_ACTIVED;
     doPreFireActive();
     pipeline_->fireChannelActive();
@@ -315,6 +328,10 @@ void Channel::processFailure(const std::string& message,
                              const ChannelFuturePtr& future) {
     LOG_ERROR << toString() << message;
 
+    // the listeners of the future may close the channel and release
+    // the last reference to it, e.g. the bind future of ServerBootstrap.
+    ChannelPtr self = shared_from_this();
+
     ChannelException exception(message);
     future->setFailure(exception);
     pipeline_->fireExceptionCaught(exception);
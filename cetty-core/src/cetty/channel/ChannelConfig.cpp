@@ -16,6 +16,8 @@
 
 #include <cetty/channel/ChannelConfig.h>
 #include <cetty/util/Exception.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
 
 #include <cetty/logging/LoggerHelper.h>
 
@@ -23,9 +25,11 @@ namespace cetty {
 namespace channel {
 
 using namespace cetty::util;
+using namespace cetty::buffer;
 
 ChannelConfig::ChannelConfig()
     : autoRead_(true),
+      pooledBuffer_(false),
       connectTimeoutMillis_(10000/*ms*/) {
 }
 
@@ -60,6 +64,13 @@ bool ChannelConfig::setOption(const ChannelOption& option,
                      << " to " << autoRead();
             return true;
         }
+        else if (option == ChannelOption::CO_POOLED_BUFFER) {
+            setPooledBuffer(boost::get<bool>(value));
+            LOG_INFO << "has set the "
+                     << option.name()
+                     << " to " << pooledBuffer();
+            return true;
+        }
 
         return false;
     }
@@ -81,5 +92,13 @@ ChannelConfig& ChannelConfig::setConnectTimeout(int connectTimeoutMillis) {
     return *this;
 }
 
+ChannelBufferPtr ChannelConfig::newBuffer(int initialCapacity) const {
+    if (pooledBuffer_) {
+        return PooledChannelBufferFactory::buffer(initialCapacity);
+    }
+
+    return Unpooled::buffer(initialCapacity);
+}
+
 }
 }
@@ -16,7 +16,10 @@
 
 #include <cetty/channel/ChannelHandlerContext.h>
 
+#include <cetty/buffer/Unpooled.h>
+
 #include <cetty/channel/Channel.h>
+#include <cetty/channel/ChannelConfig.h>
 #include <cetty/channel/NullChannel.h>
 #include <cetty/channel/InetAddress.h>
 #include <cetty/channel/ChannelPipeline.h>
@@ -33,7 +36,8 @@ ChannelHandlerContext::ChannelHandlerContext(const std::string& name)
       next_(),
       prev_(),
       eventLoop_(),
-      pipeline_() {
+      pipeline_(),
+      pipelineGeneration_() {
     resetNeighbourContexts();
 }
 
@@ -43,7 +47,8 @@ ChannelHandlerContext::ChannelHandlerContext(const std::string& name,
       next_(),
       prev_(),
       eventLoop_(eventLoop),
-      pipeline_() {
+      pipeline_(),
+      pipelineGeneration_() {
     resetNeighbourContexts();
 }
 
@@ -486,6 +491,65 @@ void ChannelHandlerContext::fireChannelReadSuspended(ChannelHandlerContext& ctx)
     }
 }
 
+void ChannelHandlerContext::fireChannelWritabilityChanged() {
+    bool& hasNext = hasNeighbourEventHandler_[EVT_CHANNEL_WRITABILITY_CHANGED];
+    ChannelHandlerContext*& nextCtx = neighbourEventHandler_[EVT_CHANNEL_WRITABILITY_CHANGED];
+
+    if (nextCtx) {
+        fireChannelWritabilityChanged(*nextCtx);
+        return;
+    }
+
+    if (hasNext) {
+        ChannelHandlerContext* next = next_;
+
+        while (next) {
+            if (next->channelWritabilityChangedCallback_) {
+                nextCtx = next;
+                fireChannelWritabilityChanged(*next);
+                break;
+            }
+
+            next = next->next_;
+        }
+
+        hasNext = (next != NULL);
+    }
+}
+
+void ChannelHandlerContext::fireChannelWritabilityChanged(ChannelHandlerContext& ctx) {
+    if (ctx.eventLoop_->inLoopThread()) {
+        try {
+            if (ctx.channelWritabilityChangedCallback_) {
+                ctx.channelWritabilityChangedCallback_(ctx);
+            }
+            else {
+                ChannelHandlerContext* next =
+                    ctx.neighbourEventHandler_[EVT_CHANNEL_WRITABILITY_CHANGED];
+
+                if (next) {
+                    next->channelWritabilityChangedCallback_(*next);
+                }
+                else {
+                    ctx.fireChannelWritabilityChanged();
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR << "An exception (" << e.what()
+                << ") was thrown by a user handler's channelWritabilityChanged() method";
+
+            notifyHandlerException(ChannelPipelineException(e.what()));
+        }
+    }
+    else {
+        ctx.eventLoop_->post(
+            boost::bind(&ChannelHandlerContext::fireChannelWritabilityChanged,
+            this,
+            boost::ref(ctx)));
+    }
+}
+
 const ChannelFuturePtr& ChannelHandlerContext::bind(const InetAddress& localAddress,
         const ChannelFuturePtr& future) {
             bool& hasPre = hasNeighbourEventHandler_[EVT_CHANNEL_BIND];
@@ -969,7 +1033,8 @@ void ChannelHandlerContext::notifyHandlerException(const ChannelPipelineExceptio
 }
 
 void ChannelHandlerContext::clearOutboundChannelBuffer(ChannelHandlerContext& ctx) {
-    ChannelBufferContainer* container =
+    // not to take the next pending buffer, which is not flushed yet.
+    const ChannelBufferContainer* container =
         outboundMessageContainer<ChannelBufferContainer>();
 
     if (container) {
@@ -982,7 +1047,7 @@ void ChannelHandlerContext::clearOutboundChannelBuffer(ChannelHandlerContext& ct
 }
 
 void ChannelHandlerContext::clearInboundChannelBuffer(ChannelHandlerContext& ctx) {
-    ChannelBufferContainer* container =
+    const ChannelBufferContainer* container =
         inboundMessageContainer<ChannelBufferContainer>();
 
     if (container) {
@@ -996,6 +1061,7 @@ void ChannelHandlerContext::clearInboundChannelBuffer(ChannelHandlerContext& ctx
 
 void ChannelHandlerContext::initialize(const ChannelPipeline& pipeline) {
     pipeline_ = &pipeline;
+    pipelineGeneration_ = &pipeline.generation();
     channel_ = pipeline.channel();
 
     if (!eventLoop_) {
@@ -1003,8 +1069,21 @@ void ChannelHandlerContext::initialize(const ChannelPipeline& pipeline) {
     }
 }
 
+ChannelBufferPtr ChannelHandlerContext::newBuffer(int initialCapacity) const {
+    ChannelPtr ch = channel();
+
+    if (ch) {
+        return ch->config().newBuffer(initialCapacity);
+    }
+
+    return Unpooled::buffer(initialCapacity);
+}
+
 void ChannelHandlerContext::onPipelineChanged() {
     resetNeighbourContexts();
+
+    nextInboundContainer_.reset();
+    nextOutboundContainer_.reset();
 }
 
 }
@@ -20,6 +20,18 @@
 namespace cetty {
 namespace channel {
 
+class AdaptiveReceiveBufferSizeChecker : public boost::static_visitor<bool> {
+public:
+    bool operator()(const std::vector<int>& value) const {
+        return value.size() == 3;
+    }
+
+    template<typename T>
+    bool operator()(const T& value) const {
+        return false;
+    }
+};
+
 class SctpInitMaxStreamsChecker : public boost::static_visitor<bool> {
 public:
     bool operator()(const std::vector<int>& value) const {
@@ -27,7 +39,7 @@ public:
     }
 
     template<typename T>
-    bool operator()(const T& vlaue) {
+    bool operator()(const T& value) const {
         return false;
     }
 };
@@ -38,6 +50,7 @@ const ValueChecker<std::string> ChannelOption::STRING_VALUE_CHECKER;
 const ValueChecker<std::vector<int> > ChannelOption::INT_VECTOR_VALUE_CHECKER;
 
 static const SctpInitMaxStreamsChecker SCTP_INIT_MAXSTREAMS_CHECKER;
+static const AdaptiveReceiveBufferSizeChecker ADAPTIVE_RECEIVE_BUFFER_SIZE_CHECKER;
 
 const ChannelOption::Variant ChannelOption::EMPTY_VALUE;
 
@@ -45,6 +58,7 @@ const ChannelOption ChannelOption::CO_CONNECT_TIMEOUT_MILLIS(1, "CONNECT_TIMEOUT
 const ChannelOption ChannelOption::CO_REUSE_CHILD(2, "REUSE_CHILD", &BOOL_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_RESERVED_CHILD_COUNT(3, "RESERVED_CHILD_COUNT", &INT_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_AUTO_READ(4, "AUTO_READ", &BOOL_VALUE_CHECKER);
+const ChannelOption ChannelOption::CO_POOLED_BUFFER(5, "POOLED_BUFFER", &BOOL_VALUE_CHECKER);
 
 const ChannelOption ChannelOption::CO_SO_BROADCAST(10, "SO_BROADCAST", &BOOL_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_SO_KEEPALIVE(11, "SO_KEEPALIVE", &BOOL_VALUE_CHECKER);
@@ -59,6 +73,13 @@ const ChannelOption ChannelOption::CO_SO_RCVLOWAT(18, "SO_RCVLOWAT", &INT_VALUE_
 const ChannelOption ChannelOption::CO_SNDHIGHWAT(19, "SNDHIGHWAT", &INT_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_RCVHIGHWAT(20, "RCVHIGHWAT", &INT_VALUE_CHECKER);
 
+const ChannelOption ChannelOption::CO_WRITE_BATCH_BYTES(21, "WRITE_BATCH_BYTES", &INT_VALUE_CHECKER);
+const ChannelOption ChannelOption::CO_WRITE_BATCH_OPERATIONS(22, "WRITE_BATCH_OPERATIONS", &INT_VALUE_CHECKER);
+const ChannelOption ChannelOption::CO_LAZY_READ_BUFFER(23, "LAZY_READ_BUFFER", &BOOL_VALUE_CHECKER);
+const ChannelOption ChannelOption::CO_ADAPTIVE_RECEIVE_BUFFER_SIZE(24, "ADAPTIVE_RECEIVE_BUFFER_SIZE", &ADAPTIVE_RECEIVE_BUFFER_SIZE_CHECKER);
+const ChannelOption ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK(26, "WRITE_BUFFER_LOW_WATER_MARK", &INT_VALUE_CHECKER);
+const ChannelOption ChannelOption::CO_SO_REUSEPORT(27, "SO_REUSEPORT", &BOOL_VALUE_CHECKER);
+
 const ChannelOption ChannelOption::CO_IP_TOS(30, "IP_TOS", &INT_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_IP_MULTICAST_ADDR(31, "IP_MULTICAST_ADDR", &STRING_VALUE_CHECKER);
 const ChannelOption ChannelOption::CO_IP_MULTICAST_IF(32, "IP_MULTICAST_IF", &STRING_VALUE_CHECKER);
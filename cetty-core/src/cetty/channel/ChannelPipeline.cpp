@@ -65,7 +65,8 @@ ChannelPipeline::ChannelPipeline(const ChannelPtr& channel)
       channel_(channel),
       eventLoop_(channel->eventLoop()),
       head_(),
-      tail_() {
+      tail_(),
+      generation_(0) {
 
     head_ = tail_ = new NullChannelHandlerContext;
     voidFuture_ = new VoidChannelFuture(channel_);
@@ -106,6 +107,8 @@ void ChannelPipeline::setHead(ChannelHandlerContext* ctx) {
     else {
         head_ = newHead;
     }
+
+    firePipelineChanged();
 }
 
 bool ChannelPipeline::addFirst(ChannelHandlerContext* context) {
@@ -131,10 +134,17 @@ bool ChannelPipeline::addFirst(ChannelHandlerContext* context) {
     if (nextCtx) {
         nextCtx->setPrev(context);
     }
+    else {
+        tail_ = context;
+    }
 
     head_->setNext(context);
 
+    context->setPrev(head_);
+    context->setNext(nextCtx);
+
     contexts_[name] = context;
+    firePipelineChanged();
 
     callAfterAdd(context);
 
@@ -166,6 +176,7 @@ bool ChannelPipeline::addLast(ChannelHandlerContext* context) {
     tail_ = context;
 
     contexts_[name] = context;
+    firePipelineChanged();
 
     callAfterAdd(context);
 
@@ -196,13 +207,16 @@ bool ChannelPipeline::addBefore(const std::string& name, ChannelHandlerContext*
     context->initialize(*this);
     callBeforeAdd(context);
 
-    ctx->prev()->setNext(context);
+    ChannelHandlerContext* prev = ctx->prev();
+
+    prev->setNext(context);
     ctx->setPrev(context);
 
-    context->setPrev(ctx->prev());
+    context->setPrev(prev);
     context->setNext(ctx);
 
     contexts_[newName] = context;
+    firePipelineChanged();
 
     callAfterAdd(context);
     return true;
@@ -232,13 +246,22 @@ bool ChannelPipeline::addAfter(const std::string& name, ChannelHandlerContext* c
     context->initialize(*this);
     callBeforeAdd(context);
 
-    ctx->next()->setPrev(context);
+    ChannelHandlerContext* next = ctx->next();
+
+    if (next) {
+        next->setPrev(context);
+    }
+    else {
+        tail_ = context;
+    }
+
     ctx->setNext(context);
 
     context->setPrev(ctx);
-    context->setNext(ctx->next());
+    context->setNext(next);
 
     contexts_[newName] = context;
+    firePipelineChanged();
 
     callAfterAdd(context);
 
@@ -259,9 +282,16 @@ void ChannelPipeline::remove(const std::string& name) {
     ChannelHandlerContext* next = ctx->next();
 
     prev->setNext(next);
-    next->setPrev(prev);
+
+    if (next) {
+        next->setPrev(prev);
+    }
+    else {
+        tail_ = prev;
+    }
 
     contexts_.erase(ctx->name());
+    firePipelineChanged();
 
     callAfterRemove(ctx);
 
@@ -281,6 +311,7 @@ void ChannelPipeline::removeLast() {
     oldTail->prev()->setNext(NULL);
     tail_ = oldTail->prev();
     contexts_.erase(oldTail->name());
+    firePipelineChanged();
 
     callAfterRemove(oldTail);
 
@@ -323,6 +354,7 @@ bool ChannelPipeline::replace(const std::string& name, ChannelHandlerContext* co
 
     contexts_.erase(oldName);
     contexts_[newName] = context;
+    firePipelineChanged();
 
     ChannelHandlerLifeCycleException removeException;
     ChannelHandlerLifeCycleException addException;
@@ -585,6 +617,17 @@ ChannelPipeline& ChannelPipeline::fireChannelReadSuspended() {
     return *this;
 }
 
+ChannelPipeline& ChannelPipeline::fireChannelWritabilityChanged() {
+    if (!head_->channelWritabilityChangedCallback()) {
+        head_->fireChannelWritabilityChanged();
+    }
+    else {
+        head_->fireChannelWritabilityChanged(*head_);
+    }
+
+    return *this;
+}
+
 void ChannelPipeline::read() {
     if (tail_) {
         return tail_->read(*tail_);
@@ -33,44 +33,35 @@ bool DefaultChannelFuture::disabledDeadLockCheckerOnce = false;
 
 Exception DefaultChannelFuture::CANCELLED("Future canceled");
 
+struct DefaultChannelFuture::Waiter {
+    boost::mutex mutex;
+    boost::condition_variable cond;
+};
+
 DefaultChannelFuture::DefaultChannelFuture(const ChannelPtr& channel,
         bool cancellable,
         bool threadUnsafe)
     : cancellable_(cancellable),
-      done_(false),
-      threadUnsafe_(threadUnsafe),
+      state_(STATE_PENDING),
       channel_(channel),
+      inlineListenerCount_(0),
       completedListeners_(NULL),
       progressListeners_(NULL),
       cause_(NULL),
-      mutex_(NULL),
-      cond_(NULL),
-      waiters_(0) {
-
-    if (!threadUnsafe) {
-        condition();
-        getMutex();
-    }
+      waiter_(NULL) {
 }
 
 DefaultChannelFuture::DefaultChannelFuture(const ChannelWeakPtr& channel,
         bool cancellable,
         bool threadUnsafe /*= false*/)
     : cancellable_(cancellable),
-      done_(false),
-      threadUnsafe_(threadUnsafe),
+      state_(STATE_PENDING),
       channel_(channel),
+      inlineListenerCount_(0),
       completedListeners_(NULL),
       progressListeners_(NULL),
       cause_(NULL),
-      mutex_(NULL),
-      cond_(NULL),
-      waiters_(0) {
-
-    if (!threadUnsafe) {
-        condition();
-        getMutex();
-    }
+      waiter_(NULL) {
 }
 
 DefaultChannelFuture::~DefaultChannelFuture() {
@@ -86,12 +77,10 @@ DefaultChannelFuture::~DefaultChannelFuture() {
         delete cause_;
     }
 
-    if (cond_) {
-        delete cond_;
-    }
+    Waiter* waiter = waiter_.get();
 
-    if (mutex_) {
-        delete mutex_;
+    if (waiter) {
+        delete waiter;
     }
 }
 
@@ -109,30 +98,80 @@ void DefaultChannelFuture::setUseDeadLockChecker(bool useDeadLockChecker) {
     DefaultChannelFuture::useDeadLockChecker = useDeadLockChecker;
 }
 
+int DefaultChannelFuture::completedState() const {
+    int state = state_.get();
+    return state >= STATE_SUCCESS && state <= STATE_CANCELLED
+           ? state : STATE_PENDING;
+}
+
 bool DefaultChannelFuture::isDone() const {
-    boost::lock_guard<boost::mutex> guard(getMutex());
-    return done_;
+    return completedState() != STATE_PENDING;
 }
 
 bool DefaultChannelFuture::isSuccess() const {
-    boost::lock_guard<boost::mutex> guard(getMutex());
-    return done_ && cause_ == NULL;
+    return completedState() == STATE_SUCCESS;
 }
 
 const Exception* DefaultChannelFuture::failedCause() const {
-    boost::lock_guard<boost::mutex> guard(getMutex());
+    // the cause is published by the completed state.
+    return completedState() == STATE_FAILED ? cause_ : NULL;
+}
 
-    if (cause_ != &CANCELLED) {
-        return cause_;
-    }
-    else {
-        return NULL;
+bool DefaultChannelFuture::isCancelled() const {
+    return completedState() == STATE_CANCELLED;
+}
+
+bool DefaultChannelFuture::lockListeners() {
+    for (;;) {
+        int state = state_.get();
+
+        if (state == STATE_PENDING) {
+            if (state_.compareAndSet(STATE_PENDING, STATE_LISTENERS_LOCKED)) {
+                return true;
+            }
+        }
+        else if (state != STATE_LISTENERS_LOCKED && state != STATE_COMPLETING) {
+            return false;
+        }
+        else {
+            // only contended by another thread for a very short time.
+            boost::this_thread::yield();
+        }
     }
 }
 
-bool DefaultChannelFuture::isCancelled() const {
-    boost::lock_guard<boost::mutex> guard(getMutex());
-    return cause_ == &CANCELLED;
+void DefaultChannelFuture::unlockListeners() {
+    state_.set(STATE_PENDING);
+}
+
+bool DefaultChannelFuture::complete(int state, Exception* cause) {
+    // Allow only once.
+    while (!state_.compareAndSet(STATE_PENDING, STATE_COMPLETING)) {
+        if (state_.get() != STATE_LISTENERS_LOCKED) {
+            if (cause && cause != &CANCELLED) {
+                delete cause;
+            }
+
+            return false;
+        }
+
+        boost::this_thread::yield();
+    }
+
+    cause_ = cause;
+
+    // a full barrier, publishes the cause, and orders with the waiter below.
+    state_.compareAndSet(STATE_COMPLETING, state);
+
+    Waiter* waiter = waiter_.get();
+
+    if (waiter) {
+        boost::lock_guard<boost::mutex> guard(waiter->mutex);
+        waiter->cond.notify_all();
+    }
+
+    notifyListeners();
+    return true;
 }
 
 ChannelFuturePtr DefaultChannelFuture::addListener(
@@ -142,35 +181,39 @@ ChannelFuturePtr DefaultChannelFuture::addListener(
         return shared_from_this();
     }
 
-    bool notifyNow = false;
+    if (!lockListeners()) {
+        notifyListener(listener);
+        return shared_from_this();
+    }
 
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
+    if (completedListeners_) {
+        completedListeners_->push(PriorityCallback(listener, priority));
+    }
+    else if (inlineListenerCount_ < INLINE_LISTENER_COUNT) {
+        // insert after the ones with the same or higher priority.
+        int i = inlineListenerCount_;
 
-        if (done_) {
-            notifyNow = true;
+        while (i > 0 && inlineListeners_[i - 1].priority < priority) {
+            inlineListeners_[i] = inlineListeners_[i - 1];
+            --i;
         }
-        else {
-            if (firstListener_.empty() && completedListeners_ == NULL) {
-                firstListener_.callback = listener;
-                firstListener_.priority = priority;
-            }
-            else {
-                if (completedListeners_ == NULL) {
-                    completedListeners_ = new PriorityCallbackQueue();
-                }
 
-                completedListeners_->push(firstListener_);
-                completedListeners_->push(PriorityCallback(listener, priority));
-                firstListener_.clear();
-            }
-        }
+        inlineListeners_[i] = PriorityCallback(listener, priority);
+        ++inlineListenerCount_;
     }
+    else {
+        completedListeners_ = new PriorityCallbackQueue();
 
-    if (notifyNow) {
-        notifyListener(listener);
+        for (int i = 0; i < inlineListenerCount_; ++i) {
+            completedListeners_->push(inlineListeners_[i]);
+            inlineListeners_[i].clear();
+        }
+
+        inlineListenerCount_ = 0;
+        completedListeners_->push(PriorityCallback(listener, priority));
     }
 
+    unlockListeners();
     return shared_from_this();
 }
 
@@ -180,16 +223,13 @@ ChannelFuturePtr DefaultChannelFuture::addProgressListener(
         return shared_from_this();
     }
 
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
-
-        if (!done_) {
-            if (progressListeners_ == NULL) {
-                progressListeners_ = new ProgressedCallbackQueue();
-            }
-
-            progressListeners_->push_back(listener);
+    if (lockListeners()) {
+        if (progressListeners_ == NULL) {
+            progressListeners_ = new ProgressedCallbackQueue();
         }
+
+        progressListeners_->push_back(listener);
+        unlockListeners();
     }
 
     return shared_from_this();
@@ -246,20 +286,16 @@ ChannelFuturePtr DefaultChannelFuture::await() {
         throw InterruptedException();
     }
 
-    {
-        boost::unique_lock<boost::mutex> lock(getMutex());
+    if (isDone()) {
+        return shared_from_this();
+    }
 
-        while (!done_) {
-            checkDeadLock();
-            waiters_++;
+    Waiter* w = waiter();
+    boost::unique_lock<boost::mutex> lock(w->mutex);
 
-            try {
-                condition().wait(lock);
-            }
-            catch (...) {
-                waiters_--;
-            }
-        }
+    while (!isDone()) {
+        checkDeadLock();
+        w->cond.wait(lock);
     }
 
     return shared_from_this();
@@ -270,21 +306,25 @@ bool DefaultChannelFuture::await(int64_t timeoutMillis) {
 }
 
 ChannelFuturePtr DefaultChannelFuture::awaitUninterruptibly() {
+    if (isDone()) {
+        return shared_from_this();
+    }
+
     bool interrupted = false;
+
     {
-        boost::unique_lock<boost::mutex> lock(getMutex());
+        Waiter* w = waiter();
+        boost::unique_lock<boost::mutex> lock(w->mutex);
 
-        while (!done_) {
+        while (!isDone()) {
             checkDeadLock();
-            waiters_++;
 
             try {
-                condition().wait(lock);
+                w->cond.wait(lock);
             }
             catch (const boost::thread_interrupted& e) {
                 (void)e;
                 interrupted = true;
-                waiters_--;
 
                 LOG_WARN << "thread interrupted while awaiting";
             }
@@ -310,50 +350,15 @@ bool DefaultChannelFuture::awaitUninterruptibly(int64_t timeoutMillis) {
 }
 
 bool DefaultChannelFuture::setSuccess() {
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
-
-        // Allow only once.
-        if (done_) {
-            return false;
-        }
-
-        done_ = true;
-
-        if (waiters_ > 0) {
-            cond_->notify_all();
-        }
-    }
-
-    notifyListeners();
-    return true;
+    return complete(STATE_SUCCESS, NULL);
 }
 
 bool DefaultChannelFuture::setFailure(const Exception& cause) {
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
-
-        // Allow only once.
-        if (done_) {
-            return false;
-        }
-
-        if (this->cause_ && this->cause_ != &CANCELLED) {
-            delete this->cause_;
-            this->cause_ = NULL;
-        }
-
-        this->cause_ = new Exception(cause);
-
-        done_ = true;
-
-        if (waiters_ > 0) {
-            cond_->notify_all();
-        }
+    if (isDone()) {
+        return false;
     }
 
-    notifyListeners();
-    return true;
+    return complete(STATE_FAILED, new Exception(cause));
 }
 
 bool DefaultChannelFuture::cancel() {
@@ -361,45 +366,23 @@ bool DefaultChannelFuture::cancel() {
         return false;
     }
 
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
-
-        // Allow only once.
-        if (done_) {
-            return false;
-        }
-
-        cause_ = &CANCELLED;
-        done_ = true;
-
-        if (waiters_ > 0) {
-            cond_->notify_all();
-        }
-    }
-
-    notifyListeners();
-    return true;
+    return complete(STATE_CANCELLED, &CANCELLED);
 }
 
 bool DefaultChannelFuture::setProgress(int amount, int current, int total) {
     ProgressedCallbackQueue tmplist;
 
-    {
-        boost::lock_guard<boost::mutex> guard(getMutex());
-
-        // Do not generate progress event after completion.
-        if (done_) {
-            return false;
-        }
-
-        if (progressListeners_ == NULL || progressListeners_->empty()) {
-            // Nothing to notify - no need to create an empty array.
-            return true;
-        }
+    // Do not generate progress event after completion.
+    if (!lockListeners()) {
+        return false;
+    }
 
+    if (progressListeners_ != NULL) {
         tmplist = *progressListeners_;
     }
 
+    unlockListeners();
+
     while (!tmplist.empty()) {
         notifyProgressListener(tmplist.front(), amount, current, total);
         tmplist.pop_front();
@@ -413,65 +396,36 @@ bool DefaultChannelFuture::await0(int64_t timeoutMillis, bool interruptable) {
         throw InterruptedException("");
     }
 
-    boost::posix_time::time_duration duration =
-        boost::posix_time::milliseconds(timeoutMillis);
+    if (isDone() || timeoutMillis <= 0) {
+        return isDone();
+    }
 
-    boost::posix_time::ptime expiredTime(
-        timeoutMillis <= 0 ? boost::get_system_time()
-        : boost::get_system_time() + duration);
+    boost::posix_time::ptime expiredTime =
+        boost::get_system_time() + boost::posix_time::milliseconds(timeoutMillis);
 
-    bool interrupted = false;
+    checkDeadLock();
 
-    try {
-        boost::unique_lock<boost::mutex> lock(getMutex());
+    Waiter* w = waiter();
+    boost::unique_lock<boost::mutex> lock(w->mutex);
 
-        if (done_) {
-            return done_;
-        }
-        else if (timeoutMillis <= 0) {
-            return done_;
+    while (!isDone()) {
+        try {
+            w->cond.timed_wait(lock, expiredTime);
         }
+        catch (const boost::thread_interrupted& e) {
+            (void)e;
 
-        checkDeadLock();
-        waiters_++;
-
-        try {
-            for (;;) {
-                try {
-                    condition().timed_wait(lock, expiredTime);
-                }
-                catch (const boost::thread_interrupted& e) {
-                    (void)e;
-
-                    if (interruptable) {
-                        throw InterruptedException("");
-                    }
-                    else {
-                        interrupted = true;
-                    }
-                }
-
-                if (done_) {
-                    return true;
-                }
-                else {
-                    if (boost::get_system_time() >= expiredTime) {
-                        return done_;
-                    }
-                }
+            if (interruptable) {
+                throw InterruptedException("");
             }
         }
-        catch (...) {
-            waiters_--;
-        }
-    }
-    catch (...) {
-        if (interrupted) {
-            //Thread.currentThread().interrupt();
+
+        if (boost::get_system_time() >= expiredTime) {
+            break;
         }
     }
 
-    return false;
+    return isDone();
 }
 
 void DefaultChannelFuture::checkDeadLock() {
@@ -485,15 +439,17 @@ void DefaultChannelFuture::checkDeadLock() {
 
 void DefaultChannelFuture::notifyListeners() {
     // This method doesn't need synchronization because:
-    // 1) This method is always called after synchronized (this) block.
+    // 1) This method is always called after the state CAS to completed,
     //    Hence any listener list modification happens-before this method.
-    // 2) This method is called only when 'done' is true.  Once 'done'
-    //    becomes true, the listener list is never modified - see add/removeListener()
-    if (!firstListener_.empty()) {
-        notifyListener(firstListener_.callback);
-        firstListener_.clear();
+    // 2) Once completed, the listener list is never modified,
+    //    see addListener().
+    for (int i = 0; i < inlineListenerCount_; ++i) {
+        notifyListener(inlineListeners_[i].callback);
+        inlineListeners_[i].clear();
     }
 
+    inlineListenerCount_ = 0;
+
     if (completedListeners_ && !completedListeners_->empty()) {
         while (!completedListeners_->empty()) {
             PriorityCallback callback = completedListeners_->top();
@@ -537,20 +493,22 @@ void DefaultChannelFuture::notifyProgressListener(const ProgressedCallback& l,
     }
 }
 
-boost::condition_variable& DefaultChannelFuture::condition() {
-    if (!cond_) {
-        cond_ = new boost::condition_variable();
-    }
+DefaultChannelFuture::Waiter* DefaultChannelFuture::waiter() {
+    Waiter* waiter = waiter_.get();
 
-    return *cond_;
-}
+    if (!waiter) {
+        Waiter* newWaiter = new Waiter;
 
-boost::mutex& DefaultChannelFuture::getMutex() const {
-    if (!mutex_) {
-        mutex_ = new boost::mutex();
+        if (waiter_.compareAndSet(NULL, newWaiter)) {
+            waiter = newWaiter;
+        }
+        else {
+            delete newWaiter;
+            waiter = waiter_.get();
+        }
     }
 
-    return *mutex_;
+    return waiter;
 }
 
 }
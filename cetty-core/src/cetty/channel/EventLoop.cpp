@@ -22,15 +22,59 @@ namespace cetty {
 namespace channel {
 
 EventLoop::EventLoop(const EventLoopPoolPtr& pool)
-    : pool_(pool) {
+    : pool_(pool),
+      stopped_(0),
+      channelCount_(0),
+      pendingTaskCount_(0),
+      busyRatio_(0),
+      busyTime_(0),
+      busyRatioUpdated_(0),
+      windowStart_(0),
+      windowBusyTime_(0) {
 }
 
 EventLoop::~EventLoop() {
 }
 
 void EventLoop::stop() {
+    stopped_.set(1);
     pool_.reset();
 }
 
+int EventLoop::busyRatio() const {
+    // the ratio only updated when running handlers, an idle loop
+    // has not updated it for a long time.
+    int64_t updated = busyRatioUpdated_.get();
+
+    if (CachedClock::nowInMicros() - updated > 2 * BUSY_RATIO_WINDOW) {
+        return 0;
+    }
+
+    return busyRatio_.get();
+}
+
+void EventLoop::addBusyTime(int64_t nowMicros, int64_t busyMicros) {
+    if (busyMicros > 0) {
+        busyTime_.relaxedSet(busyTime_.relaxedGet() + busyMicros);
+        windowBusyTime_ += busyMicros;
+    }
+
+    if (!windowStart_) {
+        windowStart_ = nowMicros;
+        return;
+    }
+
+    int64_t elapsed = nowMicros - windowStart_;
+
+    if (elapsed >= BUSY_RATIO_WINDOW) {
+        int ratio = static_cast<int>(windowBusyTime_ * 1000 / elapsed);
+        busyRatio_.set(ratio > 1000 ? 1000 : ratio);
+        busyRatioUpdated_.set(nowMicros);
+
+        windowStart_ = nowMicros;
+        windowBusyTime_ = 0;
+    }
+}
+
 }
 }
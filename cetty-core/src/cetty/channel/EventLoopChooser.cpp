@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/EventLoopChooser.h>
+
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/EventLoopPool.h>
+
+namespace cetty {
+namespace channel {
+
+EventLoopChooser* EventLoopChooser::create(const std::string& name) {
+    if (name == "roundRobin") {
+        return new RoundRobinEventLoopChooser;
+    }
+    else if (name == "leastChannels") {
+        return new LeastChannelsEventLoopChooser;
+    }
+    else if (name == "leastPendingTasks") {
+        return new LeastPendingTasksEventLoopChooser;
+    }
+    else if (name == "powerOfTwoChoices") {
+        return new PowerOfTwoChoicesEventLoopChooser;
+    }
+
+    return NULL;
+}
+
+int RoundRobinEventLoopChooser::next(const EventLoopPool& pool) {
+    unsigned int index = static_cast<unsigned int>(index_.getAndAdd(1));
+    return static_cast<int>(index % pool.size());
+}
+
+int LeastChannelsEventLoopChooser::next(const EventLoopPool& pool) {
+    int chosen = 0;
+    int leastChannels = pool.loopAt(0)->channelCount();
+    int leastTasks = pool.loopAt(0)->pendingTaskCount();
+
+    for (int i = 1, j = pool.size(); i < j; ++i) {
+        const EventLoopPtr& loop = pool.loopAt(i);
+        int channels = loop->channelCount();
+
+        if (channels < leastChannels) {
+            chosen = i;
+            leastChannels = channels;
+            leastTasks = loop->pendingTaskCount();
+        }
+        else if (channels == leastChannels) {
+            int tasks = loop->pendingTaskCount();
+
+            if (tasks < leastTasks) {
+                chosen = i;
+                leastTasks = tasks;
+            }
+        }
+    }
+
+    return chosen;
+}
+
+int LeastPendingTasksEventLoopChooser::next(const EventLoopPool& pool) {
+    int chosen = 0;
+    int leastTasks = pool.loopAt(0)->pendingTaskCount();
+
+    for (int i = 1, j = pool.size(); i < j && leastTasks > 0; ++i) {
+        int tasks = pool.loopAt(i)->pendingTaskCount();
+
+        if (tasks < leastTasks) {
+            chosen = i;
+            leastTasks = tasks;
+        }
+    }
+
+    return chosen;
+}
+
+int PowerOfTwoChoicesEventLoopChooser::next(const EventLoopPool& pool) {
+    int size = pool.size();
+
+    if (size < 2) {
+        return 0;
+    }
+
+    // a cheap hash of a shared counter, good enough to spread the samples.
+    unsigned int x = static_cast<unsigned int>(seed_.getAndAdd(1));
+    x *= 0x9E3779B1U;
+    x ^= x >> 15;
+
+    int first = static_cast<int>(x % size);
+    int second = static_cast<int>((x >> 16) % (size - 1));
+
+    if (second >= first) {
+        ++second;
+    }
+
+    const EventLoopPtr& a = pool.loopAt(first);
+    const EventLoopPtr& b = pool.loopAt(second);
+
+    int busyA = a->busyRatio();
+    int busyB = b->busyRatio();
+
+    if (busyA - busyB > BUSY_RATIO_TOLERANCE) {
+        return second;
+    }
+
+    if (busyB - busyA > BUSY_RATIO_TOLERANCE) {
+        return first;
+    }
+
+    int channelsA = a->channelCount();
+    int channelsB = b->channelCount();
+
+    if (channelsA != channelsB) {
+        return channelsA < channelsB ? first : second;
+    }
+
+    return a->pendingTaskCount() <= b->pendingTaskCount() ? first : second;
+}
+
+}
+}
@@ -50,9 +50,24 @@ EventLoopPool::EventLoopPool(int ioThreadCount)
     : started_(false),
       singleThread_(0 == ioThreadCount),
       threadCnt_(ioThreadCount),
-      eventLoopCnt_(singleThread_ ? 1 : ioThreadCount) {
+      eventLoopCnt_(singleThread_ ? 1 : ioThreadCount),
+      chooser_(new RoundRobinEventLoopChooser) {
+    init();
+}
+
+EventLoopPool::EventLoopPool(int ioThreadCount,
+                             const EventLoopThreadPlacement& placement)
+    : started_(false),
+      singleThread_(0 == ioThreadCount),
+      threadCnt_(ioThreadCount),
+      eventLoopCnt_(singleThread_ ? 1 : ioThreadCount),
+      chooser_(new RoundRobinEventLoopChooser),
+      placement_(placement) {
+    init();
+}
 
-    if (ioThreadCount < 0) {
+void EventLoopPool::init() {
+    if (threadCnt_ < 0) {
         threadCnt_ = boost::thread::hardware_concurrency();
         eventLoopCnt_ = threadCnt_;
         LOG_WARN << "poolSize is negative, instead of the cpu number : "
@@ -68,9 +83,29 @@ EventLoopPool::EventLoopPool(int ioThreadCount)
 EventLoopPool::~EventLoopPool() {
 }
 
+void EventLoopPool::setChooser(const EventLoopChooserPtr& chooser) {
+    if (chooser) {
+        boost::atomic_store(&chooser_, chooser);
+    }
+    else {
+        LOG_WARN << "the EventLoopChooser should not be NULL, will not set.";
+    }
+}
+
 void EventLoopPool::insertLoop(const ThreadId& id, const EventLoopPtr& loop) {
     allEventLoops_.insert(std::make_pair(id, loop));
 }
 
+void EventLoopPool::placeLoopThread(int index) {
+    if (singleThread_ || placement_.empty()) {
+        return;
+    }
+
+    if (!placement_.applyToCurrentThread(index)) {
+        LOG_WARN << "the event loop " << index
+                 << " runs without the full thread placement.";
+    }
+}
+
 }
 }
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/EventLoopThreadPlacement.h>
+
+#include <stdlib.h>
+#include <errno.h>
+
+#include <cetty/Platform.h>
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include <cetty/util/StringUtil.h>
+#include <cetty/logging/LoggerHelper.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+
+namespace cetty {
+namespace channel {
+
+using namespace cetty::util;
+using cetty::buffer::PooledChannelBufferFactory;
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+
+// from the <numaif.h>, which comes with the libnuma.
+#if !defined(MPOL_PREFERRED)
+#define MPOL_PREFERRED 1
+#endif
+
+// the preferred node with an empty node mask is the node of the cpu
+// allocating the memory, supported since the early numa kernels.
+static bool setLocalMemoryPolicy() {
+#if defined(SYS_set_mempolicy)
+    return ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, NULL, 0) == 0;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+#endif
+
+EventLoopThreadPlacement::EventLoopThreadPlacement()
+    : numaLocal_(false) {
+}
+
+EventLoopThreadPlacement::EventLoopThreadPlacement(const std::string& namePrefix,
+        const std::vector<int>& cpus,
+        bool numaLocal)
+    : numaLocal_(numaLocal),
+      namePrefix_(namePrefix),
+      cpus_(cpus) {
+}
+
+std::string EventLoopThreadPlacement::threadName(int index) const {
+    std::string suffix = StringUtil::printf("%d", index);
+    std::string::size_type prefixLength =
+        MAX_THREAD_NAME_LENGTH - static_cast<int>(suffix.size());
+
+    return namePrefix_.substr(0, prefixLength) + suffix;
+}
+
+int EventLoopThreadPlacement::cpu(int index) const {
+    if (cpus_.empty() || index < 0) {
+        return -1;
+    }
+
+    return cpus_[index % cpus_.size()];
+}
+
+bool EventLoopThreadPlacement::applyToCurrentThread(int index) const {
+    if (empty()) {
+        return true;
+    }
+
+#if (CETTY_OS == CETTY_OS_LINUX)
+    bool placed = true;
+
+    if (!namePrefix_.empty()) {
+        std::string name = threadName(index);
+
+        if (::prctl(PR_SET_NAME, name.c_str(), 0, 0, 0) < 0) {
+            LOG_WARN << "failed to name the event loop thread " << name
+                     << ", errno: " << errno;
+            placed = false;
+        }
+    }
+
+    // pin first, the memory policy and the arena follow the cpu.
+    int cpu = this->cpu(index);
+
+    if (cpu >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+
+        if (cpu >= CPU_SETSIZE) {
+            LOG_WARN << "the cpu " << cpu << " of the event loop " << index
+                     << " is out of the cpu set, not pinned.";
+            placed = false;
+        }
+        else {
+            CPU_SET(cpu, &cpuSet);
+
+            if (::sched_setaffinity(0, sizeof(cpuSet), &cpuSet) < 0) {
+                LOG_WARN << "failed to pin the event loop " << index
+                         << " to the cpu " << cpu << ", errno: " << errno;
+                placed = false;
+            }
+            else {
+                LOG_INFO << "pinned the event loop " << index
+                         << " to the cpu " << cpu;
+            }
+        }
+    }
+
+    if (numaLocal_) {
+        if (!setLocalMemoryPolicy()) {
+            LOG_WARN << "failed to prefer the local numa node in the event loop "
+                     << index << ", errno: " << errno;
+            placed = false;
+        }
+
+        PooledChannelBufferFactory::prepareThreadArena();
+    }
+
+    return placed;
+#else
+    LOG_WARN << "the event loop thread placement is only supported on Linux,"
+             " the event loop " << index << " is not placed.";
+    return false;
+#endif
+}
+
+bool EventLoopThreadPlacement::parseCpuList(const std::string& list,
+        std::vector<int>* cpus) {
+    if (!cpus) {
+        return false;
+    }
+
+    cpus->clear();
+
+    const char* str = list.c_str();
+
+    while (*str) {
+        if (*str == ' ' || *str == ',') {
+            ++str;
+            continue;
+        }
+
+        char* end;
+        long first = ::strtol(str, &end, 10);
+
+        if (end == str || first < 0) {
+            cpus->clear();
+            return false;
+        }
+
+        long last = first;
+        str = end;
+
+        if (*str == '-') {
+            ++str;
+            last = ::strtol(str, &end, 10);
+
+            if (end == str || last < first) {
+                cpus->clear();
+                return false;
+            }
+
+            str = end;
+        }
+
+        if (*str && *str != ',' && *str != ' ') {
+            cpus->clear();
+            return false;
+        }
+
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus->push_back(static_cast<int>(cpu));
+        }
+    }
+
+    return true;
+}
+
+}
+}
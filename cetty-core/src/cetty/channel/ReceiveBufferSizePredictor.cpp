@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/ReceiveBufferSizePredictor.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <cetty/Types.h>
+#include <cetty/util/Exception.h>
+
+namespace cetty {
+namespace channel {
+
+using namespace cetty::util;
+
+static const int INDEX_INCREMENT = 4;
+static const int INDEX_DECREMENT = 1;
+
+class SizeTable {
+public:
+    SizeTable() {
+        for (int i = 16; i < 512; i += 16) {
+            sizes.push_back(i);
+        }
+
+        for (int i = 512; i > 0 && i < MAX_INT32 / 2; i <<= 1) {
+            sizes.push_back(i);
+        }
+    }
+
+    // the index of the first size not less than the size.
+    int index(int size) const {
+        std::vector<int>::const_iterator itr =
+            std::lower_bound(sizes.begin(), sizes.end(), size);
+
+        if (itr == sizes.end()) {
+            return static_cast<int>(sizes.size()) - 1;
+        }
+
+        return static_cast<int>(itr - sizes.begin());
+    }
+
+    int size(int index) const {
+        return sizes[index];
+    }
+
+private:
+    std::vector<int> sizes;
+};
+
+static const SizeTable SIZE_TABLE;
+
+AdaptiveReceiveBufferSizePredictor::AdaptiveReceiveBufferSizePredictor() {
+    init(DEFAULT_MINIMUM, DEFAULT_INITIAL, DEFAULT_MAXIMUM);
+}
+
+AdaptiveReceiveBufferSizePredictor::AdaptiveReceiveBufferSizePredictor(
+    int minimum, int initial, int maximum) {
+    init(minimum, initial, maximum);
+}
+
+void AdaptiveReceiveBufferSizePredictor::init(int minimum,
+        int initial,
+        int maximum) {
+    if (minimum <= 0) {
+        throw InvalidArgumentException("minimum should be positive.");
+    }
+
+    if (initial < minimum) {
+        throw InvalidArgumentException("initial should not less than minimum.");
+    }
+
+    if (maximum < initial) {
+        throw InvalidArgumentException("maximum should not less than initial.");
+    }
+
+    int minIndex = SIZE_TABLE.index(minimum);
+
+    if (SIZE_TABLE.size(minIndex) < minimum) {
+        minIndex_ = minIndex + 1;
+    }
+    else {
+        minIndex_ = minIndex;
+    }
+
+    int maxIndex = SIZE_TABLE.index(maximum);
+
+    if (SIZE_TABLE.size(maxIndex) > maximum) {
+        maxIndex_ = maxIndex - 1;
+    }
+    else {
+        maxIndex_ = maxIndex;
+    }
+
+    index_ = SIZE_TABLE.index(initial);
+    nextReceiveBufferSize_ = SIZE_TABLE.size(index_);
+    decreaseNow_ = false;
+}
+
+void AdaptiveReceiveBufferSizePredictor::previousReceiveBufferSize(
+    int previousReceiveBufferSize) {
+    if (previousReceiveBufferSize <= SIZE_TABLE.size(
+                std::max(0, index_ - INDEX_DECREMENT - 1))) {
+        if (decreaseNow_) {
+            index_ = std::max(index_ - INDEX_DECREMENT, minIndex_);
+            nextReceiveBufferSize_ = SIZE_TABLE.size(index_);
+            decreaseNow_ = false;
+        }
+        else {
+            decreaseNow_ = true;
+        }
+    }
+    else if (previousReceiveBufferSize >= nextReceiveBufferSize_) {
+        index_ = std::min(index_ + INDEX_INCREMENT, maxIndex_);
+        nextReceiveBufferSize_ = SIZE_TABLE.size(index_);
+        decreaseNow_ = false;
+    }
+}
+
+}
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/asio/AsioHashedWheelTimer.h>
+
+#include <boost/bind.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cetty/util/CachedClock.h>
+#include <cetty/channel/asio/AsioService.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace asio {
+
+AsioHashedWheelTimeout::AsioHashedWheelTimeout(AsioHashedWheelTimer& timer,
+        int64_t deadline,
+        int64_t period,
+        const Handler& handler)
+    : state_(TIMER_UNINITIALIZED),
+      bucket_(-1),
+      remainingRounds_(0),
+      deadline_(deadline),
+      period_(period > 0 ? period : 0),
+      handler_(handler),
+      timer_(timer),
+      prev_(NULL),
+      next_(NULL) {
+}
+
+AsioHashedWheelTimeout::~AsioHashedWheelTimeout() {
+}
+
+bool AsioHashedWheelTimeout::isExpired() const {
+    return state_.get() == TIMER_EXPIRED;
+}
+
+bool AsioHashedWheelTimeout::isCancelled() const {
+    return state_.get() == TIMER_CANCELLED;
+}
+
+bool AsioHashedWheelTimeout::isActived() const {
+    return state_.get() == TIMER_ACTIVE;
+}
+
+void AsioHashedWheelTimeout::cancel() {
+    // the loop thread may expire or reschedule the timeout meanwhile.
+    for (;;) {
+        int state = state_.get();
+
+        if (state == TIMER_CANCELLED || (state == TIMER_EXPIRED && !period_)) {
+            return;
+        }
+
+        if (state_.compareAndSet(state, TIMER_CANCELLED)) {
+            break;
+        }
+    }
+
+    if (timer_.service_.inLoopThread()) {
+        timer_.cancel(AsioHashedWheelTimeoutPtr(this));
+    }
+    else {
+        timer_.service_.post(boost::bind(&AsioHashedWheelTimer::cancel,
+                                         &timer_,
+                                         AsioHashedWheelTimeoutPtr(this)));
+    }
+}
+
+boost::int64_t AsioHashedWheelTimeout::expiresFromNow() const {
+    return deadline_ - timer_.now();
+}
+
+AsioHashedWheelTimer::AsioHashedWheelTimer(AsioService& service)
+    : service_(service),
+      tickDuration_(DEFAULT_TICK_DURATION),
+      mask_(DEFAULT_TICKS_PER_WHEEL - 1),
+      pendingTimeouts_(0),
+      ticking_(false),
+      lastTick_(0),
+      startTime_(boost::posix_time::microsec_clock::universal_time()),
+      tickTimer_(service.service()),
+      wheel_(DEFAULT_TICKS_PER_WHEEL) {
+}
+
+AsioHashedWheelTimer::AsioHashedWheelTimer(AsioService& service,
+        int tickDuration,
+        int ticksPerWheel)
+    : service_(service),
+      tickDuration_(tickDuration > 0 ? tickDuration : DEFAULT_TICK_DURATION),
+      mask_(0),
+      pendingTimeouts_(0),
+      ticking_(false),
+      lastTick_(0),
+      startTime_(boost::posix_time::microsec_clock::universal_time()),
+      tickTimer_(service.service()) {
+    // normalize to the power of two.
+    int size = 1;
+
+    while (size < ticksPerWheel) {
+        size <<= 1;
+    }
+
+    mask_ = size - 1;
+    wheel_.resize(size);
+}
+
+AsioHashedWheelTimer::~AsioHashedWheelTimer() {
+    boost::system::error_code error;
+    tickTimer_.cancel(error);
+
+    for (std::size_t i = 0; i < wheel_.size(); ++i) {
+        while (wheel_[i]) {
+            AsioHashedWheelTimeout* timeout = wheel_[i];
+            timeout->state_.set(AsioHashedWheelTimeout::TIMER_CANCELLED);
+            unlink(timeout);
+        }
+    }
+}
+
+TimeoutPtr AsioHashedWheelTimer::newTimeout(int64_t delay,
+        int64_t period,
+        const Handler& handler) {
+    if (!handler) {
+        LOG_WARN << "Timer handler is empty, do nothing.";
+        return TimeoutPtr();
+    }
+
+    return newTimeoutAt(now() + (delay > 0 ? delay : 0), period, handler);
+}
+
+TimeoutPtr AsioHashedWheelTimer::newTimeout(const boost::posix_time::ptime& timestamp,
+        const Handler& handler) {
+    if (!handler) {
+        LOG_WARN << "Timer handler is empty, do nothing.";
+        return TimeoutPtr();
+    }
+
+    // the deadline on the timeline of the wheel, not a delay from another
+    // clock, a passed one expires in the next tick.
+    int64_t deadline = (timestamp - startTime_).total_milliseconds();
+    return newTimeoutAt(deadline > 0 ? deadline : 0, 0, handler);
+}
+
+TimeoutPtr AsioHashedWheelTimer::newTimeoutAt(int64_t deadline,
+        int64_t period,
+        const Handler& handler) {
+    AsioHashedWheelTimeoutPtr timeout(
+        new AsioHashedWheelTimeout(*this, deadline, period, handler));
+
+    timeout->state_.set(AsioHashedWheelTimeout::TIMER_ACTIVE);
+
+    if (service_.inLoopThread()) {
+        schedule(timeout);
+    }
+    else {
+        service_.post(boost::bind(&AsioHashedWheelTimer::schedule,
+                                  this,
+                                  timeout));
+    }
+
+    return boost::static_pointer_cast<Timeout>(timeout);
+}
+
+int64_t AsioHashedWheelTimer::now() const {
+    return (CachedClock::now() - startTime_).total_milliseconds();
+}
+
+void AsioHashedWheelTimer::schedule(const AsioHashedWheelTimeoutPtr& timeout) {
+    // cancelled before the posted scheduling.
+    if (timeout->state_.get() != AsioHashedWheelTimeout::TIMER_ACTIVE) {
+        return;
+    }
+
+    if (!ticking_) {
+        startTicking();
+    }
+
+    // the first tick not earlier than the deadline.
+    int64_t ticks = (timeout->deadline_ + tickDuration_ - 1) / tickDuration_;
+
+    if (ticks <= lastTick_) {
+        ticks = lastTick_ + 1;
+    }
+
+    timeout->remainingRounds_ = (ticks - lastTick_ - 1) / (mask_ + 1);
+    timeout->bucket_ = static_cast<int>(ticks & mask_);
+
+    link(timeout.get());
+}
+
+void AsioHashedWheelTimer::cancel(const AsioHashedWheelTimeoutPtr& timeout) {
+    if (timeout->bucket_ >= 0) {
+        unlink(timeout.get());
+    }
+}
+
+void AsioHashedWheelTimer::link(AsioHashedWheelTimeout* timeout) {
+    AsioHashedWheelTimeout*& head = wheel_[timeout->bucket_];
+
+    timeout->prev_ = NULL;
+    timeout->next_ = head;
+
+    if (head) {
+        head->prev_ = timeout;
+    }
+
+    head = timeout;
+
+    timeout->duplicate();
+    ++pendingTimeouts_;
+}
+
+void AsioHashedWheelTimer::unlink(AsioHashedWheelTimeout* timeout) {
+    if (timeout->prev_) {
+        timeout->prev_->next_ = timeout->next_;
+    }
+    else {
+        wheel_[timeout->bucket_] = timeout->next_;
+    }
+
+    if (timeout->next_) {
+        timeout->next_->prev_ = timeout->prev_;
+    }
+
+    timeout->prev_ = NULL;
+    timeout->next_ = NULL;
+    timeout->bucket_ = -1;
+
+    --pendingTimeouts_;
+    timeout->release();
+}
+
+void AsioHashedWheelTimer::startTicking() {
+    ticking_ = true;
+    lastTick_ = now() / tickDuration_;
+
+    tickTimer_.expires_at(startTime_ +
+                          boost::posix_time::milliseconds((lastTick_ + 1) * tickDuration_));
+    tickTimer_.async_wait(boost::bind(&AsioHashedWheelTimer::tick,
+                                      this,
+                                      boost::asio::placeholders::error));
+}
+
+void AsioHashedWheelTimer::tick(const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+
+    AsioService::BusyTime busyTime(service_);
+    std::vector<AsioHashedWheelTimeoutPtr> expired;
+    int64_t currentTick = now() / tickDuration_;
+
+    while (lastTick_ < currentTick) {
+        ++lastTick_;
+        expireBucket(static_cast<int>(lastTick_ & mask_), &expired);
+    }
+
+    for (std::size_t i = 0; i < expired.size(); ++i) {
+        AsioHashedWheelTimeout* timeout = expired[i].get();
+
+        // cancelled by the handlers expired before, or by another thread.
+        if (!timeout->state_.compareAndSet(AsioHashedWheelTimeout::TIMER_ACTIVE,
+                                           AsioHashedWheelTimeout::TIMER_EXPIRED)) {
+            continue;
+        }
+
+        timeout->handler_();
+
+        if (timeout->period_ > 0
+                && timeout->state_.compareAndSet(AsioHashedWheelTimeout::TIMER_EXPIRED,
+                                                 AsioHashedWheelTimeout::TIMER_ACTIVE)) {
+            timeout->deadline_ += timeout->period_;
+            schedule(expired[i]);
+        }
+    }
+
+    if (pendingTimeouts_ > 0) {
+        tickTimer_.expires_at(startTime_ +
+                              boost::posix_time::milliseconds((lastTick_ + 1) * tickDuration_));
+        tickTimer_.async_wait(boost::bind(&AsioHashedWheelTimer::tick,
+                                          this,
+                                          boost::asio::placeholders::error));
+    }
+    else {
+        // stop ticking when idle, restarted by the next scheduling.
+        ticking_ = false;
+    }
+}
+
+void AsioHashedWheelTimer::expireBucket(int bucket,
+                                        std::vector<AsioHashedWheelTimeoutPtr>* expired) {
+    AsioHashedWheelTimeout* timeout = wheel_[bucket];
+
+    while (timeout) {
+        AsioHashedWheelTimeout* next = timeout->next_;
+
+        if (timeout->remainingRounds_ <= 0) {
+            expired->push_back(AsioHashedWheelTimeoutPtr(timeout));
+            unlink(timeout);
+        }
+        else {
+            --timeout->remainingRounds_;
+        }
+
+        timeout = next;
+    }
+}
+
+}
+}
+}
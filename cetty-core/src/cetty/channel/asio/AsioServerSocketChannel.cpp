@@ -30,6 +30,20 @@ namespace asio {
 
 using namespace cetty::channel;
 
+#if defined(SO_REUSEPORT)
+typedef boost::asio::detail::socket_option::boolean<
+SOL_SOCKET, SO_REUSEPORT> ReusePort;
+#endif
+
+AsioServerSocketChannel::ChildAcceptor::ChildAcceptor(int index,
+        const AsioServicePtr& ioService)
+    : index(index),
+      lastChildId(0),
+      ioService(ioService),
+      acceptor(ioService->service()),
+      acceptedCount(0) {
+}
+
 AsioServerSocketChannel::AsioServerSocketChannel(
     const EventLoopPtr& eventLoop,
     const EventLoopPoolPtr& childEventLoopPool)
@@ -40,7 +54,8 @@ AsioServerSocketChannel::AsioServerSocketChannel(
       ioService_(boost::dynamic_pointer_cast<AsioService>(eventLoop)),
       acceptor_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
       serverConfig_(acceptor_),
-      childServicePool_(boost::dynamic_pointer_cast<AsioServicePool>(childEventLoopPool)) {
+      childServicePool_(boost::dynamic_pointer_cast<AsioServicePool>(childEventLoopPool)),
+      acceptedCount_(0) {
     boost::system::error_code ec;
 
     if (addressFamily_ == InetAddress::FAMILY_IPv4) {
@@ -64,6 +79,27 @@ AsioServerSocketChannel::AsioServerSocketChannel(
 AsioServerSocketChannel::~AsioServerSocketChannel() {
 }
 
+void AsioServerSocketChannel::setChildInitializer(
+    const ChildInitializer& initializer) {
+    childInitializer_ = initializer;
+}
+
+int AsioServerSocketChannel::acceptorCount() const {
+    return childAcceptors_.empty() ? 1 : static_cast<int>(childAcceptors_.size());
+}
+
+int64_t AsioServerSocketChannel::acceptedCount(int index) const {
+    if (childAcceptors_.empty()) {
+        return index == 0 ? acceptedCount_.get() : 0;
+    }
+
+    if (index < 0 || index >= static_cast<int>(childAcceptors_.size())) {
+        return 0;
+    }
+
+    return childAcceptors_[index]->acceptedCount.get();
+}
+
 bool AsioServerSocketChannel::doBind(const InetAddress& localAddress) {
     const std::string& host = localAddress.host();
 
@@ -72,76 +108,97 @@ bool AsioServerSocketChannel::doBind(const InetAddress& localAddress) {
         boost::asio::ip::address::from_string(host),
         localAddress.port());
 
-    if (localAddress.family() != addressFamily_) {
-        acceptor_.close(ec);
+    const boost::optional<bool>& reusePort = serverConfig_.isReusePort();
 
-        if (ec) {
-            LOG_ERROR << "failed to close the acceptor before change ip family,"
-                      " but skip it.";
+    if (reusePort && *reusePort) {
+        if (!childInitializer_) {
+            LOG_WARN << "server channel " << toString()
+                     << " has no child initializer,"
+                     " can not accept in SO_REUSEPORT mode.";
         }
-
-        acceptor_.open(ep.protocol(), ec);
-
-        if (!ec) {
-            LOG_INFO << "the server channel (acceptor) changed to open in IPV6 mode.";
-        }
-        else {
-            LOG_ERROR << "failed to reopen the acceptor in different ip family.";
+        else if (!bindChildAcceptors(ep)) {
             doClose();
             return false;
         }
+    }
 
-        const boost::optional<bool>& isReuseAddress =
-            serverConfig_.isReuseAddress();
-
-        if (isReuseAddress) {
-            serverConfig_.setReuseAddress(*isReuseAddress);
+    if (!childAcceptors_.empty()) {
+        // the acceptors of the child event loops are listening instead.
+        acceptor_.close(ec);
+    }
+    else {
+        if (localAddress.family() != addressFamily_) {
+            acceptor_.close(ec);
+
+            if (ec) {
+                LOG_ERROR << "failed to close the acceptor before change ip family,"
+                          " but skip it.";
+            }
+
+            acceptor_.open(ep.protocol(), ec);
+
+            if (!ec) {
+                LOG_INFO << "the server channel (acceptor) changed to open in IPV6 mode.";
+            }
+            else {
+                LOG_ERROR << "failed to reopen the acceptor in different ip family.";
+                doClose();
+                return false;
+            }
+
+            const boost::optional<bool>& isReuseAddress =
+                serverConfig_.isReuseAddress();
+
+            if (isReuseAddress) {
+                serverConfig_.setReuseAddress(*isReuseAddress);
+            }
+
+            const boost::optional<int>& receiveBufferSize =
+                serverConfig_.receiveBufferSize();
+
+            if (receiveBufferSize) {
+                serverConfig_.setReceiveBufferSize(*receiveBufferSize);
+            }
         }
 
-        const boost::optional<int>& receiveBufferSize =
-            serverConfig_.receiveBufferSize();
+        acceptor_.bind(ep, ec);
 
-        if (receiveBufferSize) {
-            serverConfig_.setReceiveBufferSize(*receiveBufferSize);
+        if (ec) {
+            LOG_ERROR << "the server channel (acceptor) can not bind to the "
+                      << localAddress.toString();
+            doClose();
+            return false;
         }
-    }
-
-    acceptor_.bind(ep, ec);
 
-    if (ec) {
-        LOG_ERROR << "the server channel (acceptor) can not bind to the "
-                  << localAddress.toString();
-        doClose();
-        return false;
-    }
+        const boost::optional<int>& backlog = serverConfig_.backlog();
 
-    const boost::optional<int>& backlog = serverConfig_.backlog();
-
-    if (backlog) {
-        acceptor_.listen(*backlog, ec);
-    }
-    else {
-        acceptor_.listen(tcp::acceptor::max_connections, ec);
-    }
+        if (backlog) {
+            acceptor_.listen(*backlog, ec);
+        }
+        else {
+            acceptor_.listen(tcp::acceptor::max_connections, ec);
+        }
 
-    if (ec) {
-        LOG_ERROR << "the server channel (acceptor) can not listen the "
-                  << localAddress.toString();
-        doClose();
-        return false;
-    }
+        if (ec) {
+            LOG_ERROR << "the server channel (acceptor) can not listen the "
+                      << localAddress.toString();
+            doClose();
+            return false;
+        }
 
-    // initialize the reserved child channels, for speeding up accepting
-    if (serverConfig_.reservedChildCount()) {
-        int reservedChildCount = *serverConfig_.reservedChildCount();
+        // initialize the reserved child channels, for speeding up accepting
+        if (serverConfig_.reservedChildCount()) {
+            int reservedChildCount = *serverConfig_.reservedChildCount();
 
-        while (reservedChildCount > 0) {
-            reusableChildChannels_.push_back(createChild());
-            --reservedChildCount;
+            while (reservedChildCount > 0) {
+                AsioSocketChannelPtr child = createChild();
+                reusableChildChannels_[child->eventLoop().get()].push_back(child);
+                --reservedChildCount;
+            }
         }
-    }
 
-    accept();
+        accept();
+    }
 
     // start the event loop pool if in main thread mode.
     const EventLoopPoolPtr& loop = ioService_->eventLoopPool();
@@ -182,9 +239,12 @@ void AsioServerSocketChannel::accept() {
 
 void AsioServerSocketChannel::handleAccept(const boost::system::error_code& error,
         const AsioSocketChannelPtr& channel) {
+    AsioService::BusyTime busyTime(*ioService_);
+
     BOOST_ASSERT(channel);
 
     if (!error) {
+        acceptedCount_.incrementAndGet();
         ChannelPtr acceptedChannel = boost::static_pointer_cast<Channel>(channel);
 
         // create the socket add it to the buffer and fire the event
@@ -221,9 +281,280 @@ void AsioServerSocketChannel::handleAccept(const boost::system::error_code& erro
     }
 }
 
+bool AsioServerSocketChannel::bindChildAcceptors(
+    const boost::asio::ip::tcp::endpoint& ep) {
+    BOOST_ASSERT(childAcceptors_.empty());
+
+    if (!childServicePool_) {
+        LOG_ERROR << "server channel " << toString()
+                  << " has no child asio service pool for SO_REUSEPORT mode.";
+        return false;
+    }
+
+    int index = 0;
+    EventLoopPool::Iterator itr = childServicePool_->begin();
+
+    for (; itr != childServicePool_->end(); ++itr, ++index) {
+        AsioServicePtr service =
+            boost::dynamic_pointer_cast<AsioService>(*itr);
+
+        childAcceptors_.push_back(
+            ChildAcceptorPtr(new ChildAcceptor(index, service)));
+    }
+
+    for (std::size_t i = 0; i < childAcceptors_.size(); ++i) {
+        if (!bindChildAcceptor(childAcceptors_[i], ep)) {
+            // nothing has been posted to the loops yet, so release the
+            // ports of the acceptors already listening right here.
+            for (std::size_t j = 0; j <= i; ++j) {
+                boost::system::error_code ec;
+                childAcceptors_[j]->acceptor.close(ec);
+            }
+
+            childAcceptors_.clear();
+            return false;
+        }
+    }
+
+    // begin to accept in the acceptor's own event loop.
+    for (std::size_t i = 0; i < childAcceptors_.size(); ++i) {
+        const ChildAcceptorPtr& acceptor = childAcceptors_[i];
+
+        acceptor->ioService->post(boost::bind(
+                                      &AsioServerSocketChannel::beginAcceptInLoop,
+                                      this,
+                                      acceptor));
+    }
+
+    LOG_INFO << "server channel " << toString() << " opened "
+             << childAcceptors_.size() << " SO_REUSEPORT acceptors.";
+
+    return true;
+}
+
+bool AsioServerSocketChannel::bindChildAcceptor(
+    const ChildAcceptorPtr& acceptor,
+    const boost::asio::ip::tcp::endpoint& ep) {
+#if defined(SO_REUSEPORT)
+    boost::system::error_code ec;
+    tcp::acceptor& a = acceptor->acceptor;
+
+    a.open(ep.protocol(), ec);
+
+    if (!ec) {
+        a.set_option(ReusePort(true), ec);
+    }
+
+    if (!ec) {
+        const boost::optional<bool>& reuseAddress =
+            serverConfig_.isReuseAddress();
+
+        if (reuseAddress) {
+            a.set_option(tcp::acceptor::reuse_address(*reuseAddress), ec);
+        }
+    }
+
+    if (!ec) {
+        const boost::optional<int>& receiveBufferSize =
+            serverConfig_.receiveBufferSize();
+
+        if (receiveBufferSize) {
+            a.set_option(tcp::acceptor::receive_buffer_size(*receiveBufferSize), ec);
+        }
+    }
+
+    if (!ec) {
+        a.bind(ep, ec);
+    }
+
+    if (!ec) {
+        const boost::optional<int>& backlog = serverConfig_.backlog();
+        a.listen(backlog ? *backlog : tcp::acceptor::max_connections, ec);
+    }
+
+    if (ec) {
+        LOG_ERROR << "the SO_REUSEPORT acceptor " << acceptor->index
+                  << " of server channel " << toString()
+                  << " failed to listen, code: " << ec.value()
+                  << " message: " << ec.message();
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AsioServerSocketChannel::beginAcceptInLoop(
+    const ChildAcceptorPtr& acceptor) {
+    if (serverConfig_.reservedChildCount()) {
+        int reservedChildCount = *serverConfig_.reservedChildCount();
+
+        while (reservedChildCount > 0) {
+            acceptor->reusableChildChannels.push_back(createChildInLoop(acceptor));
+            --reservedChildCount;
+        }
+    }
+
+    acceptInLoop(acceptor);
+}
+
+void AsioServerSocketChannel::acceptInLoop(const ChildAcceptorPtr& acceptor) {
+    if (!acceptor->acceptor.is_open()) {
+        return;
+    }
+
+    AsioSocketChannelPtr c = createChildInLoop(acceptor);
+    acceptor->acceptor.async_accept(c->tcpSocket(),
+                                    makeCustomAllocHandler(acceptor->acceptAllocator,
+                                            boost::bind(&AsioServerSocketChannel::handleAcceptInLoop,
+                                                    this,
+                                                    boost::asio::placeholders::error,
+                                                    c,
+                                                    acceptor)));
+}
+
+void AsioServerSocketChannel::handleAcceptInLoop(
+    const boost::system::error_code& error,
+    const AsioSocketChannelPtr& channel,
+    const ChildAcceptorPtr& acceptor) {
+    AsioService::BusyTime busyTime(*acceptor->ioService);
+
+    BOOST_ASSERT(channel);
+
+    if (error) {
+        if (error != boost::asio::error::operation_aborted) {
+            LOG_ERROR << "the SO_REUSEPORT acceptor " << acceptor->index
+                      << " of server channel " << toString()
+                      << " failed to accept a connection any more. ErrorCode: "
+                      << error.value()
+                      << ", Message: " << error.message();
+        }
+
+        return;
+    }
+
+    acceptor->acceptedCount.incrementAndGet();
+
+    // accepted in the event loop which the channel belongs to,
+    // so initialize and serve it right here.
+    childInitializer_(boost::static_pointer_cast<Channel>(channel));
+
+    acceptor->childChannels.insert(std::make_pair(channel->id(), channel));
+    channel->closeFuture()->addListener(boost::bind(
+                                            &AsioServerSocketChannel::handleChildClosedInLoop,
+                                            this,
+                                            _1,
+                                            acceptor),
+                                        100);
+    channel->open();
+    channel->setActived();
+    LOG_INFO << "server channel " << toString()
+             << " accepted a new channel " << channel->toString()
+             << " in acceptor " << acceptor->index;
+
+    channel->beginRead();
+
+    acceptInLoop(acceptor);
+}
+
+AsioSocketChannelPtr AsioServerSocketChannel::createChildInLoop(
+    const ChildAcceptorPtr& acceptor) {
+    if (!acceptor->reusableChildChannels.empty()) {
+        AsioSocketChannelPtr newChannel = acceptor->reusableChildChannels.front();
+        acceptor->reusableChildChannels.pop_front();
+
+        return newChannel;
+    }
+
+    // interleave the ids, so the children of all acceptors are unique.
+    int id = acceptor->lastChildId++ * static_cast<int>(childAcceptors_.size())
+             + acceptor->index + 1;
+
+    return AsioSocketChannelPtr(
+               new AsioSocketChannel(id,
+                                     shared_from_this(),
+                                     acceptor->ioService));
+}
+
+void AsioServerSocketChannel::handleChildClosedInLoop(
+    const ChannelFuture& future,
+    const ChildAcceptorPtr& acceptor) {
+    removeChildInLoop(future.channel()->id(), acceptor);
+}
+
+void AsioServerSocketChannel::removeChildInLoop(
+    int childId,
+    const ChildAcceptorPtr& acceptor) {
+    // the future may not live till the posted handler runs, bind the id.
+    if (!acceptor->ioService->inLoopThread()) {
+        acceptor->ioService->post(boost::bind(
+                                      &AsioServerSocketChannel::removeChildInLoop,
+                                      this,
+                                      childId,
+                                      acceptor));
+        return;
+    }
+
+    ChildChannels::iterator itr = acceptor->childChannels.find(childId);
+
+    if (itr == acceptor->childChannels.end()) {
+        return;
+    }
+
+    const boost::optional<bool>& reuseChild = serverConfig_.isReuseChild();
+
+    if ((!reuseChild || *reuseChild) && acceptor->acceptor.is_open()) {
+        acceptor->reusableChildChannels.push_back(itr->second);
+    }
+
+    acceptor->childChannels.erase(itr);
+}
+
+void AsioServerSocketChannel::closeChildAcceptor(
+    const ChildAcceptorPtr& acceptor) {
+    if (!acceptor->ioService->inLoopThread()) {
+        acceptor->ioService->post(boost::bind(
+                                      &AsioServerSocketChannel::closeChildAcceptor,
+                                      this,
+                                      acceptor));
+        return;
+    }
+
+    boost::system::error_code error;
+
+    if (acceptor->acceptor.is_open()) {
+        acceptor->acceptor.close(error);
+
+        if (error) {
+            LOG_ERROR << "server channel" << toString()
+                      << " failed to close the acceptor " << acceptor->index
+                      << ", error:" << error.value() << ":" << error.message();
+        }
+    }
+
+    std::vector<AsioSocketChannelPtr> children;
+    ChildChannels::iterator itr = acceptor->childChannels.begin();
+
+    for (; itr != acceptor->childChannels.end(); ++itr) {
+        children.push_back(itr->second);
+    }
+
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        children[i]->close(children[i]->newVoidFuture());
+    }
+
+    acceptor->reusableChildChannels.clear();
+}
+
 bool AsioServerSocketChannel::doClose() {
     boost::system::error_code error;
 
+    for (std::size_t i = 0; i < childAcceptors_.size(); ++i) {
+        closeChildAcceptor(childAcceptors_[i]);
+    }
+
     if (acceptor_.is_open()) {
         acceptor_.close(error);
 
@@ -255,9 +586,16 @@ bool AsioServerSocketChannel::doDisconnect() {
 }
 
 void AsioServerSocketChannel::handleChildClosed(const ChannelFuture& future) {
+    removeChild(future.channel()->id());
+}
+
+void AsioServerSocketChannel::removeChild(int childId) {
     if (eventLoop()->inLoopThread()) {
-        ChildChannels::iterator itr =
-            childChannels_.find(future.channel()->id());
+        ChildChannels::iterator itr = childChannels_.find(childId);
+
+        if (itr == childChannels_.end()) {
+            return;
+        }
 
 #if !defined(NDEBUG)
         AsioSocketChannelPtr ch = itr->second;
@@ -274,7 +612,8 @@ void AsioServerSocketChannel::handleChildClosed(const ChannelFuture& future) {
 
         // only if reuseChild set to false, will not recycle the channel.
         if (!reuseChild || *reuseChild) {
-            reusableChildChannels_.push_back(itr->second);
+            const AsioSocketChannelPtr& child = itr->second;
+            reusableChildChannels_[child->eventLoop().get()].push_back(child);
             LOG_INFO << "the channel: " << ch->id()
                      << " push to reusable pool.";
         }
@@ -282,9 +621,10 @@ void AsioServerSocketChannel::handleChildClosed(const ChannelFuture& future) {
         childChannels_.erase(itr);
     }
     else {
-        eventLoop()->post(boost::bind(&AsioServerSocketChannel::handleChildClosed,
+        // the future may not live till the posted handler runs, bind the id.
+        eventLoop()->post(boost::bind(&AsioServerSocketChannel::removeChild,
                                       this,
-                                      boost::cref(future)));
+                                      childId));
     }
 }
 
@@ -303,14 +643,17 @@ void AsioServerSocketChannel::doPreOpen() {
 }
 
 AsioSocketChannelPtr AsioServerSocketChannel::createChild() {
-    if (!reusableChildChannels_.empty()) {
-        AsioSocketChannelPtr newChannel = reusableChildChannels_.front();
-        reusableChildChannels_.pop_front();
+    // the child pool chooses the loop first, then reuse a child in that loop.
+    const AsioServicePtr& ioService = childServicePool_->nextService();
+    ReusableChildChannels& reusables = reusableChildChannels_[ioService.get()];
+
+    if (!reusables.empty()) {
+        AsioSocketChannelPtr newChannel = reusables.front();
+        reusables.pop_front();
 
         return newChannel;
     }
     else {
-        const AsioServicePtr& ioService = childServicePool_->nextService();
         return AsioSocketChannelPtr(
                    new AsioSocketChannel(++lastChildId_,
                                          shared_from_this(),
@@ -56,6 +56,9 @@ bool AsioServerSocketChannelConfig::setOption(const ChannelOption& option,
     else if (option == ChannelOption::CO_RESERVED_CHILD_COUNT) {
         setReservedChildCount(boost::get<int>(value));
     }
+    else if (option == ChannelOption::CO_SO_REUSEPORT) {
+        setReusePort(boost::get<bool>(value));
+    }
     else {
         return false;
     }
@@ -156,6 +159,19 @@ void AsioServerSocketChannelConfig::setReservedChildCount(int count) {
     }
 }
 
+void AsioServerSocketChannelConfig::setReusePort(bool reusePort) {
+#if defined(SO_REUSEPORT)
+    reusePort_ = reusePort;
+#else
+    if (reusePort) {
+        LOG_WARN << "SO_REUSEPORT is not supported in this platform,"
+                 " will accept in one acceptor.";
+    }
+
+    reusePort_ = false;
+#endif
+}
+
 }
 }
 }
@@ -16,6 +16,7 @@
 
 #include <cetty/channel/asio/AsioService.h>
 
+#include <cetty/util/CachedClock.h>
 #include <cetty/logging/LoggerHelper.h>
 
 namespace cetty {
@@ -29,17 +30,98 @@ AsioService::AsioService(const EventLoopPoolPtr& pool)
       timerId_(0) {
 }
 
+AsioService::AsioService(const EventLoopPoolPtr& pool, bool timerWheel)
+    : EventLoop(pool),
+      timerId_(0) {
+    if (timerWheel) {
+        timerWheel_.reset(new AsioHashedWheelTimer(*this));
+    }
+}
+
 void AsioService::stop() {
     EventLoop::stop();
     ioService_.stop();
 }
 
+AsioService::BusyTime::BusyTime(AsioService& service)
+    : service_(service),
+      start_(CachedClock::nowInMicros()) {
+}
+
+AsioService::BusyTime::~BusyTime() {
+    CachedClock::invalidate();
+
+    int64_t end = CachedClock::nowInMicros();
+    service_.addBusyTime(end, end - start_);
+}
+
+AsioService::RunningHandlersGuard::RunningHandlersGuard(AsioService& service)
+    : next(0),
+      service_(service) {
+}
+
+AsioService::RunningHandlersGuard::~RunningHandlersGuard() {
+    std::vector<Handler>& running = service_.runningHandlers_;
+
+    if (next < running.size()) {
+        bool wasEmpty;
+
+        {
+            boost::lock_guard<boost::mutex> lock(service_.postedMutex_);
+            std::vector<Handler>& posted = service_.postedHandlers_;
+
+            wasEmpty = posted.empty();
+            posted.insert(posted.begin(), running.begin() + next, running.end());
+        }
+
+        if (wasEmpty) {
+            service_.ioService_.post(boost::bind(&AsioService::runPostedHandlers,
+                                                 &service_));
+        }
+    }
+
+    running.clear();
+}
+
 void AsioService::post(const Handler& handler) {
-    ioService_.post(handler);
+    bool wasEmpty;
+
+    taskPosted();
+
+    {
+        boost::lock_guard<boost::mutex> lock(postedMutex_);
+        wasEmpty = postedHandlers_.empty();
+        postedHandlers_.push_back(handler);
+    }
+
+    // only the first handler of a batch goes through the io_service.
+    if (wasEmpty) {
+        ioService_.post(boost::bind(&AsioService::runPostedHandlers, this));
+    }
+}
+
+void AsioService::runPostedHandlers() {
+    BusyTime busyTime(*this);
+    RunningHandlersGuard guard(*this);
+
+    {
+        boost::lock_guard<boost::mutex> lock(postedMutex_);
+        runningHandlers_.swap(postedHandlers_);
+    }
+
+    // the handlers posted meanwhile start a new batch.
+    while (guard.next < runningHandlers_.size()) {
+        taskCompleted();
+        runningHandlers_[guard.next++]();
+    }
 }
 
 TimeoutPtr AsioService::runAt(const boost::posix_time::ptime& timestamp,
                               const Handler& handler) {
+    if (timerWheel_) {
+        return timerWheel_->newTimeout(timestamp, handler);
+    }
+
     if (handler) {
         AsioDeadlineTimeoutPtr timeout
             = new AsioDeadlineTimeout(*this, timerId_++, timestamp);
@@ -68,6 +150,10 @@ TimeoutPtr AsioService::runAt(const boost::posix_time::ptime& timestamp,
 
 TimeoutPtr AsioService::runAfter(int64_t millisecond,
                                  const Handler& handler) {
+    if (timerWheel_) {
+        return timerWheel_->newTimeout(millisecond, 0, handler);
+    }
+
     if (handler) {
         AsioDeadlineTimeoutPtr timeout
             = new AsioDeadlineTimeout(*this, timerId_++, millisecond);
@@ -96,6 +182,10 @@ TimeoutPtr AsioService::runAfter(int64_t millisecond,
 
 TimeoutPtr AsioService::runEvery(int64_t millisecond,
                                  const Handler& handler) {
+    if (timerWheel_) {
+        return timerWheel_->newTimeout(millisecond, millisecond, handler);
+    }
+
     if (handler) {
         AsioDeadlineTimeoutPtr timeout
             = new AsioDeadlineTimeout(*this, timerId_++, millisecond);
@@ -125,6 +215,8 @@ TimeoutPtr AsioService::runEvery(int64_t millisecond,
 void AsioService::timerExpiresCallback(const boost::system::error_code& code,
                                        const Handler& handler,
                                        const AsioDeadlineTimeoutPtr& timeout) {
+    BusyTime busyTime(*this);
+
     if (code != boost::asio::error::operation_aborted) {
         timeout->setState(AsioDeadlineTimeout::TIMER_EXPIRED);
 
@@ -151,6 +243,8 @@ void AsioService::repeatTimerExpiresCallback(const boost::system::error_code& co
         const Handler& handler,
         int64_t millisecond,
         const AsioDeadlineTimeoutPtr& timeout) {
+    BusyTime busyTime(*this);
+
     if (code != boost::asio::error::operation_aborted) {
         timeout->setState(AsioDeadlineTimeout::TIMER_EXPIRED);
 
@@ -26,6 +26,7 @@
 
 #include <cetty/Types.h>
 #include <cetty/util/Exception.h>
+#include <cetty/util/CachedClock.h>
 #include <cetty/logging/LoggerHelper.h>
 
 #include <cetty/channel/asio/AsioService.h>
@@ -96,14 +97,28 @@ private:
 };
 
 AsioServicePool::AsioServicePool(int threadCnt)
-    : EventLoopPool(threadCnt),
-      nextServiceIndex_(0) {
+    : EventLoopPool(threadCnt) {
+    init(false);
+}
+
+AsioServicePool::AsioServicePool(int threadCnt, bool timerWheel)
+    : EventLoopPool(threadCnt) {
+    init(timerWheel);
+}
+
+AsioServicePool::AsioServicePool(int threadCnt,
+                                 bool timerWheel,
+                                 const EventLoopThreadPlacement& placement)
+    : EventLoopPool(threadCnt, placement) {
+    init(timerWheel);
+}
 
+void AsioServicePool::init(bool timerWheel) {
     // Give all the io_services work to do so that their run() functions will not
     // exit until they are explicitly stopped.
     for (int i = 0; i < size(); ++i) {
         appendLoopHolder(new AsioServiceHolder(
-                             new AsioService(shared_from_this())));
+                             new AsioService(shared_from_this(), timerWheel)));
     }
 
     // automatic start
@@ -117,9 +132,10 @@ AsioServicePool::AsioServicePool(int threadCnt)
 
             holder->setThread(
                 ThreadPtr(new boost::thread(
-                              boost::bind(&AsioServicePool::runIOservice,
+                              boost::bind(&AsioServicePool::runIOserviceInThread,
                                           this,
-                                          holder))));
+                                          holder,
+                                          i))));
         }
 
         setStarted(true);
@@ -194,7 +210,20 @@ int AsioServicePool::runIOservice(AsioServiceHolder* holder) {
     }
 
     boost::system::error_code err;
-    std::size_t opCount = service->service().run(err);
+    std::size_t opCount = 0;
+    boost::asio::io_service& ioService = service->service();
+
+    // the timestamps in one handler share one system clock reading.
+    CachedClock::enable();
+
+    // the handlers measure the time running them for the busy ratio,
+    // see AsioService::BusyTime, so the loop only blocks in run_one.
+    while (ioService.run_one(err)) {
+        ++opCount;
+        CachedClock::invalidate();
+    }
+
+    CachedClock::disable();
 
     // if error happened, try to recover.
     if (err) {
@@ -207,27 +236,17 @@ int AsioServicePool::runIOservice(AsioServiceHolder* holder) {
     return opCount;
 }
 
+int AsioServicePool::runIOserviceInThread(AsioServiceHolder* holder, int index) {
+    placeLoopThread(index);
+    return runIOservice(holder);
+}
+
 const EventLoopPtr& AsioServicePool::nextLoop() {
     return nextServiceHolder()->eventLoop();
 }
 
 AsioServiceHolder* AsioServicePool::nextServiceHolder() {
-    // Only one service.
-    if (size() == 1) {
-        return down_cast<AsioServiceHolder*>(loopHolderAt(0));
-    }
-
-    // Use a round-robin scheme to choose the next io_service to use.
-    AsioServiceHolder* holder =
-        down_cast<AsioServiceHolder*>(loopHolderAt(nextServiceIndex_));
-
-    ++nextServiceIndex_;
-
-    if (nextServiceIndex_ == size()) {
-        nextServiceIndex_ = 0;
-    }
-
-    return holder;
+    return down_cast<AsioServiceHolder*>(loopHolderAt(nextLoopIndex()));
 }
 
 }
@@ -32,6 +32,7 @@
 
 #include <cetty/buffer/ChannelBuffer.h>
 #include <cetty/buffer/CompositeChannelBuffer.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
 
 #include <cetty/util/StringUtil.h>
 #include <cetty/logging/LoggerHelper.h>
@@ -58,11 +59,14 @@ AsioSocketChannel::AsioSocketChannel(const ChannelPtr& parent,
       isWriting_(false),
       isConnecting_(false),
       initialized_(false),
+      readPending_(false),
+      writable_(1),
       highWaterMarkCounter_(0),
+      writingOperations_(0),
       ioService_(boost::dynamic_pointer_cast<AsioService>(eventLoop)),
       tcpSocket_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
       resolver_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
-      readBuffer_(Unpooled::buffer(DEFAULT_READER_BUFFER_SIZE)),
+      readBuffer_(),
       writeBufferContainer_(),
       socketConfig_(tcpSocket_) {
     writeQueue_.reset(new AsioWriteOperationQueue(*this));
@@ -74,11 +78,14 @@ AsioSocketChannel::AsioSocketChannel(const EventLoopPtr& eventLoop)
       isWriting_(false),
       isConnecting_(false),
       initialized_(false),
+      readPending_(false),
+      writable_(1),
       highWaterMarkCounter_(0),
+      writingOperations_(0),
       ioService_(boost::dynamic_pointer_cast<AsioService>(eventLoop)),
       tcpSocket_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
       resolver_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
-      readBuffer_(Unpooled::buffer(DEFAULT_READER_BUFFER_SIZE)),
+      readBuffer_(),
       writeBufferContainer_(),
       socketConfig_(tcpSocket_) {
     writeQueue_.reset(new AsioWriteOperationQueue(*this));
@@ -90,11 +97,14 @@ AsioSocketChannel::AsioSocketChannel(int id, const EventLoopPtr& eventLoop)
       isWriting_(false),
       isConnecting_(false),
       initialized_(false),
+      readPending_(false),
+      writable_(1),
       highWaterMarkCounter_(0),
+      writingOperations_(0),
       ioService_(boost::dynamic_pointer_cast<AsioService>(eventLoop)),
       tcpSocket_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
       resolver_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
-      readBuffer_(Unpooled::buffer(DEFAULT_READER_BUFFER_SIZE)),
+      readBuffer_(),
       writeBufferContainer_(),
       socketConfig_(tcpSocket_) {
     writeQueue_.reset(new AsioWriteOperationQueue(*this));
@@ -108,11 +118,14 @@ AsioSocketChannel::AsioSocketChannel(int id,
       isWriting_(false),
       isConnecting_(false),
       initialized_(false),
+      readPending_(false),
+      writable_(1),
       highWaterMarkCounter_(0),
+      writingOperations_(0),
       ioService_(boost::dynamic_pointer_cast<AsioService>(eventLoop)),
       tcpSocket_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
       resolver_(boost::dynamic_pointer_cast<AsioService>(eventLoop)->service()),
-      readBuffer_(Unpooled::buffer(DEFAULT_READER_BUFFER_SIZE)),
+      readBuffer_(),
       writeBufferContainer_(),
       socketConfig_(tcpSocket_) {
     writeQueue_.reset(new AsioWriteOperationQueue(*this));
@@ -124,12 +137,24 @@ AsioSocketChannel::~AsioSocketChannel() {
 
 void AsioSocketChannel::handleRead(const boost::system::error_code& error,
                                    size_t bytes_transferred) {
+    AsioService::BusyTime busyTime(*ioService_);
+
+    readPending_ = false;
+
     if (!error) {
-        LOG_INFO << "channel" << toString()
-                 << " has read " << bytes_transferred << " bytes";
+        LOG_DEBUG << "channel" << toString()
+                  << " has read " << bytes_transferred << " bytes";
 
         readBuffer_->offsetWriterIndex(bytes_transferred);
 
+        ReceiveBufferSizePredictor* predictor =
+            socketConfig_.receiveBufferSizePredictor();
+
+        if (predictor) {
+            predictor->previousReceiveBufferSize(
+                static_cast<int>(bytes_transferred));
+        }
+
         pipeline().addInboundChannelBuffer(readBuffer_);
         pipeline().fireMessageUpdated();
 
@@ -161,32 +186,53 @@ void AsioSocketChannel::handleRead(const boost::system::error_code& error,
 
 void AsioSocketChannel::handleWrite(const boost::system::error_code& error,
                                     size_t bytes_transferred) {
+    AsioService::BusyTime busyTime(*ioService_);
+
     if (!error) {
         LOG_DEBUG << "channel " << toString()
                   << " written buffer with " << bytes_transferred << " bytes.";
-        AsioWriteOperation& op = writeQueue_->front();
 
-        if (op.hasWrittenAllBuffer(bytes_transferred)) {
-            op.setSuccess();
-        }
-        else {
-            LOG_WARN << "failed to write all the " << op.writeBufferSize()
-                     << " bytes, just written " << bytes_transferred
-                     << " bytes";
+        // complete all the operations of the (coalesced) write in order,
+        // by the byte count returned.
+        int writtenBytes = static_cast<int>(bytes_transferred);
+        int writtenOperations = writingOperations_;
 
-            ChannelException e("can not write all the buffer");
-            op.setFailure(e);
+        for (int i = 0; i < writtenOperations && !writeQueue_->empty(); ++i) {
+            AsioWriteOperation& op = writeQueue_->front();
+
+            if (writtenBytes >= op.writeBufferSize()) {
+                writtenBytes -= op.writeBufferSize();
+                op.setSuccess();
+                writeQueue_->popWritten();
+            }
+            else {
+                LOG_WARN << "failed to write all the " << op.writeBufferSize()
+                         << " bytes, just written " << writtenBytes
+                         << " bytes";
+
+                writtenBytes = 0;
+                ChannelException e("can not write all the buffer");
+                op.setFailure(e);
+                writeQueue_->popFront();
+            }
         }
 
-        writeQueue_->popFront();
+        writingOperations_ = 0;
         isWriting_ = false;
 
+        if (!writable_.relaxedGet() &&
+                writeQueue_->writeBufferSize() < socketConfig_.writeBufferLowWaterMark()) {
+            writable_.set(1);
+            pipeline().fireChannelWritabilityChanged();
+        }
+
         if (!writeQueue_->empty()) {
             beginWrite();
         }
     }
     else {
         isWriting_ = false;
+        writingOperations_ = 0;
 
         ChannelException e(error.message(), error.value());
 
@@ -195,6 +241,12 @@ void AsioSocketChannel::handleWrite(const boost::system::error_code& error,
             writeQueue_->popFront();
         }
 
+        // nothing is waiting to be written any more.
+        if (!writable_.relaxedGet()) {
+            writable_.set(1);
+            pipeline().fireChannelWritabilityChanged();
+        }
+
         LOG_ERROR << "channel " << toString()
                   << " failed to write buffer, code: " << error.value()
                   << " message: " << error.message();
@@ -211,6 +263,8 @@ void AsioSocketChannel::handleWrite(const boost::system::error_code& error,
 void AsioSocketChannel::handleResolve(const boost::system::error_code& error,
                                       boost::asio::ip::tcp::resolver::iterator itr,
                                       const ChannelFuturePtr& cf) {
+    AsioService::BusyTime busyTime(*ioService_);
+
     if (!error) {
         tcp::endpoint endpoint = *itr;
         tcpSocket_.async_connect(
@@ -241,6 +295,8 @@ void AsioSocketChannel::handleResolve(const boost::system::error_code& error,
 void AsioSocketChannel::handleConnect(const boost::system::error_code& error,
                                       boost::asio::ip::tcp::resolver::iterator endpointIterator,
                                       const ChannelFuturePtr& cf) {
+    AsioService::BusyTime busyTime(*ioService_);
+
     if (!error) {
         if (connectTimeout_) {
             connectTimeout_->cancel();
@@ -393,31 +449,165 @@ void AsioSocketChannel::doConnect(ChannelHandlerContext& ctx,
 }
 
 void AsioSocketChannel::beginRead() {
+    if (socketConfig_.isLazyReadBuffer()) {
+        beginNullBufferRead();
+        return;
+    }
+
     int size;
-    char* buf = readBuffer_->writableBytes(&size);
+    char* buf = prepareReadBuffer(&size);
+
+    LOG_DEBUG << "channel" << toString()
+              << " begin to read asynchronously, with the the buffer size "
+             << size << " Bytes";
+
+    tcpSocket_.async_read_some(
+        boost::asio::buffer(buf, size),
+        boost::bind(&AsioSocketChannel::handleRead,
+                    this,
+                    boost::asio::placeholders::error,
+                    boost::asio::placeholders::bytes_transferred));
+
+    isReading_ = true;
+    readPending_ = true;
+}
+
+char* AsioSocketChannel::prepareReadBuffer(int* size) {
+    ReceiveBufferSizePredictor* predictor =
+        socketConfig_.receiveBufferSizePredictor();
+
+    if (predictor) {
+        return prepareAdaptiveReadBuffer(predictor->nextReceiveBufferSize(),
+                                         size);
+    }
+
+    // allocate in the loop thread, after the channel options have been set.
+    if (!readBuffer_) {
+        readBuffer_ = newReadBuffer(DEFAULT_READER_BUFFER_SIZE);
+    }
+
+    char* buf = readBuffer_->writableBytes(size);
 
     // auto increment the capacity.
-    if (size < MIN_READER_BUFFER_SIZE) {
+    if (*size < MIN_READER_BUFFER_SIZE) {
         if (!readBuffer_->ensureWritableBytes(4096, true)) {
             LOG_ERROR << "channel " << toString()
                       << " failed to get more writable bytes for read buffer";
         }
 
-        buf = readBuffer_->writableBytes(&size);
+        buf = readBuffer_->writableBytes(size);
     }
 
-    LOG_INFO << "channel" << toString()
-             << " begin to read asynchronously, with the the buffer size "
-             << size << " Bytes";
+    return buf;
+}
+
+char* AsioSocketChannel::prepareAdaptiveReadBuffer(int nextSize, int* size) {
+    if (!readBuffer_) {
+        readBuffer_ = newReadBuffer(nextSize);
+    }
+    else if (!readBuffer_->readable()) {
+        // the predictor has shrunk, switch to a smaller buffer instead of
+        // resizing in place.
+        if (readBuffer_->capacity() >= nextSize * 4) {
+            readBuffer_ = newReadBuffer(nextSize);
+        }
+        else {
+            readBuffer_->clear();
+        }
+    }
+    else if (readBuffer_->writableBytes() < nextSize) {
+        readBuffer_->discardReadBytes();
+
+        if (readBuffer_->writableBytes() < nextSize) {
+            readBuffer_->ensureWritableBytes(nextSize, true);
+        }
+    }
+
+    char* buf = readBuffer_->writableBytes(size);
+
+    // read no more than the prediction, so a full read can be told apart.
+    if (*size > nextSize) {
+        *size = nextSize;
+    }
+
+    return buf;
+}
+
+ChannelBufferPtr AsioSocketChannel::newReadBuffer(int size) {
+    if (config().pooledBuffer() || socketConfig_.isLazyReadBuffer()) {
+        return PooledChannelBufferFactory::buffer(size);
+    }
+    else {
+        return Unpooled::buffer(size);
+    }
+}
+
+void AsioSocketChannel::beginNullBufferRead() {
+    releaseIdleReadBuffer();
+
+    LOG_DEBUG << "channel " << toString()
+              << " begin to wait for readable without a read buffer";
 
     tcpSocket_.async_read_some(
-        boost::asio::buffer(buf, size),
-        boost::bind(&AsioSocketChannel::handleRead,
-                    this,
-                    boost::asio::placeholders::error,
-                    boost::asio::placeholders::bytes_transferred));
+        boost::asio::null_buffers(),
+        makeCustomAllocHandler(readAllocator_,
+                               boost::bind(&AsioSocketChannel::handleReadable,
+                                           this,
+                                           boost::asio::placeholders::error)));
 
     isReading_ = true;
+    readPending_ = true;
+}
+
+void AsioSocketChannel::handleReadable(const boost::system::error_code& error) {
+    AsioService::BusyTime busyTime(*ioService_);
+
+    readPending_ = false;
+
+    if (error) {
+        handleRead(error, 0);
+        return;
+    }
+
+    // the socket is readable now, borrow a buffer from the loop's pool
+    // and read without blocking.
+    boost::system::error_code ec;
+
+    if (!tcpSocket_.non_blocking()) {
+        tcpSocket_.non_blocking(true, ec);
+    }
+
+    int size;
+    char* buf = prepareReadBuffer(&size);
+    std::size_t bytes = tcpSocket_.read_some(boost::asio::buffer(buf, size), ec);
+
+    if (ec == boost::asio::error::would_block
+            || ec == boost::asio::error::try_again) {
+        beginNullBufferRead();
+        return;
+    }
+
+    handleRead(ec, bytes);
+}
+
+void AsioSocketChannel::releaseIdleReadBuffer() {
+    if (!readBuffer_ || readBuffer_->readable()) {
+        return;
+    }
+
+    // the head inbound container still refers to the last read buffer.
+    ChannelBufferContainer* container =
+        pipeline().inboundMessageContainer<ChannelBufferPtr, MESSAGE_STREAM>();
+
+    if (container) {
+        ChannelBufferPtr& buffer = container->getMessages();
+
+        if (buffer == readBuffer_) {
+            buffer.reset();
+        }
+    }
+
+    readBuffer_.reset();
 }
 
 bool AsioSocketChannel::doBind(const InetAddress& localAddress) {
@@ -472,6 +662,17 @@ void AsioSocketChannel::doFlush(ChannelHandlerContext& ctx,
         const ChannelBufferPtr& buffer = writeBufferContainer_->getMessages();
         writeQueue_->offer(buffer, future);
         beginWrite();
+
+        if (writable_.relaxedGet() &&
+                writeQueue_->writeBufferSize() > socketConfig_.writeBufferHighWaterMark()) {
+            LOG_DEBUG << "channel " << toString() << " has "
+                      << writeQueue_->writeBufferSize()
+                      << " bytes waiting to be written, turns not writable.";
+
+            writable_.set(0);
+            ++highWaterMarkCounter_;
+            pipeline().fireChannelWritabilityChanged();
+        }
     }
     else {
         LOG_ERROR << "channel " << toString()
@@ -576,30 +777,45 @@ void AsioSocketChannel::registerTo(Context& context) {
                                 _2));
 
     context.setReadFunctor(boost::bind(
-                               &AsioSocketChannel::beginRead,
+                               &AsioSocketChannel::doRead,
                                this));
 }
 
+void AsioSocketChannel::doRead() {
+    // the auto read may be turned off and on again before the
+    // outstanding read completes, which will go on reading by itself.
+    if (!readPending_ && isActive()) {
+        beginRead();
+    }
+}
+
 void AsioSocketChannel::handleConnectTimeout(const ChannelFuturePtr& future) {
     ChannelException e("connection timed out");
     connectFailed(future, e);
 }
 
 void AsioSocketChannel::cleanUpWriteBuffer() {
-    // last one in the writeBuffer should not been cleaned.
+    // the operations in writing should not been cleaned.
     // the handleWrite callback may be already queued into the AsioService,
     // it should take care of itself.
     if (!writeQueue_->empty()) {
         ChannelException e("channel closed");
-        AsioWriteOperation firstOp = writeQueue_->front();
-        writeQueue_->popFront();
+        std::vector<AsioWriteOperation> writingOps;
+        int writingCount = writingOperations_ > 0 ? writingOperations_ : 1;
+
+        for (int i = 0; i < writingCount && !writeQueue_->empty(); ++i) {
+            writingOps.push_back(writeQueue_->front());
+            writeQueue_->popFront();
+        }
 
         while (!writeQueue_->empty()) {
             writeQueue_->front().setFailure(e);
             writeQueue_->popFront();
         }
 
-        writeQueue_->offer(firstOp);
+        for (std::size_t i = 0; i < writingOps.size(); ++i) {
+            writeQueue_->offer(writingOps[i]);
+        }
     }
 }
 
@@ -609,6 +825,14 @@ void AsioSocketChannel::beginWrite() {
     }
 
     isWriting_ = true;
+
+    if (socketConfig_.isWriteBatching() && writeQueue_->size() > 1) {
+        if (beginBatchWrite()) {
+            return;
+        }
+    }
+
+    writingOperations_ = 1;
     AsioWriteOperation& operation = writeQueue_->front();
     int writeBufferSize = operation.writeBufferSize();
 
@@ -632,10 +856,23 @@ void AsioSocketChannel::beginWrite() {
             this,
             boost::asio::placeholders::error,
             boost::asio::placeholders::bytes_transferred)));
-        LOG_INFO << "channel " << toString()
+        LOG_DEBUG << "channel " << toString()
             << " write a buffer with " << writeBufferSize
             << " bytes to the socket asynchronously";
     }
+    else if (operation.isLargeGatheringBuffer()) {
+        boost::asio::async_write(tcpSocket_,
+            operation.asioBufferVector(),
+            makeCustomAllocHandler(writeAllocator_,
+            boost::bind(&AsioSocketChannel::handleWrite,
+            this,
+            boost::asio::placeholders::error,
+            boost::asio::placeholders::bytes_transferred)));
+        LOG_DEBUG << "channel " << toString()
+            << " write a gathering buffer of "
+            << operation.asioBufferVector().size() << " blocks with "
+            << writeBufferSize << " bytes to the socket asynchronously";
+    }
     else {
         boost::asio::async_write(tcpSocket_,
             operation.asioBufferArray(),
@@ -644,10 +881,83 @@ void AsioSocketChannel::beginWrite() {
             this,
             boost::asio::placeholders::error,
             boost::asio::placeholders::bytes_transferred)));
-        LOG_WARN << "channel " << toString()
+        LOG_DEBUG << "channel " << toString()
             << " write a gathering buffer with " << writeBufferSize
-            << " bytes to the socket asynchronously, may be latency.";
+            << " bytes to the socket asynchronously";
+    }
+}
+
+bool AsioSocketChannel::beginBatchWrite() {
+    int maxOperations = socketConfig_.writeBatchOperations();
+    int maxBytes = socketConfig_.writeBatchBytes();
+
+    int operations = 0;
+    int writeBufferSize = 0;
+    int queueSize = static_cast<int>(writeQueue_->size());
+
+    batchBuffers_.clear();
+
+    // always take the first operation, even it is larger than the max bytes.
+    while (operations < queueSize && operations < maxOperations) {
+        const AsioWriteOperation& op = writeQueue_->at(operations);
+
+        if (operations > 0) {
+            if (writeBufferSize + op.writeBufferSize() > maxBytes) {
+                break;
+            }
+
+            if (static_cast<int>(batchBuffers_.size()) + op.blockCount()
+                    > AsioWriteOperation::MAX_GATHERING_BUFFER_COUNT) {
+                break;
+            }
+        }
+
+        op.appendTo(&batchBuffers_);
+        writeBufferSize += op.writeBufferSize();
+        ++operations;
     }
+
+    if (operations < 2) {
+        batchBuffers_.clear();
+        return false;
+    }
+
+    writingOperations_ = operations;
+
+    if (writeBufferSize == 0) {
+        ioService_->service().post(boost::bind(
+            &AsioSocketChannel::handleWrite,
+            this,
+            boost::system::error_code(),
+            0));
+        return true;
+    }
+
+    boost::asio::async_write(tcpSocket_,
+        batchBuffers_,
+        makeCustomAllocHandler(writeAllocator_,
+        boost::bind(&AsioSocketChannel::handleWrite,
+        this,
+        boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred)));
+
+    LOG_DEBUG << "channel " << toString()
+        << " write " << operations << " coalesced operations with "
+        << writeBufferSize << " bytes to the socket asynchronously";
+
+    return true;
+}
+
+int AsioSocketChannel::writeBufferSize() const {
+    return writeQueue_->writeBufferSize();
+}
+
+int64_t AsioSocketChannel::gatheringWrittenBytes() const {
+    return writeQueue_->gatheringBytes();
+}
+
+int64_t AsioSocketChannel::compactedWrittenBytes() const {
+    return writeQueue_->compactedBytes();
 }
 
 
@@ -33,10 +33,17 @@ using namespace cetty::util;
 static const int DEFAULT_SEND_BUFFER_LOW_WATERMARK  = 2 * 1024;
 static const int DEFAULT_SEND_BUFFER_HIGH_WATERMARK = 2 * 1024 * 1024;
 
+static const int DEFAULT_WRITE_BATCH_BYTES = 256 * 1024;
+static const int DEFAULT_WRITE_BATCH_OPERATIONS = 1;
+
 AsioSocketChannelConfig::AsioSocketChannelConfig(TcpSocket& socket)
     : socket_(socket),
       sendBufferLowWaterMark_(0),
-      sendBufferHighWaterMark_(DEFAULT_SEND_BUFFER_HIGH_WATERMARK) {
+      sendBufferHighWaterMark_(DEFAULT_SEND_BUFFER_HIGH_WATERMARK),
+      writeBatchBytes_(DEFAULT_WRITE_BATCH_BYTES),
+      writeBatchOperations_(DEFAULT_WRITE_BATCH_OPERATIONS),
+      writeBufferLowWaterMark_(0),
+      lazyReadBuffer_(false) {
 }
 
 bool AsioSocketChannelConfig::setOption(const ChannelOption& option,
@@ -72,6 +79,29 @@ bool AsioSocketChannelConfig::setOption(const ChannelOption& option,
     else if (option == ChannelOption::CO_RCVHIGHWAT) {
         setReceiveBufferHighWaterMark(boost::get<int>(value));
     }
+    else if (option == ChannelOption::CO_WRITE_BATCH_BYTES) {
+        setWriteBatchBytes(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_WRITE_BATCH_OPERATIONS) {
+        setWriteBatchOperations(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK) {
+        setWriteBufferLowWaterMark(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_LAZY_READ_BUFFER) {
+        setLazyReadBuffer(boost::get<bool>(value));
+    }
+    else if (option == ChannelOption::CO_ADAPTIVE_RECEIVE_BUFFER_SIZE) {
+        const std::vector<int>& range = boost::get<std::vector<int> >(value);
+
+        if (range.size() != 3) {
+            LOG_WARN << "the " << option.name()
+                     << " should be [minimum, initial, maximum]";
+            return false;
+        }
+
+        return setAdaptiveReceiveBufferSize(range[0], range[1], range[2]);
+    }
     else {
         return false;
     }
@@ -287,7 +317,7 @@ void AsioSocketChannelConfig::setSendBufferHighWaterMark(int bufferHighWaterMark
     }
     else {
         LOG_WARN << "the SNDHIGHWAT " << bufferHighWaterMark
-                 << " should not be negative";
+                 << " should be positive, will not set";
     }
 }
 
@@ -301,10 +331,62 @@ void AsioSocketChannelConfig::setReceiveBufferHighWaterMark(int bufferHighWaterM
     }
     else {
         LOG_WARN << "the RCVHIGHWAT " << bufferHighWaterMark
+                 << " should be positive, will not set";
+    }
+}
+
+void AsioSocketChannelConfig::setWriteBufferLowWaterMark(int writeBufferLowWaterMark) {
+    // 0 means half of the high water mark.
+    if (writeBufferLowWaterMark >= 0) {
+        writeBufferLowWaterMark_ = writeBufferLowWaterMark;
+    }
+    else {
+        LOG_WARN << "the WRITE_BUFFER_LOW_WATER_MARK " << writeBufferLowWaterMark
+                 << " should not be negative, will not set";
+    }
+}
+
+void AsioSocketChannelConfig::setWriteBatchBytes(int writeBatchBytes) {
+    if (writeBatchBytes > 0) {
+        writeBatchBytes_ = writeBatchBytes;
+    }
+    else {
+        LOG_WARN << "the WRITE_BATCH_BYTES " << writeBatchBytes
+                 << " should not be negative";
+    }
+}
+
+void AsioSocketChannelConfig::setWriteBatchOperations(int writeBatchOperations) {
+    if (writeBatchOperations > 0) {
+        writeBatchOperations_ = writeBatchOperations;
+    }
+    else {
+        LOG_WARN << "the WRITE_BATCH_OPERATIONS " << writeBatchOperations
                  << " should not be negative";
     }
 }
 
+bool AsioSocketChannelConfig::setAdaptiveReceiveBufferSize(int minimum,
+        int initial,
+        int maximum) {
+    if (minimum <= 0 || initial < minimum || maximum < initial) {
+        LOG_WARN << "the adaptive receive buffer size should satisfy "
+                    "0 < minimum <= initial <= maximum, but minimum: "
+                 << minimum << ", initial: " << initial
+                 << ", maximum: " << maximum;
+        return false;
+    }
+
+    receiveBufferSizePredictor_.reset(
+        new AdaptiveReceiveBufferSizePredictor(minimum, initial, maximum));
+
+    LOG_INFO << "has set the adaptive receive buffer size, minimum: "
+             << minimum << ", initial: " << initial
+             << ", maximum: " << maximum;
+
+    return true;
+}
+
 }
 }
 }
@@ -16,6 +16,7 @@
 
 #include <cetty/channel/asio/AsioWriteOperationQueue.h>
 
+#include <limits.h>
 #include <boost/assert.hpp>
 #include <boost/asio/buffer.hpp>
 
@@ -31,13 +32,21 @@ namespace asio {
 using namespace cetty::channel;
 using namespace cetty::buffer;
 
+#if defined(IOV_MAX)
+const int AsioWriteOperation::MAX_GATHERING_BUFFER_COUNT = IOV_MAX;
+#else
+const int AsioWriteOperation::MAX_GATHERING_BUFFER_COUNT = 1024;
+#endif
+
 AsioWriteOperation::AsioWriteOperation()
-    : byteSize_() {
+    : byteSize_(),
+      compactedBytes_() {
 }
 
 AsioWriteOperation::AsioWriteOperation(const ChannelBufferPtr& buffer,
                                        const ChannelFuturePtr& f)
     : byteSize_(0),
+      compactedBytes_(0),
       future_(f),
       channelBuffer_(buffer) {
     GatheringBuffer gathering;
@@ -54,8 +63,20 @@ AsioWriteOperation::AsioWriteOperation(const ChannelBufferPtr& buffer,
         BOOST_ASSERT(byteSize == byteSize_ &&
                      "buffer size should be same after compact");
 
+        compactedBytes_ = byteSize_;
         buffers_.push_back(AsioBuffer(bytes, byteSize_));
     }
+    else if (gathering.blockCount() > MAX_BUFFER_COUNT) {
+        int blockCount = gathering.blockCount();
+        largeBuffers_.reset(new AsioBufferVector);
+        largeBuffers_->reserve(blockCount);
+
+        for (int i = 0; i < blockCount; ++i) {
+            const StringPiece& bytes = gathering.at(i);
+            largeBuffers_->push_back(
+                AsioBuffer(const_cast<char*>(bytes.data()), bytes.size()));
+        }
+    }
     else {
         for (int i = 0, j = gathering.blockCount(); i < j; ++i) {
             const StringPiece& bytes = gathering.at(i);
@@ -67,22 +88,41 @@ AsioWriteOperation::AsioWriteOperation(const ChannelBufferPtr& buffer,
 
 AsioWriteOperation::AsioWriteOperation(const AsioWriteOperation& op)
     : byteSize_(op.byteSize_),
+      compactedBytes_(op.compactedBytes_),
       buffers_(op.buffers_),
+      largeBuffers_(op.largeBuffers_),
       future_(op.future_),
       channelBuffer_(op.channelBuffer_) {
 }
 
 AsioWriteOperation& AsioWriteOperation::operator=(const AsioWriteOperation& op) {
     byteSize_ = op.byteSize_;
+    compactedBytes_ = op.compactedBytes_;
     buffers_ = op.buffers_;
+    largeBuffers_ = op.largeBuffers_;
     channelBuffer_ = op.channelBuffer_;
     future_ = op.future_;
     return *this;
 }
 
+void AsioWriteOperation::appendTo(AsioBufferVector* buffers) const {
+    BOOST_ASSERT(buffers);
+
+    if (largeBuffers_) {
+        buffers->insert(buffers->end(),
+                        largeBuffers_->begin(),
+                        largeBuffers_->end());
+    }
+    else {
+        buffers->insert(buffers->end(), buffers_.begin(), buffers_.end());
+    }
+}
+
 AsioWriteOperationQueue::AsioWriteOperationQueue(AsioSocketChannel& channel)
     : channel_(channel),
-      writeBufferSize_(0) {
+      writeBufferSize_(0),
+      gatheringBytes_(0),
+      compactedBytes_(0) {
 }
 
 void AsioWriteOperationQueue::plusWriteBufferSize(int messageSize) {
@@ -93,6 +133,16 @@ void AsioWriteOperationQueue::minusWriteBufferSize(int messageSize) {
     writeBufferSize_ -= messageSize;
 }
 
+void AsioWriteOperationQueue::updateGatheringStatistics(
+    const AsioWriteOperation& operation) {
+    if (operation.compactedBytes()) {
+        compactedBytes_ += operation.compactedBytes();
+    }
+    else if (!operation.isSingleBuffer()) {
+        gatheringBytes_ += operation.writeBufferSize();
+    }
+}
+
 }
 }
 }
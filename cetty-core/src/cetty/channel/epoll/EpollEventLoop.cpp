@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollEventLoop.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cetty/util/CachedClock.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::util;
+
+static const boost::posix_time::ptime EPOCH(boost::gregorian::date(1970, 1, 1));
+
+EpollTimeout::EpollTimeout(EpollEventLoop& loop,
+                           int64_t deadline,
+                           int64_t period,
+                           const Handler& handler)
+    : state_(TIMER_UNINITIALIZED),
+      scheduled_(false),
+      deadline_(deadline),
+      period_(period > 0 ? period : 0),
+      handler_(handler),
+      loop_(loop) {
+}
+
+EpollTimeout::~EpollTimeout() {
+}
+
+bool EpollTimeout::isExpired() const {
+    return state_.get() == TIMER_EXPIRED;
+}
+
+bool EpollTimeout::isCancelled() const {
+    return state_.get() == TIMER_CANCELLED;
+}
+
+bool EpollTimeout::isActived() const {
+    return state_.get() == TIMER_ACTIVE;
+}
+
+void EpollTimeout::cancel() {
+    // only one of the cancelling threads and the expiring loop wins,
+    // a periodic timeout may also be cancelled in its own handler.
+    if (!state_.compareAndSet(TIMER_ACTIVE, TIMER_CANCELLED)
+            && !(period_ && state_.compareAndSet(TIMER_EXPIRED,
+                                                 TIMER_CANCELLED))) {
+        return;
+    }
+
+    if (loop_.inLoopThread()) {
+        loop_.cancel(EpollTimeoutPtr(this));
+    }
+    else {
+        loop_.post(boost::bind(&EpollEventLoop::cancel,
+                               &loop_,
+                               EpollTimeoutPtr(this)));
+    }
+}
+
+boost::int64_t EpollTimeout::expiresFromNow() const {
+    return (deadline_ - CachedClock::nowInMicros()) / 1000;
+}
+
+EpollEventLoop::EpollEventLoop(const EventLoopPoolPtr& pool)
+    : EventLoop(pool),
+      epollFd_(-1),
+      wakeupFd_(-1),
+      timerFd_(-1),
+      timerDeadline_(0),
+      dispatching_(false),
+      extraReadBuffer_(EXTRA_READ_BUFFER_SIZE) {
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeupFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timerFd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (!isOpen()) {
+        LOG_ERROR << "failed to create the epoll event loop, errno: " << errno;
+        return;
+    }
+
+    // the two are told apart from the watchers by the address.
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = &wakeupFd_;
+
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &event) < 0) {
+        LOG_ERROR << "failed to add the eventfd to the epoll, errno: " << errno;
+    }
+
+    event.data.ptr = &timerFd_;
+
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, timerFd_, &event) < 0) {
+        LOG_ERROR << "failed to add the timerfd to the epoll, errno: " << errno;
+    }
+}
+
+EpollEventLoop::~EpollEventLoop() {
+    timeouts_.clear();
+
+    if (timerFd_ >= 0) {
+        ::close(timerFd_);
+    }
+
+    if (wakeupFd_ >= 0) {
+        ::close(wakeupFd_);
+    }
+
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+    }
+}
+
+int64_t EpollEventLoop::run() {
+    if (!isOpen()) {
+        LOG_ERROR << "the epoll event loop has not opened, can not run.";
+        return -1;
+    }
+
+    struct epoll_event events[MAX_EVENTS_PER_POLL];
+    int64_t count = 0;
+
+    // the timestamps in one iteration share one system clock reading.
+    CachedClock::enable();
+
+    while (!stopped()) {
+        // do not block if handlers were posted in the loop thread.
+        int waitMillis = handlers_.empty() ? -1 : 0;
+        int n = ::epoll_wait(epollFd_, events, MAX_EVENTS_PER_POLL, waitMillis);
+
+        CachedClock::invalidate();
+        int64_t start = CachedClock::nowInMicros();
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            LOG_ERROR << "epoll_wait failed, errno: " << errno;
+            count = -1;
+            break;
+        }
+
+        dispatching_ = true;
+
+        for (int i = 0; i < n; ++i) {
+            void* ptr = events[i].data.ptr;
+
+            if (ptr == &wakeupFd_) {
+                handleWakeup();
+            }
+            else if (ptr == &timerFd_) {
+                handleTimer();
+            }
+            else {
+                Watcher* watcher = static_cast<Watcher*>(ptr);
+
+                if (removedWatchers_.empty() || !isRemoved(watcher)) {
+                    watcher->handleEvents(static_cast<int>(events[i].events));
+                }
+            }
+        }
+
+        dispatching_ = false;
+        removedWatchers_.clear();
+
+        count += n;
+        count += runPostedHandlers();
+        count += expireTimeouts();
+
+        CachedClock::invalidate();
+        int64_t end = CachedClock::nowInMicros();
+        addBusyTime(end, end - start);
+    }
+
+    CachedClock::disable();
+
+    LOG_INFO << "epoll event loop completed, and " << count
+             << " events and handlers that were executed.";
+    return count;
+}
+
+void EpollEventLoop::stop() {
+    EventLoop::stop();
+    wakeup();
+}
+
+void EpollEventLoop::post(const Handler& handler) {
+    taskPosted();
+
+    // the loop thread checks the queue before polling.
+    if (handlers_.push(handler) && !inLoopThread()) {
+        wakeup();
+    }
+}
+
+void EpollEventLoop::PostedHandlerRunner::operator()(
+    const Handler& handler) const {
+    loop->taskCompleted();
+    handler();
+}
+
+int EpollEventLoop::runPostedHandlers() {
+    return handlers_.popAll(PostedHandlerRunner(this));
+}
+
+void EpollEventLoop::wakeup() {
+    uint64_t one = 1;
+
+    if (::write(wakeupFd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        LOG_ERROR << "failed to wake up the epoll event loop, errno: " << errno;
+    }
+}
+
+void EpollEventLoop::handleWakeup() {
+    uint64_t value;
+
+    while (::read(wakeupFd_, &value, sizeof(value)) > 0) {
+    }
+}
+
+TimeoutPtr EpollEventLoop::runAt(const boost::posix_time::ptime& timestamp,
+                                 const Handler& handler) {
+    return newTimeout((timestamp - EPOCH).total_microseconds(), 0, handler);
+}
+
+TimeoutPtr EpollEventLoop::runAfter(int64_t millisecond,
+                                    const Handler& handler) {
+    int64_t delay = millisecond > 0 ? millisecond * 1000 : 0;
+    return newTimeout(CachedClock::nowInMicros() + delay, 0, handler);
+}
+
+TimeoutPtr EpollEventLoop::runEvery(int64_t millisecond,
+                                    const Handler& handler) {
+    int64_t period = millisecond > 0 ? millisecond * 1000 : 0;
+    return newTimeout(CachedClock::nowInMicros() + period, period, handler);
+}
+
+TimeoutPtr EpollEventLoop::newTimeout(int64_t deadline,
+                                      int64_t period,
+                                      const Handler& handler) {
+    if (!handler) {
+        LOG_WARN << "Timer handler is empty, do nothing.";
+        return TimeoutPtr();
+    }
+
+    EpollTimeoutPtr timeout(new EpollTimeout(*this, deadline, period, handler));
+    timeout->state_.set(EpollTimeout::TIMER_ACTIVE);
+
+    if (inLoopThread()) {
+        schedule(timeout);
+    }
+    else {
+        post(boost::bind(&EpollEventLoop::schedule, this, timeout));
+    }
+
+    return boost::static_pointer_cast<Timeout>(timeout);
+}
+
+void EpollEventLoop::schedule(const EpollTimeoutPtr& timeout) {
+    // cancelled before the posted scheduling.
+    if (timeout->state_.get() != EpollTimeout::TIMER_ACTIVE) {
+        return;
+    }
+
+    timeout->position_ =
+        timeouts_.insert(std::make_pair(timeout->deadline_, timeout));
+    timeout->scheduled_ = true;
+
+    updateTimer();
+}
+
+void EpollEventLoop::cancel(const EpollTimeoutPtr& timeout) {
+    if (timeout->scheduled_) {
+        timeout->scheduled_ = false;
+        timeouts_.erase(timeout->position_);
+
+        updateTimer();
+    }
+}
+
+int EpollEventLoop::expireTimeouts() {
+    if (timeouts_.empty()) {
+        return 0;
+    }
+
+    int64_t now = CachedClock::nowInMicros();
+
+    if (timeouts_.begin()->first > now) {
+        // the timerfd may fire a little earlier than the cached clock.
+        updateTimer();
+        return 0;
+    }
+
+    std::vector<EpollTimeoutPtr> expired;
+
+    while (!timeouts_.empty() && timeouts_.begin()->first <= now) {
+        expired.push_back(timeouts_.begin()->second);
+        expired.back()->scheduled_ = false;
+        timeouts_.erase(timeouts_.begin());
+    }
+
+    for (std::size_t i = 0; i < expired.size(); ++i) {
+        EpollTimeout* timeout = expired[i].get();
+
+        // cancelled by the handlers expired before, or by another thread.
+        if (!timeout->state_.compareAndSet(EpollTimeout::TIMER_ACTIVE,
+                                           EpollTimeout::TIMER_EXPIRED)) {
+            continue;
+        }
+
+        timeout->handler_();
+
+        if (timeout->period_ > 0) {
+            timeout->deadline_ += timeout->period_;
+
+            // do not catch up the periods missed.
+            if (timeout->deadline_ <= now) {
+                timeout->deadline_ = now + timeout->period_;
+            }
+
+            // cancelled in the handler or by another thread meanwhile.
+            if (timeout->state_.compareAndSet(EpollTimeout::TIMER_EXPIRED,
+                                              EpollTimeout::TIMER_ACTIVE)) {
+                schedule(expired[i]);
+            }
+        }
+    }
+
+    updateTimer();
+    return static_cast<int>(expired.size());
+}
+
+void EpollEventLoop::updateTimer() {
+    int64_t deadline = timeouts_.empty() ? 0 : timeouts_.begin()->first;
+
+    if (deadline == timerDeadline_) {
+        return;
+    }
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    if (deadline) {
+        int64_t delay = deadline - CachedClock::nowInMicros();
+
+        // a zero value disarms the timer.
+        if (delay < 1) {
+            delay = 1;
+        }
+
+        spec.it_value.tv_sec = static_cast<time_t>(delay / 1000000);
+        spec.it_value.tv_nsec = static_cast<long>((delay % 1000000) * 1000);
+    }
+
+    if (::timerfd_settime(timerFd_, 0, &spec, NULL) < 0) {
+        LOG_ERROR << "failed to set the timerfd, errno: " << errno;
+    }
+
+    timerDeadline_ = deadline;
+}
+
+void EpollEventLoop::handleTimer() {
+    uint64_t expirations;
+
+    while (::read(timerFd_, &expirations, sizeof(expirations)) > 0) {
+    }
+
+    // the timer should be armed again by the expiring.
+    timerDeadline_ = 0;
+}
+
+bool EpollEventLoop::addWatcher(int fd, int events, Watcher* watcher) {
+    struct epoll_event event;
+    event.events = static_cast<uint32_t>(events) | EPOLLET;
+    event.data.ptr = watcher;
+
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        LOG_ERROR << "failed to add the fd " << fd
+                  << " to the epoll, errno: " << errno;
+        return false;
+    }
+
+    return true;
+}
+
+void EpollEventLoop::removeWatcher(int fd, Watcher* watcher) {
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, NULL) < 0
+            && errno != ENOENT && errno != EBADF) {
+        LOG_WARN << "failed to remove the fd " << fd
+                 << " from the epoll, errno: " << errno;
+    }
+
+    if (dispatching_) {
+        removedWatchers_.push_back(watcher);
+    }
+}
+
+bool EpollEventLoop::isRemoved(Watcher* watcher) const {
+    return std::find(removedWatchers_.begin(), removedWatchers_.end(), watcher)
+           != removedWatchers_.end();
+}
+
+}
+}
+}
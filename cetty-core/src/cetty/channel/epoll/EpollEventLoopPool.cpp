@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+
+#include <boost/bind.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/logging/LoggerHelper.h>
+#include <cetty/channel/epoll/EpollEventLoop.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+class EpollEventLoopHolder : public EventLoopPool::EventLoopHolder {
+public:
+    enum {
+        INITIALIZED =  0,
+        RUNNING     =  1,
+        STOPPED     = -1
+    };
+
+    typedef boost::shared_ptr<boost::thread> ThreadPtr;
+
+public:
+    EpollEventLoopHolder(const EpollEventLoopPtr& loop)
+        : state_(INITIALIZED),
+          loop_(loop),
+          eventLoop_(boost::static_pointer_cast<EventLoop>(loop)) {
+    }
+
+    virtual ~EpollEventLoopHolder() {
+    }
+
+    virtual const EventLoopPtr& eventLoop() const {
+        return eventLoop_;
+    }
+
+    const EpollEventLoopPtr& loop() const {
+        return loop_;
+    }
+
+    void setThread(const ThreadPtr& thread) {
+        thread_ = thread;
+    }
+
+    void waitingForStop() {
+        if (thread_) {
+            thread_->join();
+        }
+    }
+
+    void stop() {
+        if (state_ != STOPPED && loop_) {
+            state_ = STOPPED;
+            loop_->stop();
+        }
+    }
+
+private:
+    int state_;
+
+    ThreadPtr thread_;
+    EpollEventLoopPtr loop_;
+    EventLoopPtr eventLoop_;
+};
+
+EpollEventLoopPool::EpollEventLoopPool(int threadCnt)
+    : EventLoopPool(threadCnt) {
+    init();
+}
+
+EpollEventLoopPool::EpollEventLoopPool(int threadCnt,
+        const EventLoopThreadPlacement& placement)
+    : EventLoopPool(threadCnt, placement) {
+    init();
+}
+
+void EpollEventLoopPool::init() {
+    for (int i = 0; i < size(); ++i) {
+        appendLoopHolder(new EpollEventLoopHolder(
+                             new EpollEventLoop(shared_from_this())));
+    }
+
+    // automatic start
+    if (!isSingleThread()) {
+        LOG_INFO << "automatic start the " << size()
+                 << " epoll event loops in thread";
+
+        for (int i = 0; i < size(); ++i) {
+            EpollEventLoopHolder* holder =
+                down_cast<EpollEventLoopHolder*>(loopHolderAt(i));
+
+            holder->setThread(
+                EpollEventLoopHolder::ThreadPtr(new boost::thread(
+                            boost::bind(&EpollEventLoopPool::runLoopInThread,
+                                        this,
+                                        holder,
+                                        i))));
+        }
+
+        setStarted(true);
+    }
+    else {
+        LOG_INFO << "the epoll event loop pool is main thread mode,"
+                 " will start later.";
+
+        EpollEventLoopHolder* holder =
+            down_cast<EpollEventLoopHolder*>(loopHolderAt(0));
+
+        ThreadId id = CurrentThread::id();
+        holder->eventLoop()->setThreadId(id);
+        insertLoop(id, holder->eventLoop());
+    }
+}
+
+bool EpollEventLoopPool::start() {
+    if (!isStarted() && isSingleThread()) {
+        LOG_INFO << "start the EpollEventLoopPool in main thread mode.";
+
+        if (runLoop(down_cast<EpollEventLoopHolder*>(loopHolderAt(0))) < 0) {
+            LOG_ERROR << "EpollEventLoopPool run the main thread loop error.";
+            return false;
+        }
+    }
+
+    setStarted(true);
+    return true;
+}
+
+void EpollEventLoopPool::stop() {
+    for (int i = 0; i < size(); ++i) {
+        EpollEventLoopHolder* holder =
+            down_cast<EpollEventLoopHolder*>(loopHolderAt(i));
+
+        holder->stop();
+    }
+
+    setStarted(false);
+}
+
+void EpollEventLoopPool::waitingForStop() {
+    if (isSingleThread()) {
+        return;
+    }
+
+    for (int i = 0; i < size(); ++i) {
+        EpollEventLoopHolder* holder =
+            down_cast<EpollEventLoopHolder*>(loopHolderAt(i));
+
+        holder->waitingForStop();
+    }
+}
+
+const EventLoopPtr& EpollEventLoopPool::nextLoop() {
+    return loopHolderAt(nextLoopIndex())->eventLoop();
+}
+
+int64_t EpollEventLoopPool::runLoopInThread(EpollEventLoopHolder* holder,
+        int index) {
+    placeLoopThread(index);
+    return runLoop(holder);
+}
+
+int64_t EpollEventLoopPool::runLoop(EpollEventLoopHolder* holder) {
+    BOOST_ASSERT(holder && holder->loop() && "event loop can not be NULL.");
+
+    const EpollEventLoopPtr& loop = holder->loop();
+
+    ThreadId id = CurrentThread::id();
+    loop->setThreadId(id);
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        insertLoop(id, holder->eventLoop());
+    }
+
+    int64_t count = loop->run();
+
+    if (count < 0) {
+        LOG_ERROR << "the epoll event loop failed, stop the pool.";
+        stop();
+    }
+
+    return count;
+}
+
+}
+}
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollServerSocketChannel.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <vector>
+#include <boost/bind.hpp>
+
+#include <cetty/logging/LoggerHelper.h>
+
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelException.h>
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+EpollServerSocketChannel::EpollServerSocketChannel(
+    const EventLoopPtr& eventLoop,
+    const EventLoopPoolPtr& childEventLoopPool)
+    : Channel(ChannelPtr(), eventLoop),
+      fd_(-1),
+      idleFd_(::open("/dev/null", O_RDONLY | O_CLOEXEC)),
+      initialized_(false),
+      lastChildId_(0),
+      loop_(boost::dynamic_pointer_cast<EpollEventLoop>(eventLoop)),
+      childLoopPool_(childEventLoopPool),
+      serverConfig_(fd_),
+      acceptedCount_(0) {
+}
+
+EpollServerSocketChannel::~EpollServerSocketChannel() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+
+    if (idleFd_ >= 0) {
+        ::close(idleFd_);
+    }
+}
+
+bool EpollServerSocketChannel::doBind(const InetAddress& localAddress) {
+    struct sockaddr_storage addr;
+    socklen_t length;
+
+    if (!EpollSocketUtil::toSockAddr(localAddress, true, &addr, &length)) {
+        return false;
+    }
+
+    fd_ = EpollSocketUtil::createSocket(addr.ss_family);
+
+    if (fd_ < 0) {
+        return false;
+    }
+
+    serverConfig_.applyTo(fd_);
+
+    if (::bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), length) < 0) {
+        LOG_ERROR << "the server channel can not bind to the "
+                  << localAddress.toString() << ", errno: " << errno;
+        doClose();
+        return false;
+    }
+
+    const boost::optional<int>& backlog = serverConfig_.backlog();
+
+    if (::listen(fd_, backlog ? *backlog : SOMAXCONN) < 0) {
+        LOG_ERROR << "the server channel can not listen the "
+                  << localAddress.toString() << ", errno: " << errno;
+        doClose();
+        return false;
+    }
+
+    if (!loop_->addWatcher(fd_, EPOLLIN, this)) {
+        doClose();
+        return false;
+    }
+
+    setLocalAddress(EpollSocketUtil::localAddress(fd_));
+
+    // start the event loop pool if in main thread mode.
+    const EventLoopPoolPtr& pool = loop_->eventLoopPool();
+
+    if (pool && pool->isSingleThread()) {
+        LOG_INFO << "the epoll event loop pool starting to run in main thread.";
+
+        if (!pool->start()) {
+            LOG_ERROR << "start the epoll event loop error,"
+                      " stop the pool and close channel.";
+            pool->stop();
+            pipeline().fireExceptionCaught(
+                ChannelException("failed to start the epoll event loop in main thread."));
+
+            return doClose();
+        }
+    }
+
+    LOG_INFO << "server channel " << toString()
+             << " has bound to "  << localAddress.toString();
+    return true;
+}
+
+void EpollServerSocketChannel::handleEvents(int events) {
+    if (events & EPOLLIN) {
+        accept();
+    }
+}
+
+void EpollServerSocketChannel::accept() {
+    // edge-triggered, accept all the pending connections.
+    while (fd_ >= 0) {
+        int fd = ::accept4(fd_, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd >= 0) {
+            acceptChild(fd);
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        else if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+            continue;
+        }
+        else if ((errno == EMFILE || errno == ENFILE) && idleFd_ >= 0) {
+            LOG_ERROR << "server channel " << toString()
+                      << " runs out of file descriptors,"
+                      " drop the pending connection.";
+
+            ::close(idleFd_);
+            fd = ::accept(fd_, NULL, NULL);
+
+            if (fd >= 0) {
+                ::close(fd);
+            }
+
+            idleFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        }
+        else {
+            LOG_ERROR << "server channel " << toString()
+                      << " failed to accept a connection, errno: " << errno;
+            break;
+        }
+    }
+}
+
+void EpollServerSocketChannel::acceptChild(int fd) {
+    acceptedCount_.incrementAndGet();
+
+    const EventLoopPtr& childLoop = childLoopPool_->nextLoop();
+    EpollSocketChannelPtr channel(new EpollSocketChannel(++lastChildId_,
+                                  shared_from_this(),
+                                  childLoop,
+                                  fd));
+
+    // create the socket add it to the buffer and fire the event
+    pipeline().addInboundChannelMessage<ChannelPtr>(
+        boost::static_pointer_cast<Channel>(channel));
+    pipeline().fireMessageUpdated();
+
+    if (!channel->isOpen()) {
+        channel->open();
+    }
+
+    childChannels_.insert(std::make_pair(channel->id(), channel));
+    channel->closeFuture()->addListener(boost::bind(
+                                            &EpollServerSocketChannel::handleChildClosed,
+                                            this,
+                                            _1),
+                                        100);
+
+    LOG_INFO << "server channel " << toString()
+             << " accepted a new channel " << channel->id();
+
+    // watch and serve the channel in its own event loop.
+    childLoop->post(boost::bind(&EpollSocketChannel::acceptedInLoop, channel));
+}
+
+void EpollServerSocketChannel::handleChildClosed(const ChannelFuture& future) {
+    // always deferred, the child is still in its closing.
+    eventLoop()->post(boost::bind(&EpollServerSocketChannel::removeChild,
+                                  this,
+                                  future.channel()->id()));
+}
+
+void EpollServerSocketChannel::removeChild(int id) {
+    childChannels_.erase(id);
+}
+
+bool EpollServerSocketChannel::doClose() {
+    if (fd_ >= 0) {
+        loop_->removeWatcher(fd_, this);
+
+        if (::close(fd_) < 0) {
+            LOG_ERROR << "server channel" << toString()
+                      << " failed to close the socket, errno: " << errno;
+        }
+
+        fd_ = -1;
+    }
+
+    //close all children Channels
+    std::vector<EpollSocketChannelPtr> children;
+    ChildChannels::iterator itr = childChannels_.begin();
+
+    for (; itr != childChannels_.end(); ++itr) {
+        children.push_back(itr->second);
+    }
+
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        children[i]->close(children[i]->newVoidFuture());
+    }
+
+    return true;
+}
+
+bool EpollServerSocketChannel::doDisconnect() {
+    return true; // NOOP
+}
+
+void EpollServerSocketChannel::doPreOpen() {
+    if (!initialized_) {
+        Channel::config().setOptionSetCallback(boost::bind(
+                &EpollSocketChannelConfig::setOption,
+                &serverConfig_,
+                _1,
+                _2));
+
+        pipeline().setHead<EpollServerSocketChannel*>("head", this);
+
+        initialized_ = true;
+    }
+}
+
+}
+}
+}
@@ -0,0 +1,680 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollSocketChannel.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <boost/bind.hpp>
+#include <boost/assert.hpp>
+
+#include <cetty/channel/ChannelException.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+
+static const int DEFAULT_READER_BUFFER_SIZE = 1024 * 16;
+static const int MIN_READER_BUFFER_SIZE = 128;
+
+// reads in one event, before yielding to the other channels of the loop.
+static const int MAX_READS_PER_EVENT = 16;
+
+#if defined(IOV_MAX)
+static const int MAX_IOVEC_COUNT = IOV_MAX;
+#else
+static const int MAX_IOVEC_COUNT = 1024;
+#endif
+
+EpollSocketChannel::EpollSocketChannel(const EventLoopPtr& eventLoop)
+    : Channel(ChannelPtr(), eventLoop),
+      fd_(-1),
+      initialized_(false),
+      connecting_(false),
+      readable_(false),
+      readRequested_(false),
+      peerClosed_(false),
+      writing_(false),
+      writePending_(false),
+      writable_(1),
+      highWaterMarkCounter_(0),
+      writeBufferSize_(0),
+      loop_(boost::dynamic_pointer_cast<EpollEventLoop>(eventLoop)),
+      writeBufferContainer_(),
+      socketConfig_(fd_) {
+}
+
+EpollSocketChannel::EpollSocketChannel(int id,
+                                       const ChannelPtr& parent,
+                                       const EventLoopPtr& eventLoop,
+                                       int fd)
+    : Channel(id, parent, eventLoop),
+      fd_(fd),
+      initialized_(false),
+      connecting_(false),
+      readable_(false),
+      readRequested_(false),
+      peerClosed_(false),
+      writing_(false),
+      writePending_(false),
+      writable_(1),
+      highWaterMarkCounter_(0),
+      writeBufferSize_(0),
+      loop_(boost::dynamic_pointer_cast<EpollEventLoop>(eventLoop)),
+      writeBufferContainer_(),
+      socketConfig_(fd_) {
+}
+
+EpollSocketChannel::~EpollSocketChannel() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+
+    LOG_DEBUG << "EpollSocketChannel dtor";
+}
+
+void EpollSocketChannel::registerTo(Context& context) {
+    Channel::registerTo(context);
+
+    writeBufferContainer_ = context.outboundContainer();
+
+    context.setConnectFunctor(boost::bind(
+                                  &EpollSocketChannel::doConnect,
+                                  this,
+                                  _1,
+                                  _2,
+                                  _3,
+                                  _4));
+
+    context.setFlushFunctor(boost::bind(
+                                &EpollSocketChannel::doFlush,
+                                this,
+                                _1,
+                                _2));
+
+    context.setReadFunctor(boost::bind(
+                               &EpollSocketChannel::doRead,
+                               this));
+}
+
+void EpollSocketChannel::doPreOpen() {
+    if (!initialized_) {
+        Channel::config().setOptionSetCallback(boost::bind(
+                &EpollSocketChannelConfig::setOption,
+                &socketConfig_,
+                _1,
+                _2));
+
+        // no need use weak_ptr here
+        pipeline().setHead<EpollSocketChannel*>("head", this);
+
+        initialized_ = true;
+    }
+}
+
+void EpollSocketChannel::doPreFireActive() {
+    setLocalAddress(EpollSocketUtil::localAddress(fd_));
+    setRemoteAddress(EpollSocketUtil::remoteAddress(fd_));
+}
+
+bool EpollSocketChannel::doBind(const InetAddress& localAddress) {
+    return true;
+}
+
+bool EpollSocketChannel::doDisconnect() {
+    return doClose();
+}
+
+bool EpollSocketChannel::doClose() {
+    if (fd_ < 0) {
+        LOG_WARN << "channel " << toString()
+                 << " do close, but its already closed.";
+        return true;
+    }
+
+    loop_->removeWatcher(fd_, this);
+
+    if (isActive() && ::shutdown(fd_, SHUT_RDWR) < 0) {
+        LOG_WARN << "channel " << toString()
+                 << " failed to shutdown the socket, errno: " << errno;
+    }
+
+    if (::close(fd_) < 0) {
+        LOG_ERROR << "channel " << toString()
+                  << " failed to close the socket, errno: " << errno;
+    }
+
+    fd_ = -1;
+
+    connecting_ = false;
+    readable_ = false;
+    writePending_ = false;
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    failWriteOperations(ChannelException("channel closed"));
+    return true;
+}
+
+void EpollSocketChannel::acceptedInLoop() {
+    if (fd_ < 0 || !isOpen()) {
+        return;
+    }
+
+    if (!loop_->addWatcher(fd_, EPOLLIN | EPOLLOUT | EPOLLRDHUP, this)) {
+        close(newVoidFuture());
+        return;
+    }
+
+    setActived();
+    LOG_INFO << "channel " << toString() << " accepted, firing connection event.";
+
+    if (config().autoRead()) {
+        doRead();
+    }
+    else {
+        pipeline().fireChannelReadSuspended();
+    }
+}
+
+void EpollSocketChannel::doConnect(ChannelHandlerContext& ctx,
+                                   const InetAddress& remoteAddress,
+                                   const InetAddress& localAddress,
+                                   const ChannelFuturePtr& future) {
+    if (!isOpen()) {
+        LOG_WARN << "channel " << toString()
+                 << " try to connect to remote before channel open.";
+        return;
+    }
+
+    if (connecting_ || fd_ >= 0) {
+        LOG_WARN << "channel " << toString()
+                 << " connection attempt already made";
+        return;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t length;
+
+    if (!EpollSocketUtil::toSockAddr(remoteAddress, false, &addr, &length)) {
+        connectFailed(future, ChannelException(
+                          "can NOT resolve the remote address " + remoteAddress.toString()));
+        return;
+    }
+
+    fd_ = EpollSocketUtil::createSocket(addr.ss_family);
+
+    if (fd_ < 0) {
+        connectFailed(future, ChannelException("failed to create the socket", errno));
+        return;
+    }
+
+    socketConfig_.applyTo(fd_);
+
+    if (localAddress) {
+        struct sockaddr_storage local;
+        socklen_t localLength;
+
+        if (!EpollSocketUtil::toSockAddr(localAddress, true, &local, &localLength)
+                || ::bind(fd_, reinterpret_cast<struct sockaddr*>(&local), localLength) < 0) {
+            connectFailed(future, ChannelException(
+                              "failed to bind to " + localAddress.toString(), errno));
+            return;
+        }
+    }
+
+    if (::connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), length) < 0
+            && errno != EINPROGRESS) {
+        int error = errno;
+        LOG_ERROR << "channel " << toString()
+                  << " failed to connect to " << remoteAddress.toString()
+                  << ", errno: " << error;
+
+        connectFailed(future, ChannelException(strerror(error), error));
+        return;
+    }
+
+    // the connected or connecting socket turns writable when done,
+    // which is reported once it is registered in the edge-triggered mode.
+    connecting_ = true;
+    connectFuture_ = future;
+
+    if (!loop_->addWatcher(fd_, EPOLLIN | EPOLLOUT | EPOLLRDHUP, this)) {
+        connectFailed(future, ChannelException("failed to watch the socket"));
+        return;
+    }
+
+    LOG_INFO << "channel " << toString() << " begin to connect "
+             << remoteAddress.toString() << " asynchronously";
+
+    // Schedule connect timeout.
+    int connectTimeoutMillis = config().connectTimeout();
+
+    if (connectTimeoutMillis > 0) {
+        connectTimeout_ =
+            loop_->runAfter(connectTimeoutMillis,
+                            boost::bind(
+                                &EpollSocketChannel::handleConnectTimeout,
+                                this,
+                                future));
+    }
+
+    const EventLoopPoolPtr& pool = eventLoop()->eventLoopPool();
+
+    if (pool && pool->isSingleThread()) {
+        LOG_INFO << "the epoll event loop pool starting to run in main thread.";
+
+        if (!pool->start()) {
+            LOG_ERROR << "start the epoll event loop error,"
+                      << " and firing an exception, then terminate self.";
+            ChannelException e("the epoll event loop can not be started.");
+            connectFailed(future, e);
+        }
+    }
+}
+
+void EpollSocketChannel::handleConnect() {
+    ChannelFuturePtr future;
+    future.swap(connectFuture_);
+
+    int error = EpollSocketUtil::socketError(fd_);
+
+    if (error) {
+        LOG_ERROR << "channel " << toString()
+                  << " failed to connect to remote server, errno: " << error;
+
+        connectFailed(future, ChannelException(strerror(error), error));
+        return;
+    }
+
+    connecting_ = false;
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    setActived();
+    future->setSuccess();
+
+    LOG_INFO << "channel " << toString()
+             << " connected, firing connection event.";
+
+    if (config().autoRead()) {
+        doRead();
+    }
+    else {
+        pipeline().fireChannelReadSuspended();
+    }
+}
+
+void EpollSocketChannel::handleConnectTimeout(const ChannelFuturePtr& future) {
+    connectTimeout_.reset();
+
+    if (connecting_) {
+        connectFailed(future, ChannelException("connection timed out"));
+    }
+}
+
+void EpollSocketChannel::connectFailed(const ChannelFuturePtr& future,
+                                       const ChannelException& e) {
+    connecting_ = false;
+    connectFuture_.reset();
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    future->setFailure(e);
+    pipeline().fireExceptionCaught(e);
+    close(newVoidFuture());
+}
+
+void EpollSocketChannel::handleEvents(int events) {
+    if (connecting_) {
+        if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            return;
+        }
+
+        handleConnect();
+
+        if (fd_ < 0) {
+            return;
+        }
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        readable_ = true;
+
+        if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            peerClosed_ = true;
+        }
+
+        if (readRequested_) {
+            readInLoop();
+        }
+    }
+
+    if (fd_ >= 0 && (events & EPOLLOUT) && writePending_ && !writing_) {
+        writeInLoop();
+    }
+}
+
+void EpollSocketChannel::doRead() {
+    if (!isActive()) {
+        return;
+    }
+
+    readRequested_ = true;
+
+    if (readable_) {
+        readInLoop();
+    }
+}
+
+void EpollSocketChannel::readInLoop() {
+    char* extraBuffer = loop_->extraReadBuffer();
+
+    for (int i = 0; i < MAX_READS_PER_EVENT; ++i) {
+        if (fd_ < 0 || !readable_ || !readRequested_) {
+            return;
+        }
+
+        // allocate in the loop thread, after the channel options have been set.
+        if (!readBuffer_) {
+            readBuffer_ = newReadBuffer(DEFAULT_READER_BUFFER_SIZE);
+        }
+
+        int size;
+        char* buf = readBuffer_->writableBytes(&size);
+
+        // auto increment the capacity.
+        if (size < MIN_READER_BUFFER_SIZE) {
+            readBuffer_->ensureWritableBytes(4096, true);
+            buf = readBuffer_->writableBytes(&size);
+        }
+
+        struct iovec vec[2];
+        vec[0].iov_base = buf;
+        vec[0].iov_len = size;
+        vec[1].iov_base = extraBuffer;
+        vec[1].iov_len = EpollEventLoop::EXTRA_READ_BUFFER_SIZE;
+
+        ssize_t n = ::readv(fd_, vec, 2);
+
+        if (n > 0) {
+            if (n <= size) {
+                readBuffer_->offsetWriterIndex(static_cast<int>(n));
+            }
+            else {
+                readBuffer_->offsetWriterIndex(size);
+                readBuffer_->writeBytes(extraBuffer, static_cast<int>(n) - size);
+            }
+
+            LOG_DEBUG << "channel " << toString()
+                      << " has read " << n << " bytes";
+
+            // a short read drains the socket, unless the peer has closed,
+            // then read on to the EOF.
+            if (n < size + EpollEventLoop::EXTRA_READ_BUFFER_SIZE && !peerClosed_) {
+                readable_ = false;
+            }
+
+            pipeline().addInboundChannelBuffer(readBuffer_);
+            pipeline().fireMessageUpdated();
+
+            // channel may be closed when error happed in the message process
+            if (fd_ < 0) {
+                return;
+            }
+
+            if (!config().autoRead()) {
+                readRequested_ = false;
+                pipeline().fireChannelReadSuspended();
+                return;
+            }
+        }
+        else if (n == 0) {
+            LOG_INFO << "channel " << toString()
+                     << " closed by the remote peer.";
+            close(newVoidFuture());
+            return;
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            readable_ = false;
+            return;
+        }
+        else {
+            LOG_ERROR << "channel " << toString()
+                      << " read error, errno: " << errno;
+            close(newVoidFuture());
+            return;
+        }
+    }
+
+    // still readable, go on reading after the other ready channels.
+    if (readable_ && fd_ >= 0) {
+        loop_->post(boost::bind(
+                        &EpollSocketChannel::readInLoop,
+                        boost::static_pointer_cast<EpollSocketChannel>(shared_from_this())));
+    }
+}
+
+ChannelBufferPtr EpollSocketChannel::newReadBuffer(int size) {
+    if (config().pooledBuffer()) {
+        return PooledChannelBufferFactory::buffer(size);
+    }
+    else {
+        return Unpooled::buffer(size);
+    }
+}
+
+void EpollSocketChannel::doFlush(ChannelHandlerContext& ctx,
+                                 const ChannelFuturePtr& future) {
+    BOOST_ASSERT(writeBufferContainer_);
+
+    if (!isActive() || fd_ < 0) {
+        LOG_ERROR << "channel " << toString()
+                  << " failed to send the msg, because the socket is"
+                  " disconnected.";
+
+        if (future) {
+            future->setFailure(ChannelException("Channel is not active."));
+        }
+
+        return;
+    }
+
+    const ChannelBufferPtr& buffer = writeBufferContainer_->getMessages();
+
+    writeOperations_.push_back(WriteOperation());
+    WriteOperation& op = writeOperations_.back();
+
+    op.written = 0;
+    op.future = future;
+
+    if (buffer) {
+        op.buffer = buffer;
+        buffer->slice(&op.gathering);
+    }
+
+    op.size = op.gathering.bytesCount();
+    writeBufferSize_ += op.size;
+
+    if (!writing_ && !writePending_) {
+        writeInLoop();
+    }
+
+    if (writable_.relaxedGet() && fd_ >= 0 &&
+            writeBufferSize_ > socketConfig_.writeBufferHighWaterMark()) {
+        LOG_DEBUG << "channel " << toString() << " has "
+                  << writeBufferSize_
+                  << " bytes waiting to be written, turns not writable.";
+
+        writable_.set(0);
+        ++highWaterMarkCounter_;
+        pipeline().fireChannelWritabilityChanged();
+    }
+}
+
+void EpollSocketChannel::writeInLoop() {
+    struct iovec vec[MAX_IOVEC_COUNT];
+    int maxBytes = socketConfig_.writeBatchBytes();
+
+    writing_ = true;
+    writePending_ = false;
+
+    while (!writeOperations_.empty() && fd_ >= 0) {
+        int count = 0;
+        int bytes = 0;
+
+        // gather the queued operations, always take the first one, even it
+        // is larger than the max bytes.
+        for (WriteOperations::iterator itr = writeOperations_.begin();
+                itr != writeOperations_.end()
+                && count < MAX_IOVEC_COUNT
+                && (bytes == 0 || bytes < maxBytes);
+                ++itr) {
+            int skip = itr->written;
+
+            for (int i = 0, j = itr->gathering.blockCount();
+                    i < j && count < MAX_IOVEC_COUNT; ++i) {
+                const StringPiece& block = itr->gathering.at(i);
+
+                if (skip >= block.size()) {
+                    skip -= block.size();
+                    continue;
+                }
+
+                vec[count].iov_base = const_cast<char*>(block.data()) + skip;
+                vec[count].iov_len = block.size() - skip;
+                bytes += block.size() - skip;
+                skip = 0;
+                ++count;
+            }
+        }
+
+        ssize_t n = 0;
+
+        if (bytes > 0) {
+            n = ::writev(fd_, vec, count);
+
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    writePending_ = true;
+                    break;
+                }
+
+                int error = errno;
+                LOG_ERROR << "channel " << toString()
+                          << " failed to write buffer, errno: " << error;
+
+                writing_ = false;
+                failWriteOperations(ChannelException(strerror(error), error));
+                close(newVoidFuture());
+                return;
+            }
+        }
+
+        LOG_DEBUG << "channel " << toString()
+                  << " written " << n << " of " << bytes << " bytes.";
+
+        // complete all the operations written in order, by the byte count
+        // returned, the listeners may flush or close again.
+        int written = static_cast<int>(n);
+
+        while (!writeOperations_.empty() && fd_ >= 0) {
+            WriteOperation& op = writeOperations_.front();
+            int remain = op.size - op.written;
+
+            if (written < remain) {
+                op.written += written;
+                writeBufferSize_ -= written;
+                break;
+            }
+
+            written -= remain;
+            writeBufferSize_ -= remain;
+
+            ChannelFuturePtr future;
+            future.swap(op.future);
+            writeOperations_.pop_front();
+
+            if (future) {
+                future->setSuccess();
+            }
+        }
+
+        if (n < bytes) {
+            // the socket send buffer is full, wait for the EPOLLOUT.
+            writePending_ = true;
+            break;
+        }
+    }
+
+    writing_ = false;
+
+    if (!writable_.relaxedGet() && fd_ >= 0 &&
+            writeBufferSize_ < socketConfig_.writeBufferLowWaterMark()) {
+        writable_.set(1);
+        pipeline().fireChannelWritabilityChanged();
+    }
+}
+
+void EpollSocketChannel::failWriteOperations(const ChannelException& e) {
+    while (!writeOperations_.empty()) {
+        ChannelFuturePtr future;
+        future.swap(writeOperations_.front().future);
+        writeOperations_.pop_front();
+
+        if (future) {
+            future->setFailure(e);
+        }
+    }
+
+    writeBufferSize_ = 0;
+}
+
+}
+}
+}
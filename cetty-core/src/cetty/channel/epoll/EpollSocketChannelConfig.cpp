@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollSocketChannelConfig.h>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+static const int DEFAULT_WRITE_BUFFER_HIGH_WATERMARK = 2 * 1024 * 1024;
+static const int DEFAULT_WRITE_BATCH_BYTES = 256 * 1024;
+
+EpollSocketChannelConfig::EpollSocketChannelConfig(const int& fd)
+    : fd_(fd),
+      writeBufferHighWaterMark_(DEFAULT_WRITE_BUFFER_HIGH_WATERMARK),
+      writeBufferLowWaterMark_(0),
+      writeBatchBytes_(DEFAULT_WRITE_BATCH_BYTES) {
+}
+
+bool EpollSocketChannelConfig::setOption(const ChannelOption& option,
+        const ChannelOption::Variant& value) {
+    if (option == ChannelOption::CO_TCP_NODELAY) {
+        setTcpNoDelay(boost::get<bool>(value));
+    }
+    else if (option == ChannelOption::CO_SO_KEEPALIVE) {
+        setKeepAlive(boost::get<bool>(value));
+    }
+    else if (option == ChannelOption::CO_SO_REUSEADDR) {
+        setReuseAddress(boost::get<bool>(value));
+    }
+    else if (option == ChannelOption::CO_SO_REUSEPORT) {
+        setReusePort(boost::get<bool>(value));
+    }
+    else if (option == ChannelOption::CO_SO_LINGER) {
+        setSoLinger(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_SO_SNDBUF) {
+        setSendBufferSize(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_SO_RCVBUF) {
+        setReceiveBufferSize(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_SO_BACKLOG) {
+        setBacklog(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_SNDHIGHWAT) {
+        setWriteBufferHighWaterMark(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK) {
+        setWriteBufferLowWaterMark(boost::get<int>(value));
+    }
+    else if (option == ChannelOption::CO_WRITE_BATCH_BYTES) {
+        setWriteBatchBytes(boost::get<int>(value));
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+void EpollSocketChannelConfig::applyTo(int fd) const {
+    if (tcpNoDelay_) {
+        EpollSocketUtil::setOption(fd, IPPROTO_TCP, TCP_NODELAY, *tcpNoDelay_);
+    }
+
+    if (keepAlive_) {
+        EpollSocketUtil::setOption(fd, SOL_SOCKET, SO_KEEPALIVE, *keepAlive_);
+    }
+
+    if (reuseAddress_) {
+        EpollSocketUtil::setOption(fd, SOL_SOCKET, SO_REUSEADDR, *reuseAddress_);
+    }
+
+#if defined(SO_REUSEPORT)
+
+    if (reusePort_) {
+        EpollSocketUtil::setOption(fd, SOL_SOCKET, SO_REUSEPORT, *reusePort_);
+    }
+
+#endif
+
+    if (sendBufferSize_) {
+        EpollSocketUtil::setOption(fd, SOL_SOCKET, SO_SNDBUF, *sendBufferSize_);
+    }
+
+    if (receiveBufferSize_) {
+        EpollSocketUtil::setOption(fd, SOL_SOCKET, SO_RCVBUF, *receiveBufferSize_);
+    }
+
+    if (soLinger_) {
+        struct linger linger;
+        linger.l_onoff = *soLinger_ > 0 ? 1 : 0;
+        linger.l_linger = *soLinger_ > 0 ? *soLinger_ : 0;
+
+        if (::setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger)) < 0) {
+            LOG_WARN << "failed to set the SO_LINGER of fd " << fd;
+        }
+    }
+}
+
+void EpollSocketChannelConfig::setTcpNoDelay(bool tcpNoDelay) {
+    setBoolOption(IPPROTO_TCP, TCP_NODELAY, tcpNoDelay, &tcpNoDelay_);
+}
+
+void EpollSocketChannelConfig::setKeepAlive(bool keepAlive) {
+    setBoolOption(SOL_SOCKET, SO_KEEPALIVE, keepAlive, &keepAlive_);
+}
+
+void EpollSocketChannelConfig::setReuseAddress(bool reuseAddress) {
+    setBoolOption(SOL_SOCKET, SO_REUSEADDR, reuseAddress, &reuseAddress_);
+}
+
+void EpollSocketChannelConfig::setReusePort(bool reusePort) {
+#if defined(SO_REUSEPORT)
+    setBoolOption(SOL_SOCKET, SO_REUSEPORT, reusePort, &reusePort_);
+#else
+    LOG_WARN << "SO_REUSEPORT is not supported on this platform, ignored.";
+#endif
+}
+
+void EpollSocketChannelConfig::setSoLinger(int soLinger) {
+    soLinger_ = soLinger;
+
+    if (fd_ >= 0) {
+        applyTo(fd_);
+    }
+}
+
+void EpollSocketChannelConfig::setSendBufferSize(int sendBufferSize) {
+    setIntOption(SOL_SOCKET, SO_SNDBUF, sendBufferSize, &sendBufferSize_);
+}
+
+void EpollSocketChannelConfig::setReceiveBufferSize(int receiveBufferSize) {
+    setIntOption(SOL_SOCKET, SO_RCVBUF, receiveBufferSize, &receiveBufferSize_);
+}
+
+void EpollSocketChannelConfig::setWriteBufferHighWaterMark(int writeBufferHighWaterMark) {
+    if (writeBufferHighWaterMark > 0) {
+        writeBufferHighWaterMark_ = writeBufferHighWaterMark;
+    }
+    else {
+        LOG_WARN << "the write buffer high water mark should be positive.";
+    }
+}
+
+void EpollSocketChannelConfig::setWriteBatchBytes(int writeBatchBytes) {
+    if (writeBatchBytes > 0) {
+        writeBatchBytes_ = writeBatchBytes;
+    }
+    else {
+        LOG_WARN << "the write batch bytes should be positive.";
+    }
+}
+
+void EpollSocketChannelConfig::setBoolOption(int level,
+        int name,
+        bool src,
+        boost::optional<bool>* dest) {
+    *dest = src;
+
+    if (fd_ >= 0) {
+        EpollSocketUtil::setOption(fd_, level, name, src ? 1 : 0);
+    }
+}
+
+void EpollSocketChannelConfig::setIntOption(int level,
+        int name,
+        int src,
+        boost::optional<int>* dest) {
+    *dest = src;
+
+    if (fd_ >= 0) {
+        EpollSocketUtil::setOption(fd_, level, name, src);
+    }
+}
+
+}
+}
+}
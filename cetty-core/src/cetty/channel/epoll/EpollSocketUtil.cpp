@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+
+#include <errno.h>
+#include <netdb.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <cetty/util/StringUtil.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::util;
+
+bool EpollSocketUtil::toSockAddr(const InetAddress& address,
+                                 bool passive,
+                                 struct sockaddr_storage* addr,
+                                 socklen_t* length) {
+    BOOST_ASSERT(addr && length);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+
+    hints.ai_family = address.family() == InetAddress::FAMILY_IPv6
+                      ? AF_INET6 : (address.family() == InetAddress::FAMILY_IPv4
+                                    ? AF_INET : AF_UNSPEC);
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV | (passive ? AI_PASSIVE : 0);
+
+    const std::string& host = address.host();
+    std::string port = StringUtil::numtostr(address.port());
+
+    struct addrinfo* result = NULL;
+    int error = ::getaddrinfo(host.empty() ? NULL : host.c_str(),
+                              port.c_str(),
+                              &hints,
+                              &result);
+
+    if (error || !result) {
+        LOG_ERROR << "can NOT resolve " << address.toString()
+                  << ", error: " << gai_strerror(error);
+        return false;
+    }
+
+    memcpy(addr, result->ai_addr, result->ai_addrlen);
+    *length = result->ai_addrlen;
+
+    ::freeaddrinfo(result);
+    return true;
+}
+
+InetAddress EpollSocketUtil::toInetAddress(const struct sockaddr_storage& addr) {
+    char host[INET6_ADDRSTRLEN] = { 0 };
+
+    if (addr.ss_family == AF_INET) {
+        const struct sockaddr_in* in =
+            reinterpret_cast<const struct sockaddr_in*>(&addr);
+
+        ::inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+        return InetAddress(host, ntohs(in->sin_port));
+    }
+    else if (addr.ss_family == AF_INET6) {
+        const struct sockaddr_in6* in6 =
+            reinterpret_cast<const struct sockaddr_in6*>(&addr);
+
+        ::inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+        return InetAddress(host, ntohs(in6->sin6_port));
+    }
+
+    return InetAddress();
+}
+
+InetAddress EpollSocketUtil::localAddress(int fd) {
+    struct sockaddr_storage addr;
+    socklen_t length = sizeof(addr);
+
+    if (::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length) < 0) {
+        LOG_WARN << "failed to get the local address of fd " << fd
+                 << ", errno: " << errno;
+        return InetAddress();
+    }
+
+    return toInetAddress(addr);
+}
+
+InetAddress EpollSocketUtil::remoteAddress(int fd) {
+    struct sockaddr_storage addr;
+    socklen_t length = sizeof(addr);
+
+    if (::getpeername(fd, reinterpret_cast<struct sockaddr*>(&addr), &length) < 0) {
+        LOG_WARN << "failed to get the remote address of fd " << fd
+                 << ", errno: " << errno;
+        return InetAddress();
+    }
+
+    return toInetAddress(addr);
+}
+
+int EpollSocketUtil::createSocket(int family) {
+    int fd = ::socket(family,
+                      SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                      IPPROTO_TCP);
+
+    if (fd < 0) {
+        LOG_ERROR << "failed to create the socket, errno: " << errno;
+    }
+
+    return fd;
+}
+
+int EpollSocketUtil::socketError(int fd) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0) {
+        return errno;
+    }
+
+    return error;
+}
+
+bool EpollSocketUtil::setOption(int fd, int level, int name, int value) {
+    if (::setsockopt(fd, level, name, &value, sizeof(value)) < 0) {
+        LOG_WARN << "failed to set the socket option " << level << ":" << name
+                 << " of fd " << fd << ", errno: " << errno;
+        return false;
+    }
+
+    return true;
+}
+
+bool EpollSocketUtil::getOption(int fd, int level, int name, int* value) {
+    socklen_t length = sizeof(*value);
+    return ::getsockopt(fd, level, name, value, &length) == 0;
+}
+
+}
+}
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/uring/IoUring.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <vector>
+
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+template<typename T>
+static inline T* ringAt(void* ring, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+static inline unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned* p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+bool IoUring::isSupported() {
+    // probed once, a race only probes more than once.
+    static int supported = -1;
+
+    if (supported >= 0) {
+        return supported > 0;
+    }
+
+    IoUring ring;
+
+    if (!ring.open(4)) {
+        supported = 0;
+        return false;
+    }
+
+    // waiting with a timeout in io_uring_enter, and no completion dropped.
+    if (!(ring.features_ & IORING_FEAT_EXT_ARG)
+            || !(ring.features_ & IORING_FEAT_NODROP)) {
+        LOG_INFO << "the io_uring of the kernel is too old, features: "
+                 << ring.features_;
+        supported = 0;
+        return false;
+    }
+
+    static const int MAX_PROBE_OPS = 256;
+    std::vector<char> buffer(sizeof(struct io_uring_probe)
+                             + MAX_PROBE_OPS * sizeof(struct io_uring_probe_op), 0);
+
+    struct io_uring_probe* probe =
+        reinterpret_cast<struct io_uring_probe*>(&buffer[0]);
+
+    if (ioUringRegister(ring.fd(), IORING_REGISTER_PROBE, probe, MAX_PROBE_OPS) < 0) {
+        supported = 0;
+        return false;
+    }
+
+    static const int REQUIRED_OPS[] = {
+        IORING_OP_READ,
+        IORING_OP_RECV,
+        IORING_OP_SENDMSG,
+        IORING_OP_ACCEPT,
+        IORING_OP_CONNECT,
+        IORING_OP_ASYNC_CANCEL
+    };
+
+    supported = 1;
+
+    for (std::size_t i = 0; i < sizeof(REQUIRED_OPS) / sizeof(int); ++i) {
+        int op = REQUIRED_OPS[i];
+
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            LOG_INFO << "the io_uring of the kernel does not support the op " << op;
+            supported = 0;
+            break;
+        }
+    }
+
+    return supported > 0;
+}
+
+IoUring::IoUring()
+    : fd_(-1),
+      features_(0),
+      sqRing_(MAP_FAILED),
+      cqRing_(MAP_FAILED),
+      sqRingSize_(0),
+      cqRingSize_(0),
+      sqes_(NULL),
+      sqesSize_(0),
+      sqHead_(NULL),
+      sqTail_(NULL),
+      sqFlags_(NULL),
+      sqArray_(NULL),
+      sqMask_(0),
+      sqEntries_(0),
+      sqeTail_(0),
+      cqHead_(NULL),
+      cqTail_(NULL),
+      cqMask_(0),
+      cqes_(NULL) {
+}
+
+IoUring::~IoUring() {
+    close();
+}
+
+bool IoUring::open(unsigned entries) {
+    if (isOpen()) {
+        return true;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CLAMP;
+
+    fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+
+    if (fd_ < 0) {
+        LOG_INFO << "failed to setup the io_uring, errno: " << errno;
+        return false;
+    }
+
+    features_ = params.features;
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes
+                  + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // the two rings share one mapping since Linux 5.4.
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (cqRingSize_ > sqRingSize_) {
+            sqRingSize_ = cqRingSize_;
+        }
+
+        cqRingSize_ = sqRingSize_;
+    }
+
+    sqRing_ = ::mmap(NULL, sqRingSize_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+
+    if (sqRing_ == MAP_FAILED) {
+        LOG_ERROR << "failed to map the io_uring submission ring, errno: " << errno;
+        close();
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cqRing_ = sqRing_;
+    }
+    else {
+        cqRing_ = ::mmap(NULL, cqRingSize_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+
+        if (cqRing_ == MAP_FAILED) {
+            LOG_ERROR << "failed to map the io_uring completion ring, errno: " << errno;
+            close();
+            return false;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = ::mmap(NULL, sqesSize_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+
+    if (sqes == MAP_FAILED) {
+        LOG_ERROR << "failed to map the io_uring submission entries, errno: " << errno;
+        close();
+        return false;
+    }
+
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    sqHead_ = ringAt<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = ringAt<unsigned>(sqRing_, params.sq_off.tail);
+    sqFlags_ = ringAt<unsigned>(sqRing_, params.sq_off.flags);
+    sqArray_ = ringAt<unsigned>(sqRing_, params.sq_off.array);
+    sqMask_ = *ringAt<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqEntries_ = *ringAt<unsigned>(sqRing_, params.sq_off.ring_entries);
+    sqeTail_ = *sqTail_;
+
+    // the entries are always submitted in order.
+    for (unsigned i = 0; i < sqEntries_; ++i) {
+        sqArray_[i] = i;
+    }
+
+    cqHead_ = ringAt<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = ringAt<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = *ringAt<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = ringAt<struct io_uring_cqe>(cqRing_, params.cq_off.cqes);
+
+    return true;
+}
+
+void IoUring::close() {
+    if (sqes_) {
+        ::munmap(sqes_, sqesSize_);
+        sqes_ = NULL;
+    }
+
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        ::munmap(cqRing_, cqRingSize_);
+    }
+
+    if (sqRing_ != MAP_FAILED) {
+        ::munmap(sqRing_, sqRingSize_);
+    }
+
+    sqRing_ = MAP_FAILED;
+    cqRing_ = MAP_FAILED;
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+struct io_uring_sqe* IoUring::getSqe() {
+    if (sqeTail_ - loadAcquire(sqHead_) >= sqEntries_) {
+        return NULL;
+    }
+
+    struct io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    ++sqeTail_;
+
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+unsigned IoUring::pendingSubmissions() const {
+    return sqeTail_ - *sqTail_;
+}
+
+unsigned IoUring::toSubmit() const {
+    return sqeTail_ - loadAcquire(sqHead_);
+}
+
+int IoUring::submit() {
+    return submitAndWait(0);
+}
+
+int IoUring::submitAndWait(int64_t waitMicros) {
+    storeRelease(sqTail_, sqeTail_);
+
+    unsigned count = toSubmit();
+    unsigned flags = 0;
+    unsigned minComplete = 0;
+
+    // the completions overflowed are flushed to the ring when getting events.
+    if (waitMicros != 0 || (loadAcquire(sqFlags_) & IORING_SQ_CQ_OVERFLOW)) {
+        flags |= IORING_ENTER_GETEVENTS;
+        minComplete = waitMicros != 0 ? 1 : 0;
+    }
+
+    if (!count && !flags) {
+        return 0;
+    }
+
+    if (waitMicros > 0) {
+        struct __kernel_timespec ts;
+        ts.tv_sec = waitMicros / 1000000;
+        ts.tv_nsec = (waitMicros % 1000000) * 1000;
+
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+        return enter(count,
+                     minComplete,
+                     flags | IORING_ENTER_EXT_ARG,
+                     &arg,
+                     sizeof(arg));
+    }
+
+    return enter(count, minComplete, flags, NULL, _NSIG / 8);
+}
+
+int IoUring::enter(unsigned toSubmit,
+                   unsigned minComplete,
+                   unsigned flags,
+                   const void* arg,
+                   size_t argSize) {
+    long ret = ::syscall(__NR_io_uring_enter,
+                         fd_,
+                         toSubmit,
+                         minComplete,
+                         flags,
+                         arg,
+                         argSize);
+
+    return ret < 0 ? -errno : static_cast<int>(ret);
+}
+
+struct io_uring_cqe* IoUring::peekCqe() {
+    unsigned head = *cqHead_;
+
+    if (head == loadAcquire(cqTail_)) {
+        return NULL;
+    }
+
+    return &cqes_[head & cqMask_];
+}
+
+void IoUring::seen() {
+    storeRelease(cqHead_, *cqHead_ + 1);
+}
+
+}
+}
+}
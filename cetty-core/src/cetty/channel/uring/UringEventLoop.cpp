@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/uring/UringEventLoop.h>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cetty/util/CachedClock.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::util;
+
+static const boost::posix_time::ptime EPOCH(boost::gregorian::date(1970, 1, 1));
+
+// completions handled before running the posted handlers and timeouts.
+static const int MAX_COMPLETIONS_PER_REAP = 1024;
+
+UringTimeout::UringTimeout(UringEventLoop& loop,
+                           int64_t deadline,
+                           int64_t period,
+                           const Handler& handler)
+    : state_(TIMER_UNINITIALIZED),
+      scheduled_(false),
+      deadline_(deadline),
+      period_(period > 0 ? period : 0),
+      handler_(handler),
+      loop_(loop) {
+}
+
+UringTimeout::~UringTimeout() {
+}
+
+bool UringTimeout::isExpired() const {
+    return state_ == TIMER_EXPIRED;
+}
+
+bool UringTimeout::isCancelled() const {
+    return state_ == TIMER_CANCELLED;
+}
+
+bool UringTimeout::isActived() const {
+    return state_ == TIMER_ACTIVE;
+}
+
+void UringTimeout::cancel() {
+    if (state_ == TIMER_CANCELLED
+            || (state_ == TIMER_EXPIRED && !period_)) {
+        return;
+    }
+
+    state_ = TIMER_CANCELLED;
+
+    if (loop_.inLoopThread()) {
+        loop_.cancel(UringTimeoutPtr(this));
+    }
+    else {
+        loop_.post(boost::bind(&UringEventLoop::cancel,
+                               &loop_,
+                               UringTimeoutPtr(this)));
+    }
+}
+
+boost::int64_t UringTimeout::expiresFromNow() const {
+    return (deadline_ - CachedClock::nowInMicros()) / 1000;
+}
+
+UringEventLoop::UringEventLoop(const EventLoopPoolPtr& pool)
+    : EventLoop(pool),
+      wakeupFd_(-1),
+      wakeupValue_(0),
+      wakeupCompletion_(this, &UringEventLoop::handleWakeup) {
+    if (!ring_.open(RING_ENTRIES)) {
+        LOG_ERROR << "failed to create the io_uring event loop.";
+        return;
+    }
+
+    // a blocking eventfd, or the read in the ring fails with EAGAIN.
+    wakeupFd_ = ::eventfd(0, EFD_CLOEXEC);
+
+    if (wakeupFd_ < 0) {
+        LOG_ERROR << "failed to create the eventfd, errno: " << errno;
+        return;
+    }
+
+    armWakeup();
+}
+
+UringEventLoop::~UringEventLoop() {
+    timeouts_.clear();
+
+    // the wakeup read is dropped with the ring.
+    ring_.close();
+
+    if (wakeupFd_ >= 0) {
+        ::close(wakeupFd_);
+    }
+}
+
+int64_t UringEventLoop::run() {
+    if (!isOpen()) {
+        LOG_ERROR << "the io_uring event loop has not opened, can not run.";
+        return -1;
+    }
+
+    int64_t count = 0;
+
+    // the timestamps in one iteration share one system clock reading.
+    CachedClock::enable();
+
+    while (!stopped()) {
+        // submit all the operations queued in the last iteration, and wait
+        // for the completions in one system call.
+        int ret = ring_.submitAndWait(waitTime());
+
+        CachedClock::invalidate();
+        int64_t start = CachedClock::nowInMicros();
+
+        if (ret < 0 && ret != -ETIME && ret != -EINTR
+                && ret != -EAGAIN && ret != -EBUSY) {
+            LOG_ERROR << "io_uring_enter failed, errno: " << -ret;
+            count = -1;
+            break;
+        }
+
+        count += reapCompletions();
+        count += runPostedHandlers();
+        count += expireTimeouts();
+
+        CachedClock::invalidate();
+        int64_t end = CachedClock::nowInMicros();
+        addBusyTime(end, end - start);
+    }
+
+    CachedClock::disable();
+
+    LOG_INFO << "io_uring event loop completed, and " << count
+             << " completions and handlers that were executed.";
+    return count;
+}
+
+int UringEventLoop::reapCompletions() {
+    int count = 0;
+    struct io_uring_cqe* cqe;
+
+    while (count < MAX_COMPLETIONS_PER_REAP && (cqe = ring_.peekCqe()) != NULL) {
+        Completion* completion = reinterpret_cast<Completion*>(
+                                     static_cast<uintptr_t>(cqe->user_data));
+        int result = cqe->res;
+        unsigned flags = cqe->flags;
+
+        // release the entry first, the completion may queue more.
+        ring_.seen();
+        ++count;
+
+        // the cancel requests carry no completion.
+        if (completion) {
+            completion->complete(result, flags);
+        }
+    }
+
+    return count;
+}
+
+int64_t UringEventLoop::waitTime() {
+    // do not block if handlers were posted in the loop thread, or the
+    // completions left by the last reaping.
+    if (!handlers_.empty() || ring_.peekCqe()) {
+        return 0;
+    }
+
+    if (timeouts_.empty()) {
+        return -1;
+    }
+
+    int64_t delay = timeouts_.begin()->first - CachedClock::nowInMicros();
+    return delay > 0 ? delay : 0;
+}
+
+void UringEventLoop::stop() {
+    EventLoop::stop();
+    wakeup();
+}
+
+void UringEventLoop::post(const Handler& handler) {
+    taskPosted();
+
+    // the loop thread checks the queue before waiting.
+    if (handlers_.push(handler) && !inLoopThread()) {
+        wakeup();
+    }
+}
+
+void UringEventLoop::PostedHandlerRunner::operator()(
+    const Handler& handler) const {
+    loop->taskCompleted();
+    handler();
+}
+
+int UringEventLoop::runPostedHandlers() {
+    return handlers_.popAll(PostedHandlerRunner(this));
+}
+
+void UringEventLoop::wakeup() {
+    uint64_t one = 1;
+
+    if (::write(wakeupFd_, &one, sizeof(one)) < 0) {
+        LOG_ERROR << "failed to wake up the io_uring event loop, errno: " << errno;
+    }
+}
+
+void UringEventLoop::armWakeup() {
+    struct io_uring_sqe* sqe = getSqe(&wakeupCompletion_);
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeupFd_;
+    sqe->addr = reinterpret_cast<uintptr_t>(&wakeupValue_);
+    sqe->len = sizeof(wakeupValue_);
+}
+
+void UringEventLoop::handleWakeup(int result, unsigned flags) {
+    if (result < 0 && result != -EINTR && result != -EAGAIN) {
+        LOG_ERROR << "failed to read the eventfd, errno: " << -result;
+    }
+
+    armWakeup();
+}
+
+struct io_uring_sqe* UringEventLoop::getSqe(Completion* completion) {
+    struct io_uring_sqe* sqe = ring_.getSqe();
+
+    // the submission ring is full, submit the queued ones first.
+    while (!sqe) {
+        int ret = ring_.submit();
+
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            LOG_ERROR << "failed to submit the io_uring entries, errno: " << -ret;
+        }
+
+        sqe = ring_.getSqe();
+
+        // the completion ring is full too, make room for the submitting.
+        if (!sqe && (ret == -EBUSY || ret == -EAGAIN)) {
+            reapCompletions();
+        }
+    }
+
+    sqe->user_data = reinterpret_cast<uintptr_t>(completion);
+    return sqe;
+}
+
+void UringEventLoop::cancelOperation(Completion* completion) {
+    struct io_uring_sqe* sqe = getSqe(NULL);
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uintptr_t>(completion);
+}
+
+TimeoutPtr UringEventLoop::runAt(const boost::posix_time::ptime& timestamp,
+                                 const Handler& handler) {
+    return newTimeout((timestamp - EPOCH).total_microseconds(), 0, handler);
+}
+
+TimeoutPtr UringEventLoop::runAfter(int64_t millisecond,
+                                    const Handler& handler) {
+    int64_t delay = millisecond > 0 ? millisecond * 1000 : 0;
+    return newTimeout(CachedClock::nowInMicros() + delay, 0, handler);
+}
+
+TimeoutPtr UringEventLoop::runEvery(int64_t millisecond,
+                                    const Handler& handler) {
+    int64_t period = millisecond > 0 ? millisecond * 1000 : 0;
+    return newTimeout(CachedClock::nowInMicros() + period, period, handler);
+}
+
+TimeoutPtr UringEventLoop::newTimeout(int64_t deadline,
+                                      int64_t period,
+                                      const Handler& handler) {
+    if (!handler) {
+        LOG_WARN << "Timer handler is empty, do nothing.";
+        return TimeoutPtr();
+    }
+
+    UringTimeoutPtr timeout(new UringTimeout(*this, deadline, period, handler));
+    timeout->state_ = UringTimeout::TIMER_ACTIVE;
+
+    if (inLoopThread()) {
+        schedule(timeout);
+    }
+    else {
+        post(boost::bind(&UringEventLoop::schedule, this, timeout));
+    }
+
+    return boost::static_pointer_cast<Timeout>(timeout);
+}
+
+void UringEventLoop::schedule(const UringTimeoutPtr& timeout) {
+    // cancelled before the posted scheduling.
+    if (timeout->state_ != UringTimeout::TIMER_ACTIVE) {
+        return;
+    }
+
+    // the waiting of the next iteration is bounded by the earliest deadline.
+    timeout->position_ =
+        timeouts_.insert(std::make_pair(timeout->deadline_, timeout));
+    timeout->scheduled_ = true;
+}
+
+void UringEventLoop::cancel(const UringTimeoutPtr& timeout) {
+    if (timeout->scheduled_) {
+        timeout->scheduled_ = false;
+        timeouts_.erase(timeout->position_);
+    }
+}
+
+int UringEventLoop::expireTimeouts() {
+    if (timeouts_.empty()) {
+        return 0;
+    }
+
+    int64_t now = CachedClock::nowInMicros();
+
+    if (timeouts_.begin()->first > now) {
+        return 0;
+    }
+
+    std::vector<UringTimeoutPtr> expired;
+
+    while (!timeouts_.empty() && timeouts_.begin()->first <= now) {
+        expired.push_back(timeouts_.begin()->second);
+        expired.back()->scheduled_ = false;
+        timeouts_.erase(timeouts_.begin());
+    }
+
+    for (std::size_t i = 0; i < expired.size(); ++i) {
+        UringTimeout* timeout = expired[i].get();
+
+        // cancelled by the handlers expired before.
+        if (timeout->state_ != UringTimeout::TIMER_ACTIVE) {
+            continue;
+        }
+
+        timeout->state_ = UringTimeout::TIMER_EXPIRED;
+        timeout->handler_();
+
+        if (timeout->period_ > 0
+                && timeout->state_ == UringTimeout::TIMER_EXPIRED) {
+            timeout->deadline_ += timeout->period_;
+
+            // do not catch up the periods missed.
+            if (timeout->deadline_ <= now) {
+                timeout->deadline_ = now + timeout->period_;
+            }
+
+            timeout->state_ = UringTimeout::TIMER_ACTIVE;
+            schedule(expired[i]);
+        }
+    }
+
+    return static_cast<int>(expired.size());
+}
+
+}
+}
+}
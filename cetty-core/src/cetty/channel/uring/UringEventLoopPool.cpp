@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/uring/UringEventLoopPool.h>
+
+#include <boost/bind.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/logging/LoggerHelper.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#include <cetty/channel/uring/IoUring.h>
+#include <cetty/channel/uring/UringEventLoop.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+class UringEventLoopHolder : public EventLoopPool::EventLoopHolder {
+public:
+    enum {
+        INITIALIZED =  0,
+        RUNNING     =  1,
+        STOPPED     = -1
+    };
+
+    typedef boost::shared_ptr<boost::thread> ThreadPtr;
+
+public:
+    UringEventLoopHolder(const UringEventLoopPtr& loop)
+        : state_(INITIALIZED),
+          loop_(loop),
+          eventLoop_(boost::static_pointer_cast<EventLoop>(loop)) {
+    }
+
+    virtual ~UringEventLoopHolder() {
+    }
+
+    virtual const EventLoopPtr& eventLoop() const {
+        return eventLoop_;
+    }
+
+    const UringEventLoopPtr& loop() const {
+        return loop_;
+    }
+
+    void setThread(const ThreadPtr& thread) {
+        thread_ = thread;
+    }
+
+    void waitingForStop() {
+        if (thread_) {
+            thread_->join();
+        }
+    }
+
+    void stop() {
+        if (state_ != STOPPED && loop_) {
+            state_ = STOPPED;
+            loop_->stop();
+        }
+    }
+
+private:
+    int state_;
+
+    ThreadPtr thread_;
+    UringEventLoopPtr loop_;
+    EventLoopPtr eventLoop_;
+};
+
+EventLoopPoolPtr UringEventLoopPool::create(int threadCnt) {
+    return create(threadCnt, EventLoopThreadPlacement());
+}
+
+EventLoopPoolPtr UringEventLoopPool::create(int threadCnt,
+        const EventLoopThreadPlacement& placement) {
+    if (IoUring::isSupported()) {
+        return new UringEventLoopPool(threadCnt, placement);
+    }
+
+    LOG_WARN << "the kernel does not support the io_uring,"
+             " fall back to the asio event loop pool.";
+
+    return new cetty::channel::asio::AsioServicePool(threadCnt,
+            false,
+            placement);
+}
+
+UringEventLoopPool::UringEventLoopPool(int threadCnt)
+    : EventLoopPool(threadCnt) {
+    init();
+}
+
+UringEventLoopPool::UringEventLoopPool(int threadCnt,
+        const EventLoopThreadPlacement& placement)
+    : EventLoopPool(threadCnt, placement) {
+    init();
+}
+
+void UringEventLoopPool::init() {
+    for (int i = 0; i < size(); ++i) {
+        appendLoopHolder(new UringEventLoopHolder(
+                             new UringEventLoop(shared_from_this())));
+    }
+
+    // automatic start
+    if (!isSingleThread()) {
+        LOG_INFO << "automatic start the " << size()
+                 << " io_uring event loops in thread";
+
+        for (int i = 0; i < size(); ++i) {
+            UringEventLoopHolder* holder =
+                down_cast<UringEventLoopHolder*>(loopHolderAt(i));
+
+            holder->setThread(
+                UringEventLoopHolder::ThreadPtr(new boost::thread(
+                            boost::bind(&UringEventLoopPool::runLoopInThread,
+                                        this,
+                                        holder,
+                                        i))));
+        }
+
+        setStarted(true);
+    }
+    else {
+        LOG_INFO << "the io_uring event loop pool is main thread mode,"
+                 " will start later.";
+
+        UringEventLoopHolder* holder =
+            down_cast<UringEventLoopHolder*>(loopHolderAt(0));
+
+        ThreadId id = CurrentThread::id();
+        holder->eventLoop()->setThreadId(id);
+        insertLoop(id, holder->eventLoop());
+    }
+}
+
+bool UringEventLoopPool::start() {
+    if (!isStarted() && isSingleThread()) {
+        LOG_INFO << "start the UringEventLoopPool in main thread mode.";
+
+        if (runLoop(down_cast<UringEventLoopHolder*>(loopHolderAt(0))) < 0) {
+            LOG_ERROR << "UringEventLoopPool run the main thread loop error.";
+            return false;
+        }
+    }
+
+    setStarted(true);
+    return true;
+}
+
+void UringEventLoopPool::stop() {
+    for (int i = 0; i < size(); ++i) {
+        UringEventLoopHolder* holder =
+            down_cast<UringEventLoopHolder*>(loopHolderAt(i));
+
+        holder->stop();
+    }
+
+    setStarted(false);
+}
+
+void UringEventLoopPool::waitingForStop() {
+    if (isSingleThread()) {
+        return;
+    }
+
+    for (int i = 0; i < size(); ++i) {
+        UringEventLoopHolder* holder =
+            down_cast<UringEventLoopHolder*>(loopHolderAt(i));
+
+        holder->waitingForStop();
+    }
+}
+
+const EventLoopPtr& UringEventLoopPool::nextLoop() {
+    return loopHolderAt(nextLoopIndex())->eventLoop();
+}
+
+int64_t UringEventLoopPool::runLoopInThread(UringEventLoopHolder* holder,
+        int index) {
+    placeLoopThread(index);
+    return runLoop(holder);
+}
+
+int64_t UringEventLoopPool::runLoop(UringEventLoopHolder* holder) {
+    BOOST_ASSERT(holder && holder->loop() && "event loop can not be NULL.");
+
+    const UringEventLoopPtr& loop = holder->loop();
+
+    ThreadId id = CurrentThread::id();
+    loop->setThreadId(id);
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        insertLoop(id, holder->eventLoop());
+    }
+
+    int64_t count = loop->run();
+
+    if (count < 0) {
+        LOG_ERROR << "the io_uring event loop failed, stop the pool.";
+        stop();
+    }
+
+    return count;
+}
+
+}
+}
+}
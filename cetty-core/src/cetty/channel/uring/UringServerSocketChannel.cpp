@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/uring/UringServerSocketChannel.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <vector>
+#include <boost/bind.hpp>
+
+#include <cetty/logging/LoggerHelper.h>
+
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelException.h>
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::channel;
+using cetty::channel::epoll::EpollSocketUtil;
+
+static void releaseChannel(const ChannelPtr& channel) {
+}
+
+UringServerSocketChannel::UringServerSocketChannel(
+    const EventLoopPtr& eventLoop,
+    const EventLoopPoolPtr& childEventLoopPool)
+    : Channel(ChannelPtr(), eventLoop),
+      fd_(-1),
+      idleFd_(::open("/dev/null", O_RDONLY | O_CLOEXEC)),
+      dropNextChild_(false),
+#if defined(IORING_ACCEPT_MULTISHOT)
+      multishot_(true),
+#else
+      multishot_(false),
+#endif
+      accepting_(false),
+      acceptOperation_(this, &UringServerSocketChannel::handleAccept),
+      initialized_(false),
+      lastChildId_(0),
+      loop_(boost::dynamic_pointer_cast<UringEventLoop>(eventLoop)),
+      childLoopPool_(childEventLoopPool),
+      serverConfig_(fd_),
+      acceptedCount_(0) {
+}
+
+UringServerSocketChannel::~UringServerSocketChannel() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+
+    if (idleFd_ >= 0) {
+        ::close(idleFd_);
+    }
+}
+
+bool UringServerSocketChannel::doBind(const InetAddress& localAddress) {
+    struct sockaddr_storage addr;
+    socklen_t length;
+
+    if (!EpollSocketUtil::toSockAddr(localAddress, true, &addr, &length)) {
+        return false;
+    }
+
+    fd_ = EpollSocketUtil::createSocket(addr.ss_family);
+
+    if (fd_ < 0) {
+        return false;
+    }
+
+    serverConfig_.applyTo(fd_);
+
+    if (::bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), length) < 0) {
+        LOG_ERROR << "the server channel can not bind to the "
+                  << localAddress.toString() << ", errno: " << errno;
+        doClose();
+        return false;
+    }
+
+    const boost::optional<int>& backlog = serverConfig_.backlog();
+
+    if (::listen(fd_, backlog ? *backlog : SOMAXCONN) < 0) {
+        LOG_ERROR << "the server channel can not listen the "
+                  << localAddress.toString() << ", errno: " << errno;
+        doClose();
+        return false;
+    }
+
+    setLocalAddress(EpollSocketUtil::localAddress(fd_));
+
+    // the ring is only touched in the loop thread.
+    if (loop_->inLoopThread()) {
+        startAccept();
+    }
+    else {
+        loop_->post(boost::bind(&UringServerSocketChannel::startAccept,
+                                boost::static_pointer_cast<UringServerSocketChannel>(
+                                    shared_from_this())));
+    }
+
+    // start the event loop pool if in main thread mode.
+    const EventLoopPoolPtr& pool = loop_->eventLoopPool();
+
+    if (pool && pool->isSingleThread()) {
+        LOG_INFO << "the io_uring event loop pool starting to run in main thread.";
+
+        if (!pool->start()) {
+            LOG_ERROR << "start the io_uring event loop error,"
+                      " stop the pool and close channel.";
+            pool->stop();
+            pipeline().fireExceptionCaught(
+                ChannelException("failed to start the io_uring event loop in main thread."));
+
+            return doClose();
+        }
+    }
+
+    LOG_INFO << "server channel " << toString()
+             << " has bound to "  << localAddress.toString();
+    return true;
+}
+
+void UringServerSocketChannel::startAccept() {
+    if (fd_ < 0 || accepting_) {
+        return;
+    }
+
+    struct io_uring_sqe* sqe = loop_->getSqe(&acceptOperation_);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd_;
+
+    // the socket operations of the io_uring are parked on the readiness
+    // of the non-blocking sockets too, instead of failing with EAGAIN.
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+#if defined(IORING_ACCEPT_MULTISHOT)
+
+    if (multishot_) {
+        sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+    }
+
+#endif
+
+    accepting_ = true;
+    self_ = shared_from_this();
+}
+
+void UringServerSocketChannel::handleAccept(int result, unsigned flags) {
+    // the multishot accept goes on while the more flag is set.
+    bool more = multishot_ && (flags & IORING_CQE_F_MORE);
+    bool broken = false;
+
+    if (result >= 0) {
+        if (fd_ < 0 || dropNextChild_) {
+            ::close(result);
+
+            if (dropNextChild_) {
+                dropNextChild_ = false;
+                idleFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            }
+        }
+        else {
+            acceptChild(result);
+        }
+    }
+    else if (result == -EINVAL && multishot_ && !more) {
+        LOG_INFO << "the kernel does not support the multishot accept,"
+                 " accept one by one.";
+        multishot_ = false;
+    }
+    else if ((result == -EMFILE || result == -ENFILE) && idleFd_ >= 0) {
+        LOG_ERROR << "server channel " << toString()
+                  << " runs out of file descriptors,"
+                  " drop the pending connection.";
+
+        ::close(idleFd_);
+        idleFd_ = -1;
+        dropNextChild_ = true;
+    }
+    else if (result != -ECANCELED && result != -EINTR && result != -EAGAIN
+             && result != -ECONNABORTED && result != -EPROTO) {
+        LOG_ERROR << "server channel " << toString()
+                  << " failed to accept a connection, errno: " << -result;
+
+        // the listening socket itself is bad, accepting again only fails.
+        broken = (result == -EINVAL || result == -EBADF || result == -ENOTSOCK);
+    }
+
+    if (more) {
+        return;
+    }
+
+    accepting_ = false;
+
+    if (fd_ >= 0 && !broken) {
+        startAccept();
+    }
+    else {
+        // released after the completion returned.
+        loop_->post(boost::bind(&releaseChannel, self_));
+        self_.reset();
+    }
+}
+
+void UringServerSocketChannel::acceptChild(int fd) {
+    acceptedCount_.incrementAndGet();
+
+    const EventLoopPtr& childLoop = childLoopPool_->nextLoop();
+    UringSocketChannelPtr channel(new UringSocketChannel(++lastChildId_,
+                                  shared_from_this(),
+                                  childLoop,
+                                  fd));
+
+    // create the socket add it to the buffer and fire the event
+    pipeline().addInboundChannelMessage<ChannelPtr>(
+        boost::static_pointer_cast<Channel>(channel));
+    pipeline().fireMessageUpdated();
+
+    if (!channel->isOpen()) {
+        channel->open();
+    }
+
+    childChannels_.insert(std::make_pair(channel->id(), channel));
+    channel->closeFuture()->addListener(boost::bind(
+                                            &UringServerSocketChannel::handleChildClosed,
+                                            this,
+                                            _1),
+                                        100);
+
+    LOG_INFO << "server channel " << toString()
+             << " accepted a new channel " << channel->id();
+
+    // serve the channel in its own event loop.
+    childLoop->post(boost::bind(&UringSocketChannel::acceptedInLoop, channel));
+}
+
+void UringServerSocketChannel::handleChildClosed(const ChannelFuture& future) {
+    // always deferred, the child is still in its closing.
+    eventLoop()->post(boost::bind(&UringServerSocketChannel::removeChild,
+                                  this,
+                                  future.channel()->id()));
+}
+
+void UringServerSocketChannel::removeChild(int id) {
+    childChannels_.erase(id);
+}
+
+bool UringServerSocketChannel::doClose() {
+    if (fd_ >= 0) {
+        if (accepting_) {
+            loop_->cancelOperation(&acceptOperation_);
+        }
+
+        if (::close(fd_) < 0) {
+            LOG_ERROR << "server channel" << toString()
+                      << " failed to close the socket, errno: " << errno;
+        }
+
+        fd_ = -1;
+    }
+
+    //close all children Channels
+    std::vector<UringSocketChannelPtr> children;
+    ChildChannels::iterator itr = childChannels_.begin();
+
+    for (; itr != childChannels_.end(); ++itr) {
+        children.push_back(itr->second);
+    }
+
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        children[i]->close(children[i]->newVoidFuture());
+    }
+
+    return true;
+}
+
+bool UringServerSocketChannel::doDisconnect() {
+    return true; // NOOP
+}
+
+void UringServerSocketChannel::doPreOpen() {
+    if (!initialized_) {
+        Channel::config().setOptionSetCallback(boost::bind(
+                &EpollSocketChannelConfig::setOption,
+                &serverConfig_,
+                _1,
+                _2));
+
+        pipeline().setHead<UringServerSocketChannel*>("head", this);
+
+        initialized_ = true;
+    }
+}
+
+}
+}
+}
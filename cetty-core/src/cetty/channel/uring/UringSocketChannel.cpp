@@ -0,0 +1,692 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/channel/uring/UringSocketChannel.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include <boost/bind.hpp>
+#include <boost/assert.hpp>
+
+#include <cetty/channel/ChannelException.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/epoll/EpollSocketUtil.h>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using cetty::channel::epoll::EpollSocketUtil;
+
+static const int DEFAULT_READER_BUFFER_SIZE = 1024 * 16;
+static const int MIN_READER_BUFFER_SIZE = 128;
+
+#if defined(IOV_MAX)
+static const int MAX_IOVEC_COUNT = IOV_MAX;
+#else
+static const int MAX_IOVEC_COUNT = 1024;
+#endif
+
+static void releaseChannel(const ChannelPtr& channel) {
+}
+
+UringSocketChannel::UringSocketChannel(const EventLoopPtr& eventLoop)
+    : Channel(ChannelPtr(), eventLoop),
+      fd_(-1),
+      initialized_(false),
+      connecting_(false),
+      reading_(false),
+      readRequested_(false),
+      writing_(false),
+      writable_(1),
+      highWaterMarkCounter_(0),
+      writeBufferSize_(0),
+      loop_(boost::dynamic_pointer_cast<UringEventLoop>(eventLoop)),
+      pendingOperations_(0),
+      connectOperation_(this, &UringSocketChannel::handleConnect),
+      readOperation_(this, &UringSocketChannel::handleRead),
+      writeOperation_(this, &UringSocketChannel::handleWrite),
+      writeBufferContainer_(),
+      sendingBytes_(0),
+      socketConfig_(fd_),
+      remoteLength_(0) {
+    memset(&message_, 0, sizeof(message_));
+}
+
+UringSocketChannel::UringSocketChannel(int id,
+                                       const ChannelPtr& parent,
+                                       const EventLoopPtr& eventLoop,
+                                       int fd)
+    : Channel(id, parent, eventLoop),
+      fd_(fd),
+      initialized_(false),
+      connecting_(false),
+      reading_(false),
+      readRequested_(false),
+      writing_(false),
+      writable_(1),
+      highWaterMarkCounter_(0),
+      writeBufferSize_(0),
+      loop_(boost::dynamic_pointer_cast<UringEventLoop>(eventLoop)),
+      pendingOperations_(0),
+      connectOperation_(this, &UringSocketChannel::handleConnect),
+      readOperation_(this, &UringSocketChannel::handleRead),
+      writeOperation_(this, &UringSocketChannel::handleWrite),
+      writeBufferContainer_(),
+      sendingBytes_(0),
+      socketConfig_(fd_),
+      remoteLength_(0) {
+    memset(&message_, 0, sizeof(message_));
+}
+
+UringSocketChannel::~UringSocketChannel() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+
+    LOG_DEBUG << "UringSocketChannel dtor";
+}
+
+void UringSocketChannel::registerTo(Context& context) {
+    Channel::registerTo(context);
+
+    writeBufferContainer_ = context.outboundContainer();
+
+    context.setConnectFunctor(boost::bind(
+                                  &UringSocketChannel::doConnect,
+                                  this,
+                                  _1,
+                                  _2,
+                                  _3,
+                                  _4));
+
+    context.setFlushFunctor(boost::bind(
+                                &UringSocketChannel::doFlush,
+                                this,
+                                _1,
+                                _2));
+
+    context.setReadFunctor(boost::bind(
+                               &UringSocketChannel::doRead,
+                               this));
+}
+
+void UringSocketChannel::doPreOpen() {
+    if (!initialized_) {
+        Channel::config().setOptionSetCallback(boost::bind(
+                &EpollSocketChannelConfig::setOption,
+                &socketConfig_,
+                _1,
+                _2));
+
+        // no need use weak_ptr here
+        pipeline().setHead<UringSocketChannel*>("head", this);
+
+        initialized_ = true;
+    }
+}
+
+void UringSocketChannel::doPreFireActive() {
+    setLocalAddress(EpollSocketUtil::localAddress(fd_));
+    setRemoteAddress(EpollSocketUtil::remoteAddress(fd_));
+}
+
+bool UringSocketChannel::doBind(const InetAddress& localAddress) {
+    return true;
+}
+
+bool UringSocketChannel::doDisconnect() {
+    return doClose();
+}
+
+bool UringSocketChannel::doClose() {
+    if (fd_ < 0) {
+        LOG_WARN << "channel " << toString()
+                 << " do close, but its already closed.";
+        return true;
+    }
+
+    // the operations in flight complete soon after the shutdown, the
+    // cancelling covers the ones not started yet.
+    if (isActive() && ::shutdown(fd_, SHUT_RDWR) < 0) {
+        LOG_WARN << "channel " << toString()
+                 << " failed to shutdown the socket, errno: " << errno;
+    }
+
+    if (connecting_) {
+        loop_->cancelOperation(&connectOperation_);
+    }
+
+    if (reading_) {
+        loop_->cancelOperation(&readOperation_);
+    }
+
+    if (writing_) {
+        loop_->cancelOperation(&writeOperation_);
+    }
+
+    // the operations in flight hold the file till completed.
+    if (::close(fd_) < 0) {
+        LOG_ERROR << "channel " << toString()
+                  << " failed to close the socket, errno: " << errno;
+    }
+
+    fd_ = -1;
+    connecting_ = false;
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    // the buffers being sent are released after the sending completed.
+    if (!writing_) {
+        failWriteOperations(ChannelException("channel closed"));
+    }
+
+    return true;
+}
+
+void UringSocketChannel::acceptedInLoop() {
+    if (fd_ < 0 || !isOpen()) {
+        return;
+    }
+
+    setActived();
+    LOG_INFO << "channel " << toString() << " accepted, firing connection event.";
+
+    if (config().autoRead()) {
+        doRead();
+    }
+    else {
+        pipeline().fireChannelReadSuspended();
+    }
+}
+
+void UringSocketChannel::doConnect(ChannelHandlerContext& ctx,
+                                   const InetAddress& remoteAddress,
+                                   const InetAddress& localAddress,
+                                   const ChannelFuturePtr& future) {
+    if (!isOpen()) {
+        LOG_WARN << "channel " << toString()
+                 << " try to connect to remote before channel open.";
+        return;
+    }
+
+    if (connecting_ || fd_ >= 0) {
+        LOG_WARN << "channel " << toString()
+                 << " connection attempt already made";
+        return;
+    }
+
+    if (!EpollSocketUtil::toSockAddr(remoteAddress, false, &remote_, &remoteLength_)) {
+        connectFailed(future, ChannelException(
+                          "can NOT resolve the remote address " + remoteAddress.toString()));
+        return;
+    }
+
+    fd_ = EpollSocketUtil::createSocket(remote_.ss_family);
+
+    if (fd_ < 0) {
+        connectFailed(future, ChannelException("failed to create the socket", errno));
+        return;
+    }
+
+    socketConfig_.applyTo(fd_);
+
+    if (localAddress) {
+        struct sockaddr_storage local;
+        socklen_t localLength;
+
+        if (!EpollSocketUtil::toSockAddr(localAddress, true, &local, &localLength)
+                || ::bind(fd_, reinterpret_cast<struct sockaddr*>(&local), localLength) < 0) {
+            connectFailed(future, ChannelException(
+                              "failed to bind to " + localAddress.toString(), errno));
+            return;
+        }
+    }
+
+    struct io_uring_sqe* sqe = loop_->getSqe(&connectOperation_);
+    sqe->opcode = IORING_OP_CONNECT;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uintptr_t>(&remote_);
+    sqe->off = remoteLength_;
+
+    connecting_ = true;
+    connectFuture_ = future;
+    operationStarted();
+
+    LOG_INFO << "channel " << toString() << " begin to connect "
+             << remoteAddress.toString() << " asynchronously";
+
+    // Schedule connect timeout.
+    int connectTimeoutMillis = config().connectTimeout();
+
+    if (connectTimeoutMillis > 0) {
+        connectTimeout_ =
+            loop_->runAfter(connectTimeoutMillis,
+                            boost::bind(
+                                &UringSocketChannel::handleConnectTimeout,
+                                this,
+                                future));
+    }
+
+    const EventLoopPoolPtr& pool = eventLoop()->eventLoopPool();
+
+    if (pool && pool->isSingleThread()) {
+        LOG_INFO << "the io_uring event loop pool starting to run in main thread.";
+
+        if (!pool->start()) {
+            LOG_ERROR << "start the io_uring event loop error,"
+                      << " and firing an exception, then terminate self.";
+            ChannelException e("the io_uring event loop can not be started.");
+            connectFailed(future, e);
+        }
+    }
+}
+
+void UringSocketChannel::handleConnect(int result, unsigned flags) {
+    if (fd_ < 0 || !connecting_) {
+        operationCompleted();
+        return;
+    }
+
+    ChannelFuturePtr future;
+    future.swap(connectFuture_);
+    connecting_ = false;
+
+    // the kernels before 6.2 issue the connect again once the socket turns
+    // writable, which finds it connected already.
+    if (result < 0 && result != -EISCONN) {
+        int error = -result;
+        LOG_ERROR << "channel " << toString()
+                  << " failed to connect to remote server, errno: " << error;
+
+        connectFailed(future, ChannelException(strerror(error), error));
+        operationCompleted();
+        return;
+    }
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    setActived();
+    future->setSuccess();
+
+    LOG_INFO << "channel " << toString()
+             << " connected, firing connection event.";
+
+    if (config().autoRead()) {
+        doRead();
+    }
+    else {
+        pipeline().fireChannelReadSuspended();
+    }
+
+    operationCompleted();
+}
+
+void UringSocketChannel::handleConnectTimeout(const ChannelFuturePtr& future) {
+    connectTimeout_.reset();
+
+    if (connecting_) {
+        connectFailed(future, ChannelException("connection timed out"));
+    }
+}
+
+void UringSocketChannel::connectFailed(const ChannelFuturePtr& future,
+                                       const ChannelException& e) {
+    connectFuture_.reset();
+
+    if (connectTimeout_) {
+        connectTimeout_->cancel();
+        connectTimeout_.reset();
+    }
+
+    future->setFailure(e);
+    pipeline().fireExceptionCaught(e);
+    close(newVoidFuture());
+
+    connecting_ = false;
+}
+
+void UringSocketChannel::doRead() {
+    if (!isActive()) {
+        return;
+    }
+
+    readRequested_ = true;
+    submitRead();
+}
+
+void UringSocketChannel::submitRead() {
+    if (fd_ < 0 || reading_ || !readRequested_) {
+        return;
+    }
+
+    // allocate in the loop thread, after the channel options have been set.
+    if (!readBuffer_) {
+        readBuffer_ = newReadBuffer(DEFAULT_READER_BUFFER_SIZE);
+    }
+
+    int size;
+    char* buf = readBuffer_->writableBytes(&size);
+
+    // auto increment the capacity.
+    if (size < MIN_READER_BUFFER_SIZE) {
+        readBuffer_->ensureWritableBytes(4096, true);
+        buf = readBuffer_->writableBytes(&size);
+    }
+
+    struct io_uring_sqe* sqe = loop_->getSqe(&readOperation_);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uintptr_t>(buf);
+    sqe->len = static_cast<unsigned>(size);
+
+    reading_ = true;
+    operationStarted();
+}
+
+void UringSocketChannel::handleRead(int result, unsigned flags) {
+    reading_ = false;
+
+    if (fd_ < 0) {
+        operationCompleted();
+        return;
+    }
+
+    if (result > 0) {
+        readBuffer_->offsetWriterIndex(result);
+
+        LOG_DEBUG << "channel " << toString()
+                  << " has read " << result << " bytes";
+
+        pipeline().addInboundChannelBuffer(readBuffer_);
+        pipeline().fireMessageUpdated();
+
+        // channel may be closed when error happed in the message process
+        if (fd_ >= 0) {
+            if (config().autoRead()) {
+                submitRead();
+            }
+            else {
+                readRequested_ = false;
+                pipeline().fireChannelReadSuspended();
+            }
+        }
+    }
+    else if (result == 0) {
+        LOG_INFO << "channel " << toString()
+                 << " closed by the remote peer.";
+        close(newVoidFuture());
+    }
+    else if (result == -EINTR || result == -EAGAIN) {
+        submitRead();
+    }
+    else {
+        LOG_ERROR << "channel " << toString()
+                  << " read error, errno: " << -result;
+        close(newVoidFuture());
+    }
+
+    operationCompleted();
+}
+
+ChannelBufferPtr UringSocketChannel::newReadBuffer(int size) {
+    if (config().pooledBuffer()) {
+        return PooledChannelBufferFactory::buffer(size);
+    }
+    else {
+        return Unpooled::buffer(size);
+    }
+}
+
+void UringSocketChannel::doFlush(ChannelHandlerContext& ctx,
+                                 const ChannelFuturePtr& future) {
+    BOOST_ASSERT(writeBufferContainer_);
+
+    if (!isActive() || fd_ < 0) {
+        LOG_ERROR << "channel " << toString()
+                  << " failed to send the msg, because the socket is"
+                  " disconnected.";
+
+        if (future) {
+            future->setFailure(ChannelException("Channel is not active."));
+        }
+
+        return;
+    }
+
+    const ChannelBufferPtr& buffer = writeBufferContainer_->getMessages();
+
+    writeOperations_.push_back(WriteOperation());
+    WriteOperation& op = writeOperations_.back();
+
+    op.written = 0;
+    op.future = future;
+
+    if (buffer) {
+        op.buffer = buffer;
+        buffer->slice(&op.gathering);
+    }
+
+    op.size = op.gathering.bytesCount();
+    writeBufferSize_ += op.size;
+
+    // the operations flushed while sending go with the next sendmsg.
+    if (!writing_) {
+        submitWrite();
+    }
+
+    if (writable_.relaxedGet() && fd_ >= 0 &&
+            writeBufferSize_ > socketConfig_.writeBufferHighWaterMark()) {
+        LOG_DEBUG << "channel " << toString() << " has "
+                  << writeBufferSize_
+                  << " bytes waiting to be written, turns not writable.";
+
+        writable_.set(0);
+        ++highWaterMarkCounter_;
+        pipeline().fireChannelWritabilityChanged();
+    }
+}
+
+void UringSocketChannel::submitWrite() {
+    int maxBytes = socketConfig_.writeBatchBytes();
+    int bytes = 0;
+
+    blocks_.clear();
+
+    // gather the queued operations, always take the first one, even it
+    // is larger than the max bytes.
+    for (WriteOperations::iterator itr = writeOperations_.begin();
+            itr != writeOperations_.end()
+            && static_cast<int>(blocks_.size()) < MAX_IOVEC_COUNT
+            && (bytes == 0 || bytes < maxBytes);
+            ++itr) {
+        int skip = itr->written;
+
+        for (int i = 0, j = itr->gathering.blockCount();
+                i < j && static_cast<int>(blocks_.size()) < MAX_IOVEC_COUNT; ++i) {
+            const StringPiece& block = itr->gathering.at(i);
+
+            if (skip >= block.size()) {
+                skip -= block.size();
+                continue;
+            }
+
+            struct iovec vec;
+            vec.iov_base = const_cast<char*>(block.data()) + skip;
+            vec.iov_len = block.size() - skip;
+            blocks_.push_back(vec);
+
+            bytes += block.size() - skip;
+            skip = 0;
+        }
+    }
+
+    if (bytes == 0) {
+        // only the empty operations, complete them at once.
+        handleWrite(0, 0);
+        return;
+    }
+
+    message_.msg_iov = &blocks_[0];
+    message_.msg_iovlen = blocks_.size();
+
+    struct io_uring_sqe* sqe = loop_->getSqe(&writeOperation_);
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uintptr_t>(&message_);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+
+    sendingBytes_ = bytes;
+    writing_ = true;
+    operationStarted();
+}
+
+void UringSocketChannel::handleWrite(int result, unsigned flags) {
+    // the empty operations completed in place, not in flight.
+    bool inFlight = writing_;
+
+    writing_ = false;
+
+    if (fd_ < 0) {
+        failWriteOperations(ChannelException("channel closed"));
+
+        if (inFlight) {
+            operationCompleted();
+        }
+
+        return;
+    }
+
+    if (result < 0) {
+        if (result == -EINTR || result == -EAGAIN) {
+            submitWrite();
+        }
+        else {
+            int error = -result;
+            LOG_ERROR << "channel " << toString()
+                      << " failed to write buffer, errno: " << error;
+
+            failWriteOperations(ChannelException(strerror(error), error));
+            close(newVoidFuture());
+        }
+
+        if (inFlight) {
+            operationCompleted();
+        }
+
+        return;
+    }
+
+    LOG_DEBUG << "channel " << toString()
+              << " written " << result << " of " << sendingBytes_ << " bytes.";
+
+    // complete all the operations written in order, by the byte count
+    // returned, the listeners may flush or close again.
+    int written = result;
+    writing_ = true;
+
+    while (!writeOperations_.empty() && fd_ >= 0) {
+        WriteOperation& op = writeOperations_.front();
+        int remain = op.size - op.written;
+
+        if (written < remain) {
+            op.written += written;
+            writeBufferSize_ -= written;
+            break;
+        }
+
+        written -= remain;
+        writeBufferSize_ -= remain;
+
+        ChannelFuturePtr future;
+        future.swap(op.future);
+        writeOperations_.pop_front();
+
+        if (future) {
+            future->setSuccess();
+        }
+    }
+
+    writing_ = false;
+
+    if (fd_ < 0) {
+        failWriteOperations(ChannelException("channel closed"));
+    }
+    else if (!writeOperations_.empty()) {
+        // the rest of a partial send, and the operations flushed meanwhile.
+        submitWrite();
+    }
+
+    if (!writable_.relaxedGet() && fd_ >= 0 &&
+            writeBufferSize_ < socketConfig_.writeBufferLowWaterMark()) {
+        writable_.set(1);
+        pipeline().fireChannelWritabilityChanged();
+    }
+
+    if (inFlight) {
+        operationCompleted();
+    }
+}
+
+void UringSocketChannel::failWriteOperations(const ChannelException& e) {
+    while (!writeOperations_.empty()) {
+        ChannelFuturePtr future;
+        future.swap(writeOperations_.front().future);
+        writeOperations_.pop_front();
+
+        if (future) {
+            future->setFailure(e);
+        }
+    }
+
+    writeBufferSize_ = 0;
+}
+
+void UringSocketChannel::operationStarted() {
+    if (pendingOperations_++ == 0) {
+        self_ = shared_from_this();
+    }
+}
+
+void UringSocketChannel::operationCompleted() {
+    if (--pendingOperations_ == 0) {
+        // released after the completion returned.
+        loop_->post(boost::bind(&releaseChannel, self_));
+        self_.reset();
+    }
+}
+
+}
+}
+}
@@ -357,16 +357,17 @@ ChannelBufferPtr LengthFieldBasedFrameDecoder::decode(ChannelHandlerContext& ctx
     // extract frame
     int readerIndex = in->readerIndex();
     int actualFrameLength = frameLength - initialBytesToStrip_ - checksumFieldLength_;
-    ChannelBufferPtr frame = extractFrame(in, readerIndex, actualFrameLength);
+    ChannelBufferPtr frame = extractFrame(ctx, in, readerIndex, actualFrameLength);
     in->readerIndex(readerIndex + actualFrameLength + checksumFieldLength_);
     return frame;
 }
 
 ChannelBufferPtr
-LengthFieldBasedFrameDecoder::extractFrame(const ChannelBufferPtr& buffer,
+LengthFieldBasedFrameDecoder::extractFrame(ChannelHandlerContext& ctx,
+        const ChannelBufferPtr& buffer,
         int index,
         int length) {
-    ChannelBufferPtr frame = Unpooled::buffer(length);
+    ChannelBufferPtr frame = ctx.newBuffer(length);
     frame->writeBytes(buffer, index, length);
     return frame;
 }
@@ -174,7 +174,7 @@ ChannelBufferPtr LengthFieldPrepender::encode(ChannelHandlerContext& ctx,
             return msg;
         }
         else {
-            ChannelBufferPtr buffer = Unpooled::buffer(msgLength);
+            ChannelBufferPtr buffer = ctx.newBuffer(msgLength);
             return writeMessage(buffer, msg, contentLength, headerPos, cs);
         }
     }
@@ -120,7 +120,7 @@ int ReplayingDecoderBuffer::indexOf(int fromIndex, int toIndex, int8_t value) co
 
 int ReplayingDecoderBuffer::readableBytes() const {
     if (terminated) {
-        return ChannelBuffer::readableBytes();
+        return buffer->readableBytes();
     }
     else {
         return MAX_INT32 - readerIndex();
@@ -30,7 +30,8 @@ using namespace cetty::util;
 
 HttpChunkPtr HttpChunk::LAST_CHUNK(new HttpChunk(Unpooled::EMPTY_BUFFER));
 
-HttpChunk::HttpChunk(const ChannelBufferPtr& content) {
+HttpChunk::HttpChunk(const ChannelBufferPtr& content)
+    : followLastChunk(false) {
     if (content) {
         setContent(content);
     }
@@ -61,11 +62,11 @@ void HttpChunk::setContent(const ChannelBufferPtr& content) {
 }
 
 bool HttpChunk::followingLastChunk() const {
-    return true;
+    return followLastChunk;
 }
 
 void HttpChunk::setFollowLastChunk(bool followLast) {
-
+    followLastChunk = followLast;
 }
 
 }
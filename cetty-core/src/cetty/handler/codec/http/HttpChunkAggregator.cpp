@@ -16,17 +16,22 @@
 
 #include <cetty/handler/codec/http/HttpChunkAggregator.h>
 
-#include <cetty/buffer/Unpooled.h>
+#include <algorithm>
+#include <boost/bind.hpp>
 
-#include <cetty/channel/Channel.h>
-#include <cetty/channel/ChannelConfig.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelFuture.h>
+#include <cetty/channel/ChannelFutureListener.h>
 #include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageTransfer.h>
+#include <cetty/logging/LoggerHelper.h>
 #include <cetty/util/Exception.h>
 #include <cetty/util/StringUtil.h>
 
 #include <cetty/handler/codec/TooLongFrameException.h>
 #include <cetty/handler/codec/http/HttpRequest.h>
 #include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/handler/codec/http/HttpResponseStatus.h>
 #include <cetty/handler/codec/http/HttpChunk.h>
 #include <cetty/handler/codec/http/HttpChunkTrailer.h>
 #include <cetty/handler/codec/http/HttpHeaders.h>
@@ -41,142 +46,249 @@ using namespace cetty::buffer;
 using namespace cetty::util;
 using namespace cetty::handler::codec;
 
+// the small chunks are packed into buffers of at least this size.
+static const int MIN_COMPONENT_SIZE = 8192;
+
 HttpChunkAggregator::HttpChunkAggregator(int maxContentLength)
-    : maxContentLength_(maxContentLength) {
+    : maxContentLength_(maxContentLength),
+      maxCumulationBufferComponents_(DEFAULT_MAX_CUMULATION_BUFFER_COMPONENTS),
+      contentLength_(0),
+      discarding_(false) {
     if (maxContentLength <= 0) {
         throw InvalidArgumentException(
-            "maxContentLength must be a positive integer: " +
-            maxContentLength);
+            StringUtil::printf("maxContentLength must be a positive integer: %d",
+                               maxContentLength));
+    }
+
+    decoder_.setDecoder(boost::bind(&HttpChunkAggregator::decode,
+                                    this,
+                                    _1,
+                                    _2));
+}
+
+void HttpChunkAggregator::setMaxCumulationBufferComponents(
+    int maxCumulationBufferComponents) {
+    if (maxCumulationBufferComponents < 2) {
+        throw InvalidArgumentException(
+            StringUtil::printf("maxCumulationBufferComponents: %d (expected: >= 2)",
+                               maxCumulationBufferComponents));
     }
+
+    maxCumulationBufferComponents_ = maxCumulationBufferComponents;
 }
 
 HttpPackage HttpChunkAggregator::decode(ChannelHandlerContext& ctx,
                                         const HttpPackage& msg) {
-#if 0
     if (msg.isHttpRequest() || msg.isHttpResponse()) {
+        return decodeMessage(ctx, msg);
+    }
+    else if (msg.isHttpChunk()) {
+        return decodeChunk(ctx, msg.httpChunk());
+    }
+    else if (msg.isHttpChunkTrailer()) {
+        if (discarding_) {
+            discarding_ = false;
+            return HttpPackage();
+        }
 
-        // Handle the 'Expect: 100-continue' header if necessary.
-        // TODO: Respond with 413 Request Entity Too Large
-        //   and discard the traffic or close the connection.
-        //       No need to notify the upstream handlers - just log.
-        //       If decoding a response, just throw an exception.
-        if (HttpHeaders::is100ContinueExpected(*value)) {
-            //Channels::write(ctx, Channels::succeededFuture(ctx.getChannel()), CONTINUE.duplicate());
+        if (!currentMessage_) {
+            return msg;
         }
 
-        HttpTransferEncoding te = value->getTransferEncoding();
+        // merge the trailing headers, the decoder has dropped the
+        // Content-Length, Transfer-Encoding and Trailer.
+        const HttpHeaders& trailers = msg.httpChunkTrailer()->headers();
+        HttpHeaders* headers = currentMessage_.headers();
 
-        if (te == HttpTransferEncoding::SINGLE) {
-            currentMessage.reset();
-            return value;
-        }
-        else if (te == HttpTransferEncoding::STREAMED
-                 || te == HttpTransferEncoding::CHUNKED) {
-            // initialize the cumulative buffer, and wait for incoming chunks.
-            value->setTransferEncoding(HttpTransferEncoding::SINGLE);
-            value->setContent(Unpooled::buffer());
-
-            currentMessage.reset();
-            currentMessage = value;
-            return HttpMessagePtr();
-        }
-        else {
-            // Error.
-            return HttpMessagePtr();
+        HttpHeaders::ConstHeaderIterator itr = trailers.firstHeader();
+        HttpHeaders::ConstHeaderIterator end = trailers.lastHeader();
+
+        for (; itr != end; ++itr) {
+            headers->setHeader(itr.name(), itr.value());
         }
+
+        return finishAggregation();
     }
-    else if (msg.isHttpChunk()) {
-        HttpMessagePtr& currentMessage = aggregator.currentMessage_;
 
-        // Sanity check
-        if (!currentMessage) {
-            throw IllegalStateException("received HttpChunk  without HttpMessage");
-        }
+    return msg;
+}
 
-        // Merge the received chunk into the content of the current message.
-        ChannelBufferPtr content = currentMessage->getContent();
+HttpPackage HttpChunkAggregator::decodeMessage(ChannelHandlerContext& ctx,
+        const HttpPackage& msg) {
+    if (currentMessage_) {
+        LOG_WARN << "a new message comes before the last chunk, "
+                 "drop the content aggregated.";
+        reset();
+    }
 
-        if (content->readableBytes() > aggregator.maxContentLength_ - value->getContent()->readableBytes()) {
-            // TODO: Respond with 413 Request Entity Too Large
-            //   and discard the traffic or close the connection.
-            //       No need to notify the upstream handlers - just log.
-            //       If decoding a response, just throw an exception.
-            std::string msg;
-            StringUtil::printf(&msg,
-                               "HTTP content length exceeded %d bytes.",
-                               aggregator.maxContentLength_);
+    discarding_ = false;
 
-            LOG_ERROR << msg;
+    // the content is complete already.
+    if (!msg.transferEncoding().multiple()) {
+        return msg;
+    }
 
-            throw TooLongFrameException(msg);
-        }
+    HttpPackage message = msg;
+
+    int contentLength = message.contentLength(-1);
+
+    if (contentLength > maxContentLength_) {
+        discarding_ = true;
+        contentTooLong(ctx, message.isHttpRequest());
+        return HttpPackage();
+    }
 
-        // Append the content of the chunk
-        aggregator.appendToCumulation(value->getContent());
+    // the client waits for the go-ahead before sending the content, answer it
+    // here, so the handlers after will not see the expectation.
+    if (message.isHttpRequest() && message.is100ContinueExpected()) {
+        writeResponse(ctx, HttpResponseStatus::CONTINUE, false);
+        message.headers()->removeHeader(HttpHeaders::HEADER_EXPECT);
+    }
 
-        if (value->isLast()) {
-            currentMessage.reset();
+    message.setTransferEncoding(HttpTransferEncoding::SINGLE);
+    currentMessage_ = message;
 
-            // Set the 'Content-Length' header.
-            currentMessage->setHeader(
-                HttpHeaders::Names::CONTENT_LENGTH,
-                StringUtil::numtostr(content->readableBytes()));
+    return HttpPackage();
+}
 
-            // All done - generate the event.
-            return currentMessage;
-        }
-        else {
-            return HttpMessagePtr();
-        }
+HttpPackage HttpChunkAggregator::decodeChunk(ChannelHandlerContext& ctx,
+        const HttpChunkPtr& chunk) {
+    bool last = chunk->isLast() || chunk->followingLastChunk();
+
+    if (discarding_) {
+        discarding_ = !last;
+        return HttpPackage();
     }
-    else if (msg.isHttpChunkTrailer()) {
-        HttpMessagePtr& currentMessage = aggregator.currentMessage_;
 
-        HttpChunkTrailer::ConstHeaderIterator itr = value->getFirstHeader();
-        HttpChunkTrailer::ConstHeaderIterator end = value->getLastHeader();
+    if (!currentMessage_) {
+        return HttpPackage(chunk);
+    }
 
-        for (; itr != end; ++itr) {
-            currentMessage->setHeader(itr->first, itr->second);
-        }
+    const ChannelBufferPtr& content = chunk->getContent();
+    int length = content ? content->readableBytes() : 0;
+
+    if (length > maxContentLength_ - contentLength_) {
+        bool isRequest = currentMessage_.isHttpRequest();
 
-        // Set the 'Content-Length' header.
-        currentMessage->setHeader(
-            HttpHeaders::Names::CONTENT_LENGTH,
-            StringUtil::numtostr(currentMessage->getContent()->readableBytes()));
+        reset();
+        discarding_ = !last;
 
-        return currentMessage;
+        contentTooLong(ctx, isRequest);
+        return HttpPackage();
     }
-#endif
-    return msg;
+
+    appendToCumulation(content);
+
+    if (last) {
+        return finishAggregation();
+    }
+
+    return HttpPackage();
+}
+
+void HttpChunkAggregator::contentTooLong(ChannelHandlerContext& ctx,
+        bool isRequest) {
+    std::string msg = StringUtil::printf("HTTP content length exceeded %d bytes.",
+                                         maxContentLength_);
+
+    // no one to answer for a response, just raise it.
+    if (!isRequest) {
+        throw TooLongFrameException(msg);
+    }
+
+    LOG_WARN << msg << " respond with 413 and close the connection.";
+    writeResponse(ctx, HttpResponseStatus::REQUEST_ENTITY_TOO_LARGE, true);
 }
 
 void HttpChunkAggregator::appendToCumulation(const ChannelBufferPtr& input) {
-#if 0
-    const ChannelBufferPtr& cumulation = currentMessage_->getContent();
+    int length = input ? input->readableBytes() : 0;
 
+    if (!length) {
+        return;
+    }
 
-    if (cumulation instanceof CompositeByteBuf) {
-        // Make sure the resulting cumulation buffer has no more than 4 components.
-        CompositeByteBuf composite = (CompositeByteBuf) cumulation;
+    contentLength_ += length;
 
-        if (composite.numComponents() >= maxCumulationBufferComponents) {
-            currentMessage.setContent(Unpooled.wrappedBuffer(composite.copy(), input));
-        }
-        else {
-            List<ByteBuf> decomposed = composite.decompose(0, composite.readableBytes());
-            ByteBuf[] buffers = decomposed.toArray(new ByteBuf[decomposed.size() + 1]);
-            buffers[buffers.length - 1] = input;
+    // the input slices the read buffer of the channel, which is reused after
+    // this chunk, so copy the payload into the spare room of the last buffer.
+    if (!components_.empty() && components_.back()->writableBytes() >= length) {
+        components_.back()->writeBytes(input, input->readerIndex(), length);
+        return;
+    }
 
-            currentMessage.setContent(Unpooled.wrappedBuffer(buffers));
+    if (static_cast<int>(components_.size()) >= maxCumulationBufferComponents_) {
+        ChannelBufferPtr merged = Unpooled::buffer(contentLength_);
+
+        for (size_t i = 0; i < components_.size(); ++i) {
+            const ChannelBufferPtr& component = components_[i];
+            merged->writeBytes(component,
+                               component->readerIndex(),
+                               component->readableBytes());
         }
+
+        merged->writeBytes(input, input->readerIndex(), length);
+
+        components_.clear();
+        components_.push_back(merged);
+        return;
+    }
+
+    ChannelBufferPtr component =
+        Unpooled::buffer(std::max(length, MIN_COMPONENT_SIZE));
+
+    component->writeBytes(input, input->readerIndex(), length);
+    components_.push_back(component);
+}
+
+HttpPackage HttpChunkAggregator::finishAggregation() {
+    HttpPackage message = currentMessage_;
+
+    if (components_.size() == 1) {
+        message.setContent(components_.front());
     }
     else {
-        currentMessage.setContent(Unpooled.wrappedBuffer(cumulation, input));
+        // the composite only slices the written bytes of each buffer.
+        message.setContent(Unpooled::wrappedBuffer(components_));
+    }
+
+    message.headers()->setContentLength(contentLength_);
+
+    reset();
+    return message;
+}
+
+void HttpChunkAggregator::reset() {
+    currentMessage_ = HttpPackage();
+    components_.clear();
+    contentLength_ = 0;
+}
+
+void HttpChunkAggregator::writeResponse(ChannelHandlerContext& ctx,
+                                        const HttpResponseStatus& status,
+                                        bool close) {
+    HttpResponsePtr response(new HttpResponse(HttpVersion::HTTP_1_1, status));
+
+    if (close) {
+        response->headers().setContentLength(0);
+        response->setKeepAlive(false);
     }
 
+    ChannelMessageTransfer<HttpPackage,
+                           ChannelMessageContainer<HttpPackage, MESSAGE_BLOCK>,
+                           TRANSFER_OUTBOUND> transfer(ctx);
+
+    ChannelFuturePtr future = ctx.newFuture();
 
-    currentMessage_->setContent(Unpooled::wrappedBuffer(cumulation, input));
-#endif
+    if (close) {
+        future->addListener(ChannelFutureListener::CLOSE);
+    }
+
+    if (transfer.unfoldAndAdd(HttpPackage(response))) {
+        ctx.flush(future);
+    }
+    else if (close) {
+        ctx.close();
+    }
 }
 
 }
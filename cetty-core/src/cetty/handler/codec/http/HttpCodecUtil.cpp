@@ -121,23 +121,34 @@ bool HttpCodecUtil::validateHeaderValue(const std::string& value) {
     return true;
 }
 
-// bool HttpCodecUtil::isTransferEncodingChunked(const HttpMessage& m) {
-//     std::vector<std::string> chunked;
-//     m.getHeaders(HttpHeaders::Names::TRANSFER_ENCODING, &chunked);
-// 
-//     if (chunked.empty()) {
-//         return false;
-//     }
-// 
-//     for (size_t i = 0; i < chunked.size(); ++i) {
-//         if (boost::algorithm::iequals(HttpHeaders::Values::CHUNKED, chunked[i])) {
-//             return true;
-//         }
-//     }
-// 
-//     return false;
-// }
-// 
+bool HttpCodecUtil::isTransferEncodingChunked(const HttpHeaders& headers) {
+    StringPiece chunked(HttpHeaders::Values::CHUNKED);
+    HttpHeaders::ConstHeaderIterator itr = headers.firstHeader();
+    HttpHeaders::ConstHeaderIterator end = headers.lastHeader();
+
+    for (; itr != end; ++itr) {
+        if (itr.id() != HttpHeaders::HEADER_TRANSFER_ENCODING) {
+            continue;
+        }
+
+        // the codings are separated by comma, e.g. "gzip, chunked".
+        StringPiece value = itr.value();
+        int start = 0;
+
+        for (int i = 0; i <= value.size(); ++i) {
+            if (i == value.size() || value[i] == COMMA) {
+                if (value.substr(start, i - start).trim().iequals(chunked)) {
+                    return true;
+                }
+
+                start = i + 1;
+            }
+        }
+    }
+
+    return false;
+}
+
 // bool HttpCodecUtil::isContentLengthSet(const HttpMessage& m) {
 //     return m.hasHeader(HttpHeaders::Names::CONTENT_LENGTH);
 // }
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/handler/codec/http/HttpCompressedContentCache.h>
+
+#include <boost/thread/once.hpp>
+#include <cetty/util/Exception.h>
+#include <cetty/util/StringUtil.h>
+#include <cetty/util/SecureRandom.h>
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+using namespace cetty::util;
+
+static uint64_t digestKey[2];
+static boost::once_flag digestKeyFlag = BOOST_ONCE_INIT;
+
+static void initDigestKey() {
+    SecureRandom random;
+    digestKey[0] = static_cast<uint64_t>(random.nextInt64());
+    digestKey[1] = static_cast<uint64_t>(random.nextInt64());
+}
+
+static inline uint64_t rotl(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+// little endian, whatever the byte order of the host is.
+static inline uint64_t load64(const unsigned char* p, int length) {
+    uint64_t word = 0;
+
+    for (int i = 0; i < length; ++i) {
+        word |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+
+    return word;
+}
+
+static inline void sipRounds(uint64_t v[4], int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        v[0] += v[1]; v[1] = rotl(v[1], 13); v[1] ^= v[0]; v[0] = rotl(v[0], 32);
+        v[2] += v[3]; v[3] = rotl(v[3], 16); v[3] ^= v[2];
+        v[0] += v[3]; v[3] = rotl(v[3], 21); v[3] ^= v[0];
+        v[2] += v[1]; v[1] = rotl(v[1], 17); v[1] ^= v[2]; v[2] = rotl(v[2], 32);
+    }
+}
+
+HttpCompressedContentCache::HttpCompressedContentCache(int capacity)
+    : capacity_(capacity),
+      size_(0),
+      hits_(0),
+      misses_(0) {
+    if (capacity <= 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("capacity must be a positive integer: %d", capacity));
+    }
+}
+
+HttpCompressedContentCache::ContentPtr HttpCompressedContentCache::get(
+    const std::string& key,
+    const Digest& digest) {
+    boost::mutex::scoped_lock lock(mutex_);
+    EntryMap::iterator itr = index_.find(key);
+
+    if (itr == index_.end() || itr->second->digest != digest) {
+        ++misses_;
+        return ContentPtr();
+    }
+
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, itr->second);
+    return itr->second->content;
+}
+
+void HttpCompressedContentCache::put(const std::string& key,
+                                     const Digest& digest,
+                                     const ContentPtr& content) {
+    if (!content || static_cast<int>(content->size()) > capacity_ / 4) {
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    EntryMap::iterator itr = index_.find(key);
+
+    if (itr != index_.end()) {
+        Entry& entry = *itr->second;
+        entries_.splice(entries_.begin(), entries_, itr->second);
+
+        // another channel has compressed the same body meanwhile.
+        if (entry.digest == digest) {
+            return;
+        }
+
+        // the body of the key has changed.
+        size_ += static_cast<int>(content->size())
+                 - static_cast<int>(entry.content->size());
+        entry.digest = digest;
+        entry.content = content;
+    }
+    else {
+        entries_.push_front(Entry(key, digest, content));
+        index_.insert(std::make_pair(key, entries_.begin()));
+        size_ += static_cast<int>(content->size());
+    }
+
+    evict();
+}
+
+void HttpCompressedContentCache::clear() {
+    boost::mutex::scoped_lock lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    size_ = 0;
+}
+
+int HttpCompressedContentCache::count() const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return static_cast<int>(index_.size());
+}
+
+int HttpCompressedContentCache::size() const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return size_;
+}
+
+int64_t HttpCompressedContentCache::hits() const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return hits_;
+}
+
+int64_t HttpCompressedContentCache::misses() const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return misses_;
+}
+
+void HttpCompressedContentCache::evict() {
+    while (size_ > capacity_ && !entries_.empty()) {
+        const Entry& entry = entries_.back();
+
+        size_ -= static_cast<int>(entry.content->size());
+        index_.erase(entry.key);
+        entries_.pop_back();
+    }
+}
+
+HttpCompressedContentCache::Digest HttpCompressedContentCache::digest(
+    const char* bytes,
+    int length) {
+    boost::call_once(&initDigestKey, digestKeyFlag);
+
+    uint64_t v[4] = {
+        CETTY_ULONGLONG(0x736F6D6570736575) ^ digestKey[0],
+        CETTY_ULONGLONG(0x646F72616E646F6D) ^ digestKey[1] ^ 0xEE,
+        CETTY_ULONGLONG(0x6C7967656E657261) ^ digestKey[0],
+        CETTY_ULONGLONG(0x7465646279746573) ^ digestKey[1]
+    };
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes);
+    const unsigned char* end = p + (length & ~7);
+
+    for (; p != end; p += 8) {
+        uint64_t m = load64(p, 8);
+        v[3] ^= m;
+        sipRounds(v, 2);
+        v[0] ^= m;
+    }
+
+    // the tail bytes with the length in the highest byte.
+    uint64_t m = load64(p, length & 7) | (static_cast<uint64_t>(length) << 56);
+    v[3] ^= m;
+    sipRounds(v, 2);
+    v[0] ^= m;
+
+    Digest digest;
+
+    v[2] ^= 0xEE;
+    sipRounds(v, 4);
+    digest.first = v[0] ^ v[1] ^ v[2] ^ v[3];
+
+    v[1] ^= 0xDD;
+    sipRounds(v, 4);
+    digest.second = v[0] ^ v[1] ^ v[2] ^ v[3];
+
+    return digest;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/handler/codec/http/HttpContentCompressor.h>
+
+#include <stdlib.h>
+#include <zlib.h>
+#include <boost/bind.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageTransfer.h>
+#include <cetty/logging/LoggerHelper.h>
+#include <cetty/util/Exception.h>
+#include <cetty/util/StringUtil.h>
+
+#include <cetty/handler/codec/EncoderException.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/handler/codec/http/HttpChunk.h>
+#include <cetty/handler/codec/http/HttpChunkTrailer.h>
+#include <cetty/handler/codec/http/HttpHeaders.h>
+#include <cetty/handler/codec/http/HttpVersion.h>
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+using namespace cetty::channel;
+using namespace cetty::buffer;
+using namespace cetty::util;
+
+// room for the encoder to prepend the response headers without a copy.
+static const int HEADER_AHEAD_BYTES = 512;
+
+// room for the chunk size line before and the CRLF after the chunk.
+static const int CHUNK_AHEAD_BYTES = 16;
+static const int CHUNK_TRAILING_BYTES = 2;
+
+// the upper bound of the deflated bytes, leaving <tt>reservedBytes</tt>
+// more in an int.
+static int compressedBound(z_stream* stream, int length, int reservedBytes) {
+    uLong bound = deflateBound(stream, static_cast<uLong>(length));
+
+    if (bound > static_cast<uLong>(MAX_INT32 - reservedBytes)) {
+        throw EncoderException(
+            StringUtil::printf("content of %d bytes is too large to compress.", length));
+    }
+
+    return static_cast<int>(bound);
+}
+
+static const int GZIP_WINDOW_BITS = 16 + MAX_WBITS;
+static const int DEFAULT_MEM_LEVEL = 8;
+
+static const char* DEFAULT_CONTENT_TYPES[] = {
+    "text/",
+    "application/json",
+    "application/javascript",
+    "application/x-javascript",
+    "application/xml",
+    "image/svg+xml"
+};
+
+HttpContentCompressor::HttpContentCompressor()
+    : compressionLevel_(DEFAULT_COMPRESSION_LEVEL),
+      minContentLength_(DEFAULT_MIN_CONTENT_LENGTH),
+      stream_(NULL),
+      streamWrapper_(NONE),
+      streaming_(false) {
+    init();
+}
+
+HttpContentCompressor::HttpContentCompressor(int compressionLevel)
+    : compressionLevel_(compressionLevel),
+      minContentLength_(DEFAULT_MIN_CONTENT_LENGTH),
+      stream_(NULL),
+      streamWrapper_(NONE),
+      streaming_(false) {
+    if (compressionLevel < 0 || compressionLevel > 9) {
+        throw InvalidArgumentException(
+            StringUtil::printf("compressionLevel: %d (expected: 0-9)",
+                               compressionLevel));
+    }
+
+    init();
+}
+
+HttpContentCompressor::~HttpContentCompressor() {
+    if (stream_) {
+        deflateEnd(stream_);
+        delete stream_;
+    }
+}
+
+void HttpContentCompressor::init() {
+    int count = sizeof(DEFAULT_CONTENT_TYPES) / sizeof(DEFAULT_CONTENT_TYPES[0]);
+    contentTypes_.assign(DEFAULT_CONTENT_TYPES, DEFAULT_CONTENT_TYPES + count);
+
+    codec_.setDecoder(boost::bind(&HttpContentCompressor::decode,
+                                  this,
+                                  _1,
+                                  _2));
+
+    codec_.setEncoder(boost::bind(&HttpContentCompressor::encode,
+                                  this,
+                                  _1,
+                                  _2));
+}
+
+void HttpContentCompressor::setMinContentLength(int minContentLength) {
+    if (minContentLength < 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("minContentLength: %d (expected: >= 0)",
+                               minContentLength));
+    }
+
+    minContentLength_ = minContentLength;
+}
+
+bool HttpContentCompressor::isCompressible(const StringPiece& contentType) const {
+    StringPiece mediaType = contentType;
+
+    for (int i = 0; i < mediaType.size(); ++i) {
+        if (mediaType[i] == ';') {
+            mediaType = mediaType.substr(0, i);
+            break;
+        }
+    }
+
+    mediaType = mediaType.trim();
+
+    if (mediaType.empty()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < contentTypes_.size(); ++i) {
+        StringPiece type = contentTypes_[i];
+
+        if (!type.empty() && type[type.size() - 1] == '/') {
+            if (mediaType.size() > type.size()
+                    && mediaType.substr(0, type.size()).iequals(type)) {
+                return true;
+            }
+        }
+        else if (mediaType.iequals(type)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+HttpContentCompressor::ZlibWrapper HttpContentCompressor::determineWrapper(
+    const StringPiece& acceptEncoding) {
+    float starQ = -1.0f;
+    float gzipQ = -1.0f;
+    float deflateQ = -1.0f;
+
+    std::vector<std::string> encodings;
+    StringUtil::split(acceptEncoding.as_string(), ',', &encodings);
+
+    for (size_t i = 0; i < encodings.size(); ++i) {
+        const std::string& encoding = encodings[i];
+        float q = 1.0f;
+        std::string::size_type equalsPos = encoding.find('=');
+
+        if (equalsPos != std::string::npos) {
+            const char* value = encoding.c_str() + equalsPos + 1;
+            char* end = NULL;
+
+            q = static_cast<float>(strtod(value, &end));
+
+            // not a number, ignore the encoding.
+            if (end == value) {
+                q = 0.0f;
+            }
+        }
+
+        if (encoding.find('*') != std::string::npos) {
+            starQ = q;
+        }
+        else if (encoding.find("gzip") != std::string::npos && q > gzipQ) {
+            gzipQ = q;
+        }
+        else if (encoding.find("deflate") != std::string::npos && q > deflateQ) {
+            deflateQ = q;
+        }
+    }
+
+    if (gzipQ > 0.0f || deflateQ > 0.0f) {
+        return gzipQ >= deflateQ ? GZIP : ZLIB;
+    }
+
+    if (starQ > 0.0f) {
+        if (gzipQ == -1.0f) {
+            return GZIP;
+        }
+
+        if (deflateQ == -1.0f) {
+            return ZLIB;
+        }
+    }
+
+    return NONE;
+}
+
+HttpPackage HttpContentCompressor::decode(ChannelHandlerContext& ctx,
+        const HttpPackage& msg) {
+    if (msg && msg.isHttpRequest()) {
+        const HttpRequestPtr& request = msg.httpRequest();
+        const HttpHeaders& headers = request->headers();
+
+        requests_.push_back(Request(
+                                determineWrapper(headers.headerValue(HttpHeaders::HEADER_ACCEPT_ENCODING)),
+                                request->method() == HttpMethod::HEAD,
+                                request->version() == HttpVersion::HTTP_1_0));
+
+        if (cache_) {
+            requests_.back().uri = request->getUriString();
+        }
+    }
+
+    return msg;
+}
+
+HttpPackage HttpContentCompressor::encode(ChannelHandlerContext& ctx,
+        const HttpPackage& msg) {
+    if (!msg) {
+        return msg;
+    }
+
+    if (msg.isHttpResponse()) {
+        return encodeResponse(ctx, msg);
+    }
+
+    if (!streaming_) {
+        return msg;
+    }
+
+    if (msg.isHttpChunk()) {
+        return encodeChunk(ctx, msg);
+    }
+
+    if (msg.isHttpChunkTrailer()) {
+        finishStream(ctx);
+    }
+
+    return msg;
+}
+
+HttpPackage HttpContentCompressor::encodeResponse(ChannelHandlerContext& ctx,
+        const HttpPackage& msg) {
+    HttpResponsePtr response = msg.httpResponse();
+
+    // the interim response, the final one will follow for the same request.
+    if (response->status().code() == 100) {
+        return msg;
+    }
+
+    if (streaming_) {
+        LOG_WARN << "a new response comes before the last chunk, "
+                 "finish the content compressed.";
+        finishStream(ctx);
+    }
+
+    if (requests_.empty()) {
+        LOG_WARN << "more responses than requests, send it uncompressed.";
+        return msg;
+    }
+
+    Request request = requests_.front();
+    requests_.pop_front();
+
+    if (!isEncodable(request, msg)) {
+        return msg;
+    }
+
+    HttpHeaders& headers = response->headers();
+
+    // the caches between should keep both variants.
+    if (!headers.hasHeader(HttpHeaders::HEADER_VARY)) {
+        headers.setHeader(HttpHeaders::HEADER_VARY,
+                          HttpHeaders::Names::ACCEPT_ENCODING);
+    }
+
+    if (request.wrapper == NONE) {
+        return msg;
+    }
+
+    const std::string& contentEncoding = request.wrapper == GZIP
+                                         ? HttpHeaders::Values::GZIP
+                                         : HttpHeaders::Values::DEFLATE;
+
+    if (response->transferEncoding().single()) {
+        ChannelBufferPtr compressed = compress(request, response);
+
+        // not worth it, such as the content is compressed already.
+        if (compressed->readableBytes() >= response->content()->readableBytes()) {
+            return msg;
+        }
+
+        response->setContent(compressed);
+        headers.setContentLength(compressed->readableBytes());
+    }
+    else {
+        beginStream(request.wrapper);
+        streaming_ = true;
+
+        // the length of the compressed content is unknown.
+        response->setTransferEncoding(HttpTransferEncoding::CHUNKED);
+    }
+
+    headers.setHeader(HttpHeaders::HEADER_CONTENT_ENCODING, contentEncoding);
+    return msg;
+}
+
+HttpPackage HttpContentCompressor::encodeChunk(ChannelHandlerContext& ctx,
+        const HttpPackage& msg) {
+    HttpChunkPtr chunk = msg.httpChunk();
+
+    if (chunk->isLast()) {
+        finishStream(ctx);
+        return msg;
+    }
+
+    const ChannelBufferPtr& content = chunk->getContent();
+    int length = content->readableBytes();
+
+    int bound = compressedBound(stream_,
+                                length,
+                                CHUNK_AHEAD_BYTES + CHUNK_TRAILING_BYTES);
+
+    ChannelBufferPtr out = Unpooled::buffer(bound + CHUNK_TRAILING_BYTES,
+                                            CHUNK_AHEAD_BYTES);
+
+    StringPiece bytes;
+    content->readableBytes(&bytes);
+
+    stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(bytes.data()));
+    stream_->avail_in = static_cast<uInt>(bytes.size());
+
+    // flushed, so the client gets the whole chunk now.
+    deflate(out, Z_SYNC_FLUSH);
+
+    chunk->setContent(out);
+    return msg;
+}
+
+bool HttpContentCompressor::isEncodable(const Request& request,
+                                        const HttpPackage& msg) const {
+    const HttpResponsePtr& response = msg.httpResponse();
+    const HttpHeaders& headers = response->headers();
+    int code = response->status().code();
+
+    if (request.head || code < 200 || code == 204 || code == 304) {
+        return false;
+    }
+
+    StringPiece contentEncoding =
+        headers.headerValue(HttpHeaders::HEADER_CONTENT_ENCODING);
+
+    if (!contentEncoding.empty()
+            && !contentEncoding.iequals(HttpHeaders::Values::IDENTITY)) {
+        return false;
+    }
+
+    std::string cacheControl =
+        headers.headerValue(HttpHeaders::HEADER_CACHE_CONTROL).as_string();
+
+    if (cacheControl.find(HttpHeaders::Values::NO_TRANSFORM) != std::string::npos) {
+        return false;
+    }
+
+    if (!isCompressible(headers.headerValue(HttpHeaders::HEADER_CONTENT_TYPE))) {
+        return false;
+    }
+
+    if (response->transferEncoding().single()) {
+        const ChannelBufferPtr& content = response->content();
+        return content && content->readableBytes() >= minContentLength_;
+    }
+
+    // the compressed chunks need the chunked transfer encoding, which a
+    // HTTP/1.0 client does not know, even if answered in HTTP/1.1.
+    if (request.http10) {
+        return false;
+    }
+
+    // unknown till the last chunk.
+    int contentLength = headers.contentLength();
+    return contentLength < 0 || contentLength >= minContentLength_;
+}
+
+ChannelBufferPtr HttpContentCompressor::compress(const Request& request,
+        const HttpResponsePtr& response) {
+    StringPiece bytes;
+    response->content()->readableBytes(&bytes);
+
+    if (!cache_) {
+        beginStream(request.wrapper);
+        return compress(bytes);
+    }
+
+    // the strong ETag identifies the content of the URI, so the body is not
+    // hashed, the weak one does not, then the body is keyed by its digest.
+    HttpCompressedContentCache::Digest digest;
+    std::string key(request.wrapper == GZIP ? "gzip " : "deflate ");
+    StringPiece etag = response->headers().headerValue(HttpHeaders::HEADER_ETAG);
+
+    if (!etag.empty() && !etag.starts_with("W/")) {
+        key += request.uri;
+        key += ' ';
+        etag.append_to(&key);
+    }
+    else {
+        digest = HttpCompressedContentCache::digest(bytes.data(), bytes.size());
+        key += StringUtil::hextostr(digest.first);
+    }
+
+    key += ' ';
+    key += StringUtil::numtostr(bytes.size());
+
+    HttpCompressedContentCache::ContentPtr cached = cache_->get(key, digest);
+
+    if (cached) {
+        int size = static_cast<int>(cached->size());
+        ChannelBufferPtr compressed = Unpooled::buffer(size, HEADER_AHEAD_BYTES);
+        compressed->writeBytes(*cached);
+        return compressed;
+    }
+
+    beginStream(request.wrapper);
+    ChannelBufferPtr compressed = compress(bytes);
+
+    StringPiece compressedBytes;
+    compressed->readableBytes(&compressedBytes);
+    cache_->put(key, digest, HttpCompressedContentCache::ContentPtr(
+                    new std::string(compressedBytes.data(), compressedBytes.size())));
+
+    return compressed;
+}
+
+ChannelBufferPtr HttpContentCompressor::compress(const StringPiece& bytes) {
+    int bound = compressedBound(stream_,
+                                static_cast<int>(bytes.size()),
+                                HEADER_AHEAD_BYTES);
+
+    ChannelBufferPtr out = Unpooled::buffer(bound, HEADER_AHEAD_BYTES);
+
+    stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(bytes.data()));
+    stream_->avail_in = static_cast<uInt>(bytes.size());
+
+    deflate(out, Z_FINISH);
+    return out;
+}
+
+void HttpContentCompressor::beginStream(ZlibWrapper wrapper) {
+    if (stream_ && streamWrapper_ == wrapper) {
+        deflateReset(stream_);
+        return;
+    }
+
+    if (stream_) {
+        deflateEnd(stream_);
+    }
+    else {
+        stream_ = new z_stream;
+    }
+
+    stream_->zalloc = Z_NULL;
+    stream_->zfree = Z_NULL;
+    stream_->opaque = Z_NULL;
+
+    int ret = deflateInit2(stream_,
+                           compressionLevel_,
+                           Z_DEFLATED,
+                           wrapper == GZIP ? GZIP_WINDOW_BITS : MAX_WBITS,
+                           DEFAULT_MEM_LEVEL,
+                           Z_DEFAULT_STRATEGY);
+
+    if (ret != Z_OK) {
+        delete stream_;
+        stream_ = NULL;
+        streamWrapper_ = NONE;
+
+        throw EncoderException(
+            StringUtil::printf("failed to initialize the deflater: %d", ret));
+    }
+
+    streamWrapper_ = wrapper;
+}
+
+void HttpContentCompressor::finishStream(ChannelHandlerContext& ctx) {
+    streaming_ = false;
+
+    // the end of the deflate stream and the gzip trailer, a few bytes.
+    ChannelBufferPtr out = Unpooled::buffer(64, CHUNK_AHEAD_BYTES);
+
+    stream_->next_in = NULL;
+    stream_->avail_in = 0;
+    deflate(out, Z_FINISH);
+
+    ChannelMessageTransfer<HttpPackage,
+                           ChannelMessageContainer<HttpPackage, MESSAGE_BLOCK>,
+                           TRANSFER_OUTBOUND> transfer(ctx);
+
+    // goes before the last chunk or the trailer being encoded.
+    transfer.unfoldAndAdd(HttpPackage(HttpChunkPtr(new HttpChunk(out))));
+}
+
+void HttpContentCompressor::deflate(const ChannelBufferPtr& out, int flush) {
+    for (;;) {
+        // keeps the room for the CRLF after a chunk.
+        out->ensureWritableBytes(CHUNK_TRAILING_BYTES + 1);
+
+        int writable;
+        char* bytes = out->writableBytes(&writable);
+        writable -= CHUNK_TRAILING_BYTES;
+
+        stream_->next_out = reinterpret_cast<Bytef*>(bytes);
+        stream_->avail_out = static_cast<uInt>(writable);
+
+        int ret = ::deflate(stream_, flush);
+        out->offsetWriterIndex(writable - static_cast<int>(stream_->avail_out));
+
+        if (ret == Z_STREAM_ERROR) {
+            throw EncoderException(
+                StringUtil::printf("failed to compress the content: %d", ret));
+        }
+
+        if (flush == Z_FINISH ? ret == Z_STREAM_END : stream_->avail_out != 0) {
+            break;
+        }
+
+        out->ensureWritableBytes(out->readableBytes() + CHUNK_TRAILING_BYTES);
+    }
+}
+
+}
+}
+}
+}
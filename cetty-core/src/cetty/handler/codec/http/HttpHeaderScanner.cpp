@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/handler/codec/http/HttpHeaderScanner.h>
+
+#include <boost/assert.hpp>
+#include <cetty/handler/codec/http/HttpCodecUtil.h>
+
+// the SIMD versions are compiled with the function target attribute, so the
+// library itself does not need to be built for a newer CPU.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) \
+    || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define CETTY_HTTP_HEADER_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+using namespace cetty::util;
+
+// only the optional white space of RFC 2616, SP and HT.
+static inline bool isWhitespace(char c) {
+    return c == HttpCodecUtil::SP || c == HttpCodecUtil::HT;
+}
+
+static const char* findLineEndScalar(const char* begin, const char* end) {
+    for (; begin != end; ++begin) {
+        if (*begin == HttpCodecUtil::CR || *begin == HttpCodecUtil::LF) {
+            break;
+        }
+    }
+
+    return begin;
+}
+
+static const char* findDelimiterScalar(const char* begin, const char* end) {
+    for (; begin != end; ++begin) {
+        char c = *begin;
+
+        if (c == ':' || c == HttpCodecUtil::CR || c == HttpCodecUtil::LF) {
+            break;
+        }
+    }
+
+    return begin;
+}
+
+#if defined(CETTY_HTTP_HEADER_SCANNER_X86)
+
+#define SSE42_FIND_MODE (_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT)
+
+__attribute__((target("sse4.2")))
+static const char* findLineEndSse42(const char* begin, const char* end) {
+    const __m128i chars = _mm_setr_epi8(HttpCodecUtil::CR, HttpCodecUtil::LF,
+                                        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    for (; end - begin >= 16; begin += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        int index = _mm_cmpestri(chars, 2, bytes, 16, SSE42_FIND_MODE);
+
+        if (index != 16) {
+            return begin + index;
+        }
+    }
+
+    return findLineEndScalar(begin, end);
+}
+
+__attribute__((target("sse4.2")))
+static const char* findDelimiterSse42(const char* begin, const char* end) {
+    const __m128i chars = _mm_setr_epi8(':', HttpCodecUtil::CR, HttpCodecUtil::LF,
+                                        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    for (; end - begin >= 16; begin += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        int index = _mm_cmpestri(chars, 3, bytes, 16, SSE42_FIND_MODE);
+
+        if (index != 16) {
+            return begin + index;
+        }
+    }
+
+    return findDelimiterScalar(begin, end);
+}
+
+__attribute__((target("avx2")))
+static const char* findLineEndAvx2(const char* begin, const char* end) {
+    const __m256i cr = _mm256_set1_epi8(HttpCodecUtil::CR);
+    const __m256i lf = _mm256_set1_epi8(HttpCodecUtil::LF);
+
+    for (; end - begin >= 32; begin += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+                                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, cr),
+                                                _mm256_cmpeq_epi8(bytes, lf))));
+
+        if (mask) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findLineEndScalar(begin, end);
+}
+
+__attribute__((target("avx2")))
+static const char* findDelimiterAvx2(const char* begin, const char* end) {
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i cr = _mm256_set1_epi8(HttpCodecUtil::CR);
+    const __m256i lf = _mm256_set1_epi8(HttpCodecUtil::LF);
+
+    for (; end - begin >= 32; begin += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, colon),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(bytes, cr),
+                                                _mm256_cmpeq_epi8(bytes, lf)));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+
+        if (mask) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findDelimiterScalar(begin, end);
+}
+
+#endif
+
+static HttpHeaderScanner::Implementation detectImplementation() {
+#if defined(CETTY_HTTP_HEADER_SCANNER_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return HttpHeaderScanner::AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+        return HttpHeaderScanner::SSE42;
+    }
+#endif
+
+    return HttpHeaderScanner::SCALAR;
+}
+
+HttpHeaderScanner::HttpHeaderScanner() {
+    init(bestImplementation());
+}
+
+HttpHeaderScanner::HttpHeaderScanner(Implementation implementation) {
+    init(implementation);
+}
+
+void HttpHeaderScanner::init(Implementation implementation) {
+    implementation_ = SCALAR;
+    findLineEnd_ = findLineEndScalar;
+    findDelimiter_ = findDelimiterScalar;
+
+    if (!isSupported(implementation)) {
+        return;
+    }
+
+#if defined(CETTY_HTTP_HEADER_SCANNER_X86)
+    if (implementation == AVX2) {
+        implementation_ = AVX2;
+        findLineEnd_ = findLineEndAvx2;
+        findDelimiter_ = findDelimiterAvx2;
+    }
+    else if (implementation == SSE42) {
+        implementation_ = SSE42;
+        findLineEnd_ = findLineEndSse42;
+        findDelimiter_ = findDelimiterSse42;
+    }
+#endif
+}
+
+bool HttpHeaderScanner::isSupported(Implementation implementation) {
+    if (implementation == SCALAR) {
+        return true;
+    }
+
+#if defined(CETTY_HTTP_HEADER_SCANNER_X86)
+    __builtin_cpu_init();
+
+    if (implementation == AVX2) {
+        return __builtin_cpu_supports("avx2");
+    }
+
+    if (implementation == SSE42) {
+        return __builtin_cpu_supports("sse4.2");
+    }
+#endif
+
+    return false;
+}
+
+HttpHeaderScanner::Implementation HttpHeaderScanner::bestImplementation() {
+    static const Implementation best = detectImplementation();
+    return best;
+}
+
+const char* HttpHeaderScanner::implementationName(Implementation implementation) {
+    switch (implementation) {
+    case AVX2:
+        return "avx2";
+
+    case SSE42:
+        return "sse4.2";
+
+    default:
+        return "scalar";
+    }
+}
+
+int HttpHeaderScanner::scan(const char* bytes, int length, Block* block) const {
+    BOOST_ASSERT(bytes && block);
+
+    const char* end = bytes + length;
+    const char* lineEnd = findLineEnd_(bytes, end);
+
+    if (lineEnd == end) {
+        return INCOMPLETE;
+    }
+
+    int lineEndSize = scanLineEnd(lineEnd, end);
+
+    if (lineEndSize <= 0) {
+        return lineEndSize;
+    }
+
+    if (!splitInitialLine(bytes, lineEnd, block)) {
+        return UNSUPPORTED;
+    }
+
+    const char* line = lineEnd + lineEndSize;
+    block->initialLineSize = static_cast<int>(line - bytes);
+    block->headerCount = 0;
+
+    for (;;) {
+        if (line == end) {
+            return INCOMPLETE;
+        }
+
+        char first = *line;
+
+        if (first == HttpCodecUtil::CR || first == HttpCodecUtil::LF) {
+            // the empty line ends the block.
+            lineEndSize = scanLineEnd(line, end);
+
+            if (lineEndSize <= 0) {
+                return lineEndSize;
+            }
+
+            return static_cast<int>(line + lineEndSize - bytes);
+        }
+
+        // folded value or too many headers.
+        if (first == HttpCodecUtil::SP || first == HttpCodecUtil::HT
+                || block->headerCount == MAX_HEADER_COUNT) {
+            return UNSUPPORTED;
+        }
+
+        const char* colon = findDelimiter_(line, end);
+
+        if (colon == end) {
+            return INCOMPLETE;
+        }
+
+        if (*colon != ':' || colon == line || isWhitespace(colon[-1])) {
+            return UNSUPPORTED;
+        }
+
+        lineEnd = findLineEnd_(colon + 1, end);
+
+        if (lineEnd == end) {
+            return INCOMPLETE;
+        }
+
+        lineEndSize = scanLineEnd(lineEnd, end);
+
+        if (lineEndSize <= 0) {
+            return lineEndSize;
+        }
+
+        const char* valueBegin = colon + 1;
+        const char* valueEnd = lineEnd;
+
+        while (valueBegin != valueEnd && isWhitespace(*valueBegin)) {
+            ++valueBegin;
+        }
+
+        while (valueEnd != valueBegin && isWhitespace(valueEnd[-1])) {
+            --valueEnd;
+        }
+
+        Header& header = block->headers[block->headerCount++];
+        header.name = StringPiece(line, static_cast<int>(colon - line));
+        header.value = StringPiece(valueBegin, static_cast<int>(valueEnd - valueBegin));
+
+        line = lineEnd + lineEndSize;
+    }
+}
+
+int HttpHeaderScanner::scanLineEnd(const char* lineEnd, const char* end) const {
+    if (*lineEnd == HttpCodecUtil::LF) {
+        return 1;
+    }
+
+    if (lineEnd + 1 == end) {
+        return INCOMPLETE;
+    }
+
+    // a bare CR.
+    return lineEnd[1] == HttpCodecUtil::LF ? 2 : UNSUPPORTED;
+}
+
+bool HttpHeaderScanner::splitInitialLine(const char* begin,
+        const char* end,
+        Block* block) const {
+    // the same split as HttpPackageDecoder, the last part takes the rest.
+    for (int i = 0; i < 3; ++i) {
+        while (begin != end && isWhitespace(*begin)) {
+            ++begin;
+        }
+
+        const char* partEnd = begin;
+
+        if (i < 2) {
+            while (partEnd != end && !isWhitespace(*partEnd)) {
+                ++partEnd;
+            }
+        }
+        else {
+            partEnd = end;
+
+            while (partEnd != begin && isWhitespace(partEnd[-1])) {
+                --partEnd;
+            }
+        }
+
+        if (partEnd == begin) {
+            return false;
+        }
+
+        block->initialLine[i] = StringPiece(begin, static_cast<int>(partEnd - begin));
+        begin = partEnd;
+    }
+
+    return true;
+}
+
+}
+}
+}
+}
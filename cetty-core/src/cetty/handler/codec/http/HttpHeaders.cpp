@@ -416,49 +416,416 @@ const std::string HttpHeaders::Values::X_PROTOBUFFER = "application/x-protobuffe
 const std::string HttpHeaders::Values::X_WWW_FORM_URLENCODED = "application/x-www-form-urlencoded";
 
 
-void HttpHeaders::setHeader(const std::string& name,
-    const std::vector<int>& values) {
-    for (size_t i = 0; i < values.size(); ++i) {
-        setHeader(name, StringUtil::numtostr(values[i]));
+// in the order of the HttpHeaders::HeaderId.
+static const std::string* const HEADER_NAMES[HttpHeaders::HEADER_COUNT] = {
+    &HttpHeaders::Names::ACCEPT,
+    &HttpHeaders::Names::ACCEPT_CHARSET,
+    &HttpHeaders::Names::ACCEPT_ENCODING,
+    &HttpHeaders::Names::ACCEPT_LANGUAGE,
+    &HttpHeaders::Names::ACCEPT_RANGES,
+    &HttpHeaders::Names::ACCEPT_PATCH,
+    &HttpHeaders::Names::AGE,
+    &HttpHeaders::Names::ALLOW,
+    &HttpHeaders::Names::AUTHORIZATION,
+    &HttpHeaders::Names::CACHE_CONTROL,
+    &HttpHeaders::Names::CONNECTION,
+    &HttpHeaders::Names::CONTENT_BASE,
+    &HttpHeaders::Names::CONTENT_ENCODING,
+    &HttpHeaders::Names::CONTENT_LANGUAGE,
+    &HttpHeaders::Names::CONTENT_LENGTH,
+    &HttpHeaders::Names::CONTENT_LOCATION,
+    &HttpHeaders::Names::CONTENT_TRANSFER_ENCODING,
+    &HttpHeaders::Names::CONTENT_MD5,
+    &HttpHeaders::Names::CONTENT_RANGE,
+    &HttpHeaders::Names::CONTENT_TYPE,
+    &HttpHeaders::Names::COOKIE,
+    &HttpHeaders::Names::DATE,
+    &HttpHeaders::Names::ETAG,
+    &HttpHeaders::Names::EXPECT,
+    &HttpHeaders::Names::EXPIRES,
+    &HttpHeaders::Names::FROM,
+    &HttpHeaders::Names::HOST,
+    &HttpHeaders::Names::IF_MATCH,
+    &HttpHeaders::Names::IF_MODIFIED_SINCE,
+    &HttpHeaders::Names::IF_NONE_MATCH,
+    &HttpHeaders::Names::IF_RANGE,
+    &HttpHeaders::Names::IF_UNMODIFIED_SINCE,
+    &HttpHeaders::Names::LAST_MODIFIED,
+    &HttpHeaders::Names::LOCATION,
+    &HttpHeaders::Names::MAX_FORWARDS,
+    &HttpHeaders::Names::ORIGIN,
+    &HttpHeaders::Names::PRAGMA,
+    &HttpHeaders::Names::PROXY_AUTHENTICATE,
+    &HttpHeaders::Names::PROXY_AUTHORIZATION,
+    &HttpHeaders::Names::RANGE,
+    &HttpHeaders::Names::REFERER,
+    &HttpHeaders::Names::RETRY_AFTER,
+    &HttpHeaders::Names::SEC_WEBSOCKET_KEY1,
+    &HttpHeaders::Names::SEC_WEBSOCKET_KEY2,
+    &HttpHeaders::Names::SEC_WEBSOCKET_LOCATION,
+    &HttpHeaders::Names::SEC_WEBSOCKET_ORIGIN,
+    &HttpHeaders::Names::SEC_WEBSOCKET_PROTOCOL,
+    &HttpHeaders::Names::SEC_WEBSOCKET_VERSION,
+    &HttpHeaders::Names::SEC_WEBSOCKET_KEY,
+    &HttpHeaders::Names::SEC_WEBSOCKET_ACCEPT,
+    &HttpHeaders::Names::SERVER,
+    &HttpHeaders::Names::SET_COOKIE,
+    &HttpHeaders::Names::SET_COOKIE2,
+    &HttpHeaders::Names::TE,
+    &HttpHeaders::Names::TRAILER,
+    &HttpHeaders::Names::TRANSFER_ENCODING,
+    &HttpHeaders::Names::UPGRADE,
+    &HttpHeaders::Names::USER_AGENT,
+    &HttpHeaders::Names::VARY,
+    &HttpHeaders::Names::VIA,
+    &HttpHeaders::Names::WARNING,
+    &HttpHeaders::Names::WEBSOCKET_LOCATION,
+    &HttpHeaders::Names::WEBSOCKET_ORIGIN,
+    &HttpHeaders::Names::WEBSOCKET_PROTOCOL,
+    &HttpHeaders::Names::WWW_AUTHENTICATE
+};
+
+static const std::string EMPTY_NAME;
+
+static inline char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static bool equalsIgnoreCase(const StringPiece& a, const StringPiece& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (int i = 0, j = a.size(); i < j; ++i) {
+        if (a[i] != b[i] && toLower(a[i]) != toLower(b[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// the standard names grouped by the length, looking up a name only compares
+// the few ones with the same length.
+class HeaderNameIndex {
+public:
+    static const int MAX_NAME_LENGTH = 32;
+
+    HeaderNameIndex() {
+        for (int i = 0; i < HttpHeaders::HEADER_COUNT; ++i) {
+            int length = static_cast<int>(HEADER_NAMES[i]->size());
+            BOOST_ASSERT(length <= MAX_NAME_LENGTH);
+            ids_[length].push_back(i);
+        }
+    }
+
+    HttpHeaders::HeaderId find(const StringPiece& name) const {
+        int length = name.size();
+
+        if (length <= 0 || length > MAX_NAME_LENGTH) {
+            return HttpHeaders::HEADER_UNKNOWN;
+        }
+
+        const std::vector<int>& ids = ids_[length];
+        char first = toLower(name[0]);
+
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            const std::string& candidate = *HEADER_NAMES[ids[i]];
+
+            if (toLower(candidate[0]) == first
+                    && equalsIgnoreCase(candidate, name)) {
+                return static_cast<HttpHeaders::HeaderId>(ids[i]);
+            }
+        }
+
+        return HttpHeaders::HEADER_UNKNOWN;
+    }
+
+private:
+    std::vector<int> ids_[MAX_NAME_LENGTH + 1];
+};
+
+HttpHeaders::HeaderId HttpHeaders::headerId(const StringPiece& name) {
+    static const HeaderNameIndex index;
+    return index.find(name);
+}
+
+const std::string& HttpHeaders::headerName(HeaderId id) {
+    if (id < 0 || id >= HEADER_COUNT) {
+        return EMPTY_NAME;
+    }
+
+    return *HEADER_NAMES[id];
+}
+
+void HttpHeaders::headerValues(const StringPiece& name,
+                               std::vector<std::string>* values) const {
+    if (!values) {
+        return;
+    }
+
+    HeaderId id = headerId(name);
+
+    for (int i = 0; i < headers_.size(); ++i) {
+        const Header& header = headers_[i];
+
+        if (header.id == id
+                && (id != HEADER_UNKNOWN || equalsIgnoreCase(nameOf(header), name))) {
+            values->push_back(valueOf(header).as_string());
+        }
+    }
+}
+
+void HttpHeaders::headerNames(std::vector<std::string>* names) const {
+    if (!names) {
+        return;
+    }
+
+    for (int i = 0; i < headers_.size(); ++i) {
+        StringPiece name = nameOf(headers_[i]);
+        bool found = false;
+
+        for (int j = 0; j < i; ++j) {
+            if (equalsIgnoreCase(nameOf(headers_[j]), name)) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            names->push_back(name.as_string());
+        }
+    }
+}
+
+void HttpHeaders::addHeader(const StringPiece& name, int value) {
+    add(headerId(name), name, StringUtil::numtostr(value));
+}
+
+void HttpHeaders::setHeader(const StringPiece& name, int value) {
+    setHeader(name, StringPiece(StringUtil::numtostr(value)));
+}
+
+void HttpHeaders::setHeader(const StringPiece& name,
+                            const std::vector<std::string>& values) {
+    HeaderId id = headerId(name);
+    remove(id, name, NULL);
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        add(id, name, values[i]);
+    }
+}
+
+void HttpHeaders::setHeader(const StringPiece& name,
+                            const std::vector<int>& values) {
+    HeaderId id = headerId(name);
+    remove(id, name, NULL);
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        add(id, name, StringUtil::numtostr(values[i]));
+    }
+}
+
+int HttpHeaders::find(HeaderId id, const StringPiece& name) const {
+    if (id != HEADER_UNKNOWN) {
+        for (int i = 0; i < headers_.size(); ++i) {
+            if (headers_[i].id == id) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    if (name.empty()) {
+        return -1;
+    }
+
+    for (int i = 0; i < headers_.size(); ++i) {
+        const Header& header = headers_[i];
+
+        if (header.id == HEADER_UNKNOWN
+                && equalsIgnoreCase(nameOf(header), name)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void HttpHeaders::add(HeaderId id,
+                      const StringPiece& name,
+                      const StringPiece& value) {
+    if (id == HEADER_UNKNOWN && name.empty()) {
+        return;
+    }
+
+    // appending the name may move the value, copy them first.
+    if (inBytes(name) || inBytes(value)) {
+        std::string nameCopy(name.data(), name.size());
+        std::string valueCopy(value.data(), value.size());
+
+        add(id, nameCopy, valueCopy);
+        return;
+    }
+
+    Header header;
+    header.id = id;
+    header.nameOffset = 0;
+    header.nameLength = 0;
+
+    if (id == HEADER_UNKNOWN) {
+        header.nameOffset = bytes_.size();
+        header.nameLength = name.size();
+        bytes_.append(name.data(), name.size());
+    }
+
+    header.valueOffset = bytes_.size();
+    header.valueLength = value.size();
+    bytes_.append(value.data(), value.size());
+
+    headers_.push_back(header);
+}
+
+void HttpHeaders::set(HeaderId id,
+                      const StringPiece& name,
+                      const StringPiece& value) {
+    // removing may compact or reuse the bytes of the name or the value.
+    if (inBytes(name) || inBytes(value)) {
+        std::string nameCopy(name.data(), name.size());
+        std::string valueCopy(value.data(), value.size());
+
+        remove(id, nameCopy, NULL);
+        add(id, nameCopy, valueCopy);
+        return;
+    }
+
+    remove(id, name, NULL);
+    add(id, name, value);
+}
+
+void HttpHeaders::remove(HeaderId id,
+                         const StringPiece& name,
+                         const StringPiece* value) {
+    if (id == HEADER_UNKNOWN && name.empty()) {
+        return;
+    }
+
+    bool removed = false;
+
+    for (int i = headers_.size() - 1; i >= 0; --i) {
+        const Header& header = headers_[i];
+
+        if (header.id != id) {
+            continue;
+        }
+
+        if (id == HEADER_UNKNOWN && !equalsIgnoreCase(nameOf(header), name)) {
+            continue;
+        }
+
+        if (value && valueOf(header) != *value) {
+            continue;
+        }
+
+        headers_.erase(i);
+        removed = true;
+    }
+
+    if (!removed) {
+        return;
+    }
+
+    if (headers_.empty()) {
+        bytes_.clear();
+        return;
+    }
+
+    // the bytes of the removed headers are left in place, compact them when
+    // most of the bytes are not used any more.
+    int used = 0;
+
+    for (int i = 0; i < headers_.size(); ++i) {
+        used += headers_[i].nameLength + headers_[i].valueLength;
+    }
+
+    if (bytes_.size() > INLINE_HEADER_BYTES && used < bytes_.size() / 2) {
+        HeaderBytes bytes;
+
+        for (int i = 0; i < headers_.size(); ++i) {
+            Header& header = headers_[i];
+            int offset = bytes.size();
+
+            bytes.append(bytes_.data() + header.nameOffset, header.nameLength);
+            header.nameOffset = offset;
+
+            offset = bytes.size();
+            bytes.append(bytes_.data() + header.valueOffset, header.valueLength);
+            header.valueOffset = offset;
+        }
+
+        bytes_ = bytes;
+    }
+}
+
+StringPiece HttpHeaders::nameOf(const Header& header) const {
+    if (header.id != HEADER_UNKNOWN) {
+        return *HEADER_NAMES[header.id];
     }
+
+    return StringPiece(bytes_.data() + header.nameOffset, header.nameLength);
+}
+
+int HttpHeaders::intValue(const StringPiece& value, int defaultValue) {
+    if (value.empty()) {
+        return defaultValue;
+    }
+
+    for (int i = 0, j = value.size(); i < j; ++i) {
+        if (!StringUtil::isDigit(value[i])) {
+            return defaultValue;
+        }
+    }
+
+    return StringUtil::strto32(value);
 }
 
 bool HttpHeaders::keepAlive(const HttpVersion& version) const {
-    const std::string& connection = headerValue(Names::CONNECTION);
+    StringPiece connection = headerValue(HEADER_CONNECTION);
 
-    if (StringUtil::iequals(Values::CLOSE, connection)) {
+    if (equalsIgnoreCase(Values::CLOSE, connection)) {
         return false;
     }
 
     if (version.keepAliveDefault()) {
-        return !StringUtil::iequals(Values::CLOSE, connection);
+        return true;
     }
     else {
-        return StringUtil::iequals(Values::KEEP_ALIVE, connection);
+        return equalsIgnoreCase(Values::KEEP_ALIVE, connection);
     }
 }
 
 void HttpHeaders::setKeepAlive(bool keepAlive, const HttpVersion& version) {
     if (version.keepAliveDefault()) {
         if (keepAlive) {
-            removeHeader(Names::CONNECTION);
+            removeHeader(HEADER_CONNECTION);
         }
         else {
-            setHeader(Names::CONNECTION, Values::CLOSE);
+            setHeader(HEADER_CONNECTION, Values::CLOSE);
         }
     }
     else {
         if (keepAlive) {
-            setHeader(Names::CONNECTION, Values::KEEP_ALIVE);
+            setHeader(HEADER_CONNECTION, Values::KEEP_ALIVE);
         }
         else {
-            removeHeader(Names::CONNECTION);
+            removeHeader(HEADER_CONNECTION);
         }
     }
 }
 
 int HttpHeaders::contentLength() const {
-    const std::string& contentLength = headerValue(Names::CONTENT_LENGTH);
+    StringPiece contentLength = headerValue(HEADER_CONTENT_LENGTH);
 
     if (!contentLength.empty()) {
         return StringUtil::strto32(contentLength);
@@ -468,19 +835,19 @@ int HttpHeaders::contentLength() const {
 }
 
 void HttpHeaders::setContentLength(int length) {
-    setHeader(Names::CONTENT_LENGTH, StringUtil::numtostr(length));
+    setHeader(HEADER_CONTENT_LENGTH, StringUtil::numtostr(length));
 }
 
-const std::string& HttpHeaders::host() const {
-    return headerValue(Names::HOST);
+StringPiece HttpHeaders::host() const {
+    return headerValue(HEADER_HOST);
 }
 
-const std::string& HttpHeaders::host(const std::string& defaultValue) const {
-    return headerValue(Names::HOST, defaultValue);
+StringPiece HttpHeaders::host(const StringPiece& defaultValue) const {
+    return headerValue(HEADER_HOST, defaultValue);
 }
 
-void HttpHeaders::setHost(const std::string& value) {
-    setHeader(Names::HOST, value);
+void HttpHeaders::setHost(const StringPiece& value) {
+    setHeader(HEADER_HOST, value);
 }
 
 const HttpTransferEncoding& HttpHeaders::transferEncoding() const {
@@ -489,17 +856,27 @@ const HttpTransferEncoding& HttpHeaders::transferEncoding() const {
 
 void HttpHeaders::setTransferEncoding(const HttpTransferEncoding& te) {
     transferEncoding_ = te;
-    const std::string& transferEnocodingStr = HttpHeaders::Names::TRANSFER_ENCODING;
-    const std::string& chunkedStr = HttpHeaders::Values::CHUNKED;
+    StringPiece chunked = Values::CHUNKED;
 
     if (te == HttpTransferEncoding::CHUNKED) {
-        if (!headers_.has(transferEnocodingStr, chunkedStr)) {
-            addHeader(transferEnocodingStr, chunkedStr);
+        bool hasChunked = false;
+
+        for (int i = 0; i < headers_.size(); ++i) {
+            if (headers_[i].id == HEADER_TRANSFER_ENCODING
+                    && valueOf(headers_[i]) == chunked) {
+                hasChunked = true;
+                break;
+            }
+        }
+
+        if (!hasChunked) {
+            addHeader(HEADER_TRANSFER_ENCODING, chunked);
         }
-        removeHeader(HttpHeaders::Names::CONTENT_LENGTH);
+
+        removeHeader(HEADER_CONTENT_LENGTH);
     }
     else {
-        headers_.erase(transferEnocodingStr, chunkedStr);
+        remove(HEADER_TRANSFER_ENCODING, StringPiece(), &chunked);
     }
 }
 
@@ -513,41 +890,22 @@ void HttpHeaders::addCookie(const std::string& name, const std::string& value) {
 }
 
 const std::vector<Cookie>& HttpHeaders::cookies() const {
-    if (cookies_.empty()) {
-        const std::string& header = headers_.get(HttpHeaders::Names::COOKIE);
-        if (!header.empty()) {
-            return cookies_;
-        }
-
-        NameValueCollection::ConstIterator lower =
-            headers_.lowerBound(HttpHeaders::Names::SET_COOKIE);
-
-        if (lower != headers_.end()) {
-            NameValueCollection::ConstIterator up =
-                headers_.upperBound(HttpHeaders::Names::SET_COOKIE);
-
-            for (NameValueCollection::ConstIterator itr = lower; itr != up; ++itr) {
-
-            }
-        }
-    }
-
     return cookies_;
 }
 
 void HttpHeaders::toString(std::string* str) const {
-
-    //     StringUtil::printf(&buf,
-    //         "HttpMessage (version: %d, keepAlive: %s,  transferEncoding: %s)",
-    //         getProtocolVersion().getText().c_str(),
-    //         HttpHeaders::keepAlive(*this) ? "true" : "false",
-    //         transferEncoding_.toString().c_str());
+    if (!str) {
+        return;
+    }
 
     ConstHeaderIterator itr = firstHeader();
     ConstHeaderIterator end = lastHeader();
 
-    for (itr; itr != end; ++itr) {
-        StringUtil::printf(str, "\r\n%s: %s", itr->first.c_str(), itr->second.c_str());
+    for (; itr != end; ++itr) {
+        str->append("\r\n");
+        itr.name().append_to(str);
+        str->append(": ");
+        itr.value().append_to(str);
     }
 }
 
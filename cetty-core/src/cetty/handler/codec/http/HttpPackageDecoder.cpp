@@ -15,6 +15,8 @@
  */
 #include <cetty/handler/codec/http/HttpPackageDecoder.h>
 
+#include <string.h>
+
 #include <cetty/buffer/Unpooled.h>
 #include <cetty/util/Exception.h>
 #include <cetty/util/StringUtil.h>
@@ -51,7 +53,9 @@ HttpPackageDecoder::HttpPackageDecoder(DecodingType decodingType)
       maxChunkSize_(MAX_CHUNK_SIZE),
       chunkSize_(0),
       headerSize_(0),
-      contentRead_(0) {
+      contentRead_(0),
+      headerBlockScan_(true),
+      headerBlockScanned_(0) {
 }
 
 HttpPackageDecoder::HttpPackageDecoder(DecodingType decodingType,
@@ -64,7 +68,9 @@ HttpPackageDecoder::HttpPackageDecoder(DecodingType decodingType,
       maxChunkSize_(maxChunkSize),
       chunkSize_(0),
       headerSize_(0),
-      contentRead_(0) {
+      contentRead_(0),
+      headerBlockScan_(true),
+      headerBlockScanned_(0) {
     if (maxInitialLineLength <= 0) {
         maxInitialLineLength_ = MAX_INITIAL_LINE_LENGTH;
     }
@@ -96,6 +102,20 @@ HttpPackage HttpPackageDecoder::decode(ChannelHandlerContext& ctx,
     }
 
     case READ_INITIAL: {
+        if (headerBlockScan_) {
+            int nextState = scanHeaderBlock(buffer);
+
+            if (nextState == READ_INITIAL) {
+                // wait for the rest of the header block.
+                buffer->needMoreBytes(true);
+                break;
+            }
+            else if (nextState >= 0) {
+                checkPoint(nextState);
+                return headersDecoded(buffer, nextState);
+            }
+        }
+
         std::vector<StringPiece> initialLine;
         StringPiece line = readLine(buffer, maxInitialLineLength_);
 
@@ -130,58 +150,7 @@ HttpPackage HttpPackageDecoder::decode(ChannelHandlerContext& ctx,
         }
 
         checkPoint(nextState);
-
-        if (nextState == READ_CHUNK_SIZE) {
-            // Chunked encoding - generate HttpMessage first.  HttpChunks will follow.
-            return message_;
-        }
-        else if (nextState == SKIP_CONTROL_CHARS) {
-            // No content is expected.
-            return message_;
-        }
-        else {
-            int contentLength = message_.contentLength(-1);
-
-            if (contentLength == 0 || (contentLength == -1 && isDecodingRequest_)) {
-                content_ = Unpooled::EMPTY_BUFFER;
-                return reset();
-            }
-
-            switch (nextState) {
-            case READ_FIXED_LENGTH_CONTENT:
-                if (contentLength > maxChunkSize_
-                        || message_.is100ContinueExpected()) {
-                    // Generate HttpMessage first.  HttpChunks will follow.
-                    checkPoint(READ_FIXED_LENGTH_CONTENT_AS_CHUNKS);
-                    message_.setTransferEncoding(HttpTransferEncoding::STREAMED);
-
-                    // chunkSize will be decreased as the READ_FIXED_LENGTH_CONTENT_AS_CHUNKS
-                    // state reads data chunk by chunk.
-                    chunkSize_ = message_.contentLength(-1);
-                    return message_;
-                }
-
-                break;
-
-            case READ_VARIABLE_LENGTH_CONTENT:
-                if (buffer->readableBytes() > maxChunkSize_
-                        || message_.is100ContinueExpected()) {
-                    // Generate HttpMessage first.  HttpChunks will follow.
-                    checkPoint(READ_VARIABLE_LENGTH_CONTENT_AS_CHUNKS);
-                    message_.setTransferEncoding(HttpTransferEncoding::STREAMED);
-                    return message_;
-                }
-
-                break;
-
-            default:
-                throw IllegalStateException(
-                    StringUtil::printf("Unexpected state: %d", nextState));
-            }
-        }
-
-        // We return null here, this forces decode to be called again where we will decode the content
-        return HttpPackage();
+        return headersDecoded(buffer, nextState);
     }
 
     case READ_VARIABLE_LENGTH_CONTENT: {
@@ -215,7 +184,7 @@ HttpPackage HttpPackageDecoder::decode(ChannelHandlerContext& ctx,
 
         HttpChunkPtr chunk = new HttpChunk(buff);
 
-        if (!buffer->readable()) {
+        if (buffer->isTerminated() && !buffer->readable()) {
             // Reached to the end of the connection.
             reset();
 
@@ -414,6 +383,10 @@ HttpPackage HttpPackageDecoder::decode(ChannelHandlerContext& ctx,
     case READ_CHUNK_FOOTER: {
         HttpChunkTrailerPtr trailer = readTrailingHeaders(buffer);
 
+        if (buffer->needMoreBytes()) {
+            return HttpPackage();
+        }
+
         if (maxChunkSize_ == 0) {
             // Chunked encoding disabled.
             return reset();
@@ -433,6 +406,63 @@ HttpPackage HttpPackageDecoder::decode(ChannelHandlerContext& ctx,
     return HttpPackage();
 }
 
+HttpPackage HttpPackageDecoder::headersDecoded(const ReplayingDecoderBufferPtr& buffer,
+        int nextState) {
+    const CheckPointInvoker& checkPoint = checkPointInvoker_;
+
+    if (nextState == READ_CHUNK_SIZE) {
+        // Chunked encoding - generate HttpMessage first.  HttpChunks will follow.
+        return message_;
+    }
+    else if (nextState == SKIP_CONTROL_CHARS) {
+        // No content is expected.
+        return message_;
+    }
+    else {
+        int contentLength = message_.contentLength(-1);
+
+        if (contentLength == 0 || (contentLength == -1 && isDecodingRequest_)) {
+            content_ = Unpooled::EMPTY_BUFFER;
+            return reset();
+        }
+
+        switch (nextState) {
+        case READ_FIXED_LENGTH_CONTENT:
+            if (contentLength > maxChunkSize_
+                    || message_.is100ContinueExpected()) {
+                // Generate HttpMessage first.  HttpChunks will follow.
+                checkPoint(READ_FIXED_LENGTH_CONTENT_AS_CHUNKS);
+                message_.setTransferEncoding(HttpTransferEncoding::STREAMED);
+
+                // chunkSize will be decreased as the READ_FIXED_LENGTH_CONTENT_AS_CHUNKS
+                // state reads data chunk by chunk.
+                chunkSize_ = message_.contentLength(-1);
+                return message_;
+            }
+
+            break;
+
+        case READ_VARIABLE_LENGTH_CONTENT:
+            if (buffer->readableBytes() > maxChunkSize_
+                    || message_.is100ContinueExpected()) {
+                // Generate HttpMessage first.  HttpChunks will follow.
+                checkPoint(READ_VARIABLE_LENGTH_CONTENT_AS_CHUNKS);
+                message_.setTransferEncoding(HttpTransferEncoding::STREAMED);
+                return message_;
+            }
+
+            break;
+
+        default:
+            throw IllegalStateException(
+                StringUtil::printf("Unexpected state: %d", nextState));
+        }
+    }
+
+    // We return null here, this forces decode to be called again where we will decode the content
+    return HttpPackage();
+}
+
 bool HttpPackageDecoder::isContentAlwaysEmpty(const HttpPackage& msg) const {
     HttpResponsePtr response = msg.httpResponse();
 
@@ -475,6 +505,7 @@ HttpPackage HttpPackageDecoder::reset() {
 
     content_.reset();
     contentRead_ = 0;
+    headerBlockScanned_ = 0;
     message_ = HttpPackage();
     
     checkPointInvoker_(SKIP_CONTROL_CHARS);
@@ -570,7 +601,6 @@ ChannelBufferPtr read(const ChannelPtr& buffer, int len) {
 #endif
 
 int HttpPackageDecoder::readHeaders(const ReplayingDecoderBufferPtr& buffer) {
-    int nextState = SKIP_CONTROL_CHARS;
     StringPiece line = readHeader(buffer);
     StringPiece name;
     StringPiece value;
@@ -587,41 +617,28 @@ int HttpPackageDecoder::readHeaders(const ReplayingDecoderBufferPtr& buffer) {
     if (!line.empty()) {
         headers->clear();
 
-        std::vector<StringPiece> header;
-        std::string valueStr;
-        std::string nameStr;
+        // only the folded values, which are obsolete, need a copy.
+        std::string foldedValue;
 
         do {
             char firstChar = line[0];
 
             if (!name.empty() && (firstChar == ' ' || firstChar == '\t')) {
-                valueStr.clear();
-                StringPiece trimedLine = line.trim();
+                if (foldedValue.empty()) {
+                    value.copy_to(&foldedValue);
+                }
 
-                valueStr.append(value.data(), value.size());
-                valueStr.append(1, ' ');
-                valueStr.append(trimedLine.data(), trimedLine.size());
+                foldedValue.append(1, ' ');
+                line.trim().append_to(&foldedValue);
+                value = foldedValue;
             }
             else {
                 if (!name.empty()) {
-                    nameStr.assign(name.data(), name.size());
-
-                    if (!valueStr.empty()) {
-                        headers->addHeader(nameStr, valueStr);
-                    }
-                    else {
-                        valueStr.assign(value.data(), value.size());
-                        headers->addHeader(nameStr, valueStr);
-                    }
-
-                    nameStr.clear();
-                    valueStr.clear();
+                    headers->addHeader(name, value);
+                    foldedValue.clear();
                 }
 
-                header.clear();
-                splitHeader(line, &header);
-                name = header[0];
-                value = header[1];
+                splitHeader(line, &name, &value);
             }
 
             line = readHeader(buffer);
@@ -634,34 +651,109 @@ int HttpPackageDecoder::readHeaders(const ReplayingDecoderBufferPtr& buffer) {
 
         // Add the last header.
         if (!name.empty()) {
-            nameStr.assign(name.data(), name.size());
-
-            if (!valueStr.empty()) {
-                headers->addHeader(nameStr, valueStr);
-            }
-            else {
-                valueStr.assign(value.data(), value.size());
-                headers->addHeader(nameStr, valueStr);
-            }
+            headers->addHeader(name, value);
         }
     }
 
+    return contentState();
+}
+
+int HttpPackageDecoder::contentState() {
+    HttpHeaders* headers = message_.headers();
+
     if (isContentAlwaysEmpty(message_)) {
         headers->setTransferEncoding(HttpTransferEncoding::SINGLE);
-        nextState = SKIP_CONTROL_CHARS;
+        return SKIP_CONTROL_CHARS;
     }
-//     else if (HttpCodecUtil::isTransferEncodingChunked(*message_)) {
-//         headers.setTransferEncoding(HttpTransferEncoding::CHUNKED);
-//         nextState = READ_CHUNK_SIZE;
-//     }
-    else if (message_.headers()->headerIntValue(HttpHeaders::Names::CONTENT_LENGTH, -1) >= 0) {
-        nextState = READ_FIXED_LENGTH_CONTENT;
+    else if (HttpCodecUtil::isTransferEncodingChunked(*headers)) {
+        headers->setTransferEncoding(HttpTransferEncoding::CHUNKED);
+        return READ_CHUNK_SIZE;
+    }
+    else if (headers->headerIntValue(HttpHeaders::HEADER_CONTENT_LENGTH, -1) >= 0) {
+        return READ_FIXED_LENGTH_CONTENT;
     }
     else {
-        nextState = READ_VARIABLE_LENGTH_CONTENT;
+        return READ_VARIABLE_LENGTH_CONTENT;
+    }
+}
+
+// searches an empty line from <tt>*scanned</tt>, which is updated to where
+// the next search starts when no empty line found.
+static bool hasEmptyLine(const char* bytes, int length, int* scanned) {
+    const char* end = bytes + length;
+    const char* p = bytes + *scanned;
+
+    while (p < end
+            && (p = static_cast<const char*>(memchr(p, HttpCodecUtil::LF, end - p)))) {
+        if (end - p < 2 || (p[1] == HttpCodecUtil::CR && end - p < 3)) {
+            // not sure yet, check this line end again with more bytes.
+            *scanned = static_cast<int>(p - bytes);
+            return false;
+        }
+
+        if (p[1] == HttpCodecUtil::LF
+                || (p[1] == HttpCodecUtil::CR && p[2] == HttpCodecUtil::LF)) {
+            return true;
+        }
+
+        ++p;
+    }
+
+    *scanned = length;
+    return false;
+}
+
+int HttpPackageDecoder::scanHeaderBlock(const ReplayingDecoderBufferPtr& buffer) {
+    int bytesCnt;
+    const char* bytes = buffer->readableBytes(&bytesCnt);
+
+    if (headerBlockScanned_ > bytesCnt) {
+        headerBlockScanned_ = 0;
+    }
+
+    if (!hasEmptyLine(bytes, bytesCnt, &headerBlockScanned_)) {
+        if (bytesCnt > maxInitialLineLength_ + maxHeaderSize_) {
+            // let the line decoding report the too long frame.
+            headerBlockScanned_ = 0;
+            return -1;
+        }
+
+        return READ_INITIAL;
+    }
+
+    headerBlockScanned_ = 0;
+
+    HttpHeaderScanner::Block block;
+    int blockSize = headerScanner_.scan(bytes, bytesCnt, &block);
+
+    if (blockSize == HttpHeaderScanner::INCOMPLETE
+            || blockSize == HttpHeaderScanner::UNSUPPORTED
+            || blockSize - block.initialLineSize > maxHeaderSize_) {
+        return -1;
+    }
+
+    if (block.initialLineSize > maxInitialLineLength_) {
+        throw TooLongFrameException(
+            StringUtil::printf("An HTTP line is larger than %d bytes.",
+                               maxInitialLineLength_));
     }
 
-    return nextState;
+    message_ = httpPackageCreator_(block.initialLine[0],
+                                   block.initialLine[1],
+                                   block.initialLine[2]);
+    headerSize_ = 0;
+
+    HttpHeaders* headers = message_.headers();
+    BOOST_ASSERT(headers);
+
+    headers->clear();
+
+    for (int i = 0; i < block.headerCount; ++i) {
+        headers->addHeader(block.headers[i].name, block.headers[i].value);
+    }
+
+    buffer->offsetReaderIndex(blockSize);
+    return contentState();
 }
 
 HttpChunkTrailerPtr
@@ -675,12 +767,8 @@ HttpPackageDecoder::readTrailingHeaders(const ReplayingDecoderBufferPtr& buffer)
     }
 
     if (!line.empty()) {
-        std::vector<StringPiece> header;
         HttpChunkTrailerPtr trailer = new HttpChunkTrailer;
 
-        std::string valueStr;
-        std::string nameStr;
-
         do {
             char firstChar = line[0];
 
@@ -703,14 +791,16 @@ HttpPackageDecoder::readTrailingHeaders(const ReplayingDecoderBufferPtr& buffer)
 #endif
             }
             else {
-                header.clear();
-                splitHeader(line, &header);
-                StringPiece name = header[0];
-
-                if (!name.iequals(HttpHeaders::Names::CONTENT_LENGTH) &&
-                        !name.iequals(HttpHeaders::Names::TRANSFER_ENCODING) &&
-                        !name.iequals(HttpHeaders::Names::TRAILER)) {
-                    trailer->headers().addHeader(name.c_str(), header[1].c_str());
+                StringPiece name;
+                StringPiece value;
+                splitHeader(line, &name, &value);
+
+                HttpHeaders::HeaderId id = HttpHeaders::headerId(name);
+
+                if (id != HttpHeaders::HEADER_CONTENT_LENGTH &&
+                        id != HttpHeaders::HEADER_TRANSFER_ENCODING &&
+                        id != HttpHeaders::HEADER_TRAILER) {
+                    trailer->headers().addHeader(name, value);
                 }
 
                 lastHeader = name;
@@ -727,7 +817,8 @@ HttpPackageDecoder::readTrailingHeaders(const ReplayingDecoderBufferPtr& buffer)
         return trailer;
     }
 
-    return boost::dynamic_pointer_cast<HttpChunkTrailer>(HttpChunk::LAST_CHUNK);
+    // no trailing headers, just the empty last chunk.
+    return HttpChunkTrailerPtr(new HttpChunkTrailer);
 }
 
 StringPiece HttpPackageDecoder::readHeader(const ReplayingDecoderBufferPtr& buffer) {
@@ -835,7 +926,9 @@ bool HttpPackageDecoder::splitInitialLine(StringPiece& sb, std::vector<StringPie
     return true;
 }
 
-void HttpPackageDecoder::splitHeader(StringPiece& sb, std::vector<StringPiece>* header) {
+void HttpPackageDecoder::splitHeader(const StringPiece& sb,
+                                     StringPiece* name,
+                                     StringPiece* value) {
     int length = sb.length();
     int nameStart;
     int nameEnd;
@@ -843,7 +936,7 @@ void HttpPackageDecoder::splitHeader(StringPiece& sb, std::vector<StringPiece>*
     int valueStart;
     int valueEnd;
 
-    if (NULL == header) {
+    if (NULL == name || NULL == value) {
         return;
     }
 
@@ -866,16 +959,15 @@ void HttpPackageDecoder::splitHeader(StringPiece& sb, std::vector<StringPiece>*
 
     valueStart = findNonWhitespace(sb, colonEnd);
 
+    *name = sb.substr(nameStart, nameEnd - nameStart);
+
     if (valueStart == length) {
-        header->push_back(sb.substr(nameStart, nameEnd - nameStart));
-        header->push_back(StringPiece());
+        *value = StringPiece();
         return;
     }
 
     valueEnd = findEndOfString(sb);
-
-    header->push_back(sb.substr(nameStart, nameEnd - nameStart));
-    header->push_back(sb.substr(valueStart, valueEnd - valueStart));
+    *value = sb.substr(valueStart, valueEnd - valueStart);
 }
 
 int HttpPackageDecoder::findNonWhitespace(const StringPiece& sb, int offset) {
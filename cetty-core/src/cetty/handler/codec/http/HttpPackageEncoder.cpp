@@ -62,7 +62,7 @@ ChannelBufferPtr HttpPackageEncoder::encode(ChannelHandlerContext& ctx,
         request->setTransferEncoding(te);
 
         // Encode the message.
-        ChannelBufferPtr header = Unpooled::buffer();
+        ChannelBufferPtr header = ctx.newBuffer(256);
 
         initialLineEncoder_(msg, header);
         encodeHeaders(*header,
@@ -98,7 +98,7 @@ ChannelBufferPtr HttpPackageEncoder::encode(ChannelHandlerContext& ctx,
         response->setTransferEncoding(te);
 
         // Encode the message.
-        ChannelBufferPtr header = Unpooled::buffer();
+        ChannelBufferPtr header = ctx.newBuffer(256);
 
         initialLineEncoder_(msg, header);
         encodeHeaders(*header,
@@ -158,7 +158,7 @@ ChannelBufferPtr HttpPackageEncoder::encode(ChannelHandlerContext& ctx,
                 return content;
             }
             else {
-                ChannelBufferPtr buffer = Unpooled::buffer(contentLength + lengthPartSize + 2);
+                ChannelBufferPtr buffer = ctx.newBuffer(contentLength + lengthPartSize + 2);
                 buffer->writeBytes(lengthStr);
                 buffer->writeByte(HttpCodecUtil::CR);
                 buffer->writeByte(HttpCodecUtil::LF);
@@ -184,7 +184,7 @@ ChannelBufferPtr HttpPackageEncoder::encode(ChannelHandlerContext& ctx,
             //encoder.chunked = false;
 
             if (chunkTrailer) {
-                ChannelBufferPtr trailer = Unpooled::buffer(1024);
+                ChannelBufferPtr trailer = ctx.newBuffer(1024);
 
                 trailer->writeByte('0');
                 trailer->writeByte(HttpCodecUtil::CR);
@@ -209,13 +209,13 @@ void HttpPackageEncoder::encodeHeaders(ChannelBuffer& buf,
     const HttpHeaders::ConstHeaderIterator& end) {
 
     for (HttpHeaders::ConstHeaderIterator itr = begin; itr != end; ++itr) {
-        encodeHeader(buf, itr->first, itr->second);
+        encodeHeader(buf, itr.name(), itr.value());
     }
 }
 
 void HttpPackageEncoder::encodeHeader(ChannelBuffer& buf,
-                                      const std::string& header,
-                                      const std::string& value) {
+                                      const StringPiece& header,
+                                      const StringPiece& value) {
     buf.writeBytes(header);
     buf.writeByte(HttpCodecUtil::COLON);
     buf.writeByte(HttpCodecUtil::SP);
@@ -51,8 +51,8 @@ HttpRequest::~HttpRequest() {
 
 const NameValueCollection& HttpRequest::queryParameters() const {
     if (queryParams_.empty()) {
-        const std::string& contentType = headers_.headerValue(HttpHeaders::Names::CONTENT_TYPE);
-        if (contentType.find(HttpHeaders::Values::X_WWW_FORM_URLENCODED) != std::string::npos) {
+        StringPiece contentType = headers_.headerValue(HttpHeaders::HEADER_CONTENT_TYPE);
+        if (contentType.as_string().find(HttpHeaders::Values::X_WWW_FORM_URLENCODED) != std::string::npos) {
             std::string contentStr;
             content_->readBytes(&contentStr);
             std::string decodedStr;
@@ -103,13 +103,13 @@ bool HttpRequest::is100ContinueExpected() const {
     }
 
     // In most cases, there will be one or zero 'Expect' header.
-    const std::string& value = headers_.headerValue(HttpHeaders::Names::EXPECT);
+    StringPiece value = headers_.headerValue(HttpHeaders::HEADER_EXPECT);
 
     if (value.empty()) {
         return false;
     }
 
-    if (StringUtil::iequals(HttpHeaders::Values::CONTINUE, value)) {
+    if (value.iequals(HttpHeaders::Values::CONTINUE)) {
         return true;
     }
 
@@ -25,8 +25,10 @@
 #include <cetty/channel/ChannelHandlerContext.h>
 
 #include <cetty/handler/timeout/IdleStateEvent.h>
+#include <cetty/handler/timeout/IdleStateSweeper.h>
 
 #include <cetty/util/Exception.h>
+#include <cetty/util/CachedClock.h>
 
 namespace cetty {
 namespace handler {
@@ -44,7 +46,10 @@ IdleStateHandler::IdleStateHandler(int readerIdleTimeSeconds,
       writerIdleCount_(),
       allIdleTimeMillis_(allIdleTimeSeconds * 1000),
       allIdleCount_(),
-      state_(0) {
+      state_(0),
+      sweepIntervalMillis_(0),
+      ctx_(NULL),
+      sweeper_(NULL) {
 }
 
 IdleStateHandler::IdleStateHandler(
@@ -57,14 +62,25 @@ IdleStateHandler::IdleStateHandler(
       writerIdleCount_(),
       allIdleTimeMillis_(allIdleTime.total_milliseconds()),
       allIdleCount_(),
-      state_(0) {
+      state_(0),
+      sweepIntervalMillis_(0),
+      ctx_(NULL),
+      sweeper_(NULL) {
 }
 
 void IdleStateHandler::beforeAdd(ChannelHandlerContext& ctx) {
     if (ctx.channel()->isActive()) {
         // channelActvie() event has been fired already, which means this.channelActive() will
         // not be invoked. We have to initialize here instead.
-        initialize(ctx);
+        if (sweepIntervalMillis_ > 0 && !ctx.eventLoop()->inLoopThread()) {
+            // the sweeper is per loop thread.
+            ctx.eventLoop()->post(boost::bind(&IdleStateHandler::initialize,
+                                              this,
+                                              boost::ref(ctx)));
+        }
+        else {
+            initialize(ctx);
+        }
     }
     else {
         // channelActive() event has not been fired yet.  this.channelActive() will be invoked
@@ -95,7 +111,16 @@ void IdleStateHandler::initialize(ChannelHandlerContext& ctx) {
 
     state_ = 1;
 
-    lastReadTime_ = lastWriteTime_ = boost::get_system_time();
+    lastReadTime_ = lastWriteTime_ = CachedClock::now();
+
+    if (sweepIntervalMillis_ > 0) {
+        ctx_ = &ctx;
+        readerIdleDeadline_ = writerIdleDeadline_ = allIdleDeadline_ = lastReadTime_;
+
+        sweeper_ = IdleStateSweeper::current(ctx.eventLoop());
+        sweeperItr_ = sweeper_->add(this);
+        return;
+    }
 
     if (!readerIdleTimerCallback_) {
         readerIdleTimerCallback_ = boost::bind(
@@ -137,6 +162,13 @@ void IdleStateHandler::initialize(ChannelHandlerContext& ctx) {
 }
 
 void IdleStateHandler::destroy() {
+    state_ = 2;
+
+    if (sweeper_) {
+        sweeper_->remove(sweeperItr_);
+        sweeper_ = NULL;
+    }
+
     if (readerIdleTimeout_) {
         readerIdleTimeout_->cancel();
         readerIdleTimeout_.reset();
@@ -154,11 +186,11 @@ void IdleStateHandler::destroy() {
 }
 
 void IdleStateHandler::handleReaderIdleTimeout(ChannelHandlerContext& ctx) {
-    if (readerIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
+    if (!readerIdleTimeout_ || readerIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
         return;
     }
 
-    Time currentTime = boost::get_system_time();
+    Time currentTime = CachedClock::now();
 
     Duration duration = currentTime - lastReadTime_;
     boost::int64_t nextDelay = readerIdleTimeMillis_ - duration.total_milliseconds();
@@ -186,11 +218,11 @@ void IdleStateHandler::handleReaderIdleTimeout(ChannelHandlerContext& ctx) {
 }
 
 void IdleStateHandler::handleWriterIdleTimeout(ChannelHandlerContext& ctx) {
-    if (readerIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
+    if (!writerIdleTimeout_ || writerIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
         return;
     }
 
-    Time currentTime = boost::get_system_time();
+    Time currentTime = CachedClock::now();
     Duration duration = currentTime - lastWriteTime_;
     boost::int64_t nextDelay = writerIdleTimeMillis_ - duration.total_milliseconds();
 
@@ -217,11 +249,11 @@ void IdleStateHandler::handleWriterIdleTimeout(ChannelHandlerContext& ctx) {
 }
 
 void IdleStateHandler::handleAllIdleTimeout(ChannelHandlerContext& ctx) {
-    if (readerIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
+    if (!allIdleTimeout_ || allIdleTimeout_->isCancelled() || !ctx.channel()->isOpen()) {
         return;
     }
 
-    Time currentTime = boost::get_system_time();
+    Time currentTime = CachedClock::now();
     Time lastIoTime = std::max(lastWriteTime_, lastReadTime_);
 
     Duration duration = currentTime - lastIoTime;
@@ -251,8 +283,86 @@ void IdleStateHandler::handleAllIdleTimeout(ChannelHandlerContext& ctx) {
     }
 }
 
+void IdleStateHandler::sweep(const Time& currentTime) {
+    if (!ctx_->channel()->isOpen()) {
+        return;
+    }
+
+    if (readerIdleTimeMillis_ > 0) {
+        Duration idleTime = boost::posix_time::milliseconds(readerIdleTimeMillis_);
+        Time deadline = std::max(readerIdleDeadline_, lastReadTime_ + idleTime);
+
+        if (currentTime >= deadline) {
+            // fire again after another idle time if still idle.
+            readerIdleDeadline_ = currentTime + idleTime;
+            fireIdle(*ctx_,
+                     IdleState::READER_IDLE,
+                     readerIdleCount_++,
+                     currentTime - lastReadTime_);
+        }
+        else {
+            readerIdleDeadline_ = deadline;
+        }
+    }
+
+    // destroyed in the idle event handling, e.g. closed the channel.
+    if (state_ != 1) {
+        return;
+    }
+
+    if (writerIdleTimeMillis_ > 0) {
+        Duration idleTime = boost::posix_time::milliseconds(writerIdleTimeMillis_);
+        Time deadline = std::max(writerIdleDeadline_, lastWriteTime_ + idleTime);
+
+        if (currentTime >= deadline) {
+            writerIdleDeadline_ = currentTime + idleTime;
+            fireIdle(*ctx_,
+                     IdleState::WRITER_IDLE,
+                     writerIdleCount_++,
+                     currentTime - lastWriteTime_);
+        }
+        else {
+            writerIdleDeadline_ = deadline;
+        }
+    }
+
+    if (state_ != 1) {
+        return;
+    }
+
+    if (allIdleTimeMillis_ > 0) {
+        Duration idleTime = boost::posix_time::milliseconds(allIdleTimeMillis_);
+        Time lastIoTime = std::max(lastWriteTime_, lastReadTime_);
+        Time deadline = std::max(allIdleDeadline_, lastIoTime + idleTime);
+
+        if (currentTime >= deadline) {
+            allIdleDeadline_ = currentTime + idleTime;
+            fireIdle(*ctx_,
+                     IdleState::ALL_IDLE,
+                     allIdleCount_++,
+                     currentTime - lastIoTime);
+        }
+        else {
+            allIdleDeadline_ = deadline;
+        }
+    }
+}
+
+void IdleStateHandler::fireIdle(ChannelHandlerContext& ctx,
+                                const IdleState& state,
+                                int count,
+                                const Duration& idleTime) {
+    try {
+        handleIdle(ctx,
+                   IdleStateEvent(state, count, idleTime.total_milliseconds()));
+    }
+    catch (const std::exception& e) {
+        ctx.fireExceptionCaught(ChannelException(e.what()));
+    }
+}
+
 void IdleStateHandler::handleWriteCompleted(const ChannelFuturePtr& future) {
-    lastWriteTime_ = boost::get_system_time();
+    lastWriteTime_ = CachedClock::now();
     writerIdleCount_ = allIdleCount_ = 0;
 }
 
@@ -272,7 +382,7 @@ void IdleStateHandler::channelInactive(ChannelHandlerContext& ctx) {
 }
 
 void IdleStateHandler::messageUpdated(ChannelHandlerContext& ctx) {
-    lastReadTime_ = boost::get_system_time();
+    lastReadTime_ = CachedClock::now();
     readerIdleCount_ = allIdleCount_ = 0;
 
     ctx.fireMessageUpdated();
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/handler/timeout/IdleStateSweeper.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <cetty/channel/Timeout.h>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/handler/timeout/IdleStateHandler.h>
+#include <cetty/util/CachedClock.h>
+
+namespace cetty {
+namespace handler {
+namespace timeout {
+
+using namespace cetty::util;
+
+static boost::thread_specific_ptr<IdleStateSweeper> sweepers;
+
+IdleStateSweeper::IdleStateSweeper(const EventLoopPtr& eventLoop)
+    : sweeping_(false),
+      interval_(0),
+      eventLoop_(eventLoop) {
+}
+
+IdleStateSweeper::~IdleStateSweeper() {
+    if (timeout_) {
+        timeout_->cancel();
+    }
+}
+
+IdleStateSweeper* IdleStateSweeper::current(const EventLoopPtr& eventLoop) {
+    IdleStateSweeper* sweeper = sweepers.get();
+
+    if (!sweeper) {
+        sweeper = new IdleStateSweeper(eventLoop);
+        sweepers.reset(sweeper);
+    }
+
+    return sweeper;
+}
+
+IdleStateSweeper::Handlers::iterator IdleStateSweeper::add(IdleStateHandler* handler) {
+    Handlers::iterator itr = handlers_.insert(handlers_.end(), handler);
+    int64_t interval = handler->sweepIntervalInMillis();
+
+    if (!interval_ || interval < interval_) {
+        interval_ = interval;
+
+        // the shorter interval takes effect now, not after the pending sweep.
+        if (timeout_ && !sweeping_) {
+            timeout_->cancel();
+            timeout_.reset();
+        }
+    }
+
+    if (!timeout_ && !sweeping_) {
+        schedule();
+    }
+
+    return itr;
+}
+
+void IdleStateSweeper::remove(Handlers::iterator itr) {
+    if (sweeping_ && itr == next_) {
+        ++next_;
+    }
+
+    int64_t interval = (*itr)->sweepIntervalInMillis();
+    handlers_.erase(itr);
+
+    if (interval == interval_) {
+        // the shortest one may have gone, the next sweep follows the rest.
+        interval_ = shortestInterval();
+    }
+
+    if (handlers_.empty() && timeout_ && !sweeping_) {
+        timeout_->cancel();
+        timeout_.reset();
+    }
+}
+
+int64_t IdleStateSweeper::shortestInterval() const {
+    int64_t interval = 0;
+    Handlers::const_iterator itr = handlers_.begin();
+
+    for (; itr != handlers_.end(); ++itr) {
+        int64_t handlerInterval = (*itr)->sweepIntervalInMillis();
+
+        if (!interval || handlerInterval < interval) {
+            interval = handlerInterval;
+        }
+    }
+
+    return interval;
+}
+
+void IdleStateSweeper::schedule() {
+    timeout_ = eventLoop_->runAfter(interval_,
+                                    boost::bind(&IdleStateSweeper::sweep, this));
+}
+
+void IdleStateSweeper::sweep() {
+    IdleStateHandler::Time currentTime = CachedClock::now();
+
+    sweeping_ = true;
+    next_ = handlers_.begin();
+
+    while (next_ != handlers_.end()) {
+        IdleStateHandler* handler = *next_;
+        ++next_;
+
+        handler->sweep(currentTime);
+    }
+
+    sweeping_ = false;
+
+    if (handlers_.empty()) {
+        // sleep until the next handler added.
+        timeout_.reset();
+    }
+    else {
+        schedule();
+    }
+}
+
+}
+}
+}
@@ -21,6 +21,7 @@
 
 #include <cetty/channel/Timeout.h>
 #include <cetty/channel/Channel.h>
+#include <cetty/util/CachedClock.h>
 
 namespace cetty {
 namespace handler {
@@ -89,7 +90,7 @@ void ReadTimeoutHandler::initialize(ChannelHandlerContext& ctx) {
                              boost::ref(ctx));
     }
 
-    lastReadTime_ = boost::get_system_time();
+    lastReadTime_ = CachedClock::now();
 
     if (timeoutMillis_ > 0) {
         timeout_ =
@@ -115,7 +116,7 @@ void ReadTimeoutHandler::handleReadTimeout(ChannelHandlerContext& ctx) {
         return;
     }
 
-    Time currentTime = boost::get_system_time();
+    Time currentTime = CachedClock::now();
     Duration duration = currentTime - lastReadTime_;
     boost::int64_t nextDelay = timeoutMillis_ - duration.total_milliseconds();
 
@@ -181,7 +182,7 @@ void ReadTimeoutHandler::channelInactive(ChannelHandlerContext& ctx) {
 }
 
 void ReadTimeoutHandler::messageUpdated(ChannelHandlerContext& ctx) {
-    lastReadTime_ = boost::get_system_time();
+    lastReadTime_ = CachedClock::now();
 
     ctx.fireMessageUpdated();
 }
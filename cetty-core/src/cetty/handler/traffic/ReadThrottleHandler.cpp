@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/handler/traffic/ReadThrottleHandler.h>
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/ChannelConfig.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace handler {
+namespace traffic {
+
+ReadThrottleHandler::ReadThrottleHandler()
+    : context_(NULL) {
+}
+
+ReadThrottleHandler::~ReadThrottleHandler() {
+}
+
+void ReadThrottleHandler::registerTo(Context& ctx) {
+    context_ = &ctx;
+
+    ctx.setChannelWritabilityChangedCallback(boost::bind(
+                &ReadThrottleHandler::writabilityChanged,
+                this,
+                _1));
+
+    ctx.setChannelInactiveCallback(boost::bind(
+                                       &ReadThrottleHandler::channelInactive,
+                                       this,
+                                       _1));
+}
+
+bool ReadThrottleHandler::throttle(const ChannelPtr& source) {
+    if (!context_ || !source) {
+        return false;
+    }
+
+    const ChannelPtr& target = context_->channel();
+
+    // check under the lock, so the resuming of the target thread will not
+    // be missed.
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if (!target || !target->isActive() || target->isWritable()) {
+        return false;
+    }
+
+    if (std::find(pausedChannels_.begin(), pausedChannels_.end(), source)
+            != pausedChannels_.end()) {
+        return true;
+    }
+
+    LOG_DEBUG << "channel " << target->toString()
+              << " is not writable, pause reading from "
+              << source->toString();
+
+    pausedChannels_.push_back(source);
+    pause(source);
+
+    return true;
+}
+
+int ReadThrottleHandler::pausedCount() const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return static_cast<int>(pausedChannels_.size());
+}
+
+void ReadThrottleHandler::writabilityChanged(ChannelHandlerContext& ctx) {
+    if (ctx.channel()->isWritable()) {
+        resumeAll();
+    }
+
+    ctx.fireChannelWritabilityChanged();
+}
+
+void ReadThrottleHandler::channelInactive(ChannelHandlerContext& ctx) {
+    resumeAll();
+    ctx.fireChannelInactive();
+}
+
+void ReadThrottleHandler::resumeAll() {
+    std::vector<ChannelPtr> channels;
+
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        channels.swap(pausedChannels_);
+    }
+
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        resume(channels[i]);
+    }
+}
+
+void ReadThrottleHandler::pause(const ChannelPtr& source) {
+    const EventLoopPtr& eventLoop = source->eventLoop();
+
+    if (eventLoop->inLoopThread()) {
+        source->config().setAutoRead(false);
+    }
+    else {
+        eventLoop->post(boost::bind(&ReadThrottleHandler::pause, source));
+    }
+}
+
+void ReadThrottleHandler::resume(const ChannelPtr& source) {
+    const EventLoopPtr& eventLoop = source->eventLoop();
+
+    if (eventLoop->inLoopThread()) {
+        if (source->isActive()) {
+            source->config().setAutoRead(true);
+            source->read();
+        }
+    }
+    else {
+        eventLoop->post(boost::bind(&ReadThrottleHandler::resume, source));
+    }
+}
+
+}
+}
+}
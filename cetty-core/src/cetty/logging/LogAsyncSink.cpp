@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/logging/LogAsyncSink.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <boost/bind.hpp>
+#include <boost/noncopyable.hpp>
+#include <cetty/util/CurrentThread.h>
+
+namespace cetty {
+namespace logging {
+
+using namespace cetty::util;
+
+static const int MIN_RING_BUFFER_SIZE = 64 * 1024;
+
+// writes the batch out when it grows larger than this.
+static const std::size_t MAX_BATCH_SIZE = 256 * 1024;
+
+// times to yield before sleeping, when blocked on a full ring buffer.
+static const int BLOCKED_SPIN_COUNT = 16;
+
+/**
+ * A single producer / single consumer ring buffer of the variable length
+ * records: [int32 size][int32 level][size bytes, padded to 8 bytes].
+ * A record with a negative size pads the end of the buffer.
+ */
+class LogRingBuffer : private boost::noncopyable {
+public:
+    static const int HEADER_SIZE = 8;
+
+    LogRingBuffer(int capacity)
+        : capacity_(MIN_RING_BUFFER_SIZE),
+          closed_(0),
+          head_(0),
+          tail_(0) {
+        while (capacity_ < capacity) {
+            capacity_ <<= 1;
+        }
+
+        mask_ = capacity_ - 1;
+        buffer_ = new char[capacity_];
+    }
+
+    ~LogRingBuffer() {
+        delete[] buffer_;
+    }
+
+    // the logging thread only.
+    bool offer(int level, const char* data, int size) {
+        int maxSize = capacity_ / 2 - HEADER_SIZE;
+
+        if (size > maxSize) {
+            size = maxSize;
+        }
+
+        int recordSize = HEADER_SIZE + align(size);
+        int64_t tail = tail_.relaxedGet();
+        int offset = static_cast<int>(tail & mask_);
+        int room = capacity_ - offset;
+        int required = room < recordSize ? recordSize + room : recordSize;
+
+        if (tail + required - head_.get() > capacity_) {
+            return false;
+        }
+
+        if (room < recordSize) {
+            writeHeader(offset, -1, 0);
+            tail += room;
+            offset = 0;
+        }
+
+        writeHeader(offset, size, level);
+        memcpy(buffer_ + offset + HEADER_SIZE, data, size);
+
+        tail_.set(tail + recordSize);
+        return true;
+    }
+
+    // the background thread only.
+    template<typename Visitor>
+    int drain(Visitor& visitor) {
+        int count = 0;
+        int64_t head = head_.relaxedGet();
+        int64_t tail = tail_.get();
+
+        while (head < tail) {
+            int offset = static_cast<int>(head & mask_);
+            int size;
+            int level;
+            readHeader(offset, &size, &level);
+
+            if (size < 0) {
+                head += capacity_ - offset;
+                continue;
+            }
+
+            visitor(level, buffer_ + offset + HEADER_SIZE, size);
+            head += HEADER_SIZE + align(size);
+            ++count;
+        }
+
+        head_.set(head);
+        return count;
+    }
+
+    bool isHalfFull() const {
+        return tail_.relaxedGet() - head_.relaxedGet() > capacity_ / 2;
+    }
+
+    bool isEmpty() const {
+        return tail_.get() == head_.relaxedGet();
+    }
+
+    void close() {
+        closed_.set(1);
+    }
+
+    bool isClosed() const {
+        return closed_.get() != 0;
+    }
+
+private:
+    static int align(int size) {
+        return (size + 7) & ~7;
+    }
+
+    void writeHeader(int offset, int size, int level) {
+        memcpy(buffer_ + offset, &size, sizeof(size));
+        memcpy(buffer_ + offset + sizeof(size), &level, sizeof(level));
+    }
+
+    void readHeader(int offset, int* size, int* level) const {
+        memcpy(size, buffer_ + offset, sizeof(*size));
+        memcpy(level, buffer_ + offset + sizeof(*size), sizeof(*level));
+    }
+
+private:
+    int capacity_;
+    int mask_;
+    char* buffer_;
+
+    Atomic<int> closed_;
+    Atomic<int64_t> head_;
+    Atomic<int64_t> tail_;
+};
+
+/**
+ * Lives in the thread specific storage, marks the ring buffer closed when
+ * the logging thread exits, then the background thread will release it
+ * after drained.
+ */
+class LogRingBufferHolder {
+public:
+    LogRingBufferHolder(const boost::shared_ptr<LogRingBuffer>& ringBuffer)
+        : ringBuffer(ringBuffer) {
+    }
+
+    ~LogRingBufferHolder() {
+        ringBuffer->close();
+    }
+
+    boost::shared_ptr<LogRingBuffer> ringBuffer;
+};
+
+class LogBatchAppender {
+public:
+    LogBatchAppender(const std::vector<LogSinkPtr>& sinks,
+                     std::vector<std::string>* batches)
+        : full(false),
+          sinks(sinks),
+          batches(batches) {
+    }
+
+    void operator()(int level, const char* data, int size) {
+        const LogLevel& logLevel = LogLevel::valueOf(level);
+
+        for (std::size_t i = 0; i < sinks.size(); ++i) {
+            if (sinks[i]->isEnabled(logLevel)) {
+                std::string& batch = (*batches)[i];
+                batch.append(data, size);
+
+                if (batch.size() > MAX_BATCH_SIZE) {
+                    full = true;
+                }
+            }
+        }
+    }
+
+    bool full;
+
+private:
+    const std::vector<LogSinkPtr>& sinks;
+    std::vector<std::string>* batches;
+};
+
+LogAsyncSink::OverflowPolicy LogAsyncSink::OverflowPolicy::DROP(0, "DROP");
+LogAsyncSink::OverflowPolicy LogAsyncSink::OverflowPolicy::BLOCK(1, "BLOCK");
+
+LogAsyncSink::OverflowPolicy::OverflowPolicy(int value, const char* name)
+    : cetty::util::Enum<OverflowPolicy>(value, name) {
+    if (markSetDefaultEnum()) {
+        setDefaultEnum(new OverflowPolicy(-1, "UNKNOWN"));
+    }
+}
+
+LogAsyncSink::LogAsyncSink(const LogSinkPtr& sink)
+    : LogSink("LogAsyncSink"),
+      ringBufferSize_(DEFAULT_RING_BUFFER_SIZE),
+      flushInterval_(DEFAULT_FLUSH_INTERVAL),
+      policy_(OverflowPolicy::DROP),
+      reportedDroppedCount_(0) {
+    addLogSink(sink);
+    init();
+}
+
+LogAsyncSink::LogAsyncSink(const LogSinkPtr& sink,
+                           int ringBufferSize,
+                           const OverflowPolicy& policy,
+                           int flushInterval)
+    : LogSink("LogAsyncSink"),
+      ringBufferSize_(ringBufferSize),
+      flushInterval_(flushInterval),
+      policy_(policy),
+      reportedDroppedCount_(0) {
+    if (ringBufferSize_ < MIN_RING_BUFFER_SIZE) {
+        ringBufferSize_ = MIN_RING_BUFFER_SIZE;
+    }
+
+    if (flushInterval_ <= 0) {
+        flushInterval_ = DEFAULT_FLUSH_INTERVAL;
+    }
+
+    if (policy_ != OverflowPolicy::BLOCK) {
+        policy_ = OverflowPolicy::DROP;
+    }
+
+    addLogSink(sink);
+    init();
+}
+
+LogAsyncSink::~LogAsyncSink() {
+    stop();
+}
+
+void LogAsyncSink::init() {
+    thread_.reset(new boost::thread(boost::bind(&LogAsyncSink::run, this)));
+}
+
+void LogAsyncSink::addLogSink(const LogSinkPtr& sink) {
+    if (!sink) {
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(drainMutex_);
+    sinks_.push_back(sink);
+    batches_.resize(sinks_.size());
+}
+
+void LogAsyncSink::stop() {
+    if (!stopped_.compareAndSet(0, 1)) {
+        return;
+    }
+
+    wakeup();
+
+    if (thread_) {
+        thread_->join();
+    }
+
+    drain();
+}
+
+void LogAsyncSink::doSink(const LogMessage& msg) {
+    const char* buffer = msg.buffer();
+    int size = static_cast<int>(strlen(buffer));
+
+    if (stopped_.relaxedGet()) {
+        boost::mutex::scoped_lock lock(drainMutex_);
+        LogBatchAppender appender(sinks_, &batches_);
+        appender(msg.level().value(), buffer, size);
+        writtenCount_.incrementAndGet();
+        writeBatches(false);
+        return;
+    }
+
+    LogRingBuffer* ringBuffer = currentRingBuffer();
+    int level = msg.level().value();
+
+    if (!ringBuffer->offer(level, buffer, size)) {
+        if (policy_ == OverflowPolicy::DROP) {
+            droppedCount_.incrementAndGet();
+            wakeup();
+            return;
+        }
+
+        blockedCount_.incrementAndGet();
+
+        for (int i = 0; !ringBuffer->offer(level, buffer, size); ++i) {
+            if (stopped_.relaxedGet()) {
+                droppedCount_.incrementAndGet();
+                return;
+            }
+
+            wakeup();
+
+            if (i < BLOCKED_SPIN_COUNT) {
+                CurrentThread::yield();
+            }
+            else {
+                CurrentThread::sleep(1);
+            }
+        }
+    }
+
+    if (ringBuffer->isHalfFull()) {
+        wakeup();
+    }
+}
+
+void LogAsyncSink::doSink(const char* messages, int size) {
+    boost::mutex::scoped_lock lock(drainMutex_);
+
+    for (std::size_t i = 0; i < sinks_.size(); ++i) {
+        sinks_[i]->sink(messages, size);
+    }
+}
+
+void LogAsyncSink::doFlush() {
+    drain();
+}
+
+void LogAsyncSink::run() {
+    boost::posix_time::milliseconds interval(flushInterval_);
+
+    while (!stopped_.get()) {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+
+            if (!wakeupPending_.get() && !stopped_.get()) {
+                cond_.timed_wait(lock, interval);
+            }
+        }
+
+        wakeupPending_.set(0);
+        drain();
+    }
+}
+
+void LogAsyncSink::wakeup() {
+    if (wakeupPending_.compareAndSet(0, 1)) {
+        boost::mutex::scoped_lock lock(mutex_);
+        cond_.notify_one();
+    }
+}
+
+LogRingBuffer* LogAsyncSink::currentRingBuffer() {
+    LogRingBufferHolder* holder = threadRingBuffer_.get();
+
+    if (!holder) {
+        LogRingBufferPtr ringBuffer(new LogRingBuffer(ringBufferSize_));
+        holder = new LogRingBufferHolder(ringBuffer);
+        threadRingBuffer_.reset(holder);
+
+        boost::mutex::scoped_lock lock(ringBuffersMutex_);
+        ringBuffers_.push_back(ringBuffer);
+    }
+
+    return holder->ringBuffer.get();
+}
+
+void LogAsyncSink::drain() {
+    boost::mutex::scoped_lock lock(drainMutex_);
+
+    std::vector<LogRingBufferPtr> ringBuffers;
+    {
+        boost::mutex::scoped_lock lock(ringBuffersMutex_);
+        ringBuffers = ringBuffers_;
+    }
+
+    int64_t dropped = droppedCount_.get();
+
+    if (dropped > reportedDroppedCount_) {
+        char report[128];
+        int size = snprintf(report,
+                            sizeof(report),
+                            "LogAsyncSink dropped %lld log messages, "
+                            "the ring buffers were full.\n",
+                            static_cast<long long>(dropped - reportedDroppedCount_));
+
+        LogBatchAppender appender(sinks_, &batches_);
+        appender(LogLevel::WARN.value(), report, size);
+        reportedDroppedCount_ = dropped;
+    }
+
+    LogBatchAppender appender(sinks_, &batches_);
+    bool hasClosed = false;
+
+    for (std::size_t i = 0; i < ringBuffers.size(); ++i) {
+        // closed before draining, so nothing will be offered after drained.
+        bool closed = ringBuffers[i]->isClosed();
+        writtenCount_.addAndGet(ringBuffers[i]->drain(appender));
+        hasClosed = hasClosed || closed;
+
+        if (appender.full) {
+            writeBatches(false);
+            appender.full = false;
+        }
+    }
+
+    writeBatches(true);
+
+    if (hasClosed) {
+        boost::mutex::scoped_lock lock(ringBuffersMutex_);
+        std::vector<LogRingBufferPtr>::iterator itr = ringBuffers_.begin();
+
+        while (itr != ringBuffers_.end()) {
+            if ((*itr)->isClosed() && (*itr)->isEmpty()) {
+                itr = ringBuffers_.erase(itr);
+            }
+            else {
+                ++itr;
+            }
+        }
+    }
+}
+
+void LogAsyncSink::writeBatches(bool flush) {
+    for (std::size_t i = 0; i < sinks_.size(); ++i) {
+        std::string& batch = batches_[i];
+
+        if (!batch.empty()) {
+            sinks_[i]->sink(batch.data(), static_cast<int>(batch.size()));
+            batch.clear();
+        }
+
+        if (flush) {
+            sinks_[i]->flush();
+        }
+    }
+}
+
+}
+}
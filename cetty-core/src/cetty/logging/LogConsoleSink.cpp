@@ -29,6 +29,10 @@ void LogConsoleSink::doSink(const LogMessage& msg) {
                 logToStdErr_ ? stderr : stdout);
 }
 
+void LogConsoleSink::doSink(const char* messages, int size) {
+    std::fwrite(messages, size, 1, logToStdErr_ ? stderr : stdout);
+}
+
 void LogConsoleSink::doFlush() {
     std::fflush(logToStdErr_ ? stderr : stdout);
 }
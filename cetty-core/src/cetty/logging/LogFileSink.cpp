@@ -85,6 +85,15 @@ LogFileSink::LogFileSink(const std::string& baseName,
 }
 
 void LogFileSink::doSink(const LogMessage& msg) {
+    const char* buf = msg.buffer();
+    write(buf, static_cast<int>(strlen(buf)));
+}
+
+void LogFileSink::doSink(const char* messages, int size) {
+    write(messages, size);
+}
+
+void LogFileSink::write(const char* data, int dataSize) {
     int64_t size = logSize();
 
     if (size > rollSize_) {
@@ -100,8 +109,7 @@ void LogFileSink::doSink(const LogMessage& msg) {
         }
     }
 
-    const char* buf = msg.buffer();
-    std::fwrite(buf, strlen(buf), 1, fp_);
+    std::fwrite(data, dataSize, 1, fp_);
 
     int errCode = 0;
     errCode = ferror(fp_);
@@ -29,6 +29,17 @@ const LogLevel LogLevel::INFO(2, "INFO");
 const LogLevel LogLevel::DEBUG(1, "DEBUG");
 const LogLevel LogLevel::TRACE(0, "TRACE");
 
+const LogLevel& LogLevel::valueOf(int value) {
+    switch (value) {
+    case 0: return TRACE;
+    case 1: return DEBUG;
+    case 2: return INFO;
+    case 3: return WARN;
+    case 4: return ERROR;
+    default: return FATAL;
+    }
+}
+
 LogLevel::LogLevel(int v, const char* name)
     : cetty::util::Enum<LogLevel>(v, name) {
     if (markSetDefaultEnum()) {
@@ -17,6 +17,7 @@
 
 #include <cetty/logging/LogMessage.h>
 #include <cetty/logging/Logger.h>
+#include <cetty/util/CachedClock.h>
 
 namespace cetty {
 namespace logging {
@@ -32,13 +33,9 @@ LogMessage::LogMessage(const LogLevel& level,
       level_(level),
       stream_(static_cast<char*>(buffer_), MAX_LOG_MESSAGE_LEN) {
 
-    if (level < Logger::level()) {
-        return;
-    }
-
     memset(buffer_, 0, sizeof(buffer_));
 
-    timestamp_ = boost::posix_time::microsec_clock::universal_time();
+    timestamp_ = CachedClock::now();
     tid_ = CurrentThread::id();
 
     Logger::patternFormatter().formatFirst(*this);
@@ -51,23 +48,15 @@ LogMessage::LogMessage(const LogLevel& level, const char* source, int line, cons
       level_(level),
       stream_(static_cast<char*>(buffer_), MAX_LOG_MESSAGE_LEN) {
 
-    if (level < Logger::level()) {
-        return;
-    }
-
     memset(buffer_, 0, sizeof(buffer_));
 
-    timestamp_ = boost::posix_time::microsec_clock::universal_time();
+    timestamp_ = CachedClock::now();
     tid_ = CurrentThread::id();
 
     Logger::patternFormatter().formatFirst(*this);
 }
 
 bool LogMessage::finish() {
-    if (level_ < Logger::level()) {
-        return false;
-    }
-
     Logger::patternFormatter().formatLast(*this);
     stream_ << "\n";
 
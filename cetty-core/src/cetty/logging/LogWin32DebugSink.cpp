@@ -33,6 +33,14 @@ void LogWin32DebugSink::doSink(const LogMessage& msg) {
 #endif
 }
 
+void LogWin32DebugSink::doSink(const char* messages, int size) {
+#if defined(WIN32) && (defined(_DEBUG) || defined(DEBUG))
+    std::wstring out;
+    ::cetty::util::StringUtil::utftoucs(std::string(messages, size), &out);
+    ::OutputDebugString(out.c_str());
+#endif
+}
+
 void LogWin32DebugSink::doFlush() {
     // NOOP
 }
@@ -18,6 +18,9 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <boost/thread/mutex.hpp>
 
 #include <cetty/util/StringUtil.h>
 #include <cetty/logging/LogConsoleSink.h>
@@ -25,10 +28,80 @@
 namespace cetty {
 namespace logging {
 
+using namespace cetty::util;
+
 LogLevel Logger::level_ = LogLevel::DEBUG;
+Atomic<int> Logger::levelValue_(LogLevel::DEBUG.value());
 LogPatternFormatter* Logger::formatter = NULL;
 std::vector<LogSinkPtr> Logger::sinks_;
 
+/**
+ * The levels of the modules, never be released, so the call sites can
+ * cache the pointers.
+ */
+class LogModuleLevels {
+public:
+    struct ModuleLevel {
+        bool explicitly;
+        Atomic<int> level;
+
+        ModuleLevel(int level) : explicitly(false), level(level) {}
+    };
+
+    typedef std::map<std::string, ModuleLevel*> ModuleLevels;
+
+    // not destroyed at exit either, the static objects still log
+    // in their destructors.
+    static LogModuleLevels& instance() {
+        static LogModuleLevels* levels = new LogModuleLevels;
+        return *levels;
+    }
+
+    ModuleLevel* get(const std::string& module, int defaultLevel) {
+        boost::mutex::scoped_lock lock(mutex);
+        ModuleLevels::iterator itr = levels.find(module);
+
+        if (itr != levels.end()) {
+            return itr->second;
+        }
+
+        ModuleLevel* level = new ModuleLevel(defaultLevel);
+        levels.insert(std::make_pair(module, level));
+        return level;
+    }
+
+    void set(const std::string& module, int level) {
+        ModuleLevel* moduleLevel = get(module, level);
+
+        boost::mutex::scoped_lock lock(mutex);
+        moduleLevel->explicitly = true;
+        moduleLevel->level.set(level);
+    }
+
+    void reset(const std::string& module, int defaultLevel) {
+        ModuleLevel* moduleLevel = get(module, defaultLevel);
+
+        boost::mutex::scoped_lock lock(mutex);
+        moduleLevel->explicitly = false;
+        moduleLevel->level.set(defaultLevel);
+    }
+
+    void setDefault(int level) {
+        boost::mutex::scoped_lock lock(mutex);
+        ModuleLevels::iterator itr = levels.begin();
+
+        for (; itr != levels.end(); ++itr) {
+            if (!itr->second->explicitly) {
+                itr->second->level.set(level);
+            }
+        }
+    }
+
+private:
+    boost::mutex mutex;
+    ModuleLevels levels;
+};
+
 Logger::Logger(SourceFile file, int line)
     : message_(LogLevel::INFO, file.data(), line) {
 }
@@ -63,6 +136,77 @@ Logger::~Logger() {
     }
 }
 
+void Logger::setLevel(const LogLevel& level) {
+    Logger::level_ = level;
+    levelValue_.set(level.value());
+    LogModuleLevels::instance().setDefault(level.value());
+}
+
+const LogLevel& Logger::level(const std::string& module) {
+    return LogLevel::valueOf(moduleLevel(module)->get());
+}
+
+void Logger::setLevel(const std::string& module, const LogLevel& level) {
+    if (module.empty()) {
+        setLevel(level);
+    }
+    else {
+        LogModuleLevels::instance().set(module, level.value());
+    }
+}
+
+void Logger::resetLevel(const std::string& module) {
+    if (!module.empty()) {
+        LogModuleLevels::instance().reset(module, levelValue_.get());
+    }
+}
+
+const Atomic<int>* Logger::moduleLevel(const std::string& module) {
+    if (module.empty()) {
+        return &levelValue_;
+    }
+
+    return &LogModuleLevels::instance().get(module, levelValue_.get())->level;
+}
+
+const Atomic<int>* Logger::moduleLevelOfFile(const char* file) {
+    return moduleLevel(moduleOfFile(file));
+}
+
+std::string Logger::moduleOfFile(const char* file) {
+    if (!file) {
+        return std::string();
+    }
+
+    // the last "cetty/" directory in the path, "cetty-core/" not included.
+    const char* module = NULL;
+
+    for (const char* p = file; *p; ++p) {
+        if ((p == file || p[-1] == '/' || p[-1] == '\\')
+                && strncmp(p, "cetty", 5) == 0
+                && (p[5] == '/' || p[5] == '\\')) {
+            module = p + 6;
+        }
+    }
+
+    if (!module) {
+        return std::string();
+    }
+
+    const char* end = module;
+
+    while (*end && *end != '/' && *end != '\\') {
+        ++end;
+    }
+
+    // a file right under the cetty directory has no module.
+    if (!*end) {
+        return std::string();
+    }
+
+    return std::string(module, end - module);
+}
+
 void Logger::addLogSink(const LogSinkPtr& sink) {
     if (sink) {
         sinks_.push_back(sink);
@@ -0,0 +1,88 @@
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/util/CachedClock.h>
+
+#include <boost/thread/tss.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace cetty {
+namespace util {
+
+using namespace boost::posix_time;
+
+struct CachedTime {
+    bool valid;
+    ptime time;
+
+    CachedTime() : valid(false) {}
+
+    const ptime& get() {
+        if (!valid) {
+            time = microsec_clock::universal_time();
+            valid = true;
+        }
+
+        return time;
+    }
+};
+
+static boost::thread_specific_ptr<CachedTime> cachedTime;
+static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+
+ptime CachedClock::now() {
+    CachedTime* cached = cachedTime.get();
+
+    if (cached) {
+        return cached->get();
+    }
+
+    return microsec_clock::universal_time();
+}
+
+int64_t CachedClock::nowInMillis() {
+    return (now() - epoch).total_milliseconds();
+}
+
+int64_t CachedClock::nowInMicros() {
+    return (now() - epoch).total_microseconds();
+}
+
+void CachedClock::enable() {
+    if (!cachedTime.get()) {
+        cachedTime.reset(new CachedTime);
+    }
+}
+
+void CachedClock::disable() {
+    cachedTime.reset();
+}
+
+bool CachedClock::isEnabled() {
+    return cachedTime.get() != NULL;
+}
+
+void CachedClock::invalidate() {
+    CachedTime* cached = cachedTime.get();
+
+    if (cached) {
+        cached->valid = false;
+    }
+}
+
+}
+}
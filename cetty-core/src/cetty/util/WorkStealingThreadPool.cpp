@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/util/WorkStealingThreadPool.h>
+
+#include <boost/bind.hpp>
+
+#include <cetty/util/CachedClock.h>
+#include <cetty/logging/LoggerHelper.h>
+
+namespace cetty {
+namespace util {
+
+struct WorkerIdentity {
+    const WorkStealingThreadPool* pool;
+    int index;
+
+    WorkerIdentity(const WorkStealingThreadPool* pool, int index)
+        : pool(pool), index(index) {}
+};
+
+static boost::thread_specific_ptr<WorkerIdentity> currentIdentity;
+
+WorkStealingThreadPool::WorkStealingThreadPool(int threadCount,
+        int maxQueuedTasks)
+    : maxQueuedTasks_(maxQueuedTasks),
+      idleWorkers_(0),
+      stopped_(0) {
+    if (threadCount <= 0) {
+        threadCount = boost::thread::hardware_concurrency();
+        LOG_WARN << "the worker thread count is not positive,"
+                 " instead of the cpu number: " << threadCount;
+    }
+
+    if (maxQueuedTasks_ <= 0) {
+        maxQueuedTasks_ = MAX_INT32;
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        workers_.push_back(new Worker);
+    }
+
+    // all the queues exist before any worker starts to steal.
+    for (int i = 0; i < threadCount; ++i) {
+        workers_[i].thread.reset(new boost::thread(
+                                     boost::bind(&WorkStealingThreadPool::run,
+                                                 this,
+                                                 i)));
+    }
+
+    LOG_INFO << "started the work stealing thread pool with "
+             << threadCount << " workers, at most "
+             << maxQueuedTasks_ << " queued tasks.";
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stop();
+}
+
+bool WorkStealingThreadPool::submit(const Task& task) {
+    int index = currentWorker();
+
+    if (index < 0 && !workers_.empty()) {
+        unsigned int next = static_cast<unsigned int>(nextWorker_.getAndAdd(1));
+        index = static_cast<int>(next % workers_.size());
+    }
+
+    Entry entry;
+    entry.task = task;
+    entry.queuedTime = CachedClock::nowInMicros();
+
+    if (index < 0 || stopped_.get()) {
+        rejected_.incrementAndGet();
+        return false;
+    }
+
+    // takes a place in the bounded queues.
+    int queued = queued_.get();
+
+    while (queued < maxQueuedTasks_
+            && !queued_.compareAndSet(queued, queued + 1)) {
+        queued = queued_.get();
+    }
+
+    if (queued >= maxQueuedTasks_) {
+        rejected_.incrementAndGet();
+        return false;
+    }
+
+    // checked again after the task is counted, a worker exits only when
+    // it sees the stop and no task counted, so the task is not left.
+    if (stopped_.get()) {
+        queued_.decrementAndGet();
+        rejected_.incrementAndGet();
+        return false;
+    }
+
+    submitted_.incrementAndGet();
+
+    {
+        Worker& worker = workers_[index];
+        boost::lock_guard<boost::mutex> lock(worker.mutex);
+        worker.tasks.push_back(entry);
+    }
+
+    // a worker counts itself idle before checking the queued tasks, and
+    // the task is counted before here, so either the worker sees the task,
+    // or it is seen idle here and waked up.
+    if (idleWorkers_.get() > 0) {
+        boost::lock_guard<boost::mutex> lock(idleMutex_);
+        idleCondition_.notify_one();
+    }
+
+    return true;
+}
+
+void WorkStealingThreadPool::stop() {
+    {
+        boost::lock_guard<boost::mutex> lock(idleMutex_);
+
+        if (stopped_.getAndSet(1)) {
+            return;
+        }
+
+        idleCondition_.notify_all();
+    }
+
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        boost::shared_ptr<boost::thread>& thread = workers_[i].thread;
+
+        if (thread && thread->get_id() != boost::this_thread::get_id()) {
+            thread->join();
+        }
+    }
+
+    LOG_INFO << "the work stealing thread pool stopped, "
+             << executed_.get() << " tasks executed, "
+             << rejected_.get() << " rejected.";
+}
+
+void WorkStealingThreadPool::statistics(Statistics* statistics) const {
+    if (!statistics) {
+        return;
+    }
+
+    statistics->submitted = submitted_.get();
+    statistics->rejected = rejected_.get();
+    statistics->executed = executed_.get();
+    statistics->stolen = stolen_.get();
+    statistics->queued = queued_.get();
+    statistics->totalWaitTime = totalWaitTime_.get();
+    statistics->maxWaitTime = maxWaitTime_.get();
+}
+
+void WorkStealingThreadPool::run(int index) {
+    currentIdentity.reset(new WorkerIdentity(this, index));
+
+    Entry entry;
+
+    while (true) {
+        if (pop(index, &entry) || steal(index, &entry)) {
+            execute(entry);
+            entry.task.clear();
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(idleMutex_);
+        idleWorkers_.incrementAndGet();
+
+        // a task counted but not queued yet is taken in the next round.
+        if (queued_.get() > 0) {
+            idleWorkers_.decrementAndGet();
+            continue;
+        }
+
+        // the queued tasks are all done before exit.
+        if (stopped_.get()) {
+            idleWorkers_.decrementAndGet();
+            break;
+        }
+
+        idleCondition_.wait(lock);
+        idleWorkers_.decrementAndGet();
+    }
+
+    currentIdentity.reset();
+}
+
+bool WorkStealingThreadPool::pop(int index, Entry* entry) {
+    Worker& worker = workers_[index];
+    boost::lock_guard<boost::mutex> lock(worker.mutex);
+
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    *entry = worker.tasks.front();
+    worker.tasks.pop_front();
+    queued_.decrementAndGet();
+    return true;
+}
+
+bool WorkStealingThreadPool::steal(int index, Entry* entry) {
+    int count = static_cast<int>(workers_.size());
+
+    for (int i = 1; i < count; ++i) {
+        Worker& victim = workers_[(index + i) % count];
+        boost::lock_guard<boost::mutex> lock(victim.mutex);
+
+        // the victim runs its oldest tasks, the thief takes the newest.
+        if (!victim.tasks.empty()) {
+            *entry = victim.tasks.back();
+            victim.tasks.pop_back();
+            queued_.decrementAndGet();
+            stolen_.incrementAndGet();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingThreadPool::execute(const Entry& entry) {
+    int64_t waitTime = CachedClock::nowInMicros() - entry.queuedTime;
+
+    if (waitTime > 0) {
+        totalWaitTime_.addAndGet(waitTime);
+
+        int64_t maxWaitTime = maxWaitTime_.get();
+
+        while (waitTime > maxWaitTime
+                && !maxWaitTime_.compareAndSet(maxWaitTime, waitTime)) {
+            maxWaitTime = maxWaitTime_.get();
+        }
+    }
+
+    try {
+        entry.task();
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR << "the task in the work stealing thread pool threw: "
+                  << e.what();
+    }
+    catch (...) {
+        LOG_ERROR << "the task in the work stealing thread pool threw"
+                  " an unknown exception.";
+    }
+
+    executed_.incrementAndGet();
+}
+
+int WorkStealingThreadPool::currentWorker() const {
+    WorkerIdentity* identity = currentIdentity.get();
+    return identity && identity->pool == this ? identity->index : -1;
+}
+
+}
+}
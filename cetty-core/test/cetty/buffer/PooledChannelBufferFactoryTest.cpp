@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+#include <cetty/buffer/ChannelBuffer.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+
+using namespace cetty::buffer;
+
+TEST(PooledChannelBufferFactoryTest, testSizeClass) {
+    ASSERT_EQ(16, PooledChannelBufferFactory::sizeClass(1));
+    ASSERT_EQ(128, PooledChannelBufferFactory::sizeClass(128));
+    ASSERT_EQ(160, PooledChannelBufferFactory::sizeClass(129));
+    ASSERT_EQ(1024, PooledChannelBufferFactory::sizeClass(1000));
+    ASSERT_EQ(16 * 1024, PooledChannelBufferFactory::sizeClass(16 * 1024));
+
+    int huge = PooledChannelBufferFactory::MAX_POOLED_SIZE + 1;
+    ASSERT_EQ(huge, PooledChannelBufferFactory::sizeClass(huge));
+}
+
+TEST(PooledChannelBufferFactoryTest, testReuseBlock) {
+    PooledChannelBufferFactory::Statistics before;
+    PooledChannelBufferFactory::threadStatistics(&before);
+
+    for (int i = 0; i < 10; ++i) {
+        ChannelBufferPtr buffer = PooledChannelBufferFactory::buffer(1000);
+        buffer->writeBytes("hello", 5);
+        ASSERT_EQ(1024, buffer->capacity());
+        ASSERT_EQ(5, buffer->readableBytes());
+    }
+
+    PooledChannelBufferFactory::Statistics after;
+    PooledChannelBufferFactory::threadStatistics(&after);
+
+    ASSERT_EQ(9, after.hits - before.hits);
+    ASSERT_EQ(1024, after.residentBytes - before.residentBytes);
+}
+
+TEST(PooledChannelBufferFactoryTest, testExpandKeepsContent) {
+    ChannelBufferPtr buffer = PooledChannelBufferFactory::buffer(16);
+    buffer->writeBytes("0123456789", 10);
+    buffer->ensureWritableBytes(4096);
+
+    ASSERT_TRUE(buffer->capacity() >= 4106);
+    ASSERT_EQ(10, buffer->readableBytes());
+    ASSERT_EQ('9', buffer->getByte(9));
+}
+
+static void releaseBuffer(ChannelBufferPtr* buffer) {
+    buffer->reset();
+}
+
+TEST(PooledChannelBufferFactoryTest, testReleaseInOtherThread) {
+    ChannelBufferPtr buffer = PooledChannelBufferFactory::buffer(2048);
+
+    boost::thread thread(boost::bind(&releaseBuffer, &buffer));
+    thread.join();
+
+    PooledChannelBufferFactory::Statistics before;
+    PooledChannelBufferFactory::threadStatistics(&before);
+
+    buffer = PooledChannelBufferFactory::buffer(2048);
+
+    PooledChannelBufferFactory::Statistics after;
+    PooledChannelBufferFactory::threadStatistics(&after);
+
+    ASSERT_EQ(1, after.hits - before.hits);
+}
@@ -4,3 +4,17 @@ using namespace cetty::buffer;
 
 #define CHANNEL_BUFFER_IMPL_TEST SlicedChannelBufferTest
 #include "cetty/buffer/AbstractChannelBufferTest.inc.h"
+
+TEST(SlicedChannelBufferReadableBytesTest, testWrappedBufferReadFrom) {
+    ChannelBufferPtr wrapped = Unpooled::copiedBuffer(std::string("0123456789"));
+    wrapped->readerIndex(4);
+
+    ChannelBufferPtr slice = wrapped->slice(2, 6);
+    slice->readerIndex(1);
+
+    int length;
+    const char* bytes = slice->readableBytes(&length);
+
+    ASSERT_EQ(5, length);
+    ASSERT_EQ(std::string("34567"), std::string(bytes, length));
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include <cetty/channel/ReceiveBufferSizePredictor.h>
+
+using namespace cetty::channel;
+
+TEST(AdaptiveReceiveBufferSizePredictorTest, testGrowOnFullRead) {
+    AdaptiveReceiveBufferSizePredictor predictor(64, 1024, 256 * 1024);
+    ASSERT_EQ(1024, predictor.nextReceiveBufferSize());
+
+    predictor.previousReceiveBufferSize(1024);
+    ASSERT_EQ(16 * 1024, predictor.nextReceiveBufferSize());
+
+    for (int i = 0; i < 10; ++i) {
+        predictor.previousReceiveBufferSize(predictor.nextReceiveBufferSize());
+    }
+
+    ASSERT_EQ(256 * 1024, predictor.nextReceiveBufferSize());
+}
+
+TEST(AdaptiveReceiveBufferSizePredictorTest, testShrinkOnTwoSmallReads) {
+    AdaptiveReceiveBufferSizePredictor predictor(64, 1024, 256 * 1024);
+
+    predictor.previousReceiveBufferSize(10);
+    ASSERT_EQ(1024, predictor.nextReceiveBufferSize());
+
+    predictor.previousReceiveBufferSize(10);
+    ASSERT_EQ(512, predictor.nextReceiveBufferSize());
+
+    for (int i = 0; i < 100; ++i) {
+        predictor.previousReceiveBufferSize(10);
+    }
+
+    ASSERT_EQ(64, predictor.nextReceiveBufferSize());
+}
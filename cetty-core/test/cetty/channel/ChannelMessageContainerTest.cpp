@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/asio/AsioService.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+static const int MESSAGE_COUNT = 64;
+
+static std::string messageAt(int index) {
+    return std::string(100 + index, static_cast<char>('a' + index % 26));
+}
+
+// what the writer does in a flush, takes all the readable bytes.
+static void flush(ChannelBufferContainer* container, std::string* received) {
+    const ChannelBufferPtr& buffer = container->getMessages();
+
+    if (buffer && buffer->readable()) {
+        std::string bytes;
+        buffer->readBytes(&bytes);
+        received->append(bytes);
+    }
+}
+
+// writes and flushes every message, as ChannelPipeline::write does.
+static void writeAll(const EventLoopPtr& eventLoop,
+                     ChannelBufferContainer* container,
+                     std::string* received) {
+    for (int i = 0; i < MESSAGE_COUNT; ++i) {
+        container->addMessage(Unpooled::copiedBuffer(messageAt(i)));
+        eventLoop->post(boost::bind(&flush, container, received));
+    }
+}
+
+// only adds the messages, the flushes are posted after all of them.
+static void addAll(ChannelBufferContainer* container) {
+    for (int i = 0; i < MESSAGE_COUNT; ++i) {
+        container->addMessage(Unpooled::copiedBuffer(messageAt(i)));
+    }
+}
+
+class ChannelMessageContainerTest : public testing::Test {
+public:
+    ChannelMessageContainerTest()
+        : service(new AsioService(EventLoopPoolPtr())) {
+        service->setThreadId(CurrentThread::id());
+
+        for (int i = 0; i < MESSAGE_COUNT; ++i) {
+            expected += messageAt(i);
+        }
+    }
+
+    void writeInOtherThread(ChannelBufferContainer* container,
+                            std::string* received) {
+        boost::thread writer(boost::bind(&writeAll,
+                                         EventLoopPtr(service),
+                                         container,
+                                         received));
+        writer.join();
+
+        service->service().run();
+    }
+
+    // N messages added out of the loop only post one drain.
+    void addInOtherThread(ChannelBufferContainer* container,
+                          std::string* received) {
+        boost::thread writer(boost::bind(&addAll, container));
+        writer.join();
+
+        ASSERT_EQ(1, service->pendingTaskCount());
+
+        for (int i = 0; i < MESSAGE_COUNT; ++i) {
+            service->post(boost::bind(&flush, container, received));
+        }
+
+        service->service().run();
+    }
+
+    AsioServicePtr service;
+    std::string expected;
+};
+
+TEST_F(ChannelMessageContainerTest, testBuffersFromOtherThread) {
+    ChannelBufferContainer container;
+    std::string received;
+
+    container.setEventLoop(service);
+    writeInOtherThread(&container, &received);
+
+    ASSERT_EQ(expected.size(), received.size());
+    ASSERT_EQ(expected, received);
+    ASSERT_TRUE(container.empty());
+}
+
+TEST_F(ChannelMessageContainerTest, testAccumulatedBuffersFromOtherThread) {
+    ChannelBufferContainer container(true);
+    std::string received;
+
+    container.setEventLoop(service);
+    writeInOtherThread(&container, &received);
+
+    ASSERT_EQ(expected, received);
+    ASSERT_TRUE(container.empty());
+}
+
+TEST_F(ChannelMessageContainerTest, testSetAccumulated) {
+    ChannelBufferContainer container;
+    container.setEventLoop(service);
+
+    container.addMessage(Unpooled::copiedBuffer(messageAt(0)));
+    container.setAccumulated();
+    container.addMessage(Unpooled::copiedBuffer(messageAt(1)));
+
+    ASSERT_TRUE(container.accumulated());
+
+    std::string received;
+    flush(&container, &received);
+    ASSERT_EQ(messageAt(0) + messageAt(1), received);
+}
+
+TEST_F(ChannelMessageContainerTest, testOneWakeupForBuffers) {
+    ChannelBufferContainer container;
+    std::string received;
+
+    container.setEventLoop(service);
+    addInOtherThread(&container, &received);
+
+    ASSERT_EQ(expected, received);
+    ASSERT_TRUE(container.empty());
+}
+
+TEST_F(ChannelMessageContainerTest, testOneWakeupForAccumulatedBuffers) {
+    ChannelBufferContainer container(true);
+    std::string received;
+
+    container.setEventLoop(service);
+    addInOtherThread(&container, &received);
+
+    ASSERT_EQ(expected, received);
+    ASSERT_TRUE(container.empty());
+}
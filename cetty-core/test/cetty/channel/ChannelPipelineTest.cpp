@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <boost/bind.hpp>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioService.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+class PipelineTestHandler {
+public:
+    typedef ChannelMessageHandlerContext<PipelineTestHandler,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer> Context;
+
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    void registerTo(Context& ctx) {}
+};
+
+/**
+ * a channel which is the head of its pipeline once opened.
+ */
+class PipelineTestChannel : public Channel {
+public:
+    typedef ChannelMessageHandlerContext<PipelineTestChannel*,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer> Context;
+
+public:
+    PipelineTestChannel(const EventLoopPtr& eventLoop)
+        : Channel(ChannelPtr(), eventLoop) {
+    }
+
+    virtual ~PipelineTestChannel() {}
+
+    void registerTo(Context& context) {
+        Channel::registerTo(context);
+    }
+
+    void activate() {
+        open();
+        setActived();
+    }
+
+protected:
+    virtual bool doBind(const InetAddress& localAddress) { return true; }
+    virtual bool doDisconnect() { return true; }
+    virtual bool doClose() { return true; }
+
+    virtual void doPreOpen() {
+        pipeline().setHead<PipelineTestChannel*>("head", this);
+    }
+};
+
+class ChannelPipelineTest : public testing::Test {
+public:
+    ChannelPipelineTest()
+        : service(new AsioService(EventLoopPoolPtr())) {
+        service->setThreadId(CurrentThread::id());
+
+        channel.reset(new PipelineTestChannel(service));
+        channel->activate();
+    }
+
+    ChannelPipeline& pipeline() {
+        return channel->pipeline();
+    }
+
+    static PipelineTestHandler::HandlerPtr newHandler() {
+        return PipelineTestHandler::HandlerPtr(new PipelineTestHandler);
+    }
+
+    // the names from the head to the tail, checking the links back.
+    std::string forward() {
+        std::string names;
+        ChannelHandlerContext* prev = NULL;
+        ChannelHandlerContext* ctx = pipeline().head();
+
+        for (; ctx; prev = ctx, ctx = ctx->next()) {
+            EXPECT_EQ(prev, ctx->prev()) << "at " << ctx->name();
+            names += names.empty() ? ctx->name() : "," + ctx->name();
+        }
+
+        EXPECT_EQ(prev, pipeline().tail());
+        return names;
+    }
+
+    // the names from the tail to the head.
+    std::string backward() {
+        std::string names;
+        ChannelHandlerContext* ctx = pipeline().tail();
+
+        for (; ctx; ctx = ctx->prev()) {
+            names = names.empty() ? ctx->name() : ctx->name() + "," + names;
+        }
+
+        return names;
+    }
+
+    AsioServicePtr service;
+    boost::shared_ptr<PipelineTestChannel> channel;
+};
+
+TEST_F(ChannelPipelineTest, testAddFirst) {
+    ASSERT_TRUE(pipeline().addFirst<PipelineTestHandler>("a", newHandler()));
+    ASSERT_EQ("head,a", forward());
+    ASSERT_EQ("head,a", backward());
+
+    ASSERT_TRUE(pipeline().addFirst<PipelineTestHandler>("b", newHandler()));
+    ASSERT_EQ("head,b,a", forward());
+    ASSERT_EQ("head,b,a", backward());
+}
+
+TEST_F(ChannelPipelineTest, testAddBefore) {
+    pipeline().addLast<PipelineTestHandler>("a", newHandler());
+    pipeline().addLast<PipelineTestHandler>("c", newHandler());
+
+    ASSERT_TRUE(pipeline().addBefore<PipelineTestHandler>("c", "b", newHandler()));
+    ASSERT_EQ("head,a,b,c", forward());
+    ASSERT_EQ("head,a,b,c", backward());
+
+    ASSERT_TRUE(pipeline().addBefore<PipelineTestHandler>("a", "0", newHandler()));
+    ASSERT_EQ("head,0,a,b,c", forward());
+    ASSERT_EQ("head,0,a,b,c", backward());
+}
+
+TEST_F(ChannelPipelineTest, testAddAfter) {
+    pipeline().addLast<PipelineTestHandler>("a", newHandler());
+    pipeline().addLast<PipelineTestHandler>("c", newHandler());
+
+    ASSERT_TRUE(pipeline().addAfter<PipelineTestHandler>("a", "b", newHandler()));
+    ASSERT_EQ("head,a,b,c", forward());
+    ASSERT_EQ("head,a,b,c", backward());
+
+    // after the tail, becomes the tail.
+    ASSERT_TRUE(pipeline().addAfter<PipelineTestHandler>("c", "d", newHandler()));
+    ASSERT_EQ("head,a,b,c,d", forward());
+    ASSERT_EQ("head,a,b,c,d", backward());
+    ASSERT_EQ(pipeline().find("d"), pipeline().tail());
+}
+
+TEST_F(ChannelPipelineTest, testRemoveTail) {
+    pipeline().addLast<PipelineTestHandler>("a", newHandler());
+    pipeline().addLast<PipelineTestHandler>("b", newHandler());
+
+    pipeline().remove("b");
+    ASSERT_EQ("head,a", forward());
+    ASSERT_EQ("head,a", backward());
+    ASSERT_EQ(pipeline().find("a"), pipeline().tail());
+
+    pipeline().addLast<PipelineTestHandler>("c", newHandler());
+    ASSERT_EQ("head,a,c", forward());
+    ASSERT_EQ("head,a,c", backward());
+}
+
+TEST_F(ChannelPipelineTest, testRemoveMiddle) {
+    pipeline().addLast<PipelineTestHandler>("a", newHandler());
+    pipeline().addLast<PipelineTestHandler>("b", newHandler());
+    pipeline().addLast<PipelineTestHandler>("c", newHandler());
+
+    pipeline().remove("b");
+    ASSERT_EQ("head,a,c", forward());
+    ASSERT_EQ("head,a,c", backward());
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <cetty/util/Exception.h>
+#include <cetty/channel/DefaultChannelFuture.h>
+
+using namespace cetty::channel;
+
+static void record(ChannelFuture& future, std::vector<int>* order, int id) {
+    order->push_back(id);
+}
+
+static void complete(ChannelFuturePtr future) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    future->setSuccess();
+}
+
+TEST(DefaultChannelFutureTest, testCompleteOnce) {
+    ChannelFuturePtr future(new DefaultChannelFuture(ChannelPtr(), true));
+
+    ASSERT_FALSE(future->isDone());
+    ASSERT_TRUE(future->setFailure(cetty::util::Exception("failed")));
+    ASSERT_FALSE(future->setSuccess());
+    ASSERT_FALSE(future->cancel());
+
+    ASSERT_TRUE(future->isDone());
+    ASSERT_FALSE(future->isSuccess());
+    ASSERT_TRUE(future->failedCause() != NULL);
+}
+
+TEST(DefaultChannelFutureTest, testListenersInPriorityOrder) {
+    std::vector<int> order;
+    ChannelFuturePtr future(new DefaultChannelFuture(ChannelPtr(), false));
+
+    // more than the inline listeners.
+    for (int i = 0; i < 6; ++i) {
+        future->addListener(boost::bind(&record, _1, &order, i), i % 2);
+    }
+
+    future->setSuccess();
+
+    ASSERT_EQ(6, static_cast<int>(order.size()));
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(1, order[i] % 2);
+        ASSERT_EQ(0, order[i + 3] % 2);
+    }
+
+    // notified immediately after completion.
+    future->addListener(boost::bind(&record, _1, &order, 6));
+    ASSERT_EQ(6, order.back());
+}
+
+TEST(DefaultChannelFutureTest, testAwaitInOtherThread) {
+    ChannelFuturePtr future(new DefaultChannelFuture(ChannelPtr(), false));
+    boost::thread thread(boost::bind(&complete, future));
+
+    ASSERT_TRUE(future->await(5000));
+    ASSERT_TRUE(future->isSuccess());
+    thread.join();
+}
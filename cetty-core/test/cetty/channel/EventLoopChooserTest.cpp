@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/EventLoopChooser.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+static void lockAndRelease(boost::mutex* mutex) {
+    boost::mutex::scoped_lock lock(*mutex);
+}
+
+static void doNothing() {
+}
+
+TEST(EventLoopChooserTest, testRoundRobin) {
+    EventLoopPoolPtr pool(new AsioServicePool(4));
+    RoundRobinEventLoopChooser chooser;
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i % 4, chooser.next(*pool));
+    }
+
+    pool->stop();
+    pool->waitingForStop();
+}
+
+TEST(EventLoopChooserTest, testLeastChannels) {
+    EventLoopPoolPtr pool(new AsioServicePool(4));
+    LeastChannelsEventLoopChooser chooser;
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4 - i; ++j) {
+            pool->loopAt(i)->channelActived();
+        }
+    }
+
+    // loop 3 has the least channels.
+    ASSERT_EQ(3, chooser.next(*pool));
+
+    pool->loopAt(3)->channelActived();
+    pool->loopAt(3)->channelActived();
+    ASSERT_EQ(2, chooser.next(*pool));
+
+    pool->stop();
+    pool->waitingForStop();
+}
+
+TEST(EventLoopChooserTest, testLeastPendingTasks) {
+    EventLoopPoolPtr pool(new AsioServicePool(4));
+    LeastPendingTasksEventLoopChooser chooser;
+    boost::mutex mutex;
+
+    {
+        boost::mutex::scoped_lock lock(mutex);
+
+        // block all the loops except the loop 2, and queue a task behind.
+        for (int i = 0; i < 4; ++i) {
+            if (i != 2) {
+                pool->loopAt(i)->post(boost::bind(&lockAndRelease, &mutex));
+                pool->loopAt(i)->post(boost::bind(&doNothing));
+            }
+        }
+
+        ASSERT_GT(pool->loopAt(0)->pendingTaskCount(), 0);
+        ASSERT_EQ(2, chooser.next(*pool));
+    }
+
+    pool->stop();
+    pool->waitingForStop();
+}
+
+TEST(EventLoopChooserTest, testPowerOfTwoChoices) {
+    EventLoopPoolPtr pool(new AsioServicePool(4));
+    pool->setChooser(EventLoopChooserPtr(new PowerOfTwoChoicesEventLoopChooser));
+
+    for (int i = 0; i < 100; ++i) {
+        pool->loopAt(0)->channelActived();
+    }
+
+    int counts[4] = {0};
+
+    for (int i = 0; i < 1000; ++i) {
+        const EventLoopPtr& loop = pool->nextLoop();
+
+        for (int j = 0; j < 4; ++j) {
+            if (pool->loopAt(j) == loop) {
+                ++counts[j];
+            }
+        }
+    }
+
+    // the most loaded loop is never chosen, the others are all chosen.
+    ASSERT_EQ(0, counts[0]);
+    ASSERT_GT(counts[1], 0);
+    ASSERT_GT(counts[2], 0);
+    ASSERT_GT(counts[3], 0);
+
+    pool->stop();
+    pool->waitingForStop();
+}
+
+TEST(EventLoopChooserTest, testCreateByName) {
+    ASSERT_TRUE(dynamic_cast<PowerOfTwoChoicesEventLoopChooser*>(
+                    EventLoopChooserPtr(EventLoopChooser::create("powerOfTwoChoices")).get()));
+    ASSERT_TRUE(EventLoopChooser::create("unknown") == NULL);
+}
+
+static void swapChoosers(EventLoopPool* pool, int times) {
+    for (int i = 0; i < times; ++i) {
+        if (i % 2) {
+            pool->setChooser(EventLoopChooserPtr(new RoundRobinEventLoopChooser));
+        }
+        else {
+            pool->setChooser(EventLoopChooserPtr(new LeastChannelsEventLoopChooser));
+        }
+    }
+}
+
+TEST(EventLoopChooserTest, testSetChooserWhileChoosing) {
+    EventLoopPoolPtr pool(new AsioServicePool(4));
+    boost::thread swapper(boost::bind(&swapChoosers, pool.get(), 10000));
+
+    // the replaced chooser is kept alive till the choice is done.
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_TRUE(pool->nextLoop());
+    }
+
+    swapper.join();
+
+    pool->stop();
+    pool->waitingForStop();
+}
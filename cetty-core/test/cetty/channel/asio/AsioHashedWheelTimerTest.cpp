@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cetty/util/CachedClock.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioService.h>
+
+using namespace cetty::channel;
+using namespace cetty::util;
+using namespace cetty::channel::asio;
+
+static void record(std::vector<int>* fired, int id) {
+    fired->push_back(id);
+}
+
+static void stopService(AsioService* service) {
+    service->service().stop();
+}
+
+class AsioHashedWheelTimerTest : public testing::Test {
+public:
+    AsioHashedWheelTimerTest() : service(new AsioService(EventLoopPoolPtr(), true)) {
+        service->setThreadId(CurrentThread::id());
+    }
+
+    void run(int64_t millisecond) {
+        service->runAfter(millisecond, boost::bind(&stopService, service.get()));
+        service->service().run();
+    }
+
+    AsioServicePtr service;
+};
+
+TEST_F(AsioHashedWheelTimerTest, testExpireInOrder) {
+    std::vector<int> fired;
+    service->runAfter(30, boost::bind(&record, &fired, 2));
+    service->runAfter(10, boost::bind(&record, &fired, 1));
+    service->runAfter(6000, boost::bind(&record, &fired, 3));
+
+    run(100);
+
+    ASSERT_EQ(2U, fired.size());
+    ASSERT_EQ(1, fired[0]);
+    ASSERT_EQ(2, fired[1]);
+    ASSERT_EQ(1, service->timerWheel()->pendingTimeouts());
+}
+
+TEST_F(AsioHashedWheelTimerTest, testCancel) {
+    std::vector<int> fired;
+    TimeoutPtr timeout = service->runAfter(20, boost::bind(&record, &fired, 1));
+    timeout->cancel();
+
+    run(60);
+
+    ASSERT_TRUE(fired.empty());
+    ASSERT_TRUE(timeout->isCancelled());
+    ASSERT_EQ(0, service->timerWheel()->pendingTimeouts());
+}
+
+TEST_F(AsioHashedWheelTimerTest, testRunEvery) {
+    std::vector<int> fired;
+    TimeoutPtr timeout = service->runEvery(20, boost::bind(&record, &fired, 1));
+
+    run(110);
+    timeout->cancel();
+
+    ASSERT_GE(fired.size(), 4U);
+    ASSERT_LE(fired.size(), 5U);
+    ASSERT_EQ(0, service->timerWheel()->pendingTimeouts());
+}
+
+TEST_F(AsioHashedWheelTimerTest, testRunAt) {
+    std::vector<int> fired;
+    boost::posix_time::ptime now = CachedClock::now();
+
+    service->runAt(now + boost::posix_time::milliseconds(30),
+                   boost::bind(&record, &fired, 2));
+    service->runAt(now - boost::posix_time::milliseconds(30),
+                   boost::bind(&record, &fired, 1));
+    service->runAt(now + boost::posix_time::seconds(6),
+                   boost::bind(&record, &fired, 3));
+
+    run(100);
+
+    ASSERT_EQ(2U, fired.size());
+    ASSERT_EQ(1, fired[0]);
+    ASSERT_EQ(2, fired[1]);
+}
+
+static void cancelTimeout(TimeoutPtr timeout) {
+    timeout->cancel();
+}
+
+TEST_F(AsioHashedWheelTimerTest, testCancelInOtherThread) {
+    std::vector<int> fired;
+    TimeoutPtr timeout = service->runEvery(10, boost::bind(&record, &fired, 1));
+
+    boost::thread canceller(boost::bind(&cancelTimeout, timeout));
+    canceller.join();
+
+    run(60);
+
+    ASSERT_TRUE(timeout->isCancelled());
+    ASSERT_TRUE(fired.empty());
+    ASSERT_EQ(0, service->timerWheel()->pendingTimeouts());
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <cetty/bootstrap/ServerBootstrap.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#include <cetty/channel/asio/AsioServerSocketChannel.h>
+
+using namespace cetty::bootstrap;
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+// each test binds its own port, not to wait for the last one released.
+static const int PORT = 19853;
+static const int CONNECTIONS = 32;
+
+static bool initializeChild(ChannelPipeline& pipeline) {
+    return true;
+}
+
+class AsioServerSocketChannelTest : public testing::Test {
+public:
+    AsioServerSocketChannelTest()
+        : port(0),
+          server(EventLoopPoolPtr(new AsioServicePool(1)),
+                 EventLoopPoolPtr(new AsioServicePool(2))) {
+        server.setChildInitializer(boost::bind(&initializeChild, _1));
+        server.setOption(ChannelOption::CO_SO_REUSEADDR, true);
+    }
+
+    virtual ~AsioServerSocketChannelTest() {
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            delete clients[i];
+        }
+
+        server.shutdown();
+    }
+
+    AsioServerSocketChannel* bind(int port) {
+        ChannelFuturePtr future = server.bind(port);
+        future->await();
+
+        if (!future->isSuccess()) {
+            return NULL;
+        }
+
+        this->port = port;
+        channel = future->channel();
+        return dynamic_cast<AsioServerSocketChannel*>(channel.get());
+    }
+
+    void connect(int count) {
+        boost::asio::ip::tcp::endpoint ep(
+            boost::asio::ip::address::from_string("127.0.0.1"), port);
+
+        for (int i = 0; i < count; ++i) {
+            boost::asio::ip::tcp::socket* socket =
+                new boost::asio::ip::tcp::socket(ioService);
+
+            socket->connect(ep);
+            clients.push_back(socket);
+        }
+    }
+
+    void closeClients() {
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            delete clients[i];
+        }
+
+        clients.clear();
+    }
+
+    static int64_t totalAccepted(const AsioServerSocketChannel& channel) {
+        int64_t total = 0;
+
+        for (int i = 0; i < channel.acceptorCount(); ++i) {
+            total += channel.acceptedCount(i);
+        }
+
+        return total;
+    }
+
+    // waits for the acceptors to count <tt>count</tt> connections in total.
+    static bool waitForAccepted(const AsioServerSocketChannel& channel,
+                                int64_t count) {
+        for (int i = 0; i < 500; ++i) {
+            if (totalAccepted(channel) >= count) {
+                return true;
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return false;
+    }
+
+    int port;
+    ServerBootstrap server;
+    ChannelPtr channel;
+
+    boost::asio::io_service ioService;
+    std::vector<boost::asio::ip::tcp::socket*> clients;
+};
+
+TEST_F(AsioServerSocketChannelTest, testSingleAcceptor) {
+    AsioServerSocketChannel* serverChannel = bind(PORT);
+    ASSERT_TRUE(serverChannel);
+    ASSERT_EQ(1, serverChannel->acceptorCount());
+
+    connect(CONNECTIONS);
+
+    ASSERT_TRUE(waitForAccepted(*serverChannel, CONNECTIONS));
+    ASSERT_EQ(CONNECTIONS, serverChannel->acceptedCount(0));
+}
+
+TEST_F(AsioServerSocketChannelTest, testReusePortAcceptors) {
+    server.setReusePort(true);
+    server.setOption(ChannelOption::CO_RESERVED_CHILD_COUNT, 4);
+
+    AsioServerSocketChannel* serverChannel = bind(PORT + 1);
+    ASSERT_TRUE(serverChannel);
+
+    // one acceptor in each child event loop.
+    ASSERT_EQ(2, serverChannel->acceptorCount());
+
+    connect(CONNECTIONS);
+
+    ASSERT_TRUE(waitForAccepted(*serverChannel, CONNECTIONS));
+    ASSERT_EQ(CONNECTIONS, totalAccepted(*serverChannel));
+
+    // the kernel spreads the connections by their addresses.
+    ASSERT_LT(0, serverChannel->acceptedCount(0));
+    ASSERT_LT(0, serverChannel->acceptedCount(1));
+
+    // the closed children are removed in their own loops,
+    // and accepting goes on.
+    closeClients();
+    usleep(50 * 1000);
+    connect(CONNECTIONS);
+
+    ASSERT_TRUE(waitForAccepted(*serverChannel, 2 * CONNECTIONS));
+    ASSERT_EQ(2 * CONNECTIONS, totalAccepted(*serverChannel));
+}
+
+TEST_F(AsioServerSocketChannelTest, testReusePortBindFailed) {
+    boost::asio::ip::tcp::endpoint ep(boost::asio::ip::tcp::v4(), PORT + 2);
+
+    // listening without SO_REUSEPORT, which no acceptor can share.
+    boost::asio::ip::tcp::acceptor blocker(ioService, ep);
+
+    server.setReusePort(true);
+    ASSERT_FALSE(bind(PORT + 2));
+
+    // the acceptors are released, the port is free once the blocker closes.
+    blocker.close();
+
+    boost::asio::ip::tcp::acceptor rebound(ioService);
+    boost::system::error_code ec;
+
+    rebound.open(ep.protocol(), ec);
+    rebound.bind(ep, ec);
+    ASSERT_FALSE(ec);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioService.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+
+static void record(std::vector<int>* ran, int id) {
+    ran->push_back(id);
+}
+
+static void fail() {
+    throw std::runtime_error("failed handler");
+}
+
+TEST(AsioServiceTest, testPostedHandlerThrows) {
+    AsioServicePtr service(new AsioService(EventLoopPoolPtr()));
+    service->setThreadId(CurrentThread::id());
+
+    std::vector<int> ran;
+
+    service->post(boost::bind(&record, &ran, 1));
+    service->post(&fail);
+    service->post(boost::bind(&record, &ran, 2));
+
+    ASSERT_THROW(service->service().run(), std::runtime_error);
+    ASSERT_EQ(1U, ran.size());
+
+    // the handler not run yet is run in the next batch, before the new one.
+    service->post(boost::bind(&record, &ran, 3));
+    service->service().run();
+
+    ASSERT_EQ(3U, ran.size());
+    ASSERT_EQ(2, ran[1]);
+    ASSERT_EQ(3, ran[2]);
+    ASSERT_EQ(0, service->pendingTaskCount());
+}
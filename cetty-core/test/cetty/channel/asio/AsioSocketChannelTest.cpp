@@ -0,0 +1,372 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <cetty/bootstrap/ServerBootstrap.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/PooledChannelBufferFactory.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelInboundBufferHandler.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#include <cetty/channel/asio/AsioSocketChannel.h>
+#include <cetty/channel/asio/AsioServerSocketChannel.h>
+#include <cetty/util/Atomic.h>
+
+using namespace cetty::bootstrap;
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+using namespace cetty::util;
+
+static const int PORT = 19873;
+
+static boost::mutex acceptedMutex;
+static AsioSocketChannelPtr acceptedChannel;
+
+static Atomic<int> readBytes;
+static Atomic<int> writabilityChanges;
+
+/**
+ * keeps the accepted channel for the test, counts and drops the bytes read.
+ */
+class ChannelTestHandler : private boost::noncopyable {
+public:
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::Context Context;
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::InboundContainer InboundContainer;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    ChannelTestHandler() : container_() {}
+
+    void registerTo(Context& ctx) {
+        container_ = ctx.inboundContainer();
+
+        ctx.setChannelActiveCallback(boost::bind(
+                                         &ChannelTestHandler::channelActive,
+                                         this,
+                                         _1));
+
+        ctx.setChannelMessageUpdatedCallback(boost::bind(
+                &ChannelTestHandler::messageUpdated,
+                this,
+                _1));
+
+        ctx.setChannelWritabilityChangedCallback(boost::bind(
+                    &ChannelTestHandler::writabilityChanged,
+                    this,
+                    _1));
+    }
+
+private:
+    void channelActive(ChannelHandlerContext& ctx) {
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel =
+            boost::dynamic_pointer_cast<AsioSocketChannel>(ctx.channel());
+    }
+
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        const ChannelBufferPtr& buffer = container_->getMessages();
+
+        if (buffer) {
+            int bytes = buffer->readableBytes();
+            buffer->skipBytes(bytes);
+            readBytes.addAndGet(bytes);
+        }
+    }
+
+    void writabilityChanged(ChannelHandlerContext& ctx) {
+        writabilityChanges.incrementAndGet();
+    }
+
+private:
+    InboundContainer* container_;
+};
+
+static bool initializeChild(ChannelPipeline& pipeline) {
+    pipeline.addLast<ChannelTestHandler::HandlerPtr>("test",
+            ChannelTestHandler::HandlerPtr(new ChannelTestHandler));
+
+    return true;
+}
+
+static std::string pattern(int size, char first) {
+    std::string bytes;
+
+    for (int i = 0; i < size; ++i) {
+        bytes += static_cast<char>(first + i % 26);
+    }
+
+    return bytes;
+}
+
+static ChannelBufferPtr newBuffer(int size, char first) {
+    return Unpooled::copiedBuffer(pattern(size, first));
+}
+
+static void countCompleted(ChannelFuture& future,
+                           std::vector<int>* completed,
+                           int index) {
+    completed->push_back(future.isSuccess() ? index : -1 - index);
+}
+
+static void writeBuffers(const AsioSocketChannelPtr& channel,
+                         const std::vector<ChannelBufferPtr>* buffers,
+                         std::vector<int>* completed) {
+    for (std::size_t i = 0; i < buffers->size(); ++i) {
+        ChannelFuturePtr future = channel->newFuture();
+        future->addListener(boost::bind(&countCompleted,
+                                        _1,
+                                        completed,
+                                        static_cast<int>(i)));
+
+        channel->writeBuffer((*buffers)[i], future);
+    }
+}
+
+class AsioSocketChannelTest : public testing::Test {
+public:
+    AsioSocketChannelTest()
+        : server(EventLoopPoolPtr(new AsioServicePool(1))),
+          client(ioService) {
+        server.setChildInitializer(boost::bind(&initializeChild, _1));
+        server.setOption(ChannelOption::CO_SO_REUSEADDR, true);
+
+        readBytes.set(0);
+        writabilityChanges.set(0);
+    }
+
+    virtual ~AsioSocketChannelTest() {
+        boost::system::error_code ec;
+        client.close(ec);
+
+        server.shutdown();
+
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel.reset();
+    }
+
+    // binds the server to the <tt>port</tt> and connects to it, returns
+    // the accepted channel, each test binds its own port.
+    AsioSocketChannelPtr connect(int port, int clientReceiveBufferSize = 0) {
+        if (!server.bind(port)->await()->isSuccess()) {
+            return AsioSocketChannelPtr();
+        }
+
+        boost::asio::ip::tcp::endpoint ep(
+            boost::asio::ip::address::from_string("127.0.0.1"), port);
+
+        client.open(ep.protocol());
+
+        if (clientReceiveBufferSize) {
+            client.set_option(boost::asio::socket_base::receive_buffer_size(
+                                  clientReceiveBufferSize));
+        }
+
+        client.connect(ep);
+
+        for (int i = 0; i < 500; ++i) {
+            {
+                boost::lock_guard<boost::mutex> lock(acceptedMutex);
+
+                if (acceptedChannel) {
+                    return acceptedChannel;
+                }
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return AsioSocketChannelPtr();
+    }
+
+    // writes the buffers in the loop of the channel, all at once.
+    void write(const AsioSocketChannelPtr& channel,
+               const std::vector<ChannelBufferPtr>& buffers) {
+        channel->eventLoop()->post(boost::bind(&writeBuffers,
+                                               channel,
+                                               &buffers,
+                                               &completed));
+    }
+
+    std::string receive(int bytes) {
+        std::string received(bytes, '\0');
+        boost::asio::read(client, boost::asio::buffer(&received[0], bytes));
+        return received;
+    }
+
+    static bool waitFor(const Atomic<int>& value, int expected) {
+        for (int i = 0; i < 500 && value.get() < expected; ++i) {
+            usleep(10 * 1000);
+        }
+
+        return value.get() >= expected;
+    }
+
+    bool waitForCompleted(const AsioSocketChannelPtr& channel, int count) {
+        for (int i = 0; i < 500; ++i) {
+            if (channel->writeBufferSize() == 0
+                    && static_cast<int>(completed.size()) >= count) {
+                return true;
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return false;
+    }
+
+    ServerBootstrap server;
+
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::socket client;
+
+    // the indexes of the completed writes, negative if failed,
+    // only touched in the loop thread until the writes are done.
+    std::vector<int> completed;
+};
+
+TEST_F(AsioSocketChannelTest, testGatheringWrite) {
+    AsioSocketChannelPtr channel = connect(PORT);
+    ASSERT_TRUE(channel);
+
+    // a composite buffer is written in place block by block.
+    std::vector<ChannelBufferPtr> buffers;
+    buffers.push_back(Unpooled::wrappedBuffer(newBuffer(1000, 'a'),
+                      newBuffer(3000, 'A'),
+                      newBuffer(5000, 'a')));
+
+    std::string expected =
+        pattern(1000, 'a') + pattern(3000, 'A') + pattern(5000, 'a');
+
+    write(channel, buffers);
+
+    ASSERT_EQ(expected, receive(9000));
+    ASSERT_TRUE(waitForCompleted(channel, 1));
+    ASSERT_EQ(0, completed[0]);
+    ASSERT_EQ(9000, channel->gatheringWrittenBytes());
+    ASSERT_EQ(0, channel->compactedWrittenBytes());
+}
+
+TEST_F(AsioSocketChannelTest, testCoalescedWrites) {
+    server.setChildOption(ChannelOption::CO_WRITE_BATCH_OPERATIONS, 16);
+    AsioSocketChannelPtr channel = connect(PORT + 1);
+    ASSERT_TRUE(channel);
+
+    // the first one is written alone, the others queued meanwhile are
+    // coalesced, including an empty one and a composite one, and completed
+    // in order by the bytes written.
+    std::vector<ChannelBufferPtr> buffers;
+    buffers.push_back(newBuffer(100, 'a'));
+    buffers.push_back(newBuffer(200, 'A'));
+    buffers.push_back(Unpooled::buffer(0));
+    buffers.push_back(Unpooled::wrappedBuffer(newBuffer(300, 'a'),
+                      newBuffer(400, 'A')));
+    buffers.push_back(newBuffer(500, 'a'));
+
+    std::string expected = pattern(100, 'a') + pattern(200, 'A')
+                           + pattern(300, 'a') + pattern(400, 'A')
+                           + pattern(500, 'a');
+
+    write(channel, buffers);
+
+    ASSERT_EQ(expected, receive(1500));
+    ASSERT_TRUE(waitForCompleted(channel, 5));
+
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(i, completed[i]);
+    }
+
+    ASSERT_EQ(700, channel->gatheringWrittenBytes());
+}
+
+TEST_F(AsioSocketChannelTest, testLazyReadBuffer) {
+    server.setChildOption(ChannelOption::CO_LAZY_READ_BUFFER, true);
+    AsioSocketChannelPtr channel = connect(PORT + 2);
+    ASSERT_TRUE(channel);
+
+    PooledChannelBufferFactory::Statistics before;
+    PooledChannelBufferFactory::statistics(&before);
+
+    std::string data(4096, 'x');
+    boost::asio::write(client, boost::asio::buffer(data));
+    ASSERT_TRUE(waitFor(readBytes, 4096));
+
+    // the buffer is given back to the pool of the loop after the read,
+    // and borrowed again by the next read.
+    usleep(20 * 1000);
+    PooledChannelBufferFactory::Statistics idle;
+    PooledChannelBufferFactory::statistics(&idle);
+    ASSERT_GT(idle.residentBytes, before.residentBytes);
+
+    boost::asio::write(client, boost::asio::buffer(data));
+    ASSERT_TRUE(waitFor(readBytes, 2 * 4096));
+
+    PooledChannelBufferFactory::Statistics after;
+    PooledChannelBufferFactory::statistics(&after);
+    ASSERT_GT(after.hits, idle.hits);
+}
+
+TEST_F(AsioSocketChannelTest, testWritabilityChanged) {
+    server.setChildOption(ChannelOption::CO_SNDHIGHWAT, 64 * 1024);
+    server.setChildOption(ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK,
+                          16 * 1024);
+
+    AsioSocketChannelPtr channel = connect(PORT + 3);
+    ASSERT_TRUE(channel);
+    ASSERT_TRUE(channel->isWritable());
+
+    std::vector<ChannelBufferPtr> buffers;
+
+    for (int i = 0; i < 16; ++i) {
+        buffers.push_back(newBuffer(64 * 1024, 'a'));
+    }
+
+    write(channel, buffers);
+
+    // turns not writable once the queued bytes exceed the high water mark,
+    // and writable again after they have dropped below the low one.
+    ASSERT_TRUE(waitFor(writabilityChanges, 1));
+    ASSERT_EQ(1, channel->highWaterMarkCount());
+
+    receive(16 * 64 * 1024);
+
+    ASSERT_TRUE(waitForCompleted(channel, 16));
+    ASSERT_TRUE(waitFor(writabilityChanges, 2));
+    ASSERT_EQ(2, writabilityChanges.get());
+    ASSERT_TRUE(channel->isWritable());
+    ASSERT_EQ(1, channel->highWaterMarkCount());
+}
+
+TEST_F(AsioSocketChannelTest, testWritableAfterWriteFailed) {
+    server.setChildOption(ChannelOption::CO_SNDHIGHWAT, 64 * 1024);
+
+    AsioSocketChannelPtr channel = connect(PORT + 4, 4096);
+    ASSERT_TRUE(channel);
+
+    // far more than the socket buffers hold, while the client reads nothing.
+    std::vector<ChannelBufferPtr> buffers;
+
+    for (int i = 0; i < 32; ++i) {
+        buffers.push_back(newBuffer(1024 * 1024, 'a'));
+    }
+
+    write(channel, buffers);
+    ASSERT_TRUE(waitFor(writabilityChanges, 1));
+    ASSERT_FALSE(channel->isWritable());
+
+    // reset the connection, the pending writes fail.
+    client.set_option(boost::asio::socket_base::linger(true, 0));
+    client.close();
+
+    ASSERT_TRUE(waitForCompleted(channel, 32));
+    ASSERT_TRUE(waitFor(writabilityChanges, 2));
+    ASSERT_TRUE(channel->isWritable());
+    ASSERT_GT(0, completed.back());
+    ASSERT_TRUE(channel->closeFuture()->await()->isSuccess());
+}
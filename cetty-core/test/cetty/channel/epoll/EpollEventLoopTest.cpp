@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <unistd.h>
+#include <boost/bind.hpp>
+
+#include <cetty/channel/Timeout.h>
+#include <cetty/channel/epoll/EpollEventLoop.h>
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+#include <cetty/util/Atomic.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::epoll;
+using namespace cetty::util;
+
+static Atomic<int> fired;
+static TimeoutPtr selfCancelling;
+
+static void fire() {
+    fired.incrementAndGet();
+}
+
+static void fireAndCancel(int times) {
+    if (fired.incrementAndGet() == times) {
+        selfCancelling->cancel();
+    }
+}
+
+class EpollEventLoopTest : public testing::Test {
+public:
+    EpollEventLoopTest()
+        : pool(new EpollEventLoopPool(1)),
+          loop(pool->nextLoop()) {
+        fired.set(0);
+    }
+
+    virtual ~EpollEventLoopTest() {
+        pool->stop();
+        pool->waitingForStop();
+
+        selfCancelling.reset();
+    }
+
+    static bool waitFor(int expected) {
+        for (int i = 0; i < 500 && fired.get() < expected; ++i) {
+            usleep(10 * 1000);
+        }
+
+        return fired.get() >= expected;
+    }
+
+    EventLoopPoolPtr pool;
+    EventLoopPtr loop;
+};
+
+TEST_F(EpollEventLoopTest, testRunAfter) {
+    TimeoutPtr timeout = loop->runAfter(20, boost::bind(&fire));
+    ASSERT_TRUE(timeout);
+
+    ASSERT_TRUE(waitFor(1));
+    usleep(50 * 1000);
+
+    ASSERT_EQ(1, fired.get());
+    ASSERT_TRUE(timeout->isExpired());
+}
+
+TEST_F(EpollEventLoopTest, testCancelFromAnotherThread) {
+    TimeoutPtr timeout = loop->runAfter(100, boost::bind(&fire));
+    ASSERT_TRUE(timeout->isActived());
+
+    timeout->cancel();
+    ASSERT_TRUE(timeout->isCancelled());
+
+    // cancelling again does nothing.
+    timeout->cancel();
+
+    usleep(200 * 1000);
+    ASSERT_EQ(0, fired.get());
+    ASSERT_TRUE(timeout->isCancelled());
+}
+
+TEST_F(EpollEventLoopTest, testCancelExpired) {
+    TimeoutPtr timeout = loop->runAfter(1, boost::bind(&fire));
+    ASSERT_TRUE(waitFor(1));
+
+    // a one shot timeout can not be cancelled after expired.
+    timeout->cancel();
+    ASSERT_TRUE(timeout->isExpired());
+}
+
+TEST_F(EpollEventLoopTest, testCancelPeriodicFromAnotherThread) {
+    TimeoutPtr timeout = loop->runEvery(10, boost::bind(&fire));
+    ASSERT_TRUE(waitFor(3));
+
+    timeout->cancel();
+    ASSERT_TRUE(timeout->isCancelled());
+
+    // the handler may be running in the loop meanwhile, but it will not
+    // be rescheduled.
+    int count = fired.get();
+    usleep(100 * 1000);
+
+    ASSERT_LE(fired.get(), count + 1);
+    ASSERT_TRUE(timeout->isCancelled());
+}
+
+TEST_F(EpollEventLoopTest, testCancelPeriodicInHandler) {
+    selfCancelling = loop->runEvery(10, boost::bind(&fireAndCancel, 3));
+    ASSERT_TRUE(waitFor(3));
+
+    usleep(100 * 1000);
+    ASSERT_EQ(3, fired.get());
+    ASSERT_TRUE(selfCancelling->isCancelled());
+}
+
+TEST_F(EpollEventLoopTest, testCancelRacesWithExpiring) {
+    static const int COUNT = 1000;
+    std::vector<TimeoutPtr> timeouts;
+
+    for (int i = 0; i < COUNT; ++i) {
+        timeouts.push_back(loop->runAfter(i % 3, boost::bind(&fire)));
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        timeouts[i]->cancel();
+    }
+
+    usleep(100 * 1000);
+
+    // every timeout is either expired or cancelled, never both.
+    int cancelled = 0;
+
+    for (int i = 0; i < COUNT; ++i) {
+        ASSERT_TRUE(timeouts[i]->isExpired() != timeouts[i]->isCancelled());
+
+        if (timeouts[i]->isCancelled()) {
+            ++cancelled;
+        }
+    }
+
+    ASSERT_EQ(COUNT, fired.get() + cancelled);
+}
@@ -0,0 +1,310 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <cetty/bootstrap/ServerBootstrap.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelInboundBufferHandler.h>
+#include <cetty/channel/epoll/EpollEventLoopPool.h>
+#include <cetty/channel/epoll/EpollSocketChannel.h>
+#include <cetty/util/Atomic.h>
+
+using namespace cetty::bootstrap;
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::epoll;
+using namespace cetty::util;
+
+static const int PORT = 19893;
+
+static boost::mutex acceptedMutex;
+static EpollSocketChannelPtr acceptedChannel;
+
+static Atomic<int> readBytes;
+static Atomic<int> echo;
+
+/**
+ * keeps the accepted channel for the test, echoes or drops the bytes read.
+ */
+class ChannelTestHandler : private boost::noncopyable {
+public:
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::Context Context;
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::InboundContainer InboundContainer;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    ChannelTestHandler() : container_() {}
+
+    void registerTo(Context& ctx) {
+        container_ = ctx.inboundContainer();
+
+        ctx.setChannelActiveCallback(boost::bind(
+                                         &ChannelTestHandler::channelActive,
+                                         this,
+                                         _1));
+
+        ctx.setChannelMessageUpdatedCallback(boost::bind(
+                &ChannelTestHandler::messageUpdated,
+                this,
+                _1));
+    }
+
+private:
+    void channelActive(ChannelHandlerContext& ctx) {
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel =
+            boost::dynamic_pointer_cast<EpollSocketChannel>(ctx.channel());
+    }
+
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        const ChannelBufferPtr& buffer = container_->getMessages();
+
+        if (!buffer) {
+            return;
+        }
+
+        int bytes = buffer->readableBytes();
+        readBytes.addAndGet(bytes);
+
+        if (echo.get() && bytes) {
+            ctx.channel()->writeBuffer(buffer->copy());
+        }
+
+        buffer->skipBytes(bytes);
+    }
+
+private:
+    InboundContainer* container_;
+};
+
+static bool initializeChild(ChannelPipeline& pipeline) {
+    pipeline.addLast<ChannelTestHandler::HandlerPtr>("test",
+            ChannelTestHandler::HandlerPtr(new ChannelTestHandler));
+
+    return true;
+}
+
+static std::string pattern(int size, char first) {
+    std::string bytes;
+
+    for (int i = 0; i < size; ++i) {
+        bytes += static_cast<char>(first + i % 26);
+    }
+
+    return bytes;
+}
+
+static ChannelBufferPtr newBuffer(int size, char first) {
+    return Unpooled::copiedBuffer(pattern(size, first));
+}
+
+static void countCompleted(ChannelFuture& future,
+                           std::vector<int>* completed,
+                           int index) {
+    completed->push_back(future.isSuccess() ? index : -1 - index);
+}
+
+static void writeBuffers(const EpollSocketChannelPtr& channel,
+                         const std::vector<ChannelBufferPtr>* buffers,
+                         std::vector<int>* completed) {
+    for (std::size_t i = 0; i < buffers->size(); ++i) {
+        ChannelFuturePtr future = channel->newFuture();
+        future->addListener(boost::bind(&countCompleted,
+                                        _1,
+                                        completed,
+                                        static_cast<int>(i)));
+
+        channel->writeBuffer((*buffers)[i], future);
+    }
+}
+
+static void closeChannel(const EpollSocketChannelPtr& channel) {
+    channel->close();
+}
+
+class EpollSocketChannelTest : public testing::Test {
+public:
+    EpollSocketChannelTest()
+        : server(EventLoopPoolPtr(new EpollEventLoopPool(1))),
+          client(ioService) {
+        server.setChildInitializer(boost::bind(&initializeChild, _1));
+        server.setOption(ChannelOption::CO_SO_REUSEADDR, true);
+
+        readBytes.set(0);
+        echo.set(0);
+    }
+
+    virtual ~EpollSocketChannelTest() {
+        boost::system::error_code ec;
+        client.close(ec);
+
+        server.shutdown();
+
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel.reset();
+    }
+
+    // binds the server to the <tt>port</tt> and connects to it, returns
+    // the accepted channel, each test binds its own port.
+    EpollSocketChannelPtr connect(int port, int clientReceiveBufferSize = 0) {
+        if (!server.bind(port)->await()->isSuccess()) {
+            return EpollSocketChannelPtr();
+        }
+
+        boost::asio::ip::tcp::endpoint ep(
+            boost::asio::ip::address::from_string("127.0.0.1"), port);
+
+        client.open(ep.protocol());
+
+        if (clientReceiveBufferSize) {
+            client.set_option(boost::asio::socket_base::receive_buffer_size(
+                                  clientReceiveBufferSize));
+        }
+
+        client.connect(ep);
+
+        for (int i = 0; i < 500; ++i) {
+            {
+                boost::lock_guard<boost::mutex> lock(acceptedMutex);
+
+                if (acceptedChannel) {
+                    return acceptedChannel;
+                }
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return EpollSocketChannelPtr();
+    }
+
+    // writes the buffers in the loop of the channel, all at once.
+    void write(const EpollSocketChannelPtr& channel,
+               const std::vector<ChannelBufferPtr>& buffers) {
+        channel->eventLoop()->post(boost::bind(&writeBuffers,
+                                               channel,
+                                               &buffers,
+                                               &completed));
+    }
+
+    std::string receive(int bytes) {
+        std::string received(bytes, '\0');
+        boost::asio::read(client, boost::asio::buffer(&received[0], bytes));
+        return received;
+    }
+
+    // waits till the writes are queued and the socket send buffer is full.
+    static bool waitForPending(const EpollSocketChannelPtr& channel) {
+        for (int i = 0; i < 500 && channel->writeBufferSize() == 0; ++i) {
+            usleep(10 * 1000);
+        }
+
+        // let the loop run into the EAGAIN.
+        usleep(50 * 1000);
+        return channel->writeBufferSize() > 0;
+    }
+
+    bool waitForCompleted(const EpollSocketChannelPtr& channel, int count) {
+        for (int i = 0; i < 500; ++i) {
+            if (channel->writeBufferSize() == 0
+                    && static_cast<int>(completed.size()) >= count) {
+                return true;
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return false;
+    }
+
+    ServerBootstrap server;
+
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::socket client;
+
+    // the indexes of the completed writes, negative if failed,
+    // only touched in the loop thread until the writes are done.
+    std::vector<int> completed;
+};
+
+TEST_F(EpollSocketChannelTest, testEcho) {
+    echo.set(1);
+
+    EpollSocketChannelPtr channel = connect(PORT);
+    ASSERT_TRUE(channel);
+
+    // larger than one read buffer, so read on into the extra buffer.
+    std::string data = pattern(256 * 1024, 'a');
+    boost::asio::write(client, boost::asio::buffer(data));
+
+    ASSERT_EQ(data, receive(static_cast<int>(data.size())));
+    ASSERT_EQ(static_cast<int>(data.size()), readBytes.get());
+}
+
+TEST_F(EpollSocketChannelTest, testPartialWrite) {
+    server.setChildOption(ChannelOption::CO_SO_SNDBUF, 4096);
+
+    EpollSocketChannelPtr channel = connect(PORT + 1, 4096);
+    ASSERT_TRUE(channel);
+
+    // far more than the socket buffers hold, the writev returns short or
+    // EAGAIN, the rest is written on the next EPOLLOUT.
+    std::vector<ChannelBufferPtr> buffers;
+    std::string expected;
+
+    for (int i = 0; i < 8; ++i) {
+        buffers.push_back(Unpooled::wrappedBuffer(newBuffer(100 * 1000, 'a' + i),
+                          newBuffer(28 * 1024, 'A' + i)));
+        expected += pattern(100 * 1000, 'a' + i) + pattern(28 * 1024, 'A' + i);
+    }
+
+    write(channel, buffers);
+    ASSERT_TRUE(waitForPending(channel));
+
+    ASSERT_EQ(expected, receive(static_cast<int>(expected.size())));
+    ASSERT_TRUE(waitForCompleted(channel, 8));
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i, completed[i]);
+    }
+}
+
+TEST_F(EpollSocketChannelTest, testCloseWhileWritePending) {
+    server.setChildOption(ChannelOption::CO_SO_SNDBUF, 4096);
+
+    EpollSocketChannelPtr channel = connect(PORT + 2, 4096);
+    ASSERT_TRUE(channel);
+
+    std::vector<ChannelBufferPtr> buffers;
+
+    for (int i = 0; i < 8; ++i) {
+        buffers.push_back(newBuffer(1024 * 1024, 'a'));
+    }
+
+    write(channel, buffers);
+    ASSERT_TRUE(waitForPending(channel));
+
+    channel->eventLoop()->post(boost::bind(&closeChannel, channel));
+    ASSERT_TRUE(channel->closeFuture()->await()->isSuccess());
+
+    // the writes not done fail, in order, and nothing is left queued.
+    ASSERT_TRUE(waitForCompleted(channel, 8));
+    ASSERT_GT(0, completed.back());
+
+    for (std::size_t i = 1; i < completed.size(); ++i) {
+        int previous = completed[i - 1] < 0 ? -1 - completed[i - 1] : completed[i - 1];
+        int current = completed[i] < 0 ? -1 - completed[i] : completed[i];
+        ASSERT_EQ(previous + 1, current);
+    }
+
+    ASSERT_EQ(0, channel->writeBufferSize());
+    ASSERT_FALSE(channel->isOpen());
+}
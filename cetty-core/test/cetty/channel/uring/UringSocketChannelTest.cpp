@@ -0,0 +1,356 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <cetty/bootstrap/ClientBootstrap.h>
+#include <cetty/bootstrap/ServerBootstrap.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelInboundBufferHandler.h>
+#include <cetty/channel/uring/IoUring.h>
+#include <cetty/channel/uring/UringEventLoopPool.h>
+#include <cetty/channel/uring/UringSocketChannel.h>
+#include <cetty/util/Atomic.h>
+
+using namespace cetty::bootstrap;
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::uring;
+using namespace cetty::util;
+
+static const int PORT = 19913;
+
+static boost::mutex acceptedMutex;
+static UringSocketChannelPtr acceptedChannel;
+
+static Atomic<int> readBytes;
+static Atomic<int> echo;
+
+/**
+ * keeps the accepted channel for the test, echoes or drops the bytes read.
+ */
+class ChannelTestHandler : private boost::noncopyable {
+public:
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::Context Context;
+    typedef ChannelInboudBufferHandler<ChannelTestHandler>::InboundContainer InboundContainer;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    ChannelTestHandler() : container_() {}
+
+    void registerTo(Context& ctx) {
+        container_ = ctx.inboundContainer();
+
+        ctx.setChannelActiveCallback(boost::bind(
+                                         &ChannelTestHandler::channelActive,
+                                         this,
+                                         _1));
+
+        ctx.setChannelMessageUpdatedCallback(boost::bind(
+                &ChannelTestHandler::messageUpdated,
+                this,
+                _1));
+    }
+
+private:
+    void channelActive(ChannelHandlerContext& ctx) {
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel =
+            boost::dynamic_pointer_cast<UringSocketChannel>(ctx.channel());
+    }
+
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        const ChannelBufferPtr& buffer = container_->getMessages();
+
+        if (!buffer) {
+            return;
+        }
+
+        int bytes = buffer->readableBytes();
+        readBytes.addAndGet(bytes);
+
+        if (echo.get() && bytes) {
+            ctx.channel()->writeBuffer(buffer->copy());
+        }
+
+        buffer->skipBytes(bytes);
+    }
+
+private:
+    InboundContainer* container_;
+};
+
+static bool initializeChild(ChannelPipeline& pipeline) {
+    pipeline.addLast<ChannelTestHandler::HandlerPtr>("test",
+            ChannelTestHandler::HandlerPtr(new ChannelTestHandler));
+
+    return true;
+}
+
+static std::string pattern(int size, char first) {
+    std::string bytes;
+
+    for (int i = 0; i < size; ++i) {
+        bytes += static_cast<char>(first + i % 26);
+    }
+
+    return bytes;
+}
+
+static ChannelBufferPtr newBuffer(int size, char first) {
+    return Unpooled::copiedBuffer(pattern(size, first));
+}
+
+static bool isNonBlocking(int fd) {
+    return (::fcntl(fd, F_GETFL) & O_NONBLOCK) != 0;
+}
+
+static void countCompleted(ChannelFuture& future,
+                           std::vector<int>* completed,
+                           int index) {
+    completed->push_back(future.isSuccess() ? index : -1 - index);
+}
+
+static void writeBuffers(const UringSocketChannelPtr& channel,
+                         const std::vector<ChannelBufferPtr>* buffers,
+                         std::vector<int>* completed) {
+    for (std::size_t i = 0; i < buffers->size(); ++i) {
+        ChannelFuturePtr future = channel->newFuture();
+        future->addListener(boost::bind(&countCompleted,
+                                        _1,
+                                        completed,
+                                        static_cast<int>(i)));
+
+        channel->writeBuffer((*buffers)[i], future);
+    }
+}
+
+static void closeChannel(const UringSocketChannelPtr& channel) {
+    channel->close();
+}
+
+/**
+ * skipped when the kernel (or the seccomp of the container) does not allow
+ * the io_uring, {@link UringEventLoopPool#create} falls back to asio then.
+ */
+class UringSocketChannelTest : public testing::Test {
+public:
+    UringSocketChannelTest()
+        : server(UringEventLoopPool::create(1)),
+          client(ioService) {
+        server.setChildInitializer(boost::bind(&initializeChild, _1));
+        server.setOption(ChannelOption::CO_SO_REUSEADDR, true);
+
+        readBytes.set(0);
+        echo.set(0);
+    }
+
+    virtual ~UringSocketChannelTest() {
+        boost::system::error_code ec;
+        client.close(ec);
+
+        server.shutdown();
+
+        boost::lock_guard<boost::mutex> lock(acceptedMutex);
+        acceptedChannel.reset();
+    }
+
+    virtual void SetUp() {
+        if (!IoUring::isSupported()) {
+            GTEST_SKIP();
+        }
+    }
+
+    // binds the server to the <tt>port</tt> and connects to it, returns
+    // the accepted channel, each test binds its own port.
+    UringSocketChannelPtr connect(int port, int clientReceiveBufferSize = 0) {
+        if (!server.bind(port)->await()->isSuccess()) {
+            return UringSocketChannelPtr();
+        }
+
+        boost::asio::ip::tcp::endpoint ep(
+            boost::asio::ip::address::from_string("127.0.0.1"), port);
+
+        client.open(ep.protocol());
+
+        if (clientReceiveBufferSize) {
+            client.set_option(boost::asio::socket_base::receive_buffer_size(
+                                  clientReceiveBufferSize));
+        }
+
+        client.connect(ep);
+
+        for (int i = 0; i < 500; ++i) {
+            {
+                boost::lock_guard<boost::mutex> lock(acceptedMutex);
+
+                if (acceptedChannel) {
+                    return acceptedChannel;
+                }
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return UringSocketChannelPtr();
+    }
+
+    // writes the buffers in the loop of the channel, all at once.
+    void write(const UringSocketChannelPtr& channel,
+               const std::vector<ChannelBufferPtr>& buffers) {
+        channel->eventLoop()->post(boost::bind(&writeBuffers,
+                                               channel,
+                                               &buffers,
+                                               &completed));
+    }
+
+    std::string receive(int bytes) {
+        std::string received(bytes, '\0');
+        boost::asio::read(client, boost::asio::buffer(&received[0], bytes));
+        return received;
+    }
+
+    // waits till the writes are queued and the socket send buffer is full.
+    static bool waitForPending(const UringSocketChannelPtr& channel) {
+        for (int i = 0; i < 500 && channel->writeBufferSize() == 0; ++i) {
+            usleep(10 * 1000);
+        }
+
+        // let the sendmsg park on the full socket.
+        usleep(50 * 1000);
+        return channel->writeBufferSize() > 0;
+    }
+
+    bool waitForCompleted(const UringSocketChannelPtr& channel, int count) {
+        for (int i = 0; i < 500; ++i) {
+            if (channel->writeBufferSize() == 0
+                    && static_cast<int>(completed.size()) >= count) {
+                return true;
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return false;
+    }
+
+    ServerBootstrap server;
+
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::socket client;
+
+    // the indexes of the completed writes, negative if failed,
+    // only touched in the loop thread until the writes are done.
+    std::vector<int> completed;
+};
+
+TEST_F(UringSocketChannelTest, testEcho) {
+    echo.set(1);
+
+    UringSocketChannelPtr channel = connect(PORT);
+    ASSERT_TRUE(channel);
+
+    // the accepted socket is non-blocking, the recv and sendmsg still
+    // wait in the ring for the socket to be ready.
+    ASSERT_TRUE(isNonBlocking(channel->fd()));
+
+    std::string data = pattern(256 * 1024, 'a');
+    boost::asio::write(client, boost::asio::buffer(data));
+
+    ASSERT_EQ(data, receive(static_cast<int>(data.size())));
+    ASSERT_EQ(static_cast<int>(data.size()), readBytes.get());
+}
+
+TEST_F(UringSocketChannelTest, testPartialWrite) {
+    server.setChildOption(ChannelOption::CO_SO_SNDBUF, 4096);
+
+    UringSocketChannelPtr channel = connect(PORT + 1, 4096);
+    ASSERT_TRUE(channel);
+
+    // far more than the socket buffers hold, the rest of a short sendmsg
+    // is sent with the next one.
+    std::vector<ChannelBufferPtr> buffers;
+    std::string expected;
+
+    for (int i = 0; i < 8; ++i) {
+        buffers.push_back(Unpooled::wrappedBuffer(newBuffer(100 * 1000, 'a' + i),
+                          newBuffer(28 * 1024, 'A' + i)));
+        expected += pattern(100 * 1000, 'a' + i) + pattern(28 * 1024, 'A' + i);
+    }
+
+    write(channel, buffers);
+    ASSERT_TRUE(waitForPending(channel));
+
+    ASSERT_EQ(expected, receive(static_cast<int>(expected.size())));
+    ASSERT_TRUE(waitForCompleted(channel, 8));
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i, completed[i]);
+    }
+}
+
+TEST_F(UringSocketChannelTest, testCloseWhileWritePending) {
+    server.setChildOption(ChannelOption::CO_SO_SNDBUF, 4096);
+
+    UringSocketChannelPtr channel = connect(PORT + 2, 4096);
+    ASSERT_TRUE(channel);
+
+    std::vector<ChannelBufferPtr> buffers;
+
+    for (int i = 0; i < 8; ++i) {
+        buffers.push_back(newBuffer(1024 * 1024, 'a'));
+    }
+
+    write(channel, buffers);
+    ASSERT_TRUE(waitForPending(channel));
+
+    channel->eventLoop()->post(boost::bind(&closeChannel, channel));
+    ASSERT_TRUE(channel->closeFuture()->await()->isSuccess());
+
+    // the sendmsg in flight is cancelled, the writes not done fail.
+    ASSERT_TRUE(waitForCompleted(channel, 8));
+    ASSERT_GT(0, completed.back());
+    ASSERT_FALSE(channel->isOpen());
+}
+
+TEST_F(UringSocketChannelTest, testConnect) {
+    boost::asio::ip::tcp::endpoint ep(
+        boost::asio::ip::address::from_string("127.0.0.1"), PORT + 3);
+
+    boost::asio::ip::tcp::acceptor acceptor(ioService, ep);
+
+    ClientBootstrap bootstrap(UringEventLoopPool::create(1));
+    bootstrap.setInitializer(boost::bind(&initializeChild, _1));
+
+    ChannelFuturePtr future = bootstrap.connect("127.0.0.1", PORT + 3);
+    acceptor.accept(client);
+
+    // the connect of a non-blocking socket completes in the ring.
+    ASSERT_TRUE(future->await()->isSuccess());
+
+    UringSocketChannelPtr channel =
+        boost::dynamic_pointer_cast<UringSocketChannel>(future->channel());
+
+    ASSERT_TRUE(channel);
+    ASSERT_TRUE(isNonBlocking(channel->fd()));
+
+    std::vector<ChannelBufferPtr> buffers;
+    buffers.push_back(newBuffer(1000, 'a'));
+    write(channel, buffers);
+
+    ASSERT_EQ(pattern(1000, 'a'), receive(1000));
+    ASSERT_TRUE(waitForCompleted(channel, 1));
+
+    channel->eventLoop()->post(boost::bind(&closeChannel, channel));
+    ASSERT_TRUE(channel->closeFuture()->await()->isSuccess());
+
+    bootstrap.shutdown();
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/codec/MessageToMessageDecoder.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::embedded;
+using namespace cetty::handler::codec;
+
+typedef ChannelMessageContainer<ChannelBufferPtr, MESSAGE_BLOCK> BufferContainer;
+
+/**
+ * passes the buffers through, but fails on the ones starting with "bad".
+ */
+class FailingDecoder : private boost::noncopyable {
+public:
+    typedef MessageToMessageDecoder<FailingDecoder,
+            ChannelBufferPtr,
+            ChannelBufferPtr> Decoder;
+
+    typedef Decoder::Context Context;
+    typedef Decoder::HandlerPtr HandlerPtr;
+
+public:
+    FailingDecoder() : decoded(0) {
+        decoder_.setDecoder(boost::bind(&FailingDecoder::decode, this, _1, _2));
+    }
+
+    void registerTo(Context& ctx) {
+        decoder_.registerTo(ctx);
+    }
+
+    ChannelBufferPtr decode(ChannelHandlerContext& ctx,
+                            const ChannelBufferPtr& msg) {
+        ++decoded;
+
+        if (msg->readableBytes() >= 3 && msg->getByte(0) == 'b'
+                && msg->getByte(1) == 'a' && msg->getByte(2) == 'd') {
+            throw DecoderException("bad message");
+        }
+
+        return msg;
+    }
+
+public:
+    int decoded;
+
+private:
+    Decoder decoder_;
+};
+
+/**
+ * stands for the handler after the decoder, keeps the messages and the
+ * exceptions.
+ */
+class NextContext : public ChannelHandlerContext {
+public:
+    NextContext(const EventLoopPtr& eventLoop)
+        : ChannelHandlerContext("next", eventLoop),
+          exceptions(0) {
+        container.setEventLoop(eventLoop);
+
+        setExceptionCallback(boost::bind(&NextContext::exceptionCaught,
+                                         this,
+                                         _1,
+                                         _2));
+    }
+
+    void exceptionCaught(ChannelHandlerContext& ctx,
+                         const ChannelException& cause) {
+        ++exceptions;
+    }
+
+    virtual boost::any getInboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    virtual boost::any getOutboundMessageContainer() {
+        return boost::any();
+    }
+
+public:
+    int exceptions;
+    BufferContainer container;
+};
+
+class MessageToMessageDecoderTest : public ::testing::Test {
+protected:
+    MessageToMessageDecoderTest()
+        : eventLoop(new EmbeddedEventLoop),
+          next(eventLoop),
+          decoder(new FailingDecoder) {
+        ctx.reset(new FailingDecoder::Context("decoder", decoder, eventLoop));
+        ctx->inboundContainer()->setEventLoop(eventLoop);
+        ctx->setNext(&next);
+    }
+
+    void write(const std::string& message) {
+        ctx->inboundContainer()->addMessage(Unpooled::copiedBuffer(message));
+    }
+
+    void messageUpdated() {
+        ctx->channelMessageUpdatedCallback()(*ctx);
+    }
+
+    std::vector<std::string> received() {
+        std::vector<std::string> messages;
+        BufferContainer::MessageQueue& queue = next.container.getMessages();
+
+        while (!queue.empty()) {
+            std::string bytes;
+            queue.front()->readBytes(&bytes);
+            messages.push_back(bytes);
+            queue.pop_front();
+        }
+
+        return messages;
+    }
+
+protected:
+    EventLoopPtr eventLoop;
+    NextContext next;
+
+    FailingDecoder::HandlerPtr decoder;
+    boost::scoped_ptr<FailingDecoder::Context> ctx;
+};
+
+TEST_F(MessageToMessageDecoderTest, testDropFailedMessage) {
+    write("first");
+    write("bad one");
+    write("second");
+    messageUpdated();
+
+    // the failed message is decoded only once, the others go on.
+    ASSERT_EQ(3, decoder->decoded);
+    ASSERT_EQ(1, next.exceptions);
+    ASSERT_TRUE(ctx->inboundContainer()->empty());
+
+    std::vector<std::string> messages = received();
+    ASSERT_EQ(2U, messages.size());
+    ASSERT_EQ("first", messages[0]);
+    ASSERT_EQ("second", messages[1]);
+}
+
+TEST_F(MessageToMessageDecoderTest, testDropFailedLastMessage) {
+    write("bad");
+    messageUpdated();
+
+    ASSERT_EQ(1, decoder->decoded);
+    ASSERT_EQ(1, next.exceptions);
+    ASSERT_TRUE(ctx->inboundContainer()->empty());
+    ASSERT_TRUE(received().empty());
+}
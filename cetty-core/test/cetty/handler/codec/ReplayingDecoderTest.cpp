@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/codec/ReplayingDecoder.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::embedded;
+using namespace cetty::handler::codec;
+
+typedef ChannelMessageContainer<ChannelBufferPtr, MESSAGE_BLOCK> FrameContainer;
+
+/**
+ * decodes the frames of 4 bytes, which slice the read bytes.
+ */
+class FixedLengthFrameDecoder : private boost::noncopyable {
+public:
+    typedef ReplayingDecoder<FixedLengthFrameDecoder, ChannelBufferPtr> Decoder;
+
+    typedef Decoder::Context Context;
+    typedef Decoder::HandlerPtr HandlerPtr;
+
+public:
+    FixedLengthFrameDecoder() {
+        decoder_.setDecoder(boost::bind(&FixedLengthFrameDecoder::decode,
+                                        this,
+                                        _1,
+                                        _2,
+                                        _3));
+    }
+
+    void registerTo(Context& ctx) {
+        decoder_.registerTo(ctx);
+    }
+
+    ChannelBufferPtr decode(ChannelHandlerContext& ctx,
+                            const ReplayingDecoderBufferPtr& buffer,
+                            int state) {
+        ChannelBufferPtr frame = buffer->readSlice(4);
+
+        if (buffer->needMoreBytes()) {
+            return ChannelBufferPtr();
+        }
+
+        return frame;
+    }
+
+private:
+    Decoder decoder_;
+};
+
+/**
+ * stands for the handler after the decoder, reads the frames as soon as
+ * they are updated.
+ */
+class FrameContext : public ChannelHandlerContext {
+public:
+    FrameContext(const EventLoopPtr& eventLoop)
+        : ChannelHandlerContext("frame", eventLoop) {
+        container.setEventLoop(eventLoop);
+
+        setChannelMessageUpdatedCallback(boost::bind(
+                                             &FrameContext::messageUpdated,
+                                             this,
+                                             _1));
+    }
+
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        FrameContainer::MessageQueue& queue = container.getMessages();
+
+        while (!queue.empty()) {
+            std::string bytes;
+            queue.front()->readBytes(&bytes);
+            frames.push_back(bytes);
+            queue.pop_front();
+        }
+    }
+
+    virtual boost::any getInboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    virtual boost::any getOutboundMessageContainer() {
+        return boost::any();
+    }
+
+public:
+    std::vector<std::string> frames;
+    FrameContainer container;
+};
+
+class ReplayingDecoderTest : public ::testing::Test {
+protected:
+    ReplayingDecoderTest()
+        : eventLoop(new EmbeddedEventLoop),
+          next(eventLoop),
+          decoder(new FixedLengthFrameDecoder) {
+        ctx.reset(new FixedLengthFrameDecoder::Context("decoder",
+                  decoder,
+                  eventLoop));
+        ctx->inboundContainer()->setEventLoop(eventLoop);
+        ctx->setNext(&next);
+    }
+
+    void write(const ChannelBufferPtr& buffer) {
+        ctx->inboundContainer()->addMessage(buffer);
+        ctx->channelMessageUpdatedCallback()(*ctx);
+    }
+
+protected:
+    EventLoopPtr eventLoop;
+    FrameContext next;
+
+    FixedLengthFrameDecoder::HandlerPtr decoder;
+    boost::scoped_ptr<FixedLengthFrameDecoder::Context> ctx;
+};
+
+TEST_F(ReplayingDecoderTest, testFramesReadBeforeCompaction) {
+    ChannelBufferPtr buffer = Unpooled::buffer(16);
+    buffer->writeBytes(std::string("aaaabbbbcc"));
+
+    write(buffer);
+
+    // the frames are read before the rest "cc" is moved to the front.
+    ASSERT_EQ(2U, next.frames.size());
+    ASSERT_EQ("aaaa", next.frames[0]);
+    ASSERT_EQ("bbbb", next.frames[1]);
+
+    ASSERT_EQ(0, buffer->readerIndex());
+    ASSERT_EQ(2, buffer->readableBytes());
+
+    buffer->writeBytes(std::string("cc"));
+    write(buffer);
+
+    ASSERT_EQ(3U, next.frames.size());
+    ASSERT_EQ("cccc", next.frames[2]);
+}
@@ -15,118 +15,273 @@
  */
 
 #include <gtest/gtest.h>
-#include <cetty/channel/embedded/EmbeddedMessageChannel.h>
+#include <string>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
 
-#include <cetty/handler/codec/http/HttpMessage.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/buffer/CompositeChannelBuffer.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/codec/http/HttpChunk.h>
+#include <cetty/handler/codec/http/HttpChunkTrailer.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/handler/codec/http/HttpResponseStatus.h>
 #include <cetty/handler/codec/http/HttpChunkAggregator.h>
 
+using namespace cetty::buffer;
+using namespace cetty::channel;
 using namespace cetty::channel::embedded;
 using namespace cetty::handler::codec::http;
 
-TEST(HttpChunkAggregatorTest, testAggregate) {
-    HttpChunkAggregator aggr = new HttpChunkAggregator(1024 * 1024);
-    EmbeddedMessageChannel embedder = new EmbeddedMessageChannel(aggr);
-
-    HttpMessage message = new DefaultHttpMessage(HttpVersion.HTTP_1_1);
-    HttpHeaders.setHeader(message, "X-Test", true);
-    message.setTransferEncoding(HttpTransferEncoding.STREAMED);
-    HttpChunk chunk1 = new DefaultHttpChunk(Unpooled.copiedBuffer("test", CharsetUtil.US_ASCII));
-    HttpChunk chunk2 = new DefaultHttpChunk(Unpooled.copiedBuffer("test2", CharsetUtil.US_ASCII));
-    HttpChunk chunk3 = new DefaultHttpChunk(Unpooled.EMPTY_BUFFER);
-    assertFalse(embedder.writeInbound(message));
-    assertFalse(embedder.writeInbound(chunk1));
-    assertFalse(embedder.writeInbound(chunk2));
-
-    // this should trigger a messageReceived event so return true
-    assertTrue(embedder.writeInbound(chunk3));
-    assertTrue(embedder.finish());
-    HttpMessage aggratedMessage = (HttpMessage) embedder.readInbound();
-    assertNotNull(aggratedMessage);
-
-    assertEquals(chunk1.getContent().readableBytes() + chunk2.getContent().readableBytes(), HttpHeaders.getContentLength(aggratedMessage));
-    assertEquals(aggratedMessage.getHeader("X-Test"), Boolean.TRUE.toString());
-    checkContentBuffer(aggratedMessage);
-    assertNull(embedder.readInbound());
+typedef ChannelMessageContainer<HttpPackage, MESSAGE_BLOCK> HttpPackageContainer;
 
-}
+/**
+ * stands for the codec before and the handler after the aggregator.
+ */
+class HttpPackageContext : public ChannelHandlerContext {
+public:
+    HttpPackageContext(const EventLoopPtr& eventLoop)
+        : ChannelHandlerContext("package", eventLoop),
+          flushed(0) {
+        container.setEventLoop(eventLoop);
+
+        // keeps the written responses, the futures are never completed.
+        setFlushFunctor(boost::bind(&HttpPackageContext::onFlush, this, _1, _2));
+    }
+
+    void onFlush(ChannelHandlerContext& ctx, const ChannelFuturePtr& future) {
+        ++flushed;
+    }
+
+    virtual boost::any getInboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    virtual boost::any getOutboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    HttpPackage read() {
+        if (container.empty()) {
+            return HttpPackage();
+        }
+
+        HttpPackage package = container.getMessages().front();
+        container.getMessages().pop_front();
+        return package;
+    }
+
+public:
+    int flushed;
+    HttpPackageContainer container;
+};
 
-static void checkContentBuffer(HttpMessage aggregatedMessage) {
-    CompositeByteBuf buffer = (CompositeByteBuf) aggregatedMessage.getContent();
-    assertEquals(2, buffer.numComponents());
-    List<ByteBuf> buffers = buffer.decompose(0, buffer.capacity());
-    assertEquals(2, buffers.size());
+class HttpChunkAggregatorTest : public ::testing::Test {
+protected:
+    HttpChunkAggregatorTest()
+        : eventLoop(new EmbeddedEventLoop),
+          codec(eventLoop),
+          handler(eventLoop) {
+    }
+
+    virtual void SetUp() {
+        setUp(1024 * 1024);
+    }
+
+    void setUp(int maxContentLength) {
+        aggregator.reset(new HttpChunkAggregator(maxContentLength));
+        ctx.reset(new HttpChunkAggregator::Context("aggregator",
+                  aggregator,
+                  eventLoop));
+        ctx->inboundContainer()->setEventLoop(eventLoop);
+        ctx->setPrev(&codec);
+        ctx->setNext(&handler);
+    }
+
+    void write(const HttpPackage& package) {
+        ctx->inboundContainer()->addMessage(package);
+        ctx->channelMessageUpdatedCallback()(*ctx);
+    }
 
-    for (ByteBuf buf: buffers) {
-        // This should be false as we decompose the buffer before to not have deep hierarchy
-        assertFalse(buf instanceof CompositeByteBuf);
+    static HttpPackage request(HttpTransferEncoding te) {
+        HttpRequestPtr request(new HttpRequest(HttpVersion::HTTP_1_1,
+                                               HttpMethod::POST,
+                                               std::string("/upload")));
+        request->headers().setHeader("X-Test", "true");
+        request->setTransferEncoding(te);
+        return HttpPackage(request);
     }
+
+    static HttpPackage chunk(const std::string& content) {
+        return HttpPackage(HttpChunkPtr(
+                               new HttpChunk(Unpooled::copiedBuffer(content))));
+    }
+
+    static std::string contentOf(HttpPackage& package) {
+        StringPiece bytes;
+        package.httpRequest()->content()->readableBytes(&bytes);
+        return bytes.as_string();
+    }
+
+protected:
+    EventLoopPtr eventLoop;
+
+    HttpPackageContext codec;
+    HttpPackageContext handler;
+
+    HttpChunkAggregator::HandlerPtr aggregator;
+    boost::scoped_ptr<HttpChunkAggregator::Context> ctx;
+};
+
+TEST_F(HttpChunkAggregatorTest, testAggregate) {
+    write(request(HttpTransferEncoding::CHUNKED));
+    write(chunk("test"));
+    write(chunk("test2"));
+    ASSERT_FALSE(handler.read());
+
+    write(HttpPackage(HttpChunkTrailerPtr(new HttpChunkTrailer)));
+
+    HttpPackage aggregated = handler.read();
+    ASSERT_TRUE(aggregated.isHttpRequest());
+    ASSERT_FALSE(aggregated.transferEncoding().multiple());
+    ASSERT_FALSE(aggregated.headers()->hasHeader(
+                     HttpHeaders::HEADER_TRANSFER_ENCODING));
+    ASSERT_EQ(9, aggregated.contentLength(-1));
+    ASSERT_EQ("true", aggregated.headers()->headerValue("X-Test").as_string());
+
+    // the small chunks share one buffer.
+    ASSERT_EQ("testtest2", contentOf(aggregated));
+    ASSERT_FALSE(handler.read());
 }
 
-TEST(HttpChunkAggregatorTest,  testAggregateWithTrailer) {
-    HttpChunkAggregator aggr = new HttpChunkAggregator(1024 * 1024);
-    EmbeddedMessageChannel embedder = new EmbeddedMessageChannel(aggr);
-    HttpMessage message = new DefaultHttpMessage(HttpVersion.HTTP_1_1);
-    HttpHeaders.setHeader(message, "X-Test", true);
-    message.setTransferEncoding(HttpTransferEncoding.CHUNKED);
-    HttpChunk chunk1 = new DefaultHttpChunk(Unpooled.copiedBuffer("test", CharsetUtil.US_ASCII));
-    HttpChunk chunk2 = new DefaultHttpChunk(Unpooled.copiedBuffer("test2", CharsetUtil.US_ASCII));
-    HttpChunkTrailer trailer = new DefaultHttpChunkTrailer();
-    trailer.setHeader("X-Trailer", true);
-
-    assertFalse(embedder.writeInbound(message));
-    assertFalse(embedder.writeInbound(chunk1));
-    assertFalse(embedder.writeInbound(chunk2));
-
-    // this should trigger a messageReceived event so return true
-    assertTrue(embedder.writeInbound(trailer));
-    assertTrue(embedder.finish());
-    HttpMessage aggratedMessage = (HttpMessage) embedder.readInbound();
-    assertNotNull(aggratedMessage);
-
-    assertEquals(chunk1.getContent().readableBytes() + chunk2.getContent().readableBytes(), HttpHeaders.getContentLength(aggratedMessage));
-    assertEquals(aggratedMessage.getHeader("X-Test"), Boolean.TRUE.toString());
-    assertEquals(aggratedMessage.getHeader("X-Trailer"), Boolean.TRUE.toString());
-    checkContentBuffer(aggratedMessage);
-
-    assertNull(embedder.readInbound());
+TEST_F(HttpChunkAggregatorTest, testAggregateWithTrailer) {
+    write(request(HttpTransferEncoding::CHUNKED));
+    write(chunk("test"));
 
+    HttpChunkTrailerPtr trailer(new HttpChunkTrailer);
+    trailer->headers().setHeader("X-Trailer", "true");
+    write(HttpPackage(trailer));
+
+    HttpPackage aggregated = handler.read();
+    ASSERT_TRUE(aggregated);
+    ASSERT_EQ(4, aggregated.contentLength(-1));
+    ASSERT_EQ("true", aggregated.headers()->headerValue("X-Trailer").as_string());
 }
 
-TEST(HttpChunkAggregatorTest,  testTooLongFrameException) {
-    try {
-
-        HttpChunkAggregator aggr = new HttpChunkAggregator(4);
-        EmbeddedMessageChannel embedder = new EmbeddedMessageChannel(aggr);
-        HttpMessage message = new DefaultHttpMessage(HttpVersion.HTTP_1_1);
-        message.setTransferEncoding(HttpTransferEncoding.STREAMED);
-        HttpChunk chunk1 = new DefaultHttpChunk(Unpooled.copiedBuffer("test", CharsetUtil.US_ASCII));
-        HttpChunk chunk2 = new DefaultHttpChunk(Unpooled.copiedBuffer("test2", CharsetUtil.US_ASCII));
-        assertFalse(embedder.writeInbound(message));
-        assertFalse(embedder.writeInbound(chunk1));
-        embedder.writeInbound(chunk2);
-        fail();
-    }
-    catch (const TooLongFrameException& e) {
+TEST_F(HttpChunkAggregatorTest, testAggregateStreamed) {
+    HttpPackage message = request(HttpTransferEncoding::STREAMED);
+    message.headers()->setContentLength(9);
+    write(message);
+
+    write(chunk("test"));
+
+    // the decoder marks the last chunk of a content with Content-Length.
+    HttpPackage last = chunk("test2");
+    last.httpChunk()->setFollowLastChunk(true);
+    write(last);
+
+    HttpPackage aggregated = handler.read();
+    ASSERT_TRUE(aggregated);
+    ASSERT_EQ("testtest2", contentOf(aggregated));
+}
+
+TEST_F(HttpChunkAggregatorTest, testPassThroughSingle) {
+    HttpPackage message = request(HttpTransferEncoding::SINGLE);
+    message.setContent(Unpooled::copiedBuffer(std::string("body")));
+    write(message);
+
+    HttpPackage passed = handler.read();
+    ASSERT_TRUE(passed.httpRequest() == message.httpRequest());
+}
+
+TEST_F(HttpChunkAggregatorTest, testConsolidateComponents) {
+    aggregator->setMaxCumulationBufferComponents(3);
+    ASSERT_THROW(aggregator->setMaxCumulationBufferComponents(1),
+                 cetty::util::InvalidArgumentException);
 
+    std::string big(16 * 1024, 'a');
+    write(request(HttpTransferEncoding::CHUNKED));
+
+    for (int i = 0; i < 5; ++i) {
+        write(chunk(big));
     }
 
+    write(HttpPackage(HttpChunkTrailerPtr(new HttpChunkTrailer)));
+
+    HttpPackage aggregated = handler.read();
+    ASSERT_TRUE(aggregated);
+
+    const ChannelBufferPtr& content = aggregated.httpRequest()->content();
+    ASSERT_EQ(5 * (int)big.size(), content->readableBytes());
+    ASSERT_TRUE(boost::dynamic_pointer_cast<CompositeChannelBuffer>(content));
+
+    // the composite is merged when read as a whole.
+    StringPiece bytes;
+    content->readableBytes(&bytes);
+    ASSERT_EQ(std::string(5 * big.size(), 'a'), bytes.as_string());
 }
 
-TEST(HttpChunkAggregatorTest,  testInvalidConstructorUsage) {
-    ASSERT_THROW(new HttpChunkAggregator(0), IllegalArgumentException);
+TEST_F(HttpChunkAggregatorTest, testTooLongRequest) {
+    setUp(8);
+
+    write(request(HttpTransferEncoding::CHUNKED));
+    write(chunk("test"));
+    write(chunk("test2"));
+
+    HttpPackage response = codec.read();
+    ASSERT_TRUE(response.isHttpResponse());
+    ASSERT_EQ(HttpResponseStatus::REQUEST_ENTITY_TOO_LARGE.code(),
+              response.httpResponse()->status().code());
+    ASSERT_FALSE(response.httpResponse()->keepAlive());
+
+    // the rest of the content is discarded.
+    write(chunk("test3"));
+    write(HttpPackage(HttpChunkTrailerPtr(new HttpChunkTrailer)));
+    ASSERT_FALSE(handler.read());
+
+    // the next request is aggregated again.
+    write(request(HttpTransferEncoding::CHUNKED));
+    write(chunk("test"));
+    write(HttpPackage(HttpChunkTrailerPtr(new HttpChunkTrailer)));
+    ASSERT_TRUE(handler.read());
 }
 
-@Test(expected = IllegalArgumentException.class)
-TEST(HttpChunkAggregatorTest,  testInvalidMaxCumulationBufferComponents) {
-    HttpChunkAggregator aggr= new HttpChunkAggregator(Integer.MAX_VALUE);
-    aggr.setMaxCumulationBufferComponents(1);
+TEST_F(HttpChunkAggregatorTest, testTooLongContentLength) {
+    setUp(8);
+
+    HttpPackage message = request(HttpTransferEncoding::STREAMED);
+    message.headers()->setContentLength(9);
+    write(message);
+
+    HttpPackage response = codec.read();
+    ASSERT_TRUE(response.isHttpResponse());
+    ASSERT_EQ(HttpResponseStatus::REQUEST_ENTITY_TOO_LARGE.code(),
+              response.httpResponse()->status().code());
 }
 
-@Test(expected = IllegalStateException.class)
-TEST(HttpChunkAggregatorTest, testSetMaxCumulationBufferComponentsAfterInit) {
-    HttpChunkAggregator aggr = new HttpChunkAggregator(Integer.MAX_VALUE);
-    ChannelHandlerContext ctx = EasyMock.createMock(ChannelHandlerContext.class);
-    EasyMock.replay(ctx);
-    aggr.beforeAdd(ctx);
-    aggr.setMaxCumulationBufferComponents(10);
+TEST_F(HttpChunkAggregatorTest, test100Continue) {
+    HttpPackage message = request(HttpTransferEncoding::STREAMED);
+    message.headers()->setContentLength(4);
+    message.headers()->setHeader(HttpHeaders::Names::EXPECT,
+                                 HttpHeaders::Values::CONTINUE);
+    write(message);
+
+    HttpPackage response = codec.read();
+    ASSERT_EQ(1, codec.flushed);
+    ASSERT_TRUE(response.isHttpResponse());
+    ASSERT_EQ(HttpResponseStatus::CONTINUE.code(),
+              response.httpResponse()->status().code());
+
+    HttpPackage last = chunk("test");
+    last.httpChunk()->setFollowLastChunk(true);
+    write(last);
+
+    HttpPackage aggregated = handler.read();
+    ASSERT_TRUE(aggregated);
+    ASSERT_FALSE(aggregated.headers()->hasHeader(HttpHeaders::HEADER_EXPECT));
+    ASSERT_EQ("test", contentOf(aggregated));
 }
@@ -14,42 +14,490 @@
  * under the License.
  */
 
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <string>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
 
-public class HttpContentCompressorTest {
-    @Test
-    public void testGetTargetContentEncoding() throws Exception {
-        HttpContentCompressor compressor = new HttpContentCompressor();
-
-        String[] tests = {
-            // Accept-Encoding -> Content-Encoding
-            "", null,
-            "*", "gzip",
-            "*;q=0.0", null,
-            "gzip", "gzip",
-            "compress, gzip;q=0.5", "gzip",
-            "gzip; q=0.5, identity", "gzip",
-            "gzip ; q=0.1", "gzip",
-            "gzip; q=0, deflate", "deflate",
-            " deflate ; q=0 , *;q=0.5", "gzip",
-        };
-        for (int i = 0; i < tests.length; i += 2) {
-            String acceptEncoding = tests[i];
-            String contentEncoding = tests[i + 1];
-            ZlibWrapper targetWrapper = compressor.determineWrapper(acceptEncoding);
-            String targetEncoding = null;
-            if (targetWrapper != null) {
-                switch (targetWrapper) {
-                case GZIP:
-                    targetEncoding = "gzip";
-                    break;
-                case ZLIB:
-                    targetEncoding = "deflate";
-                    break;
-                default:
-                    Assert.fail();
-                }
-            }
-            Assert.assertEquals(contentEncoding, targetEncoding);
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/codec/http/HttpChunk.h>
+#include <cetty/handler/codec/http/HttpChunkTrailer.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/handler/codec/http/HttpResponseStatus.h>
+#include <cetty/handler/codec/http/HttpContentCompressor.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::embedded;
+using namespace cetty::handler::codec::http;
+
+typedef ChannelMessageContainer<HttpPackage, MESSAGE_BLOCK> HttpPackageContainer;
+
+/**
+ * stands for the codec before and the handler after the compressor.
+ */
+class HttpPackageContext : public ChannelHandlerContext {
+public:
+    HttpPackageContext(const EventLoopPtr& eventLoop)
+        : ChannelHandlerContext("package", eventLoop) {
+        container.setEventLoop(eventLoop);
+
+        // keeps the written responses, the futures are never completed.
+        setFlushFunctor(boost::bind(&HttpPackageContext::onFlush, this, _1, _2));
+    }
+
+    void onFlush(ChannelHandlerContext& ctx, const ChannelFuturePtr& future) {
+    }
+
+    virtual boost::any getInboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    virtual boost::any getOutboundMessageContainer() {
+        return boost::any(&container);
+    }
+
+    HttpPackage read() {
+        if (container.empty()) {
+            return HttpPackage();
+        }
+
+        HttpPackage package = container.getMessages().front();
+        container.getMessages().pop_front();
+        return package;
+    }
+
+public:
+    HttpPackageContainer container;
+};
+
+static std::string bytesOf(const ChannelBufferPtr& buffer) {
+    StringPiece bytes;
+    buffer->readableBytes(&bytes);
+    return bytes.as_string();
+}
+
+// inflates both the gzip and the zlib format.
+static std::string inflateContent(const std::string& compressed) {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = (Bytef*)compressed.data();
+    stream.avail_in = (uInt)compressed.size();
+
+    inflateInit2(&stream, 32 + MAX_WBITS);
+
+    std::string content;
+    char out[4096];
+    int ret;
+
+    do {
+        stream.next_out = (Bytef*)out;
+        stream.avail_out = sizeof(out);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        content.append(out, sizeof(out) - stream.avail_out);
+    }
+    while (ret == Z_OK);
+
+    inflateEnd(&stream);
+    return ret == Z_STREAM_END ? content : std::string("<broken>");
+}
+
+static std::string catalog() {
+    std::string json("[");
+
+    for (int i = 0; i < 1000; ++i) {
+        json += "{\"id\":1,\"name\":\"item\",\"price\":9.99},";
+    }
+
+    json += "{}]";
+    return json;
+}
+
+class HttpContentCompressorTest : public ::testing::Test {
+protected:
+    HttpContentCompressorTest()
+        : eventLoop(new EmbeddedEventLoop),
+          codec(eventLoop),
+          handler(eventLoop) {
+    }
+
+    virtual void SetUp() {
+        compressor.reset(new HttpContentCompressor);
+        ctx.reset(new HttpContentCompressor::Context("deflater",
+                  compressor,
+                  eventLoop));
+        ctx->inboundContainer()->setEventLoop(eventLoop);
+        ctx->outboundContainer()->setEventLoop(eventLoop);
+        ctx->setPrev(&codec);
+        ctx->setNext(&handler);
+    }
+
+    void request(const std::string& acceptEncoding) {
+        request(acceptEncoding, HttpVersion::HTTP_1_1);
+    }
+
+    void request(const std::string& acceptEncoding, const HttpVersion& version) {
+        HttpRequestPtr request(new HttpRequest(version,
+                                               HttpMethod::GET,
+                                               std::string("/catalog")));
+
+        if (!acceptEncoding.empty()) {
+            request->headers().setHeader(HttpHeaders::Names::ACCEPT_ENCODING,
+                                         acceptEncoding);
+        }
+
+        ctx->inboundContainer()->addMessage(HttpPackage(request));
+        ctx->channelMessageUpdatedCallback()(*ctx);
+        handler.read();
+    }
+
+    void write(const HttpPackage& package) {
+        ctx->outboundContainer()->addMessage(package);
+        ctx->flushFunctor()(*ctx, ctx->newFuture());
+    }
+
+    static HttpResponsePtr response(const std::string& contentType,
+                                    const std::string& content) {
+        HttpResponsePtr response(new HttpResponse(HttpVersion::HTTP_1_1,
+                                 HttpResponseStatus::OK));
+        response->headers().setHeader(HttpHeaders::Names::CONTENT_TYPE, contentType);
+        response->setContent(Unpooled::copiedBuffer(content));
+        response->headers().setContentLength((int)content.size());
+        return response;
+    }
+
+    static HttpPackage chunk(const std::string& content) {
+        return HttpPackage(HttpChunkPtr(
+                               new HttpChunk(Unpooled::copiedBuffer(content))));
+    }
+
+protected:
+    EventLoopPtr eventLoop;
+
+    HttpPackageContext codec;
+    HttpPackageContext handler;
+
+    HttpContentCompressor::HandlerPtr compressor;
+    boost::scoped_ptr<HttpContentCompressor::Context> ctx;
+};
+
+TEST(HttpContentCompressorWrapperTest, testGetTargetContentEncoding) {
+    const char* tests[] = {
+        // Accept-Encoding -> Content-Encoding
+        "", NULL,
+        "*", "gzip",
+        "*;q=0.0", NULL,
+        "gzip", "gzip",
+        "compress, gzip;q=0.5", "gzip",
+        "gzip; q=0.5, identity", "gzip",
+        "gzip ; q=0.1", "gzip",
+        "gzip; q=0, deflate", "deflate",
+        " deflate ; q=0 , *;q=0.5", "gzip",
+    };
+
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i += 2) {
+        const char* acceptEncoding = tests[i];
+        const char* contentEncoding = tests[i + 1];
+        HttpContentCompressor::ZlibWrapper targetWrapper =
+            HttpContentCompressor::determineWrapper(acceptEncoding);
+
+        const char* targetEncoding = NULL;
+
+        switch (targetWrapper) {
+        case HttpContentCompressor::GZIP:
+            targetEncoding = "gzip";
+            break;
+
+        case HttpContentCompressor::ZLIB:
+            targetEncoding = "deflate";
+            break;
+
+        default:
+            break;
+        }
+
+        if (contentEncoding) {
+            ASSERT_STREQ(contentEncoding, targetEncoding) << acceptEncoding;
+        }
+        else {
+            ASSERT_TRUE(targetEncoding == NULL) << acceptEncoding;
+        }
+    }
+}
+
+TEST_F(HttpContentCompressorTest, testIsCompressible) {
+    ASSERT_TRUE(compressor->isCompressible("application/json"));
+    ASSERT_TRUE(compressor->isCompressible("Application/JSON; charset=utf-8"));
+    ASSERT_TRUE(compressor->isCompressible("text/html"));
+    ASSERT_FALSE(compressor->isCompressible("text/"));
+    ASSERT_FALSE(compressor->isCompressible("image/png"));
+    ASSERT_FALSE(compressor->isCompressible(""));
+
+    compressor->addCompressibleContentType("application/x-protobuf");
+    ASSERT_TRUE(compressor->isCompressible("application/x-protobuf"));
+}
+
+TEST_F(HttpContentCompressorTest, testCompressSingle) {
+    std::string json = catalog();
+
+    request("gzip, deflate");
+    write(HttpPackage(response("application/json", json)));
+
+    HttpPackage package = codec.read();
+    HttpResponsePtr compressed = package.httpResponse();
+    ASSERT_TRUE(compressed);
+
+    const HttpHeaders& headers = compressed->headers();
+    ASSERT_EQ("gzip", headers.headerValue(HttpHeaders::HEADER_CONTENT_ENCODING).as_string());
+    ASSERT_EQ("Accept-Encoding", headers.headerValue(HttpHeaders::HEADER_VARY).as_string());
+    ASSERT_EQ(compressed->content()->readableBytes(), compressed->contentLength(-1));
+    ASSERT_LT(compressed->content()->readableBytes(), (int)json.size() / 10);
+
+    // the response headers can be prepended without a copy.
+    ASSERT_GT(compressed->content()->aheadWritableBytes(), 256);
+
+    ASSERT_EQ(json, inflateContent(bytesOf(compressed->content())));
+}
+
+TEST_F(HttpContentCompressorTest, testPipelinedRequests) {
+    std::string json = catalog();
+
+    request("deflate");
+    request("");
+
+    write(HttpPackage(response("application/json", json)));
+    write(HttpPackage(response("application/json", json)));
+
+    HttpResponsePtr deflated = codec.read().httpResponse();
+    ASSERT_EQ("deflate", deflated->headers().headerValue(
+                  HttpHeaders::HEADER_CONTENT_ENCODING).as_string());
+    ASSERT_EQ(json, inflateContent(bytesOf(deflated->content())));
+
+    HttpResponsePtr identity = codec.read().httpResponse();
+    ASSERT_FALSE(identity->headers().hasHeader(HttpHeaders::HEADER_CONTENT_ENCODING));
+    ASSERT_EQ("Accept-Encoding", identity->headers().headerValue(
+                  HttpHeaders::HEADER_VARY).as_string());
+    ASSERT_EQ(json, bytesOf(identity->content()));
+}
+
+TEST_F(HttpContentCompressorTest, testNotCompressed) {
+    std::string json = catalog();
+
+    // too short.
+    request("gzip");
+    write(HttpPackage(response("application/json", "{}")));
+    ASSERT_FALSE(codec.read().httpResponse()->headers().hasHeader(
+                     HttpHeaders::HEADER_CONTENT_ENCODING));
+
+    // not in the content types.
+    request("gzip");
+    write(HttpPackage(response("image/png", json)));
+    ASSERT_FALSE(codec.read().httpResponse()->headers().hasHeader(
+                     HttpHeaders::HEADER_CONTENT_ENCODING));
+
+    // encoded already.
+    request("gzip");
+    HttpResponsePtr encoded = response("application/json", json);
+    encoded->headers().setHeader(HttpHeaders::Names::CONTENT_ENCODING, "br");
+    write(HttpPackage(encoded));
+    ASSERT_EQ(json, bytesOf(codec.read().httpResponse()->content()));
+}
+
+TEST_F(HttpContentCompressorTest, testCompressChunked) {
+    request("gzip");
+
+    HttpResponsePtr message(new HttpResponse(HttpVersion::HTTP_1_1,
+                            HttpResponseStatus::OK));
+    message->headers().setHeader(HttpHeaders::Names::CONTENT_TYPE, "text/plain");
+    message->setTransferEncoding(HttpTransferEncoding::CHUNKED);
+    write(HttpPackage(message));
+
+    HttpResponsePtr compressed = codec.read().httpResponse();
+    ASSERT_EQ("gzip", compressed->headers().headerValue(
+                  HttpHeaders::HEADER_CONTENT_ENCODING).as_string());
+    ASSERT_TRUE(compressed->transferEncoding() == HttpTransferEncoding::CHUNKED);
+
+    std::string expected;
+    std::string received;
+
+    for (int i = 0; i < 3; ++i) {
+        std::string content(2000, 'a' + i);
+        expected += content;
+        write(chunk(content));
+
+        // each chunk is flushed, no waiting for the rest.
+        HttpPackage compressedChunk = codec.read();
+        ASSERT_TRUE(compressedChunk.isHttpChunk());
+        received += bytesOf(compressedChunk.httpChunk()->getContent());
+    }
+
+    write(HttpPackage(HttpChunkTrailerPtr(new HttpChunkTrailer)));
+
+    // the end of the gzip stream goes before the trailer.
+    HttpPackage tail = codec.read();
+    ASSERT_TRUE(tail.isHttpChunk());
+    received += bytesOf(tail.httpChunk()->getContent());
+    ASSERT_TRUE(codec.read().isHttpChunkTrailer());
+
+    ASSERT_EQ(expected, inflateContent(received));
+}
+
+TEST_F(HttpContentCompressorTest, testCache) {
+    HttpCompressedContentCachePtr cache(new HttpCompressedContentCache(1024 * 1024));
+    compressor->setCache(cache);
+
+    std::string json = catalog();
+    std::string first;
+
+    for (int i = 0; i < 3; ++i) {
+        request("gzip");
+        write(HttpPackage(response("application/json", json)));
+
+        std::string compressed = bytesOf(codec.read().httpResponse()->content());
+        ASSERT_EQ(json, inflateContent(compressed));
+
+        if (i == 0) {
+            first = compressed;
         }
+        else {
+            ASSERT_EQ(first, compressed);
+        }
+    }
+
+    ASSERT_EQ(1, cache->count());
+    ASSERT_EQ(2, cache->hits());
+    ASSERT_EQ(1, cache->misses());
+
+    // the other encoding is another entry.
+    request("deflate");
+    write(HttpPackage(response("application/json", json)));
+    codec.read();
+    ASSERT_EQ(2, cache->count());
+
+    // keyed by the strong ETag of the URI.
+    for (int i = 0; i < 2; ++i) {
+        request("gzip");
+        HttpResponsePtr tagged = response("application/json", json);
+        tagged->headers().setHeader(HttpHeaders::Names::ETAG, "\"v1\"");
+        write(HttpPackage(tagged));
+        ASSERT_EQ(json, inflateContent(bytesOf(codec.read().httpResponse()->content())));
+    }
+
+    ASSERT_EQ(3, cache->count());
+    ASSERT_EQ(3, cache->hits());
+
+    // the changed content has another ETag.
+    std::string changed = json;
+    changed[1] = ' ';
+
+    for (int i = 0; i < 2; ++i) {
+        request("gzip");
+        HttpResponsePtr tagged = response("application/json", changed);
+        tagged->headers().setHeader(HttpHeaders::Names::ETAG, "\"v2\"");
+        write(HttpPackage(tagged));
+        ASSERT_EQ(changed,
+                  inflateContent(bytesOf(codec.read().httpResponse()->content())));
     }
+
+    ASSERT_EQ(4, cache->count());
+    ASSERT_EQ(4, cache->hits());
+
+    // a weak ETag does not identify the content, keyed by the digest.
+    request("gzip");
+    HttpResponsePtr weak = response("application/json", changed);
+    weak->headers().setHeader(HttpHeaders::Names::ETAG, "W/\"v2\"");
+    write(HttpPackage(weak));
+    ASSERT_EQ(changed, inflateContent(bytesOf(codec.read().httpResponse()->content())));
+    ASSERT_EQ(5, cache->count());
+}
+
+TEST_F(HttpContentCompressorTest, testChunkedHttp10NotCompressed) {
+    request("gzip", HttpVersion::HTTP_1_0);
+
+    // the version of the request counts, the response may be a HTTP/1.1 one.
+    HttpResponsePtr message(new HttpResponse(HttpVersion::HTTP_1_1,
+                            HttpResponseStatus::OK));
+    message->headers().setHeader(HttpHeaders::Names::CONTENT_TYPE, "text/plain");
+    message->setTransferEncoding(HttpTransferEncoding::STREAMED);
+    write(HttpPackage(message));
+
+    HttpResponsePtr response = codec.read().httpResponse();
+    ASSERT_FALSE(response->headers().hasHeader(
+                     HttpHeaders::HEADER_CONTENT_ENCODING));
+    ASSERT_TRUE(response->transferEncoding() == HttpTransferEncoding::STREAMED);
+
+    std::string content(2000, 'a');
+    write(chunk(content));
+    ASSERT_EQ(content, bytesOf(codec.read().httpChunk()->getContent()));
+}
+
+TEST(HttpCompressedContentCacheTest, testEvict) {
+    HttpCompressedContentCache cache(400);
+    HttpCompressedContentCache::Digest digest;
+    HttpCompressedContentCache::ContentPtr content(new std::string(100, 'a'));
+
+    cache.put("a", digest, content);
+    cache.put("b", digest, content);
+    cache.put("c", digest, content);
+    cache.put("d", digest, content);
+    ASSERT_EQ(400, cache.size());
+
+    // "a" becomes the most recently used one, "b" is evicted.
+    ASSERT_TRUE(cache.get("a", digest));
+    cache.put("e", digest, content);
+
+    ASSERT_EQ(4, cache.count());
+    ASSERT_FALSE(cache.get("b", digest));
+    ASSERT_TRUE(cache.get("a", digest));
+    ASSERT_TRUE(cache.get("e", digest));
+
+    // too large to cache.
+    cache.put("f", digest,
+              HttpCompressedContentCache::ContentPtr(new std::string(101, 'f')));
+    ASSERT_FALSE(cache.get("f", digest));
+}
+
+TEST(HttpCompressedContentCacheTest, testDigestMismatch) {
+    HttpCompressedContentCache cache(400);
+    std::string a(10, 'a');
+    std::string b(20, 'b');
+
+    HttpCompressedContentCache::Digest digestA =
+        HttpCompressedContentCache::digest(a.data(), (int)a.size());
+    HttpCompressedContentCache::Digest digestB =
+        HttpCompressedContentCache::digest(b.data(), (int)b.size());
+
+    cache.put("key", digestA, HttpCompressedContentCache::ContentPtr(
+                  new std::string(a)));
+    ASSERT_TRUE(cache.get("key", digestA));
+    ASSERT_FALSE(cache.get("key", digestB));
+
+    // replaced by the content of the other digest.
+    cache.put("key", digestB, HttpCompressedContentCache::ContentPtr(
+                  new std::string(b)));
+    ASSERT_EQ(1, cache.count());
+    ASSERT_EQ(20, cache.size());
+    ASSERT_FALSE(cache.get("key", digestA));
+    ASSERT_EQ(b, *cache.get("key", digestB));
+}
+
+TEST(HttpCompressedContentCacheTest, testDigest) {
+    std::string a(1001, 'a');
+    std::string b(a);
+    b[1000] = 'b';
+
+    ASSERT_TRUE(HttpCompressedContentCache::digest(a.data(), (int)a.size())
+                == HttpCompressedContentCache::digest(a.data(), (int)a.size()));
+    ASSERT_TRUE(HttpCompressedContentCache::digest(a.data(), (int)a.size())
+                != HttpCompressedContentCache::digest(b.data(), (int)b.size()));
+    ASSERT_TRUE(HttpCompressedContentCache::digest(a.data(), 8)
+                != HttpCompressedContentCache::digest(a.data(), 9));
 }
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <cetty/handler/codec/http/HttpHeaderScanner.h>
+
+using namespace cetty::util;
+using namespace cetty::handler::codec::http;
+
+static const char* REQUEST =
+    "GET /index.html?q=a%20long%20enough%20query%20string HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:10.0) Gecko/20100101 Firefox/10.0\r\n"
+    "Accept:text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "X-Empty:\r\n"
+    "Connection: keep-alive  \r\n"
+    "\r\n"
+    "body";
+
+static void scanAll(void (*test)(const HttpHeaderScanner& scanner)) {
+    HttpHeaderScanner::Implementation implementations[] = {
+        HttpHeaderScanner::SCALAR,
+        HttpHeaderScanner::SSE42,
+        HttpHeaderScanner::AVX2
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        if (HttpHeaderScanner::isSupported(implementations[i])) {
+            SCOPED_TRACE(HttpHeaderScanner::implementationName(implementations[i]));
+            test(HttpHeaderScanner(implementations[i]));
+        }
+    }
+}
+
+static void scanRequest(const HttpHeaderScanner& scanner) {
+    std::string request(REQUEST);
+    HttpHeaderScanner::Block block;
+
+    int size = scanner.scan(request.data(), (int)request.size(), &block);
+    ASSERT_EQ((int)request.size() - 4, size);
+
+    ASSERT_EQ("GET", block.initialLine[0].as_string());
+    ASSERT_EQ("/index.html?q=a%20long%20enough%20query%20string",
+              block.initialLine[1].as_string());
+    ASSERT_EQ("HTTP/1.1", block.initialLine[2].as_string());
+    ASSERT_EQ((int)request.find("Host:"), block.initialLineSize);
+
+    ASSERT_EQ(5, block.headerCount);
+    ASSERT_EQ("Host", block.headers[0].name.as_string());
+    ASSERT_EQ("www.example.com", block.headers[0].value.as_string());
+    ASSERT_EQ("Accept", block.headers[2].name.as_string());
+    ASSERT_EQ(0U, block.headers[2].value.as_string().find("text/html"));
+    ASSERT_TRUE(block.headers[3].value.empty());
+    ASSERT_EQ("keep-alive", block.headers[4].value.as_string());
+}
+
+static void scanEveryPrefix(const HttpHeaderScanner& scanner) {
+    std::string request(REQUEST);
+    int blockSize = (int)request.size() - 4;
+    HttpHeaderScanner::Block block;
+
+    for (int i = 0; i < blockSize; ++i) {
+        // copy, so reading past the prefix would be caught by the tools.
+        std::string prefix(request, 0, i);
+        ASSERT_EQ(HttpHeaderScanner::INCOMPLETE,
+                  scanner.scan(prefix.data(), i, &block)) << i;
+    }
+}
+
+static void scanLineFeedOnly(const HttpHeaderScanner& scanner) {
+    std::string request("HTTP/1.1 200 OK\nContent-Length: 4\n\nbody");
+    HttpHeaderScanner::Block block;
+
+    ASSERT_EQ((int)request.size() - 4,
+              scanner.scan(request.data(), (int)request.size(), &block));
+    ASSERT_EQ("200", block.initialLine[1].as_string());
+    ASSERT_EQ("OK", block.initialLine[2].as_string());
+    ASSERT_EQ(1, block.headerCount);
+    ASSERT_EQ("4", block.headers[0].value.as_string());
+}
+
+static void scanUnsupported(const HttpHeaderScanner& scanner) {
+    const char* requests[] = {
+        "GET / HTTP/1.1\r\nX-Folded: one\r\n two\r\n\r\n",
+        "GET / HTTP/1.1\r\nX-Bare: one\rtwo\r\n\r\n",
+        "GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+        "GET / HTTP/1.1\r\n: empty name\r\n\r\n",
+        "GET / HTTP/1.1\r\nX-Space : value\r\n\r\n",
+        "GET /\r\nHost: a\r\n\r\n"
+    };
+
+    HttpHeaderScanner::Block block;
+
+    for (int i = 0; i < (int)(sizeof(requests) / sizeof(requests[0])); ++i) {
+        std::string request(requests[i]);
+        ASSERT_EQ(HttpHeaderScanner::UNSUPPORTED,
+                  scanner.scan(request.data(), (int)request.size(), &block)) << i;
+    }
+}
+
+static void scanTooManyHeaders(const HttpHeaderScanner& scanner) {
+    std::string request("GET / HTTP/1.1\r\n");
+
+    for (int i = 0; i <= HttpHeaderScanner::MAX_HEADER_COUNT; ++i) {
+        request += "X-Header: value\r\n";
+    }
+
+    request += "\r\n";
+
+    HttpHeaderScanner::Block block;
+    ASSERT_EQ(HttpHeaderScanner::UNSUPPORTED,
+              scanner.scan(request.data(), (int)request.size(), &block));
+}
+
+TEST(HttpHeaderScannerTest, testScanRequest) {
+    scanAll(scanRequest);
+}
+
+TEST(HttpHeaderScannerTest, testScanEveryPrefix) {
+    scanAll(scanEveryPrefix);
+}
+
+TEST(HttpHeaderScannerTest, testScanLineFeedOnly) {
+    scanAll(scanLineFeedOnly);
+}
+
+TEST(HttpHeaderScannerTest, testScanUnsupported) {
+    scanAll(scanUnsupported);
+}
+
+TEST(HttpHeaderScannerTest, testScanTooManyHeaders) {
+    scanAll(scanTooManyHeaders);
+}
+
+TEST(HttpHeaderScannerTest, testBestImplementation) {
+    HttpHeaderScanner scanner;
+    ASSERT_EQ(HttpHeaderScanner::bestImplementation(), scanner.implementation());
+    ASSERT_TRUE(HttpHeaderScanner::isSupported(scanner.implementation()));
+}
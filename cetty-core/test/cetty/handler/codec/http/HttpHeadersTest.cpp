@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <cetty/util/StringUtil.h>
+#include <cetty/handler/codec/http/HttpHeaders.h>
+
+using namespace cetty::util;
+using namespace cetty::handler::codec::http;
+
+TEST(HttpHeadersTest, testHeaderId) {
+    ASSERT_EQ(HttpHeaders::HEADER_CONTENT_LENGTH,
+              HttpHeaders::headerId("content-length"));
+    ASSERT_EQ(HttpHeaders::HEADER_CONTENT_LENGTH,
+              HttpHeaders::headerId("CONTENT-LENGTH"));
+    ASSERT_EQ(HttpHeaders::HEADER_WWW_AUTHENTICATE,
+              HttpHeaders::headerId(HttpHeaders::Names::WWW_AUTHENTICATE));
+    ASSERT_EQ(HttpHeaders::HEADER_UNKNOWN, HttpHeaders::headerId("X-Test"));
+    ASSERT_EQ(HttpHeaders::HEADER_UNKNOWN, HttpHeaders::headerId(""));
+
+    for (int i = 0; i < HttpHeaders::HEADER_COUNT; ++i) {
+        HttpHeaders::HeaderId id = static_cast<HttpHeaders::HeaderId>(i);
+        ASSERT_EQ(id, HttpHeaders::headerId(HttpHeaders::headerName(id)));
+    }
+}
+
+TEST(HttpHeadersTest, testGetByNameOrId) {
+    HttpHeaders headers;
+    headers.addHeader("content-length", "10");
+    headers.addHeader("X-Test", "a");
+    headers.addHeader("x-test", "b");
+
+    ASSERT_TRUE(headers.hasHeader(HttpHeaders::HEADER_CONTENT_LENGTH));
+    ASSERT_TRUE(headers.hasHeader("X-TEST"));
+    ASSERT_FALSE(headers.hasHeader(HttpHeaders::HEADER_HOST));
+    ASSERT_FALSE(headers.hasHeader("X-Other"));
+
+    ASSERT_EQ(10, headers.contentLength());
+    ASSERT_EQ(10, headers.headerIntValue(HttpHeaders::Names::CONTENT_LENGTH, -1));
+    ASSERT_EQ("a", headers.headerValue("x-test").as_string());
+    ASSERT_EQ("none", headers.headerValue("X-Other", "none").as_string());
+
+    std::vector<std::string> values;
+    headers.headerValues("X-Test", &values);
+    ASSERT_EQ(2U, values.size());
+    ASSERT_EQ("b", values[1]);
+
+    std::vector<std::string> names;
+    headers.headerNames(&names);
+    ASSERT_EQ(2U, names.size());
+    ASSERT_EQ(HttpHeaders::Names::CONTENT_LENGTH, names[0]);
+    ASSERT_EQ("X-Test", names[1]);
+}
+
+TEST(HttpHeadersTest, testSetAndRemove) {
+    HttpHeaders headers;
+    headers.addHeader(HttpHeaders::Names::ACCEPT, "text/html");
+    headers.addHeader("X-Test", "a");
+    headers.addHeader("X-Test", "b");
+
+    headers.setHeader("x-test", "c");
+    ASSERT_EQ(2, headers.headerCount());
+    ASSERT_EQ("c", headers.headerValue("X-Test").as_string());
+
+    headers.addHeader("X-Test", "d");
+    headers.removeHeader("X-Test", "c");
+    ASSERT_EQ("d", headers.headerValue("X-Test").as_string());
+
+    headers.removeHeader(HttpHeaders::HEADER_ACCEPT);
+    headers.removeHeader("X-Test");
+    ASSERT_EQ(0, headers.headerCount());
+}
+
+TEST(HttpHeadersTest, testIterateInOrder) {
+    HttpHeaders headers;
+
+    // more than the inline storage.
+    for (int i = 0; i < 100; ++i) {
+        headers.addHeader(StringUtil::printf("X-Header-%d", i),
+                          StringUtil::printf("value %d", i));
+    }
+
+    headers.setHost("localhost");
+
+    HttpHeaders copy(headers);
+    HttpHeaders::ConstHeaderIterator itr = copy.firstHeader();
+
+    for (int i = 0; i < 100; ++i, ++itr) {
+        ASSERT_EQ(HttpHeaders::HEADER_UNKNOWN, itr.id());
+        ASSERT_EQ(StringUtil::printf("X-Header-%d", i), itr.name().as_string());
+        ASSERT_EQ(StringUtil::printf("value %d", i), itr.value().as_string());
+    }
+
+    ASSERT_EQ(HttpHeaders::HEADER_HOST, itr.id());
+    ASSERT_EQ(HttpHeaders::Names::HOST, itr.name().as_string());
+    ASSERT_EQ("localhost", copy.host().as_string());
+    ASSERT_TRUE(++itr == copy.lastHeader());
+}
+
+TEST(HttpHeadersTest, testSetFromOwnValue) {
+    HttpHeaders headers;
+    headers.addHeader("X-Test", "value");
+
+    for (int i = 0; i < 100; ++i) {
+        headers.addHeader(StringUtil::printf("X-Copy-%d", i),
+                          headers.headerValue("X-Test"));
+    }
+
+    ASSERT_EQ("value", headers.headerValue("X-Copy-99").as_string());
+
+    // the bytes are on the heap now, and reallocated from there.
+    for (int i = 100; i < 400; ++i) {
+        headers.addHeader(StringUtil::printf("X-Copy-%d", i),
+                          headers.headerValue(StringUtil::printf("X-Copy-%d", i - 1)));
+    }
+
+    for (int i = 0; i < 400; ++i) {
+        ASSERT_EQ("value",
+                  headers.headerValue(StringUtil::printf("X-Copy-%d", i)).as_string());
+    }
+
+    // set from its own value, the only header with the bytes cleared.
+    HttpHeaders single;
+    single.addHeader("X-Test", "value");
+    single.setHeader("X-Test", single.headerValue("X-Test"));
+    ASSERT_EQ("value", single.headerValue("X-Test").as_string());
+
+    // set from its own value, compacting the bytes.
+    headers.setHeader("X-Copy-0", headers.headerValue("X-Copy-0"));
+    ASSERT_EQ("value", headers.headerValue("X-Copy-0").as_string());
+
+    headers.setHeader("X-Test", headers.headerValue("X-Copy-399"));
+    ASSERT_EQ("value", headers.headerValue("X-Test").as_string());
+}
+
+TEST(HttpHeadersTest, testKeepAliveAndTransferEncoding) {
+    HttpHeaders headers;
+    ASSERT_TRUE(headers.keepAlive(HttpVersion::HTTP_1_1));
+
+    headers.setKeepAlive(false, HttpVersion::HTTP_1_1);
+    ASSERT_EQ(HttpHeaders::Values::CLOSE,
+              headers.headerValue(HttpHeaders::HEADER_CONNECTION).as_string());
+    ASSERT_FALSE(headers.keepAlive(HttpVersion::HTTP_1_1));
+
+    headers.setContentLength(100);
+    headers.setTransferEncoding(HttpTransferEncoding::CHUNKED);
+    ASSERT_FALSE(headers.hasHeader(HttpHeaders::HEADER_CONTENT_LENGTH));
+    ASSERT_EQ(HttpHeaders::Values::CHUNKED,
+              headers.headerValue(HttpHeaders::HEADER_TRANSFER_ENCODING).as_string());
+
+    headers.setTransferEncoding(HttpTransferEncoding::SINGLE);
+    ASSERT_FALSE(headers.hasHeader(HttpHeaders::HEADER_TRANSFER_ENCODING));
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/codec/TooLongFrameException.h>
+#include <cetty/handler/codec/ReplayingDecoderBuffer.h>
+#include <cetty/handler/codec/http/HttpChunk.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpPackageDecoder.h>
+#include <cetty/handler/codec/http/HttpRequestCreator.h>
+#include <cetty/handler/codec/http/HttpResponseCreator.h>
+
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::embedded;
+using namespace cetty::handler::codec;
+using namespace cetty::handler::codec::http;
+
+static const char* REQUEST = "GET /path?q=1 HTTP/1.1\r\n"
+                             "Host: example.com\r\n"
+                             "User-Agent: test\r\n"
+                             "Content-Length: 0\r\n"
+                             "\r\n";
+
+class DecoderContext : public ChannelHandlerContext {
+public:
+    DecoderContext(const EventLoopPtr& eventLoop)
+        : ChannelHandlerContext("decoder", eventLoop) {
+    }
+
+    virtual boost::any getInboundMessageContainer() {
+        return boost::any();
+    }
+
+    virtual boost::any getOutboundMessageContainer() {
+        return boost::any();
+    }
+};
+
+/**
+ * drives the decoder as the ReplayingDecoder does, the bytes are never
+ * discarded, and the reader index goes back to the check point when more
+ * bytes are needed.
+ */
+class HttpPackageDecoderTest : public testing::Test {
+public:
+    HttpPackageDecoderTest()
+        : ctx(EventLoopPtr(new EmbeddedEventLoop)),
+          buffer(Unpooled::buffer(1024)),
+          replayable(new ReplayingDecoderBuffer(buffer)) {
+    }
+
+    void setUp(int maxInitialLineLength,
+               int maxHeaderSize,
+               int maxChunkSize,
+               HttpPackageDecoder::DecodingType type = HttpPackageDecoder::REQUEST) {
+        decoder.reset(new HttpPackageDecoder(type,
+                                             maxInitialLineLength,
+                                             maxHeaderSize,
+                                             maxChunkSize));
+
+        decoder->setCheckPointInvoker(
+            boost::bind(&HttpPackageDecoderTest::checkPoint, this, _1));
+
+        if (type == HttpPackageDecoder::REQUEST) {
+            decoder->setHttpPackageCreator(boost::bind(
+                                               &HttpRequestCreator::create,
+                                               &requestCreator, _1, _2, _3));
+        }
+        else {
+            decoder->setHttpPackageCreator(boost::bind(
+                                               &HttpResponseCreator::create,
+                                               &responseCreator, _1, _2, _3));
+        }
+
+        state = decoder->initialState();
+        checkedPoint = buffer->readerIndex();
+    }
+
+    virtual void SetUp() {
+        setUp(4096, 8192, 8192);
+    }
+
+    void checkPoint(int nextState) {
+        state = nextState;
+        checkedPoint = buffer->readerIndex();
+    }
+
+    HttpPackage write(const std::string& bytes) {
+        buffer->writeBytes(bytes);
+
+        return decode();
+    }
+
+    // the channel is closed, decodes the rest.
+    HttpPackage close() {
+        replayable->terminate();
+
+        HttpPackage package = decode();
+        return package ? package : decoder->decode(ctx, replayable, state);
+    }
+
+    HttpPackage decode() {
+        while (buffer->readable()) {
+            int oldState = state;
+            int oldReaderIndex = checkedPoint = buffer->readerIndex();
+
+            replayable->needMoreBytes(false);
+            HttpPackage package = decoder->decode(ctx, replayable, state);
+
+            if (replayable->needMoreBytes()) {
+                buffer->readerIndex(checkedPoint);
+                return HttpPackage();
+            }
+
+            if (package) {
+                return package;
+            }
+
+            if (oldState == state && oldReaderIndex == buffer->readerIndex()) {
+                break;
+            }
+        }
+
+        return HttpPackage();
+    }
+
+    static std::string content(const HttpPackage& package) {
+        HttpChunkPtr chunk = package.httpChunk();
+
+        if (!chunk) {
+            return std::string();
+        }
+
+        int length;
+        const char* bytes = chunk->getContent()->readableBytes(&length);
+        return std::string(bytes, length);
+    }
+
+    HttpRequestCreator requestCreator;
+    HttpResponseCreator responseCreator;
+    DecoderContext ctx;
+    ChannelBufferPtr buffer;
+    ReplayingDecoderBufferPtr replayable;
+    boost::scoped_ptr<HttpPackageDecoder> decoder;
+
+    int state;
+    int checkedPoint;
+};
+
+TEST_F(HttpPackageDecoderTest, testWholeRequest) {
+    HttpPackage package = write(REQUEST);
+    ASSERT_TRUE(package);
+
+    HttpRequestPtr request = package.httpRequest();
+    ASSERT_TRUE(request);
+    ASSERT_EQ(std::string("example.com"), request->headers().host().as_string());
+    ASSERT_EQ(std::string("test"),
+              request->headers().headerValue("User-Agent").as_string());
+    ASSERT_EQ(0, buffer->readableBytes());
+}
+
+TEST_F(HttpPackageDecoderTest, testRequestByteByByte) {
+    std::string bytes(REQUEST);
+    HttpPackage package;
+
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        ASSERT_FALSE(package) << "decoded before byte " << i;
+        package = write(bytes.substr(i, 1));
+    }
+
+    ASSERT_TRUE(package);
+
+    HttpRequestPtr request = package.httpRequest();
+    ASSERT_TRUE(request);
+    ASSERT_EQ(std::string("/path?q=1"), request->getUriString());
+    ASSERT_EQ(std::string("example.com"), request->headers().host().as_string());
+    ASSERT_EQ(3, request->headers().headerCount());
+}
+
+TEST_F(HttpPackageDecoderTest, testTooLongInitialLine) {
+    setUp(16, 8192, 8192);
+
+    ASSERT_THROW(write(REQUEST), TooLongFrameException);
+}
+
+TEST_F(HttpPackageDecoderTest, testVariableLengthContentEndsOnClose) {
+    setUp(4096, 8192, 4, HttpPackageDecoder::RESPONSE);
+
+    HttpPackage package = write("HTTP/1.0 200 OK\r\n"
+                                "\r\n");
+    ASSERT_TRUE(package.httpResponse());
+
+    // the read bytes are drained, but the content goes on.
+    package = write("abcd");
+    ASSERT_EQ(std::string("abcd"), content(package));
+    ASSERT_FALSE(package.httpChunk()->followingLastChunk());
+
+    package = write("efgh");
+    ASSERT_EQ(std::string("efgh"), content(package));
+    ASSERT_FALSE(package.httpChunk()->followingLastChunk());
+
+    ASSERT_FALSE(write("ij"));
+
+    package = close();
+    ASSERT_EQ(std::string("ij"), content(package));
+    ASSERT_TRUE(package.httpChunk()->followingLastChunk());
+}
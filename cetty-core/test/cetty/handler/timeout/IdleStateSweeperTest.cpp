@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <cetty/channel/embedded/EmbeddedEventLoop.h>
+#include <cetty/handler/timeout/IdleStateHandler.h>
+#include <cetty/handler/timeout/IdleStateSweeper.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::embedded;
+using namespace cetty::handler::timeout;
+
+TEST(IdleStateSweeperTest, testIntervalFollowsHandlers) {
+    IdleStateSweeper sweeper(EventLoopPtr(new EmbeddedEventLoop));
+    IdleStateHandler slow(10, 0, 0);
+    IdleStateHandler fast(1, 0, 0);
+    IdleStateHandler medium(5, 0, 0);
+
+    slow.setSweepInterval(1000);
+    fast.setSweepInterval(100);
+    medium.setSweepInterval(500);
+
+    IdleStateSweeper::Handlers::iterator slowItr = sweeper.add(&slow);
+    ASSERT_EQ(1000, sweeper.interval());
+
+    IdleStateSweeper::Handlers::iterator fastItr = sweeper.add(&fast);
+    ASSERT_EQ(100, sweeper.interval());
+
+    IdleStateSweeper::Handlers::iterator mediumItr = sweeper.add(&medium);
+    ASSERT_EQ(100, sweeper.interval());
+
+    // the interval grows back when the shortest one goes away.
+    sweeper.remove(fastItr);
+    ASSERT_EQ(500, sweeper.interval());
+
+    sweeper.remove(slowItr);
+    ASSERT_EQ(500, sweeper.interval());
+
+    sweeper.remove(mediumItr);
+    ASSERT_EQ(0, sweeper.interval());
+    ASSERT_EQ(0, sweeper.handlerCount());
+
+    sweeper.add(&slow);
+    ASSERT_EQ(1000, sweeper.interval());
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/ChannelConfig.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioService.h>
+#include <cetty/handler/traffic/ReadThrottleHandler.h>
+
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+using namespace cetty::handler::traffic;
+
+/**
+ * a channel which is active once opened, writable as the test says, and
+ * counts the reads requested.
+ */
+class ThrottleTestChannel : public Channel {
+public:
+    typedef ChannelMessageHandlerContext<ThrottleTestChannel*,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessage,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            VoidMessageContainer> Context;
+
+public:
+    ThrottleTestChannel(const EventLoopPtr& eventLoop)
+        : Channel(ChannelPtr(), eventLoop),
+          writable(true),
+          reads(0) {
+    }
+
+    void registerTo(Context& context) {
+        Channel::registerTo(context);
+        context.setReadFunctor(boost::bind(&ThrottleTestChannel::doRead, this));
+    }
+
+    virtual ~ThrottleTestChannel() {}
+
+    virtual bool isWritable() const {
+        return writable;
+    }
+
+    void activate() {
+        open();
+        setActived();
+    }
+
+    void setWritable(bool writable) {
+        this->writable = writable;
+        pipeline().fireChannelWritabilityChanged();
+    }
+
+public:
+    bool writable;
+    int reads;
+
+protected:
+    virtual bool doBind(const InetAddress& localAddress) { return true; }
+    virtual bool doDisconnect() { return true; }
+    virtual bool doClose() { return true; }
+
+    virtual void doPreOpen() {
+        pipeline().setHead<ThrottleTestChannel*>("head", this);
+    }
+
+private:
+    void doRead() {
+        ++reads;
+    }
+};
+
+class ReadThrottleHandlerTest : public testing::Test {
+public:
+    ReadThrottleHandlerTest()
+        : service(new AsioService(EventLoopPoolPtr())),
+          throttle(new ReadThrottleHandler) {
+        service->setThreadId(CurrentThread::id());
+
+        target.reset(new ThrottleTestChannel(service));
+        source.reset(new ThrottleTestChannel(service));
+
+        target->setInitializer(boost::bind(
+                                   &ReadThrottleHandlerTest::initializeTarget,
+                                   this,
+                                   _1));
+
+        target->activate();
+        source->activate();
+    }
+
+    bool initializeTarget(ChannelPipeline& pipeline) {
+        pipeline.addLast<ReadThrottleHandler::HandlerPtr>("throttle", throttle);
+        return true;
+    }
+
+    AsioServicePtr service;
+    ReadThrottleHandler::HandlerPtr throttle;
+    boost::shared_ptr<ThrottleTestChannel> target;
+    boost::shared_ptr<ThrottleTestChannel> source;
+};
+
+TEST_F(ReadThrottleHandlerTest, testNotPausedWhenWritable) {
+    ASSERT_FALSE(throttle->throttle(source));
+    ASSERT_EQ(0, throttle->pausedCount());
+    ASSERT_TRUE(source->config().autoRead());
+}
+
+TEST_F(ReadThrottleHandlerTest, testPauseAndResume) {
+    target->setWritable(false);
+
+    ASSERT_TRUE(throttle->throttle(source));
+    ASSERT_TRUE(throttle->throttle(source));
+    ASSERT_EQ(1, throttle->pausedCount());
+    ASSERT_FALSE(source->config().autoRead());
+
+    // still not writable, keeps paused.
+    target->setWritable(false);
+    ASSERT_EQ(1, throttle->pausedCount());
+    ASSERT_EQ(0, source->reads);
+
+    target->setWritable(true);
+
+    ASSERT_EQ(0, throttle->pausedCount());
+    ASSERT_TRUE(source->config().autoRead());
+    ASSERT_EQ(1, source->reads);
+}
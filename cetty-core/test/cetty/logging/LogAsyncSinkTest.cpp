@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <cetty/logging/LogAsyncSink.h>
+
+using namespace cetty::logging;
+
+class MemoryLogSink : public LogSink {
+public:
+    MemoryLogSink() : LogSink("memory"), batches(0) {}
+
+    std::string text() {
+        boost::mutex::scoped_lock lock(mutex);
+        return messages;
+    }
+
+    int batches;
+
+protected:
+    virtual void doSink(const LogMessage& msg) {
+        doSink(msg.buffer(), static_cast<int>(strlen(msg.buffer())));
+    }
+
+    virtual void doSink(const char* data, int size) {
+        boost::mutex::scoped_lock lock(mutex);
+        messages.append(data, size);
+        ++batches;
+    }
+
+    virtual void doFlush() {}
+
+private:
+    boost::mutex mutex;
+    std::string messages;
+};
+
+static int countLines(const std::string& text) {
+    return static_cast<int>(std::count(text.begin(), text.end(), '\n'));
+}
+
+static void logMessages(LogAsyncSink* sink, int count) {
+    for (int i = 0; i < count; ++i) {
+        LogMessage msg(LogLevel::ERROR, __FILE__, __LINE__);
+        msg.stream() << "message " << i;
+        msg.finish();
+        sink->sink(msg);
+    }
+}
+
+TEST(LogAsyncSinkTest, testWriteInBatch) {
+    MemoryLogSink* memory = new MemoryLogSink;
+    LogSinkPtr backend(memory);
+    LogAsyncSink sink(backend);
+
+    boost::thread_group threads;
+
+    for (int i = 0; i < 4; ++i) {
+        threads.create_thread(boost::bind(&logMessages, &sink, 100));
+    }
+
+    threads.join_all();
+    sink.flush();
+
+    ASSERT_EQ(400, countLines(memory->text()));
+    ASSERT_EQ(400, sink.writtenCount());
+    ASSERT_EQ(0, sink.droppedCount());
+    ASSERT_LT(memory->batches, 400);
+}
+
+TEST(LogAsyncSinkTest, testDropWhenFull) {
+    MemoryLogSink* memory = new MemoryLogSink;
+    LogSinkPtr backend(memory);
+    LogAsyncSink sink(backend,
+                      64 * 1024,
+                      LogAsyncSink::OverflowPolicy::DROP,
+                      60 * 1000);
+
+    // every message is about 100 bytes, 64KB can not hold them all.
+    logMessages(&sink, 5000);
+    sink.stop();
+
+    ASSERT_EQ(5000, sink.writtenCount() + sink.droppedCount());
+
+    if (sink.droppedCount() > 0) {
+        ASSERT_NE(std::string::npos, memory->text().find("dropped"));
+    }
+}
+
+TEST(LogAsyncSinkTest, testBlockWhenFull) {
+    MemoryLogSink* memory = new MemoryLogSink;
+    LogSinkPtr backend(memory);
+    LogAsyncSink sink(backend,
+                      64 * 1024,
+                      LogAsyncSink::OverflowPolicy::BLOCK,
+                      60 * 1000);
+
+    logMessages(&sink, 5000);
+    sink.stop();
+
+    ASSERT_EQ(5000, sink.writtenCount());
+    ASSERT_EQ(0, sink.droppedCount());
+    ASSERT_EQ(5000, countLines(memory->text()));
+}
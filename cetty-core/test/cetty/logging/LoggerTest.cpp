@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <cetty/logging/Logger.h>
+#include <cetty/logging/LoggerHelper.h>
+
+using namespace cetty::logging;
+
+TEST(LoggerTest, testModuleOfFile) {
+    ASSERT_EQ("channel", Logger::moduleOfFile("/src/cetty-core/src/cetty/channel/asio/AsioSocketChannel.cpp"));
+    ASSERT_EQ("redis", Logger::moduleOfFile("cetty-redis/src/cetty/redis/RedisClient.cpp"));
+    ASSERT_EQ("logging", Logger::moduleOfFile("include\\cetty\\logging\\Logger.h"));
+    ASSERT_EQ("", Logger::moduleOfFile("cetty/Types.h"));
+    ASSERT_EQ("", Logger::moduleOfFile("test/LoggerTest.cpp"));
+}
+
+TEST(LoggerTest, testModuleLevel) {
+    Logger::setLevel(LogLevel::INFO);
+    ASSERT_FALSE(Logger::isEnabled("service", LogLevel::DEBUG));
+
+    Logger::setLevel("service", LogLevel::DEBUG);
+    ASSERT_TRUE(Logger::isEnabled("service", LogLevel::DEBUG));
+    ASSERT_FALSE(Logger::isEnabled("channel", LogLevel::DEBUG));
+
+    // the explicit module level is kept when the default level changes.
+    Logger::setLevel(LogLevel::WARN);
+    ASSERT_TRUE(Logger::isEnabled("service", LogLevel::DEBUG));
+    ASSERT_FALSE(Logger::isEnabled("channel", LogLevel::INFO));
+
+    Logger::resetLevel("service");
+    ASSERT_FALSE(Logger::isEnabled("service", LogLevel::INFO));
+    ASSERT_TRUE(LogLevel::WARN == Logger::level("service"));
+
+    Logger::setLevel(LogLevel::DEBUG);
+}
+
+TEST(LoggerTest, testSitePerCallSite) {
+    Logger::Site& first = cettyLogSite<__LINE__>();
+    Logger::Site& second = cettyLogSite<__LINE__>();
+    ASSERT_NE(&first, &second);
+
+    // the cached threshold still follows the level of the module.
+    Logger::setLevel("channel", LogLevel::WARN);
+    ASSERT_FALSE(first.isEnabled(LogLevel::INFO, "cetty/channel/Channel.cpp"));
+
+    Logger::setLevel("channel", LogLevel::INFO);
+    ASSERT_TRUE(first.isEnabled(LogLevel::INFO, "cetty/channel/Channel.cpp"));
+    ASSERT_TRUE(second.isEnabled(LogLevel::INFO, "cetty/channel/Channel.cpp", "channel"));
+
+    Logger::resetLevel("channel");
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cetty/util/CachedClock.h>
+
+using namespace cetty::util;
+using namespace boost::posix_time;
+
+static void sleepMillis(int millis) {
+    boost::this_thread::sleep(milliseconds(millis));
+}
+
+static void checkDisabled(bool* enabled, bool* advanced) {
+    *enabled = CachedClock::isEnabled();
+
+    ptime first = CachedClock::now();
+    sleepMillis(5);
+    *advanced = CachedClock::now() > first;
+}
+
+TEST(CachedClockTest, testCachedUntilInvalidated) {
+    CachedClock::enable();
+    ASSERT_TRUE(CachedClock::isEnabled());
+
+    ptime first = CachedClock::now();
+    sleepMillis(5);
+    ASSERT_EQ(first, CachedClock::now());
+    ASSERT_EQ(CachedClock::nowInMillis(), CachedClock::nowInMicros() / 1000);
+
+    CachedClock::invalidate();
+    ptime second = CachedClock::now();
+    ASSERT_GE(second - first, milliseconds(5));
+
+    CachedClock::disable();
+    ASSERT_FALSE(CachedClock::isEnabled());
+}
+
+TEST(CachedClockTest, testNotCachedWhenDisabled) {
+    ASSERT_FALSE(CachedClock::isEnabled());
+
+    ptime first = CachedClock::now();
+    sleepMillis(5);
+    ASSERT_GT(CachedClock::now(), first);
+
+    // invalidating a disabled clock does nothing.
+    CachedClock::invalidate();
+    ASSERT_FALSE(CachedClock::isEnabled());
+}
+
+TEST(CachedClockTest, testEnabledPerThread) {
+    CachedClock::enable();
+
+    bool enabled = true;
+    bool advanced = false;
+    boost::thread other(boost::bind(&checkDisabled, &enabled, &advanced));
+    other.join();
+
+    // the other thread reads the system clock.
+    ASSERT_FALSE(enabled);
+    ASSERT_TRUE(advanced);
+    ASSERT_TRUE(CachedClock::isEnabled());
+
+    CachedClock::disable();
+}
+
+TEST(CachedClockTest, testCloseToSystemClock) {
+    CachedClock::enable();
+    CachedClock::invalidate();
+
+    ptime cached = CachedClock::now();
+    ptime system = microsec_clock::universal_time();
+
+    ASSERT_LE(cached, system);
+    ASSERT_LT(system - cached, seconds(1));
+
+    CachedClock::disable();
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <cetty/util/MpscQueue.h>
+
+using namespace cetty::util;
+
+static void append(std::vector<int>* values, int value) {
+    values->push_back(value);
+}
+
+static void produce(MpscQueue<int>* queue, int producer, int count) {
+    for (int i = 0; i < count; ++i) {
+        queue->push(producer * count + i);
+    }
+}
+
+TEST(MpscQueueTest, testPushOrderAndEmptyTransition) {
+    MpscQueue<int> queue;
+    std::vector<int> values;
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_FALSE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+
+    ASSERT_EQ(3, queue.popAll(boost::bind(&append, &values, _1)));
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(1, values[0]);
+    ASSERT_EQ(2, values[1]);
+    ASSERT_EQ(3, values[2]);
+
+    ASSERT_TRUE(queue.push(4));
+    ASSERT_EQ(1, queue.popAll(boost::bind(&append, &values, _1)));
+    ASSERT_EQ(4, values[3]);
+}
+
+TEST(MpscQueueTest, testManyProducers) {
+    const int producers = 4;
+    const int count = 10000;
+
+    MpscQueue<int> queue;
+    std::vector<int> values;
+
+    boost::thread_group threads;
+
+    for (int i = 0; i < producers; ++i) {
+        threads.create_thread(boost::bind(&produce, &queue, i, count));
+    }
+
+    while (static_cast<int>(values.size()) < producers * count) {
+        queue.popAll(boost::bind(&append, &values, _1));
+    }
+
+    threads.join_all();
+
+    // every value popped once, in order for every producer.
+    std::vector<int> last(producers, -1);
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        int producer = values[i] / count;
+        ASSERT_LT(last[producer], values[i]);
+        last[producer] = values[i];
+    }
+
+    ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <cetty/util/Atomic.h>
+#include <cetty/util/WorkStealingThreadPool.h>
+
+using namespace cetty::util;
+
+static void count(Atomic<int>* counter) {
+    counter->incrementAndGet();
+}
+
+static void block(boost::mutex* mutex, Atomic<int>* started) {
+    started->incrementAndGet();
+    boost::lock_guard<boost::mutex> lock(*mutex);
+}
+
+static void resubmit(WorkStealingThreadPool* pool,
+                     Atomic<int>* counter,
+                     bool* inWorker) {
+    *inWorker = pool->inWorkerThread();
+    pool->submit(boost::bind(&count, counter));
+}
+
+TEST(WorkStealingThreadPoolTest, testRunAllTasksBeforeStop) {
+    Atomic<int> counter;
+    WorkStealingThreadPool pool(4, 0);
+
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(pool.submit(boost::bind(&count, &counter)));
+    }
+
+    pool.stop();
+
+    ASSERT_EQ(10000, counter.get());
+    ASSERT_FALSE(pool.submit(boost::bind(&count, &counter)));
+
+    WorkStealingThreadPool::Statistics statistics;
+    pool.statistics(&statistics);
+
+    ASSERT_EQ(10000, statistics.submitted);
+    ASSERT_EQ(10000, statistics.executed);
+    ASSERT_EQ(1, statistics.rejected);
+    ASSERT_EQ(0, statistics.queued);
+}
+
+TEST(WorkStealingThreadPoolTest, testRejectWhenFull) {
+    boost::mutex mutex;
+    Atomic<int> started;
+    Atomic<int> counter;
+
+    WorkStealingThreadPool pool(1, 2);
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        ASSERT_TRUE(pool.submit(boost::bind(&block, &mutex, &started)));
+
+        while (started.get() == 0) {
+            boost::this_thread::yield();
+        }
+
+        ASSERT_TRUE(pool.submit(boost::bind(&count, &counter)));
+        ASSERT_TRUE(pool.submit(boost::bind(&count, &counter)));
+        ASSERT_FALSE(pool.submit(boost::bind(&count, &counter)));
+        ASSERT_EQ(2, pool.queuedTasks());
+    }
+
+    pool.stop();
+    ASSERT_EQ(2, counter.get());
+}
+
+TEST(WorkStealingThreadPoolTest, testStealFromBlockedWorker) {
+    boost::mutex mutex;
+    Atomic<int> started;
+    Atomic<int> counter;
+
+    WorkStealingThreadPool pool(2, 0);
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+
+        // round robin: the first and the third go to the first worker,
+        // which is blocked by the first one.
+        ASSERT_TRUE(pool.submit(boost::bind(&block, &mutex, &started)));
+        ASSERT_TRUE(pool.submit(boost::bind(&count, &counter)));
+        ASSERT_TRUE(pool.submit(boost::bind(&count, &counter)));
+
+        while (counter.get() < 2) {
+            boost::this_thread::yield();
+        }
+    }
+
+    pool.stop();
+
+    WorkStealingThreadPool::Statistics statistics;
+    pool.statistics(&statistics);
+    ASSERT_EQ(3, statistics.executed);
+    ASSERT_GE(statistics.stolen, 1);
+}
+
+TEST(WorkStealingThreadPoolTest, testSubmitInWorker) {
+    Atomic<int> counter;
+    bool inWorker = false;
+
+    WorkStealingThreadPool pool(2, 0);
+
+    ASSERT_FALSE(pool.inWorkerThread());
+    ASSERT_TRUE(pool.submit(boost::bind(&resubmit, &pool, &counter, &inWorker)));
+
+    while (counter.get() == 0) {
+        boost::this_thread::yield();
+    }
+
+    pool.stop();
+    ASSERT_TRUE(inWorker);
+}
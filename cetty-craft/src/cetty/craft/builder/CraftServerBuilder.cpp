@@ -20,6 +20,8 @@
 #include <cetty/config/ConfigCenter.h>
 #include <cetty/handler/codec/LengthFieldBasedFrameDecoder.h>
 #include <cetty/handler/codec/LengthFieldPrepender.h>
+#include <cetty/handler/codec/http/HttpChunkAggregator.h>
+#include <cetty/handler/codec/http/HttpContentCompressor.h>
 #include <cetty/handler/codec/http/HttpRequest.h>
 #include <cetty/handler/codec/http/HttpResponse.h>
 #include <cetty/handler/codec/http/HttpServerCodec.h>
@@ -46,6 +48,12 @@ using namespace cetty::craft::http;
 
 static const std::string PROTOBUF_SERVICE_HTTP("http");
 
+// the largest request content aggregated for a service.
+static const int MAX_HTTP_CONTENT_LENGTH = 4 * 1024 * 1024;
+
+// the compressed responses shared by all the connections.
+static const int COMPRESSED_CONTENT_CACHE_SIZE = 16 * 1024 * 1024;
+
 CraftServerBuilder::CraftServerBuilder()
     : builder_() {
     init();
@@ -80,20 +88,31 @@ bool CraftServerBuilder::initializeChildChannel(ChannelPipeline& pipeline) {
     pipeline.addLast<HttpServerCodec::HandlerPtr>("httpCodec",
             HttpServerCodec::HandlerPtr(new HttpServerCodec));
 
-    // Remove the following line if you don't want automatic content compression.
-    //pipeline.addLast("deflater", new HttpContentCompressor());
+    pipeline.addLast<HttpChunkAggregator::HandlerPtr>("aggregator",
+            HttpChunkAggregator::HandlerPtr(
+                new HttpChunkAggregator(MAX_HTTP_CONTENT_LENGTH)));
+
+    // Remove the following lines if you don't want automatic content compression.
+    HttpContentCompressor::HandlerPtr compressor(new HttpContentCompressor);
+    compressor->setCache(compressedContentCache_);
+
+    pipeline.addLast<HttpContentCompressor::HandlerPtr>("deflater", compressor);
 
     pipeline.addLast<HttpServiceFilter::HandlerPtr>("protobufFilter",
             HttpServiceFilter::HandlerPtr(
                 new HttpServiceFilter()));
 
     pipeline.addLast<ProtobufServiceMessageHandler::HandlerPtr>("messageHandler",
-            ProtobufServiceMessageHandler::HandlerPtr(new ProtobufServiceMessageHandler));
+            ProtobufServiceMessageHandler::HandlerPtr(
+                new ProtobufServiceMessageHandler(builder_.workerPool())));
 
     return true;
 }
 
 void CraftServerBuilder::init() {
+    compressedContentCache_.reset(
+        new HttpCompressedContentCache(COMPRESSED_CONTENT_CACHE_SIZE));
+
     builder_.serverBuilder().registerPrototype(PROTOBUF_SERVICE_HTTP,
                                             boost::bind(&CraftServerBuilder::initializeChildChannel,
                                                     this,
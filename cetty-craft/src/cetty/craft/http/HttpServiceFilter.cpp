@@ -60,7 +60,7 @@ ProtobufServiceMessagePtr HttpServiceFilter::filterRequest(
         LOG_DEBUG << "request content: " << std::string(content.data(), content.size());
     }
 
-    LOG_DEBUG << "request content type: " << request->headers().headerValue(HttpHeaders::Names::CONTENT_TYPE);
+    LOG_DEBUG << "request content type: " << request->headers().headerValue(HttpHeaders::HEADER_CONTENT_TYPE).as_string();
 
     std::string format;
     ProtobufServiceMessagePtr msg =
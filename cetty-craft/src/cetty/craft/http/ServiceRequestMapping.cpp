@@ -83,7 +83,7 @@ public:
     }
 
     bool acceptedPost(const HttpRequestPtr& request) {
-        const std::string& type = request->headers().headerValue(HttpHeaders::Names::CONTENT_TYPE);
+        StringPiece type = request->headers().headerValue(HttpHeaders::HEADER_CONTENT_TYPE);
         return request->method() == HttpMethod::POST &&
                (httpMethod_ == HttpMethod::POST ||
                 type == HttpHeaders::Values::X_PROTOBUFFER ||
@@ -266,8 +266,10 @@ ProtobufServiceMessagePtr ServiceRequestMapping::toProtobufMessage(
                                                    method->methodName()));
                     message->setPayload(req);
 
-                    if (request->headers().hasHeader("X-protobuf-id")) {
-                        message->setId(StringUtil::strto64(request->headers().headerValue("X-protobuf-id")));
+                    StringPiece id = request->headers().headerValue("X-protobuf-id");
+
+                    if (!id.empty()) {
+                        message->setId(StringUtil::strto64(id));
                     }
 
                     StringPiece value = method->pathParamValue("format");
@@ -720,7 +722,7 @@ bool ServiceRequestMapping::getValues(const HttpRequestPtr& request,
         return nameValues.get(options.query_param(), values) > 0;
     }
     else if (options.has_header_param()) {
-        std::string value = request->headers().headerValue(options.header_param());
+        std::string value = request->headers().headerValue(options.header_param()).as_string();
 
         if (options.header_param().compare("Authorization") == 0 &&
                 value.find("Bearer ") == 0) {
@@ -736,7 +738,7 @@ bool ServiceRequestMapping::getValues(const HttpRequestPtr& request,
 
     }
     else if (options.has_cookie_param()) {
-        std::string value = request->headers().headerValue(HttpHeaders::Names::COOKIE);
+        std::string value = request->headers().headerValue(HttpHeaders::HEADER_COOKIE).as_string();
         return false;
     }
     else if (options.has_mapping_content() && options.mapping_content()) {
@@ -84,7 +84,8 @@ bool ProtobufServerBuilder::initializeChannel(ChannelPipeline& pipeline) {
 
     pipeline.addLast<ProtobufServiceMessageHandler>(
         "messageHandler",
-        ProtobufServiceMessageHandler::HandlerPtr(new ProtobufServiceMessageHandler));
+        ProtobufServiceMessageHandler::HandlerPtr(
+            new ProtobufServiceMessageHandler(workerPool_)));
 
     return true;
 }
@@ -94,6 +95,13 @@ ChannelPtr ProtobufServerBuilder::build(int port) {
 }
 
 void ProtobufServerBuilder::init() {
+    const ServerBuilderConfig& config = builder_.config();
+
+    if (config.workerThreadCount > 0) {
+        workerPool_.reset(new WorkStealingThreadPool(config.workerThreadCount,
+                          config.workerQueueSize));
+    }
+
     builder_.registerPrototype(PROTOBUF_SERVICE_RPC,
                    boost::bind(&ProtobufServerBuilder::initializeChannel,
                                this,
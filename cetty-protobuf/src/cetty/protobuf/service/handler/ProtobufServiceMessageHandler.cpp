@@ -22,6 +22,7 @@
 #include <google/protobuf/descriptor.h>
 
 #include <cetty/channel/Channel.h>
+#include <cetty/channel/EventLoop.h>
 #include <cetty/channel/ChannelFuture.h>
 #include <cetty/channel/ChannelPipeline.h>
 #include <cetty/channel/ChannelHandlerContext.h>
@@ -31,6 +32,7 @@
 #include <cetty/protobuf/service/ProtobufServiceRegister.h>
 #include <cetty/protobuf/service/ProtobufServiceMessage.h>
 #include <cetty/protobuf/service/service.pb.h>
+#include <cetty/protobuf/service/service_options.pb.h>
 
 namespace cetty {
 namespace protobuf {
@@ -42,6 +44,19 @@ using namespace cetty::service;
 using namespace cetty::protobuf::service;
 using namespace google::protobuf;
 
+// the policy of the method overrides the one of the service.
+static bool executeInWorkerPool(const MethodDescriptor* method) {
+    const ServiceMethodOptions& options =
+        method->options().GetExtension(service_method_options);
+
+    if (options.has_execution_policy()) {
+        return options.execution_policy() == EXECUTE_IN_WORKER_POOL;
+    }
+
+    return method->service()->options().GetExtension(
+               service_options).execution_policy() == EXECUTE_IN_WORKER_POOL;
+}
+
 void ProtobufServiceMessageHandler::messageUpdated(ChannelHandlerContext& ctx) {
     InboundQueue& inboundQueue =
         context_->inboundContainer()->getMessages();
@@ -74,7 +89,20 @@ void ProtobufServiceMessageHandler::messageReceived(ChannelHandlerContext& ctx,
 
         LOG_INFO << "rpc request: " << rpc.service() << "." << rpc.method() << " " << id;        
 
-        if (method) {
+        if (method && workers_ && executeInWorkerPool(method)) {
+            if (!workers_->submit(boost::bind(
+                                      &ProtobufServiceMessageHandler::callInWorker,
+                                      shared_from_this(),
+                                      service,
+                                      method,
+                                      msg,
+                                      ctx.channel()))) {
+                LOG_WARN << "the worker pool is full, reject the rpc request: "
+                         << rpc.service() << "." << rpc.method() << " " << id;
+                replyError(ctx, msg);
+            }
+        }
+        else if (method) {
             service->CallMethod(method,
                                 msg->payload(),
                                 service->GetResponsePrototype(method)->New(),
@@ -89,14 +117,7 @@ void ProtobufServiceMessageHandler::messageReceived(ChannelHandlerContext& ctx,
         else {
             // return error message
             LOG_DEBUG << "has no such service or method.";
-            ProtobufServiceMessagePtr message(
-                new ProtobufServiceMessage(MSG_ERROR,
-                id,
-                rpc.service(),
-                rpc.method(),
-                MessagePtr()));
-
-            context_->outboundTransfer()->write(message, ctx.newVoidFuture());
+            replyError(ctx, msg);
         }
     }
     else if (rpc.type() == cetty::protobuf::service::MSG_ERROR) {
@@ -123,6 +144,75 @@ void ProtobufServiceMessageHandler::doneCallback(const MessagePtr& response,
     context_->outboundTransfer()->write(message, ctx.newFuture());
 }
 
+void ProtobufServiceMessageHandler::replyError(ChannelHandlerContext& ctx,
+        const ProtobufServiceMessagePtr& req) {
+    const ServiceMessage& rpc = req->serviceMessage();
+
+    ProtobufServiceMessagePtr message(
+        new ProtobufServiceMessage(MSG_ERROR,
+                                   rpc.id(),
+                                   rpc.service(),
+                                   rpc.method(),
+                                   MessagePtr()));
+
+    context_->outboundTransfer()->write(message, ctx.newVoidFuture());
+}
+
+void ProtobufServiceMessageHandler::callInWorker(const ProtobufServicePtr& service,
+        const MethodDescriptor* method,
+        const ProtobufServiceMessagePtr& req,
+        const ChannelPtr& channel) {
+    service->CallMethod(method,
+                        req->payload(),
+                        service->GetResponsePrototype(method)->New(),
+                        boost::bind(&ProtobufServiceMessageHandler::workerDoneCallback,
+                                    shared_from_this(),
+                                    _1,
+                                    channel,
+                                    req));
+}
+
+void ProtobufServiceMessageHandler::workerDoneCallback(const MessagePtr& response,
+        const ChannelPtr& channel,
+        const ProtobufServiceMessagePtr& req) {
+    ProtobufServiceMessagePtr message(
+        new ProtobufServiceMessage(MSG_RESPONSE,
+                                   req->serviceMessage().id(),
+                                   req->service(),
+                                   req->method(),
+                                   response));
+
+    // only the first response of a batch wakes the event loop up.
+    if (workerResponses_.push(message)) {
+        channel->eventLoop()->post(boost::bind(
+                                       &ProtobufServiceMessageHandler::flushWorkerResponses,
+                                       shared_from_this(),
+                                       channel));
+    }
+}
+
+void ProtobufServiceMessageHandler::flushWorkerResponses(const ChannelPtr& channel) {
+    if (!channel->isActive()) {
+        workerResponses_.popAll(ResponseWriter(NULL));
+        return;
+    }
+
+    int count = workerResponses_.popAll(ResponseWriter(this));
+
+    if (count > 0) {
+        LOG_DEBUG << "rpc responses from the workers: " << count;
+        context_->flush(context_->newFuture());
+    }
+}
+
+void ProtobufServiceMessageHandler::ResponseWriter::operator()(
+    const ProtobufServiceMessagePtr& response) const {
+    // the responses of a closed channel are dropped.
+    if (handler) {
+        handler->context_->outboundTransfer()->unfoldAndAdd(response);
+    }
+}
+
 }
 }
 }
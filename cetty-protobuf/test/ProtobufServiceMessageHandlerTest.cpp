@@ -0,0 +1,239 @@
+/*test for calling the service methods in the worker pool*/
+
+#include <set>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <google/protobuf/descriptor.h>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioService.h>
+#include <cetty/util/WorkStealingThreadPool.h>
+#include <cetty/protobuf/service/ProtobufService.h>
+#include <cetty/protobuf/service/ProtobufServiceMessage.h>
+#include <cetty/protobuf/service/ProtobufServiceRegister.h>
+#include <cetty/protobuf/service/handler/ProtobufServiceMessageHandler.h>
+#include <cetty/protobuf/service/service.pb.h>
+
+#include <worker_pool.pb.h>
+#include <gtest/gtest.h>
+
+using namespace cetty::util;
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+using namespace cetty::protobuf::service;
+using namespace cetty::protobuf::service::handler;
+using namespace google::protobuf;
+
+// answers the value of the request, and whether it ran in a worker.
+class WorkerPoolTestServiceImpl : public ProtobufService {
+public:
+    WorkerPoolTestServiceImpl() : loopThread(boost::this_thread::get_id()) {}
+
+    virtual const ServiceDescriptor* GetDescriptor() {
+        return WorkerPoolTestRequest::descriptor()->file()->FindServiceByName(
+                   "WorkerPoolTestService");
+    }
+
+    virtual void CallMethod(const MethodDescriptor* method,
+                            const ConstMessagePtr& request,
+                            const MessagePtr& response,
+                            const DoneCallback& done) {
+        WorkerPoolTestResponse* rep =
+            static_cast<WorkerPoolTestResponse*>(response);
+
+        rep->set_value(static_cast<const WorkerPoolTestRequest*>(request)->value());
+        rep->set_in_worker(boost::this_thread::get_id() != loopThread);
+        done(response);
+    }
+
+    virtual const Message* GetRequestPrototype(const MethodDescriptor* method) const {
+        return &WorkerPoolTestRequest::default_instance();
+    }
+
+    virtual const Message* GetResponsePrototype(const MethodDescriptor* method) const {
+        return &WorkerPoolTestResponse::default_instance();
+    }
+
+private:
+    boost::thread::id loopThread;
+};
+
+/**
+ * a channel which is active once opened, and keeps the messages flushed.
+ */
+class ServiceTestChannel : public Channel {
+public:
+    typedef ProtobufServiceMessageHandler::InboundContainer Container;
+
+    typedef ChannelMessageHandlerContext<ServiceTestChannel*,
+            VoidMessage,
+            VoidMessage,
+            ProtobufServiceMessagePtr,
+            VoidMessage,
+            VoidMessageContainer,
+            VoidMessageContainer,
+            Container,
+            VoidMessageContainer> Context;
+
+public:
+    ServiceTestChannel(const EventLoopPtr& eventLoop)
+        : Channel(ChannelPtr(), eventLoop),
+          container_() {
+    }
+
+    virtual ~ServiceTestChannel() {}
+
+    void registerTo(Context& context) {
+        Channel::registerTo(context);
+
+        container_ = context.outboundContainer();
+        context.setFlushFunctor(boost::bind(&ServiceTestChannel::doFlush,
+                                            this,
+                                            _1,
+                                            _2));
+    }
+
+    void activate() {
+        open();
+        setActived();
+    }
+
+    void receive(const ProtobufServiceMessagePtr& request) {
+        pipeline().addInboundChannelMessage<ProtobufServiceMessagePtr>(request);
+        pipeline().fireMessageUpdated();
+    }
+
+public:
+    std::vector<ProtobufServiceMessagePtr> flushed;
+
+protected:
+    virtual bool doBind(const InetAddress& localAddress) { return true; }
+    virtual bool doDisconnect() { return true; }
+    virtual bool doClose() { return true; }
+
+    virtual void doPreOpen() {
+        pipeline().setHead<ServiceTestChannel*>("head", this);
+    }
+
+private:
+    void doFlush(ChannelHandlerContext& ctx, const ChannelFuturePtr& future) {
+        Container::MessageQueue& queue = container_->getMessages();
+
+        while (!queue.empty()) {
+            flushed.push_back(queue.front());
+            queue.pop_front();
+        }
+
+        if (future) {
+            future->setSuccess();
+        }
+    }
+
+private:
+    Container* container_;
+};
+
+class ProtobufServiceMessageHandlerTest : public testing::Test {
+public:
+    ProtobufServiceMessageHandlerTest()
+        : service(new AsioService(EventLoopPoolPtr())),
+          workers(new WorkStealingThreadPool(2, 100)) {
+        service->setThreadId(CurrentThread::id());
+
+        ProtobufServiceRegister::instance().registerService(
+            ProtobufServicePtr(new WorkerPoolTestServiceImpl));
+
+        channel.reset(new ServiceTestChannel(service));
+        channel->setInitializer(boost::bind(
+                                    &ProtobufServiceMessageHandlerTest::initialize,
+                                    this,
+                                    _1));
+        channel->activate();
+    }
+
+    ~ProtobufServiceMessageHandlerTest() {
+        workers->stop();
+        ProtobufServiceRegister::instance().unregisterService(
+            "WorkerPoolTestService");
+    }
+
+    bool initialize(ChannelPipeline& pipeline) {
+        pipeline.addLast<ProtobufServiceMessageHandler::HandlerPtr>(
+            "service",
+            ProtobufServiceMessageHandler::HandlerPtr(
+                new ProtobufServiceMessageHandler(workers)));
+        return true;
+    }
+
+    void request(const std::string& method, int id) {
+        WorkerPoolTestRequest* payload = new WorkerPoolTestRequest;
+        payload->set_value(id);
+
+        channel->receive(ProtobufServiceMessagePtr(
+                             new ProtobufServiceMessage(MSG_REQUEST,
+                                     id,
+                                     "WorkerPoolTestService",
+                                     method,
+                                     payload)));
+    }
+
+    // runs the event loop until the responses are flushed, at most 5s.
+    void waitForResponses(std::size_t count) {
+        for (int i = 0; i < 5000 && channel->flushed.size() < count; ++i) {
+            service->service().restart();
+            service->service().poll();
+
+            if (channel->flushed.size() < count) {
+                boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            }
+        }
+    }
+
+    const WorkerPoolTestResponse* responseAt(int index) {
+        return static_cast<const WorkerPoolTestResponse*>(
+                   channel->flushed[index]->payload());
+    }
+
+    AsioServicePtr service;
+    WorkStealingThreadPoolPtr workers;
+    boost::shared_ptr<ServiceTestChannel> channel;
+};
+
+TEST_F(ProtobufServiceMessageHandlerTest, testQuickMethodInEventLoop) {
+    request("quick", 1);
+
+    // answered at once, without the event loop running.
+    ASSERT_EQ(1U, channel->flushed.size());
+    ASSERT_EQ(MSG_RESPONSE, channel->flushed[0]->type());
+    ASSERT_EQ(1, responseAt(0)->value());
+    ASSERT_FALSE(responseAt(0)->in_worker());
+}
+
+TEST_F(ProtobufServiceMessageHandlerTest, testSlowMethodInWorkers) {
+    const int count = 16;
+
+    for (int i = 0; i < count; ++i) {
+        request("slow", i);
+    }
+
+    waitForResponses(count);
+    ASSERT_EQ(static_cast<std::size_t>(count), channel->flushed.size());
+
+    std::set<int> values;
+
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(MSG_RESPONSE, channel->flushed[i]->type());
+        ASSERT_TRUE(responseAt(i)->in_worker());
+        values.insert(responseAt(i)->value());
+    }
+
+    ASSERT_EQ(static_cast<std::size_t>(count), values.size());
+
+    WorkStealingThreadPool::Statistics statistics;
+    workers->statistics(&statistics);
+    ASSERT_EQ(count, statistics.executed);
+}
@@ -0,0 +1,557 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: worker_pool.proto
+
+#include "worker_pool.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+PROTOBUF_CONSTEXPR WorkerPoolTestRequest::WorkerPoolTestRequest(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.value_)*/0} {}
+struct WorkerPoolTestRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR WorkerPoolTestRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~WorkerPoolTestRequestDefaultTypeInternal() {}
+  union {
+    WorkerPoolTestRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 WorkerPoolTestRequestDefaultTypeInternal _WorkerPoolTestRequest_default_instance_;
+PROTOBUF_CONSTEXPR WorkerPoolTestResponse::WorkerPoolTestResponse(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.value_)*/0
+  , /*decltype(_impl_.in_worker_)*/false} {}
+struct WorkerPoolTestResponseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR WorkerPoolTestResponseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~WorkerPoolTestResponseDefaultTypeInternal() {}
+  union {
+    WorkerPoolTestResponse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 WorkerPoolTestResponseDefaultTypeInternal _WorkerPoolTestResponse_default_instance_;
+static ::_pb::Metadata file_level_metadata_worker_5fpool_2eproto[2];
+static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_worker_5fpool_2eproto = nullptr;
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_worker_5fpool_2eproto = nullptr;
+
+const uint32_t TableStruct_worker_5fpool_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestRequest, _impl_._has_bits_),
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestRequest, _impl_.value_),
+  0,
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestResponse, _impl_._has_bits_),
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestResponse, _impl_.value_),
+  PROTOBUF_FIELD_OFFSET(::WorkerPoolTestResponse, _impl_.in_worker_),
+  0,
+  1,
+};
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, 7, -1, sizeof(::WorkerPoolTestRequest)},
+  { 8, 16, -1, sizeof(::WorkerPoolTestResponse)},
+};
+
+static const ::_pb::Message* const file_default_instances[] = {
+  &::_WorkerPoolTestRequest_default_instance_._instance,
+  &::_WorkerPoolTestResponse_default_instance_._instance,
+};
+
+const char descriptor_table_protodef_worker_5fpool_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\021worker_pool.proto\032,cetty/protobuf/serv"
+  "ice/service_options.proto\"&\n\025WorkerPoolT"
+  "estRequest\022\r\n\005value\030\001 \001(\005\":\n\026WorkerPoolT"
+  "estResponse\022\r\n\005value\030\001 \001(\005\022\021\n\tin_worker\030"
+  "\002 \001(\0102\232\001\n\025WorkerPoolTestService\0227\n\004slow\022"
+  "\026.WorkerPoolTestRequest\032\027.WorkerPoolTest"
+  "Response\022@\n\005quick\022\026.WorkerPoolTestReques"
+  "t\032\027.WorkerPoolTestResponse\"\006\212\246\035\002\030\000\032\006\212\246\035\002"
+  "\010\001"
+  ;
+static const ::_pbi::DescriptorTable* const descriptor_table_worker_5fpool_2eproto_deps[1] = {
+  &::descriptor_table_cetty_2fprotobuf_2fservice_2fservice_5foptions_2eproto,
+};
+static ::_pbi::once_flag descriptor_table_worker_5fpool_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_worker_5fpool_2eproto = {
+    false, false, 322, descriptor_table_protodef_worker_5fpool_2eproto,
+    "worker_pool.proto",
+    &descriptor_table_worker_5fpool_2eproto_once, descriptor_table_worker_5fpool_2eproto_deps, 1, 2,
+    schemas, file_default_instances, TableStruct_worker_5fpool_2eproto::offsets,
+    file_level_metadata_worker_5fpool_2eproto, file_level_enum_descriptors_worker_5fpool_2eproto,
+    file_level_service_descriptors_worker_5fpool_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_worker_5fpool_2eproto_getter() {
+  return &descriptor_table_worker_5fpool_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_worker_5fpool_2eproto(&descriptor_table_worker_5fpool_2eproto);
+
+// ===================================================================
+
+class WorkerPoolTestRequest::_Internal {
+ public:
+  using HasBits = decltype(std::declval<WorkerPoolTestRequest>()._impl_._has_bits_);
+  static void set_has_value(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+};
+
+WorkerPoolTestRequest::WorkerPoolTestRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:WorkerPoolTestRequest)
+}
+WorkerPoolTestRequest::WorkerPoolTestRequest(const WorkerPoolTestRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  WorkerPoolTestRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.value_){}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_impl_.value_ = from._impl_.value_;
+  // @@protoc_insertion_point(copy_constructor:WorkerPoolTestRequest)
+}
+
+inline void WorkerPoolTestRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.value_){0}
+  };
+}
+
+WorkerPoolTestRequest::~WorkerPoolTestRequest() {
+  // @@protoc_insertion_point(destructor:WorkerPoolTestRequest)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void WorkerPoolTestRequest::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void WorkerPoolTestRequest::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void WorkerPoolTestRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:WorkerPoolTestRequest)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.value_ = 0;
+  _impl_._has_bits_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* WorkerPoolTestRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional int32 value = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_value(&has_bits);
+          _impl_.value_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _impl_._has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* WorkerPoolTestRequest::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:WorkerPoolTestRequest)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _impl_._has_bits_[0];
+  // optional int32 value = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(1, this->_internal_value(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:WorkerPoolTestRequest)
+  return target;
+}
+
+size_t WorkerPoolTestRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:WorkerPoolTestRequest)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // optional int32 value = 1;
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_value());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData WorkerPoolTestRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    WorkerPoolTestRequest::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*WorkerPoolTestRequest::GetClassData() const { return &_class_data_; }
+
+
+void WorkerPoolTestRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<WorkerPoolTestRequest*>(&to_msg);
+  auto& from = static_cast<const WorkerPoolTestRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:WorkerPoolTestRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_has_value()) {
+    _this->_internal_set_value(from._internal_value());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void WorkerPoolTestRequest::CopyFrom(const WorkerPoolTestRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:WorkerPoolTestRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool WorkerPoolTestRequest::IsInitialized() const {
+  return true;
+}
+
+void WorkerPoolTestRequest::InternalSwap(WorkerPoolTestRequest* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
+  swap(_impl_.value_, other->_impl_.value_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata WorkerPoolTestRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_worker_5fpool_2eproto_getter, &descriptor_table_worker_5fpool_2eproto_once,
+      file_level_metadata_worker_5fpool_2eproto[0]);
+}
+
+// ===================================================================
+
+class WorkerPoolTestResponse::_Internal {
+ public:
+  using HasBits = decltype(std::declval<WorkerPoolTestResponse>()._impl_._has_bits_);
+  static void set_has_value(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_in_worker(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+};
+
+WorkerPoolTestResponse::WorkerPoolTestResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:WorkerPoolTestResponse)
+}
+WorkerPoolTestResponse::WorkerPoolTestResponse(const WorkerPoolTestResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  WorkerPoolTestResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.value_){}
+    , decltype(_impl_.in_worker_){}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.value_, &from._impl_.value_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.in_worker_) -
+    reinterpret_cast<char*>(&_impl_.value_)) + sizeof(_impl_.in_worker_));
+  // @@protoc_insertion_point(copy_constructor:WorkerPoolTestResponse)
+}
+
+inline void WorkerPoolTestResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.value_){0}
+    , decltype(_impl_.in_worker_){false}
+  };
+}
+
+WorkerPoolTestResponse::~WorkerPoolTestResponse() {
+  // @@protoc_insertion_point(destructor:WorkerPoolTestResponse)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void WorkerPoolTestResponse::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void WorkerPoolTestResponse::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void WorkerPoolTestResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:WorkerPoolTestResponse)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    ::memset(&_impl_.value_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&_impl_.in_worker_) -
+        reinterpret_cast<char*>(&_impl_.value_)) + sizeof(_impl_.in_worker_));
+  }
+  _impl_._has_bits_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* WorkerPoolTestResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional int32 value = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_value(&has_bits);
+          _impl_.value_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bool in_worker = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _Internal::set_has_in_worker(&has_bits);
+          _impl_.in_worker_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _impl_._has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* WorkerPoolTestResponse::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:WorkerPoolTestResponse)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _impl_._has_bits_[0];
+  // optional int32 value = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt32ToArray(1, this->_internal_value(), target);
+  }
+
+  // optional bool in_worker = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(2, this->_internal_in_worker(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:WorkerPoolTestResponse)
+  return target;
+}
+
+size_t WorkerPoolTestResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:WorkerPoolTestResponse)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    // optional int32 value = 1;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(this->_internal_value());
+    }
+
+    // optional bool in_worker = 2;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += 1 + 1;
+    }
+
+  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData WorkerPoolTestResponse::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    WorkerPoolTestResponse::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*WorkerPoolTestResponse::GetClassData() const { return &_class_data_; }
+
+
+void WorkerPoolTestResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<WorkerPoolTestResponse*>(&to_msg);
+  auto& from = static_cast<const WorkerPoolTestResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:WorkerPoolTestResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      _this->_impl_.value_ = from._impl_.value_;
+    }
+    if (cached_has_bits & 0x00000002u) {
+      _this->_impl_.in_worker_ = from._impl_.in_worker_;
+    }
+    _this->_impl_._has_bits_[0] |= cached_has_bits;
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void WorkerPoolTestResponse::CopyFrom(const WorkerPoolTestResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:WorkerPoolTestResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool WorkerPoolTestResponse::IsInitialized() const {
+  return true;
+}
+
+void WorkerPoolTestResponse::InternalSwap(WorkerPoolTestResponse* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(WorkerPoolTestResponse, _impl_.in_worker_)
+      + sizeof(WorkerPoolTestResponse::_impl_.in_worker_)
+      - PROTOBUF_FIELD_OFFSET(WorkerPoolTestResponse, _impl_.value_)>(
+          reinterpret_cast<char*>(&_impl_.value_),
+          reinterpret_cast<char*>(&other->_impl_.value_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata WorkerPoolTestResponse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_worker_5fpool_2eproto_getter, &descriptor_table_worker_5fpool_2eproto_once,
+      file_level_metadata_worker_5fpool_2eproto[1]);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::WorkerPoolTestRequest*
+Arena::CreateMaybeMessage< ::WorkerPoolTestRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::WorkerPoolTestRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::WorkerPoolTestResponse*
+Arena::CreateMaybeMessage< ::WorkerPoolTestResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::WorkerPoolTestResponse >(arena);
+}
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
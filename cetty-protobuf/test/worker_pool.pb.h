@@ -0,0 +1,505 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: worker_pool.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_worker_5fpool_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_worker_5fpool_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/unknown_field_set.h>
+#include "cetty/protobuf/service/service_options.pb.h"
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_worker_5fpool_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_worker_5fpool_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_worker_5fpool_2eproto;
+class WorkerPoolTestRequest;
+struct WorkerPoolTestRequestDefaultTypeInternal;
+extern WorkerPoolTestRequestDefaultTypeInternal _WorkerPoolTestRequest_default_instance_;
+class WorkerPoolTestResponse;
+struct WorkerPoolTestResponseDefaultTypeInternal;
+extern WorkerPoolTestResponseDefaultTypeInternal _WorkerPoolTestResponse_default_instance_;
+PROTOBUF_NAMESPACE_OPEN
+template<> ::WorkerPoolTestRequest* Arena::CreateMaybeMessage<::WorkerPoolTestRequest>(Arena*);
+template<> ::WorkerPoolTestResponse* Arena::CreateMaybeMessage<::WorkerPoolTestResponse>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+
+// ===================================================================
+
+class WorkerPoolTestRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:WorkerPoolTestRequest) */ {
+ public:
+  inline WorkerPoolTestRequest() : WorkerPoolTestRequest(nullptr) {}
+  ~WorkerPoolTestRequest() override;
+  explicit PROTOBUF_CONSTEXPR WorkerPoolTestRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  WorkerPoolTestRequest(const WorkerPoolTestRequest& from);
+  WorkerPoolTestRequest(WorkerPoolTestRequest&& from) noexcept
+    : WorkerPoolTestRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline WorkerPoolTestRequest& operator=(const WorkerPoolTestRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline WorkerPoolTestRequest& operator=(WorkerPoolTestRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
+  }
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const WorkerPoolTestRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const WorkerPoolTestRequest* internal_default_instance() {
+    return reinterpret_cast<const WorkerPoolTestRequest*>(
+               &_WorkerPoolTestRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(WorkerPoolTestRequest& a, WorkerPoolTestRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(WorkerPoolTestRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(WorkerPoolTestRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  WorkerPoolTestRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<WorkerPoolTestRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const WorkerPoolTestRequest& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const WorkerPoolTestRequest& from) {
+    WorkerPoolTestRequest::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(WorkerPoolTestRequest* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "WorkerPoolTestRequest";
+  }
+  protected:
+  explicit WorkerPoolTestRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kValueFieldNumber = 1,
+  };
+  // optional int32 value = 1;
+  bool has_value() const;
+  private:
+  bool _internal_has_value() const;
+  public:
+  void clear_value();
+  int32_t value() const;
+  void set_value(int32_t value);
+  private:
+  int32_t _internal_value() const;
+  void _internal_set_value(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:WorkerPoolTestRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    int32_t value_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_worker_5fpool_2eproto;
+};
+// -------------------------------------------------------------------
+
+class WorkerPoolTestResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:WorkerPoolTestResponse) */ {
+ public:
+  inline WorkerPoolTestResponse() : WorkerPoolTestResponse(nullptr) {}
+  ~WorkerPoolTestResponse() override;
+  explicit PROTOBUF_CONSTEXPR WorkerPoolTestResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  WorkerPoolTestResponse(const WorkerPoolTestResponse& from);
+  WorkerPoolTestResponse(WorkerPoolTestResponse&& from) noexcept
+    : WorkerPoolTestResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline WorkerPoolTestResponse& operator=(const WorkerPoolTestResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline WorkerPoolTestResponse& operator=(WorkerPoolTestResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
+  }
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const WorkerPoolTestResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const WorkerPoolTestResponse* internal_default_instance() {
+    return reinterpret_cast<const WorkerPoolTestResponse*>(
+               &_WorkerPoolTestResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(WorkerPoolTestResponse& a, WorkerPoolTestResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(WorkerPoolTestResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(WorkerPoolTestResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  WorkerPoolTestResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<WorkerPoolTestResponse>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const WorkerPoolTestResponse& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const WorkerPoolTestResponse& from) {
+    WorkerPoolTestResponse::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(WorkerPoolTestResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "WorkerPoolTestResponse";
+  }
+  protected:
+  explicit WorkerPoolTestResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kValueFieldNumber = 1,
+    kInWorkerFieldNumber = 2,
+  };
+  // optional int32 value = 1;
+  bool has_value() const;
+  private:
+  bool _internal_has_value() const;
+  public:
+  void clear_value();
+  int32_t value() const;
+  void set_value(int32_t value);
+  private:
+  int32_t _internal_value() const;
+  void _internal_set_value(int32_t value);
+  public:
+
+  // optional bool in_worker = 2;
+  bool has_in_worker() const;
+  private:
+  bool _internal_has_in_worker() const;
+  public:
+  void clear_in_worker();
+  bool in_worker() const;
+  void set_in_worker(bool value);
+  private:
+  bool _internal_in_worker() const;
+  void _internal_set_in_worker(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:WorkerPoolTestResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    int32_t value_;
+    bool in_worker_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_worker_5fpool_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// WorkerPoolTestRequest
+
+// optional int32 value = 1;
+inline bool WorkerPoolTestRequest::_internal_has_value() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool WorkerPoolTestRequest::has_value() const {
+  return _internal_has_value();
+}
+inline void WorkerPoolTestRequest::clear_value() {
+  _impl_.value_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000001u;
+}
+inline int32_t WorkerPoolTestRequest::_internal_value() const {
+  return _impl_.value_;
+}
+inline int32_t WorkerPoolTestRequest::value() const {
+  // @@protoc_insertion_point(field_get:WorkerPoolTestRequest.value)
+  return _internal_value();
+}
+inline void WorkerPoolTestRequest::_internal_set_value(int32_t value) {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  _impl_.value_ = value;
+}
+inline void WorkerPoolTestRequest::set_value(int32_t value) {
+  _internal_set_value(value);
+  // @@protoc_insertion_point(field_set:WorkerPoolTestRequest.value)
+}
+
+// -------------------------------------------------------------------
+
+// WorkerPoolTestResponse
+
+// optional int32 value = 1;
+inline bool WorkerPoolTestResponse::_internal_has_value() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool WorkerPoolTestResponse::has_value() const {
+  return _internal_has_value();
+}
+inline void WorkerPoolTestResponse::clear_value() {
+  _impl_.value_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000001u;
+}
+inline int32_t WorkerPoolTestResponse::_internal_value() const {
+  return _impl_.value_;
+}
+inline int32_t WorkerPoolTestResponse::value() const {
+  // @@protoc_insertion_point(field_get:WorkerPoolTestResponse.value)
+  return _internal_value();
+}
+inline void WorkerPoolTestResponse::_internal_set_value(int32_t value) {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  _impl_.value_ = value;
+}
+inline void WorkerPoolTestResponse::set_value(int32_t value) {
+  _internal_set_value(value);
+  // @@protoc_insertion_point(field_set:WorkerPoolTestResponse.value)
+}
+
+// optional bool in_worker = 2;
+inline bool WorkerPoolTestResponse::_internal_has_in_worker() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool WorkerPoolTestResponse::has_in_worker() const {
+  return _internal_has_in_worker();
+}
+inline void WorkerPoolTestResponse::clear_in_worker() {
+  _impl_.in_worker_ = false;
+  _impl_._has_bits_[0] &= ~0x00000002u;
+}
+inline bool WorkerPoolTestResponse::_internal_in_worker() const {
+  return _impl_.in_worker_;
+}
+inline bool WorkerPoolTestResponse::in_worker() const {
+  // @@protoc_insertion_point(field_get:WorkerPoolTestResponse.in_worker)
+  return _internal_in_worker();
+}
+inline void WorkerPoolTestResponse::_internal_set_in_worker(bool value) {
+  _impl_._has_bits_[0] |= 0x00000002u;
+  _impl_.in_worker_ = value;
+}
+inline void WorkerPoolTestResponse::set_in_worker(bool value) {
+  _internal_set_in_worker(value);
+  // @@protoc_insertion_point(field_set:WorkerPoolTestResponse.in_worker)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_worker_5fpool_2eproto
@@ -16,6 +16,8 @@
 
 #include <cetty/service/builder/ServerBuilder.h>
 
+#include <algorithm>
+
 #include <cetty/channel/NullChannel.h>
 #include <cetty/channel/ChannelPipeline.h>
 #include <cetty/channel/asio/AsioServicePool.h>
@@ -25,6 +27,8 @@
 #include <cetty/logging/Logger.h>
 #include <cetty/logging/LoggerHelper.h>
 #include <cetty/logging/LogFileSink.h>
+#include <cetty/logging/LogAsyncSink.h>
+#include <cetty/logging/LogConsoleSink.h>
 
 namespace cetty {
 namespace service {
@@ -254,13 +258,43 @@ void ServerBuilder::init() {
         ServerUtil::daemonize();
     }
 
+    std::vector<int> cpus;
+
+    if (!config_.cpuAffinity.empty()
+            && !EventLoopThreadPlacement::parseCpuList(config_.cpuAffinity, &cpus)) {
+        LOG_WARN << "the cpu_affinity " << config_.cpuAffinity
+                 << " is malformed, the event loop threads will not be pinned.";
+    }
+
     if (!parentEventLoopPool_) {
-        parentEventLoopPool_ = new AsioServicePool(config_.parentThreadCount);
+        EventLoopThreadPlacement placement(config_.threadNamePrefix.empty()
+                                           ? config_.threadNamePrefix
+                                           : config_.threadNamePrefix + "p",
+                                           cpus,
+                                           config_.numaLocal);
+
+        parentEventLoopPool_ = new AsioServicePool(config_.parentThreadCount,
+                config_.timerWheel,
+                placement);
     }
 
     if (!childEventLoopPool_) {
         if (config_.childThreadCount > 0) {
-            childEventLoopPool_ = new AsioServicePool(config_.childThreadCount);
+            // the child loops take the cpus after the parent loops.
+            if (!cpus.empty() && !parentEventLoopPool_->isSingleThread()) {
+                int offset = parentEventLoopPool_->size() % cpus.size();
+                std::rotate(cpus.begin(), cpus.begin() + offset, cpus.end());
+            }
+
+            EventLoopThreadPlacement placement(config_.threadNamePrefix.empty()
+                                               ? config_.threadNamePrefix
+                                               : config_.threadNamePrefix + "c",
+                                               cpus,
+                                               config_.numaLocal);
+
+            childEventLoopPool_ = new AsioServicePool(config_.childThreadCount,
+                    config_.timerWheel,
+                    placement);
         }
         else {
             childEventLoopPool_ = parentEventLoopPool_;
@@ -271,22 +305,45 @@ void ServerBuilder::init() {
         const ServerBuilderConfig::Logger* logger = config_.logger;
         Logger::setLevel(LogLevel::parseFrom(logger->level));
 
+        std::map<std::string, std::string>::const_iterator itr =
+            logger->moduleLevels.begin();
+
+        for (; itr != logger->moduleLevels.end(); ++itr) {
+            Logger::setLevel(itr->first, LogLevel::parseFrom(itr->second));
+        }
+
         if (!logger->partten.empty()) {
             Logger::setPatternFormatter(logger->partten);
         }
 
         const ServerBuilderConfig::LoggerFileSink* fileSink = logger->fileSink;
+        LogSinkPtr sink;
 
         if (fileSink) {
             LogFileSink::RollingSchedule schedule =
                 LogFileSink::RollingSchedule::parseFrom(fileSink->rollingSchedule);
-            LogSinkPtr sink = new LogFileSink(fileSink->baseName,
-                                              fileSink->extention,
-                                              fileSink->immediateFlush,
-                                              schedule,
-                                              fileSink->bufferSize,
-                                              fileSink->rollSize);
+            sink = new LogFileSink(fileSink->baseName,
+                                   fileSink->extention,
+                                   fileSink->immediateFlush,
+                                   schedule,
+                                   fileSink->bufferSize,
+                                   fileSink->rollSize);
+        }
+
+        const ServerBuilderConfig::LoggerAsyncSink* asyncSink = logger->asyncSink;
 
+        if (asyncSink) {
+            if (!sink) {
+                sink = new LogConsoleSink;
+            }
+
+            sink = new LogAsyncSink(sink,
+                                    asyncSink->ringBufferSize,
+                                    LogAsyncSink::OverflowPolicy::parseFrom(asyncSink->overflowPolicy),
+                                    asyncSink->flushInterval);
+        }
+
+        if (sink) {
             Logger::addLogSink(sink);
         }
     }
@@ -427,7 +484,9 @@ void ServerBuilder::readOptions(const std::string& name,
         .setOption(ChannelOption::CO_REUSE_CHILD,
                    serverConfig->reuseChild)
         .setOption(ChannelOption::CO_RESERVED_CHILD_COUNT,
-                   serverConfig->reservedChildCount);
+                   serverConfig->reservedChildCount)
+        .setOption(ChannelOption::CO_SO_REUSEPORT,
+                   serverConfig->reusePort);
 
         if (serverConfig->receiveBufferSize) {
             options->setOption(ChannelOption::CO_SO_RCVBUF,
@@ -441,7 +500,11 @@ void ServerBuilder::readOptions(const std::string& name,
         .setOption(ChannelOption::CO_SO_REUSEADDR,
                    childConfig->isReuseAddress)
         .setOption(ChannelOption::CO_TCP_NODELAY,
-                   childConfig->isTcpNoDelay);
+                   childConfig->isTcpNoDelay)
+        .setOption(ChannelOption::CO_POOLED_BUFFER,
+                   childConfig->pooledBuffer)
+        .setOption(ChannelOption::CO_LAZY_READ_BUFFER,
+                   childConfig->lazyReadBuffer);
 
         if (childConfig->soLinger) {
             childOptions->setOption(ChannelOption::CO_SO_LINGER,
@@ -457,6 +520,26 @@ void ServerBuilder::readOptions(const std::string& name,
             childOptions->setOption(ChannelOption::CO_SO_RCVBUF,
                                     childConfig->receiveBufferSize);
         }
+
+        if (childConfig->writeBatchOperations) {
+            childOptions->setOption(ChannelOption::CO_WRITE_BATCH_OPERATIONS,
+                                    childConfig->writeBatchOperations);
+        }
+
+        if (childConfig->writeBatchBytes) {
+            childOptions->setOption(ChannelOption::CO_WRITE_BATCH_BYTES,
+                                    childConfig->writeBatchBytes);
+        }
+
+        if (childConfig->writeBufferHighWaterMark) {
+            childOptions->setOption(ChannelOption::CO_SNDHIGHWAT,
+                                    childConfig->writeBufferHighWaterMark);
+        }
+
+        if (childConfig->writeBufferLowWaterMark) {
+            childOptions->setOption(ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK,
+                                    childConfig->writeBufferLowWaterMark);
+        }
     }
 }
 
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/service/http/HttpClient.h>
+
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#include <cetty/handler/codec/http/HttpHeaders.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpVersion.h>
+#include <cetty/util/StringUtil.h>
+
+namespace cetty {
+namespace service {
+namespace http {
+
+using namespace cetty::buffer;
+using namespace cetty::channel::asio;
+
+HttpClient::HttpClient()
+    : eventLoopPool_(new AsioServicePool(1)),
+      pool_(eventLoopPool_->nextLoop()) {
+}
+
+HttpClient::HttpClient(const EventLoopPtr& eventLoop)
+    : pool_(eventLoop) {
+}
+
+HttpClient::~HttpClient() {
+    pool_.close();
+
+    if (eventLoopPool_) {
+        eventLoopPool_->stop();
+        eventLoopPool_->waitingForStop();
+    }
+}
+
+void HttpClient::setHeader(const std::string& name, const std::string& value) {
+    headers_[name] = value;
+}
+
+void HttpClient::get(const std::string& url, const ResponseCallback& callback) {
+    URI uri(url);
+    HttpRequestPtr request = newRequest(uri, HttpMethod::GET);
+
+    pool_.request(uri.getHost(), uri.getPort(), request, callback);
+}
+
+void HttpClient::post(const std::string& url,
+                      const std::string& data,
+                      const ResponseCallback& callback) {
+    URI uri(url);
+    HttpRequestPtr request = newRequest(uri, HttpMethod::POST);
+    HttpHeaders& headers = request->headers();
+
+    if (!headers.containsHeader(HttpHeaders::Names::CONTENT_TYPE)) {
+        headers.setHeader(HttpHeaders::Names::CONTENT_TYPE,
+                          "application/x-www-form-urlencoded");
+    }
+
+    request->setContent(Unpooled::copiedBuffer(data));
+    request->setContentLength(static_cast<int>(data.size()));
+
+    pool_.request(uri.getHost(), uri.getPort(), request, callback);
+}
+
+HttpRequestPtr HttpClient::newRequest(const URI& uri,
+                                      const HttpMethod& method) const {
+    HttpRequestPtr request(new HttpRequest);
+    std::string path = uri.getPathAndQuery();
+
+    request->setVersion(HttpVersion::HTTP_1_1);
+    request->setMethod(method);
+    request->setUri(path.empty() ? std::string("/") : path);
+
+    HttpHeaders& headers = request->headers();
+    std::map<std::string, std::string>::const_iterator itr = headers_.begin();
+
+    for (; itr != headers_.end(); ++itr) {
+        headers.setHeader(itr->first, itr->second);
+    }
+
+    if (uri.getPort() == 80) {
+        headers.setHeader(HttpHeaders::Names::HOST, uri.getHost());
+    }
+    else {
+        headers.setHeader(HttpHeaders::Names::HOST,
+                          uri.getHost() + ":" + StringUtil::numtostr(uri.getPort()));
+    }
+
+    // HTTP/1.1 is persistent by default, but some servers close without it.
+    if (!headers.containsHeader(HttpHeaders::Names::CONNECTION)) {
+        headers.setHeader(HttpHeaders::Names::CONNECTION,
+                          HttpHeaders::Values::KEEP_ALIVE);
+    }
+
+    return request;
+}
+
+}
+}
+}
@@ -0,0 +1,741 @@
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/service/http/HttpConnectionPool.h>
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/Timeout.h>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/ChannelFuture.h>
+#include <cetty/channel/ChannelOption.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelHandlerContext.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/channel/ChannelInboundMessageHandler.h>
+#include <cetty/handler/codec/http/HttpMethod.h>
+#include <cetty/handler/codec/http/HttpPackage.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/handler/codec/http/HttpVersion.h>
+#include <cetty/handler/codec/http/HttpRequestEncoder.h>
+#include <cetty/handler/codec/http/HttpResponseDecoder.h>
+#include <cetty/handler/codec/http/HttpChunkAggregator.h>
+#include <cetty/logging/LoggerHelper.h>
+#include <cetty/util/Exception.h>
+#include <cetty/util/StringUtil.h>
+
+namespace cetty {
+namespace service {
+namespace http {
+
+using namespace cetty::channel;
+using namespace cetty::handler::codec::http;
+
+const int HttpConnectionPool::CLOSE_TIMEOUT = 5 * 1000;
+
+/**
+ * the tail of the pipeline of a pooled connection, hands the aggregated
+ * responses to the pool, unless the pool is closed.
+ */
+class HttpConnectionPool::ResponseHandler : private boost::noncopyable {
+public:
+    typedef ChannelInboudMessageHandler<ResponseHandler,
+            HttpPackage,
+            HttpPackage> MessageHandler;
+
+    typedef MessageHandler::Context Context;
+    typedef MessageHandler::InboundContainer InboundContainer;
+
+    typedef Context::Handler Handler;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    ResponseHandler(const PoolWeakPtr& pool)
+        : pool_(pool), container_() {
+    }
+
+    void registerTo(Context& ctx) {
+        container_ = ctx.inboundContainer();
+
+        ctx.setChannelMessageUpdatedCallback(boost::bind(
+                &ResponseHandler::messageUpdated,
+                this,
+                _1));
+
+        ctx.setExceptionCallback(boost::bind(
+                                     &ResponseHandler::exceptionCaught,
+                                     this,
+                                     _1,
+                                     _2));
+    }
+
+private:
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        InboundContainer::MessageQueue& queue = container_->getMessages();
+        ChannelPtr channel = ctx.channel();
+
+        while (!queue.empty()) {
+            HttpResponsePtr response = queue.front().httpResponse();
+            queue.pop_front();
+
+            PoolPtr pool = pool_.lock();
+
+            if (!pool) {
+                queue.clear();
+                return;
+            }
+
+            if (response) {
+                pool->responseReceived(channel, response);
+            }
+        }
+    }
+
+    void exceptionCaught(ChannelHandlerContext& ctx,
+                         const ChannelException& e) {
+        LOG_WARN << "pooled http connection caught an exception: "
+                 << e.what() << ", close it.";
+        ctx.close();
+    }
+
+private:
+    PoolWeakPtr pool_;
+    InboundContainer* container_;
+};
+
+/**
+ * the caller of {@link HttpConnectionPool#close} out of the loop thread
+ * waits on it until the pool is closed in the loop thread.  It is shared
+ * with the posted handler, which may still run after the caller gave up
+ * waiting, then the pool is not touched any more.
+ */
+struct HttpConnectionPool::CloseLatch {
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    HttpConnectionPool* pool;
+    bool closing;
+    bool closed;
+    bool abandoned;
+
+    CloseLatch(HttpConnectionPool* pool)
+        : pool(pool), closing(false), closed(false), abandoned(false) {}
+};
+
+static void notOwned(HttpConnectionPool*) {
+}
+
+// only the idempotent requests are pipelined, or retried on a stale
+// connection, as they are safe to be sent again.
+static bool isIdempotent(const HttpRequestPtr& request) {
+    return request->method() == HttpMethod::GET;
+}
+
+HttpConnectionPool::HttpConnectionPool(const EventLoopPtr& eventLoop)
+    : eventLoop_(eventLoop),
+      bootstrap_(eventLoop),
+      maxIdleConnections_(DEFAULT_MAX_IDLE_CONNECTIONS),
+      maxConnectionsPerHost_(DEFAULT_MAX_CONNECTIONS_PER_HOST),
+      maxPipelinedRequests_(DEFAULT_MAX_PIPELINED_REQUESTS),
+      idleTimeout_(DEFAULT_IDLE_TIMEOUT),
+      maxContentLength_(DEFAULT_MAX_CONTENT_LENGTH),
+      self_(this, notOwned) {
+    bootstrap_.setInitializer(boost::bind(
+                                  &HttpConnectionPool::initializeChannel,
+                                  this,
+                                  _1));
+
+    bootstrap_.setOption(ChannelOption::CO_TCP_NODELAY, true);
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    close();
+}
+
+void HttpConnectionPool::setMaxIdleConnections(int maxIdleConnections) {
+    if (maxIdleConnections < 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("maxIdleConnections must not be negative: %d",
+                               maxIdleConnections));
+    }
+
+    maxIdleConnections_ = maxIdleConnections;
+}
+
+void HttpConnectionPool::setMaxConnectionsPerHost(int maxConnectionsPerHost) {
+    if (maxConnectionsPerHost <= 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("maxConnectionsPerHost must be a positive integer: %d",
+                               maxConnectionsPerHost));
+    }
+
+    maxConnectionsPerHost_ = maxConnectionsPerHost;
+}
+
+void HttpConnectionPool::setMaxPipelinedRequests(int maxPipelinedRequests) {
+    if (maxPipelinedRequests <= 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("maxPipelinedRequests must be a positive integer: %d",
+                               maxPipelinedRequests));
+    }
+
+    maxPipelinedRequests_ = maxPipelinedRequests;
+}
+
+void HttpConnectionPool::setIdleTimeout(int idleTimeout) {
+    if (idleTimeout <= 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("idleTimeout must be a positive integer: %d",
+                               idleTimeout));
+    }
+
+    idleTimeout_ = idleTimeout;
+}
+
+void HttpConnectionPool::setMaxContentLength(int maxContentLength) {
+    if (maxContentLength <= 0) {
+        throw InvalidArgumentException(
+            StringUtil::printf("maxContentLength must be a positive integer: %d",
+                               maxContentLength));
+    }
+
+    maxContentLength_ = maxContentLength;
+}
+
+double HttpConnectionPool::hitRatio() const {
+    int64_t hits = hits_.get();
+    int64_t total = hits + misses_.get();
+
+    return total ? static_cast<double>(hits) / total : 0;
+}
+
+void HttpConnectionPool::request(const std::string& host,
+                                 int port,
+                                 const HttpRequestPtr& request,
+                                 const ResponseCallback& callback) {
+    requests_.incrementAndGet();
+
+    if (eventLoop_->inLoopThread()) {
+        dispatch(host, port, Call(request, callback));
+    }
+    else {
+        void (HttpConnectionPool::*dispatcher)(const std::string&,
+                                               int,
+                                               const Call&) =
+                                                   &HttpConnectionPool::dispatch;
+
+        eventLoop_->post(boost::bind(dispatcher,
+                                     this,
+                                     host,
+                                     port,
+                                     Call(request, callback)));
+    }
+}
+
+void HttpConnectionPool::close() {
+    if (!closed_.compareAndSet(0, 1)) {
+        return;
+    }
+
+    // the handlers posted to a stopped loop will never be run.
+    if (eventLoop_->inLoopThread() || eventLoop_->stopped()) {
+        closeAll();
+        return;
+    }
+
+    CloseLatchPtr latch(new CloseLatch(this));
+    eventLoop_->post(boost::bind(&HttpConnectionPool::closeInLoop, latch));
+
+    boost::system_time deadline = boost::get_system_time()
+                                  + boost::posix_time::milliseconds(CLOSE_TIMEOUT);
+
+    boost::unique_lock<boost::mutex> lock(latch->mutex);
+
+    while (!latch->closed) {
+        if (latch->closing) {
+            latch->condition.wait(lock);
+        }
+        else if (!latch->condition.timed_wait(lock, deadline)
+                 && !latch->closing) {
+            LOG_WARN << "the event loop did not close the http connection pool"
+                     " in " << CLOSE_TIMEOUT << " ms, close it in the caller"
+                     " thread.";
+
+            latch->abandoned = true;
+            lock.unlock();
+
+            closeAll();
+            return;
+        }
+    }
+}
+
+void HttpConnectionPool::notifyIfOpen(const PoolWeakPtr& pool,
+                                      const ChannelFuture::CompletedCallback& listener,
+                                      ChannelFuture& future) {
+    if (pool.lock()) {
+        listener(future);
+    }
+}
+
+bool HttpConnectionPool::initializeChannel(ChannelPipeline& pipeline) {
+    pipeline.addLast<HttpRequestEncoder::HandlerPtr>("encoder",
+            HttpRequestEncoder::HandlerPtr(new HttpRequestEncoder));
+
+    pipeline.addLast<HttpResponseDecoder::HandlerPtr>("decoder",
+            HttpResponseDecoder::HandlerPtr(new HttpResponseDecoder));
+
+    pipeline.addLast<HttpChunkAggregator::HandlerPtr>("aggregator",
+            HttpChunkAggregator::HandlerPtr(
+                new HttpChunkAggregator(maxContentLength_)));
+
+    pipeline.addLast<ResponseHandler::HandlerPtr>("pool",
+            ResponseHandler::HandlerPtr(new ResponseHandler(self_)));
+
+    return true;
+}
+
+void HttpConnectionPool::dispatch(const std::string& host,
+                                  int port,
+                                  const Call& call) {
+    if (closed_.get()) {
+        std::deque<Call> calls(1, call);
+        fail(&calls);
+        return;
+    }
+
+    std::string key(host);
+    key += ':';
+    key += StringUtil::numtostr(port);
+
+    HostMap::iterator itr = hosts_.find(key);
+
+    if (itr == hosts_.end()) {
+        itr = hosts_.insert(std::make_pair(key, new Host(host, port))).first;
+    }
+
+    dispatch(itr->second, call);
+}
+
+void HttpConnectionPool::dispatch(Host* host, const Call& call) {
+    while (!host->idles.empty()) {
+        ConnectionPtr connection = host->idles.front();
+        host->idles.pop_front();
+
+        connection->idle = false;
+        idleConnectionCount_.decrementAndGet();
+
+        if (connection->channel->isActive()) {
+            hits_.incrementAndGet();
+            send(connection, call);
+            return;
+        }
+
+        // closed by the server, but the close is not notified yet.
+        retire(connection);
+    }
+
+    if (static_cast<int>(host->connections.size()) < maxConnectionsPerHost_) {
+        misses_.incrementAndGet();
+        connect(host, call);
+        return;
+    }
+
+    ConnectionPtr connection = pipelinedConnection(host, call);
+
+    if (connection) {
+        hits_.incrementAndGet();
+        send(connection, call);
+        return;
+    }
+
+    host->waitings.push_back(call);
+}
+
+HttpConnectionPool::ConnectionPtr HttpConnectionPool::pipelinedConnection(
+    Host* host,
+    const Call& call) {
+    ConnectionPtr least;
+
+    if (maxPipelinedRequests_ <= 1 || !isIdempotent(call.request)) {
+        return least;
+    }
+
+    ConnectionList::const_iterator itr = host->connections.begin();
+
+    for (; itr != host->connections.end(); ++itr) {
+        const ConnectionPtr& connection = *itr;
+
+        if (!connection->pipelining || connection->closing) {
+            continue;
+        }
+
+        int pending = static_cast<int>(connection->calls.size());
+
+        if (pending < maxPipelinedRequests_ &&
+                (!least || pending < static_cast<int>(least->calls.size()))) {
+            least = connection;
+        }
+    }
+
+    return least;
+}
+
+void HttpConnectionPool::connect(Host* host, const Call& call) {
+    if (!evictTimeout_) {
+        int period = idleTimeout_ / 2 > 0 ? idleTimeout_ / 2 : 1;
+
+        evictTimeout_ = eventLoop_->runEvery(period, boost::bind(
+                &HttpConnectionPool::evictExpired,
+                this));
+    }
+
+    ChannelFuturePtr future = bootstrap_.connect(host->host, host->port);
+
+    ConnectionPtr connection(new Connection(host));
+    connection->channel = future->channel();
+    connection->calls.push_back(call);
+
+    host->connections.push_back(connection);
+    channels_[connection->channel->id()] = connection;
+    connectionCount_.incrementAndGet();
+
+    LOG_DEBUG << "open a new http connection to "
+              << host->host << ":" << host->port;
+
+    future->addListener(boost::bind(
+                            &HttpConnectionPool::notifyIfOpen,
+                            PoolWeakPtr(self_),
+                            ChannelFuture::CompletedCallback(boost::bind(
+                                        &HttpConnectionPool::connected,
+                                        this,
+                                        _1,
+                                        connection)),
+                            _1));
+}
+
+void HttpConnectionPool::connected(ChannelFuture& future,
+                                   ConnectionPtr connection) {
+    Host* host = connection->host;
+
+    if (!future.isSuccess()) {
+        LOG_WARN << "failed to connect to "
+                 << host->host << ":" << host->port;
+
+        std::deque<Call> calls;
+        calls.swap(connection->calls);
+
+        // nothing to wait for if the server is not reachable at all.
+        if (host->connections.size() == 1) {
+            calls.insert(calls.end(),
+                         host->waitings.begin(),
+                         host->waitings.end());
+            host->waitings.clear();
+        }
+
+        retire(connection);
+        fail(&calls);
+        return;
+    }
+
+    connection->channel->closeFuture()->addListener(boost::bind(
+                &HttpConnectionPool::notifyIfOpen,
+                PoolWeakPtr(self_),
+                ChannelFuture::CompletedCallback(boost::bind(
+                            &HttpConnectionPool::closed,
+                            this,
+                            _1)),
+                _1));
+
+    connection->connected = true;
+    connection->lastActive = eventLoop_->now();
+
+    std::deque<Call>::const_iterator itr = connection->calls.begin();
+
+    for (; itr != connection->calls.end(); ++itr) {
+        write(connection, *itr);
+    }
+}
+
+void HttpConnectionPool::send(const ConnectionPtr& connection,
+                              const Call& call) {
+    connection->calls.push_back(call);
+
+    if (connection->connected) {
+        write(connection, call);
+    }
+}
+
+void HttpConnectionPool::write(const ConnectionPtr& connection,
+                               const Call& call) {
+    connection->lastActive = eventLoop_->now();
+
+    // a failed write closes the channel, then the call fails in closed.
+    connection->channel->writeMessage(HttpPackage(call.request));
+}
+
+void HttpConnectionPool::responseReceived(const ChannelPtr& channel,
+        const HttpResponsePtr& response) {
+    ChannelMap::iterator itr = channels_.find(channel->id());
+
+    if (itr == channels_.end() || itr->second->calls.empty()) {
+        LOG_WARN << "received an unexpected http response, ignore it.";
+        return;
+    }
+
+    int code = response->status().code();
+
+    // an interim response, the final one follows, except the 101 which
+    // switches the connection to another protocol.
+    if (code >= 100 && code < 200 && code != 101) {
+        return;
+    }
+
+    ConnectionPtr connection = itr->second;
+    Call call = connection->calls.front();
+
+    connection->calls.pop_front();
+    connection->lastActive = eventLoop_->now();
+    ++connection->responses;
+
+    if (!response->keepAlive() || code == 101) {
+        connection->closing = true;
+    }
+    else if (response->version() == HttpVersion::HTTP_1_1) {
+        connection->pipelining = true;
+    }
+
+    if (call.callback) {
+        call.callback(response);
+    }
+
+    if (connection->closing) {
+        // the server will not answer the requests pipelined after this one.
+        std::deque<Call> calls;
+        calls.swap(connection->calls);
+
+        Host* host = connection->host;
+        retire(connection);
+
+        while (!calls.empty()) {
+            dispatch(host, calls.front());
+            calls.pop_front();
+        }
+    }
+    else if (connection->calls.empty()) {
+        release(connection);
+    }
+}
+
+void HttpConnectionPool::release(const ConnectionPtr& connection) {
+    Host* host = connection->host;
+
+    if (!host->waitings.empty()) {
+        Call call = host->waitings.front();
+        host->waitings.pop_front();
+
+        hits_.incrementAndGet();
+        send(connection, call);
+        return;
+    }
+
+    if (idleConnectionCount_.get() >= maxIdleConnections_) {
+        retire(connection);
+        return;
+    }
+
+    connection->idle = true;
+    host->idles.push_front(connection);
+    idleConnectionCount_.incrementAndGet();
+}
+
+void HttpConnectionPool::retire(const ConnectionPtr& connection) {
+    ChannelMap::iterator itr = channels_.find(connection->channel->id());
+
+    if (itr == channels_.end() || itr->second != connection) {
+        return;
+    }
+
+    Host* host = connection->host;
+
+    channels_.erase(itr);
+    host->connections.remove(connection);
+
+    if (connection->idle) {
+        connection->idle = false;
+        host->idles.remove(connection);
+        idleConnectionCount_.decrementAndGet();
+    }
+
+    connectionCount_.decrementAndGet();
+
+    if (connection->channel->isOpen()) {
+        connection->channel->close();
+    }
+
+    if (!host->waitings.empty() &&
+            static_cast<int>(host->connections.size()) < maxConnectionsPerHost_) {
+        Call call = host->waitings.front();
+        host->waitings.pop_front();
+
+        misses_.incrementAndGet();
+        connect(host, call);
+    }
+}
+
+void HttpConnectionPool::closed(ChannelFuture& future) {
+    ChannelMap::iterator itr = channels_.find(future.channel()->id());
+
+    if (itr == channels_.end()) {
+        return;
+    }
+
+    ConnectionPtr connection = itr->second;
+    Host* host = connection->host;
+    bool reused = connection->responses > 0;
+
+    std::deque<Call> calls;
+    calls.swap(connection->calls);
+
+    retire(connection);
+
+    std::deque<Call> failures;
+
+    while (!calls.empty()) {
+        Call& call = calls.front();
+
+        // the server may close a kept alive connection just when a request
+        // is sent on it, then the request is sent again once.
+        if (reused && !call.retried && isIdempotent(call.request)) {
+            call.retried = true;
+            dispatch(host, call);
+        }
+        else {
+            failures.push_back(call);
+        }
+
+        calls.pop_front();
+    }
+
+    fail(&failures);
+}
+
+void HttpConnectionPool::fail(std::deque<Call>* calls) {
+    while (!calls->empty()) {
+        const Call& call = calls->front();
+
+        if (call.callback) {
+            call.callback(HttpResponsePtr());
+        }
+
+        calls->pop_front();
+    }
+}
+
+void HttpConnectionPool::evictExpired() {
+    boost::posix_time::ptime deadline =
+        eventLoop_->now() - boost::posix_time::milliseconds(idleTimeout_);
+
+    std::vector<ConnectionPtr> expired;
+    HostMap::const_iterator itr = hosts_.begin();
+
+    for (; itr != hosts_.end(); ++itr) {
+        const ConnectionList& idles = itr->second->idles;
+        ConnectionList::const_reverse_iterator idle = idles.rbegin();
+
+        // the least recently idle ones are at the back.
+        for (; idle != idles.rend() && (*idle)->lastActive <= deadline; ++idle) {
+            expired.push_back(*idle);
+        }
+    }
+
+    for (std::size_t i = 0; i < expired.size(); ++i) {
+        retire(expired[i]);
+    }
+
+    if (!expired.empty()) {
+        LOG_DEBUG << "closed " << expired.size() << " idle http connections.";
+    }
+}
+
+void HttpConnectionPool::closeInLoop(const CloseLatchPtr& latch) {
+    {
+        boost::lock_guard<boost::mutex> guard(latch->mutex);
+
+        if (latch->abandoned) {
+            return;
+        }
+
+        latch->closing = true;
+    }
+
+    latch->pool->closeAll();
+
+    boost::lock_guard<boost::mutex> guard(latch->mutex);
+    latch->closed = true;
+    latch->condition.notify_one();
+}
+
+void HttpConnectionPool::closeAll() {
+    if (evictTimeout_) {
+        evictTimeout_->cancel();
+        evictTimeout_.reset();
+    }
+
+    // detaches the listeners of the channels, which may be notified after
+    // the pool is gone.
+    self_.reset();
+
+    std::deque<Call> calls;
+    HostMap::iterator host = hosts_.begin();
+
+    for (; host != hosts_.end(); ++host) {
+        std::deque<Call>& waitings = host->second->waitings;
+        calls.insert(calls.end(), waitings.begin(), waitings.end());
+        waitings.clear();
+    }
+
+    std::vector<ConnectionPtr> connections;
+    ChannelMap::iterator itr = channels_.begin();
+
+    for (; itr != channels_.end(); ++itr) {
+        connections.push_back(itr->second);
+    }
+
+    for (std::size_t i = 0; i < connections.size(); ++i) {
+        std::deque<Call>& pending = connections[i]->calls;
+        calls.insert(calls.end(), pending.begin(), pending.end());
+        pending.clear();
+
+        retire(connections[i]);
+    }
+
+    for (host = hosts_.begin(); host != hosts_.end(); ++host) {
+        delete host->second;
+    }
+
+    hosts_.clear();
+    fail(&calls);
+}
+
+}
+}
+}
@@ -18,6 +18,7 @@
 
 #include <boost/bind.hpp>
 #include <cetty/channel/Channel.h>
+#include <cetty/channel/EventLoop.h>
 #include <cetty/channel/ChannelFuture.h>
 #include <cetty/logging/LoggerHelper.h>
 
@@ -69,14 +70,18 @@ ChannelPtr ConnectionPool::getChannel(const ConnectedCallback& callback) {
         return ChannelPtr();
     }
     else {
-        return channels_.begin()->second->channel;
+        ChannelConnection* conn = channels_.begin()->second;
+        conn->lastActive = conn->channel->eventLoop()->now();
+        return conn->channel;
     }
 }
 
 ChannelPtr ConnectionPool::getChannel() {
     if (!channels_.empty() &&
             channels_.begin()->second->channel->isActive()) {
-        return channels_.begin()->second->channel;
+        ChannelConnection* conn = channels_.begin()->second;
+        conn->lastActive = conn->channel->eventLoop()->now();
+        return conn->channel;
     }
 
     channels_.clear();
@@ -91,6 +96,7 @@ void ConnectionPool::connectedCallback(ChannelFuture& future) {
         ChannelPtr channel = future.channel();
 
         conn->channel = channel;
+        conn->start = conn->lastActive = channel->eventLoop()->now();
         int id = channel->id();
         channels_.insert(id, conn);
 
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cetty/bootstrap/ServerBootstrap.h>
+#include <cetty/buffer/Unpooled.h>
+#include <cetty/channel/ChannelFutureListener.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/channel/ChannelInboundMessageHandler.h>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/asio/AsioServicePool.h>
+#include <cetty/handler/codec/http/HttpServerCodec.h>
+#include <cetty/handler/codec/http/HttpChunkAggregator.h>
+#include <cetty/handler/codec/http/HttpRequest.h>
+#include <cetty/handler/codec/http/HttpResponse.h>
+#include <cetty/service/http/HttpConnectionPool.h>
+#include <cetty/util/Atomic.h>
+
+using namespace cetty::bootstrap;
+using namespace cetty::buffer;
+using namespace cetty::channel;
+using namespace cetty::channel::asio;
+using namespace cetty::handler::codec::http;
+using namespace cetty::service::http;
+using namespace cetty::util;
+
+static const int PORT = 19833;
+static const char* HOST = "127.0.0.1";
+
+static Atomic<int> accepted;
+
+/**
+ * answers "hello <uri>", closes the connection after answering the uris
+ * containing "close", and without answering the ones containing "drop".
+ */
+class PoolTestServer : private boost::noncopyable {
+public:
+    typedef ChannelInboudMessageHandler<PoolTestServer,
+            HttpPackage,
+            HttpPackage> MessageHandler;
+
+    typedef MessageHandler::Context Context;
+    typedef MessageHandler::InboundContainer InboundContainer;
+    typedef MessageHandler::OutboundTransfer OutboundTransfer;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    void registerTo(Context& ctx) {
+        container_ = ctx.inboundContainer();
+        transfer_ = ctx.outboundTransfer();
+
+        ctx.setChannelActiveCallback(boost::bind(
+                                         &PoolTestServer::channelActive,
+                                         this,
+                                         _1));
+
+        ctx.setChannelMessageUpdatedCallback(boost::bind(
+                &PoolTestServer::messageUpdated,
+                this,
+                _1));
+    }
+
+private:
+    void channelActive(ChannelHandlerContext& ctx) {
+        accepted.incrementAndGet();
+    }
+
+    void messageUpdated(ChannelHandlerContext& ctx) {
+        InboundContainer::MessageQueue& queue = container_->getMessages();
+
+        while (!queue.empty()) {
+            HttpRequestPtr request = queue.front().httpRequest();
+            queue.pop_front();
+
+            if (!request) {
+                continue;
+            }
+
+            const std::string& uri = request->getUriString();
+
+            if (uri.find("drop") != std::string::npos) {
+                queue.clear();
+                ctx.close();
+                return;
+            }
+
+            std::string content = "hello " + uri;
+            HttpResponsePtr response(new HttpResponse(HttpVersion::HTTP_1_1,
+                                     HttpResponseStatus::OK));
+
+            response->setContent(Unpooled::copiedBuffer(content));
+            response->setContentLength(static_cast<int>(content.size()));
+
+            bool closing = uri.find("close") != std::string::npos;
+
+            if (closing) {
+                response->headers().setHeader(HttpHeaders::Names::CONNECTION,
+                                              HttpHeaders::Values::CLOSE);
+            }
+
+            ChannelFuturePtr future = ctx.newFuture();
+            transfer_->write(HttpPackage(response), future);
+
+            if (closing) {
+                future->addListener(ChannelFutureListener::CLOSE);
+            }
+        }
+    }
+
+private:
+    InboundContainer* container_;
+    OutboundTransfer* transfer_;
+};
+
+static bool initializeServer(ChannelPipeline& pipeline) {
+    pipeline.addLast<HttpServerCodec::HandlerPtr>("codec",
+            HttpServerCodec::HandlerPtr(new HttpServerCodec));
+
+    pipeline.addLast<HttpChunkAggregator::HandlerPtr>("aggregator",
+            HttpChunkAggregator::HandlerPtr(new HttpChunkAggregator(1 << 20)));
+
+    pipeline.addLast<PoolTestServer::HandlerPtr>("server",
+            PoolTestServer::HandlerPtr(new PoolTestServer));
+
+    return true;
+}
+
+class HttpConnectionPoolTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        // kept for all the tests, and left to the process exit.
+        ServerBootstrap* server =
+            new ServerBootstrap(EventLoopPoolPtr(new AsioServicePool(1)));
+
+        server->setChildInitializer(boost::bind(&initializeServer, _1));
+        server->setOption(ChannelOption::CO_SO_REUSEADDR, true);
+        server->bind(PORT)->await();
+    }
+
+    HttpConnectionPoolTest()
+        : eventLoopPool(new AsioServicePool(1)),
+          pool(new HttpConnectionPool(eventLoopPool->nextLoop())) {
+        acceptedBefore = accepted.get();
+    }
+
+    virtual ~HttpConnectionPoolTest() {
+        pool.reset();
+
+        eventLoopPool->stop();
+        eventLoopPool->waitingForStop();
+    }
+
+    void request(const std::string& uri) {
+        HttpRequestPtr request(new HttpRequest(HttpVersion::HTTP_1_1,
+                                               HttpMethod::GET,
+                                               uri));
+        request->headers().setHeader(HttpHeaders::Names::HOST, HOST);
+
+        pool->request(HOST, PORT, request, boost::bind(
+                          &HttpConnectionPoolTest::responded,
+                          this,
+                          _1));
+    }
+
+    void responded(const HttpResponsePtr& response) {
+        if (response) {
+            succeeded.incrementAndGet();
+        }
+        else {
+            failed.incrementAndGet();
+        }
+    }
+
+    // waits for the callbacks of <tt>count</tt> requests in total.
+    bool waitFor(int count) {
+        for (int i = 0; i < 500; ++i) {
+            if (succeeded.get() + failed.get() >= count) {
+                return true;
+            }
+
+            usleep(10 * 1000);
+        }
+
+        return false;
+    }
+
+    int newConnections() const {
+        return accepted.get() - acceptedBefore;
+    }
+
+    EventLoopPoolPtr eventLoopPool;
+    boost::scoped_ptr<HttpConnectionPool> pool;
+
+    int acceptedBefore;
+    Atomic<int> succeeded;
+    Atomic<int> failed;
+};
+
+TEST_F(HttpConnectionPoolTest, testReuseIdleConnection) {
+    for (int i = 0; i < 5; ++i) {
+        request("/reuse");
+        ASSERT_TRUE(waitFor(i + 1));
+    }
+
+    ASSERT_EQ(5, succeeded.get());
+    ASSERT_EQ(1, newConnections());
+    ASSERT_EQ(1, pool->misses());
+    ASSERT_EQ(4, pool->hits());
+    ASSERT_EQ(1, pool->connectionCount());
+    ASSERT_EQ(1, pool->idleConnectionCount());
+}
+
+TEST_F(HttpConnectionPoolTest, testEvictIdleConnection) {
+    pool->setIdleTimeout(200);
+
+    request("/idle");
+    ASSERT_TRUE(waitFor(1));
+    ASSERT_EQ(1, pool->idleConnectionCount());
+
+    usleep(600 * 1000);
+
+    ASSERT_EQ(0, pool->idleConnectionCount());
+    ASSERT_EQ(0, pool->connectionCount());
+}
+
+TEST_F(HttpConnectionPoolTest, testServerClose) {
+    request("/close");
+    ASSERT_TRUE(waitFor(1));
+
+    // the connection is not returned to the pool.
+    ASSERT_EQ(0, pool->idleConnectionCount());
+    ASSERT_EQ(0, pool->connectionCount());
+
+    request("/after-close");
+    ASSERT_TRUE(waitFor(2));
+
+    ASSERT_EQ(2, succeeded.get());
+    ASSERT_EQ(2, newConnections());
+    ASSERT_EQ(2, pool->misses());
+}
+
+TEST_F(HttpConnectionPoolTest, testPipelinedConnectionClosed) {
+    pool->setMaxConnectionsPerHost(1);
+
+    // a persistent HTTP/1.1 response enables the pipelining.
+    request("/first");
+    ASSERT_TRUE(waitFor(1));
+
+    request("/drop");
+    request("/second");
+    request("/third");
+    ASSERT_TRUE(waitFor(4));
+
+    // the server closes without answering, all the pipelined requests are
+    // sent again once on a new connection, "/drop" fails as it is closed
+    // again, then the others are sent on another new one.
+    ASSERT_EQ(3, succeeded.get());
+    ASSERT_EQ(1, failed.get());
+    ASSERT_EQ(3, newConnections());
+    ASSERT_EQ(1, pool->connectionCount());
+    ASSERT_EQ(1, pool->idleConnectionCount());
+}
+
+TEST_F(HttpConnectionPoolTest, testRequestAfterClose) {
+    request("/before-close");
+    ASSERT_TRUE(waitFor(1));
+
+    pool->close();
+    ASSERT_EQ(0, pool->connectionCount());
+
+    request("/after-close");
+    ASSERT_TRUE(waitFor(2));
+    ASSERT_EQ(1, failed.get());
+}
+
+TEST_F(HttpConnectionPoolTest, testCloseAfterLoopStopped) {
+    request("/before-stop");
+    ASSERT_TRUE(waitFor(1));
+
+    eventLoopPool->stop();
+    eventLoopPool->waitingForStop();
+
+    // closed in this thread, not waiting for the stopped loop.
+    pool->close();
+    ASSERT_EQ(0, pool->connectionCount());
+}
@@ -37,3 +37,14 @@ if (Mongo_found)
 else (Mongo_found)
     message(STATUS "mongo library not found")
 endif (Mongo_found)
+
+# the io_uring transport needs the kernel headers of Linux 5.11 or later.
+if (CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    include(CheckSymbolExists)
+    CHECK_SYMBOL_EXISTS(IORING_FEAT_EXT_ARG "linux/io_uring.h" HAVE_IO_URING)
+    if (HAVE_IO_URING)
+        add_definitions(-DCETTY_HAVE_IO_URING)
+    else (HAVE_IO_URING)
+        message(STATUS "linux/io_uring.h not found or too old, the io_uring transport disabled")
+    endif (HAVE_IO_URING)
+endif ()
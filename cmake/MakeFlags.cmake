@@ -98,3 +98,9 @@ if (CMAKE_COMPILER_IS_GNUCXX)
   set(CMAKE_CXX_FLAGS_DEBUG "-O0")
   set(CMAKE_CXX_FLAGS_RELEASE "-O2 -finline-limit=1000 -DNDEBUG")
 endif()
+
+# The log call sites below CETTY_MIN_LOG_LEVEL are compiled out,
+# 0 (TRACE), 1 (DEBUG), 2 (INFO), 3 (WARN), e.g. -DCETTY_MIN_LOG_LEVEL=2
+if (CETTY_MIN_LOG_LEVEL)
+  add_definitions(-DCETTY_MIN_LOG_LEVEL=${CETTY_MIN_LOG_LEVEL})
+endif()
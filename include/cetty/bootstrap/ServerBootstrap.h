@@ -36,6 +36,8 @@ namespace bootstrap {
 
 using namespace cetty::channel;
 
+class Acceptor;
+
 /**
  * A helper class which creates a new server-side {@link Channel} and accepts
  * incoming connections.
@@ -137,6 +139,21 @@ using namespace cetty::channel;
  * one {@link Channel}s or run a server that accepts incoming connections to
  * create its child channels.
  *
+ * <h3>Accepting in every child event loop</h3>
+ *
+ * By default, the parent channel accepts in one parent event loop, and hands
+ * off the accepted channels to the child event loops.  With
+ * {@link #setReusePort(bool)}, every child event loop opens its own
+ * <tt>SO_REUSEPORT</tt> acceptor on the same address, the kernel balances
+ * the incoming connections among them, and every connection is accepted and
+ * served in the same event loop, without a cross-thread handoff.
+ *
+ * <pre>
+ * {@link ServerBootstrap} b(1, 4);
+ * b.setReusePort(true);
+ * b.bind(8080);
+ * </pre>
+ *
  * <h3>Applying different settings for different {@link Channel}s</h3>
  *
  * {@link ServerBootstrap} is just a helper class.  It neither allocates nor
@@ -191,6 +208,12 @@ public:
      */
     virtual ServerBootstrap& setEventLoopPool(const EventLoopPoolPtr& pool);
 
+    /**
+     * Accept the connections by one <tt>SO_REUSEPORT</tt> acceptor in every
+     * child event loop, same as setting {@link ChannelOption#CO_SO_REUSEPORT}.
+     */
+    ServerBootstrap& setReusePort(bool reusePort);
+
     /**
      *
      */
@@ -271,9 +294,12 @@ public:
     virtual void waitingForExit();
 
 private:
+    friend class Acceptor;
+
     ChannelPtr newChannel();
 
     bool initServerChannel(ChannelPipeline& pipeline);
+    void initChildChannel(const ChannelPtr& child);
 
 private:
     bool daemonized_;
@@ -306,6 +332,11 @@ ServerBootstrap& ServerBootstrap::setPidFileName(const std::string& fileName) {
     return *this;
 }
 
+inline
+ServerBootstrap& ServerBootstrap::setReusePort(bool reusePort) {
+    return setOption(ChannelOption::CO_SO_REUSEPORT, reusePort);
+}
+
 inline
 const ChannelOptions& ServerBootstrap::childOptions() const {
     return childOptions_;
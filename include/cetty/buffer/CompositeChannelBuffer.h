@@ -55,6 +55,17 @@ public:
      */
     std::vector<ChannelBufferPtr> decompose(int index, int length);
 
+    /**
+     * Merges all the components into one heap buffer, keeping the indexes.
+     * After that the readable bytes are contiguous.
+     */
+    void consolidate();
+
+    /**
+     * Returns the readable bytes as one contiguous region, the components
+     * will be {@link #consolidate() consolidated} first if there are more
+     * than one.
+     */
     virtual const char* readableBytes(int* length);
     virtual char* writableBytes(int* length);
     virtual char* aheadWritableBytes(int* length);
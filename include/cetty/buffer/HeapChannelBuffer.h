@@ -114,7 +114,7 @@ public:
 private:
     void init(char* buf, int length, int maxCapacity, int readerIndex, int writerIndex);
 
-private:
+protected:
     /**
      *  Indicated whether to maintain the life cycle of
      *  the underlying heap byte or not.
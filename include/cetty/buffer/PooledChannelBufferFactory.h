@@ -0,0 +1,138 @@
+#if !defined(CETTY_BUFFER_POOLEDCHANNELBUFFERFACTORY_H)
+#define CETTY_BUFFER_POOLEDCHANNELBUFFERFACTORY_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/Types.h>
+#include <cetty/buffer/ChannelBufferPtr.h>
+
+namespace cetty {
+namespace buffer {
+
+/**
+ * Creates heap {@link ChannelBuffer}s whose memory blocks come from a
+ * per-thread arena, instead of <tt>new char[]</tt> like {@link Unpooled}.
+ *
+ * <h3>Size classes</h3>
+ * The requested capacity is rounded up to a size class in the jemalloc
+ * style: 16 bytes spacing up to 128 bytes, then four classes for every
+ * doubling up to {@link #MAX_POOLED_SIZE}.  Larger buffers are allocated
+ * from the heap directly and are not cached.
+ *
+ * <h3>Arenas</h3>
+ * Every thread (so every {@link EventLoop}) owns its arena, allocating from
+ * it takes no lock.  When the reference count of a pooled buffer drops to
+ * zero, its memory block goes back to the arena which allocated it, a block
+ * released in another thread is handed back to the owner arena and reused
+ * on the owner's next allocation.
+ *
+ * <pre>
+ * {@link ChannelBufferPtr} buffer = PooledChannelBufferFactory::buffer(4096);
+ * </pre>
+ *
+ * Channels use the factory for their own buffers when the
+ * {@link ChannelOption#CO_POOLED_BUFFER} option is set.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class PooledChannelBufferFactory {
+public:
+    /**
+     * the max size class, larger buffers will not be pooled.
+     */
+    static const int MAX_POOLED_SIZE = 256 * 1024;
+
+    struct Statistics {
+        /**
+         * allocations served from the cached blocks.
+         */
+        int64_t hits;
+
+        /**
+         * allocations which had to get memory from the heap.
+         */
+        int64_t misses;
+
+        /**
+         * bytes of the free blocks cached in the arenas.
+         */
+        int64_t residentBytes;
+
+        /**
+         * count of the arenas, one for every thread using the factory.
+         */
+        int arenas;
+
+        Statistics() : hits(0), misses(0), residentBytes(0), arenas(0) {}
+    };
+
+public:
+    /**
+     * Creates a new big-endian pooled heap buffer with the specified
+     * <tt>initialCapacity</tt>, which expands its capacity on demand.
+     */
+    static ChannelBufferPtr buffer(int initialCapacity);
+
+    /**
+     * Creates a new big-endian pooled heap buffer with the specified
+     * <tt>capacity + aheadBytes</tt>.  The new buffer's <tt>readerIndex</tt>
+     * and <tt>writerIndex</tt> are <tt>aheadBytes</tt>.
+     *
+     * @return if capacity is <tt>0</tt>, return <tt>Unpooled::EMPTY_BUFFER</tt>
+     */
+    static ChannelBufferPtr buffer(int initialCapacity,
+                                   int aheadBytes,
+                                   int maxCapacity = MAX_INT32);
+
+    /**
+     * Returns the size class the <tt>size</tt> will be rounded up to,
+     * or <tt>size</tt> itself when larger than {@link #MAX_POOLED_SIZE}.
+     */
+    static int sizeClass(int size);
+
+    /**
+     * Gets the statistics summed over all the arenas.
+     */
+    static void statistics(Statistics* statistics);
+
+    /**
+     * Gets the statistics of the arena of the current thread.
+     */
+    static void threadStatistics(Statistics* statistics);
+
+    /**
+     * Creates the arena of the current thread now instead of on the first
+     * allocation, mostly called by an {@link EventLoop} thread which has
+     * been placed on its numa node, see {@link EventLoopThreadPlacement},
+     * so the arena lives on the node of the thread from the beginning.
+     */
+    static void prepareThreadArena();
+
+private:
+    PooledChannelBufferFactory();
+    ~PooledChannelBufferFactory();
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_BUFFER_POOLEDCHANNELBUFFERFACTORY_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -151,6 +151,15 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Returns {@code true} if the I/O thread will perform the requested
+     * write operation immediately, {@code false} if the bytes waiting to be
+     * written have exceeded the high water mark, and the writes had better
+     * be held until a <tt>channelWritabilityChanged</tt> event reports that
+     * they dropped below the low water mark again.
+     */
+    virtual bool isWritable() const;
+
     /**
      * Returns the local address where this channel is bound to.
      *
@@ -723,6 +732,11 @@ bool Channel::isActive() const {
     return state_ == CHANNEL_ACTIVED;
 }
 
+inline
+bool Channel::isWritable() const {
+    return true;
+}
+
 inline
 ChannelFuturePtr Channel::newSucceededFuture() {
     return succeededFuture_;
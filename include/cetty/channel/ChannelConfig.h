@@ -24,6 +24,7 @@
 #include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 #include <cetty/channel/ChannelOptions.h>
+#include <cetty/buffer/ChannelBufferPtr.h>
 
 namespace cetty {
 namespace channel {
@@ -145,6 +146,25 @@ public:
      */
     ChannelConfig& setAutoRead(bool autoRead);
 
+    /**
+     * Returns {@code true} if the buffers owned by the channel are allocated
+     * from the {@link PooledChannelBufferFactory}. The default value is {@code false}.
+     */
+    bool pooledBuffer() const;
+
+    /**
+     * Sets if the buffers owned by the channel are allocated from the
+     * {@link PooledChannelBufferFactory} instead of {@link Unpooled}.
+     */
+    ChannelConfig& setPooledBuffer(bool pooledBuffer);
+
+    /**
+     * Creates a new buffer with the specified <tt>initialCapacity</tt>,
+     * from the {@link PooledChannelBufferFactory} if {@link #pooledBuffer()},
+     * otherwise from {@link Unpooled}.
+     */
+    cetty::buffer::ChannelBufferPtr newBuffer(int initialCapacity) const;
+
     /**
      * Sets the callback which will be invoked when {@link #setOption} or {@link #setOptions} called.
      * Clear the callback when setting an empty {@link OptionSetCallback}.
@@ -153,6 +173,7 @@ public:
 
 private:
     bool autoRead_;
+    bool pooledBuffer_;
     int connectTimeoutMillis_; // 10 seconds
     OptionSetCallback callback_;
 };
@@ -173,6 +194,17 @@ ChannelConfig& ChannelConfig::setAutoRead(bool autoRead) {
     return *this;
 }
 
+inline
+bool ChannelConfig::pooledBuffer() const {
+    return pooledBuffer_;
+}
+
+inline
+ChannelConfig& ChannelConfig::setPooledBuffer(bool pooledBuffer) {
+    pooledBuffer_ = pooledBuffer;
+    return *this;
+}
+
 inline
 ChannelConfig& ChannelConfig::setOptionSetCallback(
     const ChannelConfig::OptionSetCallback& callback) {
@@ -32,6 +32,7 @@
 #include <cetty/channel/InetAddress.h>
 #include <cetty/channel/ChannelException.h>
 #include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageContainerCache.h>
 #include <cetty/buffer/ChannelBuffer.h>
 
 namespace cetty {
@@ -217,6 +218,13 @@ public:
      */
     typedef boost::function<void (ChannelHandlerContext&)> ChannelReadSuspendedCallback;
 
+    /**
+     * Invoked when the writable state of the {@link Channel} changed, that is
+     * the bytes waiting to be written crossed the high water mark or dropped
+     * below the low water mark. Check the state with {@link Channel#isWritable()}.
+     */
+    typedef boost::function<void (ChannelHandlerContext&)> ChannelWritabilityChangedCallback;
+
     /**
      * Called once a bind operation is made.
      *
@@ -311,6 +319,13 @@ public:
      */
     const EventLoopPtr& eventLoop() const;
 
+    /**
+     * Creates a new buffer with the specified <tt>initialCapacity</tt>
+     * as the {@link ChannelConfig} of the {@link Channel} decides,
+     * or from {@link Unpooled} when the channel has been detached.
+     */
+    ChannelBufferPtr newBuffer(int initialCapacity) const;
+
     /**
      * Returns the name of the {@link ChannelHandler} in the
      * {@link ChannelPipeline}.
@@ -399,22 +414,45 @@ public:
         return NULL;
     }
 
+    /**
+     * the nearest inbound container of type <tt>T</tt> after this context,
+     * cached till the {@link ChannelPipeline} changes.
+     */
     template<class T>
     T* nextInboundMessageContainer() {
-        if (next_) {
-            return nextInboundMessageContainer<T>(next_);
+        if (!next_) {
+            return NULL;
         }
 
-        return NULL;
+        T* container = NULL;
+
+        if (pipelineGeneration_
+                && nextInboundContainer_.get(*pipelineGeneration_, &container)) {
+            return container;
+        }
+
+        bool cacheable = true;
+        container = nextInboundMessageContainer<T>(next_, &cacheable);
+
+        if (pipelineGeneration_ && cacheable) {
+            nextInboundContainer_.set(*pipelineGeneration_, container);
+        }
+
+        return container;
     }
 
     template<class T>
-    T* nextInboundMessageContainer(ChannelHandlerContext* ctx) {
+    T* nextInboundMessageContainer(ChannelHandlerContext* ctx,
+                                   bool* cacheable = NULL) {
         ChannelHandlerContext* context = ctx;
 
         while (context) {
             T* t = context->inboundMessageContainer<T>();
 
+            if (cacheable && !context->messageContainerCacheable()) {
+                *cacheable = false;
+            }
+
             if (t) {
                 return t;
             }
@@ -444,27 +482,47 @@ public:
     }
 
     /**
-     *
+     * the nearest outbound container of type <tt>T</tt> before this
+     * context, cached till the {@link ChannelPipeline} changes.
      */
     template<class T>
     T* nextOutboundMessageContainer() {
-        if (prev_) {
-            return nextOutboundMessageContainer<T>(prev_);
+        if (!prev_) {
+            return NULL;
         }
 
-        return NULL;
+        T* container = NULL;
+
+        if (pipelineGeneration_
+                && nextOutboundContainer_.get(*pipelineGeneration_, &container)) {
+            return container;
+        }
+
+        bool cacheable = true;
+        container = nextOutboundMessageContainer<T>(prev_, &cacheable);
+
+        if (pipelineGeneration_ && cacheable) {
+            nextOutboundContainer_.set(*pipelineGeneration_, container);
+        }
+
+        return container;
     }
 
     /**
      *
      */
     template<class T>
-    T* nextOutboundMessageContainer(ChannelHandlerContext* ctx) {
+    T* nextOutboundMessageContainer(ChannelHandlerContext* ctx,
+                                   bool* cacheable = NULL) {
         ChannelHandlerContext* context = ctx;
 
         while (context) {
             T* t = context->outboundMessageContainer<T>();
 
+            if (cacheable && !context->messageContainerCacheable()) {
+                *cacheable = false;
+            }
+
             if (t) {
                 return t;
             }
@@ -488,6 +546,7 @@ public:
     const ChannelInactiveCallback& channelInactiveCallback() const;
     const ChannelMessageUpdatedCallback& channelMessageUpdatedCallback() const;
     const ChannelReadSuspendedCallback& channelReadSuspendedCallback() const;
+    const ChannelWritabilityChangedCallback& channelWritabilityChangedCallback() const;
     const BindFunctor& bindFunctor() const;
     const ConnectFunctor& connectFunctor() const;
     const DisconnectFunctor& disconnectFunctor() const;
@@ -509,6 +568,7 @@ public:
     void setChannelInactiveCallback(const ChannelInactiveCallback& channelInactive);
     void setChannelMessageUpdatedCallback(const ChannelMessageUpdatedCallback& messageUpdated);
     void setChannelReadSuspendedCallback(const ChannelReadSuspendedCallback& readSuspended);
+    void setChannelWritabilityChangedCallback(const ChannelWritabilityChangedCallback& writabilityChanged);
     void setBindFunctor(const BindFunctor& bindFun);
     void setConnectFunctor(const ConnectFunctor& connectFun);
     void setDisconnectFunctor(const DisconnectFunctor& disconnectFun);
@@ -579,6 +639,12 @@ public:
      */
     void fireChannelReadSuspended();
 
+    /**
+     * Triggers a {@link ChannelWritabilityChangedCallback} event to the next
+     * {@link ChannelHandler} in the {@link ChannelPipeline}.
+     */
+    void fireChannelWritabilityChanged();
+
     /**
      * Request to bind to the given {@link SocketAddress} and notify the {@link ChannelFuture} once the operation
      * completes, either because the operation was successful or because of an error.
@@ -702,6 +768,7 @@ public:
     void fireChannelInactive(ChannelHandlerContext& ctx);
     void fireMessageUpdated(ChannelHandlerContext& ctx);
     void fireChannelReadSuspended(ChannelHandlerContext& ctx);
+    void fireChannelWritabilityChanged(ChannelHandlerContext& ctx);
     void fireExceptionCaught(ChannelHandlerContext& ctx,
         const ChannelException& cause);
 
@@ -744,6 +811,15 @@ protected:
      */
     virtual boost::any getOutboundMessageContainer() = 0;
 
+    /**
+     * whether the containers returned by this context may be cached by the
+     * others till the pipeline changes, false if they come and go with
+     * something out of the pipeline, e.g. a linked channel.
+     */
+    virtual bool messageContainerCacheable() const {
+        return true;
+    }
+
     /**
      *
      */
@@ -771,6 +847,7 @@ private:
     ChannelInactiveCallback channelInactiveCallback_;
     ChannelMessageUpdatedCallback channelMessageUpdatedCallback_;
     ChannelReadSuspendedCallback channelReadSuspendedCallback_;
+    ChannelWritabilityChangedCallback channelWritabilityChangedCallback_;
 
     BindFunctor bindFunctor_;
     ConnectFunctor connectFunctor_;
@@ -786,6 +863,7 @@ private:
         EVT_CHANNEL_INACTIVE,
         EVT_CHANNEL_EXCEPTION,
         EVT_CHANNEL_READ_SUSPENDED,
+        EVT_CHANNEL_WRITABILITY_CHANGED,
         EVT_CHANNEL_USR_EVENT,
         EVT_CHANNEL_MESSAGE_UPDATED,
         EVT_CHANNEL_BIND,
@@ -809,6 +887,11 @@ private:
     EventLoopPtr eventLoop_;
     ChannelWeakPtr channel_;
     const ChannelPipeline* pipeline_;
+
+    // the generation of the pipeline, and the next containers found in it.
+    const int* pipelineGeneration_;
+    ChannelMessageContainerCache nextInboundContainer_;
+    ChannelMessageContainerCache nextOutboundContainer_;
 };
 
 inline
@@ -933,6 +1016,12 @@ ChannelHandlerContext::channelReadSuspendedCallback() const {
     return channelReadSuspendedCallback_;
 }
 
+inline
+const ChannelHandlerContext::ChannelWritabilityChangedCallback&
+ChannelHandlerContext::channelWritabilityChangedCallback() const {
+    return channelWritabilityChangedCallback_;
+}
+
 inline
 const ChannelHandlerContext::BindFunctor&
 ChannelHandlerContext::bindFunctor() const {
@@ -1041,6 +1130,12 @@ void ChannelHandlerContext::setChannelReadSuspendedCallback(
     channelReadSuspendedCallback_ = readSuspended;
 }
 
+inline
+void ChannelHandlerContext::setChannelWritabilityChangedCallback(
+    const ChannelHandlerContext::ChannelWritabilityChangedCallback& writabilityChanged) {
+    channelWritabilityChangedCallback_ = writabilityChanged;
+}
+
 inline
 void ChannelHandlerContext::setBindFunctor(
     const ChannelHandlerContext::BindFunctor& bindFun) {
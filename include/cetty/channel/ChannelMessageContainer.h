@@ -18,8 +18,12 @@
  */
 
 #include <deque>
+#include <boost/bind.hpp>
 #include <boost/assert.hpp>
 #include <cetty/channel/VoidMessage.h>
+#include <cetty/channel/EventLoop.h>
+
+#include <cetty/util/MpscQueue.h>
 
 #include <cetty/buffer/Unpooled.h>
 #include <cetty/buffer/ChannelBuffer.h>
@@ -36,6 +40,17 @@ enum ChannelMessageType {
     MESSAGE_BLOCK
 };
 
+/**
+ * The container of the messages between two handlers.
+ *
+ * The messages added out of the event loop are pushed to a lock-free inbox
+ * without copying, the ownership is transferred, so the sender should not
+ * modify the message any more.  Only the first message pushed into an empty
+ * inbox posts a drain to the event loop, so N writes from the other threads
+ * cost one wakeup.  The inbox is also drained before the messages are got,
+ * so the messages added before a flush will always be flushed.
+ */
+
 template<class T, int MessageType>
 class ChannelMessageContainer {
 public:
@@ -120,8 +135,20 @@ public:
         if (eventLoop_->inLoopThread()) {
             ChannelBufferPtr buffer = Unpooled::buffer(DEFAULT_BUFFER_SIZE);
 
+            if (!inbox_.empty()) {
+                drainInbox();
+            }
+
             if (!empty()) {
-                buffer->writeBytes(buffer_);
+                if (buffer_) {
+                    buffer->writeBytes(buffer_);
+                }
+
+                while (!pendings_.empty()) {
+                    buffer->writeBytes(pendings_.front());
+                    pendings_.pop_front();
+                }
+
                 buffer_ = buffer;
 
                 LOG_INFO << "setting the ChannelBufferContaner to accumulated,"
@@ -131,6 +158,8 @@ public:
             else {
                 buffer_ = buffer;
             }
+
+            accumulated_ = true;
         }
         else {
             eventLoop_->post(boost::bind(&Container::setAccumulated, this));
@@ -139,21 +168,32 @@ public:
 
     void addMessage(const ChannelBufferPtr& message) {
         if (eventLoop_->inLoopThread()) {
-            if (accumulated_) {
-                buffer_->writeBytes(message);
-            }
-            else {
-                buffer_ = message;
+            if (!inbox_.empty()) {
+                drainInbox();
             }
+
+            appendMessage(message);
         }
-        else {
-            eventLoop_->post(boost::bind(&Container::addMessage,
-                                         this,
-                                         message->copy()));
+        else if (inbox_.push(message)) {
+            eventLoop_->post(boost::bind(&Container::drainInbox, this));
         }
     }
 
+    /**
+     * A buffer which is not accumulated replaces the previous one, so the
+     * buffers drained together wait in the order added, and each call takes
+     * the next one, as each write out of the event loop posts its own flush.
+     */
     ChannelBufferPtr& getMessages() {
+        if (!inbox_.empty()) {
+            drainInbox();
+        }
+
+        if (!pendings_.empty()) {
+            buffer_ = pendings_.front();
+            pendings_.pop_front();
+        }
+
         return buffer_;
     }
 
@@ -162,13 +202,45 @@ public:
     }
 
     bool empty() const {
-        return !(buffer_ && buffer_->readable());
+        return !(buffer_ && buffer_->readable())
+               && pendings_.empty()
+               && inbox_.empty();
+    }
+
+private:
+    void appendMessage(const ChannelBufferPtr& message) {
+        if (accumulated_) {
+            buffer_->writeBytes(message);
+        }
+        else if (pendings_.empty()) {
+            buffer_ = message;
+        }
+        else {
+            pendings_.push_back(message);
+        }
+    }
+
+    void appendPendingMessage(const ChannelBufferPtr& message) {
+        if (accumulated_) {
+            buffer_->writeBytes(message);
+        }
+        else {
+            pendings_.push_back(message);
+        }
+    }
+
+    void drainInbox() {
+        inbox_.popAll(boost::bind(&Container::appendPendingMessage, this, _1));
     }
 
 private:
     bool accumulated_;
     ChannelBufferPtr buffer_;
     EventLoopPtr eventLoop_;
+
+    // the buffers drained but not got yet, only when not accumulated.
+    std::deque<ChannelBufferPtr> pendings_;
+    cetty::util::MpscQueue<ChannelBufferPtr> inbox_;
 };
 
 template<class T>
@@ -186,16 +258,22 @@ public:
 
     void addMessage(const T& message) {
         if (eventLoop_->inLoopThread()) {
+            if (!inbox_.empty()) {
+                drainInbox();
+            }
+
             messageQueue_.push_back(message);
         }
-        else {
-            eventLoop_->post(boost::bind(&Container::addMessage,
-                                         this,
-                                         message));
+        else if (inbox_.push(message)) {
+            eventLoop_->post(boost::bind(&Container::drainInbox, this));
         }
     }
 
     MessageQueue& getMessages() {
+        if (!inbox_.empty()) {
+            drainInbox();
+        }
+
         return messageQueue_;
     }
 
@@ -204,28 +282,24 @@ public:
     }
 
     bool empty() const {
-        return messageQueue_.empty();
+        return messageQueue_.empty() && inbox_.empty();
     }
 
 private:
-    EventLoopPtr eventLoop_;
-    MessageQueue messageQueue_;
-};
-
-template<> inline
-void ChannelMessageContainer<ChannelBufferPtr, MESSAGE_BLOCK>::addMessage(
-    const ChannelBufferPtr& message) {
-    if (eventLoop_->inLoopThread()) {
+    void appendMessage(const T& message) {
         messageQueue_.push_back(message);
     }
-    else {
-        eventLoop_->post(
-            boost::bind(
-                &ChannelMessageContainer<ChannelBufferPtr, MESSAGE_BLOCK>::addMessage,
-                this,
-                message->copy()));
+
+    void drainInbox() {
+        inbox_.popAll(boost::bind(&Container::appendMessage, this, _1));
     }
-}
+
+private:
+    EventLoopPtr eventLoop_;
+    MessageQueue messageQueue_;
+
+    cetty::util::MpscQueue<T> inbox_;
+};
 
 typedef ChannelMessageContainer<VoidMessage, MESSAGE_STREAM> VoidBufferContainer;
 typedef ChannelMessageContainer<VoidMessage, MESSAGE_BLOCK>  VoidMessageContainer;
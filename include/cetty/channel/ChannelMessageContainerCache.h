@@ -0,0 +1,85 @@
+#if !defined(CETTY_CHANNEL_CHANNELMESSAGECONTAINERCACHE_H)
+#define CETTY_CHANNEL_CHANNELMESSAGECONTAINERCACHE_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <typeinfo>
+#include <cstddef>
+
+namespace cetty {
+namespace channel {
+
+/**
+ * Remembers the message container of type <tt>T</tt> found by walking the
+ * {@link ChannelHandlerContext}s, so the following lookups of the same type
+ * are only a pointer compare, till the {@link ChannelPipeline#generation}
+ * changes.
+ *
+ * Only one type is remembered, which is the common case of a context
+ * transferring one kind of message to the next.
+ */
+class ChannelMessageContainerCache {
+public:
+    ChannelMessageContainerCache()
+        : generation_(-1),
+          type_(NULL),
+          container_(NULL) {
+    }
+
+    /**
+     * @return false if not cached, or cached in an older generation.
+     */
+    template<class T>
+    bool get(int generation, T** container) const {
+        if (generation_ == generation && type_ && *type_ == typeid(T)) {
+            *container = static_cast<T*>(container_);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * the <tt>container</tt> may be NULL, which is cached as well.
+     */
+    template<class T>
+    void set(int generation, T* container) {
+        generation_ = generation;
+        type_ = &typeid(T);
+        container_ = container;
+    }
+
+    void reset() {
+        generation_ = -1;
+        type_ = NULL;
+        container_ = NULL;
+    }
+
+private:
+    int generation_;
+    const std::type_info* type_;
+    void* container_;
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_CHANNELMESSAGECONTAINERCACHE_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -126,6 +126,12 @@ public:
         return boost::any();
     }
 
+protected:
+    // the container belongs to the linked channel, which may go away.
+    virtual bool messageContainerCacheable() const {
+        return false;
+    }
+
 private:
     ChannelWeakPtr channel_;
     ChannelPipeline* pipeline_;
@@ -207,7 +207,7 @@ public:
 
     bool unfoldAndAdd(const ChannelBufferPtr& msg) {
         if (!container_) {
-            ctx_.nextInboundMessageContainer<ChannelBufferContainer>();
+            container_ = ctx_.nextInboundMessageContainer<ChannelBufferContainer>();
         }
 
         if (container_ && msg) {
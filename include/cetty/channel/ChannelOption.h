@@ -74,6 +74,7 @@ public:
     static const ChannelOption CO_REUSE_CHILD;
     static const ChannelOption CO_RESERVED_CHILD_COUNT;
     static const ChannelOption CO_AUTO_READ;
+    static const ChannelOption CO_POOLED_BUFFER;
 
     static const ChannelOption CO_SO_BROADCAST;
     static const ChannelOption CO_SO_KEEPALIVE;
@@ -84,10 +85,17 @@ public:
     static const ChannelOption CO_SO_BACKLOG;
     static const ChannelOption CO_SO_SNDLOWAT;
     static const ChannelOption CO_SO_RCVLOWAT;
+    static const ChannelOption CO_SO_REUSEPORT;
 
     static const ChannelOption CO_SNDHIGHWAT;
     static const ChannelOption CO_RCVHIGHWAT;
 
+    static const ChannelOption CO_WRITE_BATCH_BYTES;
+    static const ChannelOption CO_WRITE_BATCH_OPERATIONS;
+    static const ChannelOption CO_LAZY_READ_BUFFER;
+    static const ChannelOption CO_ADAPTIVE_RECEIVE_BUFFER_SIZE;
+    static const ChannelOption CO_WRITE_BUFFER_LOW_WATER_MARK;
+
     static const ChannelOption CO_IP_TOS;
     static const ChannelOption CO_IP_MULTICAST_ADDR;
     static const ChannelOption CO_IP_MULTICAST_IF;
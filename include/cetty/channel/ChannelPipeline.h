@@ -507,6 +507,14 @@ public:
         return tail_;
     }
 
+    /**
+     * Increased whenever a context is added, removed or replaced, the
+     * message containers cached by the contexts are dropped when changed.
+     */
+    const int& generation() const {
+        return generation_;
+    }
+
     /**
      * Returns the context object of the {@link ChannelHandler} with the
      * specified name in this pipeline.
@@ -532,6 +540,7 @@ public:
 
     ChannelPipeline& fireMessageUpdated();
     ChannelPipeline& fireChannelReadSuspended();
+    ChannelPipeline& fireChannelWritabilityChanged();
 
     ChannelPipeline& fireUserEventTriggered(const boost::any& evt);
     ChannelPipeline& fireExceptionCaught(const ChannelException& cause);
@@ -569,11 +578,7 @@ public:
      */
     template<class T, int MessageT>
     ChannelMessageContainer<T, MessageT>* inboundMessageContainer() {
-        if (head_) {
-            return head_->nextInboundMessageContainer<ChannelMessageContainer<T, MessageT> >(head_);
-        }
-
-        return NULL;
+        return inboundMessageContainer<ChannelMessageContainer<T, MessageT> >();
     }
 
         /**
@@ -586,11 +591,24 @@ public:
      */
     template<class T>
     T* inboundMessageContainer() {
-        if (head_) {
-            return head_->nextInboundMessageContainer<T>(head_);
+        if (!head_) {
+            return NULL;
+        }
+
+        T* container = NULL;
+
+        if (inboundContainer_.get(generation_, &container)) {
+            return container;
+        }
+
+        bool cacheable = true;
+        container = head_->nextInboundMessageContainer<T>(head_, &cacheable);
+
+        if (cacheable) {
+            inboundContainer_.set(generation_, container);
         }
 
-        return NULL;
+        return container;
     }
 
     /**
@@ -603,11 +621,7 @@ public:
      */
     template<class T, int MessageT>
     ChannelMessageContainer<T, MessageT>* outboundMessageContainer() {
-        if (tail_) {
-            return tail_->nextOutboundMessageContainer<ChannelMessageContainer<T, MessageT> >(tail_);
-        }
-
-        return NULL;
+        return outboundMessageContainer<ChannelMessageContainer<T, MessageT> >();
     }
 
     /**
@@ -620,11 +634,24 @@ public:
      */
     template<class T>
     T* outboundMessageContainer() {
-        if (tail_) {
-            return tail_->nextOutboundMessageContainer<T>(tail_);
+        if (!tail_) {
+            return NULL;
+        }
+
+        T* container = NULL;
+
+        if (outboundContainer_.get(generation_, &container)) {
+            return container;
+        }
+
+        bool cacheable = true;
+        container = tail_->nextOutboundMessageContainer<T>(tail_, &cacheable);
+
+        if (cacheable) {
+            outboundContainer_.set(generation_, container);
         }
 
-        return NULL;
+        return container;
     }
 
     template<typename T, int MessageT>
@@ -789,8 +816,12 @@ private:
         return contexts_.find(name) != contexts_.end();
     }
 
+    /**
+     * only drops the cached message containers, the handlers which care
+     * about the changes are told by the {@link ChannelHandlerContext} itself.
+     */
     void firePipelineChanged() {
-
+        ++generation_;
     }
 
 private:
@@ -808,6 +839,10 @@ private:
 
     ChannelHandlerContext* head_;
     ChannelHandlerContext* tail_;
+
+    int generation_;
+    ChannelMessageContainerCache inboundContainer_;
+    ChannelMessageContainerCache outboundContainer_;
 };
 
 inline
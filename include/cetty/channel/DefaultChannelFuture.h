@@ -23,13 +23,9 @@
 
 #include <deque>
 #include <queue>
+#include <cetty/util/Atomic.h>
 #include <cetty/channel/ChannelFuture.h>
 
-namespace boost {
-    class mutex;
-    class condition_variable;
-}
-
 namespace cetty {
 namespace channel {
 
@@ -41,6 +37,13 @@ using namespace ::cetty::util;
  * to create a new {@link ChannelFuture} rather than calling the constructor
  * explicitly.
  *
+ * The state of the future is one atomic word, completing it is one CAS.
+ * The listeners are kept in a small inline array, guarded by a lock bit in
+ * the same state word, which is only contended when adding a listener in
+ * one thread and completing in another at the same time.  The mutex and the
+ * condition variable are only created when {@link #await} is called before
+ * completion.
+ *
  *
  * @author <a href="http://gleamynode.net/">Trustin Lee</a>
  * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
@@ -69,9 +72,9 @@ public:
      *        the {@link Channel} associated with this future
      * @param cancellable
      *        <tt>true</tt> if and only if this future can be canceled
-     * @param threadUnsaft
-     *        <tt>true</tt> if the future only used in the one thread loop
-     *        is mainly internal used.
+     * @param threadUnsafe
+     *        not used any more, all the futures are thread safe and
+     *        lock-free when not waited.
      */
     DefaultChannelFuture(const ChannelPtr& channel,
         bool cancellable,
@@ -109,6 +112,27 @@ public:
     virtual bool cancel();
 
 private:
+    enum {
+        STATE_PENDING          = 0,
+        STATE_COMPLETING       = 1,
+        STATE_SUCCESS          = 2,
+        STATE_FAILED           = 3,
+        STATE_CANCELLED        = 4,
+        STATE_LISTENERS_LOCKED = 8  // pending, and the listeners are changing
+    };
+
+    static const int INLINE_LISTENER_COUNT = 4;
+
+    struct Waiter;
+
+private:
+    bool complete(int state, Exception* cause);
+
+    bool lockListeners();
+    void unlockListeners();
+
+    int completedState() const;
+
     bool await0(int64_t timeoutMillis, bool interruptable);
 
     void checkDeadLock();
@@ -120,8 +144,7 @@ private:
                                 int current,
                                 int total);
 
-    boost::condition_variable& condition();
-    boost::mutex& getMutex() const;
+    Waiter* waiter();
 
 private:
     static Exception CANCELLED;
@@ -165,23 +188,21 @@ private:
 
 private:
     bool cancellable_;
-    bool done_;
 
-    bool threadUnsafe_;
+    Atomic<int> state_;
 
     ChannelWeakPtr channel_;
 
-    PriorityCallback firstListener_;
+    // sorted by the priority, only used before overflowed to the queue.
+    int inlineListenerCount_;
+    PriorityCallback inlineListeners_[INLINE_LISTENER_COUNT];
 
     PriorityCallbackQueue* completedListeners_;
     ProgressedCallbackQueue* progressListeners_;
 
     Exception* cause_;
 
-    mutable boost::mutex* mutex_;
-    boost::condition_variable* cond_;
-
-    int waiters_;
+    Atomic<Waiter*> waiter_;
 };
 
 }
@@ -26,6 +26,8 @@
 #include <cetty/channel/EventLoopPtr.h>
 #include <cetty/channel/EventLoopPoolPtr.h>
 
+#include <cetty/util/Atomic.h>
+#include <cetty/util/CachedClock.h>
 #include <cetty/util/CurrentThread.h>
 #include <cetty/util/ReferenceCounter.h>
 
@@ -34,10 +36,25 @@ namespace channel {
 
 using namespace cetty::util;
 
+/**
+ * Besides running the handlers, every EventLoop keeps some cheap load
+ * statistics, which are updated with atomic operations and can be read in
+ * any thread, by the {@link EventLoopChooser} and the monitoring:
+ * <ul>
+ * <li>{@link #channelCount}, the active channels served by the loop.</li>
+ * <li>{@link #pendingTaskCount}, the posted handlers not run yet.</li>
+ * <li>{@link #busyRatio}, the recent ratio of time running handlers.</li>
+ * </ul>
+ */
 class EventLoop : public cetty::util::ReferenceCounter<EventLoop, int> {
 public:
     typedef boost::function0<void> Handler;
 
+    /**
+     * the window in microseconds of the {@link #busyRatio}.
+     */
+    static const int64_t BUSY_RATIO_WINDOW = 100 * 1000;
+
 public:
     EventLoop(const EventLoopPoolPtr& pool);
 
@@ -63,6 +80,23 @@ public:
      */
     bool inLoopThread() const;
 
+    /**
+     * the cached current UTC time of the loop thread, refreshed lazily once
+     * every loop iteration, see {@link CachedClock}.
+     * Called out of the loop threads, it reads the system clock.
+     */
+    boost::posix_time::ptime now() const;
+
+    /**
+     * the milliseconds since the epoch of {@link #now}.
+     */
+    int64_t nowInMillis() const;
+
+    /**
+     * the microseconds since the epoch of {@link #now}.
+     */
+    int64_t nowInMicros() const;
+
     //virtual void start();
 
     /**
@@ -71,6 +105,12 @@ public:
      */
     virtual void stop();
 
+    /**
+     * test the EventLoop has been stopped, then the handlers posted
+     * will not be run any more.
+     */
+    bool stopped() const;
+
     //virtual void dispatch(const Handler& handler) = 0;
 
     /**
@@ -98,9 +138,58 @@ public:
     virtual TimeoutPtr runEvery(int64_t millisecond,
                                 const Handler& handler) = 0;
 
+    /**
+     * the count of the active channels served by the loop.
+     */
+    int channelCount() const;
+
+    /**
+     * the count of the handlers posted but not run yet.
+     */
+    int pendingTaskCount() const;
+
+    /**
+     * the permillage of the time spent in running the handlers in
+     * the latest {@link #BUSY_RATIO_WINDOW}, 0 if idle for a long time.
+     */
+    int busyRatio() const;
+
+    /**
+     * the total microseconds spent in running the handlers.
+     */
+    int64_t busyTime() const;
+
+    /**
+     * called by the {@link Channel} when it turns active or inactive.
+     */
+    void channelActived();
+    void channelInactived();
+
+protected:
+    void taskPosted();
+    void taskCompleted();
+
+    /**
+     * called in the loop thread after running handlers,
+     * <tt>busyMicros</tt> is the time running them.
+     */
+    void addBusyTime(int64_t nowMicros, int64_t busyMicros);
+
 private:
     ThreadId threadId_;
     EventLoopPoolPtr pool_;
+
+    Atomic<int> stopped_;
+    Atomic<int> channelCount_;
+    Atomic<int> pendingTaskCount_;
+
+    Atomic<int> busyRatio_;
+    Atomic<int64_t> busyTime_;
+    Atomic<int64_t> busyRatioUpdated_;
+
+    // only accessed in the loop thread.
+    int64_t windowStart_;
+    int64_t windowBusyTime_;
 };
 
 inline
@@ -118,11 +207,66 @@ bool EventLoop::inLoopThread() const {
     return threadId_ == CurrentThread::id();
 }
 
+inline
+boost::posix_time::ptime EventLoop::now() const {
+    return CachedClock::now();
+}
+
+inline
+int64_t EventLoop::nowInMillis() const {
+    return CachedClock::nowInMillis();
+}
+
+inline
+int64_t EventLoop::nowInMicros() const {
+    return CachedClock::nowInMicros();
+}
+
 inline
 const EventLoopPoolPtr& EventLoop::eventLoopPool() const {
     return pool_;
 }
 
+inline
+bool EventLoop::stopped() const {
+    return stopped_.get() != 0;
+}
+
+inline
+int EventLoop::channelCount() const {
+    return channelCount_.get();
+}
+
+inline
+int EventLoop::pendingTaskCount() const {
+    return pendingTaskCount_.get();
+}
+
+inline
+int64_t EventLoop::busyTime() const {
+    return busyTime_.get();
+}
+
+inline
+void EventLoop::channelActived() {
+    channelCount_.incrementAndGet();
+}
+
+inline
+void EventLoop::channelInactived() {
+    channelCount_.decrementAndGet();
+}
+
+inline
+void EventLoop::taskPosted() {
+    pendingTaskCount_.incrementAndGet();
+}
+
+inline
+void EventLoop::taskCompleted() {
+    pendingTaskCount_.decrementAndGet();
+}
+
 }
 }
 
@@ -0,0 +1,128 @@
+#if !defined(CETTY_CHANNEL_EVENTLOOPCHOOSER_H)
+#define CETTY_CHANNEL_EVENTLOOPCHOOSER_H
+
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <cetty/util/Atomic.h>
+
+namespace cetty {
+namespace channel {
+
+class EventLoop;
+class EventLoopPool;
+
+/**
+ * Chooses the {@link EventLoop} in an {@link EventLoopPool} for the next
+ * channel, see {@link EventLoopPool#nextLoop}.
+ *
+ * The load aware choosers use the load statistics of the {@link EventLoop},
+ * which are read without locking, so the choice is a good guess rather than
+ * the exact least loaded one.  The choosers may be called in many threads at
+ * the same time.
+ */
+class EventLoopChooser : private boost::noncopyable {
+public:
+    virtual ~EventLoopChooser() {}
+
+    /**
+     * @return the index of the chosen {@link EventLoop} in the pool.
+     */
+    virtual int next(const EventLoopPool& pool) = 0;
+
+    /**
+     * Creates the chooser by the name, "roundRobin", "leastChannels",
+     * "leastPendingTasks" or "powerOfTwoChoices", NULL if unknown.
+     */
+    static EventLoopChooser* create(const std::string& name);
+};
+
+typedef boost::shared_ptr<EventLoopChooser> EventLoopChooserPtr;
+
+/**
+ * Chooses the loops one by one, the default one.
+ */
+class RoundRobinEventLoopChooser : public EventLoopChooser {
+public:
+    RoundRobinEventLoopChooser() : index_(0) {}
+    virtual ~RoundRobinEventLoopChooser() {}
+
+    virtual int next(const EventLoopPool& pool);
+
+private:
+    cetty::util::Atomic<int> index_;
+};
+
+/**
+ * Chooses the loop serving the least active channels, the ties are broken
+ * by the pending tasks.  Suits the long connections, e.g. streaming.
+ */
+class LeastChannelsEventLoopChooser : public EventLoopChooser {
+public:
+    virtual ~LeastChannelsEventLoopChooser() {}
+
+    virtual int next(const EventLoopPool& pool);
+};
+
+/**
+ * Chooses the loop with the least posted handlers waiting to run.
+ */
+class LeastPendingTasksEventLoopChooser : public EventLoopChooser {
+public:
+    virtual ~LeastPendingTasksEventLoopChooser() {}
+
+    virtual int next(const EventLoopPool& pool);
+};
+
+/**
+ * Samples two loops randomly and chooses the less loaded one, which is
+ * O(1) and avoids all the channels rushing to the same least loaded loop
+ * whose statistics have not been updated yet.
+ *
+ * The loop noticeably less busy (in {@link EventLoop#busyRatio}) is the
+ * less loaded, then the one with less channels, then the one with less
+ * pending tasks.
+ */
+class PowerOfTwoChoicesEventLoopChooser : public EventLoopChooser {
+public:
+    /**
+     * the busy ratios (in permillage) closer than it are treated as same.
+     */
+    static const int BUSY_RATIO_TOLERANCE = 100;
+
+public:
+    PowerOfTwoChoicesEventLoopChooser() : seed_(0) {}
+    virtual ~PowerOfTwoChoicesEventLoopChooser() {}
+
+    virtual int next(const EventLoopPool& pool);
+
+private:
+    cetty::util::Atomic<int> seed_;
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EVENTLOOPCHOOSER_H)
+
+// Local Variables:
+// mode: c++
+// End:
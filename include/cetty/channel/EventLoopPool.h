@@ -23,7 +23,9 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 
 #include <cetty/channel/EventLoopPtr.h>
+#include <cetty/channel/EventLoopChooser.h>
 #include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/EventLoopThreadPlacement.h>
 #include <cetty/util/CurrentThread.h>
 #include <cetty/util/ReferenceCounter.h>
 
@@ -67,6 +69,13 @@ public:
 
 public:
     EventLoopPool(int ioThreadCount);
+
+    /**
+     * @param placement how the threads of the loops are named, pinned to
+     *        the cpus and placed on the numa nodes.
+     */
+    EventLoopPool(int ioThreadCount, const EventLoopThreadPlacement& placement);
+
     virtual ~EventLoopPool();
 
     bool empty() const;
@@ -78,6 +87,29 @@ public:
     Iterator begin();
     Iterator end();
 
+    /**
+     * the EventLoop at <tt>index</tt>, 0 <= index < {@link #size}.
+     */
+    const EventLoopPtr& loopAt(int index) const;
+
+    /**
+     * the strategy of {@link #nextLoop}, round robin by default.
+     */
+    EventLoopChooserPtr chooser() const;
+
+    /**
+     * Set the strategy of {@link #nextLoop}, e.g. the
+     * {@link PowerOfTwoChoicesEventLoopChooser} to balance the load.
+     * It may be replaced while the other threads are choosing the loops.
+     */
+    void setChooser(const EventLoopChooserPtr& chooser);
+
+    /**
+     * the placement of the loop threads, given when constructed, because the
+     * threads start running in the constructor of the pools.
+     */
+    const EventLoopThreadPlacement& threadPlacement() const;
+
     /**
      *
      */
@@ -99,6 +131,11 @@ public:
     virtual void waitingForStop() = 0;
 
 protected:
+    /**
+     * the index of the next loop chosen by the {@link #chooser}.
+     */
+    int nextLoopIndex();
+
     EventLoopHolder* loopHolderAt(int index);
     void appendLoopHolder(EventLoopHolder* holder);
 
@@ -106,6 +143,15 @@ protected:
 
     void insertLoop(const ThreadId& id, const EventLoopPtr& loop);
 
+    /**
+     * place the current thread, which is created by the pool to run the loop
+     * at <tt>index</tt>, with the {@link #threadPlacement}.
+     */
+    void placeLoopThread(int index);
+
+private:
+    void init();
+
 private:
     static EventLoops allEventLoops_;
 
@@ -120,6 +166,11 @@ private:
     ThreadId mainThreadId_;
 
     EventLoopHolders eventLoops_;
+
+    // only accessed with boost::atomic_load and boost::atomic_store.
+    EventLoopChooserPtr chooser_;
+
+    EventLoopThreadPlacement placement_;
 };
 
 inline
@@ -173,6 +224,26 @@ EventLoopPool::Iterator EventLoopPool::end() {
     return Iterator(eventLoops_.end());
 }
 
+inline
+const EventLoopPtr& EventLoopPool::loopAt(int index) const {
+    return eventLoops_.at(index).eventLoop();
+}
+
+inline
+EventLoopChooserPtr EventLoopPool::chooser() const {
+    return boost::atomic_load(&chooser_);
+}
+
+inline
+const EventLoopThreadPlacement& EventLoopPool::threadPlacement() const {
+    return placement_;
+}
+
+inline
+int EventLoopPool::nextLoopIndex() {
+    return eventLoopCnt_ > 1 ? boost::atomic_load(&chooser_)->next(*this) : 0;
+}
+
 inline
 EventLoopPool::EventLoopHolder* EventLoopPool::loopHolderAt(int index) {
     return &eventLoops_.at(index);
@@ -0,0 +1,155 @@
+#if !defined(CETTY_CHANNEL_EVENTLOOPTHREADPLACEMENT_H)
+#define CETTY_CHANNEL_EVENTLOOPTHREADPLACEMENT_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string>
+#include <vector>
+
+namespace cetty {
+namespace channel {
+
+/**
+ * Where the threads of an {@link EventLoopPool} run: the name, the cpu and
+ * the memory node of every loop thread.
+ *
+ * The loop at <tt>index</tt> of the pool is named <tt>namePrefix</tt>
+ * followed by the index, and pinned to the cpu
+ * <tt>cpus[index % cpus.size()]</tt>.  When <tt>numaLocal</tt> is set, the
+ * thread prefers the memory of the numa node it is running on, and the
+ * {@link PooledChannelBufferFactory} arena of the thread is created there
+ * before the loop runs, so the buffers of the channels served by the loop
+ * stay on the local node.
+ *
+ * @code
+ * std::vector<int> cpus;
+ * EventLoopThreadPlacement::parseCpuList("0-3,8-11", &cpus);
+ *
+ * new AsioServicePool(8, false, EventLoopThreadPlacement("io-", cpus, true));
+ * @endcode
+ *
+ * Only the threads created by the pool are placed, the main thread of a
+ * pool in the main thread mode is left as it is.  The placement is only
+ * supported on Linux, and ignored with a warning on the other platforms.
+ */
+class EventLoopThreadPlacement {
+public:
+    /**
+     * the max length of a thread name on Linux, without the trailing zero.
+     */
+    static const int MAX_THREAD_NAME_LENGTH = 15;
+
+public:
+    /**
+     * no placement, the threads are left to the system.
+     */
+    EventLoopThreadPlacement();
+
+    EventLoopThreadPlacement(const std::string& namePrefix,
+                             const std::vector<int>& cpus,
+                             bool numaLocal);
+
+    const std::string& namePrefix() const;
+    void setNamePrefix(const std::string& namePrefix);
+
+    const std::vector<int>& cpus() const;
+    void setCpus(const std::vector<int>& cpus);
+
+    bool isNumaLocal() const;
+    void setNumaLocal(bool numaLocal);
+
+    /**
+     * whether nothing to place.
+     */
+    bool empty() const;
+
+    /**
+     * the name of the thread of the loop at <tt>index</tt>, the prefix is
+     * cut to keep the index when longer than {@link #MAX_THREAD_NAME_LENGTH}.
+     */
+    std::string threadName(int index) const;
+
+    /**
+     * the cpu of the loop at <tt>index</tt>, -1 if not pinned.
+     */
+    int cpu(int index) const;
+
+    /**
+     * place the current thread, which runs the loop at <tt>index</tt>.
+     *
+     * @return false if any of the placement failed, the thread still runs
+     *         where the system puts it.
+     */
+    bool applyToCurrentThread(int index) const;
+
+    /**
+     * Parses a cpu list like <tt>"0-3,8,10-11"</tt>, in the format of
+     * <tt>taskset -c</tt> and the <tt>/sys/devices/system/cpu</tt> files.
+     *
+     * @return false if the list is malformed, the <tt>cpus</tt> is cleared.
+     */
+    static bool parseCpuList(const std::string& list, std::vector<int>* cpus);
+
+private:
+    bool numaLocal_;
+    std::string namePrefix_;
+    std::vector<int> cpus_;
+};
+
+inline
+const std::string& EventLoopThreadPlacement::namePrefix() const {
+    return namePrefix_;
+}
+
+inline
+void EventLoopThreadPlacement::setNamePrefix(const std::string& namePrefix) {
+    namePrefix_ = namePrefix;
+}
+
+inline
+const std::vector<int>& EventLoopThreadPlacement::cpus() const {
+    return cpus_;
+}
+
+inline
+void EventLoopThreadPlacement::setCpus(const std::vector<int>& cpus) {
+    cpus_ = cpus;
+}
+
+inline
+bool EventLoopThreadPlacement::isNumaLocal() const {
+    return numaLocal_;
+}
+
+inline
+void EventLoopThreadPlacement::setNumaLocal(bool numaLocal) {
+    numaLocal_ = numaLocal;
+}
+
+inline
+bool EventLoopThreadPlacement::empty() const {
+    return namePrefix_.empty() && cpus_.empty() && !numaLocal_;
+}
+
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EVENTLOOPTHREADPLACEMENT_H)
+
+// Local Variables:
+// mode: c++
+// End:
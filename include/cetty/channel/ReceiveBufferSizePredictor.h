@@ -0,0 +1,123 @@
+#if !defined(CETTY_CHANNEL_RECEIVEBUFFERSIZEPREDICTOR_H)
+#define CETTY_CHANNEL_RECEIVEBUFFERSIZEPREDICTOR_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/noncopyable.hpp>
+
+namespace cetty {
+namespace channel {
+
+/**
+ * Predicts the number of readable bytes in the socket receive buffer.
+ * <p>
+ * It calculates the close-to-optimal capacity of the {@link ChannelBuffer}
+ * for the next read operation depending on the actual number of read bytes
+ * in the previous read operation.  More accurate the prediction is, more
+ * effective the memory utilization will be.
+ *
+ * @author <a href="http://gleamynode.net/">Trustin Lee</a>
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+class ReceiveBufferSizePredictor : private boost::noncopyable {
+public:
+    virtual ~ReceiveBufferSizePredictor() {}
+
+    /**
+     * Predicts the capacity of the {@link ChannelBuffer} for the next
+     * read operation depending on the actual number of read bytes in the
+     * previous read operation.
+     *
+     * @return the expected number of readable bytes this time
+     */
+    virtual int nextReceiveBufferSize() const = 0;
+
+    /**
+     * Updates this predictor by specifying the actual number of read bytes
+     * in the previous read operation.
+     *
+     * @param previousReceiveBufferSize
+     *        the actual number of read bytes in the previous read operation
+     */
+    virtual void previousReceiveBufferSize(int previousReceiveBufferSize) = 0;
+};
+
+/**
+ * The {@link ReceiveBufferSizePredictor} that automatically increases and
+ * decreases the predicted buffer size on feed back.
+ * <p>
+ * It gradually increases the expected number of readable bytes if the previous
+ * read fully filled the allocated buffer.  It gradually decreases the expected
+ * number of readable bytes if the read operation was not able to fill a certain
+ * amount of the allocated buffer two times consecutively.  Otherwise, it keeps
+ * returning the same prediction.
+ *
+ * @author <a href="http://gleamynode.net/">Trustin Lee</a>
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+class AdaptiveReceiveBufferSizePredictor : public ReceiveBufferSizePredictor {
+public:
+    static const int DEFAULT_MINIMUM = 64;
+    static const int DEFAULT_INITIAL = 1024;
+    static const int DEFAULT_MAXIMUM = 256 * 1024;
+
+public:
+    /**
+     * Creates a new predictor with the default parameters.  With the default
+     * parameters, the expected buffer size starts from <tt>1024</tt>, does not
+     * go down below <tt>64</tt>, and does not go up above <tt>262144</tt>.
+     */
+    AdaptiveReceiveBufferSizePredictor();
+
+    /**
+     * Creates a new predictor with the specified parameters.
+     *
+     * @param minimum  the inclusive lower bound of the expected buffer size
+     * @param initial  the initial buffer size when no feed back was received
+     * @param maximum  the inclusive upper bound of the expected buffer size
+     */
+    AdaptiveReceiveBufferSizePredictor(int minimum, int initial, int maximum);
+
+    virtual ~AdaptiveReceiveBufferSizePredictor() {}
+
+    virtual int nextReceiveBufferSize() const;
+    virtual void previousReceiveBufferSize(int previousReceiveBufferSize);
+
+private:
+    void init(int minimum, int initial, int maximum);
+
+private:
+    int minIndex_;
+    int maxIndex_;
+    int index_;
+    int nextReceiveBufferSize_;
+    bool decreaseNow_;
+};
+
+inline
+int AdaptiveReceiveBufferSizePredictor::nextReceiveBufferSize() const {
+    return nextReceiveBufferSize_;
+}
+
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_RECEIVEBUFFERSIZEPREDICTOR_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,218 @@
+#if !defined(CETTY_CHANNEL_ASIO_ASIOHASHEDWHEELTIMER_H)
+#define CETTY_CHANNEL_ASIO_ASIOHASHEDWHEELTIMER_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/date_time/posix_time/ptime.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/util/Atomic.h>
+#include <cetty/channel/Timeout.h>
+
+namespace cetty {
+namespace channel {
+namespace asio {
+
+class AsioService;
+class AsioHashedWheelTimer;
+
+/**
+ * The {@link Timeout} scheduled in an {@link AsioHashedWheelTimer}.
+ */
+class AsioHashedWheelTimeout : public cetty::channel::Timeout {
+public:
+    typedef boost::function0<void> Handler;
+
+    enum {
+        TIMER_UNINITIALIZED  = 0,
+        TIMER_CANCELLED      = 1,
+        TIMER_EXPIRED        = 2,
+        TIMER_ACTIVE         = 4,
+    };
+
+public:
+    AsioHashedWheelTimeout(AsioHashedWheelTimer& timer,
+                           int64_t deadline,
+                           int64_t period,
+                           const Handler& handler);
+
+    virtual ~AsioHashedWheelTimeout();
+
+    virtual bool isExpired() const;
+    virtual bool isCancelled() const;
+    virtual bool isActived() const;
+
+    virtual void cancel();
+
+    virtual boost::int64_t expiresFromNow() const;
+
+    /**
+     * the period in milliseconds, 0 if not repeated.
+     */
+    int64_t period() const;
+
+private:
+    friend class AsioHashedWheelTimer;
+
+    // written in the loop thread, except the cancelling in any thread.
+    cetty::util::Atomic<int> state_;
+    int bucket_;
+    int64_t remainingRounds_;
+
+    // milliseconds since the start time of the timer.
+    int64_t deadline_;
+    int64_t period_;
+
+    Handler handler_;
+    AsioHashedWheelTimer& timer_;
+
+    AsioHashedWheelTimeout* prev_;
+    AsioHashedWheelTimeout* next_;
+};
+
+typedef boost::intrusive_ptr<AsioHashedWheelTimeout> AsioHashedWheelTimeoutPtr;
+
+/**
+ * A hashed timing wheel of an {@link AsioService}, which backs
+ * {@link EventLoop#runAt}, {@link EventLoop#runAfter} and
+ * {@link EventLoop#runEvery} instead of one <tt>deadline_timer</tt> for
+ * every {@link Timeout}.
+ *
+ * The timeouts are hashed into <tt>ticksPerWheel</tt> buckets by their
+ * deadline, every bucket is an intrusive double linked list, so scheduling
+ * and cancelling are both O(1).  One <tt>deadline_timer</tt> ticks the wheel
+ * every <tt>tickDuration</tt> milliseconds, and only when there are
+ * timeouts pending.
+ *
+ * The timeouts expire in the ticks after their deadline, so the precision
+ * is the <tt>tickDuration</tt>, which suits the connection, idle and
+ * request timeouts, not the precise ones.
+ *
+ * All the scheduling and expiring happen in the thread of the
+ * {@link AsioService}, scheduling or cancelling in other threads will be
+ * posted to the thread.
+ */
+class AsioHashedWheelTimer : private boost::noncopyable {
+public:
+    typedef boost::function0<void> Handler;
+
+    static const int DEFAULT_TICK_DURATION = 10;
+    static const int DEFAULT_TICKS_PER_WHEEL = 512;
+
+public:
+    AsioHashedWheelTimer(AsioService& service);
+
+    AsioHashedWheelTimer(AsioService& service,
+                         int tickDuration,
+                         int ticksPerWheel);
+
+    ~AsioHashedWheelTimer();
+
+    /**
+     * schedules the handler to run after <tt>delay</tt> milliseconds,
+     * and every <tt>period</tt> milliseconds after that if it is positive.
+     */
+    TimeoutPtr newTimeout(int64_t delay, int64_t period, const Handler& handler);
+
+    /**
+     * schedules the handler to run at <tt>timestamp</tt>, in UTC as
+     * {@link CachedClock#now()}, which also drives the ticks of the wheel.
+     */
+    TimeoutPtr newTimeout(const boost::posix_time::ptime& timestamp,
+                          const Handler& handler);
+
+    /**
+     * the duration in milliseconds between the ticks.
+     */
+    int tickDuration() const;
+
+    int ticksPerWheel() const;
+
+    /**
+     * the count of the timeouts waiting in the wheel.
+     */
+    int pendingTimeouts() const;
+
+private:
+    friend class AsioHashedWheelTimeout;
+
+    int64_t now() const;
+
+    TimeoutPtr newTimeoutAt(int64_t deadline,
+                            int64_t period,
+                            const Handler& handler);
+
+    void schedule(const AsioHashedWheelTimeoutPtr& timeout);
+    void cancel(const AsioHashedWheelTimeoutPtr& timeout);
+
+    void link(AsioHashedWheelTimeout* timeout);
+    void unlink(AsioHashedWheelTimeout* timeout);
+
+    void startTicking();
+    void tick(const boost::system::error_code& error);
+    void expireBucket(int bucket,
+                      std::vector<AsioHashedWheelTimeoutPtr>* expired);
+
+private:
+    AsioService& service_;
+
+    int tickDuration_;
+    int mask_;
+    int pendingTimeouts_;
+
+    bool ticking_;
+    int64_t lastTick_;
+
+    boost::posix_time::ptime startTime_;
+    boost::asio::deadline_timer tickTimer_;
+
+    std::vector<AsioHashedWheelTimeout*> wheel_;
+};
+
+inline
+int64_t AsioHashedWheelTimeout::period() const {
+    return period_;
+}
+
+inline
+int AsioHashedWheelTimer::tickDuration() const {
+    return tickDuration_;
+}
+
+inline
+int AsioHashedWheelTimer::ticksPerWheel() const {
+    return mask_ + 1;
+}
+
+inline
+int AsioHashedWheelTimer::pendingTimeouts() const {
+    return pendingTimeouts_;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_ASIO_ASIOHASHEDWHEELTIMER_H)
+
+// Local Variables:
+// mode: c++
+// End:
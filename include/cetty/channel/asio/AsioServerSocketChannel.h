@@ -22,8 +22,12 @@
  */
 
 #include <deque>
+#include <vector>
+#include <boost/function.hpp>
 #include <boost/asio.hpp>
 
+#include <cetty/util/Atomic.h>
+
 #include <cetty/channel/InetAddress.h>
 #include <cetty/channel/EventLoopPoolPtr.h>
 
@@ -41,8 +45,22 @@ typedef boost::shared_ptr<AsioSocketChannel> AsioSocketChannelPtr;
 
 using namespace cetty::channel;
 
-// only response to bind port, open and close.
+/**
+ * only response to bind port, open and close.
+ *
+ * By default, one acceptor accepts in the parent event loop, and the
+ * accepted channels are handed off to the child event loops.  When
+ * {@link ChannelOption#CO_SO_REUSEPORT} is set, every child event loop
+ * opens its own <tt>SO_REUSEPORT</tt> acceptor on the same address, the
+ * kernel balances the connections among them, and every connection is
+ * accepted and served in the same event loop without handing off.  In this
+ * mode, the accepted channels do not pass through the pipeline of the
+ * server channel, they are initialized by the {@link ChildInitializer}.
+ */
 class AsioServerSocketChannel : public cetty::channel::Channel {
+public:
+    typedef boost::function1<void, const ChannelPtr&> ChildInitializer;
+
 public:
     AsioServerSocketChannel(const EventLoopPtr& eventLoop,
                             const EventLoopPoolPtr& childEventLoopPool);
@@ -65,6 +83,25 @@ public:
         Channel::registerTo(context);
     }
 
+    /**
+     * Set the initializer of the channels accepted in the
+     * <tt>SO_REUSEPORT</tt> mode, which must be set before binding.
+     */
+    void setChildInitializer(const ChildInitializer& initializer);
+
+    /**
+     * the count of the acceptors, more than one only in the
+     * <tt>SO_REUSEPORT</tt> mode.
+     */
+    int acceptorCount() const;
+
+    /**
+     * the count of the connections accepted by the acceptor at
+     * <tt>index</tt>, the acceptor at <tt>index</tt> runs in the
+     * <tt>index</tt>th child event loop in the <tt>SO_REUSEPORT</tt> mode.
+     */
+    int64_t acceptedCount(int index) const;
+
 protected:
     virtual bool doBind(const InetAddress& localAddress);
     virtual bool doDisconnect();
@@ -79,10 +116,51 @@ private:
 
     AsioSocketChannelPtr createChild();
     void handleChildClosed(const ChannelFuture& future);
+    void removeChild(int childId);
 
 private:
     typedef std::map<int, AsioSocketChannelPtr> ChildChannels;
     typedef std::deque<AsioSocketChannelPtr> ReusableChildChannels;
+    typedef std::map<const EventLoop*, ReusableChildChannels> LoopReusableChildChannels;
+
+    // the acceptor and its children in one child event loop,
+    // only accessed in that event loop.
+    struct ChildAcceptor : private boost::noncopyable {
+        int index;
+        int lastChildId;
+
+        AsioServicePtr ioService;
+        boost::asio::ip::tcp::acceptor acceptor;
+        AsioHandlerAllocator<int> acceptAllocator;
+
+        ChildChannels childChannels;
+        ReusableChildChannels reusableChildChannels;
+
+        cetty::util::Atomic<int64_t> acceptedCount;
+
+        ChildAcceptor(int index, const AsioServicePtr& ioService);
+    };
+
+    typedef boost::shared_ptr<ChildAcceptor> ChildAcceptorPtr;
+    typedef std::vector<ChildAcceptorPtr> ChildAcceptors;
+
+private:
+    bool bindChildAcceptors(const boost::asio::ip::tcp::endpoint& ep);
+    bool bindChildAcceptor(const ChildAcceptorPtr& acceptor,
+                           const boost::asio::ip::tcp::endpoint& ep);
+
+    void beginAcceptInLoop(const ChildAcceptorPtr& acceptor);
+    void acceptInLoop(const ChildAcceptorPtr& acceptor);
+    void handleAcceptInLoop(const boost::system::error_code& error,
+                            const AsioSocketChannelPtr& channel,
+                            const ChildAcceptorPtr& acceptor);
+
+    AsioSocketChannelPtr createChildInLoop(const ChildAcceptorPtr& acceptor);
+    void handleChildClosedInLoop(const ChannelFuture& future,
+                                 const ChildAcceptorPtr& acceptor);
+    void removeChildInLoop(int childId, const ChildAcceptorPtr& acceptor);
+
+    void closeChildAcceptor(const ChildAcceptorPtr& acceptor);
 
 private:
     bool initialized_;
@@ -98,7 +176,12 @@ private:
     AsioServicePoolPtr childServicePool_;
     ChildChannels childChannels_;
 
-    ReusableChildChannels reusableChildChannels_;
+    LoopReusableChildChannels reusableChildChannels_;
+
+    cetty::util::Atomic<int64_t> acceptedCount_;
+
+    ChildInitializer childInitializer_;
+    ChildAcceptors childAcceptors_;
 };
 
 }
@@ -59,6 +59,13 @@ public:
     const boost::optional<int>& reservedChildCount() const;
     void setReservedChildCount(int count);
 
+    /**
+     * open one <tt>SO_REUSEPORT</tt> acceptor in every child event loop,
+     * and the kernel balances the incoming connections among them.
+     */
+    const boost::optional<bool>& isReusePort() const;
+    void setReusePort(bool reusePort);
+
 private:
     template<typename Option, typename Value>
     bool applyOptionToAcceptor(const ChannelOption& key, Value value) {
@@ -106,6 +113,8 @@ private:
 
     mutable boost::optional<bool> reuseChild_;
     mutable boost::optional<int>  reservedChildCount_;
+
+    mutable boost::optional<bool> reusePort_;
 };
 
 inline
@@ -123,6 +132,11 @@ const boost::optional<int>& AsioServerSocketChannelConfig::reservedChildCount()
     return reservedChildCount_;
 }
 
+inline
+const boost::optional<bool>& AsioServerSocketChannelConfig::isReusePort() const {
+    return reusePort_;
+}
+
 }
 }
 }
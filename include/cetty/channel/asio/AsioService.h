@@ -17,8 +17,10 @@
  * under the License.
  */
 
+#include <vector>
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/placeholders.hpp>
 
@@ -27,21 +29,67 @@
 #include <cetty/channel/asio/AsioServicePtr.h>
 #include <cetty/channel/asio/AsioServicePoolPtr.h>
 #include <cetty/channel/asio/AsioDeadlineTimeout.h>
+#include <cetty/channel/asio/AsioHashedWheelTimer.h>
 
 namespace cetty {
 namespace channel {
 namespace asio {
 
 /**
+ * The {@link EventLoop} of an <tt>io_service</tt>.
  *
- *
+ * The timeouts are backed by one <tt>deadline_timer</tt> for every
+ * {@link Timeout} by default, or by an {@link AsioHashedWheelTimer} if
+ * <tt>timerWheel</tt> is set, which is cheaper when there are lots of
+ * timeouts (e.g. idle or request timeouts of every connection).
  */
 class AsioService : public cetty::channel::EventLoop {
+public:
+    /**
+     * Adds the time from its construction to its destruction, in the loop
+     * thread, to the {@link EventLoop#busyTime()}.  The handlers of the
+     * timers, the posted handlers and the socket operations are measured
+     * with it, so the loop only blocks in <tt>run_one</tt>.
+     */
+    class BusyTime : private boost::noncopyable {
+    public:
+        BusyTime(AsioService& service);
+        ~BusyTime();
+
+    private:
+        AsioService& service_;
+        int64_t start_;
+    };
+
+    /**
+     * Clears the running batch of the posted handlers when it is done, even
+     * if a handler throws, then the handlers not run yet are put back before
+     * the ones posted meanwhile.
+     */
+    class RunningHandlersGuard : private boost::noncopyable {
+    public:
+        RunningHandlersGuard(AsioService& service);
+        ~RunningHandlersGuard();
+
+        // the index of the next handler to run.
+        std::size_t next;
+
+    private:
+        AsioService& service_;
+    };
+
 public:
     AsioService(const EventLoopPoolPtr& pool);
 
+    AsioService(const EventLoopPoolPtr& pool, bool timerWheel);
+
     boost::asio::io_service& service();
 
+    /**
+     * the timing wheel, NULL if not using the timing wheel.
+     */
+    AsioHashedWheelTimer* timerWheel();
+
     virtual void stop();
 
     virtual void post(const Handler& handler);
@@ -56,6 +104,10 @@ public:
                                 const Handler& handler);
 
 private:
+    friend class AsioServicePool;
+
+    void runPostedHandlers();
+
     void timerExpiresCallback(const boost::system::error_code& code,
                               const Handler& handler,
                               const AsioDeadlineTimeoutPtr& timeout);
@@ -69,6 +121,14 @@ private:
     int timerId_;
     boost::asio::io_service ioService_;
     std::list<AsioDeadlineTimeoutPtr> timers_;
+
+    boost::scoped_ptr<AsioHashedWheelTimer> timerWheel_;
+
+    // the handlers posted are run in batches by one io_service handler,
+    // the vectors keep their capacity between the batches.
+    boost::mutex postedMutex_;
+    std::vector<Handler> postedHandlers_;
+    std::vector<Handler> runningHandlers_;
 };
 
 inline
@@ -76,6 +136,11 @@ boost::asio::io_service& AsioService::service() {
     return ioService_;
 }
 
+inline
+AsioHashedWheelTimer* AsioService::timerWheel() {
+    return timerWheel_.get();
+}
+
 }
 }
 }
@@ -49,6 +49,20 @@ public:
      */
     AsioServicePool(int threadCnt);
 
+    /**
+     * @param timerWheel the event loops run the timeouts in a hashed
+     *        timing wheel, see {@link AsioHashedWheelTimer}.
+     */
+    AsioServicePool(int threadCnt, bool timerWheel);
+
+    /**
+     * @param placement the names, cpus and numa nodes of the threads, see
+     *        {@link EventLoopThreadPlacement}.
+     */
+    AsioServicePool(int threadCnt,
+                    bool timerWheel,
+                    const EventLoopThreadPlacement& placement);
+
     virtual ~AsioServicePool() {}
 
     /**
@@ -78,7 +92,9 @@ private:
     AsioServicePool(const AsioServicePool&);
     AsioServicePool& operator=(const AsioServicePool&);
 
+    void init(bool timerWheel);
     int runIOservice(AsioServiceHolder* holder);
+    int runIOserviceInThread(AsioServiceHolder* holder, int index);
     AsioServiceHolder* nextServiceHolder();
 
 private:
@@ -86,9 +102,6 @@ private:
     typedef boost::shared_ptr<boost::asio::io_service::work> WorkPtr;
 
 private:
-    // The next io_service to use for a connection.
-    int nextServiceIndex_;
-
     boost::mutex mutext_;
 };
 
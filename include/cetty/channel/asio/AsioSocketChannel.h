@@ -21,12 +21,14 @@
  * Distributed under under the Apache License, version 2.0 (the "License").
  */
 
+#include <vector>
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/detail/atomic_count.hpp>
 
+#include <cetty/util/Atomic.h>
 #include <cetty/channel/Channel.h>
 #include <cetty/channel/TimeoutPtr.h>
 #include <cetty/channel/InetAddress.h>
@@ -85,6 +87,37 @@ public:
 
     void registerTo(Context& context);
 
+    /**
+     * bytes of the multi-block buffers (e.g. {@link CompositeChannelBuffer})
+     * written to the socket in place with a gathering write, which would
+     * have been copied into one contiguous buffer before.
+     */
+    int64_t gatheringWrittenBytes() const;
+
+    /**
+     * bytes which still have been compacted before writing, because the
+     * buffer has too many memory blocks for one gathering write.
+     */
+    int64_t compactedWrittenBytes() const;
+
+    /**
+     * Returns false when the bytes waiting to be written exceeded the
+     * {@link AsioSocketChannelConfig#writeBufferHighWaterMark() high water mark},
+     * till they drop below the
+     * {@link AsioSocketChannelConfig#writeBufferLowWaterMark() low water mark}.
+     */
+    virtual bool isWritable() const;
+
+    /**
+     * the bytes waiting in the write queue.
+     */
+    int writeBufferSize() const;
+
+    /**
+     * the times the channel turned not writable.
+     */
+    int highWaterMarkCount() const;
+
 private:
     // template methods
     virtual bool doBind(const InetAddress& localAddress);
@@ -110,6 +143,8 @@ private:
     void handleWrite(const boost::system::error_code& error,
                      size_t bytes_transferred);
 
+    void handleReadable(const boost::system::error_code& error);
+
     void handleConnect(const boost::system::error_code& error,
                        boost::asio::ip::tcp::resolver::iterator endpointIterator,
                        const ChannelFuturePtr& cf);
@@ -120,9 +155,22 @@ private:
 
     void handleConnectTimeout(const ChannelFuturePtr& future);
 
+    void doRead();
     void beginRead();
     void beginWrite();
 
+    // wait for readable without holding a read buffer,
+    // when the lazy read buffer mode is on.
+    void beginNullBufferRead();
+    void releaseIdleReadBuffer();
+    char* prepareReadBuffer(int* size);
+    char* prepareAdaptiveReadBuffer(int nextSize, int* size);
+    ChannelBufferPtr newReadBuffer(int size);
+
+    // coalesce the queued write operations into one gathering write,
+    // return false if there is nothing to coalesce.
+    bool beginBatchWrite();
+
     void connectFailed(const ChannelFuturePtr& connectFuture,
                        const ChannelException& e);
 
@@ -137,8 +185,14 @@ private:
     bool isWriting_;
     bool isConnecting_;
     bool initialized_;
+    bool readPending_;
+    // written in the loop thread, read by isWritable() in any thread.
+    cetty::util::Atomic<int> writable_;
     int  highWaterMarkCounter_;
 
+    // the count of write operations in the outstanding async_write.
+    int  writingOperations_;
+
     AsioServicePtr  ioService_;
     boost::asio::ip::tcp::socket tcpSocket_;
     boost::asio::ip::tcp::resolver resolver_;
@@ -146,6 +200,7 @@ private:
     ChannelBufferPtr readBuffer_;
     ChannelBufferContainer* writeBufferContainer_;
     boost::scoped_ptr<AsioWriteOperationQueue> writeQueue_;
+    std::vector<boost::asio::mutable_buffer> batchBuffers_;
 
     AsioSocketChannelConfig socketConfig_;
 
@@ -165,6 +220,16 @@ const AsioServicePtr& AsioSocketChannel::ioService() {
     return ioService_;
 }
 
+inline
+bool AsioSocketChannel::isWritable() const {
+    return writable_.get() != 0;
+}
+
+inline
+int AsioSocketChannel::highWaterMarkCount() const {
+    return highWaterMarkCounter_;
+}
+
 }
 }
 }
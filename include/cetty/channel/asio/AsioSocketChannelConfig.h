@@ -22,9 +22,11 @@
  */
 
 #include <boost/optional.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
 #include <cetty/channel/ChannelConfig.h>
+#include <cetty/channel/ReceiveBufferSizePredictor.h>
 
 namespace cetty {
 namespace channel {
@@ -51,9 +53,13 @@ using namespace cetty::channel;
  * </tr><tr>
  * <td><tt>"readBufferLowWaterMark"</tt></td><td>{@link #setReadBufferLowWaterMark(int)}</td>
  * </tr><tr>
- * <td><tt>"receiveBufferSizePredictor"</tt></td><td>{@link #setReceiveBufferSizePredictor(ReceiveBufferSizePredictor)}</td>
+ * <td><tt>"writeBatchBytes"</tt></td><td>{@link #setWriteBatchBytes(int)}</td>
  * </tr><tr>
- * <td><tt>"receiveBufferSizePredictorFactory"</tt></td><td>{@link #setReceiveBufferSizePredictorFactory(ReceiveBufferSizePredictorFactory)}</td>
+ * <td><tt>"writeBatchOperations"</tt></td><td>{@link #setWriteBatchOperations(int)}</td>
+ * </tr><tr>
+ * <td><tt>"lazyReadBuffer"</tt></td><td>{@link #setLazyReadBuffer(bool)}</td>
+ * </tr><tr>
+ * <td><tt>"adaptiveReceiveBufferSize"</tt></td><td>{@link #setAdaptiveReceiveBufferSize(int, int, int)}</td>
  * </tr>
  * </table>
  *
@@ -117,6 +123,76 @@ public:
      */
     void setReceiveBufferLowWaterMark(int bufferLowWaterMark);
 
+    /**
+     * Gets the max bytes of the queued write operations which will be
+     * coalesced into one gathering write.
+     */
+    int writeBatchBytes() const;
+
+    /**
+     * Sets the max bytes of one coalesced gathering write.
+     */
+    void setWriteBatchBytes(int writeBatchBytes);
+
+    /**
+     * Gets the max count of the queued write operations which will be
+     * coalesced into one gathering write, <tt>1</tt> means the write
+     * batching is disabled, which is the default.
+     */
+    int writeBatchOperations() const;
+
+    /**
+     * Sets the max count of the write operations of one coalesced
+     * gathering write, <tt>1</tt> to disable the write batching.
+     */
+    void setWriteBatchOperations(int writeBatchOperations);
+
+    bool isWriteBatching() const;
+
+    /**
+     * Returns true if the channel waits for readable with a zero-byte read
+     * first, and only then borrows a read buffer from the per-loop pool,
+     * giving it back when nothing is left buffered after the pipeline has run.
+     * Idle connections then hold no read buffer. The default is false.
+     */
+    bool isLazyReadBuffer() const;
+
+    void setLazyReadBuffer(bool lazyReadBuffer);
+
+    /**
+     * Returns the bytes waiting in the write queue, above which the channel
+     * turns not writable, the same as {@link #sendBufferHighWaterMark()},
+     * which is set by {@link ChannelOption::CO_SNDHIGHWAT}.
+     * The default is 2MB.
+     */
+    int writeBufferHighWaterMark() const;
+
+    void setWriteBufferHighWaterMark(int writeBufferHighWaterMark);
+
+    /**
+     * Returns the bytes waiting in the write queue, below which a not
+     * writable channel turns writable again.  The default is half of the
+     * {@link #writeBufferHighWaterMark()}.
+     */
+    int writeBufferLowWaterMark() const;
+
+    void setWriteBufferLowWaterMark(int writeBufferLowWaterMark);
+
+    /**
+     * Returns the predictor of the read size, <tt>NULL</tt> if the channel
+     * reads into a fixed size buffer, which is the default.
+     */
+    ReceiveBufferSizePredictor* receiveBufferSizePredictor() const;
+
+    /**
+     * Sizes every read adaptively by an {@link AdaptiveReceiveBufferSizePredictor}
+     * within <tt>[minimum, maximum]</tt>, starting from <tt>initial</tt>.
+     *
+     * @return <tt>false</tt>, and the predictor is not changed, unless
+     *         <tt>0 &lt; minimum &lt;= initial &lt;= maximum</tt>.
+     */
+    bool setAdaptiveReceiveBufferSize(int minimum, int initial, int maximum);
+
 private:
     template<typename Option>
     void setSocketOption(const ChannelOption& key,
@@ -213,8 +289,67 @@ private:
 
     mutable boost::optional<int> receiveBufferLowWaterMark_;
     mutable boost::optional<int> receiveBufferHighWaterMark_;
+
+    int writeBatchBytes_;
+    int writeBatchOperations_;
+    int writeBufferLowWaterMark_;
+
+    bool lazyReadBuffer_;
+
+    boost::scoped_ptr<ReceiveBufferSizePredictor> receiveBufferSizePredictor_;
 };
 
+inline
+ReceiveBufferSizePredictor* AsioSocketChannelConfig::receiveBufferSizePredictor() const {
+    return receiveBufferSizePredictor_.get();
+}
+
+inline
+int AsioSocketChannelConfig::writeBufferHighWaterMark() const {
+    return *sendBufferHighWaterMark_;
+}
+
+inline
+void AsioSocketChannelConfig::setWriteBufferHighWaterMark(int writeBufferHighWaterMark) {
+    setSendBufferHighWaterMark(writeBufferHighWaterMark);
+}
+
+inline
+int AsioSocketChannelConfig::writeBufferLowWaterMark() const {
+    int high = writeBufferHighWaterMark();
+
+    if (writeBufferLowWaterMark_ > 0 && writeBufferLowWaterMark_ < high) {
+        return writeBufferLowWaterMark_;
+    }
+
+    return high / 2;
+}
+
+inline
+bool AsioSocketChannelConfig::isLazyReadBuffer() const {
+    return lazyReadBuffer_;
+}
+
+inline
+void AsioSocketChannelConfig::setLazyReadBuffer(bool lazyReadBuffer) {
+    lazyReadBuffer_ = lazyReadBuffer;
+}
+
+inline
+int AsioSocketChannelConfig::writeBatchBytes() const {
+    return writeBatchBytes_;
+}
+
+inline
+int AsioSocketChannelConfig::writeBatchOperations() const {
+    return writeBatchOperations_;
+}
+
+inline
+bool AsioSocketChannelConfig::isWriteBatching() const {
+    return writeBatchOperations_ > 1;
+}
+
 }
 }
 }
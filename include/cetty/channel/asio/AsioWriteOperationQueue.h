@@ -18,9 +18,13 @@
  */
 
 #include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/static_assert.hpp>
 
+#include <cetty/Types.h>
+
 #include <cetty/buffer/ChannelBuffer.h>
 #include <cetty/buffer/GatheringBuffer.h>
 #include <cetty/channel/ChannelFuture.h>
@@ -45,8 +49,15 @@ class AsioWriteOperation {
 public:
     const static int  MAX_BUFFER_COUNT = 8;
 
+    /**
+     * the max memory blocks (IOV_MAX) handed to one gathering write,
+     * a buffer with more blocks will be compacted before writing.
+     */
+    const static int  MAX_GATHERING_BUFFER_COUNT;
+
     typedef boost::asio::mutable_buffer AsioBuffer;
     typedef cetty::util::TruncatableArray<AsioBuffer, MAX_BUFFER_COUNT> AsioBufferArray;
+    typedef std::vector<AsioBuffer> AsioBufferVector;
 
 public:
     AsioWriteOperation();
@@ -63,8 +74,33 @@ public:
 
     bool isSingleBuffer() const;
 
+    /**
+     * has more than {@link MAX_BUFFER_COUNT} memory blocks, which are
+     * stored in the {@link #asioBufferVector()} instead of the
+     * {@link #asioBufferArray()}.
+     */
+    bool isLargeGatheringBuffer() const;
+
+    /**
+     * the bytes which have been copied into a contiguous block,
+     * 0 if the buffer will be written in place.
+     */
+    int compactedBytes() const;
+
     AsioBuffer& asioBuffer();
     AsioBufferArray& asioBufferArray();
+    AsioBufferVector& asioBufferVector();
+
+    /**
+     * the count of memory blocks to write.
+     */
+    int blockCount() const;
+
+    /**
+     * append all the memory blocks to the <tt>buffers</tt>, used when
+     * coalescing several operations into one gathering write.
+     */
+    void appendTo(AsioBufferVector* buffers) const;
 
     bool setSuccess();
     bool setFailure(const Exception& cause);
@@ -74,7 +110,9 @@ private:
 
 private:
     int byteSize_;
+    int compactedBytes_;
     AsioBufferArray buffers_;
+    boost::shared_ptr<AsioBufferVector> largeBuffers_;
 
     ChannelFuturePtr future_;
     ChannelBufferPtr channelBuffer_;
@@ -92,22 +130,48 @@ public:
 
     AsioWriteOperation& front();
 
+    AsioWriteOperation& at(std::size_t index);
+
     void popFront();
 
+    /**
+     * pops the front operation which has been written completely, and
+     * counts it in the {@link #gatheringBytes()} or {@link #compactedBytes()}.
+     * The operations are counted once written, not when offered, as the ones
+     * in writing are offered again when the channel is cleaning up.
+     */
+    void popWritten();
+
     AsioWriteOperation& offer(const ChannelBufferPtr& buffer, const ChannelFuturePtr& f);
 
     AsioWriteOperation& offer(const AsioWriteOperation& operation);
 
     int writeBufferSize() const;
 
+    /**
+     * total bytes of the multi-block buffers which have been handed to
+     * the socket as a gathering write, that is the compaction avoided.
+     */
+    int64_t gatheringBytes() const;
+
+    /**
+     * total bytes which have been compacted before writing, only when the
+     * buffer has more than {@link AsioWriteOperation::MAX_GATHERING_BUFFER_COUNT}
+     * memory blocks.
+     */
+    int64_t compactedBytes() const;
+
 private:
     void plusWriteBufferSize(int messageSize);
+    void updateGatheringStatistics(const AsioWriteOperation& operation);
     void minusWriteBufferSize(int messageSize);
 
 private:
     AsioSocketChannel& channel_;
 
     int writeBufferSize_;
+    int64_t gatheringBytes_;
+    int64_t compactedBytes_;
     std::deque<AsioWriteOperation> ops_;
 };
 
@@ -126,6 +190,16 @@ bool AsioWriteOperation::isSingleBuffer() const {
     return buffers_.truncatedSize() == 1;
 }
 
+inline
+bool AsioWriteOperation::isLargeGatheringBuffer() const {
+    return !!largeBuffers_;
+}
+
+inline
+int AsioWriteOperation::compactedBytes() const {
+    return compactedBytes_;
+}
+
 inline
 AsioWriteOperation::AsioBuffer& AsioWriteOperation::asioBuffer() {
     return buffers_[0];
@@ -136,6 +210,18 @@ AsioWriteOperation::AsioBufferArray& AsioWriteOperation::asioBufferArray() {
     return buffers_;
 }
 
+inline
+AsioWriteOperation::AsioBufferVector& AsioWriteOperation::asioBufferVector() {
+    BOOST_ASSERT(largeBuffers_);
+    return *largeBuffers_;
+}
+
+inline
+int AsioWriteOperation::blockCount() const {
+    return largeBuffers_ ? static_cast<int>(largeBuffers_->size())
+           : buffers_.truncatedSize();
+}
+
 inline
 bool AsioWriteOperation::setSuccess() {
     return future_ ? future_->setSuccess() : false;
@@ -148,7 +234,7 @@ bool AsioWriteOperation::setFailure(const Exception& cause) {
 
 inline
 bool AsioWriteOperation::needCompactBuffers(const GatheringBuffer& gathering) {
-    return gathering.blockCount() > 1;
+    return gathering.blockCount() > MAX_GATHERING_BUFFER_COUNT;
 }
 
 inline
@@ -166,17 +252,38 @@ int AsioWriteOperationQueue::writeBufferSize() const {
     return writeBufferSize_;
 }
 
+inline
+int64_t AsioWriteOperationQueue::gatheringBytes() const {
+    return gatheringBytes_;
+}
+
+inline
+int64_t AsioWriteOperationQueue::compactedBytes() const {
+    return compactedBytes_;
+}
+
 inline
 AsioWriteOperation& AsioWriteOperationQueue::front() {
     return ops_.front();
 }
 
+inline
+AsioWriteOperation& AsioWriteOperationQueue::at(std::size_t index) {
+    return ops_[index];
+}
+
 inline
 void AsioWriteOperationQueue::popFront() {
     minusWriteBufferSize(ops_.front().writeBufferSize());
     ops_.pop_front();
 }
 
+inline
+void AsioWriteOperationQueue::popWritten() {
+    updateGatheringStatistics(ops_.front());
+    popFront();
+}
+
 inline
 AsioWriteOperation& AsioWriteOperationQueue::offer(const ChannelBufferPtr& buffer,
         const ChannelFuturePtr& f) {
@@ -0,0 +1,244 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOP_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOP_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+#include <vector>
+#include <boost/function.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/channel/Timeout.h>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/epoll/EpollEventLoopPtr.h>
+
+#include <cetty/util/Atomic.h>
+#include <cetty/util/MpscQueue.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+class EpollEventLoop;
+class EpollTimeout;
+typedef boost::intrusive_ptr<EpollTimeout> EpollTimeoutPtr;
+
+/**
+ * The {@link Timeout} scheduled in an {@link EpollEventLoop}.
+ */
+class EpollTimeout : public cetty::channel::Timeout {
+public:
+    typedef boost::function0<void> Handler;
+
+    enum {
+        TIMER_UNINITIALIZED  = 0,
+        TIMER_CANCELLED      = 1,
+        TIMER_EXPIRED        = 2,
+        TIMER_ACTIVE         = 4,
+    };
+
+public:
+    EpollTimeout(EpollEventLoop& loop,
+                 int64_t deadline,
+                 int64_t period,
+                 const Handler& handler);
+
+    virtual ~EpollTimeout();
+
+    virtual bool isExpired() const;
+    virtual bool isCancelled() const;
+    virtual bool isActived() const;
+
+    virtual void cancel();
+
+    virtual boost::int64_t expiresFromNow() const;
+
+private:
+    friend class EpollEventLoop;
+
+    typedef std::multimap<int64_t, EpollTimeoutPtr>::iterator Iterator;
+
+    // cancelled in any thread, expired and rescheduled in the loop thread.
+    cetty::util::Atomic<int> state_;
+    bool scheduled_;
+
+    // microseconds since the epoch.
+    int64_t deadline_;
+    int64_t period_;
+
+    Handler handler_;
+    EpollEventLoop& loop_;
+
+    Iterator position_;
+};
+
+/**
+ * An {@link EventLoop} on the Linux edge-triggered epoll, one loop runs
+ * in one thread, see {@link EpollEventLoopPool}.
+ *
+ * The file descriptors are registered once with {@link #addWatcher} for
+ * all the interested events in the edge-triggered mode, so no
+ * <tt>epoll_ctl</tt> is needed when turning reading or writing on and off,
+ * the {@link Watcher} remembers the readiness itself.
+ *
+ * The handlers {@link #post posted} from the other threads are pushed to a
+ * lock-free {@link MpscQueue}, and only the first handler pushed into the
+ * empty queue wakes the loop up through an <tt>eventfd</tt>.  The timeouts
+ * are kept in the deadline order, one <tt>timerfd</tt> is armed to the
+ * earliest deadline.
+ *
+ * Unlike the boost::asio reactor, there is no handler allocation and no
+ * locking per I/O operation, the channels read and write with the
+ * non-blocking <tt>readv</tt>/<tt>writev</tt> directly when the events
+ * come.
+ */
+class EpollEventLoop : public cetty::channel::EventLoop {
+public:
+    /**
+     * The receiver of the events of a file descriptor, which should
+     * live until {@link EpollEventLoop#removeWatcher removed}.
+     */
+    class Watcher {
+    public:
+        virtual ~Watcher() {}
+
+        /**
+         * called in the loop thread, <tt>events</tt> are the
+         * <tt>EPOLLIN</tt>, <tt>EPOLLOUT</tt> etc. happened.
+         */
+        virtual void handleEvents(int events) = 0;
+    };
+
+    static const int MAX_EVENTS_PER_POLL = 256;
+    static const int EXTRA_READ_BUFFER_SIZE = 64 * 1024;
+
+public:
+    EpollEventLoop(const EventLoopPoolPtr& pool);
+
+    virtual ~EpollEventLoop();
+
+    /**
+     * whether the epoll, eventfd and timerfd have been created.
+     */
+    bool isOpen() const;
+
+    /**
+     * run the loop in the current thread, till {@link #stop}.
+     *
+     * @return the count of events and handlers run, -1 if failed.
+     */
+    int64_t run();
+
+    virtual void stop();
+
+    virtual void post(const Handler& handler);
+
+    virtual TimeoutPtr runAt(const boost::posix_time::ptime& timestamp,
+                             const Handler& handler);
+
+    virtual TimeoutPtr runAfter(int64_t millisecond,
+                                const Handler& handler);
+
+    virtual TimeoutPtr runEvery(int64_t millisecond,
+                                const Handler& handler);
+
+    /**
+     * register the <tt>fd</tt> with the <tt>events</tt>, the
+     * <tt>EPOLLET</tt> will always be added.
+     */
+    bool addWatcher(int fd, int events, Watcher* watcher);
+
+    /**
+     * unregister the <tt>fd</tt> in the loop thread, the events of the
+     * <tt>watcher</tt> already polled will be dropped.
+     */
+    void removeWatcher(int fd, Watcher* watcher);
+
+    /**
+     * a buffer shared by the channels of the loop, which is the second
+     * block of the <tt>readv</tt>, so one read can take more than the read
+     * buffer of the channel has, only used in the loop thread.
+     */
+    char* extraReadBuffer();
+
+private:
+    friend class EpollTimeout;
+
+    struct PostedHandlerRunner {
+        EpollEventLoop* loop;
+        PostedHandlerRunner(EpollEventLoop* loop) : loop(loop) {}
+        void operator()(const Handler& handler) const;
+    };
+
+    void wakeup();
+    void handleWakeup();
+    int runPostedHandlers();
+
+    TimeoutPtr newTimeout(int64_t deadline,
+                          int64_t period,
+                          const Handler& handler);
+
+    void schedule(const EpollTimeoutPtr& timeout);
+    void cancel(const EpollTimeoutPtr& timeout);
+
+    int expireTimeouts();
+    void updateTimer();
+    void handleTimer();
+
+    bool isRemoved(Watcher* watcher) const;
+
+private:
+    typedef std::multimap<int64_t, EpollTimeoutPtr> Timeouts;
+
+    int epollFd_;
+    int wakeupFd_;
+    int timerFd_;
+
+    MpscQueue<Handler> handlers_;
+
+    Timeouts timeouts_;
+    int64_t timerDeadline_;
+
+    // the watchers removed while dispatching the polled events.
+    bool dispatching_;
+    std::vector<Watcher*> removedWatchers_;
+
+    std::vector<char> extraReadBuffer_;
+};
+
+inline
+bool EpollEventLoop::isOpen() const {
+    return epollFd_ >= 0 && wakeupFd_ >= 0 && timerFd_ >= 0;
+}
+
+inline
+char* EpollEventLoop::extraReadBuffer() {
+    return &extraReadBuffer_[0];
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOP_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,93 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOPPOOL_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOPPOOL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/thread.hpp>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/epoll/EpollEventLoopPtr.h>
+#include <cetty/channel/epoll/EpollEventLoopPoolPtr.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+class EpollEventLoopHolder;
+
+/**
+ * The pool of the {@link EpollEventLoop}s, one loop per thread, which can
+ * be used in the {@link ServerBootstrap} and {@link ClientBootstrap}
+ * instead of the {@link AsioServicePool}, the pipelines do not change.
+ *
+ * @code
+ * ServerBootstrap bootstrap(new EpollEventLoopPool(threadCount));
+ * @endcode
+ *
+ * Only available on Linux.
+ */
+class EpollEventLoopPool : public cetty::channel::EventLoopPool {
+public:
+    /**
+     * if multi-thread, will automatically run.
+     */
+    EpollEventLoopPool(int threadCnt);
+
+    /**
+     * @param placement the names, cpus and numa nodes of the threads, see
+     *        {@link EventLoopThreadPlacement}.
+     */
+    EpollEventLoopPool(int threadCnt, const EventLoopThreadPlacement& placement);
+
+    virtual ~EpollEventLoopPool() {}
+
+    /**
+     * Run the event loop in the main thread mode.
+     */
+    virtual bool start();
+
+    /**
+     * Stop all the event loops in the pool.
+     */
+    virtual void stop();
+
+    virtual void waitingForStop();
+
+    virtual const EventLoopPtr& nextLoop();
+
+private:
+    EpollEventLoopPool(const EpollEventLoopPool&);
+    EpollEventLoopPool& operator=(const EpollEventLoopPool&);
+
+    void init();
+    int64_t runLoop(EpollEventLoopHolder* holder);
+    int64_t runLoopInThread(EpollEventLoopHolder* holder, int index);
+
+private:
+    boost::mutex mutex_;
+};
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLEVENTLOOPPOOL_H)
+
+// Local Variables:
+// mode: c++
+// End:
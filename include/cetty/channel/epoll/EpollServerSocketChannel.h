@@ -0,0 +1,130 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSERVERSOCKETCHANNEL_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLSERVERSOCKETCHANNEL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+
+#include <cetty/util/Atomic.h>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/InetAddress.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+
+#include <cetty/channel/epoll/EpollEventLoop.h>
+#include <cetty/channel/epoll/EpollSocketChannel.h>
+#include <cetty/channel/epoll/EpollSocketChannelConfig.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+/**
+ * only response to bind port, open and close.
+ *
+ * The listening socket is watched by the parent {@link EpollEventLoop},
+ * all the pending connections are accepted with <tt>accept4</tt> when it
+ * turns readable, and every accepted {@link EpollSocketChannel} is handed
+ * off to the next loop of the child {@link EventLoopPool}, which watches
+ * and serves it from then on.
+ */
+class EpollServerSocketChannel : public cetty::channel::Channel,
+    private EpollEventLoop::Watcher {
+public:
+    typedef ChannelMessageHandlerContext<
+    EpollServerSocketChannel*,
+    VoidMessage,
+    VoidMessage,
+    VoidMessage,
+    VoidMessage,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    VoidMessageContainer> Context;
+
+public:
+    EpollServerSocketChannel(const EventLoopPtr& eventLoop,
+                             const EventLoopPoolPtr& childEventLoopPool);
+
+    virtual ~EpollServerSocketChannel();
+
+    void registerTo(Context& context) {
+        Channel::registerTo(context);
+    }
+
+    /**
+     * the count of the connections accepted.
+     */
+    int64_t acceptedCount() const;
+
+protected:
+    virtual bool doBind(const InetAddress& localAddress);
+    virtual bool doDisconnect();
+    virtual bool doClose();
+
+    virtual void doPreOpen();
+
+private:
+    virtual void handleEvents(int events);
+
+    void accept();
+    void acceptChild(int fd);
+
+    void handleChildClosed(const ChannelFuture& future);
+    void removeChild(int id);
+
+private:
+    typedef std::map<int, EpollSocketChannelPtr> ChildChannels;
+
+    int fd_;
+
+    // reserved for accepting and closing the connection when the process
+    // runs out of file descriptors, or the pending connection will keep
+    // the listening socket readable.
+    int idleFd_;
+
+    bool initialized_;
+    int lastChildId_;
+
+    EpollEventLoopPtr loop_;
+    EventLoopPoolPtr childLoopPool_;
+
+    EpollSocketChannelConfig serverConfig_;
+
+    ChildChannels childChannels_;
+
+    cetty::util::Atomic<int64_t> acceptedCount_;
+};
+
+inline
+int64_t EpollServerSocketChannel::acceptedCount() const {
+    return acceptedCount_.get();
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSERVERSOCKETCHANNEL_H)
+
+// Local Variables:
+// mode: c++
+// End:
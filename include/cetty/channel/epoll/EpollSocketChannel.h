@@ -0,0 +1,221 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNEL_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNEL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <deque>
+#include <vector>
+
+#include <cetty/util/Atomic.h>
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/TimeoutPtr.h>
+#include <cetty/channel/InetAddress.h>
+#include <cetty/channel/ChannelFuture.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+
+#include <cetty/channel/epoll/EpollEventLoop.h>
+#include <cetty/channel/epoll/EpollSocketChannelConfig.h>
+
+#include <cetty/buffer/ChannelBuffer.h>
+#include <cetty/buffer/GatheringBuffer.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+using namespace cetty::buffer;
+
+class EpollServerSocketChannel;
+
+/**
+ * A tcp channel on the {@link EpollEventLoop}, all the operations run in
+ * the loop thread of the channel.
+ *
+ * The socket is registered once for both reading and writing in the
+ * edge-triggered mode.  When readable, the channel reads with
+ * <tt>readv</tt> into the read buffer and the
+ * {@link EpollEventLoop#extraReadBuffer() extra read buffer} of the loop,
+ * till the socket is drained.  The flushed buffers are queued and written
+ * with <tt>writev</tt> in place (including all the blocks of the
+ * {@link CompositeChannelBuffer}), the rest waits for the next
+ * <tt>EPOLLOUT</tt> when the socket send buffer is full.
+ */
+class EpollSocketChannel : public cetty::channel::Channel,
+    private EpollEventLoop::Watcher {
+public:
+    typedef ChannelMessageHandlerContext<
+    EpollSocketChannel*,
+    VoidMessage,
+    VoidMessage,
+    ChannelBufferPtr,
+    VoidMessage,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    ChannelBufferContainer,
+    VoidMessageContainer> Context;
+
+public:
+    EpollSocketChannel(const EventLoopPtr& eventLoop);
+
+    /**
+     * the channel accepted by the {@link EpollServerSocketChannel}, which
+     * owns the connected socket <tt>fd</tt>.
+     */
+    EpollSocketChannel(int id,
+                       const ChannelPtr& parent,
+                       const EventLoopPtr& eventLoop,
+                       int fd);
+
+    virtual ~EpollSocketChannel();
+
+    int fd() const;
+
+    void registerTo(Context& context);
+
+    /**
+     * Returns false when the bytes waiting to be written exceeded the
+     * {@link EpollSocketChannelConfig#writeBufferHighWaterMark() high water mark},
+     * till they drop below the
+     * {@link EpollSocketChannelConfig#writeBufferLowWaterMark() low water mark}.
+     */
+    virtual bool isWritable() const;
+
+    /**
+     * the bytes waiting in the write queue.
+     */
+    int writeBufferSize() const;
+
+    /**
+     * the times the channel turned not writable.
+     */
+    int highWaterMarkCount() const;
+
+private:
+    // template methods
+    virtual bool doBind(const InetAddress& localAddress);
+    virtual bool doDisconnect();
+    virtual bool doClose();
+
+    virtual void doPreOpen();
+    virtual void doPreFireActive();
+
+    void doConnect(ChannelHandlerContext& ctx,
+                   const InetAddress& remoteAddress,
+                   const InetAddress& localAddress,
+                   const ChannelFuturePtr& future);
+
+    void doFlush(ChannelHandlerContext& ctx, const ChannelFuturePtr& future);
+
+    void doRead();
+
+    virtual void handleEvents(int events);
+
+    void handleConnect();
+    void handleConnectTimeout(const ChannelFuturePtr& future);
+    void connectFailed(const ChannelFuturePtr& future,
+                       const ChannelException& e);
+
+    // called in the child event loop after accepted.
+    void acceptedInLoop();
+
+    void readInLoop();
+    void writeInLoop();
+
+    ChannelBufferPtr newReadBuffer(int size);
+
+    void failWriteOperations(const ChannelException& e);
+
+private:
+    friend class EpollServerSocketChannel;
+
+    struct WriteOperation {
+        int size;
+        int written;
+
+        ChannelBufferPtr buffer;
+        ChannelFuturePtr future;
+        GatheringBuffer gathering;
+    };
+
+    typedef std::deque<WriteOperation> WriteOperations;
+
+private:
+    int fd_;
+
+    bool initialized_;
+    bool connecting_;
+
+    // the socket has data or EOF to read, till EAGAIN.
+    bool readable_;
+    bool readRequested_;
+    bool peerClosed_;
+
+    // in writeInLoop, or waiting for the EPOLLOUT.
+    bool writing_;
+    bool writePending_;
+
+    // written in the loop thread, read by isWritable() in any thread.
+    cetty::util::Atomic<int> writable_;
+    int  highWaterMarkCounter_;
+    int  writeBufferSize_;
+
+    EpollEventLoopPtr loop_;
+
+    ChannelBufferPtr readBuffer_;
+    ChannelBufferContainer* writeBufferContainer_;
+    WriteOperations writeOperations_;
+
+    EpollSocketChannelConfig socketConfig_;
+
+    ChannelFuturePtr connectFuture_;
+    TimeoutPtr connectTimeout_;
+};
+
+typedef boost::shared_ptr<EpollSocketChannel> EpollSocketChannelPtr;
+
+inline
+int EpollSocketChannel::fd() const {
+    return fd_;
+}
+
+inline
+bool EpollSocketChannel::isWritable() const {
+    return writable_.get() != 0;
+}
+
+inline
+int EpollSocketChannel::writeBufferSize() const {
+    return writeBufferSize_;
+}
+
+inline
+int EpollSocketChannel::highWaterMarkCount() const {
+    return highWaterMarkCounter_;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNEL_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,228 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNELCONFIG_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNELCONFIG_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/optional.hpp>
+#include <cetty/channel/ChannelOption.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+/**
+ * The socket options of the {@link EpollSocketChannel} and the
+ * {@link EpollServerSocketChannel}.
+ *
+ * The options set before the socket is created are kept, and applied
+ * by {@link #applyTo} once the socket is created.
+ *
+ * <h3>Available options</h3>
+ *
+ * <table border="1" cellspacing="0" cellpadding="6">
+ * <tr>
+ * <th>Name</th><th>Associated setter method</th>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_TCP_NODELAY}</td><td>{@link #setTcpNoDelay(bool)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_KEEPALIVE}</td><td>{@link #setKeepAlive(bool)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_REUSEADDR}</td><td>{@link #setReuseAddress(bool)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_REUSEPORT}</td><td>{@link #setReusePort(bool)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_LINGER}</td><td>{@link #setSoLinger(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_SNDBUF}</td><td>{@link #setSendBufferSize(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_RCVBUF}</td><td>{@link #setReceiveBufferSize(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SO_BACKLOG}</td><td>{@link #setBacklog(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_SNDHIGHWAT}</td><td>{@link #setWriteBufferHighWaterMark(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_WRITE_BUFFER_LOW_WATER_MARK}</td><td>{@link #setWriteBufferLowWaterMark(int)}</td>
+ * </tr><tr>
+ * <td>{@link ChannelOption::CO_WRITE_BATCH_BYTES}</td><td>{@link #setWriteBatchBytes(int)}</td>
+ * </tr>
+ * </table>
+ */
+class EpollSocketChannelConfig {
+public:
+    EpollSocketChannelConfig(const int& fd);
+
+    bool setOption(const ChannelOption& option,
+                   const ChannelOption::Variant& value);
+
+    /**
+     * apply all the options have been set to the new created socket.
+     */
+    void applyTo(int fd) const;
+
+    const boost::optional<bool>& isTcpNoDelay() const;
+    void setTcpNoDelay(bool tcpNoDelay);
+
+    const boost::optional<bool>& isKeepAlive() const;
+    void setKeepAlive(bool keepAlive);
+
+    const boost::optional<bool>& isReuseAddress() const;
+    void setReuseAddress(bool reuseAddress);
+
+    const boost::optional<bool>& isReusePort() const;
+    void setReusePort(bool reusePort);
+
+    const boost::optional<int>& soLinger() const;
+    void setSoLinger(int soLinger);
+
+    const boost::optional<int>& sendBufferSize() const;
+    void setSendBufferSize(int sendBufferSize);
+
+    const boost::optional<int>& receiveBufferSize() const;
+    void setReceiveBufferSize(int receiveBufferSize);
+
+    /**
+     * the backlog of the listening socket, <tt>SOMAXCONN</tt> if not set.
+     */
+    const boost::optional<int>& backlog() const;
+    void setBacklog(int backlog);
+
+    /**
+     * Returns the bytes waiting in the write queue, above which the channel
+     * turns not writable.  The default is 2MB.
+     */
+    int writeBufferHighWaterMark() const;
+    void setWriteBufferHighWaterMark(int writeBufferHighWaterMark);
+
+    /**
+     * Returns the bytes waiting in the write queue, below which a not
+     * writable channel turns writable again.  The default is half of the
+     * {@link #writeBufferHighWaterMark()}.
+     */
+    int writeBufferLowWaterMark() const;
+    void setWriteBufferLowWaterMark(int writeBufferLowWaterMark);
+
+    /**
+     * Returns the max bytes of the queued writes gathered into one
+     * <tt>writev</tt>.  The default is 256KB.
+     */
+    int writeBatchBytes() const;
+    void setWriteBatchBytes(int writeBatchBytes);
+
+private:
+    void setBoolOption(int level, int name, bool src, boost::optional<bool>* dest);
+    void setIntOption(int level, int name, int src, boost::optional<int>* dest);
+
+private:
+    const int& fd_;
+
+    boost::optional<bool> tcpNoDelay_;
+    boost::optional<bool> keepAlive_;
+    boost::optional<bool> reuseAddress_;
+    boost::optional<bool> reusePort_;
+
+    boost::optional<int> soLinger_;
+    boost::optional<int> sendBufferSize_;
+    boost::optional<int> receiveBufferSize_;
+    boost::optional<int> backlog_;
+
+    int writeBufferHighWaterMark_;
+    int writeBufferLowWaterMark_;
+    int writeBatchBytes_;
+};
+
+inline
+const boost::optional<bool>& EpollSocketChannelConfig::isTcpNoDelay() const {
+    return tcpNoDelay_;
+}
+
+inline
+const boost::optional<bool>& EpollSocketChannelConfig::isKeepAlive() const {
+    return keepAlive_;
+}
+
+inline
+const boost::optional<bool>& EpollSocketChannelConfig::isReuseAddress() const {
+    return reuseAddress_;
+}
+
+inline
+const boost::optional<bool>& EpollSocketChannelConfig::isReusePort() const {
+    return reusePort_;
+}
+
+inline
+const boost::optional<int>& EpollSocketChannelConfig::soLinger() const {
+    return soLinger_;
+}
+
+inline
+const boost::optional<int>& EpollSocketChannelConfig::sendBufferSize() const {
+    return sendBufferSize_;
+}
+
+inline
+const boost::optional<int>& EpollSocketChannelConfig::receiveBufferSize() const {
+    return receiveBufferSize_;
+}
+
+inline
+const boost::optional<int>& EpollSocketChannelConfig::backlog() const {
+    return backlog_;
+}
+
+inline
+void EpollSocketChannelConfig::setBacklog(int backlog) {
+    backlog_ = backlog;
+}
+
+inline
+int EpollSocketChannelConfig::writeBufferHighWaterMark() const {
+    return writeBufferHighWaterMark_;
+}
+
+inline
+int EpollSocketChannelConfig::writeBufferLowWaterMark() const {
+    int high = writeBufferHighWaterMark_;
+
+    if (writeBufferLowWaterMark_ > 0 && writeBufferLowWaterMark_ < high) {
+        return writeBufferLowWaterMark_;
+    }
+
+    return high / 2;
+}
+
+inline
+void EpollSocketChannelConfig::setWriteBufferLowWaterMark(int writeBufferLowWaterMark) {
+    writeBufferLowWaterMark_ = writeBufferLowWaterMark;
+}
+
+inline
+int EpollSocketChannelConfig::writeBatchBytes() const {
+    return writeBatchBytes_;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETCHANNELCONFIG_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,74 @@
+#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETUTIL_H)
+#define CETTY_CHANNEL_EPOLL_EPOLLSOCKETUTIL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <sys/socket.h>
+#include <cetty/channel/InetAddress.h>
+
+namespace cetty {
+namespace channel {
+namespace epoll {
+
+using namespace cetty::channel;
+
+/**
+ * The helpers of the raw sockets used by the epoll channels.
+ */
+class EpollSocketUtil {
+public:
+    /**
+     * resolve the address to a <tt>sockaddr</tt>, the host name will be
+     * resolved in blocking.  An empty host means any address when
+     * <tt>passive</tt>.
+     */
+    static bool toSockAddr(const InetAddress& address,
+                           bool passive,
+                           struct sockaddr_storage* addr,
+                           socklen_t* length);
+
+    static InetAddress toInetAddress(const struct sockaddr_storage& addr);
+
+    static InetAddress localAddress(int fd);
+    static InetAddress remoteAddress(int fd);
+
+    /**
+     * create a non-blocking and close-on-exec tcp socket.
+     */
+    static int createSocket(int family);
+
+    /**
+     * the pending error of the socket, <tt>SO_ERROR</tt>.
+     */
+    static int socketError(int fd);
+
+    static bool setOption(int fd, int level, int name, int value);
+    static bool getOption(int fd, int level, int name, int* value);
+
+private:
+    EpollSocketUtil();
+};
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_EPOLL_EPOLLSOCKETUTIL_H)
+
+// Local Variables:
+// mode: c++
+// End:
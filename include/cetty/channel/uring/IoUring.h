@@ -0,0 +1,149 @@
+#if !defined(CETTY_CHANNEL_URING_IOURING_H)
+#define CETTY_CHANNEL_URING_IOURING_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+#include <boost/noncopyable.hpp>
+
+#include <cetty/Types.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+/**
+ * A minimal io_uring instance on the raw system calls, with no dependency
+ * on liburing.  Only used in one thread.
+ *
+ * The submission entries got by {@link #getSqe} are only queued in the
+ * shared ring, all of them go to the kernel with one <tt>io_uring_enter</tt>
+ * in {@link #submitAndWait}, which waits for the completions too.
+ */
+class IoUring : private boost::noncopyable {
+public:
+    IoUring();
+    ~IoUring();
+
+    /**
+     * Returns true if the running kernel has all the io_uring features and
+     * operations the {@link UringEventLoop} needs (Linux 5.11 or later).
+     * The result is probed once and cached.
+     */
+    static bool isSupported();
+
+    /**
+     * setup the rings with at least <tt>entries</tt> submission entries.
+     */
+    bool open(unsigned entries);
+    void close();
+
+    bool isOpen() const;
+
+    int fd() const;
+
+    /**
+     * Returns a cleared submission entry, or NULL if the submission ring is
+     * full, then {@link #submit} first.
+     */
+    struct io_uring_sqe* getSqe();
+
+    /**
+     * the count of the entries queued, but not submitted yet.
+     */
+    unsigned pendingSubmissions() const;
+
+    /**
+     * submit all the queued entries without waiting.
+     *
+     * @return the count submitted, or <tt>-errno</tt>.
+     */
+    int submit();
+
+    /**
+     * submit all the queued entries, and wait for at least one completion
+     * at most <tt>waitMicros</tt>, forever if negative.
+     *
+     * @return the count submitted, or <tt>-errno</tt>, <tt>-ETIME</tt> if
+     *         timed out.
+     */
+    int submitAndWait(int64_t waitMicros);
+
+    /**
+     * Returns the next completion, or NULL if none, call {@link #seen}
+     * after handled it.
+     */
+    struct io_uring_cqe* peekCqe();
+    void seen();
+
+private:
+    int enter(unsigned toSubmit,
+              unsigned minComplete,
+              unsigned flags,
+              const void* arg,
+              size_t argSize);
+
+    unsigned toSubmit() const;
+
+private:
+    int fd_;
+    unsigned features_;
+
+    void* sqRing_;
+    void* cqRing_;
+    size_t sqRingSize_;
+    size_t cqRingSize_;
+
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqFlags_;
+    unsigned* sqArray_;
+    unsigned sqMask_;
+    unsigned sqEntries_;
+
+    // the tail of the entries got, published to the kernel when submitting.
+    unsigned sqeTail_;
+
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    struct io_uring_cqe* cqes_;
+};
+
+inline
+bool IoUring::isOpen() const {
+    return fd_ >= 0;
+}
+
+inline
+int IoUring::fd() const {
+    return fd_;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_URING_IOURING_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,251 @@
+#if !defined(CETTY_CHANNEL_URING_URINGEVENTLOOP_H)
+#define CETTY_CHANNEL_URING_URINGEVENTLOOP_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+#include <vector>
+#include <boost/function.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/channel/Timeout.h>
+#include <cetty/channel/EventLoop.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/uring/IoUring.h>
+#include <cetty/channel/uring/UringEventLoopPtr.h>
+
+#include <cetty/util/Atomic.h>
+#include <cetty/util/MpscQueue.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::channel;
+
+class UringEventLoop;
+class UringTimeout;
+typedef boost::intrusive_ptr<UringTimeout> UringTimeoutPtr;
+
+/**
+ * The {@link Timeout} scheduled in an {@link UringEventLoop}.
+ */
+class UringTimeout : public cetty::channel::Timeout {
+public:
+    typedef boost::function0<void> Handler;
+
+    enum {
+        TIMER_UNINITIALIZED  = 0,
+        TIMER_CANCELLED      = 1,
+        TIMER_EXPIRED        = 2,
+        TIMER_ACTIVE         = 4,
+    };
+
+public:
+    UringTimeout(UringEventLoop& loop,
+                 int64_t deadline,
+                 int64_t period,
+                 const Handler& handler);
+
+    virtual ~UringTimeout();
+
+    virtual bool isExpired() const;
+    virtual bool isCancelled() const;
+    virtual bool isActived() const;
+
+    virtual void cancel();
+
+    virtual boost::int64_t expiresFromNow() const;
+
+private:
+    friend class UringEventLoop;
+
+    typedef std::multimap<int64_t, UringTimeoutPtr>::iterator Iterator;
+
+    int state_;
+    bool scheduled_;
+
+    // microseconds since the epoch.
+    int64_t deadline_;
+    int64_t period_;
+
+    Handler handler_;
+    UringEventLoop& loop_;
+
+    Iterator position_;
+};
+
+/**
+ * An {@link EventLoop} on the Linux io_uring, one loop runs in one thread,
+ * see {@link UringEventLoopPool}.
+ *
+ * The channels queue their <tt>recv</tt>, <tt>sendmsg</tt>, <tt>accept</tt>
+ * operations with {@link #getSqe}, nothing goes to the kernel at once, all
+ * the operations queued in one iteration are submitted together with the
+ * waiting for the completions in one <tt>io_uring_enter</tt>.  Every
+ * operation carries its {@link Completion} as the user data, which is
+ * called in the loop thread when the result comes.
+ *
+ * The handlers {@link #post posted} from the other threads wake the loop
+ * up through an <tt>eventfd</tt> which always has one read pending in the
+ * ring, the waiting in <tt>io_uring_enter</tt> is bounded by the earliest
+ * deadline of the timeouts.
+ */
+class UringEventLoop : public cetty::channel::EventLoop {
+public:
+    /**
+     * The receiver of the result of an operation, which should live until
+     * the completion came, even the operation has been
+     * {@link UringEventLoop#cancelOperation cancelled}.
+     */
+    class Completion {
+    public:
+        virtual ~Completion() {}
+
+        /**
+         * called in the loop thread, <tt>result</tt> is the
+         * <tt>cqe->res</tt>, <tt>-errno</tt> if failed, and <tt>flags</tt>
+         * the <tt>cqe->flags</tt>.
+         */
+        virtual void complete(int result, unsigned flags) = 0;
+    };
+
+    /**
+     * A {@link Completion} which calls back a member function.
+     */
+    template<typename T>
+    class MemberCompletion : public Completion {
+    public:
+        typedef void (T::*Callback)(int result, unsigned flags);
+
+    public:
+        MemberCompletion(T* object, Callback callback)
+            : object_(object), callback_(callback) {
+        }
+
+        virtual ~MemberCompletion() {}
+
+        virtual void complete(int result, unsigned flags) {
+            (object_->*callback_)(result, flags);
+        }
+
+    private:
+        T* object_;
+        Callback callback_;
+    };
+
+    static const int RING_ENTRIES = 1024;
+
+public:
+    UringEventLoop(const EventLoopPoolPtr& pool);
+
+    virtual ~UringEventLoop();
+
+    /**
+     * whether the io_uring and the eventfd have been created.
+     */
+    bool isOpen() const;
+
+    /**
+     * run the loop in the current thread, till {@link #stop}.
+     *
+     * @return the count of completions and handlers run, -1 if failed.
+     */
+    int64_t run();
+
+    virtual void stop();
+
+    virtual void post(const Handler& handler);
+
+    virtual TimeoutPtr runAt(const boost::posix_time::ptime& timestamp,
+                             const Handler& handler);
+
+    virtual TimeoutPtr runAfter(int64_t millisecond,
+                                const Handler& handler);
+
+    virtual TimeoutPtr runEvery(int64_t millisecond,
+                                const Handler& handler);
+
+    /**
+     * Returns a cleared submission entry with the <tt>completion</tt> as
+     * the user data, which will be submitted in the current iteration,
+     * only used in the loop thread.
+     */
+    struct io_uring_sqe* getSqe(Completion* completion);
+
+    /**
+     * cancel the operation of the <tt>completion</tt>, which will still
+     * complete, mostly with <tt>-ECANCELED</tt>.
+     */
+    void cancelOperation(Completion* completion);
+
+private:
+    friend class UringTimeout;
+
+    struct PostedHandlerRunner {
+        UringEventLoop* loop;
+        PostedHandlerRunner(UringEventLoop* loop) : loop(loop) {}
+        void operator()(const Handler& handler) const;
+    };
+
+    void wakeup();
+    void armWakeup();
+    void handleWakeup(int result, unsigned flags);
+    int runPostedHandlers();
+
+    int reapCompletions();
+
+    TimeoutPtr newTimeout(int64_t deadline,
+                          int64_t period,
+                          const Handler& handler);
+
+    void schedule(const UringTimeoutPtr& timeout);
+    void cancel(const UringTimeoutPtr& timeout);
+
+    int expireTimeouts();
+
+    // microseconds to wait in io_uring_enter, -1 for forever.
+    int64_t waitTime();
+
+private:
+    typedef std::multimap<int64_t, UringTimeoutPtr> Timeouts;
+
+    IoUring ring_;
+
+    int wakeupFd_;
+    uint64_t wakeupValue_;
+    MemberCompletion<UringEventLoop> wakeupCompletion_;
+
+    MpscQueue<Handler> handlers_;
+
+    Timeouts timeouts_;
+};
+
+inline
+bool UringEventLoop::isOpen() const {
+    return ring_.isOpen() && wakeupFd_ >= 0;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_URING_URINGEVENTLOOP_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,108 @@
+#if !defined(CETTY_CHANNEL_URING_URINGEVENTLOOPPOOL_H)
+#define CETTY_CHANNEL_URING_URINGEVENTLOOPPOOL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/thread.hpp>
+#include <cetty/channel/EventLoopPool.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/uring/UringEventLoopPtr.h>
+#include <cetty/channel/uring/UringEventLoopPoolPtr.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::channel;
+
+class UringEventLoopHolder;
+
+/**
+ * The pool of the {@link UringEventLoop}s, one loop per thread, which can
+ * be used in the {@link ServerBootstrap} and {@link ClientBootstrap}
+ * instead of the {@link AsioServicePool}, the pipelines do not change.
+ *
+ * The io_uring needs Linux 5.11 or later, and may be forbidden by the
+ * seccomp of the containers, so create the pool with {@link #create},
+ * which falls back to the {@link AsioServicePool} when the kernel can
+ * not run it.
+ *
+ * @code
+ * ServerBootstrap bootstrap(UringEventLoopPool::create(threadCount));
+ * @endcode
+ *
+ * Only available on Linux.
+ */
+class UringEventLoopPool : public cetty::channel::EventLoopPool {
+public:
+    /**
+     * if multi-thread, will automatically run.
+     */
+    UringEventLoopPool(int threadCnt);
+
+    /**
+     * @param placement the names, cpus and numa nodes of the threads, see
+     *        {@link EventLoopThreadPlacement}.
+     */
+    UringEventLoopPool(int threadCnt, const EventLoopThreadPlacement& placement);
+
+    virtual ~UringEventLoopPool() {}
+
+    /**
+     * Returns an {@link UringEventLoopPool} if the kernel supports the
+     * io_uring, otherwise an {@link AsioServicePool}.
+     */
+    static EventLoopPoolPtr create(int threadCnt);
+
+    static EventLoopPoolPtr create(int threadCnt,
+                                   const EventLoopThreadPlacement& placement);
+
+    /**
+     * Run the event loop in the main thread mode.
+     */
+    virtual bool start();
+
+    /**
+     * Stop all the event loops in the pool.
+     */
+    virtual void stop();
+
+    virtual void waitingForStop();
+
+    virtual const EventLoopPtr& nextLoop();
+
+private:
+    UringEventLoopPool(const UringEventLoopPool&);
+    UringEventLoopPool& operator=(const UringEventLoopPool&);
+
+    void init();
+    int64_t runLoop(UringEventLoopHolder* holder);
+    int64_t runLoopInThread(UringEventLoopHolder* holder, int index);
+
+private:
+    boost::mutex mutex_;
+};
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_URING_URINGEVENTLOOPPOOL_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,139 @@
+#if !defined(CETTY_CHANNEL_URING_URINGSERVERSOCKETCHANNEL_H)
+#define CETTY_CHANNEL_URING_URINGSERVERSOCKETCHANNEL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+
+#include <cetty/util/Atomic.h>
+
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/InetAddress.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+
+#include <cetty/channel/epoll/EpollSocketChannelConfig.h>
+#include <cetty/channel/uring/UringEventLoop.h>
+#include <cetty/channel/uring/UringSocketChannel.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::channel;
+using cetty::channel::epoll::EpollSocketChannelConfig;
+
+/**
+ * only response to bind port, open and close.
+ *
+ * The listening socket keeps one multishot <tt>ACCEPT</tt> in the ring of
+ * the parent {@link UringEventLoop}, which completes once for every
+ * connection till it is terminated, then it is queued again.  The kernels
+ * without the multishot accept (before Linux 5.19) accept one connection
+ * per operation.  Every accepted {@link UringSocketChannel} is handed off
+ * to the next loop of the child {@link EventLoopPool}, which serves it from
+ * then on.
+ */
+class UringServerSocketChannel : public cetty::channel::Channel {
+public:
+    typedef ChannelMessageHandlerContext<
+    UringServerSocketChannel*,
+    VoidMessage,
+    VoidMessage,
+    VoidMessage,
+    VoidMessage,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    VoidMessageContainer> Context;
+
+public:
+    UringServerSocketChannel(const EventLoopPtr& eventLoop,
+                             const EventLoopPoolPtr& childEventLoopPool);
+
+    virtual ~UringServerSocketChannel();
+
+    void registerTo(Context& context) {
+        Channel::registerTo(context);
+    }
+
+    /**
+     * the count of the connections accepted.
+     */
+    int64_t acceptedCount() const;
+
+protected:
+    virtual bool doBind(const InetAddress& localAddress);
+    virtual bool doDisconnect();
+    virtual bool doClose();
+
+    virtual void doPreOpen();
+
+private:
+    void startAccept();
+    void handleAccept(int result, unsigned flags);
+    void acceptChild(int fd);
+
+    void handleChildClosed(const ChannelFuture& future);
+    void removeChild(int id);
+
+private:
+    typedef std::map<int, UringSocketChannelPtr> ChildChannels;
+
+    int fd_;
+
+    // released when the process runs out of file descriptors, so the next
+    // connection can be accepted and closed, instead of failing the accept
+    // again and again.
+    int idleFd_;
+    bool dropNextChild_;
+
+    bool multishot_;
+    bool accepting_;
+
+    // the server holds itself while the accept is in flight.
+    ChannelPtr self_;
+    UringEventLoop::MemberCompletion<UringServerSocketChannel> acceptOperation_;
+
+    bool initialized_;
+    int lastChildId_;
+
+    UringEventLoopPtr loop_;
+    EventLoopPoolPtr childLoopPool_;
+
+    EpollSocketChannelConfig serverConfig_;
+
+    ChildChannels childChannels_;
+
+    cetty::util::Atomic<int64_t> acceptedCount_;
+};
+
+inline
+int64_t UringServerSocketChannel::acceptedCount() const {
+    return acceptedCount_.get();
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_URING_URINGSERVERSOCKETCHANNEL_H)
+
+// Local Variables:
+// mode: c++
+// End:
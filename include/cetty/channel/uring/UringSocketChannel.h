@@ -0,0 +1,244 @@
+#if !defined(CETTY_CHANNEL_URING_URINGSOCKETCHANNEL_H)
+#define CETTY_CHANNEL_URING_URINGSOCKETCHANNEL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <deque>
+#include <vector>
+#include <sys/socket.h>
+
+#include <cetty/util/Atomic.h>
+#include <cetty/channel/Channel.h>
+#include <cetty/channel/TimeoutPtr.h>
+#include <cetty/channel/InetAddress.h>
+#include <cetty/channel/ChannelFuture.h>
+#include <cetty/channel/ChannelPipeline.h>
+#include <cetty/channel/ChannelMessageContainer.h>
+#include <cetty/channel/ChannelMessageHandlerContext.h>
+
+#include <cetty/channel/epoll/EpollSocketChannelConfig.h>
+#include <cetty/channel/uring/UringEventLoop.h>
+
+#include <cetty/buffer/ChannelBuffer.h>
+#include <cetty/buffer/GatheringBuffer.h>
+
+namespace cetty {
+namespace channel {
+namespace uring {
+
+using namespace cetty::channel;
+using namespace cetty::buffer;
+using cetty::channel::epoll::EpollSocketChannelConfig;
+
+class UringServerSocketChannel;
+
+/**
+ * A tcp channel on the {@link UringEventLoop}, all the operations run in
+ * the loop thread of the channel.
+ *
+ * There is at most one read and one write in flight.  The read goes
+ * straight into the read buffer with a <tt>RECV</tt>.  The flushed buffers are queued and gathered into one
+ * <tt>SENDMSG</tt> (including all the blocks of the
+ * {@link CompositeChannelBuffer}), the rest of a partial send is sent with
+ * the next one.
+ *
+ * The socket options are the same as the {@link EpollSocketChannel}.
+ *
+ * The channel holds itself while any operation is in flight, the kernel
+ * may still write to the read buffer till the completion comes, even the
+ * channel has been closed.
+ */
+class UringSocketChannel : public cetty::channel::Channel {
+public:
+    typedef ChannelMessageHandlerContext<
+    UringSocketChannel*,
+    VoidMessage,
+    VoidMessage,
+    ChannelBufferPtr,
+    VoidMessage,
+    VoidMessageContainer,
+    VoidMessageContainer,
+    ChannelBufferContainer,
+    VoidMessageContainer> Context;
+
+public:
+    UringSocketChannel(const EventLoopPtr& eventLoop);
+
+    /**
+     * the channel accepted by the {@link UringServerSocketChannel}, which
+     * owns the connected socket <tt>fd</tt>.
+     */
+    UringSocketChannel(int id,
+                       const ChannelPtr& parent,
+                       const EventLoopPtr& eventLoop,
+                       int fd);
+
+    virtual ~UringSocketChannel();
+
+    int fd() const;
+
+    void registerTo(Context& context);
+
+    /**
+     * Returns false when the bytes waiting to be written exceeded the
+     * {@link EpollSocketChannelConfig#writeBufferHighWaterMark() high water mark},
+     * till they drop below the
+     * {@link EpollSocketChannelConfig#writeBufferLowWaterMark() low water mark}.
+     */
+    virtual bool isWritable() const;
+
+    /**
+     * the bytes waiting in the write queue.
+     */
+    int writeBufferSize() const;
+
+    /**
+     * the times the channel turned not writable.
+     */
+    int highWaterMarkCount() const;
+
+private:
+    // template methods
+    virtual bool doBind(const InetAddress& localAddress);
+    virtual bool doDisconnect();
+    virtual bool doClose();
+
+    virtual void doPreOpen();
+    virtual void doPreFireActive();
+
+    void doConnect(ChannelHandlerContext& ctx,
+                   const InetAddress& remoteAddress,
+                   const InetAddress& localAddress,
+                   const ChannelFuturePtr& future);
+
+    void doFlush(ChannelHandlerContext& ctx, const ChannelFuturePtr& future);
+
+    void doRead();
+
+    // called in the child event loop after accepted.
+    void acceptedInLoop();
+
+    void handleConnect(int result, unsigned flags);
+    void handleConnectTimeout(const ChannelFuturePtr& future);
+    void connectFailed(const ChannelFuturePtr& future,
+                       const ChannelException& e);
+
+    void submitRead();
+    void handleRead(int result, unsigned flags);
+
+    void submitWrite();
+    void handleWrite(int result, unsigned flags);
+
+    void operationStarted();
+    void operationCompleted();
+
+    ChannelBufferPtr newReadBuffer(int size);
+
+    void failWriteOperations(const ChannelException& e);
+
+private:
+    friend class UringServerSocketChannel;
+
+    typedef UringEventLoop::MemberCompletion<UringSocketChannel> Operation;
+
+    struct WriteOperation {
+        int size;
+        int written;
+
+        ChannelBufferPtr buffer;
+        ChannelFuturePtr future;
+        GatheringBuffer gathering;
+    };
+
+    typedef std::deque<WriteOperation> WriteOperations;
+
+private:
+    int fd_;
+
+    bool initialized_;
+    bool connecting_;
+
+    bool reading_;
+    bool readRequested_;
+
+    bool writing_;
+
+    // written in the loop thread, read by isWritable() in any thread.
+    cetty::util::Atomic<int> writable_;
+    int  highWaterMarkCounter_;
+    int  writeBufferSize_;
+
+    UringEventLoopPtr loop_;
+
+    // the operations in flight, and the channel itself kept alive by them.
+    int pendingOperations_;
+    ChannelPtr self_;
+
+    Operation connectOperation_;
+    Operation readOperation_;
+    Operation writeOperation_;
+
+    ChannelBufferPtr readBuffer_;
+
+    ChannelBufferContainer* writeBufferContainer_;
+    WriteOperations writeOperations_;
+
+    // the message and blocks of the sendmsg in flight.
+    struct msghdr message_;
+    std::vector<struct iovec> blocks_;
+    int sendingBytes_;
+
+    EpollSocketChannelConfig socketConfig_;
+
+    struct sockaddr_storage remote_;
+    socklen_t remoteLength_;
+
+    ChannelFuturePtr connectFuture_;
+    TimeoutPtr connectTimeout_;
+};
+
+typedef boost::shared_ptr<UringSocketChannel> UringSocketChannelPtr;
+
+inline
+int UringSocketChannel::fd() const {
+    return fd_;
+}
+
+inline
+bool UringSocketChannel::isWritable() const {
+    return writable_.get() != 0;
+}
+
+inline
+int UringSocketChannel::writeBufferSize() const {
+    return writeBufferSize_;
+}
+
+inline
+int UringSocketChannel::highWaterMarkCount() const {
+    return highWaterMarkCounter_;
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_CHANNEL_URING_URINGSOCKETCHANNEL_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -20,6 +20,7 @@
 #include <cetty/channel/ChannelPtr.h>
 #include <cetty/protobuf/service/ProtobufServicePtr.h>
 #include <cetty/protobuf/service/builder/ProtobufServerBuilder.h>
+#include <cetty/handler/codec/http/HttpCompressedContentCache.h>
 
 namespace cetty {
 namespace config {
@@ -67,6 +68,12 @@ public:
     const EventLoopPoolPtr& parentPool() const;
     const EventLoopPoolPtr& childPool() const;
 
+    /**
+     * the worker pool shared with the rpc services, see
+     * {@link ProtobufServerBuilder#workerPool()}.
+     */
+    const WorkStealingThreadPoolPtr& workerPool() const;
+
     ServerBuilder& serverBuilder();
     const ServerBuilder& serverBuilder() const;
 
@@ -76,6 +83,7 @@ private:
 
 private:
     ProtobufServerBuilder builder_;
+    cetty::handler::codec::http::HttpCompressedContentCachePtr compressedContentCache_;
 };
 
 inline
@@ -119,6 +127,11 @@ const EventLoopPoolPtr& CraftServerBuilder::childPool() const {
     return builder_.childPool();
 }
 
+inline
+const WorkStealingThreadPoolPtr& CraftServerBuilder::workerPool() const {
+    return builder_.workerPool();
+}
+
 inline
 ServerBuilder& CraftServerBuilder::serverBuilder() {
     return builder_.serverBuilder();
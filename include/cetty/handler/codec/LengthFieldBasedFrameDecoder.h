@@ -342,7 +342,10 @@ private:
      * Refer to the source code of {@link ObjectDecoder} to see how this method
      * is overridden to avoid memory copy.
      */
-    ChannelBufferPtr extractFrame(const ChannelBufferPtr& buffer, int index, int length);
+    ChannelBufferPtr extractFrame(ChannelHandlerContext& ctx,
+                                  const ChannelBufferPtr& buffer,
+                                  int index,
+                                  int length);
 
 private:
     void init();
@@ -151,9 +151,12 @@ public:
                 inboundQueue.pop_front();
             }
             catch (const CodecException& e) {
+                // drop the bad message, or it would be decoded again forever.
+                inboundQueue.pop_front();
                 ctx.fireExceptionCaught(e);
             }
             catch (const std::exception& e) {
+                inboundQueue.pop_front();
                 ctx.fireExceptionCaught(DecoderException(e.what()));
             }
         }
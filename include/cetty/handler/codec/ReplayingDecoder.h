@@ -614,9 +614,12 @@ protected:
 private:
     void fireMessageUpdated(ChannelHandlerContext& ctx,
     const ChannelBufferPtr& in) {
+        // the decoded messages may still slice the read bytes, so let the
+        // next handlers see them before the bytes are moved.
+        ctx.fireMessageUpdated();
+
         checkedPoint_ -= in->readerIndex();
         in->discardReadBytes();
-        ctx.fireMessageUpdated();
     }
 
     void updateReplayable(const ChannelBufferPtr& input) {
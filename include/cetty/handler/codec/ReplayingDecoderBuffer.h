@@ -59,6 +59,13 @@ public:
         terminated = true;
     }
 
+    /**
+     * Returns <tt>true</tt> if the channel is closed, no more bytes will come.
+     */
+    bool isTerminated() const {
+        return terminated;
+    }
+
     bool needMoreBytes() const {
         return needMore;
     }
@@ -69,6 +69,10 @@ public:
     */
     virtual bool isLast() const;
 
+    /**
+     * Returns <tt>true</tt> if this chunk carries the last bytes of the
+     * content, and no 'end of content' marker will follow it.
+     */
     bool followingLastChunk() const;
     void setFollowLastChunk(bool followLast);
 
@@ -88,6 +92,7 @@ public:
     virtual std::string toString() const;
 
 private:
+    bool followLastChunk;
     ChannelBufferPtr content;
 };
 
@@ -21,6 +21,9 @@
  * Distributed under under the Apache License, version 2.0 (the "License").
  */
 
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <cetty/buffer/ChannelBuffer.h>
 #include <cetty/handler/codec/MessageToMessageDecoder.h>
 #include <cetty/handler/codec/http/HttpPackage.h>
 
@@ -29,26 +32,42 @@ namespace handler {
 namespace codec {
 namespace http {
 
+using namespace cetty::buffer;
 using namespace cetty::handler::codec;
 
-class HttpPackageVisitor;
+class HttpResponseStatus;
 
 /**
- * A {@link ChannelHandler} that aggregates an {@link HttpMessage}
- * and its following {@link HttpChunk}s into a single {@link HttpMessage} with
+ * A {@link ChannelHandler} that aggregates an {@link HttpPackage}
+ * and its following {@link HttpChunk}s into a single {@link HttpPackage} with
  * no following {@link HttpChunk}s.  It is useful when you don't want to take
  * care of HTTP messages whose transfer encoding is 'chunked'.  Insert this
- * handler after {@link HttpMessageDecoder} in the {@link ChannelPipeline}:
+ * handler after {@link HttpServerCodec} in the {@link ChannelPipeline}:
  * <pre>
- * {@link ChannelPipeline} p = ...;
+ * ChannelPipeline& p = ...;
  * ...
- * p.addLast("decoder", new {@link HttpRequestDecoder}());
- * p.addLast("aggregator", <b>new {@link HttpChunkAggregator}(1048576)</b>);
+ * p.addLast<HttpServerCodec::HandlerPtr>("codec",
+ *     HttpServerCodec::HandlerPtr(new HttpServerCodec));
+ * p.addLast<HttpChunkAggregator::HandlerPtr>("aggregator",
+ *     HttpChunkAggregator::HandlerPtr(<b>new HttpChunkAggregator(1048576)</b>));
  * ...
- * p.addLast("encoder", new {@link HttpResponseEncoder}());
  * p.addLast("handler", new HttpRequestHandler());
  * </pre>
  *
+ * The chunk payloads are sliced from the read buffer of the channel, which
+ * is reused after the chunks are handled, so each payload is copied once
+ * into the buffers owned by the aggregator, small chunks are packed into
+ * the spare room of the last one.  The aggregated content is a
+ * {@link CompositeChannelBuffer} over these buffers, not a flat copy, until
+ * there are {@link #maxCumulationBufferComponents()} of them, then they are
+ * merged into one.
+ *
+ * A request whose content exceeds the <tt>maxContentLength</tt>, already
+ * known from the <tt>"Content-Length"</tt> header or found while the chunks
+ * are coming, is answered with <tt>413 Request Entity Too Large</tt> and the
+ * connection is closed, the rest of its chunks are discarded.  A request
+ * with <tt>"Expect: 100-continue"</tt> is answered with
+ * <tt>100 Continue</tt> before its content is aggregated.
  *
  * @author <a href="http://gleamynode.net/">Trustin Lee</a>
  * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
@@ -57,7 +76,18 @@ class HttpPackageVisitor;
  * @apiviz.has org.jboss.netty.handler.codec.http.HttpChunk oneway - - filters out
  */
 
-class HttpChunkAggregator {
+class HttpChunkAggregator : private boost::noncopyable {
+public:
+    typedef MessageToMessageDecoder<HttpChunkAggregator,
+            HttpPackage,
+            HttpPackage> Decoder;
+
+    typedef Decoder::Context Context;
+    typedef Decoder::Handler Handler;
+    typedef Decoder::HandlerPtr HandlerPtr;
+
+    static const int DEFAULT_MAX_CUMULATION_BUFFER_COMPONENTS = 1024;
+
 public:
     /**
      * Creates a new instance.
@@ -65,23 +95,63 @@ public:
      * @param maxContentLength
      *        the maximum length of the aggregated content.
      *        If the length of the aggregated content exceeds this value,
-     *        a {@link TooLongFrameException} will be raised.
+     *        the request will be answered with <tt>413</tt>, and a
+     *        {@link TooLongFrameException} will be raised for a response.
      */
     HttpChunkAggregator(int maxContentLength);
 
     ~HttpChunkAggregator() {}
 
-protected:
-    HttpPackage decode(ChannelHandlerContext& ctx,
-                                  const HttpPackage& msg);
+    int maxContentLength() const {
+        return maxContentLength_;
+    }
+
+    /**
+     * Returns the maximum number of the buffers in the aggregated content
+     * before they are merged into one.
+     */
+    int maxCumulationBufferComponents() const {
+        return maxCumulationBufferComponents_;
+    }
+
+    /**
+     * Sets the maximum number of the buffers in the aggregated content,
+     * which must be at least <tt>2</tt>.
+     */
+    void setMaxCumulationBufferComponents(int maxCumulationBufferComponents);
+
+    void registerTo(Context& ctx) {
+        decoder_.registerTo(ctx);
+    }
+
+private:
+    HttpPackage decode(ChannelHandlerContext& ctx, const HttpPackage& msg);
+
+    HttpPackage decodeMessage(ChannelHandlerContext& ctx, const HttpPackage& msg);
+    HttpPackage decodeChunk(ChannelHandlerContext& ctx, const HttpChunkPtr& chunk);
+
+    void contentTooLong(ChannelHandlerContext& ctx, bool isRequest);
 
     void appendToCumulation(const ChannelBufferPtr& input);
+    HttpPackage finishAggregation();
+
+    void reset();
+
+    void writeResponse(ChannelHandlerContext& ctx,
+                       const HttpResponseStatus& status,
+                       bool close);
 
 private:
     int maxContentLength_;
+    int maxCumulationBufferComponents_;
+
+    int contentLength_;
+    bool discarding_;
+
     HttpPackage currentMessage_;
+    std::vector<ChannelBufferPtr> components_;
 
-    MessageToMessageDecoder<HttpChunkAggregator, HttpPackage, HttpPackage> decoder_;
+    Decoder decoder_;
 };
 
 }
@@ -29,6 +29,7 @@ namespace codec {
 namespace http {
 
 class HttpMessage;
+class HttpHeaders;
 
 /**
  *
@@ -84,7 +85,12 @@ public:
 public:
     static bool validateHeaderName(const std::string& name);
     static bool validateHeaderValue(const std::string& value);
-    //static bool isTransferEncodingChunked(const HttpMessage& m);
+
+    /**
+     * Returns <tt>true</tt> if one of the <tt>"Transfer-Encoding"</tt>
+     * headers lists the <tt>chunked</tt> coding.
+     */
+    static bool isTransferEncodingChunked(const HttpHeaders& headers);
     //static bool isContentLengthSet(const HttpMessage& m);
 
     //static void splitElements(const std::string& s, std::vector<std::string>& elements, bool ignoreEmpty = true);
@@ -0,0 +1,164 @@
+#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPCOMPRESSEDCONTENTCACHE_H)
+#define CETTY_HANDLER_CODEC_HTTP_HTTPCOMPRESSEDCONTENTCACHE_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+#include <list>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cetty/Types.h>
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+/**
+ * A least recently used cache of the compressed response bodies, shared by
+ * the {@link HttpContentCompressor}s of all the channels, so the same
+ * response is compressed once, not once per request.
+ *
+ * The cache is bounded by the total bytes of the compressed bodies, the
+ * least recently used ones are evicted first.  A body larger than a quarter
+ * of the capacity is never cached.  All the methods are thread safe.
+ *
+ * Each entry keeps the {@link #digest digest} of its uncompressed body, a
+ * body is only served from the cache when its digest matches too.  The
+ * entries of a key which identifies the body itself may be cached with an
+ * empty <tt>Digest()</tt>, without hashing the body.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class HttpCompressedContentCache : private boost::noncopyable {
+public:
+    typedef boost::shared_ptr<const std::string> ContentPtr;
+
+    /**
+     * The 128 bits digest of an uncompressed body.
+     */
+    struct Digest {
+        uint64_t first;
+        uint64_t second;
+
+        Digest() : first(0), second(0) {}
+
+        bool operator==(const Digest& digest) const {
+            return first == digest.first && second == digest.second;
+        }
+
+        bool operator!=(const Digest& digest) const {
+            return !(*this == digest);
+        }
+    };
+
+public:
+    /**
+     * Creates a new instance.
+     *
+     * @param capacity the maximum bytes of all the cached bodies.
+     */
+    HttpCompressedContentCache(int capacity);
+
+    int capacity() const {
+        return capacity_;
+    }
+
+    /**
+     * Returns the compressed body of the <tt>key</tt>, or an empty pointer
+     * if there is none or it is not compressed from the body of the
+     * <tt>digest</tt>, and marks it as the most recently used one.
+     */
+    ContentPtr get(const std::string& key, const Digest& digest);
+
+    /**
+     * Caches the compressed body of the <tt>key</tt>, which replaces the one
+     * of another digest, evicting the least recently used ones when the
+     * capacity is exceeded.
+     */
+    void put(const std::string& key,
+             const Digest& digest,
+             const ContentPtr& content);
+
+    void clear();
+
+    /**
+     * the number of the cached bodies.
+     */
+    int count() const;
+
+    /**
+     * the bytes of all the cached bodies.
+     */
+    int size() const;
+
+    int64_t hits() const;
+    int64_t misses() const;
+
+    /**
+     * Returns the SipHash-2-4 (128 bits output) of the bytes, keyed by a
+     * random key drawn once per process, so the clients can not craft the
+     * bodies of the same digest.
+     */
+    static Digest digest(const char* bytes, int length);
+
+private:
+    struct Entry {
+        std::string key;
+        Digest digest;
+        ContentPtr content;
+
+        Entry(const std::string& key,
+              const Digest& digest,
+              const ContentPtr& content)
+            : key(key), digest(digest), content(content) {}
+    };
+
+    typedef std::list<Entry> EntryList;
+    typedef std::map<std::string, EntryList::iterator> EntryMap;
+
+    void evict();
+
+private:
+    int capacity_;
+    int size_;
+
+    int64_t hits_;
+    int64_t misses_;
+
+    // the most recently used entry is at the front.
+    EntryList entries_;
+    EntryMap index_;
+
+    mutable boost::mutex mutex_;
+};
+
+typedef boost::shared_ptr<HttpCompressedContentCache> HttpCompressedContentCachePtr;
+
+}
+}
+}
+}
+
+#endif //#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPCOMPRESSEDCONTENTCACHE_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,243 @@
+#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPCONTENTCOMPRESSOR_H)
+#define CETTY_HANDLER_CODEC_HTTP_HTTPCONTENTCOMPRESSOR_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <cetty/buffer/ChannelBuffer.h>
+#include <cetty/util/StringPiece.h>
+#include <cetty/handler/codec/MessageToMessageCodec.h>
+#include <cetty/handler/codec/http/HttpPackage.h>
+#include <cetty/handler/codec/http/HttpResponsePtr.h>
+#include <cetty/handler/codec/http/HttpCompressedContentCache.h>
+
+struct z_stream_s;
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+using namespace cetty::buffer;
+using namespace cetty::util;
+using namespace cetty::handler::codec;
+
+/**
+ * Compresses an {@link HttpResponse} and its following {@link HttpChunk}s in
+ * <tt>gzip</tt> or <tt>deflate</tt> encoding, as the <tt>"Accept-Encoding"</tt>
+ * header of the request prefers, while respecting the <tt>"q"</tt> values.
+ * Insert this handler after {@link HttpServerCodec} in the
+ * {@link ChannelPipeline}:
+ * <pre>
+ * ChannelPipeline& p = ...;
+ * ...
+ * p.addLast<HttpServerCodec::HandlerPtr>("codec",
+ *     HttpServerCodec::HandlerPtr(new HttpServerCodec));
+ * p.addLast<HttpContentCompressor::HandlerPtr>("deflater",
+ *     HttpContentCompressor::HandlerPtr(<b>new HttpContentCompressor</b>));
+ * ...
+ * p.addLast("handler", new HttpRequestHandler());
+ * </pre>
+ *
+ * Only the responses worth it are compressed: the content is at least
+ * {@link #minContentLength()} bytes, its <tt>"Content-Type"</tt> is one of
+ * the {@link #compressibleContentTypes()}, and it is not encoded already.
+ * A compressed response gets the <tt>"Content-Encoding"</tt> and the
+ * <tt>"Vary: Accept-Encoding"</tt> headers.
+ *
+ * The content of a single response is compressed at once.  With a
+ * {@link HttpCompressedContentCache}, shared by the compressors of all the
+ * channels, the compressed content is reused for the same content, keyed by
+ * the URI and the strong <tt>"ETag"</tt> of the response, which must change
+ * with the content, or by the digest of the content without it, then checked
+ * against the digest too.
+ *
+ * The chunks of a response are compressed as they come, each one is flushed,
+ * so the client can inflate it without waiting for the rest, and the response
+ * is sent in <tt>chunked</tt> transfer encoding, as its length is unknown.
+ * The chunks of a response to a HTTP/1.0 request are not compressed.
+ *
+ * @author <a href="http://gleamynode.net/">Trustin Lee</a>
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class HttpContentCompressor : private boost::noncopyable {
+public:
+    typedef MessageToMessageCodec<HttpContentCompressor,
+            HttpPackage,
+            HttpPackage,
+            HttpPackage,
+            HttpPackage> Codec;
+
+    typedef Codec::Context Context;
+    typedef Codec::Handler Handler;
+    typedef Codec::HandlerPtr HandlerPtr;
+
+    enum ZlibWrapper {
+        NONE,
+
+        /**
+         * the <tt>deflate</tt> content encoding, the zlib format of RFC 1950.
+         */
+        ZLIB,
+
+        /**
+         * the <tt>gzip</tt> content encoding of RFC 1952.
+         */
+        GZIP
+    };
+
+    static const int DEFAULT_COMPRESSION_LEVEL = 6;
+    static const int DEFAULT_MIN_CONTENT_LENGTH = 1024;
+
+public:
+    /**
+     * Creates a new instance with the default compression level (<tt>6</tt>).
+     */
+    HttpContentCompressor();
+
+    /**
+     * Creates a new instance with the specified compression level.
+     *
+     * @param compressionLevel
+     *        <tt>1</tt> yields the fastest compression and <tt>9</tt> yields the
+     *        best compression.  <tt>0</tt> means no compression.
+     */
+    HttpContentCompressor(int compressionLevel);
+
+    ~HttpContentCompressor();
+
+    int compressionLevel() const {
+        return compressionLevel_;
+    }
+
+    /**
+     * Returns the minimum length of the content to be compressed,
+     * <tt>1024</tt> by default.  The content of a chunked response without
+     * <tt>"Content-Length"</tt> is always compressed.
+     */
+    int minContentLength() const {
+        return minContentLength_;
+    }
+
+    void setMinContentLength(int minContentLength);
+
+    /**
+     * Returns the media types of the content to be compressed, a type ending
+     * with <tt>'/'</tt>, like <tt>"text/"</tt>, matches all its subtypes.
+     * By default, they are the text, JSON, JavaScript, XML and SVG types.
+     */
+    const std::vector<std::string>& compressibleContentTypes() const {
+        return contentTypes_;
+    }
+
+    void setCompressibleContentTypes(const std::vector<std::string>& types) {
+        contentTypes_ = types;
+    }
+
+    void addCompressibleContentType(const std::string& type) {
+        contentTypes_.push_back(type);
+    }
+
+    /**
+     * Returns <tt>true</tt> if the content of the <tt>"Content-Type"</tt>
+     * is one of the {@link #compressibleContentTypes()}.
+     */
+    bool isCompressible(const StringPiece& contentType) const;
+
+    const HttpCompressedContentCachePtr& cache() const {
+        return cache_;
+    }
+
+    /**
+     * Sets the cache of the compressed content, no cache by default.
+     */
+    void setCache(const HttpCompressedContentCachePtr& cache) {
+        cache_ = cache;
+    }
+
+    void registerTo(Context& ctx) {
+        codec_.registerTo(ctx);
+    }
+
+    /**
+     * Returns the wrapper of the content encoding preferred by the
+     * <tt>"Accept-Encoding"</tt>, or {@link #NONE}.
+     */
+    static ZlibWrapper determineWrapper(const StringPiece& acceptEncoding);
+
+private:
+    struct Request {
+        ZlibWrapper wrapper;
+        bool head;
+        bool http10;
+        std::string uri;
+
+        Request(ZlibWrapper wrapper, bool head, bool http10)
+            : wrapper(wrapper), head(head), http10(http10) {}
+    };
+
+    void init();
+
+    HttpPackage decode(ChannelHandlerContext& ctx, const HttpPackage& msg);
+    HttpPackage encode(ChannelHandlerContext& ctx, const HttpPackage& msg);
+
+    HttpPackage encodeResponse(ChannelHandlerContext& ctx, const HttpPackage& msg);
+    HttpPackage encodeChunk(ChannelHandlerContext& ctx, const HttpPackage& msg);
+
+    bool isEncodable(const Request& request, const HttpPackage& msg) const;
+
+    ChannelBufferPtr compress(const Request& request, const HttpResponsePtr& response);
+    ChannelBufferPtr compress(const StringPiece& bytes);
+
+    void beginStream(ZlibWrapper wrapper);
+    void finishStream(ChannelHandlerContext& ctx);
+
+    void deflate(const ChannelBufferPtr& out, int flush);
+
+private:
+    int compressionLevel_;
+    int minContentLength_;
+
+    std::vector<std::string> contentTypes_;
+    HttpCompressedContentCachePtr cache_;
+
+    // the requests not responded yet, for the HTTP pipelining.
+    std::deque<Request> requests_;
+
+    // reused by all the responses of the channel, as the deflate state is
+    // a few hundreds KB, allocated and freed per response costs more.
+    z_stream_s* stream_;
+    ZlibWrapper streamWrapper_;
+    bool streaming_;
+
+    Codec codec_;
+};
+
+}
+}
+}
+}
+
+#endif //#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPCONTENTCOMPRESSOR_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,147 @@
+#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPHEADERSCANNER_H)
+#define CETTY_HANDLER_CODEC_HTTP_HTTPHEADERSCANNER_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cetty/util/StringPiece.h>
+
+namespace cetty {
+namespace handler {
+namespace codec {
+namespace http {
+
+using namespace cetty::util;
+
+/**
+ * Scans a whole HTTP header block, the initial line and the headers up to
+ * the empty line, in one pass over a contiguous memory region.
+ *
+ * The line ends and the header colons are searched 32 (AVX2) or 16 (SSE4.2)
+ * bytes at a time, the implementation is selected by the CPU at runtime and
+ * the plain byte loop is the fallback everywhere else.
+ *
+ * Only the common well formed blocks are handled here. Anything unusual,
+ * folded header values, a bare CR, a header line without colon or too many
+ * headers, is reported as {@link #UNSUPPORTED} and left to the line by line
+ * decoding of {@link HttpPackageDecoder}, which keeps the final word on the
+ * syntax.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class HttpHeaderScanner {
+public:
+    enum Implementation {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    enum Status {
+        /**
+         * the header block is not complete yet.
+         */
+        INCOMPLETE  = 0,
+
+        /**
+         * the header block should be decoded line by line.
+         */
+        UNSUPPORTED = -1
+    };
+
+    static const int MAX_HEADER_COUNT = 64;
+
+    struct Header {
+        StringPiece name;
+        StringPiece value;
+    };
+
+    /**
+     * The views into the scanned bytes.
+     */
+    struct Block {
+        StringPiece initialLine[3];
+
+        /**
+         * the bytes of the initial line, including the line end.
+         */
+        int initialLineSize;
+
+        int headerCount;
+        Header headers[MAX_HEADER_COUNT];
+    };
+
+public:
+    /**
+     * Creates a scanner with the fastest implementation of this CPU.
+     */
+    HttpHeaderScanner();
+
+    /**
+     * Creates a scanner with the specified implementation, or the scalar one
+     * if this CPU does not support it.
+     */
+    explicit HttpHeaderScanner(Implementation implementation);
+
+    Implementation implementation() const {
+        return implementation_;
+    }
+
+    /**
+     * Scans the header block at the beginning of <tt>bytes</tt>.
+     *
+     * @return the size of the whole header block, including the empty line,
+     *         or {@link #INCOMPLETE}, or {@link #UNSUPPORTED}.
+     */
+    int scan(const char* bytes, int length, Block* block) const;
+
+    static bool isSupported(Implementation implementation);
+    static Implementation bestImplementation();
+    static const char* implementationName(Implementation implementation);
+
+private:
+    /**
+     * @return the first CR or LF in [begin, end), or <tt>end</tt>.
+     */
+    typedef const char* (*LineEndFinder)(const char* begin, const char* end);
+
+    /**
+     * @return the first ':', CR or LF in [begin, end), or <tt>end</tt>.
+     */
+    typedef const char* (*DelimiterFinder)(const char* begin, const char* end);
+
+    void init(Implementation implementation);
+
+    int scanLineEnd(const char* lineEnd, const char* end) const;
+    bool splitInitialLine(const char* begin, const char* end, Block* block) const;
+
+private:
+    Implementation implementation_;
+    LineEndFinder findLineEnd_;
+    DelimiterFinder findDelimiter_;
+};
+
+}
+}
+}
+}
+
+#endif //#if !defined(CETTY_HANDLER_CODEC_HTTP_HTTPHEADERSCANNER_H)
+
+// Local Variables:
+// mode: c++
+// End:
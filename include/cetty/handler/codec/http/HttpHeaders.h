@@ -23,7 +23,8 @@
 
 #include <string>
 #include <vector>
-#include <cetty/util/NameValueCollection.h>
+#include <cetty/util/StringPiece.h>
+#include <cetty/util/SmallVector.h>
 #include <cetty/handler/codec/http/Cookie.h>
 #include <cetty/handler/codec/http/HttpVersion.h>
 #include <cetty/handler/codec/http/HttpTransferEncoding.h>
@@ -456,14 +457,174 @@ public:
     };
 
 public:
-    typedef NameValueCollection::ConstIterator ConstHeaderIterator;
+    /**
+     * The ids of the standard header names in {@link Names}, in the same
+     * order.  The headers with these names are stored and found by the id,
+     * without keeping or comparing the name.
+     */
+    enum HeaderId {
+        HEADER_UNKNOWN = -1,
+        HEADER_ACCEPT,
+        HEADER_ACCEPT_CHARSET,
+        HEADER_ACCEPT_ENCODING,
+        HEADER_ACCEPT_LANGUAGE,
+        HEADER_ACCEPT_RANGES,
+        HEADER_ACCEPT_PATCH,
+        HEADER_AGE,
+        HEADER_ALLOW,
+        HEADER_AUTHORIZATION,
+        HEADER_CACHE_CONTROL,
+        HEADER_CONNECTION,
+        HEADER_CONTENT_BASE,
+        HEADER_CONTENT_ENCODING,
+        HEADER_CONTENT_LANGUAGE,
+        HEADER_CONTENT_LENGTH,
+        HEADER_CONTENT_LOCATION,
+        HEADER_CONTENT_TRANSFER_ENCODING,
+        HEADER_CONTENT_MD5,
+        HEADER_CONTENT_RANGE,
+        HEADER_CONTENT_TYPE,
+        HEADER_COOKIE,
+        HEADER_DATE,
+        HEADER_ETAG,
+        HEADER_EXPECT,
+        HEADER_EXPIRES,
+        HEADER_FROM,
+        HEADER_HOST,
+        HEADER_IF_MATCH,
+        HEADER_IF_MODIFIED_SINCE,
+        HEADER_IF_NONE_MATCH,
+        HEADER_IF_RANGE,
+        HEADER_IF_UNMODIFIED_SINCE,
+        HEADER_LAST_MODIFIED,
+        HEADER_LOCATION,
+        HEADER_MAX_FORWARDS,
+        HEADER_ORIGIN,
+        HEADER_PRAGMA,
+        HEADER_PROXY_AUTHENTICATE,
+        HEADER_PROXY_AUTHORIZATION,
+        HEADER_RANGE,
+        HEADER_REFERER,
+        HEADER_RETRY_AFTER,
+        HEADER_SEC_WEBSOCKET_KEY1,
+        HEADER_SEC_WEBSOCKET_KEY2,
+        HEADER_SEC_WEBSOCKET_LOCATION,
+        HEADER_SEC_WEBSOCKET_ORIGIN,
+        HEADER_SEC_WEBSOCKET_PROTOCOL,
+        HEADER_SEC_WEBSOCKET_VERSION,
+        HEADER_SEC_WEBSOCKET_KEY,
+        HEADER_SEC_WEBSOCKET_ACCEPT,
+        HEADER_SERVER,
+        HEADER_SET_COOKIE,
+        HEADER_SET_COOKIE2,
+        HEADER_TE,
+        HEADER_TRAILER,
+        HEADER_TRANSFER_ENCODING,
+        HEADER_UPGRADE,
+        HEADER_USER_AGENT,
+        HEADER_VARY,
+        HEADER_VIA,
+        HEADER_WARNING,
+        HEADER_WEBSOCKET_LOCATION,
+        HEADER_WEBSOCKET_ORIGIN,
+        HEADER_WEBSOCKET_PROTOCOL,
+        HEADER_WWW_AUTHENTICATE,
+        HEADER_COUNT
+    };
+
+    /**
+     * the id of the standard header <tt>name</tt>, case insensitive, or
+     * {@link #HEADER_UNKNOWN}.
+     */
+    static HeaderId headerId(const StringPiece& name);
+
+    /**
+     * the name in {@link Names} of the <tt>id</tt>.
+     */
+    static const std::string& headerName(HeaderId id);
+
+private:
+    // the header names and values are kept in the bytes_ of the headers,
+    // the standard names are not kept at all.
+    struct Header {
+        int id;
+        int nameOffset;
+        int nameLength;
+        int valueOffset;
+        int valueLength;
+    };
+
+    static const int INLINE_HEADER_COUNT = 16;
+    static const int INLINE_HEADER_BYTES = 1024;
+
+    typedef SmallVector<Header, INLINE_HEADER_COUNT> HeaderList;
+    typedef SmallVector<char, INLINE_HEADER_BYTES> HeaderBytes;
+
+public:
+    /**
+     * Iterates the headers in the order added, the names and the values are
+     * the views of the bytes kept in the {@link HttpHeaders}, which are valid
+     * till the headers change.
+     */
+    class ConstHeaderIterator {
+    public:
+        ConstHeaderIterator()
+            : headers_(NULL), index_(0) {}
+
+        ConstHeaderIterator(const HttpHeaders* headers, int index)
+            : headers_(headers), index_(index) {}
+
+        HeaderId id() const {
+            return static_cast<HeaderId>(header().id);
+        }
+
+        StringPiece name() const {
+            return headers_->nameOf(header());
+        }
+
+        StringPiece value() const {
+            return headers_->valueOf(header());
+        }
+
+        ConstHeaderIterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        ConstHeaderIterator operator++(int) {
+            ConstHeaderIterator itr(*this);
+            ++index_;
+            return itr;
+        }
+
+        bool operator==(const ConstHeaderIterator& itr) const {
+            return headers_ == itr.headers_ && index_ == itr.index_;
+        }
+
+        bool operator!=(const ConstHeaderIterator& itr) const {
+            return !(*this == itr);
+        }
+
+    private:
+        const Header& header() const {
+            return headers_->headers_[index_];
+        }
+
+    private:
+        const HttpHeaders* headers_;
+        int index_;
+    };
 
 public:
     HttpHeaders()
         : transferEncoding_(HttpTransferEncoding::SINGLE) {}
 
-    bool hasHeader(const std::string& name) const {
-        return headers_.has(name);
+    bool hasHeader(HeaderId id) const {
+        return find(id, StringPiece()) >= 0;
+    }
+
+    bool hasHeader(const StringPiece& name) const {
+        return find(headerId(name), name) >= 0;
     }
 
     /**
@@ -471,10 +632,14 @@ public:
      * more than one header value for the specified header name, the first
      * value is returned.
      *
-     * @return the header value or <tt>null</tt> if there is no such header
+     * @return the header value or an empty one if there is no such header
      */
-    const std::string& headerValue(const std::string& name) const {
-        return headers_.get(name);
+    StringPiece headerValue(HeaderId id) const {
+        return headerValue(id, StringPiece());
+    }
+
+    StringPiece headerValue(const StringPiece& name) const {
+        return headerValue(name, StringPiece());
     }
 
     /**
@@ -485,9 +650,15 @@ public:
      * @return the header value or the <tt>defaultValue</tt> if there is no such
      *         header
      */
-    const std::string& headerValue(const std::string& name,
-                                   const std::string& defaultValue) const {
-        return headers_.get(name, defaultValue);
+    StringPiece headerValue(HeaderId id, const StringPiece& defaultValue) const {
+        int index = find(id, StringPiece());
+        return index < 0 ? defaultValue : valueOf(headers_[index]);
+    }
+
+    StringPiece headerValue(const StringPiece& name,
+                            const StringPiece& defaultValue) const {
+        int index = find(headerId(name), name);
+        return index < 0 ? defaultValue : valueOf(headers_[index]);
     }
 
     /**
@@ -495,19 +666,10 @@ public:
      * there are more than one header value for the specified header name, the
      * first value is returned.
      *
-     * @return the header value
-     * @throws NumberFormatException
-     *         if there is no such header or the header value is not a number
+     * @return the header value, 0 if there is no such header
      */
-    int headerIntValue(const std::string& name) {
-        const std::string& value = headers_.get(name);
-
-        if (!value.empty()) {
-            return StringUtil::strto32(value);
-        }
-        else {
-            return 0;
-        }
+    int headerIntValue(const StringPiece& name) const {
+        return headerIntValue(name, 0);
     }
 
     /**
@@ -518,15 +680,12 @@ public:
      * @return the header value or the <tt>defaultValue</tt> if there is no such
      *         header or the header value is not a number
      */
-    int headerIntValue(const std::string& name, int defaultValue) {
-        const std::string& value = headers_.get(name);
+    int headerIntValue(HeaderId id, int defaultValue) const {
+        return intValue(headerValue(id), defaultValue);
+    }
 
-        if (!value.empty() && StringUtil::isDigits(value)) {
-            return StringUtil::strto32(value);
-        }
-        else {
-            return defaultValue;
-        }
+    int headerIntValue(const StringPiece& name, int defaultValue) const {
+        return intValue(headerValue(name), defaultValue);
     }
 
     /**
@@ -537,90 +696,94 @@ public:
     *               An empty list if there is no such header.
     *
     */
-    void headerValues(const std::string& name, std::vector<std::string>* headers) const {
-        if (headers) {
-            headers_.get(name, headers);
-        }
-    }
+    void headerValues(const StringPiece& name,
+                      std::vector<std::string>* values) const;
 
     /**
     * Get the all header names and values that this message contains.
-    *
-    * @param nameValues The {@link NameValueList} of the header name-value pairs.
-    *                   An empty list if there is no header in this message.
     */
     ConstHeaderIterator firstHeader() const {
-        return headers_.begin();
+        return ConstHeaderIterator(this, 0);
     }
 
     ConstHeaderIterator lastHeader() const {
-        return headers_.end();
+        return ConstHeaderIterator(this, headers_.size());
+    }
+
+    int headerCount() const {
+        return headers_.size();
     }
 
     /**
     * Returns <tt>true</tt> if and only if there is a header with the specified
     * header name.
     */
-    bool containsHeader(const std::string& name) const {
-        return headers_.has(name);
+    bool containsHeader(HeaderId id) const {
+        return hasHeader(id);
+    }
+
+    bool containsHeader(const StringPiece& name) const {
+        return hasHeader(name);
     }
 
     /**
     * Get the {@link StringList} of all header names that this message contains.
     */
-    void headerNames(std::vector<std::string>* names) const {
-        headers_.getNames(names);
-    }
+    void headerNames(std::vector<std::string>* names) const;
 
     /**
     * Adds a new header with the specified name and string value.
     */
-    void addHeader(const std::string& name, int value) {
-        headers_.add(name, StringUtil::numtostr(value));
-    }
+    void addHeader(const StringPiece& name, int value);
 
     /**
     * Adds a new header with the specified name and string value.
     */
-    void addHeader(const std::string& name, const std::string& value) {
-        headers_.add(name, value);
+    void addHeader(HeaderId id, const StringPiece& value) {
+        add(id, StringPiece(), value);
+    }
+
+    void addHeader(const StringPiece& name, const StringPiece& value) {
+        add(headerId(name), name, value);
     }
 
     /**
     * Adds a new header with the specified name and int value.
     */
-    void setHeader(const std::string& name, int value) {
-        headers_.set(name, StringUtil::numtostr(value));
+    void setHeader(const StringPiece& name, int value);
+
+    void setHeader(HeaderId id, const StringPiece& value) {
+        set(id, StringPiece(), value);
     }
 
-    void setHeader(const std::string& name, const std::string& value) {
-        headers_.set(name, value);
+    void setHeader(const StringPiece& name, const StringPiece& value) {
+        set(headerId(name), name, value);
     }
 
     /**
     * Sets a new header with the specified name and values.  If there is an
     * existing header with the same name, the existing header is removed.
     */
-    void setHeader(const std::string& name, const std::vector<std::string>& values) {
-        headers_.set(name, values.begin(), values.end());
-    }
+    void setHeader(const StringPiece& name, const std::vector<std::string>& values);
 
-    void setHeader(const std::string& name, const std::vector<int>& values);
+    void setHeader(const StringPiece& name, const std::vector<int>& values);
 
     /**
     * Removes the header with the specified name.
     */
-    void removeHeader(const std::string& name) {
-        headers_.erase(name);
+    void removeHeader(HeaderId id) {
+        remove(id, StringPiece(), NULL);
+    }
+
+    void removeHeader(const StringPiece& name) {
+        remove(headerId(name), name, NULL);
     }
 
     /**
     * Removes the header with the specified name and value.
-    * If only one value with the name, then move the name item completely,
-    * otherwise only remove the value.
     */
-    void removeHeader(const std::string& name, const std::string& value) {
-        headers_.erase(name, value);
+    void removeHeader(const StringPiece& name, const StringPiece& value) {
+        remove(headerId(name), name, &value);
     }
 
     /**
@@ -628,7 +791,9 @@ public:
     */
     void clear() {
         headers_.clear();
+        bytes_.clear();
         cookies_.clear();
+        transferEncoding_ = HttpTransferEncoding::SINGLE;
     }
 
     /**
@@ -680,18 +845,18 @@ public:
     /**
      * Returns the value of the <tt>"Host"</tt> header.
      */
-    const std::string& host() const;
+    StringPiece host() const;
 
     /**
      * Returns the value of the <tt>"Host"</tt> header.  If there is no such
      * header, the <tt>defaultValue</tt> is returned.
      */
-    const std::string& host(const std::string& defaultValue) const;
+    StringPiece host(const StringPiece& defaultValue) const;
 
     /**
      * Sets the <tt>"Host"</tt> header.
      */
-    void setHost(const std::string& value);
+    void setHost(const StringPiece& value);
 
     /**
      * Returns the transfer encoding of this {@link HttpMessage}.
@@ -730,7 +895,32 @@ public:
     void toString(std::string* str) const;
 
 private:
-    NameValueCollection headers_;
+    int find(HeaderId id, const StringPiece& name) const;
+
+    void add(HeaderId id, const StringPiece& name, const StringPiece& value);
+    void set(HeaderId id, const StringPiece& name, const StringPiece& value);
+    void remove(HeaderId id, const StringPiece& name, const StringPiece* value);
+
+    // whether the piece refers to the bytes_, e.g. a value got from the
+    // headers, which move when the bytes_ grow or are compacted.
+    bool inBytes(const StringPiece& piece) const {
+        return !piece.empty()
+               && piece.data() >= bytes_.data()
+               && piece.data() < bytes_.data() + bytes_.size();
+    }
+
+    StringPiece nameOf(const Header& header) const;
+
+    StringPiece valueOf(const Header& header) const {
+        return StringPiece(bytes_.data() + header.valueOffset,
+                           header.valueLength);
+    }
+
+    static int intValue(const StringPiece& value, int defaultValue);
+
+private:
+    HeaderList headers_;
+    HeaderBytes bytes_;
     HttpTransferEncoding transferEncoding_;
 
     mutable std::vector<Cookie> cookies_;
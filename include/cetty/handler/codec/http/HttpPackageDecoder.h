@@ -28,6 +28,7 @@
 
 #include <cetty/handler/codec/http/HttpPackage.h>
 #include <cetty/handler/codec/http/HttpChunkTrailer.h>
+#include <cetty/handler/codec/http/HttpHeaderScanner.h>
 
 #include <cetty/util/StringPiece.h>
 
@@ -199,6 +200,15 @@ public:
        httpPackageCreator_ = creator;
     }
 
+    /**
+     * Sets whether a header block, which is complete in the readable bytes,
+     * is scanned in one pass by the {@link HttpHeaderScanner} instead of
+     * line by line. It is enabled by default.
+     */
+    void setHeaderBlockScan(bool enabled) {
+        headerBlockScan_ = enabled;
+    }
+
     bool isContentAlwaysEmpty(const HttpPackage& msg) const;
 
     // if has an exception, reply an error message.
@@ -210,6 +220,22 @@ public:
 private:
     HttpPackage reset();
 
+    /**
+     * The bytes already searched for the end of an incomplete header block
+     * are not searched again when more bytes arrive.
+     *
+     * @return the state after the headers, or <tt>READ_INITIAL</tt> if more
+     *         bytes are needed, or -1 if the header block has to be decoded
+     *         line by line.
+     *
+     * @throws TooLongFrameException if the initial line is too long.
+     */
+    int scanHeaderBlock(const ReplayingDecoderBufferPtr& buffer);
+
+    int contentState();
+    HttpPackage headersDecoded(const ReplayingDecoderBufferPtr& buffer,
+                               int nextState);
+
     bool skipControlCharacters(const ReplayingDecoderBufferPtr& buffer) const;
     HttpPackage readFixedLengthContent(const ReplayingDecoderBufferPtr& buffer);
 
@@ -231,7 +257,7 @@ private:
      * @return true can read out a line completely. false means need to read more bytes.
      */
     bool splitInitialLine(StringPiece& sb, std::vector<StringPiece>* lines);
-    void splitHeader(StringPiece& sb, std::vector<StringPiece>* header);
+    void splitHeader(const StringPiece& sb, StringPiece* name, StringPiece* value);
 
     int findNonWhitespace(const StringPiece& sb, int offset);
     int findWhitespace(const StringPiece& sb, int offset);
@@ -254,6 +280,10 @@ private:
 
     int contentRead_;
 
+    bool headerBlockScan_;
+    int headerBlockScanned_;
+    HttpHeaderScanner headerScanner_;
+
     HttpPackage message_;
     ChannelBufferPtr content_;
 
@@ -98,8 +98,8 @@ private:
 
     // header and value has been validated when added to the HttpHeader.
     void encodeHeader(ChannelBuffer& buf,
-                      const std::string& header,
-                      const std::string& value);
+                      const StringPiece& header,
+                      const StringPiece& value);
 
 private:
     HttpTransferEncoding lastTE_;
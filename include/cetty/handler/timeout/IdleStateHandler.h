@@ -21,6 +21,7 @@
  * Distributed under under the Apache License, version 2.0 (the "License").
  */
 
+#include <list>
 #include <boost/function.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
 
@@ -37,6 +38,7 @@ using namespace cetty::util;
 
 class IdleState;
 class IdleStateEvent;
+class IdleStateSweeper;
 
 /**
  * Triggers an {@link IdleStateEvent} when a {@link Channel} has not performed
@@ -111,6 +113,16 @@ class IdleStateEvent;
  * created should be stopped manually by calling {@link #releaseExternalResources()}
  * or {@link Timer#stop()} when your application shuts down.
  *
+ * <h3>Sweeping mode</h3>
+ * By default every handler schedules up to three {@link Timeout}s in the
+ * {@link EventLoop}.  When {@link #setSweepInterval} is set, the handler
+ * only stamps the last read and write time, and one sweeper of every
+ * {@link EventLoop} checks all the handlers of the loop every
+ * <tt>sweepInterval</tt> milliseconds, and fires the {@link IdleStateEvent}s
+ * from there.  The idle events may be delayed at most one
+ * <tt>sweepInterval</tt>, which suits lots of connections with long idle
+ * times.
+ *
  *
  * @author <a href="http://gleamynode.net/">Trustin Lee</a>
  * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
@@ -206,6 +218,21 @@ public:
         return allIdleTimeMillis_;
     }
 
+    /**
+     * the interval in milliseconds of the sweeper checking the idle
+     * states, 0 (default) means using the timeouts of the {@link EventLoop}.
+     * Only takes effect before the handler initialized.
+     */
+    int64_t sweepIntervalInMillis() const {
+        return sweepIntervalMillis_;
+    }
+
+    void setSweepInterval(int64_t milliseconds) {
+        if (state_ == 0) {
+            sweepIntervalMillis_ = milliseconds > 0 ? milliseconds : 0;
+        }
+    }
+
     void setIdleEventCallback(const IdleEventCallback& idleEventCallback) {
         if (idleEventCallback) {
             this->idleEventCallback_ = idleEventCallback;
@@ -262,6 +289,17 @@ private:
     void handleWriterIdleTimeout(ChannelHandlerContext& ctx);
     void handleAllIdleTimeout(ChannelHandlerContext& ctx);
 
+    void fireIdle(ChannelHandlerContext& ctx,
+                  const IdleState& state,
+                  int count,
+                  const Duration& idleTime);
+
+private:
+    friend class IdleStateSweeper;
+
+    // the sweeping mode.
+    void sweep(const Time& currentTime);
+
 private:
     typedef boost::function0<void> TimerCallback;
 
@@ -288,6 +326,15 @@ private:
 
     int state_; // 0 - none, 1 - initialized, 2 - destroyed
 
+    int64_t sweepIntervalMillis_;
+    Time readerIdleDeadline_;
+    Time writerIdleDeadline_;
+    Time allIdleDeadline_;
+
+    ChannelHandlerContext* ctx_;
+    IdleStateSweeper* sweeper_;
+    std::list<IdleStateHandler*>::iterator sweeperItr_;
+
     IdleEventCallback idleEventCallback_;
 };
 
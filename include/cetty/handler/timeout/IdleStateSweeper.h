@@ -0,0 +1,101 @@
+#if !defined(CETTY_HANDLER_TIMEOUT_IDLESTATESWEEPER_H)
+#define CETTY_HANDLER_TIMEOUT_IDLESTATESWEEPER_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <list>
+#include <boost/noncopyable.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/channel/TimeoutPtr.h>
+#include <cetty/channel/EventLoopPtr.h>
+
+namespace cetty {
+namespace handler {
+namespace timeout {
+
+using namespace cetty::channel;
+
+class IdleStateHandler;
+
+/**
+ * Checks the idle states of all the sweeping mode {@link IdleStateHandler}s
+ * of an {@link EventLoop}, lives in the thread of the {@link EventLoop}.
+ *
+ * The sweeper wakes up every {@link #interval()} milliseconds, which is the
+ * shortest {@link IdleStateHandler#sweepIntervalInMillis()} of the handlers
+ * added, and sleeps when there is no handler.
+ */
+class IdleStateSweeper : private boost::noncopyable {
+public:
+    typedef std::list<IdleStateHandler*> Handlers;
+
+public:
+    IdleStateSweeper(const EventLoopPtr& eventLoop);
+    ~IdleStateSweeper();
+
+    /**
+     * the sweeper of the current thread, created at the first time.
+     */
+    static IdleStateSweeper* current(const EventLoopPtr& eventLoop);
+
+    Handlers::iterator add(IdleStateHandler* handler);
+    void remove(Handlers::iterator itr);
+
+    /**
+     * the current sweep interval in milliseconds, 0 if no handler.
+     */
+    int64_t interval() const;
+
+    int handlerCount() const;
+
+private:
+    void schedule();
+    void sweep();
+
+    int64_t shortestInterval() const;
+
+private:
+    bool sweeping_;
+    int64_t interval_;
+
+    EventLoopPtr eventLoop_;
+    TimeoutPtr timeout_;
+
+    Handlers handlers_;
+    Handlers::iterator next_;
+};
+
+inline
+int64_t IdleStateSweeper::interval() const {
+    return interval_;
+}
+
+inline
+int IdleStateSweeper::handlerCount() const {
+    return static_cast<int>(handlers_.size());
+}
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_HANDLER_TIMEOUT_IDLESTATESWEEPER_H)
+
+// Local Variables:
+// mode: c++
+// End:
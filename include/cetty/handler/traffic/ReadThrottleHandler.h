@@ -0,0 +1,104 @@
+#if !defined(CETTY_HANDLER_TRAFFIC_READTHROTTLEHANDLER_H)
+#define CETTY_HANDLER_TRAFFIC_READTHROTTLEHANDLER_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <cetty/channel/ChannelPtr.h>
+#include <cetty/channel/ChannelStateHandler.h>
+
+namespace cetty {
+namespace handler {
+namespace traffic {
+
+using namespace cetty::channel;
+
+/**
+ * Keeps the memory bounded in the proxies, where the bytes read from the
+ * source channels are written to a target channel.
+ *
+ * Add the handler to the pipeline of the target channel, and call
+ * {@link #throttle(const ChannelPtr&)} with the source channel after
+ * writing to the target.  When the target is not
+ * {@link Channel#isWritable() writable}, the <tt>autoRead</tt> of the
+ * source is paused, and resumed after the target becomes writable again or
+ * inactive.
+ *
+ * <pre>
+ * ReadThrottleHandler::HandlerPtr throttle(new ReadThrottleHandler);
+ * outboundPipeline.addLast<ReadThrottleHandler::Handler>("throttle", throttle);
+ * ...
+ * outboundChannel->flush();
+ * throttle->throttle(inboundChannel);
+ * </pre>
+ *
+ * The source channels may be in the other {@link EventLoop}s than the
+ * target, the pausing and resuming are posted to their own ones.
+ */
+class ReadThrottleHandler : private boost::noncopyable {
+public:
+    typedef ChannelStateHandler<ReadThrottleHandler>::Context Context;
+    typedef Context::Handler Handler;
+    typedef Context::HandlerPtr HandlerPtr;
+
+public:
+    ReadThrottleHandler();
+    ~ReadThrottleHandler();
+
+    /**
+     * pauses the <tt>autoRead</tt> of the <tt>source</tt> if the target
+     * channel is not writable now.
+     *
+     * @return true if the source has been paused.
+     */
+    bool throttle(const ChannelPtr& source);
+
+    /**
+     * the count of the source channels paused now.
+     */
+    int pausedCount() const;
+
+    void registerTo(Context& ctx);
+
+private:
+    void writabilityChanged(ChannelHandlerContext& ctx);
+    void channelInactive(ChannelHandlerContext& ctx);
+
+    void resumeAll();
+
+    static void pause(const ChannelPtr& source);
+    static void resume(const ChannelPtr& source);
+
+private:
+    Context* context_;
+
+    mutable boost::mutex mutex_;
+    std::vector<ChannelPtr> pausedChannels_;
+};
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_HANDLER_TRAFFIC_READTHROTTLEHANDLER_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,217 @@
+#if !defined(CETTY_LOGGING_LOGASYNCSINK_H)
+#define CETTY_LOGGING_LOGASYNCSINK_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <vector>
+#include <string>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/util/Enum.h>
+#include <cetty/util/Atomic.h>
+#include <cetty/logging/LogSink.h>
+
+namespace cetty {
+namespace logging {
+
+class LogRingBuffer;
+class LogRingBufferHolder;
+
+/**
+ * A {@link LogSink} which moves the writing of the messages out of the
+ * logging threads.
+ *
+ * Every logging thread copies its formatted messages into its own
+ * lock-free single producer / single consumer ring buffer, a background
+ * thread drains all the ring buffers every <tt>flushInterval</tt>
+ * milliseconds (or earlier when a ring buffer is half full), and writes
+ * the messages to the wrapped sinks in one batch, e.g. one
+ * <tt>fwrite</tt> for a {@link LogFileSink}.
+ *
+ * When a ring buffer is full, the message is dropped or the logging thread
+ * waits for the background thread, according to the {@link OverflowPolicy}.
+ * The dropped messages are counted, and reported to the wrapped sinks.
+ *
+ * The order of the messages from different threads is not kept, messages
+ * of the same thread are written in order.
+ *
+ * <pre>
+ * Logger::addLogSink(new LogAsyncSink(new LogFileSink("server")));
+ * </pre>
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class LogAsyncSink : public LogSink {
+public:
+    class OverflowPolicy : public cetty::util::Enum<OverflowPolicy> {
+    public:
+        /**
+         * drop the message when the ring buffer is full.
+         */
+        static OverflowPolicy DROP;
+
+        /**
+         * the logging thread waits until the ring buffer has room.
+         */
+        static OverflowPolicy BLOCK;
+
+    private:
+        OverflowPolicy(int value, const char* name);
+    };
+
+    static const int DEFAULT_RING_BUFFER_SIZE = 1024 * 1024;
+    static const int DEFAULT_FLUSH_INTERVAL = 1000;
+
+public:
+    /**
+     * Creates the sink and starts its background thread.
+     */
+    LogAsyncSink(const LogSinkPtr& sink);
+
+    LogAsyncSink(const LogSinkPtr& sink,
+                 int ringBufferSize,
+                 const OverflowPolicy& policy,
+                 int flushInterval);
+
+    virtual ~LogAsyncSink();
+
+    /**
+     * Adds another sink the messages will be written to.
+     */
+    void addLogSink(const LogSinkPtr& sink);
+
+    /**
+     * Drains all the pending messages and stops the background thread.
+     * Messages logged after stopped will be written synchronously.
+     */
+    void stop();
+
+    /**
+     * the size in bytes of the ring buffer of every logging thread.
+     */
+    int ringBufferSize() const;
+
+    const OverflowPolicy& overflowPolicy() const;
+
+    /**
+     * the interval in milliseconds the background thread drains and
+     * flushes the messages.
+     */
+    int flushInterval() const;
+
+    /**
+     * messages dropped because the ring buffers were full.
+     */
+    int64_t droppedCount() const;
+
+    /**
+     * times the logging threads waited for the ring buffers,
+     * only in the {@link OverflowPolicy#BLOCK} policy.
+     */
+    int64_t blockedCount() const;
+
+    /**
+     * messages which have been written to the wrapped sinks.
+     */
+    int64_t writtenCount() const;
+
+protected:
+    virtual void doSink(const LogMessage& msg);
+    virtual void doSink(const char* messages, int size);
+    virtual void doFlush();
+
+private:
+    void init();
+    void run();
+    void wakeup();
+    void drain();
+    void writeBatches(bool flush);
+
+    LogRingBuffer* currentRingBuffer();
+
+private:
+    typedef boost::shared_ptr<LogRingBuffer> LogRingBufferPtr;
+
+    int ringBufferSize_;
+    int flushInterval_;
+    OverflowPolicy policy_;
+
+    cetty::util::Atomic<int> stopped_;
+    cetty::util::Atomic<int> wakeupPending_;
+
+    cetty::util::Atomic<int64_t> droppedCount_;
+    cetty::util::Atomic<int64_t> blockedCount_;
+    cetty::util::Atomic<int64_t> writtenCount_;
+    int64_t reportedDroppedCount_;
+
+    boost::mutex mutex_;
+    boost::condition_variable cond_;
+    boost::scoped_ptr<boost::thread> thread_;
+
+    // guards the ring buffers registration.
+    boost::mutex ringBuffersMutex_;
+    std::vector<LogRingBufferPtr> ringBuffers_;
+    boost::thread_specific_ptr<LogRingBufferHolder> threadRingBuffer_;
+
+    // only one consumer drains the ring buffers at a time.
+    boost::mutex drainMutex_;
+    std::vector<LogSinkPtr> sinks_;
+    std::vector<std::string> batches_;
+};
+
+inline
+int LogAsyncSink::ringBufferSize() const {
+    return ringBufferSize_;
+}
+
+inline
+const LogAsyncSink::OverflowPolicy& LogAsyncSink::overflowPolicy() const {
+    return policy_;
+}
+
+inline
+int LogAsyncSink::flushInterval() const {
+    return flushInterval_;
+}
+
+inline
+int64_t LogAsyncSink::droppedCount() const {
+    return droppedCount_.get();
+}
+
+inline
+int64_t LogAsyncSink::blockedCount() const {
+    return blockedCount_.get();
+}
+
+inline
+int64_t LogAsyncSink::writtenCount() const {
+    return writtenCount_.get();
+}
+
+}
+}
+
+#endif //#if !defined(CETTY_LOGGING_LOGASYNCSINK_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -37,6 +37,7 @@ public:
 
 private:
     virtual void doSink(const LogMessage& msg);
+    virtual void doSink(const char* messages, int size);
     virtual void doFlush();
 
 private:
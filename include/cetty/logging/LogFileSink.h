@@ -54,6 +54,7 @@ public:
                 int rollSize);
 
     virtual void doSink(const LogMessage& msg);
+    virtual void doSink(const char* messages, int size);
     virtual void doFlush();
 
     // Get the current LOG file size.
@@ -100,6 +101,7 @@ public:
     void setMaxRollingBackups(int backups);
 
 private:
+    void write(const char* data, int size);
     void rollFile();
     void generateLogFileName();
 
@@ -49,6 +49,11 @@ public:
     static const LogLevel DEBUG;
     static const LogLevel TRACE;
 
+    /**
+     * @return the LogLevel of the value, FATAL if out of range.
+     */
+    static const LogLevel& valueOf(int value);
+
 private:
     LogLevel(int v, const char* name);
 
@@ -40,10 +40,32 @@ public:
         }
     }
 
+    /**
+     * Sinks the messages which have been formatted already, joined
+     * with '\n', used by the sinks which buffer messages, like
+     * {@link LogAsyncSink}.  The threshold LogLevel should be checked
+     * by the caller with {@link #isEnabled}.
+     */
+    void sink(const char* messages, int size) {
+        if (messages && size > 0) {
+            doSink(messages, size);
+
+            if (immediateFlush_) {
+                doFlush();
+            }
+        }
+    }
+
     void flush() {
         doFlush();
     }
 
+    /**
+     * Check whether the LogLevel is not below the appender's
+     * threshold.
+     */
+    bool isEnabled(const LogLevel& level) const;
+
     /**
      * Returns this appenders threshold LogLevel. See the {@link
      * #setThreshold} method for the meaning of this option.
@@ -74,6 +96,7 @@ protected:
     }
 
     virtual void doSink(const LogMessage& msg) = 0;
+    virtual void doSink(const char* messages, int size) = 0;
     virtual void doFlush() = 0;
 
 private:
@@ -111,9 +134,14 @@ void LogSink::setImmediateFlush(bool immediateFlush) {
     immediateFlush_ = immediateFlush;
 }
 
+inline
+bool LogSink::isEnabled(const LogLevel& level) const {
+    return !level_ ? true : level >= *level_;
+}
+
 inline
 bool LogSink::enabled(const LogMessage& msg) const {
-    return !level_ ? true : msg.level() >= *level_;
+    return isEnabled(msg.level());
 }
 
 }
@@ -17,6 +17,8 @@
  * under the License.
  */
 
+#include <boost/noncopyable.hpp>
+#include <cetty/util/Atomic.h>
 #include <cetty/logging/LogSink.h>
 #include <cetty/logging/LogLevel.h>
 #include <cetty/logging/LogMessage.h>
@@ -54,6 +56,41 @@ public:
         int size_;
     };
 
+    /**
+     * The cached threshold of the module of a call site, resolved at the
+     * first time used, so checking the level only costs one load of the
+     * cached pointer and one relaxed load of the module's level.  The
+     * threshold is published atomically, as a call site may be first hit
+     * by several threads at the same time.
+     */
+    class Site : private boost::noncopyable {
+    public:
+        bool isEnabled(const LogLevel& level, const char* file) {
+            const cetty::util::Atomic<int>* threshold = threshold_.get();
+
+            if (!threshold) {
+                threshold = Logger::moduleLevelOfFile(file);
+                threshold_.set(threshold);
+            }
+
+            return level.value() >= threshold->relaxedGet();
+        }
+
+        bool isEnabled(const LogLevel& level, const char* file, const char* module) {
+            const cetty::util::Atomic<int>* threshold = threshold_.get();
+
+            if (!threshold) {
+                threshold = Logger::moduleLevel(module);
+                threshold_.set(threshold);
+            }
+
+            return level.value() >= threshold->relaxedGet();
+        }
+
+    private:
+        cetty::util::Atomic<const cetty::util::Atomic<int>*> threshold_;
+    };
+
 public:
     Logger(SourceFile file, int line);
     Logger(SourceFile file, int line, LogLevel level);
@@ -64,11 +101,49 @@ public:
     LogMessage::Stream& stream() { return message_.stream(); }
 
 public:
+    /**
+     * the default level, used by the modules which have no level set.
+     */
     static const LogLevel& level();
     static void setLevel(const LogLevel& level);
 
     static bool isEnabled(const LogLevel& level);
 
+    /**
+     * The level of the module, like "channel", "buffer", "codec",
+     * "service", "redis" and so on.  The module of a source file is the
+     * directory right under the <tt>cetty</tt> directory, e.g.
+     * <tt>cetty/channel/asio/AsioSocketChannel.cpp</tt> is in the
+     * <tt>channel</tt> module, or defined by <tt>CETTY_LOG_MODULE</tt>
+     * before including LoggerHelper.h.
+     */
+    static const LogLevel& level(const std::string& module);
+    static void setLevel(const std::string& module, const LogLevel& level);
+
+    /**
+     * Removes the level of the module, then the module follows the
+     * default level again.
+     */
+    static void resetLevel(const std::string& module);
+
+    static bool isEnabled(const std::string& module, const LogLevel& level);
+
+    /**
+     * @return the threshold of the module, which lives for ever.
+     */
+    static const cetty::util::Atomic<int>* moduleLevel(const std::string& module);
+
+    /**
+     * @return the threshold of the module the source file belongs to.
+     */
+    static const cetty::util::Atomic<int>* moduleLevelOfFile(const char* file);
+
+    /**
+     * @return the module name of the source file, empty if not under a
+     * <tt>cetty</tt> directory.
+     */
+    static std::string moduleOfFile(const char* file);
+
     static const LogPatternFormatter& patternFormatter();
     static void setPatternFormatter(const std::string& format);
 
@@ -78,6 +153,7 @@ private:
     LogMessage message_;
 
     static LogLevel level_;
+    static cetty::util::Atomic<int> levelValue_;
     static LogPatternFormatter* formatter;
     static std::vector<LogSinkPtr> sinks_;
 };
@@ -88,13 +164,13 @@ const LogLevel& Logger::level() {
 }
 
 inline
-void Logger::setLevel(const LogLevel& level) {
-    Logger::level_ = level;
+bool Logger::isEnabled(const LogLevel& level) {
+    return level.value() >= levelValue_.relaxedGet();
 }
 
 inline
-bool Logger::isEnabled(const LogLevel& level) {
-    return level >= Logger::level_;
+bool Logger::isEnabled(const std::string& module, const LogLevel& level) {
+    return level.value() >= moduleLevel(module)->relaxedGet();
 }
 
 inline
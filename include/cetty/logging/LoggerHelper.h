@@ -35,44 +35,125 @@
     #undef LOG_TRACE
 #endif
 
-#define LOG(level) \
+#define CETTY_LOG_LEVEL_TRACE 0
+#define CETTY_LOG_LEVEL_DEBUG 1
+#define CETTY_LOG_LEVEL_INFO  2
+#define CETTY_LOG_LEVEL_WARN  3
+
+// The call sites below CETTY_MIN_LOG_LEVEL are compiled out, e.g.
+// -DCETTY_MIN_LOG_LEVEL=CETTY_LOG_LEVEL_INFO strips LOG_TRACE and LOG_DEBUG.
+#if !defined(CETTY_MIN_LOG_LEVEL)
+#define CETTY_MIN_LOG_LEVEL CETTY_LOG_LEVEL_TRACE
+#endif
+
+// The module of the call sites, resolved from the path of the source file
+// (the directory under "cetty/") unless CETTY_LOG_MODULE is defined before
+// including this file.
+#if defined(__GNUC__)
+#define CETTY_LOG_BASE_FILE __BASE_FILE__
+#else
+#define CETTY_LOG_BASE_FILE __FILE__
+#endif
+
+namespace {
+
+// C++03 could not declare a static variable inside the expression of the
+// macros, so every line gets its own Site by instantiating the template with
+// __LINE__ of the call site, the anonymous namespace keeps it per file.
+template<int Line>
+inline ::cetty::logging::Logger::Site& cettyLogSite() {
+    static ::cetty::logging::Logger::Site site;
+    return site;
+}
+
+}
+
+#if defined(CETTY_LOG_MODULE)
+#define CETTY_LOG_IS_ENABLED(level) \
+    cettyLogSite<__LINE__>().isEnabled(level, CETTY_LOG_BASE_FILE, CETTY_LOG_MODULE)
+#else
+#define CETTY_LOG_IS_ENABLED(level) \
+    cettyLogSite<__LINE__>().isEnabled(level, CETTY_LOG_BASE_FILE)
+#endif
+
+// The level is checked before constructing the Logger, so a disabled
+// message costs nothing more than a comparison, neither the LogMessage nor
+// the arguments of the stream will be evaluated.
+#define CETTY_LOG_STREAM(level) \
     ::cetty::logging::Logger(__FILE__, __LINE__, level).stream()
 
+#if defined(_MSC_VER)
+#define CETTY_LOG_FUNC_STREAM(level) \
+    ::cetty::logging::Logger(__FILE__, __LINE__, __FUNCTION__, level).stream()
+#else
+#define CETTY_LOG_FUNC_STREAM(level) \
+    ::cetty::logging::Logger(__FILE__, __LINE__, __func__, level).stream()
+#endif
+
+#define CETTY_LOG_ENABLED(level, stream) \
+    !CETTY_LOG_IS_ENABLED(level) ? (void) 0 : \
+    ::cetty::logging::LogMessageVoidify() & stream
+
+// still type checked, but never executed.
+#define CETTY_LOG_STRIPPED(stream) \
+    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & stream
+
+#define LOG(level) \
+    !((level).value() >= CETTY_MIN_LOG_LEVEL && CETTY_LOG_IS_ENABLED(level)) ? (void) 0 : \
+    ::cetty::logging::LogMessageVoidify() & CETTY_LOG_STREAM(level)
+
 #define LOG_FATAL \
-    ::cetty::logging::Logger(__FILE__, __LINE__, ::cetty::logging::LogLevel::ERROR).stream()
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::ERROR, \
+                      CETTY_LOG_STREAM(::cetty::logging::LogLevel::ERROR))
 
 #define LOG_SYSFATAL \
-    ::cetty::logging::Logger(__FILE__, __LINE__, true).stream()
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::FATAL, \
+                      ::cetty::logging::Logger(__FILE__, __LINE__, true).stream())
 
 #define LOG_ERROR \
-    ::cetty::logging::Logger(__FILE__, __LINE__, ::cetty::logging::LogLevel::ERROR).stream()
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::ERROR, \
+                      CETTY_LOG_STREAM(::cetty::logging::LogLevel::ERROR))
 
+#if CETTY_MIN_LOG_LEVEL > CETTY_LOG_LEVEL_WARN
 #define LOG_WARN \
-    ::cetty::logging::Logger(__FILE__, __LINE__, ::cetty::logging::LogLevel::WARN).stream()
+    CETTY_LOG_STRIPPED(CETTY_LOG_STREAM(::cetty::logging::LogLevel::WARN))
+#else
+#define LOG_WARN \
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::WARN, \
+                      CETTY_LOG_STREAM(::cetty::logging::LogLevel::WARN))
+#endif
 
+#if CETTY_MIN_LOG_LEVEL > CETTY_LOG_LEVEL_INFO
 #define LOG_INFO \
-    ::cetty::logging::Logger(__FILE__, __LINE__, ::cetty::logging::LogLevel::INFO).stream()
-
-#if defined(_MSC_VER)
+    CETTY_LOG_STRIPPED(CETTY_LOG_STREAM(::cetty::logging::LogLevel::INFO))
+#else
+#define LOG_INFO \
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::INFO, \
+                      CETTY_LOG_STREAM(::cetty::logging::LogLevel::INFO))
+#endif
 
+#if CETTY_MIN_LOG_LEVEL > CETTY_LOG_LEVEL_DEBUG
 #define LOG_DEBUG \
-    ::cetty::logging::Logger(__FILE__, __LINE__, __FUNCTION__, ::cetty::logging::LogLevel::DEBUG).stream()
-
-#define LOG_TRACE \
-    ::cetty::logging::Logger(__FILE__, __LINE__, __FUNCTION__, ::cetty::logging::LogLevel::TRACE).stream()
-
+    CETTY_LOG_STRIPPED(CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::DEBUG))
 #else
-
 #define LOG_DEBUG \
-    ::cetty::logging::Logger(__FILE__, __LINE__, __func__, ::cetty::logging::LogLevel::DEBUG).stream()
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::DEBUG, \
+                      CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::DEBUG))
+#endif
 
+#if CETTY_MIN_LOG_LEVEL > CETTY_LOG_LEVEL_TRACE
 #define LOG_TRACE \
-    ::cetty::logging::Logger(__FILE__, __LINE__, __func__, ::cetty::logging::LogLevel::TRACE).stream()
-
+    CETTY_LOG_STRIPPED(CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::TRACE))
+#else
+#define LOG_TRACE \
+    CETTY_LOG_ENABLED(::cetty::logging::LogLevel::TRACE, \
+                      CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::TRACE))
 #endif
 
 #define LOG_IF(level, condition) \
-    !(condition) ? (void) 0 : ::cetty::logging::LogMessageVoidify() & LOG(level)
+    !((condition) && (level).value() >= CETTY_MIN_LOG_LEVEL \
+      && CETTY_LOG_IS_ENABLED(level)) ? (void) 0 : \
+    ::cetty::logging::LogMessageVoidify() & CETTY_LOG_STREAM(level)
 
 // Plus some debug-logging macros that get compiled to nothing for production
 #if !defined(NDEBUG) || defined(_DEBUG)
@@ -85,16 +166,19 @@
 #else  // NDEBUG
 
 #define DLOG(level) \
-    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & LOG(level)
+    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & CETTY_LOG_STREAM(level)
 
 #define DLOG_DEBUG \
-    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & LOG_DEBUG
+    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & \
+    CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::DEBUG)
 
 #define DLOG_TRACE \
-    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & LOG_TRACE
+    true ? (void) 0 : ::cetty::logging::LogMessageVoidify() & \
+    CETTY_LOG_FUNC_STREAM(::cetty::logging::LogLevel::TRACE)
 
 #define DLOG_IF(level, condition) \
-    (true || !(condition)) ? (void) 0 : ::cetty::logging::LogMessageVoidify() & LOG_IF(level, condition)
+    (true || !(condition)) ? (void) 0 : \
+    ::cetty::logging::LogMessageVoidify() & CETTY_LOG_STREAM(level)
 
 #endif  // NDEBUG
 
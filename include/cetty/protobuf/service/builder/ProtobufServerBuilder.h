@@ -18,6 +18,7 @@
  */
 
 #include <cetty/channel/ChannelPtr.h>
+#include <cetty/util/WorkStealingThreadPool.h>
 #include <cetty/service/builder/ServerBuilder.h>
 #include <cetty/protobuf/service/ProtobufServicePtr.h>
 
@@ -36,6 +37,7 @@ using namespace cetty::channel;
 using namespace cetty::config;
 using namespace cetty::service;
 using namespace cetty::service::builder;
+using namespace cetty::util;
 using namespace cetty::protobuf::service;
 
 class ProtobufServerBuilder : private boost::noncopyable {
@@ -69,6 +71,13 @@ public:
     const EventLoopPoolPtr& parentPool() const;
     const EventLoopPoolPtr& childPool() const;
 
+    /**
+     * the pool running the service methods of the
+     * <tt>EXECUTE_IN_WORKER_POOL</tt> policy, NULL if the
+     * <tt>worker_thread_count</tt> is not configured.
+     */
+    const WorkStealingThreadPoolPtr& workerPool() const;
+
     ServerBuilder& serverBuilder();
     const ServerBuilder& serverBuilder() const;
 
@@ -78,6 +87,7 @@ private:
 
 private:
     ServerBuilder builder_;
+    WorkStealingThreadPoolPtr workerPool_;
 };
 
 inline
@@ -121,6 +131,11 @@ const EventLoopPoolPtr& ProtobufServerBuilder::childPool() const {
     return builder_.childPool();
 }
 
+inline
+const WorkStealingThreadPoolPtr& ProtobufServerBuilder::workerPool() const {
+    return workerPool_;
+}
+
 inline
 ServerBuilder& ProtobufServerBuilder::serverBuilder() {
     return builder_;
@@ -18,9 +18,12 @@
  */
 
 #include <deque>
+#include <boost/enable_shared_from_this.hpp>
 #include <cetty/Types.h>
 #include <cetty/channel/ChannelHandlerWrapper.h>
 #include <cetty/channel/ChannelMessageHandlerContext.h>
+#include <cetty/util/MpscQueue.h>
+#include <cetty/util/WorkStealingThreadPool.h>
 #include <cetty/protobuf/service/ProtobufServiceFuture.h>
 #include <cetty/protobuf/service/ProtobufServiceRegister.h>
 #include <cetty/protobuf/service/ProtobufServiceMessagePtr.h>
@@ -43,8 +46,37 @@ namespace protobuf {
 namespace service {
 namespace handler {
 using namespace cetty::channel;
+using namespace cetty::util;
 
-class ProtobufServiceMessageHandler : private boost::noncopyable {
+/**
+ * Calls the service methods of the requests, and writes back the responses.
+ *
+ * By default the methods are called in the event loop of the channel.  With
+ * a {@link WorkStealingThreadPool}, the methods whose
+ * <tt>execution_policy</tt> in the <tt>service_options.proto</tt> (of the
+ * method, or else of the service) is <tt>EXECUTE_IN_WORKER_POOL</tt> are
+ * called in the workers, so a slow method does not hold the other channels
+ * of the loop:
+ *
+ * <pre>
+ * service SqlService {
+ *     option (service_options).execution_policy = EXECUTE_IN_WORKER_POOL;
+ *
+ *     rpc query(Query) returns (Rows);
+ *     rpc ping(Ping) returns (Pong) {
+ *         option (service_method_options).execution_policy = EXECUTE_IN_IO_THREAD;
+ *     }
+ * }
+ * </pre>
+ *
+ * The responses from the workers are queued to the channel, and written in
+ * its event loop with one flush for all the responses queued meanwhile.
+ * When the worker pool is full the request is answered with an error at
+ * once.
+ */
+class ProtobufServiceMessageHandler
+    : public boost::enable_shared_from_this<ProtobufServiceMessageHandler>,
+      private boost::noncopyable {
 public:
     typedef ChannelMessageContainer<ProtobufServiceMessagePtr,
             MESSAGE_BLOCK> InboundContainer;
@@ -66,6 +98,14 @@ public:
 
 public:
     ProtobufServiceMessageHandler() {}
+
+    /**
+     * @param workers runs the methods of the <tt>EXECUTE_IN_WORKER_POOL</tt>
+     *        policy, which is usually shared by all the channels.
+     */
+    ProtobufServiceMessageHandler(const WorkStealingThreadPoolPtr& workers)
+        : workers_(workers) {}
+
     ~ProtobufServiceMessageHandler() {}
 
 public:
@@ -89,8 +129,35 @@ private:
                       ProtobufServiceMessagePtr req,
                       int64_t id);
 
+    void replyError(ChannelHandlerContext& ctx,
+                    const ProtobufServiceMessagePtr& req);
+
+    // called in the worker, the handler and the channel are kept alive
+    // by the bound pointers until the response is flushed.
+    void callInWorker(const ProtobufServicePtr& service,
+                      const google::protobuf::MethodDescriptor* method,
+                      const ProtobufServiceMessagePtr& req,
+                      const ChannelPtr& channel);
+
+    void workerDoneCallback(const MessagePtr& response,
+                            const ChannelPtr& channel,
+                            const ProtobufServiceMessagePtr& req);
+
+    // called in the event loop of the channel.
+    void flushWorkerResponses(const ChannelPtr& channel);
+
+private:
+    struct ResponseWriter {
+        ProtobufServiceMessageHandler* handler;
+        ResponseWriter(ProtobufServiceMessageHandler* handler) : handler(handler) {}
+        void operator()(const ProtobufServiceMessagePtr& response) const;
+    };
+
 private:
     Context* context_;
+
+    WorkStealingThreadPoolPtr workers_;
+    MpscQueue<ProtobufServiceMessagePtr> workerResponses_;
 };
 
 }
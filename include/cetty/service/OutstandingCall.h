@@ -20,6 +20,7 @@
 #include <boost/intrusive_ptr.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
 
+#include <cetty/util/CachedClock.h>
 #include <cetty/util/ReferenceCounter.h>
 #include <cetty/service/ServiceFuture.h>
 
@@ -36,7 +37,7 @@ public:
 
 public:
     OutstandingCall(const Request& request, const ServiceFuturePtr& future)
-        : timeStamp_(),
+        : timeStamp_(cetty::util::CachedClock::now()),
           request_(request),
           future_(future) {
     }
@@ -49,6 +50,13 @@ public:
         id_ = id;
     }
 
+    /**
+     * the time when the call created.
+     */
+    const ptime& timeStamp() const {
+        return timeStamp_;
+    }
+
     const Request& request() const {
         return request_;
     }
@@ -17,101 +17,94 @@
  * under the License.
  */
 
-#include <boost/function.hpp>
+#include <map>
+#include <string>
 #include <boost/noncopyable.hpp>
-#include <boost/intrusive_ptr.hpp>
-#include <cetty/service/ClientService.h>
-#include <cetty/service/builder/ClientBuilder.h>
-#include <cetty/handler/codec/http/HttpPackage.h>
+#include <cetty/channel/EventLoopPtr.h>
+#include <cetty/channel/EventLoopPoolPtr.h>
+#include <cetty/util/URI.h>
 #include <cetty/handler/codec/http/HttpMethod.h>
-#include <cetty/handler/codec/http/HttpRequestEncoder.h>
-#include <cetty/handler/codec/http/HttpResponseDecoder.h>
+#include <cetty/service/http/HttpConnectionPool.h>
 
 namespace cetty {
 namespace service {
 namespace http {
 
+using namespace cetty::util;
 using namespace cetty::channel;
-using namespace cetty::service::builder;
 using namespace cetty::handler::codec::http;
 
+/**
+ * A simple asynchronous HTTP/1.1 client, the requests are sent on the
+ * keep-alive connections of its {@link HttpConnectionPool}, so the calls to
+ * the same server do not pay a TCP handshake each time.
+ *
+ * <pre>
+ * HttpClient client;
+ * client.get("http://localhost:8080/users/1", callback);
+ * ...
+ * LOG_INFO << "pool hit ratio: " << client.pool().hitRatio();
+ * </pre>
+ *
+ * The callback is called in the {@link EventLoop} of the pool, with the
+ * aggregated response, or an empty pointer if the request failed.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
 class HttpClient : private boost::noncopyable {
 public:
-    typedef ServiceFuture<HttpPackage> HttpServiceFuture;
-    typedef HttpServiceFuture::Ptr HttpServiceFuturePtr;
-
-    typedef boost::function<void (HttpResponsePtr const&)> ResponseCallback;
+    typedef HttpConnectionPool::ResponseCallback ResponseCallback;
 
 public:
-    HttpClient() {
-        future_ = new HttpServiceFuture();
-        builder_.setClientInitializer(boost::bind(&HttpClient::initChannelPipeline, this, _1));
+    /**
+     * Creates a new instance served by its own {@link EventLoop}.
+     */
+    HttpClient();
+
+    /**
+     * Creates a new instance served by the <tt>eventLoop</tt>, it
+     * {@link HttpConnectionPool#close closes} the pool when destroyed, so it
+     * should be destroyed before the loop stops.
+     */
+    HttpClient(const EventLoopPtr& eventLoop);
+
+    ~HttpClient();
+
+    /**
+     * Sets the header sent with all the requests.
+     */
+    void setHeader(const std::string& name, const std::string& value);
+
+    void get(const std::string& url, const ResponseCallback& callback);
+
+    /**
+     * Posts the <tt>data</tt> as
+     * <tt>"application/x-www-form-urlencoded"</tt>, unless a
+     * <tt>"Content-Type"</tt> header has been set.
+     */
+    void post(const std::string& url,
+              const std::string& data,
+              const ResponseCallback& callback);
+
+    HttpConnectionPool& pool() {
+        return pool_;
     }
 
-    void setHeader(const std::string& name, const std::string& value) {
-
-    }
-
-    void get(const std::string& url, const ResponseCallback& callback) {
-        HttpRequestPtr req = new HttpRequest;
-
-        //req->headers().
-        req->setMethod(HttpMethod::GET);
-        req->headers().setHeader(HttpHeaders::Names::CACHE_CONTROL,
-            "max-age=0");
-
-        //req->setKeepAlive(false);
-        req->setUri(url);
-        req->setVersion(HttpVersion::HTTP_1_1);
-
-        req->headers().setHeader(HttpHeaders::Names::HOST,
-            req->uri().getHost());
-
-        Connection conn(req->uri().getHost(), req->uri().getPort(), 1);
-        ChannelPtr ch = builder_.build(conn);
-        HttpPackage package(req);
-        future_->addListener(boost::bind(&HttpClient::onResponse,
-                                         this,
-                                         _1,
-                                         _2,
-                                         callback));
-        ClientService<HttpPackage>::callMethod(ch, package, future_);
-    }
-
-    void post(const std::string& url, const std::string& data) {
-
+    const HttpConnectionPool& pool() const {
+        return pool_;
     }
 
 private:
-    void onResponse(const HttpServiceFuture& future,
-                    const HttpPackage& response,
-                    const ResponseCallback& callback) {
-        if (response.isHttpResponse()) {
-            if (callback) {
-                callback(response.httpResponse());
-            }
-        }
-    }
-
-    bool initChannelPipeline(ChannelPipeline& pipeline) {
-        pipeline.addLast<HttpRequestEncoder::Handler>(
-            "encoder",
-            HttpRequestEncoder::HandlerPtr(new HttpRequestEncoder));
-
-        pipeline.addLast<HttpResponseDecoder::Handler>(
-            "decoder",
-            HttpResponseDecoder::HandlerPtr(new HttpResponseDecoder));
-
-        return true;
-    }
+    HttpRequestPtr newRequest(const URI& uri, const HttpMethod& method) const;
 
 private:
+    EventLoopPoolPtr eventLoopPool_;
+    HttpConnectionPool pool_;
+
     std::map<std::string, std::string> headers_;
-    ClientBuilder<HttpPackage> builder_;
-    HttpServiceFuturePtr future_;
 };
 
-
 }
 }
 }
@@ -0,0 +1,341 @@
+#if !defined(CETTY_SERVICE_HTTP_HTTPCONNECTIONPOOL_H)
+#define CETTY_SERVICE_HTTP_HTTPCONNECTIONPOOL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <map>
+#include <list>
+#include <deque>
+#include <string>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/date_time/posix_time/ptime.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/util/Atomic.h>
+#include <cetty/channel/ChannelPtr.h>
+#include <cetty/channel/ChannelFuture.h>
+#include <cetty/channel/TimeoutPtr.h>
+#include <cetty/channel/EventLoopPtr.h>
+#include <cetty/bootstrap/ClientBootstrap.h>
+#include <cetty/handler/codec/http/HttpRequestPtr.h>
+#include <cetty/handler/codec/http/HttpResponsePtr.h>
+
+namespace cetty {
+namespace service {
+namespace http {
+
+using namespace cetty::util;
+using namespace cetty::channel;
+using namespace cetty::bootstrap;
+using namespace cetty::handler::codec::http;
+
+/**
+ * A pool of the keep-alive HTTP connections, per <tt>host:port</tt>, so the
+ * requests to the same server reuse the connections instead of paying the
+ * DNS resolution, the TCP handshake and the slow start each time.
+ *
+ * A request takes an idle connection of its server first, or opens a new one
+ * when there are less than {@link #maxConnectionsPerHost()} connections.
+ * Otherwise it is pipelined on a busy connection, if the server has answered
+ * a <tt>HTTP/1.1</tt> persistent response on it, or waits for a connection
+ * turning idle.
+ *
+ * A connection is returned to the pool when all its requests are responded,
+ * unless the response has <tt>"Connection: close"</tt>, or is a
+ * <tt>HTTP/1.0</tt> response without <tt>"Connection: keep-alive"</tt>.
+ * At most {@link #maxIdleConnections()} idle connections are kept, and the
+ * ones idle longer than {@link #idleTimeout()} are closed.
+ *
+ * All the connections are served by the same {@link EventLoop}, in which all
+ * the state of the pool is accessed, so {@link #request} may be called in any
+ * thread.  The statistics may be read in any thread too.
+ *
+ * The pool should be {@link #close() closed}, or destroyed, before its
+ * {@link EventLoop} stops, as the connections are closed in the loop thread.
+ * When the loop has stopped, the pool is closed in the caller's thread.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+class HttpConnectionPool : private boost::noncopyable {
+public:
+    /**
+     * called with the response, or an empty pointer if the request failed.
+     */
+    typedef boost::function<void (const HttpResponsePtr&)> ResponseCallback;
+
+    static const int DEFAULT_MAX_IDLE_CONNECTIONS = 64;
+    static const int DEFAULT_MAX_CONNECTIONS_PER_HOST = 8;
+    static const int DEFAULT_MAX_PIPELINED_REQUESTS = 4;
+    static const int DEFAULT_IDLE_TIMEOUT = 60 * 1000;
+    static const int DEFAULT_MAX_CONTENT_LENGTH = 16 * 1024 * 1024;
+
+    /**
+     * the milliseconds {@link #close()} waits for the loop thread, before
+     * closing the pool in the caller's thread.
+     */
+    static const int CLOSE_TIMEOUT;
+
+public:
+    HttpConnectionPool(const EventLoopPtr& eventLoop);
+
+    /**
+     * {@link #close() Closes} the pool if not closed yet.
+     */
+    ~HttpConnectionPool();
+
+    const EventLoopPtr& eventLoop() const {
+        return eventLoop_;
+    }
+
+    /**
+     * the maximum idle connections of all the servers.
+     */
+    int maxIdleConnections() const {
+        return maxIdleConnections_;
+    }
+
+    void setMaxIdleConnections(int maxIdleConnections);
+
+    /**
+     * the maximum connections, idle or busy, to a <tt>host:port</tt>.
+     */
+    int maxConnectionsPerHost() const {
+        return maxConnectionsPerHost_;
+    }
+
+    void setMaxConnectionsPerHost(int maxConnectionsPerHost);
+
+    /**
+     * the maximum requests not responded on a connection,
+     * <tt>1</tt> disables the pipelining.
+     */
+    int maxPipelinedRequests() const {
+        return maxPipelinedRequests_;
+    }
+
+    void setMaxPipelinedRequests(int maxPipelinedRequests);
+
+    /**
+     * the milliseconds a connection may stay idle in the pool.
+     */
+    int idleTimeout() const {
+        return idleTimeout_;
+    }
+
+    void setIdleTimeout(int idleTimeout);
+
+    /**
+     * the maximum content length of the response, the larger one fails.
+     */
+    int maxContentLength() const {
+        return maxContentLength_;
+    }
+
+    void setMaxContentLength(int maxContentLength);
+
+    /**
+     * Sends the request to the server at <tt>host:port</tt>, the callback is
+     * called in the {@link EventLoop} of the pool.
+     */
+    void request(const std::string& host,
+                 int port,
+                 const HttpRequestPtr& request,
+                 const ResponseCallback& callback);
+
+    /**
+     * Closes all the connections, the requests not responded fail, and so do
+     * the ones requested later.  It returns once the connections are closed
+     * and detached from the pool in the loop thread.  If the loop has stopped,
+     * or does not run the close in {@link #CLOSE_TIMEOUT}, the pool is closed
+     * in the caller's thread instead.
+     */
+    void close();
+
+    /**
+     * the count of the requests.
+     */
+    int64_t requests() const {
+        return requests_.get();
+    }
+
+    /**
+     * the count of the requests sent on a pooled connection, idle or pipelined.
+     */
+    int64_t hits() const {
+        return hits_.get();
+    }
+
+    /**
+     * the count of the requests which opened a new connection.
+     */
+    int64_t misses() const {
+        return misses_.get();
+    }
+
+    /**
+     * the ratio of the {@link #hits()} to the requests which have got
+     * a connection, 0 before any.
+     */
+    double hitRatio() const;
+
+    /**
+     * the count of the open connections, including the connecting ones.
+     */
+    int connectionCount() const {
+        return connectionCount_.get();
+    }
+
+    int idleConnectionCount() const {
+        return idleConnectionCount_.get();
+    }
+
+private:
+    class ResponseHandler;
+    struct CloseLatch;
+    typedef boost::shared_ptr<CloseLatch> CloseLatchPtr;
+
+    typedef boost::shared_ptr<HttpConnectionPool> PoolPtr;
+    typedef boost::weak_ptr<HttpConnectionPool> PoolWeakPtr;
+
+    struct Call {
+        HttpRequestPtr request;
+        ResponseCallback callback;
+        bool retried;
+
+        Call(const HttpRequestPtr& request, const ResponseCallback& callback)
+            : request(request), callback(callback), retried(false) {}
+    };
+
+    struct Connection;
+    typedef boost::shared_ptr<Connection> ConnectionPtr;
+    typedef std::list<ConnectionPtr> ConnectionList;
+
+    struct Host {
+        std::string host;
+        int port;
+
+        // all the open connections, the most recently idle one at the front
+        // of the idle ones.
+        ConnectionList connections;
+        ConnectionList idles;
+
+        // the requests waiting for a connection.
+        std::deque<Call> waitings;
+
+        Host(const std::string& host, int port) : host(host), port(port) {}
+    };
+
+    struct Connection {
+        Host* host;
+        ChannelPtr channel;
+
+        // the requests sent, not responded yet, in the sending order.
+        std::deque<Call> calls;
+
+        bool connected;
+        bool idle;
+        bool closing;
+
+        // the server has answered a HTTP/1.1 persistent response.
+        bool pipelining;
+
+        int64_t responses;
+        boost::posix_time::ptime lastActive;
+
+        Connection(Host* host)
+            : host(host),
+              connected(false),
+              idle(false),
+              closing(false),
+              pipelining(false),
+              responses(0) {}
+    };
+
+    typedef std::map<std::string, Host*> HostMap;
+    typedef std::map<int, ConnectionPtr> ChannelMap;
+
+    bool initializeChannel(ChannelPipeline& pipeline);
+
+    void dispatch(const std::string& host, int port, const Call& call);
+    void dispatch(Host* host, const Call& call);
+
+    void connect(Host* host, const Call& call);
+    void send(const ConnectionPtr& connection, const Call& call);
+
+    ConnectionPtr pipelinedConnection(Host* host, const Call& call);
+
+    void connected(ChannelFuture& future, ConnectionPtr connection);
+    void closed(ChannelFuture& future);
+
+    void responseReceived(const ChannelPtr& channel,
+                          const HttpResponsePtr& response);
+
+    void write(const ConnectionPtr& connection, const Call& call);
+    void release(const ConnectionPtr& connection);
+    void retire(const ConnectionPtr& connection);
+    void fail(std::deque<Call>* calls);
+
+    void evictExpired();
+    void closeAll();
+    static void closeInLoop(const CloseLatchPtr& latch);
+
+    static void notifyIfOpen(const PoolWeakPtr& pool,
+                             const ChannelFuture::CompletedCallback& listener,
+                             ChannelFuture& future);
+
+private:
+    EventLoopPtr eventLoop_;
+    ClientBootstrap bootstrap_;
+
+    int maxIdleConnections_;
+    int maxConnectionsPerHost_;
+    int maxPipelinedRequests_;
+    int idleTimeout_;
+    int maxContentLength_;
+
+    // only accessed in the loop thread.
+    HostMap hosts_;
+    ChannelMap channels_;
+    TimeoutPtr evictTimeout_;
+
+    // does not own the pool, reset when closed, so the listeners of the
+    // channels holding a weak one are not called any more.
+    PoolPtr self_;
+    Atomic<int> closed_;
+
+    Atomic<int64_t> requests_;
+    Atomic<int64_t> hits_;
+    Atomic<int64_t> misses_;
+
+    Atomic<int> connectionCount_;
+    Atomic<int> idleConnectionCount_;
+};
+
+}
+}
+}
+
+#endif //#if !defined(CETTY_SERVICE_HTTP_HTTPCONNECTIONPOOL_H)
+
+// Local Variables:
+// mode: c++
+// End:
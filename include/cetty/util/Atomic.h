@@ -0,0 +1,163 @@
+#if !defined(CETTY_UTIL_ATOMIC_H)
+#define CETTY_UTIL_ATOMIC_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/noncopyable.hpp>
+#include <cetty/Types.h>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#include <intrin.h>
+#endif
+
+namespace cetty {
+namespace util {
+
+/**
+ * A word sized (int32_t, int64_t or a pointer) value which may be updated
+ * atomically, for the lock-free structures where
+ * <tt>boost::detail::atomic_count</tt> is not enough.
+ *
+ * <ul>
+ * <li>{@link #get} is an acquire load, {@link #set} is a release store.</li>
+ * <li>{@link #relaxedGet} and {@link #relaxedSet} have no ordering
+ * constraint, they are only for counters and hints.</li>
+ * <li>the read-modify-write operations are full barriers.</li>
+ * </ul>
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+
+template<typename T>
+class Atomic : private boost::noncopyable {
+public:
+    Atomic() : value_(T()) {}
+    explicit Atomic(T value) : value_(value) {}
+
+    T get() const {
+        T value = value_;
+        compilerBarrier();
+        return value;
+    }
+
+    void set(T value) {
+        compilerBarrier();
+        value_ = value;
+    }
+
+    T relaxedGet() const {
+        return value_;
+    }
+
+    void relaxedSet(T value) {
+        value_ = value;
+    }
+
+    /**
+     * Sets to <tt>update</tt> if the current value equals <tt>expect</tt>.
+     *
+     * @return true if successful.
+     */
+    bool compareAndSet(T expect, T update) {
+#if defined(_MSC_VER)
+        return casValue(expect, update) == expect;
+#else
+        return __sync_bool_compare_and_swap(&value_, expect, update);
+#endif
+    }
+
+    /**
+     * Sets to <tt>update</tt> and returns the old value.
+     */
+    T getAndSet(T update) {
+        T expect = value_;
+
+        while (!compareAndSet(expect, update)) {
+            expect = value_;
+        }
+
+        return expect;
+    }
+
+    /**
+     * Adds <tt>delta</tt> and returns the old value.
+     */
+    T getAndAdd(T delta) {
+#if defined(_MSC_VER)
+        T expect = value_;
+
+        while (!compareAndSet(expect, expect + delta)) {
+            expect = value_;
+        }
+
+        return expect;
+#else
+        return __sync_fetch_and_add(&value_, delta);
+#endif
+    }
+
+    T addAndGet(T delta) {
+        return getAndAdd(delta) + delta;
+    }
+
+    T incrementAndGet() {
+        return addAndGet(1);
+    }
+
+    T decrementAndGet() {
+        return addAndGet(-1);
+    }
+
+private:
+    static void compilerBarrier() {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#elif defined(__i386__) || defined(__x86_64__)
+        // loads are not reordered with other loads, and stores are not
+        // reordered with other stores on x86, only the compiler matters.
+        __asm__ __volatile__("" ::: "memory");
+#else
+        __sync_synchronize();
+#endif
+    }
+
+#if defined(_MSC_VER)
+    T casValue(T expect, T update) {
+        if (sizeof(T) == 8) {
+            return (T)_InterlockedCompareExchange64(
+                       (volatile __int64*)&value_, (__int64)update, (__int64)expect);
+        }
+        else {
+            return (T)_InterlockedCompareExchange(
+                       (volatile long*)&value_, (long)update, (long)expect);
+        }
+    }
+#endif
+
+private:
+    volatile T value_;
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_UTIL_ATOMIC_H)
+
+// Local Variables:
+// mode: c++
+// End:
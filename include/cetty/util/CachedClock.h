@@ -0,0 +1,87 @@
+#if !defined(CETTY_UTIL_CACHEDCLOCK_H)
+#define CETTY_UTIL_CACHEDCLOCK_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/date_time/posix_time/ptime.hpp>
+#include <cetty/Types.h>
+
+namespace cetty {
+namespace util {
+
+/**
+ * A coarse clock cached per thread.
+ *
+ * In the threads which enabled the cached clock, e.g. the threads of the
+ * {@link cetty::channel::EventLoop}s, the first {@link #now} after
+ * {@link #invalidate} reads the system clock, and the following ones
+ * return the cached time until the next {@link #invalidate}.  The event
+ * loops invalidate the clock once every loop iteration, so all the
+ * timestamps taken in one handler, such as the log messages, the idle
+ * states and the outstanding calls, cost only one system clock reading.
+ *
+ * In the other threads, it is the same as
+ * <tt>boost::posix_time::microsec_clock::universal_time()</tt>.
+ */
+class CachedClock {
+public:
+    /**
+     * the current UTC time, in microsecond resolution.
+     */
+    static boost::posix_time::ptime now();
+
+    /**
+     * the milliseconds since the epoch of the current time.
+     */
+    static int64_t nowInMillis();
+
+    /**
+     * the microseconds since the epoch of the current time.
+     */
+    static int64_t nowInMicros();
+
+    /**
+     * enable the cached clock in the current thread.
+     */
+    static void enable();
+
+    /**
+     * disable the cached clock in the current thread.
+     */
+    static void disable();
+
+    static bool isEnabled();
+
+    /**
+     * mark the cached time out of date, the next {@link #now} in the
+     * current thread will read the system clock again.
+     */
+    static void invalidate();
+
+private:
+    CachedClock();
+    CachedClock(const CachedClock&);
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_UTIL_CACHEDCLOCK_H)
+
+// Local Variables:
+// mode: c++
+// End:
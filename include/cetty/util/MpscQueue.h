@@ -0,0 +1,135 @@
+#if !defined(CETTY_UTIL_MPSCQUEUE_H)
+#define CETTY_UTIL_MPSCQUEUE_H
+
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/noncopyable.hpp>
+#include <cetty/util/Atomic.h>
+
+namespace cetty {
+namespace util {
+
+/**
+ * An unbounded lock-free queue with many producers and a single consumer,
+ * e.g. the threads writing to a channel and its event loop.
+ *
+ * The producers push to an intrusive stack with a CAS, the consumer takes
+ * the whole stack with one atomic exchange and restores the FIFO order.
+ * {@link #push} tells the producer whether the queue was empty, so the
+ * consumer only needs to be woken up once for a batch of messages.
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+template<typename T>
+class MpscQueue : private boost::noncopyable {
+public:
+    MpscQueue() : head_(NULL) {}
+
+    ~MpscQueue() {
+        Node* node = head_.getAndSet(NULL);
+
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    /**
+     * Pushes the value in any thread.
+     *
+     * @return true if the queue was empty before.
+     */
+    bool push(const T& value) {
+        Node* node = new Node(value);
+        Node* head = NULL;
+
+        do {
+            head = head_.get();
+            node->next = head;
+        }
+        while (!head_.compareAndSet(head, node));
+
+        return head == NULL;
+    }
+
+    /**
+     * may be stale when called in the producer threads.
+     */
+    bool empty() const {
+        return head_.get() == NULL;
+    }
+
+    /**
+     * Pops all the values in the pushing order, and appends them to the
+     * <tt>consumer</tt> by <tt>consumer(value)</tt>, only in the consumer
+     * thread.
+     *
+     * @return the count of the values popped.
+     */
+    template<typename Consumer>
+    int popAll(Consumer consumer) {
+        Node* node = head_.getAndSet(NULL);
+
+        if (!node) {
+            return 0;
+        }
+
+        // reverse to the pushing order.
+        Node* reversed = NULL;
+
+        while (node) {
+            Node* next = node->next;
+            node->next = reversed;
+            reversed = node;
+            node = next;
+        }
+
+        int count = 0;
+
+        while (reversed) {
+            Node* next = reversed->next;
+            consumer(reversed->value);
+            delete reversed;
+            reversed = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+
+        Node(const T& value) : value(value), next(NULL) {}
+    };
+
+private:
+    Atomic<Node*> head_;
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_UTIL_MPSCQUEUE_H)
+
+// Local Variables:
+// mode: c++
+// End:
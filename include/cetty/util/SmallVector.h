@@ -0,0 +1,180 @@
+#if !defined(CETTY_UTIL_SMALLVECTOR_H)
+#define CETTY_UTIL_SMALLVECTOR_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+namespace cetty {
+namespace util {
+
+/**
+ * A contiguous array keeping the first <tt>N</tt> elements inside the
+ * object, and moving to the heap only when growing beyond that.
+ *
+ * It is meant for the small plain values, which are default constructed in
+ * the whole capacity and copied by assignment.
+ */
+template<typename T, int N>
+class SmallVector {
+public:
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+public:
+    SmallVector()
+        : data_(inline_), size_(0), capacity_(N) {
+        BOOST_STATIC_ASSERT(N > 0);
+    }
+
+    SmallVector(const SmallVector& other)
+        : data_(inline_), size_(0), capacity_(N) {
+        append(other.data_, other.size_);
+    }
+
+    ~SmallVector() {
+        if (data_ != inline_) {
+            delete[] data_;
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            size_ = 0;
+            append(other.data_, other.size_);
+        }
+
+        return *this;
+    }
+
+    int size() const { return size_; }
+    int capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * whether the elements are still inside the object.
+     */
+    bool inlined() const { return data_ == inline_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    T& operator[](int i) {
+        BOOST_ASSERT(i >= 0 && i < size_);
+        return data_[i];
+    }
+
+    const T& operator[](int i) const {
+        BOOST_ASSERT(i >= 0 && i < size_);
+        return data_[i];
+    }
+
+    T& back() {
+        BOOST_ASSERT(size_ > 0);
+        return data_[size_ - 1];
+    }
+
+    const T& back() const {
+        BOOST_ASSERT(size_ > 0);
+        return data_[size_ - 1];
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            T copy = value;
+            reserve(size_ + 1);
+            data_[size_++] = copy;
+        }
+        else {
+            data_[size_++] = value;
+        }
+    }
+
+    void append(const T* values, int count) {
+        if (count <= 0) {
+            return;
+        }
+
+        // the values may be a part of this vector, which moves when growing.
+        if (values >= data_ && values < data_ + size_) {
+            int offset = static_cast<int>(values - data_);
+            reserve(size_ + count);
+            values = data_ + offset;
+        }
+        else {
+            reserve(size_ + count);
+        }
+
+        std::copy(values, values + count, data_ + size_);
+        size_ += count;
+    }
+
+    /**
+     * removes the element at <tt>index</tt>, keeping the order of the rest.
+     */
+    void erase(int index) {
+        BOOST_ASSERT(index >= 0 && index < size_);
+        std::copy(data_ + index + 1, data_ + size_, data_ + index);
+        --size_;
+    }
+
+    /**
+     * drops the elements, the heap storage if any is kept for reuse.
+     */
+    void clear() {
+        size_ = 0;
+    }
+
+    void reserve(int capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+
+        int newCapacity = std::max(capacity, capacity_ * 2);
+        T* data = new T[newCapacity];
+        std::copy(data_, data_ + size_, data);
+
+        if (data_ != inline_) {
+            delete[] data_;
+        }
+
+        data_ = data;
+        capacity_ = newCapacity;
+    }
+
+private:
+    T* data_;
+    int size_;
+    int capacity_;
+    T inline_[N];
+};
+
+}
+}
+
+#endif //#if !defined(CETTY_UTIL_SMALLVECTOR_H)
+
+// Local Variables:
+// mode: c++
+// End:
@@ -169,13 +169,13 @@ public:
         const char* newData = ptr_;
         int   newSize = length_;
 
-        while ((*newData == ' ' || *newData == '\t') && newSize > 0) {
-            newData++;
-            --newData;
+        while (newSize > 0 && (*newData == ' ' || *newData == '\t')) {
+            ++newData;
+            --newSize;
         }
 
-        while ((newData[newSize - 1] == ' ' || newData[newSize - 1] == '\t')
-                && newSize > 0) {
+        while (newSize > 0
+                && (newData[newSize - 1] == ' ' || newData[newSize - 1] == '\t')) {
             --newSize;
         }
 
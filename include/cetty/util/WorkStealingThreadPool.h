@@ -0,0 +1,218 @@
+#if !defined(CETTY_UTIL_WORKSTEALINGTHREADPOOL_H)
+#define CETTY_UTIL_WORKSTEALINGTHREADPOOL_H
+
+/*
+ * Copyright (c) 2010-2012 frankee zhou (frankee.zhou at gmail dot com)
+ *
+ * Distributed under under the Apache License, version 2.0 (the "License").
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <deque>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include <cetty/Types.h>
+#include <cetty/util/Atomic.h>
+
+namespace cetty {
+namespace util {
+
+/**
+ * A bounded pool of threads running the tasks which should not run in the
+ * event loops, e.g. the service methods doing heavy computing or blocking
+ * I/O.
+ *
+ * Every worker has its own queue.  The tasks submitted from the other
+ * threads are spread over the queues round robin, the tasks submitted in a
+ * worker go to its own queue.  A worker runs the tasks of its own queue in
+ * order, and when its queue is empty, steals the newest task from the
+ * others before going to sleep, so one slow task does not hold the tasks
+ * queued behind it while other workers are idle.
+ *
+ * At most <tt>maxQueuedTasks</tt> tasks wait in the pool, {@link #submit}
+ * rejects the task beyond that instead of growing the queue without limit,
+ * the caller decides how to fail.
+ *
+ * @code
+ * WorkStealingThreadPoolPtr workers(new WorkStealingThreadPool(8, 10000));
+ *
+ * if (!workers->submit(boost::bind(&query, request))) {
+ *     // overloaded
+ * }
+ * @endcode
+ *
+ * @author <a href="mailto:frankee.zhou@gmail.com">Frankee Zhou</a>
+ */
+class WorkStealingThreadPool : private boost::noncopyable {
+public:
+    typedef boost::function0<void> Task;
+
+    struct Statistics {
+        /**
+         * the tasks accepted by {@link #submit}.
+         */
+        int64_t submitted;
+
+        /**
+         * the tasks rejected because the pool is full or stopped.
+         */
+        int64_t rejected;
+
+        /**
+         * the tasks which have run.
+         */
+        int64_t executed;
+
+        /**
+         * the tasks run by a worker other than the one queued to.
+         */
+        int64_t stolen;
+
+        /**
+         * the tasks waiting in the queues now.
+         */
+        int queued;
+
+        /**
+         * the microseconds the executed tasks waited in the queues, in total
+         * and the longest one.
+         */
+        int64_t totalWaitTime;
+        int64_t maxWaitTime;
+
+        Statistics()
+            : submitted(0),
+              rejected(0),
+              executed(0),
+              stolen(0),
+              queued(0),
+              totalWaitTime(0),
+              maxWaitTime(0) {}
+    };
+
+public:
+    /**
+     * starts <tt>threadCount</tt> workers, the cpu number if not positive.
+     */
+    WorkStealingThreadPool(int threadCount, int maxQueuedTasks);
+
+    /**
+     * stops the pool, and waits for the queued tasks to finish.
+     */
+    ~WorkStealingThreadPool();
+
+    int threadCount() const;
+    int maxQueuedTasks() const;
+
+    /**
+     * the tasks waiting in the queues now.
+     */
+    int queuedTasks() const;
+
+    /**
+     * Queues the <tt>task</tt>, in any thread.
+     *
+     * @return false if the pool is full or stopped, the task is dropped.
+     */
+    bool submit(const Task& task);
+
+    /**
+     * whether the current thread is a worker of this pool.
+     */
+    bool inWorkerThread() const;
+
+    /**
+     * no task will be accepted any more, the workers exit after the queued
+     * tasks are done, and wait for them.
+     */
+    void stop();
+
+    void statistics(Statistics* statistics) const;
+
+private:
+    struct Entry {
+        Task task;
+        int64_t queuedTime;
+    };
+
+    struct Worker {
+        boost::mutex mutex;
+        std::deque<Entry> tasks;
+        boost::shared_ptr<boost::thread> thread;
+    };
+
+    void run(int index);
+
+    bool pop(int index, Entry* entry);
+    bool steal(int index, Entry* entry);
+
+    void execute(const Entry& entry);
+
+    int currentWorker() const;
+
+private:
+    int maxQueuedTasks_;
+
+    boost::ptr_vector<Worker> workers_;
+
+    Atomic<int> queued_;
+    Atomic<int> nextWorker_;
+
+    // the workers sleep here when no task in any queue, a submit only takes
+    // the mutex when some worker is sleeping.
+    boost::mutex idleMutex_;
+    boost::condition_variable idleCondition_;
+    Atomic<int> idleWorkers_;
+    Atomic<int> stopped_;
+
+    Atomic<int64_t> submitted_;
+    Atomic<int64_t> rejected_;
+    Atomic<int64_t> executed_;
+    Atomic<int64_t> stolen_;
+    Atomic<int64_t> totalWaitTime_;
+    Atomic<int64_t> maxWaitTime_;
+};
+
+typedef boost::shared_ptr<WorkStealingThreadPool> WorkStealingThreadPoolPtr;
+
+inline
+int WorkStealingThreadPool::threadCount() const {
+    return static_cast<int>(workers_.size());
+}
+
+inline
+int WorkStealingThreadPool::maxQueuedTasks() const {
+    return maxQueuedTasks_;
+}
+
+inline
+int WorkStealingThreadPool::queuedTasks() const {
+    return queued_.get();
+}
+
+inline
+bool WorkStealingThreadPool::inWorkerThread() const {
+    return currentWorker() >= 0;
+}
+
+}
+}
+
+#endif //#if !defined(CETTY_UTIL_WORKSTEALINGTHREADPOOL_H)
+
+// Local Variables:
+// mode: c++
+// End: